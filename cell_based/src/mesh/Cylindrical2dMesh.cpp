@@ -208,6 +208,9 @@ void Cylindrical2dMesh::ReMesh(NodeMap& rMap)
      * of extra nodes which will be deleted, hence the name 'big_map'.
      */
     NodeMap big_map(GetNumAllNodes());
+
+    // The mirrored nodes are not part of the existing triangulation, so it cannot be repaired incrementally
+    mCanReMeshIncrementally = false;
     MutableMesh<2,2>::ReMesh(big_map);
 
     /*
@@ -44,6 +44,7 @@ PottsMesh<DIM>::PottsMesh(std::vector<Node<DIM>*> nodes,
                           std::vector<PottsElement<DIM>*> pottsElements,
                           std::vector< std::set<unsigned> > vonNeumannNeighbouringNodeIndices,
                           std::vector< std::set<unsigned> > mooreNeighbouringNodeIndices)
+    : mNeighbourTablesRevision(0)
 {
     // Reset member variables and clear mNodes, mElements.
     Clear();
@@ -82,11 +83,14 @@ PottsMesh<DIM>::PottsMesh(std::vector<Node<DIM>*> nodes,
         }
     }
 
+    SetUpNeighbourTables();
+
     this->mMeshChangesDuringSimulation = true;
 }
 
 template<unsigned DIM>
 PottsMesh<DIM>::PottsMesh()
+    : mNeighbourTablesRevision(0)
 {
     this->mMeshChangesDuringSimulation = true;
     Clear();
@@ -242,6 +246,65 @@ std::set<unsigned> PottsMesh<DIM>::GetVonNeumannNeighbouringNodeIndices(unsigned
     return mVonNeumannNeighbouringNodeIndices[nodeIndex];
 }
 
+template<unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetMooreNeighbourStarts() const
+{
+    return mMooreNeighbourStarts;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetMooreNeighbours() const
+{
+    return mMooreNeighbours;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetVonNeumannNeighbourStarts() const
+{
+    return mVonNeumannNeighbourStarts;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& PottsMesh<DIM>::rGetVonNeumannNeighbours() const
+{
+    return mVonNeumannNeighbours;
+}
+
+template<unsigned DIM>
+unsigned PottsMesh<DIM>::GetNeighbourTablesRevision() const
+{
+    return mNeighbourTablesRevision;
+}
+
+template<unsigned DIM>
+void PottsMesh<DIM>::SetUpNeighbourTables()
+{
+    assert(mVonNeumannNeighbouringNodeIndices.size() == mMooreNeighbouringNodeIndices.size());
+    unsigned num_nodes = mMooreNeighbouringNodeIndices.size();
+
+    mVonNeumannNeighbourStarts.assign(1, 0);
+    mVonNeumannNeighbours.clear();
+    mMooreNeighbourStarts.assign(1, 0);
+    mMooreNeighbours.clear();
+    mVonNeumannNeighbourStarts.reserve(num_nodes+1);
+    mMooreNeighbourStarts.reserve(num_nodes+1);
+
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        mVonNeumannNeighbours.insert(mVonNeumannNeighbours.end(),
+                                     mVonNeumannNeighbouringNodeIndices[node_index].begin(),
+                                     mVonNeumannNeighbouringNodeIndices[node_index].end());
+        mVonNeumannNeighbourStarts.push_back(mVonNeumannNeighbours.size());
+
+        mMooreNeighbours.insert(mMooreNeighbours.end(),
+                                mMooreNeighbouringNodeIndices[node_index].begin(),
+                                mMooreNeighbouringNodeIndices[node_index].end());
+        mMooreNeighbourStarts.push_back(mMooreNeighbours.size());
+    }
+
+    mNeighbourTablesRevision++;
+}
+
 template<unsigned DIM>
 void PottsMesh<DIM>::DeleteElement(unsigned index)
 {
@@ -363,6 +426,8 @@ void PottsMesh<DIM>::DeleteNode(unsigned index)
             mElements[elem_index]->ResetIndex(elem_index);
         }
     }
+
+    SetUpNeighbourTables();
 }
 
 template<unsigned DIM>
@@ -574,6 +639,8 @@ void PottsMesh<DIM>::ConstructFromMeshReader(AbstractMeshReader<DIM, DIM>& rMesh
     {
         mMooreNeighbouringNodeIndices.resize(num_nodes);
     }
+
+    SetUpNeighbourTables();
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -80,6 +80,38 @@ protected:
     /** Vector of set of Moore neighbours for each node. */
     std::vector< std::set<unsigned> > mMooreNeighbouringNodeIndices;
 
+    /**
+     * Compressed row storage of the Von Neumann neighbours: the neighbours of node i are
+     * mVonNeumannNeighbours[mVonNeumannNeighbourStarts[i]] to
+     * mVonNeumannNeighbours[mVonNeumannNeighbourStarts[i+1]-1], in increasing order.
+     * Rebuilt by SetUpNeighbourTables() whenever the neighbour sets change.
+     */
+    std::vector<unsigned> mVonNeumannNeighbourStarts;
+
+    /** The Von Neumann neighbours of all nodes, indexed by mVonNeumannNeighbourStarts. */
+    std::vector<unsigned> mVonNeumannNeighbours;
+
+    /**
+     * Compressed row storage of the Moore neighbours, laid out as for
+     * mVonNeumannNeighbourStarts.
+     */
+    std::vector<unsigned> mMooreNeighbourStarts;
+
+    /** The Moore neighbours of all nodes, indexed by mMooreNeighbourStarts. */
+    std::vector<unsigned> mMooreNeighbours;
+
+    /**
+     * The number of times SetUpNeighbourTables() has been called, so that classes caching
+     * data derived from the neighbour tables can tell when the lattice has changed.
+     */
+    unsigned mNeighbourTablesRevision;
+
+    /**
+     * Fill the compressed row neighbour tables from mVonNeumannNeighbouringNodeIndices
+     * and mMooreNeighbouringNodeIndices.
+     */
+    void SetUpNeighbourTables();
+
     /**
      * Solve node mapping method. This overridden method is required
      * as it is pure virtual in the base class.
@@ -285,6 +317,42 @@ public:
      */
     std::set<unsigned> GetVonNeumannNeighbouringNodeIndices(unsigned nodeIndex);
 
+    /**
+     * Get the row offsets of the compressed row table of Moore neighbours. The neighbours of
+     * node i are rGetMooreNeighbours()[j] for rGetMooreNeighbourStarts()[i] <= j < rGetMooreNeighbourStarts()[i+1],
+     * in the same (increasing) order as GetMooreNeighbouringNodeIndices(i).
+     *
+     * Unlike GetMooreNeighbouringNodeIndices() this does not copy a set, so it should be used
+     * in inner loops such as Monte Carlo sweeps.
+     *
+     * @return the row offsets (of size GetNumNodes()+1)
+     */
+    const std::vector<unsigned>& rGetMooreNeighbourStarts() const;
+
+    /**
+     * @return the Moore neighbours of all nodes, indexed by rGetMooreNeighbourStarts()
+     */
+    const std::vector<unsigned>& rGetMooreNeighbours() const;
+
+    /**
+     * Get the row offsets of the compressed row table of Von Neumann neighbours, laid out
+     * as for rGetMooreNeighbourStarts().
+     *
+     * @return the row offsets (of size GetNumNodes()+1)
+     */
+    const std::vector<unsigned>& rGetVonNeumannNeighbourStarts() const;
+
+    /**
+     * @return the Von Neumann neighbours of all nodes, indexed by rGetVonNeumannNeighbourStarts()
+     */
+    const std::vector<unsigned>& rGetVonNeumannNeighbours() const;
+
+    /**
+     * @return a counter that changes whenever the neighbour tables are rebuilt, for example
+     * when a node is deleted
+     */
+    unsigned GetNeighbourTablesRevision() const;
+
     /**
      * Mark a node as deleted. Note that in a Potts mesh this requires the elements and connectivity to be updated accordingley.
      *
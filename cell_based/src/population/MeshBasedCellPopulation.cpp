@@ -324,6 +324,27 @@ void MeshBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>::Update(bool hasHadBirthsOrD
             }
         }
 
+        // Spring rest lengths are stored by node index, so are renumbered too if remeshing incrementally
+        if (mHasVariableRestLength
+            && static_cast<MutableMesh<ELEMENT_DIM,SPACE_DIM>&>((this->mrMesh)).GetUseIncrementalReMesh())
+        {
+            std::map<std::pair<unsigned,unsigned>, double> old_spring_rest_lengths;
+            old_spring_rest_lengths.swap(mSpringRestLengths);
+
+            for (std::map<std::pair<unsigned,unsigned>, double>::iterator iter = old_spring_rest_lengths.begin();
+                 iter != old_spring_rest_lengths.end();
+                 ++iter)
+            {
+                unsigned old_index_a = iter->first.first;
+                unsigned old_index_b = iter->first.second;
+                if (!node_map.IsDeleted(old_index_a) && !node_map.IsDeleted(old_index_b))
+                {
+                    std::pair<unsigned,unsigned> node_pair = this->CreateOrderedPair(node_map.GetNewIndex(old_index_a), node_map.GetNewIndex(old_index_b));
+                    mSpringRestLengths[node_pair] = iter->second;
+                }
+            }
+        }
+
         this->Validate();
     }
     else if (output_node_velocities)
@@ -56,8 +56,14 @@ NodeBasedCellPopulation<DIM>::NodeBasedCellPopulation(NodesOnlyMesh<DIM>& rMesh,
     : AbstractCentreBasedCellPopulation<DIM>(rMesh, rCells, locationIndices),
       mDeleteMesh(deleteMesh),
       mUseVariableRadii(false),
+      mCellsToSendRight(mCellsToSend[PetscTools::GetMyRank() + 1]),
+      mCellsToSendLeft(mCellsToSend[PetscTools::GetMyRank() - 1]),
+      mpCellsRecvRight(mCellsRecv[PetscTools::GetMyRank() + 1]),
+      mpCellsRecvLeft(mCellsRecv[PetscTools::GetMyRank() - 1]),
       mLoadBalanceMesh(false),
-      mLoadBalanceFrequency(100)
+      mLoadBalanceFrequency(100),
+      mVerletSkin(0.0),
+      mVerletListIsValid(false)
 {
     mpNodesOnlyMesh = static_cast<NodesOnlyMesh<DIM>* >(&(this->mrMesh));
 
@@ -72,8 +78,14 @@ NodeBasedCellPopulation<DIM>::NodeBasedCellPopulation(NodesOnlyMesh<DIM>& rMesh)
     : AbstractCentreBasedCellPopulation<DIM>(rMesh),
       mDeleteMesh(true),
       mUseVariableRadii(false), // will be set by serialize() method
+      mCellsToSendRight(mCellsToSend[PetscTools::GetMyRank() + 1]),
+      mCellsToSendLeft(mCellsToSend[PetscTools::GetMyRank() - 1]),
+      mpCellsRecvRight(mCellsRecv[PetscTools::GetMyRank() + 1]),
+      mpCellsRecvLeft(mCellsRecv[PetscTools::GetMyRank() - 1]),
       mLoadBalanceMesh(false),
-      mLoadBalanceFrequency(100)
+      mLoadBalanceFrequency(100),
+      mVerletSkin(0.0),
+      mVerletListIsValid(false)
 {
     mpNodesOnlyMesh = static_cast<NodesOnlyMesh<DIM>* >(&(this->mrMesh));
 }
@@ -82,6 +94,7 @@ template<unsigned DIM>
 NodeBasedCellPopulation<DIM>::~NodeBasedCellPopulation()
 {
     Clear();
+    ClearHaloCells();
     if (mDeleteMesh)
     {
         delete &this->mrMesh;
@@ -104,6 +117,7 @@ template<unsigned DIM>
 void NodeBasedCellPopulation<DIM>::Clear()
 {
     mNodePairs.clear();
+    mVerletListIsValid = false;
 }
 
 template<unsigned DIM>
@@ -141,11 +155,22 @@ void NodeBasedCellPopulation<DIM>::Update(bool hasHadBirthsOrDeaths)
 {
     UpdateCellProcessLocation();
 
-    mpNodesOnlyMesh->UpdateBoxCollection();
+    bool load_balance = mLoadBalanceMesh && ((SimulationTime::Instance()->GetTimeStepsElapsed() % mLoadBalanceFrequency) == 0);
 
-    if (mLoadBalanceMesh)
+    if ((mVerletSkin > 0.0) && !IsVerletListRebuildNeeded(hasHadBirthsOrDeaths || load_balance))
     {
-        if ((SimulationTime::Instance()->GetTimeStepsElapsed() % mLoadBalanceFrequency) == 0)
+        // Reuse the node pairs from the last rebuild, so only the halo cells need updating
+        RefreshHaloCells();
+
+        AddReceivedHaloCellsWithoutBoxes();
+
+        UpdateVerletHaloNodePairs();
+    }
+    else
+    {
+        mpNodesOnlyMesh->UpdateBoxCollection();
+
+        if (load_balance)
         {
             mpNodesOnlyMesh->LoadBalanceMesh();
 
@@ -153,15 +178,20 @@ void NodeBasedCellPopulation<DIM>::Update(bool hasHadBirthsOrDeaths)
 
             mpNodesOnlyMesh->UpdateBoxCollection();
         }
-    }
 
-    RefreshHaloCells();
+        RefreshHaloCells();
+
+        mpNodesOnlyMesh->CalculateInteriorNodePairs(mNodePairs, mNodeNeighbours);
 
-    mpNodesOnlyMesh->CalculateInteriorNodePairs(mNodePairs, mNodeNeighbours);
+        AddReceivedHaloCells();
 
-    AddReceivedHaloCells();
+        mpNodesOnlyMesh->CalculateBoundaryNodePairs(mNodePairs, mNodeNeighbours);
 
-    mpNodesOnlyMesh->CalculateBoundaryNodePairs(mNodePairs, mNodeNeighbours);
+        if (mVerletSkin > 0.0)
+        {
+            StoreVerletList();
+        }
+    }
 
     /*
      * Update cell radii based on CellData
@@ -242,6 +272,12 @@ unsigned NodeBasedCellPopulation<DIM>::RemoveDeadCells()
         }
     }
 
+    if (num_removed > 0)
+    {
+        // The node pairs refer to the deleted nodes
+        mVerletListIsValid = false;
+    }
+
     return num_removed;
 }
 
@@ -285,7 +321,7 @@ std::vector< std::pair<Node<DIM>*, Node<DIM>* > >& NodeBasedCellPopulation<DIM>:
 template<unsigned DIM>
 void NodeBasedCellPopulation<DIM>::OutputCellPopulationParameters(out_stream& rParamsFile)
 {
-    *rParamsFile << "\t\t<MechanicsCutOffLength>" << mpNodesOnlyMesh->GetMaximumInteractionDistance() << "</MechanicsCutOffLength>\n";
+    *rParamsFile << "\t\t<MechanicsCutOffLength>" << GetMechanicsCutOffLength() << "</MechanicsCutOffLength>\n";
     *rParamsFile << "\t\t<UseVariableRadii>" << mUseVariableRadii <<
 "</UseVariableRadii>\n";
 
@@ -308,7 +344,7 @@ void NodeBasedCellPopulation<DIM>::AcceptCellWriter(boost::shared_ptr<AbstractCe
 template<unsigned DIM>
 double NodeBasedCellPopulation<DIM>::GetMechanicsCutOffLength()
 {
-    return mpNodesOnlyMesh->GetMaximumInteractionDistance();
+    return mpNodesOnlyMesh->GetMaximumInteractionDistance() - mVerletSkin;
 }
 
 template<unsigned DIM>
@@ -335,6 +371,137 @@ void NodeBasedCellPopulation<DIM>::SetLoadBalanceFrequency(unsigned loadBalanceF
     mLoadBalanceFrequency = loadBalanceFrequency;
 }
 
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::SetVerletSkin(double verletSkin)
+{
+    assert(verletSkin >= 0.0);
+
+    double cut_off_length = GetMechanicsCutOffLength();
+    mVerletSkin = verletSkin;
+    mpNodesOnlyMesh->SetMaximumInteractionDistance(cut_off_length + mVerletSkin);
+
+    // Node pairs up to the new distance apart must lie in neighbouring boxes, so resize the boxes
+    DistributedBoxCollection<DIM>* p_box_collection = mpNodesOnlyMesh->GetBoxCollection();
+    if (p_box_collection)
+    {
+        c_vector<double, 2*DIM> domain_size = p_box_collection->rGetDomainSize();
+        mpNodesOnlyMesh->SetInitialBoxCollection(domain_size, cut_off_length + mVerletSkin);
+    }
+
+    mVerletListIsValid = false;
+}
+
+template<unsigned DIM>
+double NodeBasedCellPopulation<DIM>::GetVerletSkin()
+{
+    return mVerletSkin;
+}
+
+template<unsigned DIM>
+bool NodeBasedCellPopulation<DIM>::IsVerletListRebuildNeeded(bool forceRebuild)
+{
+    bool rebuild = forceRebuild || !mVerletListIsValid;
+
+    if (!rebuild)
+    {
+        double max_squared_displacement = 0.25*mVerletSkin*mVerletSkin;
+        for (unsigned i=0; i<mVerletReferenceLocations.size(); i++)
+        {
+            c_vector<double, DIM> displacement = mVerletReferenceLocations[i].first->rGetLocation() - mVerletReferenceLocations[i].second;
+            if (inner_prod(displacement, displacement) > max_squared_displacement)
+            {
+                rebuild = true;
+                break;
+            }
+        }
+    }
+
+    // Processes must agree, as the node pairs near process boundaries depend on each other's nodes
+    return PetscTools::ReplicateBool(rebuild);
+}
+
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::StoreVerletList()
+{
+    mVerletReferenceLocations.clear();
+    for (typename AbstractMesh<DIM,DIM>::NodeIterator node_iter = mpNodesOnlyMesh->GetNodeIteratorBegin();
+         node_iter != mpNodesOnlyMesh->GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        mVerletReferenceLocations.push_back(std::make_pair(&(*node_iter), node_iter->rGetLocation()));
+    }
+
+    // The first node of each pair is owned by this process, the second may be a halo node
+    mVerletHaloPairs.clear();
+    for (unsigned i=0; i<mNodePairs.size(); i++)
+    {
+        assert(mLocationHaloCellMap.find(mNodePairs[i].first->GetIndex()) == mLocationHaloCellMap.end());
+
+        unsigned other_index = mNodePairs[i].second->GetIndex();
+        if (mLocationHaloCellMap.find(other_index) != mLocationHaloCellMap.end())
+        {
+            mVerletHaloPairs.push_back(std::make_pair(i, other_index));
+        }
+    }
+
+    mVerletListIsValid = true;
+}
+
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::UpdateVerletHaloNodePairs()
+{
+    bool pairs_dropped = false;
+    for (unsigned i=0; i<mVerletHaloPairs.size(); i++)
+    {
+        unsigned halo_index = mVerletHaloPairs[i].second;
+        if (mLocationHaloCellMap.find(halo_index) != mLocationHaloCellMap.end())
+        {
+            mNodePairs[mVerletHaloPairs[i].first].second = mpNodesOnlyMesh->GetNodeOrHaloNode(halo_index);
+        }
+        else
+        {
+            mNodePairs[mVerletHaloPairs[i].first].second = NULL;
+            pairs_dropped = true;
+        }
+    }
+
+    if (pairs_dropped)
+    {
+        std::vector< std::pair<Node<DIM>*, Node<DIM>* > > kept_pairs;
+        std::vector<std::pair<unsigned, unsigned> > kept_halo_pairs;
+        kept_pairs.reserve(mNodePairs.size());
+
+        unsigned halo_pair = 0;
+        for (unsigned i=0; i<mNodePairs.size(); i++)
+        {
+            bool is_halo_pair = (halo_pair < mVerletHaloPairs.size()) && (mVerletHaloPairs[halo_pair].first == i);
+            if (mNodePairs[i].second != NULL)
+            {
+                if (is_halo_pair)
+                {
+                    kept_halo_pairs.push_back(std::make_pair((unsigned) kept_pairs.size(), mVerletHaloPairs[halo_pair].second));
+                }
+                kept_pairs.push_back(mNodePairs[i]);
+            }
+            else if (!mNodeNeighbours.empty())
+            {
+                // Remove the halo node from the neighbours, as it is no longer present on this process
+                unsigned node_index = mNodePairs[i].first->GetIndex();
+                unsigned halo_index = mVerletHaloPairs[halo_pair].second;
+                mNodeNeighbours[node_index].erase(halo_index);
+                mNodeNeighbours.erase(halo_index);
+            }
+            if (is_halo_pair)
+            {
+                halo_pair++;
+            }
+        }
+
+        mNodePairs.swap(kept_pairs);
+        mVerletHaloPairs.swap(kept_halo_pairs);
+    }
+}
+
 template<unsigned DIM>
 double NodeBasedCellPopulation<DIM>::GetWidth(const unsigned& rDimension)
 {
@@ -658,6 +825,9 @@ CellPtr NodeBasedCellPopulation<DIM>::AddCell(CellPtr pNewCell, const c_vector<d
 
     p_new_node->SetRadius(p_parent_node->GetRadius());
 
+    // The new node has no node pairs yet
+    mVerletListIsValid = false;
+
     // Return pointer to new cell
     return p_created_cell;
 }
@@ -687,6 +857,15 @@ void NodeBasedCellPopulation<DIM>::DeleteMovedCell(unsigned index)
     {
         if (this->GetLocationIndexUsingCell(*cell_iter) == index)
         {
+            /*
+             * The cell now belongs to another process, which counts it by its cell properties, so stop
+             * counting it here. It has already been sent, so marking it as dead doesn't affect the copy.
+             */
+            if (!(*cell_iter)->IsDead())
+            {
+                (*cell_iter)->Kill();
+            }
+
             // Update mappings between cells and location indices
             this->RemoveCellUsingLocationIndex(index, (*cell_iter));
             cell_iter = this->mCells.erase(cell_iter);
@@ -696,39 +875,18 @@ void NodeBasedCellPopulation<DIM>::DeleteMovedCell(unsigned index)
     }
 }
 
-/**
- * This null deleter is for the next method, SendCellsToNeighbourProcesses so we can make a
- * shared_ptr copy of mCellsToSendx without it actually being deleted when the pointer goes out of scope.
- * We need a shared pointer to send it because ObjectCommunicator only sends/recvs shared pointers to
- * avoid memory management problems.
- */
-struct null_deleter
-{
-    /**
-     * The delete operation that does nothing.
-     */
-    void operator()(void const *) const
-    {
-    }
-};
-
 template<unsigned DIM>
 void NodeBasedCellPopulation<DIM>::SendCellsToNeighbourProcesses()
 {
 #if BOOST_VERSION < 103700
     EXCEPTION("Parallel cell-based Chaste requires Boost >= 1.37");
 #else // BOOST_VERSION >= 103700
-    MPI_Status status;
-
-    if (!PetscTools::AmTopMost())
+    // Every process exchanges with its neighbours in ascending order of rank, which cannot deadlock.
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_cells_right(&mCellsToSendRight, null_deleter());
-        mpCellsRecvRight = mRightCommunicator.SendRecvObject(p_cells_right, PetscTools::GetMyRank() + 1, mCellCommunicationTag, PetscTools::GetMyRank() + 1, mCellCommunicationTag, status);
-    }
-    if (!PetscTools::AmMaster())
-    {
-        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_cells_left(&mCellsToSendLeft, null_deleter());
-        mpCellsRecvLeft = mLeftCommunicator.SendRecvObject(p_cells_left, PetscTools::GetMyRank() - 1, mCellCommunicationTag, PetscTools::GetMyRank() - 1, mCellCommunicationTag, status);
+        unsigned process = r_neighbours[i];
+        mCellsRecv[process] = mCommunicators[process].SendRecvCells(mCellsToSend[process], process, mCellCommunicationTag, process, mCellCommunicationTag);
     }
 #endif
 }
@@ -740,28 +898,22 @@ void NodeBasedCellPopulation<DIM>::NonBlockingSendCellsToNeighbourProcesses()
     EXCEPTION("Parallel cell-based Chaste requires Boost >= 1.37");
 #else // BOOST_VERSION >= 103700
 
-    if (!PetscTools::AmTopMost())
-    {
-        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_cells_right(&mCellsToSendRight, null_deleter());
-        int tag = SmallPow(2u, 1+ PetscTools::GetMyRank() ) * SmallPow (3u, 1 + PetscTools::GetMyRank() + 1);
-        mRightCommunicator.ISendObject(p_cells_right, PetscTools::GetMyRank() + 1, tag);
-    }
-    if (!PetscTools::AmMaster())
+    /*
+     * Messages are matched on their source process as well as their tag, and there is
+     * only one message between each pair of processes, so a single tag is enough.
+     */
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        int tag = SmallPow (2u, 1 + PetscTools::GetMyRank() ) * SmallPow (3u, 1 + PetscTools::GetMyRank() - 1);
-        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_cells_left(&mCellsToSendLeft, null_deleter());
-        mLeftCommunicator.ISendObject(p_cells_left, PetscTools::GetMyRank() - 1, tag);
+        unsigned process = r_neighbours[i];
+        mCommunicators[process].ISendCells(mCellsToSend[process], process, mCellCommunicationTag);
     }
+
     // Now post receives to start receiving data before returning.
-    if (!PetscTools::AmTopMost())
-    {
-        int tag = SmallPow (3u, 1 + PetscTools::GetMyRank() ) * SmallPow (2u, 1+ PetscTools::GetMyRank() + 1);
-        mRightCommunicator.IRecvObject(PetscTools::GetMyRank() + 1, tag);
-    }
-    if (!PetscTools::AmMaster())
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        int tag = SmallPow (3u, 1 + PetscTools::GetMyRank() ) * SmallPow (2u, 1+ PetscTools::GetMyRank() - 1);
-        mLeftCommunicator.IRecvObject(PetscTools::GetMyRank() - 1, tag);
+        unsigned process = r_neighbours[i];
+        mCommunicators[process].IRecvCells(process, mCellCommunicationTag);
     }
 #endif
 }
@@ -773,13 +925,11 @@ void NodeBasedCellPopulation<DIM>::GetReceivedCells()
     EXCEPTION("Parallel cell-based Chaste requires Boost >= 1.37");
 #else // BOOST_VERSION >= 103700
 
-    if (!PetscTools::AmTopMost())
-    {
-        mpCellsRecvRight = mRightCommunicator.GetRecvObject();
-    }
-    if (!PetscTools::AmMaster())
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        mpCellsRecvLeft = mLeftCommunicator.GetRecvObject();
+        unsigned process = r_neighbours[i];
+        mCellsRecv[process] = mCommunicators[process].GetRecvCells();
     }
 #endif
 }
@@ -796,28 +946,35 @@ std::pair<CellPtr, Node<DIM>* > NodeBasedCellPopulation<DIM>::GetCellNodePair(un
 }
 
 template<unsigned DIM>
-void NodeBasedCellPopulation<DIM>::AddNodeAndCellToSendRight(unsigned nodeIndex)
+void NodeBasedCellPopulation<DIM>::AddNodeAndCellToSend(unsigned nodeIndex, unsigned processIndex)
 {
     std::pair<CellPtr, Node<DIM>* > pair = GetCellNodePair(nodeIndex);
 
-    mCellsToSendRight.push_back(pair);
+    mCellsToSend[processIndex].push_back(pair);
 }
 
 template<unsigned DIM>
-void NodeBasedCellPopulation<DIM>::AddNodeAndCellToSendLeft(unsigned nodeIndex)
+void NodeBasedCellPopulation<DIM>::AddNodeAndCellToSendRight(unsigned nodeIndex)
 {
-    std::pair<CellPtr, Node<DIM>* > pair = GetCellNodePair(nodeIndex);
+    AddNodeAndCellToSend(nodeIndex, PetscTools::GetMyRank() + 1);
+}
 
-    mCellsToSendLeft.push_back(pair);
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::AddNodeAndCellToSendLeft(unsigned nodeIndex)
+{
+    AddNodeAndCellToSend(nodeIndex, PetscTools::GetMyRank() - 1);
 }
 
 template<unsigned DIM>
 void NodeBasedCellPopulation<DIM>::AddReceivedCells()
 {
-    if (!PetscTools::AmMaster())
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        for (typename std::vector<std::pair<CellPtr, Node<DIM>* > >::iterator iter = mpCellsRecvLeft->begin();
-             iter != mpCellsRecvLeft->end();
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_cells_recv = mCellsRecv[r_neighbours[i]];
+
+        for (typename std::vector<std::pair<CellPtr, Node<DIM>* > >::iterator iter = p_cells_recv->begin();
+             iter != p_cells_recv->end();
              ++iter)
         {
             // Make a shared pointer to the node to make sure it is correctly deleted.
@@ -825,30 +982,37 @@ void NodeBasedCellPopulation<DIM>::AddReceivedCells()
             AddMovedCell(iter->first, p_node);
         }
     }
-    if (!PetscTools::AmTopMost())
-    {
-        for (typename std::vector<std::pair<CellPtr, Node<DIM>* > >::iterator iter = mpCellsRecvRight->begin();
-             iter != mpCellsRecvRight->end();
-             ++iter)
-        {
-            boost::shared_ptr<Node<DIM> > p_node(iter->second);
-            AddMovedCell(iter->first, p_node);
-        }
-    }
 }
 
 template<unsigned DIM>
 void NodeBasedCellPopulation<DIM>::UpdateCellProcessLocation()
 {
+    // If the box collection is created or enlarged its halo information is lost, so the Verlet list must be rebuilt
+    DistributedBoxCollection<DIM>* p_box_collection = mpNodesOnlyMesh->GetBoxCollection();
+    c_vector<double, 2*DIM> old_domain_size = zero_vector<double>(2*DIM);
+    if (p_box_collection)
+    {
+        old_domain_size = p_box_collection->rGetDomainSize();
+    }
+
     mpNodesOnlyMesh->ResizeBoxCollection();
 
+    if (!p_box_collection || (norm_inf(mpNodesOnlyMesh->GetBoxCollection()->rGetDomainSize() - old_domain_size) > 0.0))
+    {
+        mVerletListIsValid = false;
+    }
+
     mpNodesOnlyMesh->CalculateNodesOutsideLocalDomain();
 
-    std::vector<unsigned> nodes_to_send_right = mpNodesOnlyMesh->rGetNodesToSendRight();
-    AddCellsToSendRight(nodes_to_send_right);
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
 
-    std::vector<unsigned> nodes_to_send_left = mpNodesOnlyMesh->rGetNodesToSendLeft();
-    AddCellsToSendLeft(nodes_to_send_left);
+    std::map<unsigned, std::vector<unsigned> > nodes_to_send;
+    for (unsigned i=0; i<r_neighbours.size(); i++)
+    {
+        unsigned process = r_neighbours[i];
+        nodes_to_send[process] = mpNodesOnlyMesh->rGetNodesToSend(process);
+        AddCellsToSend(process, nodes_to_send[process]);
+    }
 
     // Post non-blocking send / receives so communication on both sides can start.
     SendCellsToNeighbourProcesses();
@@ -856,22 +1020,30 @@ void NodeBasedCellPopulation<DIM>::UpdateCellProcessLocation()
     // Post blocking receive calls that wait until communication complete.
     //GetReceivedCells();
 
-    for (std::vector<unsigned>::iterator iter = nodes_to_send_right.begin();
-         iter != nodes_to_send_right.end();
-         ++iter)
+    for (std::map<unsigned, std::vector<unsigned> >::iterator process_iter = nodes_to_send.begin();
+         process_iter != nodes_to_send.end();
+         ++process_iter)
     {
-        DeleteMovedCell(*iter);
+        for (std::vector<unsigned>::iterator iter = process_iter->second.begin();
+             iter != process_iter->second.end();
+             ++iter)
+        {
+            DeleteMovedCell(*iter);
+        }
     }
 
-    for (std::vector<unsigned>::iterator iter = nodes_to_send_left.begin();
-         iter != nodes_to_send_left.end();
-         ++iter)
+    AddReceivedCells();
+
+    // Cells moving between processes change the node pairs, so the Verlet list must be rebuilt
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        DeleteMovedCell(*iter);
+        unsigned process = r_neighbours[i];
+        if (!nodes_to_send[process].empty() || !mCellsRecv[process]->empty())
+        {
+            mVerletListIsValid = false;
+        }
     }
 
-    AddReceivedCells();
-
     NodeMap map(1 + mpNodesOnlyMesh->GetMaximumNodeIndex());
     mpNodesOnlyMesh->ReMesh(map);
     UpdateMapsAfterRemesh(map);
@@ -882,69 +1054,68 @@ void NodeBasedCellPopulation<DIM>::RefreshHaloCells()
 {
     mpNodesOnlyMesh->ClearHaloNodes();
 
-    mHaloCells.clear();
-    mHaloCellLocationMap.clear();
-    mLocationHaloCellMap.clear();
+    ClearHaloCells();
 
-    std::vector<unsigned> halos_to_send_right = mpNodesOnlyMesh->rGetHaloNodesToSendRight();
-    AddCellsToSendRight(halos_to_send_right);
-
-    std::vector<unsigned> halos_to_send_left = mpNodesOnlyMesh->rGetHaloNodesToSendLeft();
-    AddCellsToSendLeft(halos_to_send_left);
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+    for (unsigned i=0; i<r_neighbours.size(); i++)
+    {
+        unsigned process = r_neighbours[i];
+        std::vector<unsigned> halos_to_send = mpNodesOnlyMesh->rGetHaloNodesToSend(process);
+        AddCellsToSend(process, halos_to_send);
+    }
 
     NonBlockingSendCellsToNeighbourProcesses();
 }
 
 template<unsigned DIM>
-void NodeBasedCellPopulation<DIM>::AddCellsToSendRight(std::vector<unsigned>& cellLocationIndices)
+void NodeBasedCellPopulation<DIM>::AddCellsToSend(unsigned processIndex, std::vector<unsigned>& cellLocationIndices)
 {
-    mCellsToSendRight.clear();
+    mCellsToSend[processIndex].clear();
 
     for (unsigned i=0; i < cellLocationIndices.size(); i++)
     {
-        AddNodeAndCellToSendRight(cellLocationIndices[i]);
+        AddNodeAndCellToSend(cellLocationIndices[i], processIndex);
     }
 }
 
 template<unsigned DIM>
-void NodeBasedCellPopulation<DIM>::AddCellsToSendLeft(std::vector<unsigned>& cellLocationIndices)
+void NodeBasedCellPopulation<DIM>::AddCellsToSendRight(std::vector<unsigned>& cellLocationIndices)
 {
-    mCellsToSendLeft.clear();
+    AddCellsToSend(PetscTools::GetMyRank() + 1, cellLocationIndices);
+}
 
-    for (unsigned i=0; i < cellLocationIndices.size(); i++)
-    {
-        AddNodeAndCellToSendLeft(cellLocationIndices[i]);
-    }
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::AddCellsToSendLeft(std::vector<unsigned>& cellLocationIndices)
+{
+    AddCellsToSend(PetscTools::GetMyRank() - 1, cellLocationIndices);
 }
 
 template<unsigned DIM>
 void NodeBasedCellPopulation<DIM>::AddReceivedHaloCells()
+{
+    AddReceivedHaloCellsWithoutBoxes();
+
+    mpNodesOnlyMesh->AddHaloNodesToBoxes();
+}
+
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::AddReceivedHaloCellsWithoutBoxes()
 {
     GetReceivedCells();
 
-    if (!PetscTools::AmMaster())
+    const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+    for (unsigned i=0; i<r_neighbours.size(); i++)
     {
-        for (typename std::vector<std::pair<CellPtr, Node<DIM>* > >::iterator iter = mpCellsRecvLeft->begin();
-                iter != mpCellsRecvLeft->end();
-                ++iter)
-        {
-            boost::shared_ptr<Node<DIM> > p_node(iter->second);
-            AddHaloCell(iter->first, p_node);
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > p_cells_recv = mCellsRecv[r_neighbours[i]];
 
-        }
-    }
-    if (!PetscTools::AmTopMost())
-    {
-        for (typename std::vector<std::pair<CellPtr, Node<DIM>* > >::iterator iter = mpCellsRecvRight->begin();
-                iter != mpCellsRecvRight->end();
+        for (typename std::vector<std::pair<CellPtr, Node<DIM>* > >::iterator iter = p_cells_recv->begin();
+                iter != p_cells_recv->end();
                 ++iter)
         {
             boost::shared_ptr<Node<DIM> > p_node(iter->second);
             AddHaloCell(iter->first, p_node);
         }
     }
-
-    mpNodesOnlyMesh->AddHaloNodesToBoxes();
 }
 
 template<unsigned DIM>
@@ -957,6 +1128,40 @@ void NodeBasedCellPopulation<DIM>::AddHaloCell(CellPtr pCell, boost::shared_ptr<
     mHaloCellLocationMap[pCell] = pNode->GetIndex();
 
     mLocationHaloCellMap[pNode->GetIndex()] = pCell;
+
+    // The process that owns the cell counts it (dead cells have already stopped being counted)
+    if (!pCell->IsDead())
+    {
+        CellPropertyCollection& r_collection = pCell->rGetCellPropertyCollection();
+        for (CellPropertyCollection::Iterator property_iter = r_collection.Begin();
+             property_iter != r_collection.End();
+             ++property_iter)
+        {
+            (*property_iter)->DecrementCellCount();
+        }
+    }
+}
+
+template<unsigned DIM>
+void NodeBasedCellPopulation<DIM>::ClearHaloCells()
+{
+    for (unsigned i=0; i<mHaloCells.size(); i++)
+    {
+        if (!mHaloCells[i]->IsDead())
+        {
+            CellPropertyCollection& r_collection = mHaloCells[i]->rGetCellPropertyCollection();
+            for (CellPropertyCollection::Iterator property_iter = r_collection.Begin();
+                 property_iter != r_collection.End();
+                 ++property_iter)
+            {
+                (*property_iter)->IncrementCellCount();
+            }
+        }
+    }
+
+    mHaloCells.clear();
+    mHaloCellLocationMap.clear();
+    mLocationHaloCellMap.clear();
 }
 
 // Explicit instantiation
@@ -37,11 +37,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NODEBASEDCELLPOPULATION_HPP_
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/base_object.hpp>
 
 #include <boost/version.hpp>
 #if BOOST_VERSION >= 103700
-#include "ObjectCommunicator.hpp"
+#include "PackedCellCommunicator.hpp"
 #endif
 
 #include "AbstractCentreBasedCellPopulation.hpp"
@@ -84,23 +85,26 @@ private:
     /** Whether or not to have cell radii updated from CellData defaults to false.*/
     bool mUseVariableRadii;
 
-    /** The cells to send to the right process */
-    std::vector<std::pair<CellPtr, Node<DIM>* > > mCellsToSendRight;
+    /** The cells to send to each neighbouring process, keyed by process rank */
+    std::map<unsigned, std::vector<std::pair<CellPtr, Node<DIM>* > > > mCellsToSend;
 
-    /** The cells to send to the left process */
-    std::vector<std::pair<CellPtr, Node<DIM>* > > mCellsToSendLeft;
+    /** Shared pointers to the cells received from each neighbouring process, keyed by process rank */
+    std::map<unsigned, boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > > mCellsRecv;
 
-    /** A shared pointer to the cells received from the right process */
-    boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > mpCellsRecvRight;
+    /** Communicators to send cells to each neighbouring process, keyed by process rank */
+    std::map<unsigned, PackedCellCommunicator<DIM> > mCommunicators;
 
-    /** A pointer to the cells received from the left process */
-    boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > > mpCellsRecvLeft;
+    /** The cells to send to the right process, i.e. the entry of #mCellsToSend for the next rank */
+    std::vector<std::pair<CellPtr, Node<DIM>* > >& mCellsToSendRight;
 
-    /** A communicator to send cells to the right hand process */
-    ObjectCommunicator<std::vector<std::pair<CellPtr, Node<DIM>* > > > mRightCommunicator;
+    /** The cells to send to the left process, i.e. the entry of #mCellsToSend for the previous rank */
+    std::vector<std::pair<CellPtr, Node<DIM>* > >& mCellsToSendLeft;
 
-    /** A communicator to send cells to the left hand process */
-    ObjectCommunicator<std::vector<std::pair<CellPtr, Node<DIM>* > > > mLeftCommunicator;
+    /** A shared pointer to the cells received from the right process, i.e. the entry of #mCellsRecv for the next rank */
+    boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > >& mpCellsRecvRight;
+
+    /** A shared pointer to the cells received from the left process, i.e. the entry of #mCellsRecv for the previous rank */
+    boost::shared_ptr<std::vector<std::pair<CellPtr, Node<DIM>* > > >& mpCellsRecvLeft;
 
     /** The tag used to send and recieve cell information */
     static const unsigned mCellCommunicationTag = 123;
@@ -120,6 +124,26 @@ private:
     /** The frequency at which the mesh is rebalanced */
     unsigned mLoadBalanceFrequency;
 
+    /**
+     * The Verlet skin: node pairs are found up to the mechanics cut-off length plus this distance,
+     * and reused until some node has moved more than half of it. Defaults to zero, in which case
+     * node pairs are found afresh every time step.
+     */
+    double mVerletSkin;
+
+    /** Whether the node pairs found at the last Verlet list rebuild may still be reused. */
+    bool mVerletListIsValid;
+
+    /** The nodes owned by this process and their locations at the last Verlet list rebuild. */
+    std::vector<std::pair<Node<DIM>*, c_vector<double, DIM> > > mVerletReferenceLocations;
+
+    /**
+     * The position in #mNodePairs, and the global index of the halo node, of each node pair
+     * involving a halo node. Halo nodes are replaced every time step, so these pairs are
+     * pointed at the new halo nodes when the Verlet list is reused.
+     */
+    std::vector<std::pair<unsigned, unsigned> > mVerletHaloPairs;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -136,6 +160,10 @@ private:
     {
         archive & boost::serialization::base_object<AbstractCentreBasedCellPopulation<DIM> >(*this);
         archive & mUseVariableRadii;
+        if (version > 0)
+        {
+            archive & mVerletSkin;
+        }
 
         this->Validate();
     }
@@ -170,7 +198,23 @@ private:
 
     /**
      * Add the node and cell with index nodeIndex to the list of cells to send
-     * to the process right.
+     * to a neighbouring process.
+     *
+     * @param nodeIndex the index of the node and cell to send.
+     * @param processIndex the rank of the neighbouring process.
+     */
+    void AddNodeAndCellToSend(unsigned nodeIndex, unsigned processIndex);
+
+    /**
+     * Replace the list of cells to send to a neighbouring process
+     * @param processIndex the rank of the neighbouring process.
+     * @param cellLocationIndices the list of location indices of cells to send.
+     */
+    void AddCellsToSend(unsigned processIndex, std::vector<unsigned>& cellLocationIndices);
+
+    /**
+     * Add the node and cell with index nodeIndex to the list of cells to send
+     * to the process right, when the mesh is split into strips.
      *
      * @param nodeIndex the index of the node and cell to send.
      */
@@ -178,20 +222,20 @@ private:
 
     /**
      * Add the node and cell with index nodeIndex to the list of cells to send
-     * to the process left.
+     * to the process left, when the mesh is split into strips.
      *
      * @param nodeIndex the index of the node and cell to send.
      */
     void AddNodeAndCellToSendLeft(unsigned nodeIndex);
 
     /**
-     * Add a collection of cells to send right
+     * Replace the list of cells to send right, when the mesh is split into strips.
      * @param cellLocationIndices the list of location indices of cells to send.
      */
     void AddCellsToSendRight(std::vector<unsigned>& cellLocationIndices);
 
     /**
-     * Add a collection of cells to send left
+     * Replace the list of cells to send left, when the mesh is split into strips.
      * @param cellLocationIndices the list of location indices of cells to send.
      */
     void AddCellsToSendLeft(std::vector<unsigned>& cellLocationIndices);
@@ -201,13 +245,51 @@ private:
      */
     void AddReceivedHaloCells();
 
+    /**
+     * Receive halo cells from neighbouring processes and add them to the halo structures on this
+     * process, without placing their nodes in the box collection.
+     */
+    void AddReceivedHaloCellsWithoutBoxes();
+
+    /**
+     * @return whether the Verlet list of node pairs must be rebuilt on this time step, on any process.
+     * It must if it has been invalidated, if rebuilding is forced, or if any node has moved more than
+     * half the Verlet skin since the last rebuild.
+     *
+     * @param forceRebuild whether to rebuild in any case (e.g. after births or deaths)
+     */
+    bool IsVerletListRebuildNeeded(bool forceRebuild);
+
+    /**
+     * Record the node locations, and the node pairs involving halo nodes, just after the node pairs have been found.
+     */
+    void StoreVerletList();
+
+    /**
+     * Point the node pairs involving halo nodes at the halo nodes received on this time step. Pairs whose
+     * halo node was not received are dropped: that node has left the halo boxes, so it is further than
+     * the mechanics cut-off length from every node on this process.
+     */
+    void UpdateVerletHaloNodePairs();
+
     /**
      * Add a single halo cell with its node to the halo structures on this process.
+     *
+     * Halo cells are copies of cells owned by other processes, which count them by their
+     * cell properties, so they stop being counted here.
+     *
      * @param pCell the cell to add.
      * @param pNode the node to add.
      */
     void AddHaloCell(CellPtr pCell, boost::shared_ptr<Node<DIM> > pNode);
 
+    /**
+     * Remove the halo cells.  As halo cells aren't counted by their cell properties (see
+     * AddHaloCell()), they are counted again just before being released, since a cell
+     * destroyed without being killed decrements the counts of its properties.
+     */
+    void ClearHaloCells();
+
     /**
      * Update the map between nodes and cells after a call to remesh.
      *
@@ -371,7 +453,7 @@ public:
     virtual void AcceptCellWriter(boost::shared_ptr<AbstractCellWriter<DIM, DIM> > pCellWriter, CellPtr pCell);
 
     /**
-     * @return the maximum interaction distance between cells, defined in NodesOnlyMesh.
+     * @return the maximum interaction distance between cells, defined in NodesOnlyMesh (less any Verlet skin).
      */
     double GetMechanicsCutOffLength();
 
@@ -399,6 +481,21 @@ public:
      */
     void SetLoadBalanceFrequency(unsigned loadBalanceFrequency);
 
+    /**
+     * Set the Verlet skin. If positive, node pairs are found up to the mechanics cut-off length plus
+     * the skin, and are only found again once some node has moved more than half the skin (or after
+     * cells are born, die or move between processes). The box collection is rebuilt with boxes of
+     * width the cut-off length plus the skin. A skin of zero finds node pairs every time step.
+     *
+     * @param verletSkin the Verlet skin
+     */
+    void SetVerletSkin(double verletSkin);
+
+    /**
+     * @return #mVerletSkin
+     */
+    double GetVerletSkin();
+
     /**
      * Overridden GetWidth() method.
      *
@@ -454,16 +551,16 @@ public:
     /////////////////////////////////////////////////////
 
     /**
-     * Send the contents of #mCellsToSendRight/Left to
+     * Send the contents of #mCellsToSend to
      * neighbouring processes and receive from them into
-     * #mpCellsRecvRight/Left.
+     * #mCellsRecv.
      */
     void SendCellsToNeighbourProcesses();
 
     /**
-     * Send the contents of #mCellsToSendRight/Left to
+     * Send the contents of #mCellsToSend to
      * neighbouring processes using asynchronous communication.
-     * #mpCellsRecvLeft/Right will not be updated until the
+     * #mCellsRecv will not be updated until the
      * equivalent GetReceivedCells() is called.
      */
     void NonBlockingSendCellsToNeighbourProcesses();
@@ -483,7 +580,7 @@ public:
     std::pair<CellPtr, Node<DIM>* > GetCellNodePair(unsigned nodeIndex);
 
     /**
-     * Add the contents of mpCellsRecvRight and mpCellsRecvLeft to the local population.
+     * Add the contents of #mCellsRecv to the local population.
      */
     void AddReceivedCells();
 
@@ -500,6 +597,19 @@ namespace boost
 {
 namespace serialization
 {
+/**
+ * Specify a version number for archive backwards compatibility.
+ *
+ * This is how to do BOOST_CLASS_VERSION(NodeBasedCellPopulation, 1)
+ * with a templated class.
+ */
+template <unsigned DIM>
+struct version<NodeBasedCellPopulation<DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(1);
+};
+
 /**
  * Serialize information required to construct a NodeBasedCellPopulation.
  */
@@ -0,0 +1,779 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+// Serialization headers - must come first
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/utility.hpp>
+
+#include "PackedCellCommunicator.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include <typeinfo>
+
+#include "CellPropertyRegistry.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "ApcOneHitCellMutationState.hpp"
+#include "ApcTwoHitCellMutationState.hpp"
+#include "BetaCateninOneHitCellMutationState.hpp"
+#include "DefaultCellProliferativeType.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "StemCellProliferativeType.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "FixedDurationGenerationBasedCellCycleModel.hpp"
+#include "StochasticDurationGenerationBasedCellCycleModel.hpp"
+#include "StochasticDurationCellCycleModel.hpp"
+#include "GammaDistributedStochasticDurationCellCycleModel.hpp"
+#include "Exception.hpp"
+
+/**
+ * The version of the packed cell format. This must be incremented whenever the format
+ * changes, so that mismatched builds fail cleanly rather than misreading each other.
+ */
+static const unsigned PACKED_CELL_FORMAT_VERSION = 2;
+
+template<unsigned DIM>
+template<typename TYPE>
+void PackedCellCommunicator<DIM>::Write(std::vector<char>& rBuffer, const TYPE& rValue)
+{
+    unsigned position = rBuffer.size();
+    rBuffer.resize(position + sizeof(TYPE));
+    memcpy(&rBuffer[position], &rValue, sizeof(TYPE));
+}
+
+template<unsigned DIM>
+template<typename TYPE>
+TYPE PackedCellCommunicator<DIM>::Read(const char* pBuffer, unsigned size, unsigned& rPosition)
+{
+    if (rPosition + sizeof(TYPE) > size)
+    {
+        EXCEPTION("Packed cell buffer ended unexpectedly");
+    }
+    TYPE value;
+    memcpy(&value, pBuffer + rPosition, sizeof(TYPE));
+    rPosition += sizeof(TYPE);
+    return value;
+}
+
+template<unsigned DIM>
+unsigned PackedCellCommunicator<DIM>::GetCellCycleModelCode(AbstractCellCycleModel* pModel)
+{
+    // Only models whose state is all known here are packed, so subclasses must match exactly
+    const std::type_info& r_info = typeid(*pModel);
+    if (r_info == typeid(FixedDurationGenerationBasedCellCycleModel))
+    {
+        return FIXED_DURATION_GENERATION_BASED;
+    }
+    if (r_info == typeid(StochasticDurationGenerationBasedCellCycleModel))
+    {
+        return STOCHASTIC_DURATION_GENERATION_BASED;
+    }
+    if (r_info == typeid(StochasticDurationCellCycleModel))
+    {
+        return STOCHASTIC_DURATION;
+    }
+    if (r_info == typeid(GammaDistributedStochasticDurationCellCycleModel))
+    {
+        return GAMMA_DISTRIBUTED_STOCHASTIC_DURATION;
+    }
+    return NUM_CELL_CYCLE_MODEL_CODES;
+}
+
+template<unsigned DIM>
+unsigned PackedCellCommunicator<DIM>::GetSharedPropertyCodeOfType(const boost::shared_ptr<AbstractCellProperty>& pProperty)
+{
+    if (pProperty->IsType<WildTypeCellMutationState>())
+    {
+        return WILD_TYPE;
+    }
+    if (pProperty->IsType<ApcOneHitCellMutationState>())
+    {
+        return APC_ONE_HIT;
+    }
+    if (pProperty->IsType<ApcTwoHitCellMutationState>())
+    {
+        return APC_TWO_HIT;
+    }
+    if (pProperty->IsType<BetaCateninOneHitCellMutationState>())
+    {
+        return BETA_CATENIN_ONE_HIT;
+    }
+    if (pProperty->IsType<DefaultCellProliferativeType>())
+    {
+        return DEFAULT_TYPE;
+    }
+    if (pProperty->IsType<DifferentiatedCellProliferativeType>())
+    {
+        return DIFFERENTIATED_TYPE;
+    }
+    if (pProperty->IsType<StemCellProliferativeType>())
+    {
+        return STEM_TYPE;
+    }
+    if (pProperty->IsType<TransitCellProliferativeType>())
+    {
+        return TRANSIT_TYPE;
+    }
+    if (pProperty->IsType<ApoptoticCellProperty>())
+    {
+        return APOPTOTIC;
+    }
+    if (pProperty->IsType<CellLabel>())
+    {
+        return SHARED_LABEL;
+    }
+    return UINT_MAX;
+}
+
+template<unsigned DIM>
+unsigned PackedCellCommunicator<DIM>::GetPropertyCode(const boost::shared_ptr<AbstractCellProperty>& pProperty)
+{
+    const std::vector<boost::shared_ptr<AbstractCellProperty> >& r_registered
+        = CellPropertyRegistry::Instance()->rGetAllCellProperties();
+
+    if (std::find(r_registered.begin(), r_registered.end(), pProperty) != r_registered.end())
+    {
+        return GetSharedPropertyCodeOfType(pProperty);
+    }
+    else
+    {
+        if (pProperty->IsType<CellId>())
+        {
+            return CELL_ID;
+        }
+        if (pProperty->IsType<CellData>())
+        {
+            return CELL_DATA;
+        }
+        if (pProperty->IsType<CellAncestor>())
+        {
+            return CELL_ANCESTOR;
+        }
+        if (pProperty->IsType<CellLabel>())
+        {
+            return CELL_LABEL;
+        }
+    }
+    return UINT_MAX;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<AbstractCellProperty> PackedCellCommunicator<DIM>::GetSharedProperty(unsigned code)
+{
+    CellPropertyRegistry* p_registry = CellPropertyRegistry::Instance();
+    switch (code)
+    {
+        case WILD_TYPE:
+            return p_registry->Get<WildTypeCellMutationState>();
+        case APC_ONE_HIT:
+            return p_registry->Get<ApcOneHitCellMutationState>();
+        case APC_TWO_HIT:
+            return p_registry->Get<ApcTwoHitCellMutationState>();
+        case BETA_CATENIN_ONE_HIT:
+            return p_registry->Get<BetaCateninOneHitCellMutationState>();
+        case DEFAULT_TYPE:
+            return p_registry->Get<DefaultCellProliferativeType>();
+        case DIFFERENTIATED_TYPE:
+            return p_registry->Get<DifferentiatedCellProliferativeType>();
+        case STEM_TYPE:
+            return p_registry->Get<StemCellProliferativeType>();
+        case TRANSIT_TYPE:
+            return p_registry->Get<TransitCellProliferativeType>();
+        case APOPTOTIC:
+            return p_registry->Get<ApoptoticCellProperty>();
+        case SHARED_LABEL:
+            return p_registry->Get<CellLabel>();
+        default:
+            EXCEPTION("Unknown shared cell property code " << code << " in packed cells");
+    }
+}
+
+template<unsigned DIM>
+bool PackedCellCommunicator<DIM>::HasSharedLabel(CellPtr pCell)
+{
+    CellPropertyCollection& r_collection = pCell->rGetCellPropertyCollection();
+    for (CellPropertyCollection::Iterator property_iter = r_collection.Begin();
+         property_iter != r_collection.End();
+         ++property_iter)
+    {
+        if (GetPropertyCode(*property_iter) == SHARED_LABEL)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+template<unsigned DIM>
+void PackedCellCommunicator<DIM>::ShareArchivedProperties(CellPtr pCell, bool hasSharedLabel)
+{
+    CellPropertyCollection& r_collection = pCell->mCellPropertyCollection;
+    std::vector<boost::shared_ptr<AbstractCellProperty> > archived_properties(r_collection.Begin(), r_collection.End());
+
+    for (unsigned i=0; i<archived_properties.size(); i++)
+    {
+        unsigned code = GetSharedPropertyCodeOfType(archived_properties[i]);
+        if (code == SHARED_LABEL)
+        {
+            if (!hasSharedLabel)
+            {
+                continue;
+            }
+            hasSharedLabel = false;
+        }
+        if (code != UINT_MAX)
+        {
+            boost::shared_ptr<AbstractCellProperty> p_shared = GetSharedProperty(code);
+            r_collection.RemoveProperty(archived_properties[i]);
+            r_collection.AddProperty(p_shared);
+            if (!pCell->mIsDead)
+            {
+                p_shared->IncrementCellCount();
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+bool PackedCellCommunicator<DIM>::CanPackCell(CellPtr pCell)
+{
+    if (GetCellCycleModelCode(pCell->GetCellCycleModel()) == NUM_CELL_CYCLE_MODEL_CODES)
+    {
+        return false;
+    }
+
+    CellPropertyCollection& r_collection = pCell->rGetCellPropertyCollection();
+    for (CellPropertyCollection::Iterator property_iter = r_collection.Begin();
+         property_iter != r_collection.End();
+         ++property_iter)
+    {
+        if (GetPropertyCode(*property_iter) == UINT_MAX)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<unsigned DIM>
+void PackedCellCommunicator<DIM>::PackCell(const std::pair<CellPtr, Node<DIM>* >& rPair,
+                                           std::vector<char>& rBuffer,
+                                           std::map<std::string, unsigned>& rKeys)
+{
+    // The node, as copied by NodesOnlyMesh::AddMovedNode()
+    Node<DIM>* p_node = rPair.second;
+    c_vector<double, DIM> location = p_node->GetPoint().rGetLocation();
+    for (unsigned i=0; i<DIM; i++)
+    {
+        Write(rBuffer, location[i]);
+    }
+    Write(rBuffer, p_node->GetIndex());
+    Write(rBuffer, p_node->IsBoundaryNode());
+
+    bool has_attributes = p_node->HasNodeAttributes();
+    Write(rBuffer, has_attributes);
+    if (has_attributes)
+    {
+        Write(rBuffer, p_node->GetRadius());
+        Write(rBuffer, p_node->GetRegion());
+        Write(rBuffer, p_node->IsParticle());
+
+        std::vector<double>& r_attributes = p_node->rGetNodeAttributes();
+        Write(rBuffer, (unsigned)r_attributes.size());
+        for (unsigned i=0; i<r_attributes.size(); i++)
+        {
+            Write(rBuffer, r_attributes[i]);
+        }
+    }
+
+    // The cell, as archived by Cell::serialize()
+    CellPtr p_cell = rPair.first;
+    Write(rBuffer, p_cell->mCanDivide);
+    Write(rBuffer, p_cell->mUndergoingApoptosis);
+    Write(rBuffer, p_cell->mIsDead);
+    Write(rBuffer, p_cell->mIsLogged);
+    Write(rBuffer, p_cell->mDeathTime);
+    Write(rBuffer, p_cell->mStartOfApoptosisTime);
+    Write(rBuffer, p_cell->mApoptosisTime);
+
+    // The cell-cycle model, as archived by AbstractCellCycleModel::serialize() and the subclasses
+    AbstractCellCycleModel* p_model = p_cell->GetCellCycleModel();
+    unsigned model_code = GetCellCycleModelCode(p_model);
+    Write(rBuffer, model_code);
+    Write(rBuffer, p_model->mBirthTime);
+    Write(rBuffer, (unsigned)p_model->mCurrentCellCyclePhase);
+    Write(rBuffer, p_model->mG1Duration);
+    Write(rBuffer, p_model->mReadyToDivide);
+    Write(rBuffer, p_model->mDimension);
+    Write(rBuffer, p_model->mMinimumGapDuration);
+    Write(rBuffer, p_model->mStemCellG1Duration);
+    Write(rBuffer, p_model->mTransitCellG1Duration);
+    Write(rBuffer, p_model->mSDuration);
+    Write(rBuffer, p_model->mG2Duration);
+    Write(rBuffer, p_model->mMDuration);
+
+    if (model_code == FIXED_DURATION_GENERATION_BASED || model_code == STOCHASTIC_DURATION_GENERATION_BASED)
+    {
+        AbstractSimpleGenerationBasedCellCycleModel* p_generation_model = static_cast<AbstractSimpleGenerationBasedCellCycleModel*>(p_model);
+        Write(rBuffer, p_generation_model->GetGeneration());
+        Write(rBuffer, p_generation_model->GetMaxTransitGenerations());
+    }
+    else if (model_code == GAMMA_DISTRIBUTED_STOCHASTIC_DURATION)
+    {
+        GammaDistributedStochasticDurationCellCycleModel* p_gamma_model = static_cast<GammaDistributedStochasticDurationCellCycleModel*>(p_model);
+        Write(rBuffer, p_gamma_model->GetShape());
+        Write(rBuffer, p_gamma_model->GetScale());
+    }
+
+    // The cell properties
+    CellPropertyCollection& r_collection = p_cell->rGetCellPropertyCollection();
+    Write(rBuffer, r_collection.GetSize());
+    for (CellPropertyCollection::Iterator property_iter = r_collection.Begin();
+         property_iter != r_collection.End();
+         ++property_iter)
+    {
+        unsigned code = GetPropertyCode(*property_iter);
+        Write(rBuffer, code);
+
+        switch (code)
+        {
+            case CELL_ID:
+                Write(rBuffer, boost::static_pointer_cast<CellId>(*property_iter)->mCellId);
+                break;
+            case CELL_DATA:
+            {
+                boost::shared_ptr<CellData> p_data = boost::static_pointer_cast<CellData>(*property_iter);
+                std::vector<std::string> keys = p_data->GetKeys();
+                Write(rBuffer, (unsigned)keys.size());
+                for (unsigned i=0; i<keys.size(); i++)
+                {
+                    std::map<std::string, unsigned>::iterator key_iter = rKeys.find(keys[i]);
+                    if (key_iter == rKeys.end())
+                    {
+                        unsigned key_index = rKeys.size();
+                        key_iter = rKeys.insert(std::make_pair(keys[i], key_index)).first;
+                    }
+                    Write(rBuffer, key_iter->second);
+                    Write(rBuffer, p_data->GetItem(keys[i]));
+                }
+                break;
+            }
+            case CELL_ANCESTOR:
+                Write(rBuffer, boost::static_pointer_cast<CellAncestor>(*property_iter)->GetAncestor());
+                break;
+            case CELL_LABEL:
+                Write(rBuffer, boost::static_pointer_cast<CellLabel>(*property_iter)->GetColour());
+                break;
+            default:
+                // Shared properties are identified by their code alone
+                break;
+        }
+    }
+}
+
+template<unsigned DIM>
+std::pair<CellPtr, Node<DIM>* > PackedCellCommunicator<DIM>::UnpackCell(const char* pBuffer,
+                                                                       unsigned size,
+                                                                       unsigned& rPosition,
+                                                                       const std::vector<std::string>& rKeys)
+{
+    // The node
+    c_vector<double, DIM> location;
+    for (unsigned i=0; i<DIM; i++)
+    {
+        location[i] = Read<double>(pBuffer, size, rPosition);
+    }
+    unsigned index = Read<unsigned>(pBuffer, size, rPosition);
+    bool is_boundary = Read<bool>(pBuffer, size, rPosition);
+    Node<DIM>* p_node = new Node<DIM>(index, location, is_boundary);
+
+    if (Read<bool>(pBuffer, size, rPosition))
+    {
+        p_node->SetRadius(Read<double>(pBuffer, size, rPosition));
+        p_node->SetRegion(Read<unsigned>(pBuffer, size, rPosition));
+        p_node->SetIsParticle(Read<bool>(pBuffer, size, rPosition));
+
+        unsigned num_attributes = Read<unsigned>(pBuffer, size, rPosition);
+        for (unsigned i=0; i<num_attributes; i++)
+        {
+            p_node->AddNodeAttribute(Read<double>(pBuffer, size, rPosition));
+        }
+    }
+
+    // The cell
+    bool can_divide = Read<bool>(pBuffer, size, rPosition);
+    bool undergoing_apoptosis = Read<bool>(pBuffer, size, rPosition);
+    bool is_dead = Read<bool>(pBuffer, size, rPosition);
+    bool is_logged = Read<bool>(pBuffer, size, rPosition);
+    double death_time = Read<double>(pBuffer, size, rPosition);
+    double start_of_apoptosis_time = Read<double>(pBuffer, size, rPosition);
+    double apoptosis_time = Read<double>(pBuffer, size, rPosition);
+
+    // The cell-cycle model
+    unsigned model_code = Read<unsigned>(pBuffer, size, rPosition);
+    AbstractCellCycleModel* p_model;
+    switch (model_code)
+    {
+        case FIXED_DURATION_GENERATION_BASED:
+            p_model = new FixedDurationGenerationBasedCellCycleModel;
+            break;
+        case STOCHASTIC_DURATION_GENERATION_BASED:
+            p_model = new StochasticDurationGenerationBasedCellCycleModel;
+            break;
+        case STOCHASTIC_DURATION:
+            p_model = new StochasticDurationCellCycleModel;
+            break;
+        case GAMMA_DISTRIBUTED_STOCHASTIC_DURATION:
+            p_model = new GammaDistributedStochasticDurationCellCycleModel;
+            break;
+        default:
+            delete p_node;
+            EXCEPTION("Unknown cell-cycle model code " << model_code << " in packed cells");
+    }
+    p_model->mBirthTime = Read<double>(pBuffer, size, rPosition);
+    p_model->mCurrentCellCyclePhase = (CellCyclePhase)Read<unsigned>(pBuffer, size, rPosition);
+    p_model->mG1Duration = Read<double>(pBuffer, size, rPosition);
+    p_model->mReadyToDivide = Read<bool>(pBuffer, size, rPosition);
+    p_model->mDimension = Read<unsigned>(pBuffer, size, rPosition);
+    p_model->mMinimumGapDuration = Read<double>(pBuffer, size, rPosition);
+    p_model->mStemCellG1Duration = Read<double>(pBuffer, size, rPosition);
+    p_model->mTransitCellG1Duration = Read<double>(pBuffer, size, rPosition);
+    p_model->mSDuration = Read<double>(pBuffer, size, rPosition);
+    p_model->mG2Duration = Read<double>(pBuffer, size, rPosition);
+    p_model->mMDuration = Read<double>(pBuffer, size, rPosition);
+
+    if (model_code == FIXED_DURATION_GENERATION_BASED || model_code == STOCHASTIC_DURATION_GENERATION_BASED)
+    {
+        AbstractSimpleGenerationBasedCellCycleModel* p_generation_model = static_cast<AbstractSimpleGenerationBasedCellCycleModel*>(p_model);
+        p_generation_model->SetGeneration(Read<unsigned>(pBuffer, size, rPosition));
+        p_generation_model->SetMaxTransitGenerations(Read<unsigned>(pBuffer, size, rPosition));
+    }
+    else if (model_code == GAMMA_DISTRIBUTED_STOCHASTIC_DURATION)
+    {
+        GammaDistributedStochasticDurationCellCycleModel* p_gamma_model = static_cast<GammaDistributedStochasticDurationCellCycleModel*>(p_model);
+        p_gamma_model->SetShape(Read<double>(pBuffer, size, rPosition));
+        p_gamma_model->SetScale(Read<double>(pBuffer, size, rPosition));
+    }
+
+    // The cell properties
+    CellPropertyCollection collection;
+    boost::shared_ptr<AbstractCellProperty> p_mutation_state;
+    unsigned num_properties = Read<unsigned>(pBuffer, size, rPosition);
+    for (unsigned i=0; i<num_properties; i++)
+    {
+        unsigned code = Read<unsigned>(pBuffer, size, rPosition);
+        if (code < NUM_SHARED_PROPERTY_CODES)
+        {
+            boost::shared_ptr<AbstractCellProperty> p_property = GetSharedProperty(code);
+            if (p_property->IsSubType<AbstractCellMutationState>())
+            {
+                p_mutation_state = p_property;
+            }
+            collection.AddProperty(p_property);
+        }
+        else if (code == CELL_ID)
+        {
+            MAKE_PTR(CellId, p_cell_id);
+            p_cell_id->mCellId = Read<unsigned>(pBuffer, size, rPosition);
+            collection.AddProperty(p_cell_id);
+        }
+        else if (code == CELL_DATA)
+        {
+            MAKE_PTR(CellData, p_data);
+            unsigned num_items = Read<unsigned>(pBuffer, size, rPosition);
+            for (unsigned j=0; j<num_items; j++)
+            {
+                unsigned key_index = Read<unsigned>(pBuffer, size, rPosition);
+                if (key_index >= rKeys.size())
+                {
+                    EXCEPTION("Cell data key " << key_index << " is not in the packed key table");
+                }
+                p_data->SetItem(rKeys[key_index], Read<double>(pBuffer, size, rPosition));
+            }
+            collection.AddProperty(p_data);
+        }
+        else if (code == CELL_ANCESTOR)
+        {
+            MAKE_PTR_ARGS(CellAncestor, p_ancestor, (Read<unsigned>(pBuffer, size, rPosition)));
+            collection.AddProperty(p_ancestor);
+        }
+        else if (code == CELL_LABEL)
+        {
+            MAKE_PTR_ARGS(CellLabel, p_label, (Read<unsigned>(pBuffer, size, rPosition)));
+            collection.AddProperty(p_label);
+        }
+        else
+        {
+            EXCEPTION("Unknown cell property code " << code << " in packed cells");
+        }
+    }
+    if (!p_mutation_state)
+    {
+        EXCEPTION("Packed cell has no mutation state");
+    }
+
+    /*
+     * The cell is created as a new cell rather than an archived one, so that the counts of
+     * its shared properties on this process are incremented. The sending process decrements
+     * its counts when the cell leaves (see NodeBasedCellPopulation::DeleteMovedCell()).
+     * Halo copies are uncounted again by NodeBasedCellPopulation::AddHaloCell().
+     */
+    CellPtr p_cell(new Cell(p_mutation_state, p_model, false, collection));
+    p_cell->mCanDivide = can_divide;
+    p_cell->mUndergoingApoptosis = undergoing_apoptosis;
+    p_cell->mIsLogged = is_logged;
+    p_cell->mDeathTime = death_time;
+    p_cell->mStartOfApoptosisTime = start_of_apoptosis_time;
+    p_cell->mApoptosisTime = apoptosis_time;
+    if (is_dead)
+    {
+        p_cell->Kill();
+    }
+
+    return std::pair<CellPtr, Node<DIM>* >(p_cell, p_node);
+}
+
+template<unsigned DIM>
+PackedCellCommunicator<DIM>::PackedCellCommunicator()
+    : mIsSending(false),
+      mRecvProcess(0),
+      mRecvTag(0),
+      mIsWaitingToReceive(false)
+{
+}
+
+template<unsigned DIM>
+void PackedCellCommunicator<DIM>::PackCells(const CellNodePairs& rCells, std::vector<char>& rBuffer)
+{
+    std::vector<char> packed_cells;
+    std::map<std::string, unsigned> keys;
+    unsigned num_packed_cells = 0;
+    boost::shared_ptr<CellNodePairs> p_archived_cells(new CellNodePairs);
+
+    for (unsigned i=0; i<rCells.size(); i++)
+    {
+        if (CanPackCell(rCells[i].first))
+        {
+            PackCell(rCells[i], packed_cells, keys);
+            num_packed_cells++;
+        }
+        else
+        {
+            p_archived_cells->push_back(rCells[i]);
+        }
+    }
+
+    rBuffer.clear();
+    Write(rBuffer, PACKED_CELL_FORMAT_VERSION);
+
+    // The CellData key table, in order of first use
+    std::vector<std::string> key_table(keys.size());
+    for (std::map<std::string, unsigned>::iterator key_iter = keys.begin();
+         key_iter != keys.end();
+         ++key_iter)
+    {
+        key_table[key_iter->second] = key_iter->first;
+    }
+    Write(rBuffer, (unsigned)key_table.size());
+    for (unsigned i=0; i<key_table.size(); i++)
+    {
+        Write(rBuffer, (unsigned)key_table[i].size());
+        rBuffer.insert(rBuffer.end(), key_table[i].begin(), key_table[i].end());
+    }
+
+    Write(rBuffer, num_packed_cells);
+    rBuffer.insert(rBuffer.end(), packed_cells.begin(), packed_cells.end());
+
+    // Any cells that could not be packed are archived with Boost
+    std::string archive_string;
+    if (!p_archived_cells->empty())
+    {
+        std::ostringstream ss(std::ios::binary);
+        boost::archive::binary_oarchive output_arch(ss);
+        output_arch << p_archived_cells;
+        archive_string = ss.str();
+    }
+    Write(rBuffer, (unsigned)archive_string.size());
+    rBuffer.insert(rBuffer.end(), archive_string.begin(), archive_string.end());
+
+    // Archived properties can't be told apart from shared ones by type alone if they are labels
+    for (unsigned i=0; i<p_archived_cells->size(); i++)
+    {
+        Write(rBuffer, HasSharedLabel((*p_archived_cells)[i].first));
+    }
+}
+
+template<unsigned DIM>
+boost::shared_ptr<typename PackedCellCommunicator<DIM>::CellNodePairs> PackedCellCommunicator<DIM>::UnpackCells(const char* pBuffer, unsigned size)
+{
+    unsigned position = 0;
+    unsigned version = Read<unsigned>(pBuffer, size, position);
+    if (version != PACKED_CELL_FORMAT_VERSION)
+    {
+        EXCEPTION("Cannot unpack cells packed with format version " << version << "; expected version " << PACKED_CELL_FORMAT_VERSION);
+    }
+
+    unsigned num_keys = Read<unsigned>(pBuffer, size, position);
+    std::vector<std::string> keys(num_keys);
+    for (unsigned i=0; i<num_keys; i++)
+    {
+        unsigned length = Read<unsigned>(pBuffer, size, position);
+        if (position + length > size)
+        {
+            EXCEPTION("Packed cell buffer ended unexpectedly");
+        }
+        keys[i].assign(pBuffer + position, length);
+        position += length;
+    }
+
+    boost::shared_ptr<CellNodePairs> p_cells(new CellNodePairs);
+    unsigned num_packed_cells = Read<unsigned>(pBuffer, size, position);
+    p_cells->reserve(num_packed_cells);
+    for (unsigned i=0; i<num_packed_cells; i++)
+    {
+        p_cells->push_back(UnpackCell(pBuffer, size, position, keys));
+    }
+
+    unsigned archive_length = Read<unsigned>(pBuffer, size, position);
+    if (archive_length > 0)
+    {
+        if (position + archive_length > size)
+        {
+            EXCEPTION("Packed cell buffer ended unexpectedly");
+        }
+        std::istringstream ss(std::string(pBuffer + position, archive_length), std::ios::binary);
+        boost::archive::binary_iarchive input_arch(ss);
+
+        boost::shared_ptr<CellNodePairs> p_archived_cells;
+        input_arch >> p_archived_cells;
+        position += archive_length;
+
+        /*
+         * The shared properties of archived cells arrive as copies, so replace them with those of
+         * the CellPropertyRegistry on this process and count the cells, as for packed cells.
+         */
+        for (unsigned i=0; i<p_archived_cells->size(); i++)
+        {
+            ShareArchivedProperties((*p_archived_cells)[i].first, Read<bool>(pBuffer, size, position));
+        }
+        p_cells->insert(p_cells->end(), p_archived_cells->begin(), p_archived_cells->end());
+    }
+
+    return p_cells;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<typename PackedCellCommunicator<DIM>::CellNodePairs> PackedCellCommunicator<DIM>::ProbeAndRecvCells(unsigned sourceProcess, unsigned tag)
+{
+    // Probe for the size of the message so that it can be received in one go
+    MPI_Status status;
+    MPI_Probe(sourceProcess, tag, PetscTools::GetWorld(), &status);
+    int message_size;
+    MPI_Get_count(&status, MPI_BYTE, &message_size);
+
+    std::vector<char> recv_buffer(message_size);
+    MPI_Recv(&recv_buffer[0], message_size, MPI_BYTE, sourceProcess, tag, PetscTools::GetWorld(), &status);
+
+    return UnpackCells(&recv_buffer[0], message_size);
+}
+
+template<unsigned DIM>
+void PackedCellCommunicator<DIM>::WaitForSend()
+{
+    if (mIsSending)
+    {
+        MPI_Status status;
+        MPI_Wait(&mSendRequest, &status);
+        mIsSending = false;
+    }
+}
+
+template<unsigned DIM>
+boost::shared_ptr<typename PackedCellCommunicator<DIM>::CellNodePairs> PackedCellCommunicator<DIM>::SendRecvCells(const CellNodePairs& rCells,
+                                                                                                                  unsigned destinationProcess,
+                                                                                                                  unsigned sendTag,
+                                                                                                                  unsigned sourceProcess,
+                                                                                                                  unsigned sourceTag)
+{
+    ISendCells(rCells, destinationProcess, sendTag);
+    boost::shared_ptr<CellNodePairs> p_cells = ProbeAndRecvCells(sourceProcess, sourceTag);
+    WaitForSend();
+
+    return p_cells;
+}
+
+template<unsigned DIM>
+void PackedCellCommunicator<DIM>::ISendCells(const CellNodePairs& rCells, unsigned destinationProcess, unsigned tag)
+{
+    // Don't overwrite a buffer that is still being sent
+    WaitForSend();
+
+    PackCells(rCells, mSendBuffer);
+    MPI_Isend(&mSendBuffer[0], mSendBuffer.size(), MPI_BYTE, destinationProcess, tag, PetscTools::GetWorld(), &mSendRequest);
+    mIsSending = true;
+}
+
+template<unsigned DIM>
+void PackedCellCommunicator<DIM>::IRecvCells(unsigned sourceProcess, unsigned tag)
+{
+    // The message size is not known yet, so the receive itself is posted by GetRecvCells()
+    mRecvProcess = sourceProcess;
+    mRecvTag = tag;
+    mIsWaitingToReceive = true;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<typename PackedCellCommunicator<DIM>::CellNodePairs> PackedCellCommunicator<DIM>::GetRecvCells()
+{
+    if (!mIsWaitingToReceive)
+    {
+        EXCEPTION("No receive has been set up by IRecvCells()");
+    }
+    boost::shared_ptr<CellNodePairs> p_cells = ProbeAndRecvCells(mRecvProcess, mRecvTag);
+    mIsWaitingToReceive = false;
+    WaitForSend();
+
+    return p_cells;
+}
+
+// Explicit instantiation
+template class PackedCellCommunicator<1>;
+template class PackedCellCommunicator<2>;
+template class PackedCellCommunicator<3>;
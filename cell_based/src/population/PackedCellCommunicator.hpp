@@ -0,0 +1,310 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PACKEDCELLCOMMUNICATOR_HPP_
+#define PACKEDCELLCOMMUNICATOR_HPP_
+
+#include <vector>
+#include <map>
+#include <string>
+#include <utility>
+#include <boost/shared_ptr.hpp>
+
+#include "PetscTools.hpp" // For MPI methods
+#include "Cell.hpp"
+#include "Node.hpp"
+
+/**
+ * Sends cells, together with their nodes, between processes in parallel node-based
+ * simulations.
+ *
+ * Rather than archiving each cell with Boost, the common cell state is written into a
+ * flat, versioned byte buffer: the node location and attributes, the Cell flags and
+ * times, the state of the simple cell-cycle models listed in CellCycleModelCode and the
+ * cell properties listed in PropertyCode. Shared properties, such as mutation states
+ * and proliferative types, are sent as codes and resolved through the
+ * CellPropertyRegistry of the receiving process. The keys of each CellData are stored
+ * once per message.
+ *
+ * Cells with any other cell-cycle model or property are archived with Boost and
+ * appended to the same message, so every exchange with a neighbouring process is a
+ * single MPI message whatever the cells contain. The shared properties of these cells
+ * are also replaced by those of the receiving CellPropertyRegistry.
+ *
+ * Received cells that are not dead are counted by their shared properties on the
+ * receiving process; the sender stops counting a cell when it is removed from its
+ * population. Halo copies are not counted: NodeBasedCellPopulation::AddHaloCell()
+ * stops counting them on receipt.
+ *
+ * The interface follows ObjectCommunicator, which this class replaces in
+ * NodeBasedCellPopulation.
+ */
+template<unsigned DIM>
+class PackedCellCommunicator
+{
+public:
+
+    /** The type of the cells and nodes sent and received. */
+    typedef std::vector<std::pair<CellPtr, Node<DIM>* > > CellNodePairs;
+
+private:
+
+    /** Codes for the cell-cycle models that are packed without Boost. */
+    enum CellCycleModelCode
+    {
+        FIXED_DURATION_GENERATION_BASED = 0,
+        STOCHASTIC_DURATION_GENERATION_BASED,
+        STOCHASTIC_DURATION,
+        GAMMA_DISTRIBUTED_STOCHASTIC_DURATION,
+        NUM_CELL_CYCLE_MODEL_CODES
+    };
+
+    /**
+     * Codes for the cell properties that are packed without Boost. The first
+     * NUM_SHARED_PROPERTY_CODES are shared through the CellPropertyRegistry and
+     * are sent without any data.
+     */
+    enum PropertyCode
+    {
+        WILD_TYPE = 0,
+        APC_ONE_HIT,
+        APC_TWO_HIT,
+        BETA_CATENIN_ONE_HIT,
+        DEFAULT_TYPE,
+        DIFFERENTIATED_TYPE,
+        STEM_TYPE,
+        TRANSIT_TYPE,
+        APOPTOTIC,
+        SHARED_LABEL,
+        NUM_SHARED_PROPERTY_CODES,
+        CELL_ID = NUM_SHARED_PROPERTY_CODES,
+        CELL_DATA,
+        CELL_ANCESTOR,
+        CELL_LABEL
+    };
+
+    /** The buffer holding the last message sent, which must persist until the send completes. */
+    std::vector<char> mSendBuffer;
+
+    /** The request for the last non-blocking send. */
+    MPI_Request mSendRequest;
+
+    /** Whether mSendRequest refers to a send that has not yet been waited for. */
+    bool mIsSending;
+
+    /** The process to receive from, set by IRecvCells(). */
+    unsigned mRecvProcess;
+
+    /** The tag to receive with, set by IRecvCells(). */
+    unsigned mRecvTag;
+
+    /** Whether IRecvCells() has been called since the last GetRecvCells(). */
+    bool mIsWaitingToReceive;
+
+    /**
+     * Append a value to a buffer.
+     *
+     * @param rBuffer the buffer
+     * @param rValue the value
+     */
+    template<typename TYPE>
+    static void Write(std::vector<char>& rBuffer, const TYPE& rValue);
+
+    /**
+     * Read a value from a buffer.
+     *
+     * @param pBuffer the buffer
+     * @param size the size of the buffer in bytes
+     * @param rPosition the position to read from, advanced past the value
+     * @return the value
+     */
+    template<typename TYPE>
+    static TYPE Read(const char* pBuffer, unsigned size, unsigned& rPosition);
+
+    /**
+     * @return the code of a cell-cycle model, or NUM_CELL_CYCLE_MODEL_CODES if it must be sent with Boost
+     *
+     * @param pModel the cell-cycle model
+     */
+    static unsigned GetCellCycleModelCode(AbstractCellCycleModel* pModel);
+
+    /**
+     * @return the shared code for the type of a cell property, whether or not it is the one in the
+     * CellPropertyRegistry, or UINT_MAX if the type is never shared
+     *
+     * @param pProperty the cell property
+     */
+    static unsigned GetSharedPropertyCodeOfType(const boost::shared_ptr<AbstractCellProperty>& pProperty);
+
+    /**
+     * @return the code of a cell property, or UINT_MAX if it must be sent with Boost
+     *
+     * @param pProperty the cell property
+     */
+    static unsigned GetPropertyCode(const boost::shared_ptr<AbstractCellProperty>& pProperty);
+
+    /**
+     * @return the property of the given shared code from this process's CellPropertyRegistry
+     *
+     * @param code the property code
+     */
+    static boost::shared_ptr<AbstractCellProperty> GetSharedProperty(unsigned code);
+
+    /**
+     * @return whether a cell has the CellLabel from the CellPropertyRegistry
+     *
+     * @param pCell the cell
+     */
+    static bool HasSharedLabel(CellPtr pCell);
+
+    /**
+     * Replace the copies of shared properties in a cell archived with Boost by those of the
+     * CellPropertyRegistry on this process, incrementing their cell counts unless the cell is dead.
+     *
+     * @param pCell the cell
+     * @param hasSharedLabel whether the cell had the shared CellLabel on the sending process
+     */
+    static void ShareArchivedProperties(CellPtr pCell, bool hasSharedLabel);
+
+    /**
+     * @return whether a cell can be packed without Boost
+     *
+     * @param pCell the cell
+     */
+    static bool CanPackCell(CellPtr pCell);
+
+    /**
+     * Append a cell and its node to a buffer.
+     *
+     * @param rPair the cell and node
+     * @param rBuffer the buffer
+     * @param rKeys the CellData keys seen so far, mapped to their position in the key table
+     */
+    static void PackCell(const std::pair<CellPtr, Node<DIM>* >& rPair,
+                         std::vector<char>& rBuffer,
+                         std::map<std::string, unsigned>& rKeys);
+
+    /**
+     * @return a new cell and node read from a buffer
+     *
+     * @param pBuffer the buffer
+     * @param size the size of the buffer in bytes
+     * @param rPosition the position of the cell in the buffer, advanced past it
+     * @param rKeys the CellData key table
+     */
+    static std::pair<CellPtr, Node<DIM>* > UnpackCell(const char* pBuffer,
+                                                      unsigned size,
+                                                      unsigned& rPosition,
+                                                      const std::vector<std::string>& rKeys);
+
+    /**
+     * @return the cells in a message received from a given process
+     *
+     * @param sourceProcess the process to receive from
+     * @param tag the message tag
+     */
+    boost::shared_ptr<CellNodePairs> ProbeAndRecvCells(unsigned sourceProcess, unsigned tag);
+
+    /**
+     * Wait for the last non-blocking send, if any, to complete.
+     */
+    void WaitForSend();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    PackedCellCommunicator();
+
+    /**
+     * Pack cells and their nodes into a buffer.
+     *
+     * @param rCells the cells and nodes
+     * @param rBuffer the buffer, which is overwritten
+     */
+    static void PackCells(const CellNodePairs& rCells, std::vector<char>& rBuffer);
+
+    /**
+     * Create new cells and nodes from a buffer written by PackCells().
+     *
+     * @param pBuffer the buffer
+     * @param size the size of the buffer in bytes
+     * @return the cells and nodes
+     */
+    static boost::shared_ptr<CellNodePairs> UnpackCells(const char* pBuffer, unsigned size);
+
+    /**
+     * Send cells to a process and receive cells from it, in a single message each way.
+     *
+     * @param rCells the cells and nodes to send
+     * @param destinationProcess the process to send to
+     * @param sendTag the send tag
+     * @param sourceProcess the process to receive from
+     * @param sourceTag the receive tag
+     * @return the cells and nodes received
+     */
+    boost::shared_ptr<CellNodePairs> SendRecvCells(const CellNodePairs& rCells,
+                                                   unsigned destinationProcess,
+                                                   unsigned sendTag,
+                                                   unsigned sourceProcess,
+                                                   unsigned sourceTag);
+
+    /**
+     * Start sending cells to a process without waiting for the send to complete.
+     *
+     * @param rCells the cells and nodes to send, which are packed before returning
+     * @param destinationProcess the process to send to
+     * @param tag the message tag
+     */
+    void ISendCells(const CellNodePairs& rCells, unsigned destinationProcess, unsigned tag);
+
+    /**
+     * Set up a receive of cells from a process, to be completed by GetRecvCells().
+     *
+     * @param sourceProcess the process to receive from
+     * @param tag the message tag
+     */
+    void IRecvCells(unsigned sourceProcess, unsigned tag);
+
+    /**
+     * Complete the receive set up by IRecvCells(), and the last non-blocking send.
+     *
+     * @return the cells and nodes received
+     */
+    boost::shared_ptr<CellNodePairs> GetRecvCells();
+};
+
+#endif /*PACKEDCELLCOMMUNICATOR_HPP_*/
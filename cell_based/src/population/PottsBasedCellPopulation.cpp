@@ -37,6 +37,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "RandomNumberGenerator.hpp"
 #include "Warnings.hpp"
 
+#include <climits>
+#include <boost/random.hpp>
+#include <boost/scoped_ptr.hpp>
+#ifdef _OPENMP
+#include <omp.h>
+#endif // _OPENMP
+
 // Needed to convert mesh in order to write nodes to VTK (visualize as glyphs)
 #include "VtkMeshWriter.hpp"
 #include "NodesOnlyMesh.hpp"
@@ -84,7 +91,10 @@ PottsBasedCellPopulation<DIM>::PottsBasedCellPopulation(PottsMesh<DIM>& rMesh,
       mpElementTessellation(NULL),
       mpMutableMesh(NULL),
       mTemperature(0.1),
-      mNumSweepsPerTimestep(1)
+      mNumSweepsPerTimestep(1),
+      mUseCheckerboardSweep(false),
+      mNumSweepThreads(1),
+      mSiteColouringRevision(UNSIGNED_UNSET)
 {
     mpPottsMesh = static_cast<PottsMesh<DIM>* >(&(this->mrMesh));
     // Check each element has only one cell associated with it
@@ -100,7 +110,10 @@ PottsBasedCellPopulation<DIM>::PottsBasedCellPopulation(PottsMesh<DIM>& rMesh)
       mpElementTessellation(NULL),
       mpMutableMesh(NULL),
       mTemperature(0.1),
-      mNumSweepsPerTimestep(1)
+      mNumSweepsPerTimestep(1),
+      mUseCheckerboardSweep(false),
+      mNumSweepThreads(1),
+      mSiteColouringRevision(UNSIGNED_UNSET)
 {
     mpPottsMesh = static_cast<PottsMesh<DIM>* >(&(this->mrMesh));
 }
@@ -232,6 +245,19 @@ void PottsBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
         p_gen->Shuffle(mUpdateRuleCollection);
     }
 
+    // Cache the element surface areas for the duration of the sweeps, so that each update costs O(neighbourhood)
+    SetUpElementSurfaceAreas();
+
+    if (mUseCheckerboardSweep)
+    {
+        PerformCheckerboardSweeps();
+        mElementSurfaceAreas.clear();
+        return;
+    }
+
+    const std::vector<unsigned>& r_neighbour_starts = mpPottsMesh->rGetMooreNeighbourStarts();
+    const std::vector<unsigned>& r_neighbours = mpPottsMesh->rGetMooreNeighbours();
+
     for (unsigned i=0; i<num_nodes*mNumSweepsPerTimestep; i++)
     {
         unsigned node_index;
@@ -252,24 +278,16 @@ void PottsBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
         assert(p_node->GetNumContainingElements() <= 1);
 
         // Find a random available neighbouring node to overwrite current site
-        std::set<unsigned> neighbouring_node_indices = mpPottsMesh->GetMooreNeighbouringNodeIndices(node_index);
+        unsigned num_neighbours = r_neighbour_starts[node_index+1] - r_neighbour_starts[node_index];
         unsigned neighbour_location_index;
 
-        if (!neighbouring_node_indices.empty())
+        if (num_neighbours > 0)
         {
-            unsigned num_neighbours = neighbouring_node_indices.size();
             unsigned chosen_neighbour = p_gen->randMod(num_neighbours);
+            neighbour_location_index = r_neighbours[r_neighbour_starts[node_index] + chosen_neighbour];
 
-            std::set<unsigned>::iterator neighbour_iter = neighbouring_node_indices.begin();
-            for (unsigned j=0; j<chosen_neighbour; j++)
-            {
-                neighbour_iter++;
-            }
-
-            neighbour_location_index = *neighbour_iter;
-
-            std::set<unsigned> containing_elements = p_node->rGetContainingElementIndices();
-            std::set<unsigned> neighbour_containing_elements = GetNode(neighbour_location_index)->rGetContainingElementIndices();
+            const std::set<unsigned>& containing_elements = p_node->rGetContainingElementIndices();
+            const std::set<unsigned>& neighbour_containing_elements = GetNode(neighbour_location_index)->rGetContainingElementIndices();
             // Only calculate Hamiltonian and update elements if the nodes are from different elements, or one is from the medium
             if (    ( !containing_elements.empty() && neighbour_containing_elements.empty() )
                  || ( containing_elements.empty() && !neighbour_containing_elements.empty() )
@@ -292,25 +310,277 @@ void PottsBasedCellPopulation<DIM>::UpdateCellLocations(double dt)
                 if (delta_H <= 0 || random_number < p)
                 {
                     // Do swap
+                    MoveNodeToNeighbourElement(node_index, neighbour_location_index);
+                }
+            }
+        }
+    }
 
-                    // Remove the current node from any elements containing it (there should be at most one such element)
-                    for (std::set<unsigned>::iterator iter = containing_elements.begin();
-                         iter != containing_elements.end();
-                         ++iter)
-                    {
-                        GetElement(*iter)->DeleteNode(GetElement(*iter)->GetNodeLocalIndex(node_index));
+    mElementSurfaceAreas.clear();
+}
+
+template<unsigned DIM>
+void PottsBasedCellPopulation<DIM>::MoveNodeToNeighbourElement(unsigned nodeIndex, unsigned neighbourIndex)
+{
+    Node<DIM>* p_node = this->mrMesh.GetNode(nodeIndex);
+    std::set<unsigned> containing_elements = p_node->rGetContainingElementIndices();
+    std::set<unsigned> neighbour_containing_elements = GetNode(neighbourIndex)->rGetContainingElementIndices();
 
-                        ///\todo If this causes the element to have no nodes then flag the element and cell to be deleted
+    /*
+     * Update any cached surface areas. Removing the node from an element removes its
+     * 2*DIM-n exposed faces, where n is the number of its Von Neumann neighbours in that
+     * element, and exposes one face of each of those neighbours; adding it does the reverse.
+     */
+    if (!mElementSurfaceAreas.empty())
+    {
+        for (std::set<unsigned>::iterator iter = containing_elements.begin();
+             iter != containing_elements.end();
+             ++iter)
+        {
+            double num_neighbours_in_element = GetNumVonNeumannNeighboursInElement(nodeIndex, *iter);
+            mElementSurfaceAreas[*iter] += 2.0*num_neighbours_in_element - 2.0*DIM;
+        }
+        for (std::set<unsigned>::iterator iter = neighbour_containing_elements.begin();
+             iter != neighbour_containing_elements.end();
+             ++iter)
+        {
+            double num_neighbours_in_element = GetNumVonNeumannNeighboursInElement(nodeIndex, *iter);
+            mElementSurfaceAreas[*iter] += 2.0*DIM - 2.0*num_neighbours_in_element;
+        }
+    }
+
+    // Remove the current node from any elements containing it (there should be at most one such element)
+    for (std::set<unsigned>::iterator iter = containing_elements.begin();
+         iter != containing_elements.end();
+         ++iter)
+    {
+        GetElement(*iter)->DeleteNode(GetElement(*iter)->GetNodeLocalIndex(nodeIndex));
+
+        ///\todo If this causes the element to have no nodes then flag the element and cell to be deleted
+    }
+
+    // Next add the current node to any elements containing the neighbouring node (there should be at most one such element)
+    for (std::set<unsigned>::iterator iter = neighbour_containing_elements.begin();
+         iter != neighbour_containing_elements.end();
+         ++iter)
+    {
+        GetElement(*iter)->AddNode(p_node);
+    }
+}
+
+template<unsigned DIM>
+unsigned PottsBasedCellPopulation<DIM>::GetNumVonNeumannNeighboursInElement(unsigned nodeIndex, unsigned elementIndex)
+{
+    const std::vector<unsigned>& r_neighbour_starts = mpPottsMesh->rGetVonNeumannNeighbourStarts();
+    const std::vector<unsigned>& r_neighbours = mpPottsMesh->rGetVonNeumannNeighbours();
+
+    unsigned num_neighbours_in_element = 0;
+    for (unsigned i=r_neighbour_starts[nodeIndex]; i<r_neighbour_starts[nodeIndex+1]; i++)
+    {
+        const std::set<unsigned>& r_neighbour_elements = this->mrMesh.GetNode(r_neighbours[i])->rGetContainingElementIndices();
+        if (!r_neighbour_elements.empty() && *(r_neighbour_elements.begin()) == elementIndex)
+        {
+            num_neighbours_in_element++;
+        }
+    }
+    return num_neighbours_in_element;
+}
+
+template<unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SetUpElementSurfaceAreas()
+{
+    mElementSurfaceAreas.clear();
+
+    // PottsMesh::GetSurfaceAreaOfElement() is only implemented in 2D and 3D
+    if (DIM > 1)
+    {
+        unsigned num_elements = mpPottsMesh->GetNumAllElements();
+        mElementSurfaceAreas.resize(num_elements, 0.0);
+        for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+        {
+            if (!mpPottsMesh->GetElement(elem_index)->IsDeleted())
+            {
+                mElementSurfaceAreas[elem_index] = mpPottsMesh->GetSurfaceAreaOfElement(elem_index);
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+double PottsBasedCellPopulation<DIM>::GetSurfaceAreaOfElement(unsigned elementIndex)
+{
+    if (!mElementSurfaceAreas.empty())
+    {
+        assert(elementIndex < mElementSurfaceAreas.size());
+        return mElementSurfaceAreas[elementIndex];
+    }
+    return mpPottsMesh->GetSurfaceAreaOfElement(elementIndex);
+}
+
+template<unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SetUpSiteColouring()
+{
+    const std::vector<unsigned>& r_neighbour_starts = mpPottsMesh->rGetMooreNeighbourStarts();
+    const std::vector<unsigned>& r_neighbours = mpPottsMesh->rGetMooreNeighbours();
+    unsigned num_nodes = this->mrMesh.GetNumNodes();
+    std::vector<unsigned> node_colours(num_nodes, UNSIGNED_UNSET);
+    unsigned num_colours = 0;
+
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        // Find the colours already used by the neighbours of this site
+        std::vector<bool> is_colour_used(num_colours, false);
+        for (unsigned i=r_neighbour_starts[node_index]; i<r_neighbour_starts[node_index+1]; i++)
+        {
+            if (node_colours[r_neighbours[i]] != UNSIGNED_UNSET)
+            {
+                is_colour_used[node_colours[r_neighbours[i]]] = true;
+            }
+        }
+
+        // Use the lowest free colour, adding a new one if necessary
+        unsigned colour = 0;
+        while (colour < num_colours && is_colour_used[colour])
+        {
+            colour++;
+        }
+        if (colour == num_colours)
+        {
+            num_colours++;
+        }
+        node_colours[node_index] = colour;
+    }
+
+    mSitesByColour.assign(num_colours, std::vector<unsigned>());
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        mSitesByColour[node_colours[node_index]].push_back(node_index);
+    }
+    mSiteColouringRevision = mpPottsMesh->GetNeighbourTablesRevision();
+}
+
+template<unsigned DIM>
+void PottsBasedCellPopulation<DIM>::PerformCheckerboardSweeps()
+{
+    // Only recompute the colouring if the lattice has changed (e.g. a node has been deleted)
+    if (mSiteColouringRevision != mpPottsMesh->GetNeighbourTablesRevision())
+    {
+        SetUpSiteColouring();
+    }
+
+    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+    const std::vector<unsigned>& r_neighbour_starts = mpPottsMesh->rGetMooreNeighbourStarts();
+    const std::vector<unsigned>& r_neighbours = mpPottsMesh->rGetMooreNeighbours();
+    unsigned num_colours = mSitesByColour.size();
+    std::vector<unsigned> colour_order(num_colours);
+    for (unsigned colour=0; colour<num_colours; colour++)
+    {
+        colour_order[colour] = colour;
+    }
+
+    // One random number stream per thread, reseeded from the global generator for each colour
+    std::vector<boost::mt19937> thread_generators(mNumSweepThreads);
+    std::vector<unsigned> chosen_neighbours;
+
+    for (unsigned sweep=0; sweep<mNumSweepsPerTimestep; sweep++)
+    {
+        if (this->mUpdateNodesInRandomOrder)
+        {
+            p_gen->Shuffle(num_colours, colour_order);
+        }
+
+        for (unsigned colour=0; colour<num_colours; colour++)
+        {
+            const std::vector<unsigned>& r_sites = mSitesByColour[colour_order[colour]];
+
+            for (unsigned thread=0; thread<mNumSweepThreads; thread++)
+            {
+                thread_generators[thread].seed(static_cast<boost::uint32_t>(p_gen->randMod(UINT_MAX)));
+            }
+
+            // OpenMP 2.5 loops need a signed index
+            const int num_sites = r_sites.size();
+            chosen_neighbours.assign(num_sites, UNSIGNED_UNSET);
+
+            // Details of the failed site with the lowest index, if any
+            int failed_site = num_sites;
+            boost::scoped_ptr<Exception> p_failure;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(mNumSweepThreads)
+#endif // _OPENMP
+            for (int site=0; site<num_sites; site++)
+            {
+#ifdef _OPENMP
+                const unsigned thread = omp_get_thread_num();
+#else
+                const unsigned thread = 0;
+#endif // _OPENMP
+                boost::variate_generator<boost::mt19937&, boost::uniform_real<> > uniform(thread_generators[thread], boost::uniform_real<>());
+
+                // Exceptions can't propagate out of a parallel region, so record the failure instead
+                try
+                {
+                    const unsigned node_index = r_sites[site];
+
+                    // Find a random available neighbouring node to overwrite current site
+                    const unsigned num_neighbours = r_neighbour_starts[node_index+1] - r_neighbour_starts[node_index];
+                    if (num_neighbours == 0)
+                    {
+                        continue;
                     }
+                    const unsigned chosen_neighbour = std::min(static_cast<unsigned>(uniform()*num_neighbours), num_neighbours-1);
+                    const unsigned neighbour_location_index = r_neighbours[r_neighbour_starts[node_index] + chosen_neighbour];
 
-                    // Next add the current node to any elements containing the neighbouring node (there should be at most one such element)
-                    for (std::set<unsigned>::iterator iter = neighbour_containing_elements.begin();
-                         iter != neighbour_containing_elements.end();
-                         ++iter)
+                    const std::set<unsigned>& r_containing_elements = this->mrMesh.GetNode(node_index)->rGetContainingElementIndices();
+                    const std::set<unsigned>& r_neighbour_containing_elements = this->mrMesh.GetNode(neighbour_location_index)->rGetContainingElementIndices();
+
+                    // Only calculate Hamiltonian and update elements if the nodes are from different elements, or one is from the medium
+                    if (    ( !r_containing_elements.empty() && r_neighbour_containing_elements.empty() )
+                         || ( r_containing_elements.empty() && !r_neighbour_containing_elements.empty() )
+                         || ( !r_containing_elements.empty() && !r_neighbour_containing_elements.empty() && *r_containing_elements.begin() != *r_neighbour_containing_elements.begin() ) )
                     {
-                        GetElement(*iter)->AddNode(this->mrMesh.GetNode(node_index));
+                        double delta_H = 0.0; // This is H_1-H_0.
+                        for (typename std::vector<boost::shared_ptr<AbstractPottsUpdateRule<DIM> > >::iterator iter = mUpdateRuleCollection.begin();
+                             iter != mUpdateRuleCollection.end();
+                             ++iter)
+                        {
+                            delta_H += (*iter)->EvaluateHamiltonianContribution(neighbour_location_index, node_index, *this);
+                        }
+
+                        if (delta_H <= 0 || uniform() < exp(-delta_H/mTemperature))
+                        {
+                            chosen_neighbours[site] = neighbour_location_index;
+                        }
                     }
                 }
+                catch (Exception& e)
+                {
+#ifdef _OPENMP
+#pragma omp critical(PottsBasedCellPopulation_SweepFailure)
+#endif // _OPENMP
+                    {
+                        if (site < failed_site)
+                        {
+                            failed_site = site;
+                            p_failure.reset(new Exception(e));
+                        }
+                    }
+                }
+            }
+
+            if (p_failure)
+            {
+                throw Exception(*p_failure);
+            }
+
+            // Apply the accepted moves in index order
+            for (int site=0; site<num_sites; site++)
+            {
+                if (chosen_neighbours[site] != UNSIGNED_UNSET)
+                {
+                    MoveNodeToNeighbourElement(r_sites[site], chosen_neighbours[site]);
+                }
             }
         }
     }
@@ -490,6 +760,40 @@ unsigned PottsBasedCellPopulation<DIM>::GetNumSweepsPerTimestep()
     return mNumSweepsPerTimestep;
 }
 
+template<unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SetUseCheckerboardSweep(bool useCheckerboardSweep)
+{
+    mUseCheckerboardSweep = useCheckerboardSweep;
+}
+
+template<unsigned DIM>
+bool PottsBasedCellPopulation<DIM>::GetUseCheckerboardSweep()
+{
+    return mUseCheckerboardSweep;
+}
+
+template<unsigned DIM>
+void PottsBasedCellPopulation<DIM>::SetNumSweepThreads(unsigned numSweepThreads)
+{
+    if (numSweepThreads == 0u)
+    {
+        EXCEPTION("The number of sweep threads must be positive.");
+    }
+#ifndef _OPENMP
+    if (numSweepThreads > 1u)
+    {
+        EXCEPTION("Chaste was not compiled with OpenMP support, so checkerboard sweeps can only use one thread.");
+    }
+#endif // _OPENMP
+    mNumSweepThreads = numSweepThreads;
+}
+
+template<unsigned DIM>
+unsigned PottsBasedCellPopulation<DIM>::GetNumSweepThreads()
+{
+    return mNumSweepThreads;
+}
+
 template<unsigned DIM>
 void PottsBasedCellPopulation<DIM>::WriteVtkResultsToFile(const std::string& rDirectory)
 {
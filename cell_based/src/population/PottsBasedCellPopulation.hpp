@@ -43,6 +43,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MutableMesh.hpp"
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/vector.hpp>
 
@@ -100,6 +101,39 @@ private:
      */
     unsigned mNumSweepsPerTimestep;
 
+    /**
+     * Whether to perform each sweep as a checkerboard sweep, in which the lattice
+     * sites are split into independent colours that are updated concurrently.
+     * Initialised to false in the constructor.
+     */
+    bool mUseCheckerboardSweep;
+
+    /**
+     * The number of threads used to update each colour in a checkerboard sweep.
+     * Initialised to 1 in the constructor.
+     */
+    unsigned mNumSweepThreads;
+
+    /**
+     * The lattice sites of each colour used by the checkerboard sweep, such that no
+     * two sites of the same colour are Moore neighbours. Computed when first needed,
+     * and recomputed whenever the neighbour tables of the mesh change.
+     */
+    std::vector<std::vector<unsigned> > mSitesByColour;
+
+    /**
+     * The revision of the mesh neighbour tables from which mSitesByColour was computed,
+     * or UNSIGNED_UNSET if it has not been computed yet.
+     */
+    unsigned mSiteColouringRevision;
+
+    /**
+     * The surface area of each element, cached by UpdateCellLocations() and updated
+     * incrementally as sites are moved, so that update rules need not recompute it
+     * for each proposed move. Empty outside UpdateCellLocations().
+     */
+    std::vector<double> mElementSurfaceAreas;
+
     friend class boost::serialization::access;
     /**
      * Serialize the object and its member variables.
@@ -128,6 +162,11 @@ private:
         archive & mUpdateRuleCollection;
         archive & mTemperature;
         archive & mNumSweepsPerTimestep;
+        if (version > 0)
+        {
+            archive & mUseCheckerboardSweep;
+            archive & mNumSweepThreads;
+        }
 
 #undef COVERAGE_IGNORE
     }
@@ -138,6 +177,51 @@ private:
      */
     void Validate();
 
+    /**
+     * Colour the lattice sites so that no two Moore neighbours share a colour,
+     * and store the sites of each colour in mSitesByColour.
+     *
+     * Sites are coloured greedily in index order, which gives 2^DIM colours on
+     * a regular lattice.
+     */
+    void SetUpSiteColouring();
+
+    /**
+     * Move a lattice site into the element(s) containing a neighbouring site,
+     * removing it from any element that currently contains it.
+     *
+     * @param nodeIndex the index of the lattice site to move
+     * @param neighbourIndex the index of the neighbouring lattice site
+     */
+    void MoveNodeToNeighbourElement(unsigned nodeIndex, unsigned neighbourIndex);
+
+    /**
+     * @return the number of Von Neumann neighbours of a lattice site that lie in a given element
+     *
+     * @param nodeIndex the index of the lattice site
+     * @param elementIndex the index of the element
+     */
+    unsigned GetNumVonNeumannNeighboursInElement(unsigned nodeIndex, unsigned elementIndex);
+
+    /**
+     * Fill mElementSurfaceAreas with the surface area of each element (in 2D and 3D).
+     */
+    void SetUpElementSurfaceAreas();
+
+    /**
+     * Perform mNumSweepsPerTimestep checkerboard sweeps of the lattice.
+     *
+     * Each sweep visits the colours of mSitesByColour in turn. Sites of one colour
+     * are not neighbours of each other, so their proposed moves are evaluated
+     * concurrently against the configuration at the start of the colour, using
+     * one random number stream per thread, and the accepted moves are then applied
+     * in index order. Adhesion energies are therefore evaluated exactly, while
+     * volume and surface area constraints see the element sizes at the start of
+     * the colour. For a given random seed and number of threads the result is
+     * reproducible.
+     */
+    void PerformCheckerboardSweeps();
+
     /**
      * Overridden WriteVtkResultsToFile() method.
      *
@@ -324,6 +408,16 @@ public:
      */
     double GetVolumeOfCell(CellPtr pCell);
 
+    /**
+     * Get the surface area (or perimeter in 2D) of an element. During UpdateCellLocations()
+     * this is read from a cache that is updated incrementally as sites move; otherwise it
+     * is computed by the mesh. Update rules should call this rather than the mesh method.
+     *
+     * @param elementIndex the index of the element
+     * @return the surface area of the element
+     */
+    double GetSurfaceAreaOfElement(unsigned elementIndex);
+
     /**
      * Overridden GetWidth() method.
      *
@@ -399,6 +493,30 @@ public:
      */
     unsigned GetNumSweepsPerTimestep();
 
+    /**
+     * Set mUseCheckerboardSweep.
+     *
+     * @param useCheckerboardSweep whether to update the lattice using checkerboard sweeps
+     */
+    void SetUseCheckerboardSweep(bool useCheckerboardSweep);
+
+    /**
+     * @return mUseCheckerboardSweep
+     */
+    bool GetUseCheckerboardSweep();
+
+    /**
+     * Set mNumSweepThreads. More than one thread requires Chaste to be compiled with OpenMP.
+     *
+     * @param numSweepThreads the number of threads used to update each colour in a checkerboard sweep
+     */
+    void SetNumSweepThreads(unsigned numSweepThreads);
+
+    /**
+     * @return mNumSweepThreads
+     */
+    unsigned GetNumSweepThreads();
+
     /**
      * Create a Element tessellation of the mesh for use in visualising the mesh.
      */
@@ -427,6 +545,19 @@ namespace boost
 {
 namespace serialization
 {
+/**
+ * Specify a version number for archive backwards compatibility.
+ *
+ * This is how to do BOOST_CLASS_VERSION(PottsBasedCellPopulation, 1)
+ * with a templated class.
+ */
+template <unsigned DIM>
+struct version<PottsBasedCellPopulation<DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(1);
+};
+
 /**
  * Serialize information required to construct a PottsBasedCellPopulation.
  */
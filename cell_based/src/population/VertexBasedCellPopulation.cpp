@@ -158,7 +158,7 @@ unsigned VertexBasedCellPopulation<DIM>::GetNumNodes()
 template<unsigned DIM>
 c_vector<double, DIM> VertexBasedCellPopulation<DIM>::GetLocationOfCellCentre(CellPtr pCell)
 {
-    return mpMutableVertexMesh->GetCentroidOfElement(this->mCellLocationMap[pCell.get()]);
+    return mpMutableVertexMesh->GetCachedCentroidOfElement(this->mCellLocationMap[pCell.get()]);
 }
 
 template<unsigned DIM>
@@ -377,7 +377,7 @@ double VertexBasedCellPopulation<DIM>::GetVolumeOfCell(CellPtr pCell)
     unsigned elem_index = this->GetLocationIndexUsingCell(pCell);
 
     // Get the cell's volume from the vertex mesh
-    double cell_volume = mpMutableVertexMesh->GetVolumeOfElement(elem_index);
+    double cell_volume = mpMutableVertexMesh->GetCachedVolumeOfElement(elem_index);
 
     return cell_volume;
 }
@@ -599,7 +599,7 @@ TetrahedralMesh<DIM, DIM>* VertexBasedCellPopulation<DIM>::GetTetrahedralMeshUsi
     {
         unsigned index = num_vertex_nodes + vertex_elem_index;
 
-        c_vector<double, DIM> location = mpMutableVertexMesh->GetCentroidOfElement(vertex_elem_index);
+        c_vector<double, DIM> location = mpMutableVertexMesh->GetCachedCentroidOfElement(vertex_elem_index);
 
         // Any node located at a VertexElement's centroid will not be a boundary node
         unsigned is_boundary_node = 0;
@@ -195,7 +195,8 @@ public:
      *
      * Find the centre of mass of a given cell (assuming uniform density).
      * Note that, as there is no guarantee of convexity, this may lie
-     * outside the VertexElement corresponding to the cell.
+     * outside the VertexElement corresponding to the cell. The centroid
+     * is taken from the mesh's element geometry cache.
      *
      * @param pCell a cell in the population
      *
@@ -321,6 +322,9 @@ public:
     /**
      * Overridden GetVolumeOfCell() method.
      *
+     * The volume is taken from the mesh's element geometry cache, so it is only
+     * recomputed when the element has moved or been rearranged.
+     *
      * @param pCell boost shared pointer to a cell
      * @return volume via associated mesh element
      */
@@ -62,6 +62,9 @@ class AbstractCellCycleModel; // Circular definition (cells need to know about c
 
 class Cell;
 
+template<unsigned DIM>
+class PackedCellCommunicator;
+
 /** Cells shouldn't be copied - it doesn't make sense.  So all access is via this pointer type. */
 typedef boost::shared_ptr<Cell> CellPtr;
 
@@ -79,6 +82,10 @@ private:
     /** Caches the result of ReadyToDivide() so Divide() can look at it. */
     bool mCanDivide;
 
+    /** Packs and unpacks the member variables of cells moving between processes. */
+    template<unsigned DIM>
+    friend class PackedCellCommunicator;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
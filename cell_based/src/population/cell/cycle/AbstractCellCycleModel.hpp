@@ -52,6 +52,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 class Cell; // Circular definition (cells need to know about cycle models and vice-versa)
 typedef boost::shared_ptr<Cell> CellPtr;
 
+template<unsigned DIM>
+class PackedCellCommunicator;
+
 /**
  * The AbstractCellCycleModel contains basic information to all cell-cycle models.
  * It handles assignment of birth time, cell cycle phase and a Cell.
@@ -62,6 +65,10 @@ class AbstractCellCycleModel : public Identifiable, boost::noncopyable
 {
 private:
 
+    /** Copies the common cell-cycle state of cells sent to another process. */
+    template<unsigned DIM>
+    friend class PackedCellCommunicator;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -45,6 +45,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class CellId;
 
+template<unsigned DIM>
+class PackedCellCommunicator;
+
 /**
  * Cell id class.
  *
@@ -66,6 +69,10 @@ private:
     /** maximum cell identifier. */
     static unsigned mMaxCellId;
 
+    /** Restores the identifier of a cell received from another process without changing mMaxCellId. */
+    template<unsigned DIM>
+    friend class PackedCellCommunicator;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -35,6 +35,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "NagaiHondaForce.hpp"
 
+#include <cfloat>
+
 template<unsigned DIM>
 NagaiHondaForce<DIM>::NagaiHondaForce()
    : AbstractForce<DIM>(),
@@ -62,100 +64,99 @@ void NagaiHondaForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCe
     // Define some helper variables
     VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
     unsigned num_nodes = p_cell_population->GetNumNodes();
-    unsigned num_elements = p_cell_population->GetNumElements();
-
-    // Begin by computing the area and perimeter of each element in the mesh, to avoid having to do this multiple times
-    std::vector<double> element_areas(num_elements);
-    std::vector<double> element_perimeters(num_elements);
-    std::vector<double> target_areas(num_elements);
-    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = p_cell_population->rGetMesh().GetElementIteratorBegin();
-         elem_iter != p_cell_population->rGetMesh().GetElementIteratorEnd();
+
+    /*
+     * The force on each Node is given by the gradient of the total free
+     * energy of the CellPopulation, evaluated at the position of the vertex. This
+     * free energy is the sum of the free energies of all CellPtrs in
+     * the cell population. The free energy of each CellPtr is comprised of three
+     * parts - a cell deformation energy, a membrane surface tension energy
+     * and an adhesion energy.
+     *
+     * Since the movement of a Node only affects the free energy of the CellPtrs
+     * containing it, we loop over elements once and add each element's contribution
+     * to the force on each of its vertices, rather than looping over nodes and
+     * searching each node's containing elements.
+     */
+    MutableVertexMesh<DIM, DIM>& r_mesh = p_cell_population->rGetMesh();
+    std::vector<c_vector<double, DIM> > forces_on_nodes(num_nodes, zero_vector<double>(DIM));
+
+    // Iterate over elements in the cell population
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = r_mesh.GetElementIteratorBegin();
+         elem_iter != r_mesh.GetElementIteratorEnd();
          ++elem_iter)
     {
+        VertexElement<DIM, DIM>* p_element = &(*elem_iter);
         unsigned elem_index = elem_iter->GetIndex();
-        element_areas[elem_index] = p_cell_population->rGetMesh().GetVolumeOfElement(elem_index);
-        element_perimeters[elem_index] = p_cell_population->rGetMesh().GetSurfaceAreaOfElement(elem_index);
+        unsigned num_nodes_elem = p_element->GetNumNodes();
+
+        // Get the area and perimeter of this element from the mesh's geometry cache
+        double element_area = r_mesh.GetCachedVolumeOfElement(elem_index);
+        double element_perimeter = r_mesh.GetCachedSurfaceAreaOfElement(elem_index);
+        const std::vector<double>& r_edge_lengths = r_mesh.rGetCachedEdgeLengthsOfElement(elem_index);
+
+        double target_area = 0.0;
         try
         {
             // If we haven't specified a growth modifier, there won't be any target areas in the CellData array and CellData
             // will throw an exception that it doesn't have "target area" entries.  We add this piece of code to give a more
             // understandable message. There is a slight chance that the exception is thrown although the error is not about the
             // target areas.
-            target_areas[elem_index] = p_cell_population->GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
+            target_area = p_cell_population->GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("target area");
         }
         catch (Exception&)
         {
             EXCEPTION("You need to add an AbstractTargetAreaModifier to the simulation in order to use NagaiHondaForce");
         }
-    }
-
-    // Iterate over vertices in the cell population
-    for (unsigned node_index=0; node_index<num_nodes; node_index++)
-    {
-        Node<DIM>* p_this_node = p_cell_population->GetNode(node_index);
+        double cell_target_perimeter = 2*sqrt(M_PI*target_area);
 
         /*
-         * The force on this Node is given by the gradient of the total free
-         * energy of the CellPopulation, evaluated at the position of the vertex. This
-         * free energy is the sum of the free energies of all CellPtrs in
-         * the cell population. The free energy of each CellPtr is comprised of three
-         * parts - a cell deformation energy, a membrane surface tension energy
-         * and an adhesion energy.
-         *
-         * Note that since the movement of this Node only affects the free energy
-         * of the CellPtrs containing it, we can just consider the contributions
-         * to the free energy gradient from each of these CellPtrs.
+         * Compute the gradient of each edge with respect to the position of its first node,
+         * together with the parameter associated with that edge, once per element.
          */
-        c_vector<double, DIM> deformation_contribution = zero_vector<double>(DIM);
-        c_vector<double, DIM> membrane_surface_tension_contribution = zero_vector<double>(DIM);
-        c_vector<double, DIM> adhesion_contribution = zero_vector<double>(DIM);
+        std::vector<c_vector<double, DIM> > edge_gradients(num_nodes_elem);
+        std::vector<double> edge_parameters(num_nodes_elem);
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            unsigned next_local_index = (local_index+1)%num_nodes_elem;
+            assert(r_edge_lengths[local_index] > DBL_EPSILON);
+            edge_gradients[local_index] = r_mesh.GetVectorFromAtoB(p_element->GetNodeLocation(next_local_index),
+                                                                   p_element->GetNodeLocation(local_index))/r_edge_lengths[local_index];
 
-        // Find the indices of the elements owned by this node
-        std::set<unsigned> containing_elem_indices = p_cell_population->GetNode(node_index)->rGetContainingElementIndices();
+            // Compute the adhesion parameter for each edge
+            edge_parameters[local_index] = GetAdhesionParameter(p_element->GetNode(local_index), p_element->GetNode(next_local_index), *p_cell_population);
+        }
 
-        // Iterate over these elements
-        for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
-             iter != containing_elem_indices.end();
-             ++iter)
+        // Add this element's contribution to the force on each of its vertices
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
         {
-            // Get this element, its index and its number of nodes
-            VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(*iter);
-            unsigned elem_index = p_element->GetIndex();
-            unsigned num_nodes_elem = p_element->GetNumNodes();
+            unsigned node_index = p_element->GetNodeGlobalIndex(local_index);
+            assert(node_index < num_nodes);
+            c_vector<double, DIM>& force_on_node = forces_on_nodes[node_index];
 
-            // Find the local index of this node in this element
-            unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+            // We add an extra num_nodes_elem in the line below as otherwise this term can be negative, which breaks the % operator
+            unsigned previous_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
 
             // Add the force contribution from this cell's deformation energy (note the minus sign)
-            c_vector<double, DIM> element_area_gradient = p_cell_population->rGetMesh().GetAreaGradientOfElementAtNode(p_element, local_index);
-            deformation_contribution -= 2*GetNagaiHondaDeformationEnergyParameter()*(element_areas[elem_index] - target_areas[elem_index])*element_area_gradient;
-
-            // Get the previous and next nodes in this element
-            unsigned previous_node_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
-            Node<DIM>* p_previous_node = p_element->GetNode(previous_node_local_index);
-
-            unsigned next_node_local_index = (local_index+1)%num_nodes_elem;
-            Node<DIM>* p_next_node = p_element->GetNode(next_node_local_index);
+            c_vector<double, DIM> element_area_gradient = r_mesh.GetAreaGradientOfElementAtNode(p_element, local_index);
+            force_on_node -= 2*GetNagaiHondaDeformationEnergyParameter()*(element_area - target_area)*element_area_gradient;
 
-            // Compute the adhesion parameter for each of these edges
-            double previous_edge_adhesion_parameter = GetAdhesionParameter(p_previous_node, p_this_node, *p_cell_population);
-            double next_edge_adhesion_parameter = GetAdhesionParameter(p_this_node, p_next_node, *p_cell_population);
-
-            // Compute the gradient of each these edges, computed at the present node
-            c_vector<double, DIM> previous_edge_gradient = -p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
-            c_vector<double, DIM> next_edge_gradient = p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+            // Compute the gradient of the edges ending and starting at this node
+            c_vector<double, DIM> previous_edge_gradient = -edge_gradients[previous_local_index];
+            c_vector<double, DIM> next_edge_gradient = edge_gradients[local_index];
 
             // Add the force contribution from cell-cell and cell-boundary adhesion (note the minus sign)
-            adhesion_contribution -= previous_edge_adhesion_parameter*previous_edge_gradient + next_edge_adhesion_parameter*next_edge_gradient;
+            force_on_node -= edge_parameters[previous_local_index]*previous_edge_gradient + edge_parameters[local_index]*next_edge_gradient;
 
             // Add the force contribution from this cell's membrane surface tension (note the minus sign)
             c_vector<double, DIM> element_perimeter_gradient = previous_edge_gradient + next_edge_gradient;
-            double cell_target_perimeter = 2*sqrt(M_PI*target_areas[elem_index]);
-            membrane_surface_tension_contribution -= 2*GetNagaiHondaMembraneSurfaceEnergyParameter()*(element_perimeters[elem_index] - cell_target_perimeter)*element_perimeter_gradient;
+            force_on_node -= 2*GetNagaiHondaMembraneSurfaceEnergyParameter()*(element_perimeter - cell_target_perimeter)*element_perimeter_gradient;
         }
+    }
 
-        c_vector<double, DIM> force_on_node = deformation_contribution + membrane_surface_tension_contribution + adhesion_contribution;
-        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(forces_on_nodes[node_index]);
     }
 }
 
@@ -163,8 +164,8 @@ template<unsigned DIM>
 double NagaiHondaForce<DIM>::GetAdhesionParameter(Node<DIM>* pNodeA, Node<DIM>* pNodeB, VertexBasedCellPopulation<DIM>& rVertexCellPopulation)
 {
     // Find the indices of the elements owned by each node
-    std::set<unsigned> elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
-    std::set<unsigned> elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
+    const std::set<unsigned>& elements_containing_nodeA = pNodeA->rGetContainingElementIndices();
+    const std::set<unsigned>& elements_containing_nodeB = pNodeB->rGetContainingElementIndices();
 
     // Find common elements
     std::set<unsigned> shared_elements;
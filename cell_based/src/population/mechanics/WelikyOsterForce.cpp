@@ -78,7 +78,7 @@ void WelikyOsterForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rC
         /******** Start of deformation force calculation ********/
 
         // Compute the area of this element
-        double element_area = p_cell_population->rGetMesh().GetVolumeOfElement(element_index);
+        double element_area = p_cell_population->rGetMesh().GetCachedVolumeOfElement(element_index);
 
         double deformation_coefficient = GetWelikyOsterAreaParameter()/element_area;
 
@@ -87,7 +87,7 @@ void WelikyOsterForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rC
         /******** Start of membrane force calculation ***********/
 
         // Compute the perimeter of the element
-        double element_perimeter = p_cell_population->rGetMesh().GetSurfaceAreaOfElement(element_index);
+        double element_perimeter = p_cell_population->rGetMesh().GetCachedSurfaceAreaOfElement(element_index);
 
         double membrane_surface_tension_coefficient = GetWelikyOsterPerimeterParameter()*element_perimeter;
 
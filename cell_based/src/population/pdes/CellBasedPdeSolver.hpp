@@ -113,6 +113,16 @@ protected:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<DIM>* pNode);
 
+    /**
+     * Overridden CanAssembleConcurrently() method.
+     *
+     * @return false, since the source terms are interpolated into member variables.
+     */
+    bool CanAssembleConcurrently()
+    {
+        return false;
+    }
+
     /**
      * Create the linear system object if it hasn't been already.
      * Can use an initial solution as PETSc template, or base it on the mesh size.
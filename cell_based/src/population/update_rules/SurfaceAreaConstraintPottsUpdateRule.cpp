@@ -59,8 +59,8 @@ double SurfaceAreaConstraintPottsUpdateRule<DIM>::EvaluateHamiltonianContributio
     // This method only works in 2D and 3D at present
     assert(DIM == 2 || DIM == 3);
 
-    std::set<unsigned> containing_elements = rCellPopulation.GetNode(currentNodeIndex)->rGetContainingElementIndices();
-    std::set<unsigned> new_location_containing_elements = rCellPopulation.GetNode(targetNodeIndex)->rGetContainingElementIndices();
+    const std::set<unsigned>& containing_elements = rCellPopulation.GetNode(currentNodeIndex)->rGetContainingElementIndices();
+    const std::set<unsigned>& new_location_containing_elements = rCellPopulation.GetNode(targetNodeIndex)->rGetContainingElementIndices();
 
     bool current_node_contained = !containing_elements.empty();
     bool target_node_contained = !new_location_containing_elements.empty();
@@ -84,12 +84,11 @@ double SurfaceAreaConstraintPottsUpdateRule<DIM>::EvaluateHamiltonianContributio
     // Iterate over nodes neighbouring the target node to work out the change in surface area
     unsigned neighbours_in_same_element_as_current_node = 0;
     unsigned neighbours_in_same_element_as_target_node = 0;
-    std::set<unsigned> target_neighbouring_node_indices = rCellPopulation.rGetMesh().GetVonNeumannNeighbouringNodeIndices(targetNodeIndex);
-    for (std::set<unsigned>::iterator iter = target_neighbouring_node_indices.begin();
-         iter != target_neighbouring_node_indices.end();
-         ++iter)
+    const std::vector<unsigned>& r_neighbour_starts = rCellPopulation.rGetMesh().rGetVonNeumannNeighbourStarts();
+    const std::vector<unsigned>& r_neighbours = rCellPopulation.rGetMesh().rGetVonNeumannNeighbours();
+    for (unsigned i=r_neighbour_starts[targetNodeIndex]; i<r_neighbour_starts[targetNodeIndex+1]; i++)
     {
-        std::set<unsigned> neighbouring_node_containing_elements = rCellPopulation.rGetMesh().GetNode(*iter)->rGetContainingElementIndices();
+        const std::set<unsigned>& neighbouring_node_containing_elements = rCellPopulation.rGetMesh().GetNode(r_neighbours[i])->rGetContainingElementIndices();
 
         // Every node must each be in at most one element
         assert(neighbouring_node_containing_elements.size() < 2);
@@ -126,7 +125,7 @@ double SurfaceAreaConstraintPottsUpdateRule<DIM>::EvaluateHamiltonianContributio
         if (current_node_contained) // current node is in an element
         {
             unsigned current_element = (*containing_elements.begin());
-            double current_surface_area = rCellPopulation.rGetMesh().GetSurfaceAreaOfElement(current_element);
+            double current_surface_area = rCellPopulation.GetSurfaceAreaOfElement(current_element);
             double current_surface_area_difference = current_surface_area - mMatureCellTargetSurfaceArea;
             double current_surface_area_difference_after_switch = current_surface_area_difference + change_in_surface_area[neighbours_in_same_element_as_current_node];
 
@@ -135,7 +134,7 @@ double SurfaceAreaConstraintPottsUpdateRule<DIM>::EvaluateHamiltonianContributio
         if (target_node_contained) // target node is in an element
         {
             unsigned target_element = (*new_location_containing_elements.begin());
-            double target_surface_area = rCellPopulation.rGetMesh().GetSurfaceAreaOfElement(target_element);
+            double target_surface_area = rCellPopulation.GetSurfaceAreaOfElement(target_element);
             double target_surface_area_difference = target_surface_area - mMatureCellTargetSurfaceArea;
             double target_surface_area_difference_after_switch = target_surface_area_difference - change_in_surface_area[neighbours_in_same_element_as_target_node];
 
@@ -152,7 +151,7 @@ double SurfaceAreaConstraintPottsUpdateRule<DIM>::EvaluateHamiltonianContributio
         if (current_node_contained) // current node is in an element
         {
             unsigned current_element = (*containing_elements.begin());
-            double current_surface_area = rCellPopulation.rGetMesh().GetSurfaceAreaOfElement(current_element);
+            double current_surface_area = rCellPopulation.GetSurfaceAreaOfElement(current_element);
             double current_surface_area_difference = current_surface_area - mMatureCellTargetSurfaceArea;
             double current_surface_area_difference_after_switch = current_surface_area_difference + change_in_surface_area[neighbours_in_same_element_as_current_node];
 
@@ -161,7 +160,7 @@ double SurfaceAreaConstraintPottsUpdateRule<DIM>::EvaluateHamiltonianContributio
         if (target_node_contained) // target node is in an element
         {
             unsigned target_element = (*new_location_containing_elements.begin());
-            double target_surface_area = rCellPopulation.rGetMesh().GetSurfaceAreaOfElement(target_element);
+            double target_surface_area = rCellPopulation.GetSurfaceAreaOfElement(target_element);
             double target_surface_area_difference = target_surface_area - mMatureCellTargetSurfaceArea;
             double target_surface_area_difference_after_switch = target_surface_area_difference - change_in_surface_area[neighbours_in_same_element_as_target_node];
 
@@ -41,6 +41,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Cylindrical2dMesh.hpp"
 #include "Cylindrical2dVertexMesh.hpp"
 #include "AbstractTwoBodyInteractionForce.hpp"
+#include "ForwardEulerNumericalMethod.hpp"
 #include "CellBasedEventHandler.hpp"
 #include "LogFile.hpp"
 #include "Version.hpp"
@@ -57,6 +58,8 @@ OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::OffLatticeSimulation(AbstractCellPo
         EXCEPTION("OffLatticeSimulations require a subclass of AbstractOffLatticeCellPopulation.");
     }
 
+    mpNumericalMethod.reset(new ForwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>());
+
     // Different time steps are used for cell-centre and vertex-based simulations
     if (dynamic_cast<AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(&rCellPopulation))
     {
@@ -99,6 +102,18 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::RemoveAllCellPopulationBoundar
     mBoundaryConditions.clear();
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::SetNumericalMethod(boost::shared_ptr<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> > pNumericalMethod)
+{
+    mpNumericalMethod = pNumericalMethod;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const boost::shared_ptr<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> > OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::GetNumericalMethod() const
+{
+    return mpNumericalMethod;
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateCellLocationsAndTopology()
 {
@@ -269,7 +284,9 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateNodePositions()
     }
 
     // Update node locations
-    static_cast<AbstractOffLatticeCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(&(this->mrCellPopulation))->UpdateNodeLocations(this->mDt);
+    mpNumericalMethod->SetCellPopulation(static_cast<AbstractOffLatticeCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(&(this->mrCellPopulation)));
+    mpNumericalMethod->SetForceCollection(&mForceCollection);
+    mpNumericalMethod->UpdateAllNodePositions(this->mDt);
 
     // Apply any boundary conditions
     for (typename std::vector<boost::shared_ptr<AbstractCellPopulationBoundaryCondition<ELEMENT_DIM,SPACE_DIM> > >::iterator bcs_iter = mBoundaryConditions.begin();
@@ -279,6 +296,13 @@ void OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM>::UpdateNodePositions()
         (*bcs_iter)->ImposeBoundaryCondition(old_node_locations);
     }
 
+    // Boundary conditions may move vertices directly, so any cached element geometry is now out of date
+    VertexBasedCellPopulation<SPACE_DIM>* p_vertex_based_cell_population = dynamic_cast<VertexBasedCellPopulation<SPACE_DIM>*>(&(this->mrCellPopulation));
+    if (!mBoundaryConditions.empty() && (p_vertex_based_cell_population != NULL))
+    {
+        p_vertex_based_cell_population->rGetMesh().InvalidateElementGeometryCache();
+    }
+
     // Verify that each boundary condition is now satisfied
     for (typename std::vector<boost::shared_ptr<AbstractCellPopulationBoundaryCondition<ELEMENT_DIM,SPACE_DIM> > >::iterator bcs_iter = mBoundaryConditions.begin();
          bcs_iter != mBoundaryConditions.end();
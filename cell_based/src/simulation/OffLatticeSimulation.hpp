@@ -39,11 +39,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractCellBasedSimulation.hpp"
 #include "AbstractForce.hpp"
 #include "AbstractCellPopulationBoundaryCondition.hpp"
+#include "AbstractNumericalMethod.hpp"
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/set.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/shared_ptr.hpp>
 
 /**
  * Run an off-lattice 2D or 3D cell-based simulation using a cell-centre-
@@ -86,6 +89,10 @@ private:
         archive & boost::serialization::base_object<AbstractCellBasedSimulation<ELEMENT_DIM,SPACE_DIM> >(*this);
         archive & mForceCollection;
         archive & mBoundaryConditions;
+        if (version > 0)
+        {
+            archive & mpNumericalMethod;
+        }
     }
 
 protected:
@@ -96,6 +103,9 @@ protected:
     /** List of boundary conditions. */
     std::vector<boost::shared_ptr<AbstractCellPopulationBoundaryCondition<ELEMENT_DIM,SPACE_DIM> > > mBoundaryConditions;
 
+    /** The numerical method used to move the nodes over each time step. Defaults to forward Euler. */
+    boost::shared_ptr<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> > mpNumericalMethod;
+
     /**
      * Overridden UpdateCellLocationsAndTopology() method.
      *
@@ -105,7 +115,7 @@ protected:
 
     /**
      * Moves each node to a new position for this timestep by
-     * calling the CellPopulation::UpdateNodeLocations() method then
+     * calling the numerical method's UpdateAllNodePositions() method then
      * applying any boundary conditions.
      *
      */
@@ -184,6 +194,18 @@ public:
      */
     void RemoveAllCellPopulationBoundaryConditions();
 
+    /**
+     * Set the numerical method used to move the nodes over each time step.
+     *
+     * @param pNumericalMethod pointer to the numerical method
+     */
+    void SetNumericalMethod(boost::shared_ptr<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> > pNumericalMethod);
+
+    /**
+     * @return the numerical method used to move the nodes over each time step.
+     */
+    const boost::shared_ptr<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> > GetNumericalMethod() const;
+
     /**
      * Overridden OutputAdditionalSimulationSetup method to output the force and cell
      * population boundary condition information.
@@ -211,6 +233,19 @@ namespace boost
 {
 namespace serialization
 {
+/**
+ * Specify a version number for archive backwards compatibility.
+ *
+ * This is how to do BOOST_CLASS_VERSION(OffLatticeSimulation, 1)
+ * with a templated class.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+struct version<OffLatticeSimulation<ELEMENT_DIM,SPACE_DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(1);
+};
+
 /**
  * Serialize information required to construct an OffLatticeSimulation.
  */
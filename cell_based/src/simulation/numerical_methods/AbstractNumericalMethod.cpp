@@ -0,0 +1,198 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AbstractNumericalMethod.hpp"
+#include "AbstractCentreBasedCellPopulation.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "MeshBasedCellPopulationWithGhostNodes.hpp"
+#include "NodeBasedCellPopulationWithParticles.hpp"
+#include "NodeBasedCellPopulationWithBuskeUpdate.hpp"
+#include "PetscTools.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::AbstractNumericalMethod()
+    : mpCellPopulation(NULL),
+      mpForceCollection(NULL)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~AbstractNumericalMethod()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetCellPopulation(AbstractOffLatticeCellPopulation<ELEMENT_DIM,SPACE_DIM>* pCellPopulation)
+{
+    mpCellPopulation = pCellPopulation;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetForceCollection(std::vector<boost::shared_ptr<AbstractForce<ELEMENT_DIM,SPACE_DIM> > >* pForces)
+{
+    mpForceCollection = pForces;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetUpNodeIndices()
+{
+    assert(mpCellPopulation);
+
+    mNodeIndices.clear();
+    if (dynamic_cast<AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(mpCellPopulation))
+    {
+        // Only the nodes associated with real cells are moved by the forces
+        for (typename AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>::Iterator cell_iter = mpCellPopulation->Begin();
+             cell_iter != mpCellPopulation->End();
+             ++cell_iter)
+        {
+            mNodeIndices.push_back(mpCellPopulation->GetLocationIndexUsingCell(*cell_iter));
+        }
+    }
+    else
+    {
+        assert(dynamic_cast<VertexBasedCellPopulation<SPACE_DIM>*>(mpCellPopulation));
+        for (unsigned node_index=0; node_index<mpCellPopulation->GetNumNodes(); node_index++)
+        {
+            mNodeIndices.push_back(node_index);
+        }
+    }
+
+    mDampingConstants.resize(mNodeIndices.size());
+    for (unsigned i=0; i<mNodeIndices.size(); i++)
+    {
+        mDampingConstants[i] = mpCellPopulation->GetDampingConstant(mNodeIndices[i]);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::CheckCellPopulationIsSupported()
+{
+    assert(mpCellPopulation);
+
+    if (dynamic_cast<MeshBasedCellPopulationWithGhostNodes<SPACE_DIM>*>(mpCellPopulation)
+        || dynamic_cast<NodeBasedCellPopulationWithParticles<SPACE_DIM>*>(mpCellPopulation)
+        || dynamic_cast<NodeBasedCellPopulationWithBuskeUpdate<SPACE_DIM>*>(mpCellPopulation))
+    {
+        EXCEPTION("Cell populations with ghost nodes, particles or the Buske update can only be used with ForwardEulerNumericalMethod.");
+    }
+
+    // Halo nodes are not moved between force evaluations within a time step
+    if (PetscTools::IsParallel())
+    {
+        EXCEPTION("Only ForwardEulerNumericalMethod can be used in parallel.");
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetMaximumDisplacement()
+{
+    double max_displacement = mpCellPopulation->GetAbsoluteMovementThreshold();
+
+    VertexBasedCellPopulation<SPACE_DIM>* p_vertex_population = dynamic_cast<VertexBasedCellPopulation<SPACE_DIM>*>(mpCellPopulation);
+    if (p_vertex_population)
+    {
+        // See VertexBasedCellPopulation::UpdateNodeLocations()
+        max_displacement = std::min(max_displacement, 0.5*p_vertex_population->rGetMesh().GetCellRearrangementThreshold());
+    }
+    return max_displacement;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNodeLocations(std::vector<c_vector<double, SPACE_DIM> >& rLocations)
+{
+    rLocations.resize(mNodeIndices.size());
+    for (unsigned i=0; i<mNodeIndices.size(); i++)
+    {
+        rLocations[i] = mpCellPopulation->GetNode(mNodeIndices[i])->rGetLocation();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetNodeLocations(const std::vector<c_vector<double, SPACE_DIM> >& rLocations)
+{
+    assert(rLocations.size() == mNodeIndices.size());
+    for (unsigned i=0; i<mNodeIndices.size(); i++)
+    {
+        // Use the cell population's SetNode() method so that any periodicity is respected
+        ChastePoint<SPACE_DIM> new_point(rLocations[i]);
+        mpCellPopulation->SetNode(mNodeIndices[i], new_point);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetVelocitiesFromAppliedForces(std::vector<c_vector<double, SPACE_DIM> >& rVelocities)
+{
+    rVelocities.resize(mNodeIndices.size());
+    for (unsigned i=0; i<mNodeIndices.size(); i++)
+    {
+        rVelocities[i] = mpCellPopulation->GetNode(mNodeIndices[i])->rGetAppliedForce()/mDampingConstants[i];
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>::ComputeVelocities(std::vector<c_vector<double, SPACE_DIM> >& rVelocities)
+{
+    assert(mpForceCollection);
+
+    // Clear all forces
+    for (typename AbstractMesh<ELEMENT_DIM, SPACE_DIM>::NodeIterator node_iter = mpCellPopulation->rGetMesh().GetNodeIteratorBegin();
+         node_iter != mpCellPopulation->rGetMesh().GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        node_iter->ClearAppliedForce();
+    }
+
+    // Now add force contributions from each AbstractForce
+    for (typename std::vector<boost::shared_ptr<AbstractForce<ELEMENT_DIM, SPACE_DIM> > >::iterator iter = mpForceCollection->begin();
+         iter != mpForceCollection->end();
+         ++iter)
+    {
+        (*iter)->AddForceContribution(*mpCellPopulation);
+    }
+
+    GetVelocitiesFromAppliedForces(rVelocities);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Explicit instantiation
+/////////////////////////////////////////////////////////////////////////////
+
+template class AbstractNumericalMethod<1,1>;
+template class AbstractNumericalMethod<1,2>;
+template class AbstractNumericalMethod<2,2>;
+template class AbstractNumericalMethod<1,3>;
+template class AbstractNumericalMethod<2,3>;
+template class AbstractNumericalMethod<3,3>;
@@ -0,0 +1,185 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTNUMERICALMETHOD_HPP_
+#define ABSTRACTNUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include "ClassIsAbstract.hpp"
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractOffLatticeCellPopulation.hpp"
+#include "AbstractForce.hpp"
+#include "Identifiable.hpp"
+
+/**
+ * An abstract class for the numerical methods used by an OffLatticeSimulation to
+ * integrate the overdamped equations of motion of the nodes, dx/dt = F(x)/eta,
+ * over one simulation time step.
+ *
+ * The simulation calculates the applied forces at the start of each time step,
+ * so the first force evaluation is always free; methods needing further force
+ * evaluations at intermediate node locations use ComputeVelocities().
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class AbstractNumericalMethod : public Identifiable
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object.
+     *
+     * The cell population and force collection are not archived, as they are
+     * set by the simulation before each solve.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+    }
+
+protected:
+
+    /** Pointer to the cell population being simulated. */
+    AbstractOffLatticeCellPopulation<ELEMENT_DIM,SPACE_DIM>* mpCellPopulation;
+
+    /** Pointer to the simulation's collection of forces. */
+    std::vector<boost::shared_ptr<AbstractForce<ELEMENT_DIM,SPACE_DIM> > >* mpForceCollection;
+
+    /**
+     * The indices of the nodes moved by this method: the nodes associated with cells
+     * for a centre-based population, and every node for a vertex-based population.
+     * Set up by SetUpNodeIndices().
+     */
+    std::vector<unsigned> mNodeIndices;
+
+    /** The damping constant of each node in mNodeIndices. Set up by SetUpNodeIndices(). */
+    std::vector<double> mDampingConstants;
+
+    /**
+     * Set up mNodeIndices and mDampingConstants for the current time step.
+     * The damping constants are held fixed over the time step.
+     */
+    void SetUpNodeIndices();
+
+    /**
+     * Throw an exception if the cell population moves some of its nodes in its own
+     * UpdateNodeLocations() method (ghost nodes, particles or the Buske update), or
+     * if running in parallel. Such populations must use ForwardEulerNumericalMethod.
+     */
+    void CheckCellPopulationIsSupported();
+
+    /**
+     * @return the largest displacement that a node may make in one (sub-)step: the
+     * population's absolute movement threshold and, for vertex-based populations,
+     * half the cell rearrangement threshold.
+     */
+    double GetMaximumDisplacement();
+
+    /**
+     * Get the current location of each node in mNodeIndices.
+     *
+     * @param rLocations vector to be filled with the node locations
+     */
+    void GetNodeLocations(std::vector<c_vector<double, SPACE_DIM> >& rLocations);
+
+    /**
+     * Move each node in mNodeIndices to the given location.
+     *
+     * @param rLocations the new node locations
+     */
+    void SetNodeLocations(const std::vector<c_vector<double, SPACE_DIM> >& rLocations);
+
+    /**
+     * Get the velocity F/eta of each node in mNodeIndices from the forces currently
+     * applied to the nodes.
+     *
+     * @param rVelocities vector to be filled with the node velocities
+     */
+    void GetVelocitiesFromAppliedForces(std::vector<c_vector<double, SPACE_DIM> >& rVelocities);
+
+    /**
+     * Recalculate the forces on every node at the current node locations, then get the
+     * velocity F/eta of each node in mNodeIndices.
+     *
+     * @param rVelocities vector to be filled with the node velocities
+     */
+    void ComputeVelocities(std::vector<c_vector<double, SPACE_DIM> >& rVelocities);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    AbstractNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~AbstractNumericalMethod();
+
+    /**
+     * Set mpCellPopulation.
+     *
+     * @param pCellPopulation pointer to the cell population
+     */
+    void SetCellPopulation(AbstractOffLatticeCellPopulation<ELEMENT_DIM,SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Set mpForceCollection.
+     *
+     * @param pForces pointer to the simulation's collection of forces
+     */
+    void SetForceCollection(std::vector<boost::shared_ptr<AbstractForce<ELEMENT_DIM,SPACE_DIM> > >* pForces);
+
+    /**
+     * Move the nodes of the cell population over one time step, given that the forces
+     * at the start of the time step have already been applied to the nodes.
+     *
+     * As this method is pure virtual, it must be overridden
+     * in subclasses.
+     *
+     * @param dt the time step
+     */
+    virtual void UpdateAllNodePositions(double dt)=0;
+};
+
+TEMPLATED_CLASS_IS_ABSTRACT_2_UNSIGNED(AbstractNumericalMethod)
+
+#endif /*ABSTRACTNUMERICALMETHOD_HPP_*/
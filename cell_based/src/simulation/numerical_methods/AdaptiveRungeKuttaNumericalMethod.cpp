@@ -0,0 +1,187 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AdaptiveRungeKuttaNumericalMethod.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AdaptiveRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::AdaptiveRungeKuttaNumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mTolerance(1e-4),
+      mSubStepSize(0.0),
+      mNumSubSteps(0)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AdaptiveRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~AdaptiveRungeKuttaNumericalMethod()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AdaptiveRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    this->CheckCellPopulationIsSupported();
+    this->SetUpNodeIndices();
+    unsigned num_nodes = this->mNodeIndices.size();
+    double max_displacement = this->GetMaximumDisplacement();
+
+    std::vector<c_vector<double, SPACE_DIM> > locations;
+    this->GetNodeLocations(locations);
+
+    // The forces at the start of the time step have already been calculated
+    std::vector<c_vector<double, SPACE_DIM> > k1, k2, k3, k4;
+    this->GetVelocitiesFromAppliedForces(k1);
+
+    std::vector<c_vector<double, SPACE_DIM> > stage_locations(num_nodes);
+    std::vector<c_vector<double, SPACE_DIM> > new_locations(num_nodes);
+
+    double step_size = (mSubStepSize > 0.0) ? std::min(mSubStepSize, dt) : dt;
+    double time = 0.0;
+    mNumSubSteps = 0;
+
+    while (time < dt*(1.0 - DBL_EPSILON))
+    {
+        // Don't step past the end of the time step
+        bool is_last_sub_step = (time + step_size >= dt*(1.0 - DBL_EPSILON));
+        double h = is_last_sub_step ? dt - time : step_size;
+
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            stage_locations[i] = locations[i] + 0.5*h*k1[i];
+        }
+        this->SetNodeLocations(stage_locations);
+        this->ComputeVelocities(k2);
+
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            stage_locations[i] = locations[i] + 0.75*h*k2[i];
+        }
+        this->SetNodeLocations(stage_locations);
+        this->ComputeVelocities(k3);
+
+        // Third-order solution
+        double max_step_displacement = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            c_vector<double, SPACE_DIM> displacement = h*(2.0*k1[i] + 3.0*k2[i] + 4.0*k3[i])/9.0;
+            max_step_displacement = std::max(max_step_displacement, norm_2(displacement));
+            new_locations[i] = locations[i] + displacement;
+        }
+        this->SetNodeLocations(new_locations);
+        this->ComputeVelocities(k4);
+
+        // Difference from the embedded second-order solution
+        double max_error = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            c_vector<double, SPACE_DIM> error = h*(-5.0*k1[i]/72.0 + k2[i]/12.0 + k3[i]/9.0 - k4[i]/8.0);
+            max_error = std::max(max_error, norm_2(error));
+        }
+
+        double factor;
+        if (max_error <= mTolerance && max_step_displacement <= max_displacement)
+        {
+            // Accept the sub-step; the last stage of this sub-step is the first stage of the next
+            locations.swap(new_locations);
+            k1.swap(k4);
+            time += h;
+            mNumSubSteps++;
+
+            factor = (max_error > 0.0) ? std::min(5.0, std::max(0.2, 0.9*pow(mTolerance/max_error, 1.0/3.0))) : 5.0;
+
+            // A shortened last sub-step says nothing about the size of the next one
+            if (!is_last_sub_step || h >= step_size)
+            {
+                step_size = h*factor;
+            }
+        }
+        else
+        {
+            // Reject the sub-step and try again with a smaller one
+            factor = (max_error > mTolerance) ? std::max(0.2, 0.9*pow(mTolerance/max_error, 1.0/3.0)) : 1.0;
+            if (max_step_displacement > max_displacement)
+            {
+                factor = std::min(factor, 0.9*max_displacement/max_step_displacement);
+            }
+            step_size = h*factor;
+
+            if (step_size < 1e-6*dt)
+            {
+                this->SetNodeLocations(locations);
+                EXCEPTION("The sub-step size has fallen below 1e-6 times the time step. Increase the tolerance or use a smaller time step.");
+            }
+        }
+    }
+
+    this->SetNodeLocations(locations);
+    mSubStepSize = step_size;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void AdaptiveRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetTolerance(double tolerance)
+{
+    assert(tolerance > 0.0);
+    mTolerance = tolerance;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double AdaptiveRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetTolerance()
+{
+    return mTolerance;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned AdaptiveRungeKuttaNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNumSubStepsInLastStep()
+{
+    return mNumSubSteps;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Explicit instantiation
+/////////////////////////////////////////////////////////////////////////////
+
+template class AdaptiveRungeKuttaNumericalMethod<1,1>;
+template class AdaptiveRungeKuttaNumericalMethod<1,2>;
+template class AdaptiveRungeKuttaNumericalMethod<2,2>;
+template class AdaptiveRungeKuttaNumericalMethod<1,3>;
+template class AdaptiveRungeKuttaNumericalMethod<2,3>;
+template class AdaptiveRungeKuttaNumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(AdaptiveRungeKuttaNumericalMethod)
@@ -0,0 +1,123 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ADAPTIVERUNGEKUTTANUMERICALMETHOD_HPP_
+#define ADAPTIVERUNGEKUTTANUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractNumericalMethod.hpp"
+
+/**
+ * An adaptive explicit method using the embedded Runge-Kutta 3(2) pair of Bogacki
+ * and Shampine (doi:10.1016/0893-9659(89)90079-7).
+ *
+ * Each simulation time step is split into as many sub-steps as needed to keep the
+ * estimated local error in each node's displacement below a tolerance, and to keep
+ * each node's displacement in a sub-step below the maximum permitted displacement.
+ * Instead of throwing an exception when cells move too far, the sub-step is
+ * rejected and retried with a smaller step size. The sub-step size is carried over
+ * between simulation time steps.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class AdaptiveRungeKuttaNumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> >(*this);
+        archive & mTolerance;
+        archive & mSubStepSize;
+    }
+
+    /** The tolerance on the estimated error in each node's displacement in a sub-step. Defaults to 1e-4. */
+    double mTolerance;
+
+    /** The sub-step size to try first in the next time step (zero until the first time step). */
+    double mSubStepSize;
+
+    /** The number of sub-steps taken in the last time step. */
+    unsigned mNumSubSteps;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    AdaptiveRungeKuttaNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~AdaptiveRungeKuttaNumericalMethod();
+
+    /**
+     * Overridden UpdateAllNodePositions() method.
+     *
+     * @param dt the time step
+     */
+    virtual void UpdateAllNodePositions(double dt);
+
+    /**
+     * Set mTolerance.
+     *
+     * @param tolerance the new value of mTolerance
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @return mTolerance
+     */
+    double GetTolerance();
+
+    /**
+     * @return the number of sub-steps taken in the last time step.
+     */
+    unsigned GetNumSubStepsInLastStep();
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(AdaptiveRungeKuttaNumericalMethod)
+
+#endif /*ADAPTIVERUNGEKUTTANUMERICALMETHOD_HPP_*/
@@ -0,0 +1,276 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "BackwardEulerNumericalMethod.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::BackwardEulerNumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>(),
+      mTolerance(1e-6),
+      mMaxNewtonIterations(10),
+      mNumSubSteps(0)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::~BackwardEulerNumericalMethod()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::ScalarProduct(const std::vector<c_vector<double, SPACE_DIM> >& rA,
+                                                                          const std::vector<c_vector<double, SPACE_DIM> >& rB)
+{
+    double product = 0.0;
+    for (unsigned i=0; i<rA.size(); i++)
+    {
+        product += inner_prod(rA[i], rB[i]);
+    }
+    return product;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SolveSubStep(double h,
+                                                                       const std::vector<c_vector<double, SPACE_DIM> >& rInitialLocations,
+                                                                       const std::vector<c_vector<double, SPACE_DIM> >& rInitialVelocities,
+                                                                       std::vector<c_vector<double, SPACE_DIM> >& rLocations)
+{
+    unsigned num_nodes = this->mNodeIndices.size();
+    unsigned max_cg_iterations = std::min(50u, SPACE_DIM*num_nodes);
+
+    // Use the forward Euler solution as the initial guess
+    rLocations.resize(num_nodes);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        rLocations[i] = rInitialLocations[i] + h*rInitialVelocities[i];
+    }
+
+    std::vector<c_vector<double, SPACE_DIM> > velocities;
+    std::vector<c_vector<double, SPACE_DIM> > perturbed_velocities;
+    std::vector<c_vector<double, SPACE_DIM> > residual(num_nodes);
+    std::vector<c_vector<double, SPACE_DIM> > update(num_nodes);
+    std::vector<c_vector<double, SPACE_DIM> > cg_residual(num_nodes);
+    std::vector<c_vector<double, SPACE_DIM> > search_direction(num_nodes);
+    std::vector<c_vector<double, SPACE_DIM> > product(num_nodes);
+    std::vector<c_vector<double, SPACE_DIM> > perturbed_locations(num_nodes);
+
+    for (unsigned newton_iter=0; ; newton_iter++)
+    {
+        this->SetNodeLocations(rLocations);
+        this->ComputeVelocities(velocities);
+
+        double max_residual = 0.0;
+        double location_size = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            residual[i] = rLocations[i] - rInitialLocations[i] - h*velocities[i];
+            max_residual = std::max(max_residual, norm_2(residual[i]));
+            location_size = std::max(location_size, norm_inf(rLocations[i]));
+        }
+        if (max_residual < mTolerance)
+        {
+            return true;
+        }
+        if (newton_iter == mMaxNewtonIterations)
+        {
+            return false;
+        }
+
+        // Solve (D - h*dF/dx) update = -D*residual by the conjugate gradient method
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            update[i] = zero_vector<double>(SPACE_DIM);
+            cg_residual[i] = -this->mDampingConstants[i]*residual[i];
+            search_direction[i] = cg_residual[i];
+        }
+        double cg_residual_squared = ScalarProduct(cg_residual, cg_residual);
+        double cg_stopping_value = 1e-6*cg_residual_squared;
+
+        bool has_update = false;
+        for (unsigned cg_iter=0; cg_iter<max_cg_iterations && cg_residual_squared > cg_stopping_value; cg_iter++)
+        {
+            // Approximate the Jacobian-vector product by finite differences of the forces
+            double epsilon = sqrt(DBL_EPSILON)*(1.0 + location_size)/sqrt(ScalarProduct(search_direction, search_direction));
+            for (unsigned i=0; i<num_nodes; i++)
+            {
+                perturbed_locations[i] = rLocations[i] + epsilon*search_direction[i];
+            }
+            this->SetNodeLocations(perturbed_locations);
+            this->ComputeVelocities(perturbed_velocities);
+
+            for (unsigned i=0; i<num_nodes; i++)
+            {
+                product[i] = this->mDampingConstants[i]*(search_direction[i] - h*(perturbed_velocities[i] - velocities[i])/epsilon);
+            }
+
+            // Stop if the matrix is not positive definite in this direction
+            double curvature = ScalarProduct(search_direction, product);
+            if (curvature <= 0.0)
+            {
+                break;
+            }
+
+            double alpha = cg_residual_squared/curvature;
+            for (unsigned i=0; i<num_nodes; i++)
+            {
+                update[i] += alpha*search_direction[i];
+                cg_residual[i] -= alpha*product[i];
+            }
+            has_update = true;
+
+            double new_cg_residual_squared = ScalarProduct(cg_residual, cg_residual);
+            double beta = new_cg_residual_squared/cg_residual_squared;
+            for (unsigned i=0; i<num_nodes; i++)
+            {
+                search_direction[i] = cg_residual[i] + beta*search_direction[i];
+            }
+            cg_residual_squared = new_cg_residual_squared;
+        }
+
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            // Fall back to a fixed-point iteration if no conjugate gradient step was possible
+            rLocations[i] += has_update ? update[i] : -residual[i];
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    this->CheckCellPopulationIsSupported();
+    this->SetUpNodeIndices();
+    unsigned num_nodes = this->mNodeIndices.size();
+    double max_displacement = this->GetMaximumDisplacement();
+
+    std::vector<c_vector<double, SPACE_DIM> > locations;
+    this->GetNodeLocations(locations);
+
+    // The forces at the start of the time step have already been calculated
+    std::vector<c_vector<double, SPACE_DIM> > velocities;
+    this->GetVelocitiesFromAppliedForces(velocities);
+
+    std::vector<c_vector<double, SPACE_DIM> > new_locations;
+
+    double step_size = dt;
+    double time = 0.0;
+    mNumSubSteps = 0;
+
+    while (time < dt*(1.0 - DBL_EPSILON))
+    {
+        double h = std::min(step_size, dt - time);
+        bool converged = SolveSubStep(h, locations, velocities, new_locations);
+
+        double max_step_displacement = 0.0;
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            max_step_displacement = std::max(max_step_displacement, norm_2(new_locations[i] - locations[i]));
+        }
+
+        if (converged && max_step_displacement <= max_displacement)
+        {
+            locations.swap(new_locations);
+            time += h;
+            mNumSubSteps++;
+
+            if (time < dt*(1.0 - DBL_EPSILON))
+            {
+                this->SetNodeLocations(locations);
+                this->ComputeVelocities(velocities);
+            }
+        }
+        else
+        {
+            // Retry with half the sub-step size
+            step_size = 0.5*h;
+            if (step_size < 1e-6*dt)
+            {
+                this->SetNodeLocations(locations);
+                EXCEPTION("The sub-step size has fallen below 1e-6 times the time step. Increase the tolerance or use a smaller time step.");
+            }
+        }
+    }
+
+    this->SetNodeLocations(locations);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetTolerance(double tolerance)
+{
+    assert(tolerance > 0.0);
+    mTolerance = tolerance;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetTolerance()
+{
+    return mTolerance;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::SetMaxNewtonIterations(unsigned maxNewtonIterations)
+{
+    mMaxNewtonIterations = maxNewtonIterations;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetMaxNewtonIterations()
+{
+    return mMaxNewtonIterations;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned BackwardEulerNumericalMethod<ELEMENT_DIM,SPACE_DIM>::GetNumSubStepsInLastStep()
+{
+    return mNumSubSteps;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Explicit instantiation
+/////////////////////////////////////////////////////////////////////////////
+
+template class BackwardEulerNumericalMethod<1,1>;
+template class BackwardEulerNumericalMethod<1,2>;
+template class BackwardEulerNumericalMethod<2,2>;
+template class BackwardEulerNumericalMethod<1,3>;
+template class BackwardEulerNumericalMethod<2,3>;
+template class BackwardEulerNumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(BackwardEulerNumericalMethod)
@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BACKWARDEULERNUMERICALMETHOD_HPP_
+#define BACKWARDEULERNUMERICALMETHOD_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractNumericalMethod.hpp"
+
+/**
+ * The backward Euler method, x(t+dt) = x(t) + dt*F(x(t+dt))/eta, for stiff force
+ * laws such as strong springs.
+ *
+ * The implicit equations are solved by Newton's method. Each Newton update solves
+ * (D - dt*dF/dx) dx = -D*r, where D holds the damping constants and r is the residual,
+ * using the conjugate gradient method with Jacobian-vector products approximated by
+ * finite differences of the forces, so no Jacobian is ever assembled. This matrix is
+ * symmetric positive definite whenever the forces derive from a potential and dt
+ * is small enough to resolve any unstable modes.
+ *
+ * If Newton's method fails to converge, or a node moves further than the maximum
+ * permitted displacement, the time step is halved and retried.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class BackwardEulerNumericalMethod : public AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM> >(*this);
+        archive & mTolerance;
+        archive & mMaxNewtonIterations;
+    }
+
+    /** The tolerance on the residual of each node's displacement. Defaults to 1e-6. */
+    double mTolerance;
+
+    /** The maximum number of Newton iterations in each sub-step. Defaults to 10. */
+    unsigned mMaxNewtonIterations;
+
+    /** The number of sub-steps taken in the last time step. */
+    unsigned mNumSubSteps;
+
+    /**
+     * Solve the backward Euler equations for one sub-step.
+     *
+     * @param h the sub-step size
+     * @param rInitialLocations the node locations at the start of the sub-step
+     * @param rInitialVelocities the node velocities at the start of the sub-step
+     * @param rLocations vector to be filled with the node locations at the end of the sub-step
+     *
+     * @return whether Newton's method converged
+     */
+    bool SolveSubStep(double h,
+                      const std::vector<c_vector<double, SPACE_DIM> >& rInitialLocations,
+                      const std::vector<c_vector<double, SPACE_DIM> >& rInitialVelocities,
+                      std::vector<c_vector<double, SPACE_DIM> >& rLocations);
+
+    /**
+     * @return the scalar product of two vectors of node vectors
+     *
+     * @param rA the first vector
+     * @param rB the second vector
+     */
+    double ScalarProduct(const std::vector<c_vector<double, SPACE_DIM> >& rA,
+                         const std::vector<c_vector<double, SPACE_DIM> >& rB);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    BackwardEulerNumericalMethod();
+
+    /**
+     * Destructor.
+     */
+    virtual ~BackwardEulerNumericalMethod();
+
+    /**
+     * Overridden UpdateAllNodePositions() method.
+     *
+     * @param dt the time step
+     */
+    virtual void UpdateAllNodePositions(double dt);
+
+    /**
+     * Set mTolerance.
+     *
+     * @param tolerance the new value of mTolerance
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * @return mTolerance
+     */
+    double GetTolerance();
+
+    /**
+     * Set mMaxNewtonIterations.
+     *
+     * @param maxNewtonIterations the new value of mMaxNewtonIterations
+     */
+    void SetMaxNewtonIterations(unsigned maxNewtonIterations);
+
+    /**
+     * @return mMaxNewtonIterations
+     */
+    unsigned GetMaxNewtonIterations();
+
+    /**
+     * @return the number of sub-steps taken in the last time step.
+     */
+    unsigned GetNumSubStepsInLastStep();
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(BackwardEulerNumericalMethod)
+
+#endif /*BACKWARDEULERNUMERICALMETHOD_HPP_*/
@@ -0,0 +1,117 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "RungeKutta4NumericalMethod.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+RungeKutta4NumericalMethod<ELEMENT_DIM,SPACE_DIM>::RungeKutta4NumericalMethod()
+    : AbstractNumericalMethod<ELEMENT_DIM,SPACE_DIM>()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+RungeKutta4NumericalMethod<ELEMENT_DIM,SPACE_DIM>::~RungeKutta4NumericalMethod()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void RungeKutta4NumericalMethod<ELEMENT_DIM,SPACE_DIM>::UpdateAllNodePositions(double dt)
+{
+    this->CheckCellPopulationIsSupported();
+    this->SetUpNodeIndices();
+    unsigned num_nodes = this->mNodeIndices.size();
+
+    std::vector<c_vector<double, SPACE_DIM> > initial_locations;
+    this->GetNodeLocations(initial_locations);
+
+    // The forces at the start of the time step have already been calculated
+    std::vector<c_vector<double, SPACE_DIM> > k1, k2, k3, k4;
+    this->GetVelocitiesFromAppliedForces(k1);
+
+    std::vector<c_vector<double, SPACE_DIM> > stage_locations(num_nodes);
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        stage_locations[i] = initial_locations[i] + 0.5*dt*k1[i];
+    }
+    this->SetNodeLocations(stage_locations);
+    this->ComputeVelocities(k2);
+
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        stage_locations[i] = initial_locations[i] + 0.5*dt*k2[i];
+    }
+    this->SetNodeLocations(stage_locations);
+    this->ComputeVelocities(k3);
+
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        stage_locations[i] = initial_locations[i] + dt*k3[i];
+    }
+    this->SetNodeLocations(stage_locations);
+    this->ComputeVelocities(k4);
+
+    double max_displacement = this->GetMaximumDisplacement();
+    for (unsigned i=0; i<num_nodes; i++)
+    {
+        c_vector<double, SPACE_DIM> displacement = dt*(k1[i] + 2.0*k2[i] + 2.0*k3[i] + k4[i])/6.0;
+
+        // Throws an exception if the cell movement goes beyond the maximum displacement
+        if (norm_2(displacement) > max_displacement)
+        {
+            this->SetNodeLocations(initial_locations);
+            EXCEPTION("Cells are moving by: " << norm_2(displacement) <<
+                    ", which is more than the AbsoluteMovementThreshold: "
+                    << max_displacement <<
+                    ". Use a smaller timestep to avoid this exception.");
+        }
+        stage_locations[i] = initial_locations[i] + displacement;
+    }
+    this->SetNodeLocations(stage_locations);
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Explicit instantiation
+/////////////////////////////////////////////////////////////////////////////
+
+template class RungeKutta4NumericalMethod<1,1>;
+template class RungeKutta4NumericalMethod<1,2>;
+template class RungeKutta4NumericalMethod<2,2>;
+template class RungeKutta4NumericalMethod<1,3>;
+template class RungeKutta4NumericalMethod<2,3>;
+template class RungeKutta4NumericalMethod<3,3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(RungeKutta4NumericalMethod)
@@ -1754,6 +1754,46 @@ public:
         TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), 2u);
     }
 
+    void TestNeighbourTables() throw(Exception)
+    {
+        // Create a 3D mesh that is periodic in x
+        PottsMeshGenerator<3> generator(4, 1, 2, 3, 1, 2, 3, 1, 2, false, true, false, false);
+        PottsMesh<3>* p_mesh = generator.GetMesh();
+
+        for (unsigned deletion=0; deletion<2; deletion++)
+        {
+            // The compressed row tables hold the same neighbours, in the same order, as the sets
+            const std::vector<unsigned>& r_moore_starts = p_mesh->rGetMooreNeighbourStarts();
+            const std::vector<unsigned>& r_moore_neighbours = p_mesh->rGetMooreNeighbours();
+            const std::vector<unsigned>& r_von_neumann_starts = p_mesh->rGetVonNeumannNeighbourStarts();
+            const std::vector<unsigned>& r_von_neumann_neighbours = p_mesh->rGetVonNeumannNeighbours();
+
+            unsigned num_nodes = p_mesh->GetNumNodes();
+            TS_ASSERT_EQUALS(r_moore_starts.size(), num_nodes+1);
+            TS_ASSERT_EQUALS(r_von_neumann_starts.size(), num_nodes+1);
+            TS_ASSERT_EQUALS(r_moore_starts.back(), r_moore_neighbours.size());
+            TS_ASSERT_EQUALS(r_von_neumann_starts.back(), r_von_neumann_neighbours.size());
+
+            for (unsigned node_index=0; node_index<num_nodes; node_index++)
+            {
+                std::set<unsigned> moore = p_mesh->GetMooreNeighbouringNodeIndices(node_index);
+                std::vector<unsigned> moore_from_table(r_moore_neighbours.begin() + r_moore_starts[node_index],
+                                                       r_moore_neighbours.begin() + r_moore_starts[node_index+1]);
+                TS_ASSERT(std::vector<unsigned>(moore.begin(), moore.end()) == moore_from_table);
+
+                std::set<unsigned> von_neumann = p_mesh->GetVonNeumannNeighbouringNodeIndices(node_index);
+                std::vector<unsigned> von_neumann_from_table(r_von_neumann_neighbours.begin() + r_von_neumann_starts[node_index],
+                                                             r_von_neumann_neighbours.begin() + r_von_neumann_starts[node_index+1]);
+                TS_ASSERT(std::vector<unsigned>(von_neumann.begin(), von_neumann.end()) == von_neumann_from_table);
+            }
+
+            // The tables are rebuilt when a node is deleted
+            unsigned revision = p_mesh->GetNeighbourTablesRevision();
+            p_mesh->DeleteNode(0);
+            TS_ASSERT_DIFFERS(p_mesh->GetNeighbourTablesRevision(), revision);
+        }
+    }
+
     void TestArchive2dPottsMesh()
     {
         EXIT_IF_PARALLEL;
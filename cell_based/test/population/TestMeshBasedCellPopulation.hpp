@@ -625,6 +625,70 @@ public:
         TS_ASSERT_EQUALS(node_indices, expected_node_indices);
     }
 
+    void TestRestLengthsAfterIncrementalReMesh()
+    {
+        SimulationTime* p_simulation_time = SimulationTime::Instance();
+        p_simulation_time->SetEndTimeAndNumberOfTimeSteps(10.0, 1);
+
+        // Create a simple mesh, to be remeshed incrementally
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/square_128_elements");
+        MutableMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+        mesh.SetUseIncrementalReMesh(true);
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        cells[27]->StartApoptosis();
+
+        MeshBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // The first remesh is a full one, after which the mesh can be repaired incrementally
+        cell_population.Update();
+        cell_population.CalculateRestLengths();
+
+        // Give each spring a different rest length, and record them by the pair of cells joined
+        std::map<std::pair<Cell*,Cell*>, double> rest_lengths;
+        unsigned spring_index = 0;
+        for (MeshBasedCellPopulation<2>::SpringIterator spring_iterator = cell_population.SpringsBegin();
+             spring_iterator != cell_population.SpringsEnd();
+             ++spring_iterator)
+        {
+            double rest_length = 1.0 + 0.001*spring_index;
+            cell_population.SetRestLength(spring_iterator.GetNodeA()->GetIndex(), spring_iterator.GetNodeB()->GetIndex(), rest_length);
+            rest_lengths[std::make_pair(spring_iterator.GetCellA().get(), spring_iterator.GetCellB().get())] = rest_length;
+            spring_index++;
+        }
+
+        // Removing a cell shifts the node indices above it
+        p_simulation_time->IncrementTimeOneStep();
+        TS_ASSERT_EQUALS(cell_population.RemoveDeadCells(), 1u);
+        cell_population.Update();
+        TS_ASSERT_EQUALS(mesh.GetNumAllNodes(), 80u);
+
+        // Springs between surviving cells keep their rest lengths under the new node indices
+        unsigned num_springs_kept = 0;
+        for (MeshBasedCellPopulation<2>::SpringIterator spring_iterator = cell_population.SpringsBegin();
+             spring_iterator != cell_population.SpringsEnd();
+             ++spring_iterator)
+        {
+            Cell* p_cell_a = spring_iterator.GetCellA().get();
+            Cell* p_cell_b = spring_iterator.GetCellB().get();
+            std::map<std::pair<Cell*,Cell*>, double>::iterator iter = rest_lengths.find(std::make_pair(p_cell_a, p_cell_b));
+            if (iter == rest_lengths.end())
+            {
+                iter = rest_lengths.find(std::make_pair(p_cell_b, p_cell_a));
+            }
+            if (iter != rest_lengths.end())
+            {
+                TS_ASSERT_DELTA(cell_population.GetRestLength(spring_iterator.GetNodeA()->GetIndex(), spring_iterator.GetNodeB()->GetIndex()),
+                                iter->second, 1e-12);
+                num_springs_kept++;
+            }
+        }
+        TS_ASSERT_LESS_THAN(190u, num_springs_kept);
+    }
+
     void TestUpdateNodeLocations()
     {
         // Test MeshBasedCellPopulation::UpdateNodeLocations()
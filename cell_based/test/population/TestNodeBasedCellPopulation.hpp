@@ -80,6 +80,22 @@ class TestNodeBasedCellPopulation : public AbstractCellBasedTestSuite
 {
 private:
 
+    std::set<std::pair<unsigned, unsigned> > GetNodePairsWithinDistance(NodeBasedCellPopulation<2>& rCellPopulation, double distance)
+    {
+        std::set<std::pair<unsigned, unsigned> > close_pairs;
+        std::vector<std::pair<Node<2>*, Node<2>* > >& r_pairs = rCellPopulation.rGetNodePairs();
+        for (unsigned i=0; i<r_pairs.size(); i++)
+        {
+            if (norm_2(r_pairs[i].first->rGetLocation() - r_pairs[i].second->rGetLocation()) < distance)
+            {
+                unsigned a = r_pairs[i].first->GetIndex();
+                unsigned b = r_pairs[i].second->GetIndex();
+                close_pairs.insert(std::make_pair(std::min(a,b), std::max(a,b)));
+            }
+        }
+        return close_pairs;
+    }
+
     template<unsigned DIM>
     void TestSimpleNodeBasedCellPopulation(std::string meshFilename)
     {
@@ -1376,6 +1392,86 @@ public:
             delete nodes[i];
         }
     }
+
+    void TestVerletList() throw (Exception)
+    {
+        EXIT_IF_PARALLEL;
+
+        // Two copies of the same cells on a perturbed grid, one of them using a Verlet list
+        std::vector<Node<2>* > nodes;
+        for (unsigned i=0; i<100; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 0.9*(i%10) + 0.05*(i%3), 0.9*(i/10) + 0.05*(i%4)));
+        }
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        NodesOnlyMesh<2> verlet_mesh;
+        verlet_mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        std::vector<CellPtr> verlet_cells;
+        CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+        cells_generator.GenerateBasic(verlet_cells, verlet_mesh.GetNumNodes());
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        NodeBasedCellPopulation<2> verlet_cell_population(verlet_mesh, verlet_cells);
+
+        TS_ASSERT_DELTA(verlet_cell_population.GetVerletSkin(), 0.0, 1e-12);
+        verlet_cell_population.SetVerletSkin(0.4);
+        TS_ASSERT_DELTA(verlet_cell_population.GetVerletSkin(), 0.4, 1e-12);
+        TS_ASSERT_DELTA(verlet_cell_population.GetMechanicsCutOffLength(), 1.5, 1e-12);
+        TS_ASSERT_DELTA(verlet_mesh.GetMaximumInteractionDistance(), 1.9, 1e-12);
+
+        unsigned num_rebuilds = 0;
+        for (unsigned step=0; step<10; step++)
+        {
+            cell_population.Update(false);
+
+            verlet_cell_population.Update(false);
+            if (norm_2(verlet_cell_population.mVerletReferenceLocations[0].second - verlet_mesh.GetNode(0)->rGetLocation()) < 1e-12)
+            {
+                num_rebuilds++;
+            }
+
+            // Every pair of cells within the cut-off length is found
+            TS_ASSERT(GetNodePairsWithinDistance(verlet_cell_population, 1.5) == GetNodePairsWithinDistance(cell_population, 1.5));
+
+            // Move both copies of the cells by the same small amount
+            for (unsigned i=0; i<100; i++)
+            {
+                c_vector<double, 2> displacement;
+                displacement[0] = 0.03*sin(double(i + step));
+                displacement[1] = 0.03*cos(double(2*i + step));
+                mesh.GetNode(i)->rGetModifiableLocation() += displacement;
+                verlet_mesh.GetNode(i)->rGetModifiableLocation() += displacement;
+            }
+        }
+
+        // No cell has moved more than half the skin, so the node pairs were only found once
+        TS_ASSERT_EQUALS(num_rebuilds, 1u);
+
+        // Moving a cell further than half the skin forces a rebuild
+        mesh.GetNode(0)->rGetModifiableLocation()[0] += 0.3;
+        verlet_mesh.GetNode(0)->rGetModifiableLocation()[0] += 0.3;
+        cell_population.Update(false);
+        verlet_cell_population.Update(false);
+        TS_ASSERT_DELTA(norm_2(verlet_cell_population.mVerletReferenceLocations[0].second - verlet_mesh.GetNode(0)->rGetLocation()), 0.0, 1e-12);
+        TS_ASSERT(GetNodePairsWithinDistance(verlet_cell_population, 1.5) == GetNodePairsWithinDistance(cell_population, 1.5));
+
+        // Births force a rebuild
+        verlet_mesh.GetNode(1)->rGetModifiableLocation()[1] += 0.01;
+
+        verlet_cell_population.Update(true);
+        TS_ASSERT_DELTA(norm_2(verlet_cell_population.mVerletReferenceLocations[1].second - verlet_mesh.GetNode(1)->rGetLocation()), 0.0, 1e-12);
+
+        // Tidy up
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
 };
 
 #endif /*TESTNODEBASEDCELLPOPULATION_HPP_*/
@@ -195,6 +195,56 @@ public:
 #endif
     }
 
+    void TestAddNodeAndCellsToSendToEachProcess() throw (Exception)
+    {
+        unsigned index_of_node_to_send = mpNodesOnlyMesh->GetNodeIteratorBegin()->GetIndex();
+        mpNodeBasedCellPopulation->AddNodeAndCellToSend(index_of_node_to_send, 2);
+        mpNodeBasedCellPopulation->AddNodeAndCellToSend(index_of_node_to_send, 3);
+
+        TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsToSend[2].size(), 1u);
+        TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsToSend[3].size(), 1u);
+
+        unsigned node_2_index = (*mpNodeBasedCellPopulation->mCellsToSend[2].begin()).second->GetIndex();
+        TS_ASSERT_EQUALS(node_2_index, index_of_node_to_send);
+
+        // Adding a collection of cells replaces the list for that process
+        std::vector<unsigned> cells_to_send;
+        mpNodeBasedCellPopulation->AddCellsToSend(3, cells_to_send);
+        TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsToSend[2].size(), 1u);
+        TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsToSend[3].size(), 0u);
+
+        // The right and left lists are those for the neighbouring ranks
+        mpNodeBasedCellPopulation->AddNodeAndCellToSend(index_of_node_to_send, PetscTools::GetMyRank() + 1);
+        TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsToSendRight.size(), 1u);
+        mpNodeBasedCellPopulation->AddCellsToSendRight(cells_to_send);
+        TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsToSend[PetscTools::GetMyRank() + 1].size(), 0u);
+    }
+
+    void TestSendAndRecieveCellsFromEachNeighbour() throw (Exception)
+    {
+        unsigned index_of_node_to_send = mpNodesOnlyMesh->GetNodeIteratorBegin()->GetIndex();
+        const std::vector<unsigned>& r_neighbours = mpNodesOnlyMesh->rGetNeighbourProcesses();
+        for (unsigned i=0; i<r_neighbours.size(); i++)
+        {
+            mpNodeBasedCellPopulation->AddNodeAndCellToSend(index_of_node_to_send, r_neighbours[i]);
+        }
+
+#if BOOST_VERSION >= 103700
+        mpNodeBasedCellPopulation->NonBlockingSendCellsToNeighbourProcesses();
+        mpNodeBasedCellPopulation->GetReceivedCells();
+
+        // The population is split into strips, so the neighbours are the processes either side
+        TS_ASSERT_EQUALS(r_neighbours.size(), 2u - PetscTools::AmMaster() - PetscTools::AmTopMost());
+        for (unsigned i=0; i<r_neighbours.size(); i++)
+        {
+            TS_ASSERT_EQUALS(mpNodeBasedCellPopulation->mCellsRecv[r_neighbours[i]]->size(), 1u);
+
+            unsigned index = (*mpNodeBasedCellPopulation->mCellsRecv[r_neighbours[i]]->begin()).second->GetIndex();
+            TS_ASSERT_EQUALS(index, r_neighbours[i]);
+        }
+#endif
+    }
+
     void TestUpdateCellProcessLocation() throw (Exception)
     {
         if (PetscTools::GetNumProcs() > 1)
@@ -265,6 +315,34 @@ public:
 #endif
     }
 
+    void TestHaloCellsAreNotCounted() throw (Exception)
+    {
+#if BOOST_VERSION >= 103700
+        boost::shared_ptr<AbstractCellProperty> p_state = CellPropertyRegistry::Instance()->Get<WildTypeCellMutationState>();
+        unsigned num_owned_cells = mpNodeBasedCellPopulation->GetNumRealCells();
+
+        // The second refresh releases the halo cells received by the first
+        for (unsigned refresh=0; refresh<2; refresh++)
+        {
+            mpNodeBasedCellPopulation->Update();
+            mpNodeBasedCellPopulation->RefreshHaloCells();
+            mpNodeBasedCellPopulation->AddReceivedHaloCells();
+
+            if (PetscTools::IsParallel())
+            {
+                TS_ASSERT_LESS_THAN(0u, mpNodeBasedCellPopulation->mHaloCells.size());
+            }
+
+            // Only the cells owned by this process are counted here, so each cell is counted once overall
+            TS_ASSERT_EQUALS(p_state->GetCellCount(), num_owned_cells);
+            unsigned total_count;
+            unsigned local_count = p_state->GetCellCount();
+            MPI_Allreduce(&local_count, &total_count, 1, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+            TS_ASSERT_EQUALS(total_count, PetscTools::GetNumProcs());
+        }
+#endif
+    }
+
     void TestUpdateWithLoadBalanceDoesntThrow() throw (Exception)
     {
 #if BOOST_VERSION < 103700
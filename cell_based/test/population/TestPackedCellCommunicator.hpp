@@ -0,0 +1,303 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTPACKEDCELLCOMMUNICATOR_HPP_
+#define TESTPACKEDCELLCOMMUNICATOR_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "PackedCellCommunicator.hpp"
+#include "FixedDurationGenerationBasedCellCycleModel.hpp"
+#include "GammaDistributedStochasticDurationCellCycleModel.hpp"
+#include "SimpleOxygenBasedCellCycleModel.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "BetaCateninOneHitCellMutationState.hpp"
+#include "StemCellProliferativeType.hpp"
+#include "TransitCellProliferativeType.hpp"
+#include "CellLabel.hpp"
+#include "CellAncestor.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "SmartPointers.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestPackedCellCommunicator : public AbstractCellBasedTestSuite
+{
+public:
+
+    void TestPackAndUnpackCells() throw (Exception)
+    {
+        CellPropertyRegistry* p_registry = CellPropertyRegistry::Instance();
+        boost::shared_ptr<AbstractCellProperty> p_wild_type(p_registry->Get<WildTypeCellMutationState>());
+        boost::shared_ptr<AbstractCellProperty> p_beta_catenin(p_registry->Get<BetaCateninOneHitCellMutationState>());
+        boost::shared_ptr<AbstractCellProperty> p_stem_type(p_registry->Get<StemCellProliferativeType>());
+        boost::shared_ptr<AbstractCellProperty> p_transit_type(p_registry->Get<TransitCellProliferativeType>());
+        boost::shared_ptr<AbstractCellProperty> p_shared_label(p_registry->Get<CellLabel>());
+
+        std::vector<std::pair<CellPtr, Node<2>* > > cells;
+
+        // A generation-based cell with data, an ancestor, a shared label and apoptosis started
+        FixedDurationGenerationBasedCellCycleModel* p_model_0 = new FixedDurationGenerationBasedCellCycleModel;
+        p_model_0->SetGeneration(3);
+        p_model_0->SetMaxTransitGenerations(5);
+        p_model_0->SetBirthTime(-2.5);
+        p_model_0->SetDimension(2);
+        CellPtr p_cell_0(new Cell(p_beta_catenin, p_model_0));
+        p_cell_0->SetCellProliferativeType(p_transit_type);
+        p_cell_0->GetCellData()->SetItem("oxygen", 0.75);
+        p_cell_0->GetCellData()->SetItem("drug", 2.0);
+        MAKE_PTR_ARGS(CellAncestor, p_ancestor, (7));
+        p_cell_0->SetAncestor(p_ancestor);
+        p_cell_0->AddCellProperty(p_shared_label);
+        p_cell_0->InitialiseCellCycleModel();
+        p_cell_0->StartApoptosis();
+        p_cell_0->SetLogged();
+
+        Node<2>* p_node_0 = new Node<2>(4, true, 1.0, 2.0);
+        p_node_0->SetRadius(0.6);
+        p_node_0->AddNodeAttribute(3.5);
+        cells.push_back(std::make_pair(p_cell_0, p_node_0));
+
+        // A stochastic cell with its own label and no node attributes
+        GammaDistributedStochasticDurationCellCycleModel* p_model_1 = new GammaDistributedStochasticDurationCellCycleModel;
+        p_model_1->SetShape(3.0);
+        p_model_1->SetScale(1.5);
+        p_model_1->SetDimension(2);
+        CellPtr p_cell_1(new Cell(p_wild_type, p_model_1));
+        p_cell_1->SetCellProliferativeType(p_stem_type);
+        p_cell_1->GetCellData()->SetItem("oxygen", 0.25);
+        MAKE_PTR_ARGS(CellLabel, p_label, (3));
+        p_cell_1->AddCellProperty(p_label);
+        p_cell_1->InitialiseCellCycleModel();
+
+        Node<2>* p_node_1 = new Node<2>(9, false, -1.0, 0.5);
+        cells.push_back(std::make_pair(p_cell_1, p_node_1));
+
+        // A cell whose cell-cycle model is not packed directly, so is archived instead
+        SimpleOxygenBasedCellCycleModel* p_model_2 = new SimpleOxygenBasedCellCycleModel;
+        p_model_2->SetDimension(2);
+        CellPtr p_cell_2(new Cell(p_wild_type, p_model_2));
+        p_cell_2->SetCellProliferativeType(p_stem_type);
+        p_cell_2->GetCellData()->SetItem("oxygen", 1.0);
+        p_cell_2->AddCellProperty(p_shared_label);
+        p_cell_2->InitialiseCellCycleModel();
+
+        Node<2>* p_node_2 = new Node<2>(12, false, 0.0, 3.0);
+        cells.push_back(std::make_pair(p_cell_2, p_node_2));
+
+        TS_ASSERT_EQUALS(p_wild_type->GetCellCount(), 2u);
+        TS_ASSERT_EQUALS(p_beta_catenin->GetCellCount(), 1u);
+
+        std::vector<char> buffer;
+        PackedCellCommunicator<2>::PackCells(cells, buffer);
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<2>* > > > p_received
+            = PackedCellCommunicator<2>::UnpackCells(&buffer[0], buffer.size());
+
+        TS_ASSERT_EQUALS(p_received->size(), 3u);
+
+        // Packed cells are received in order, followed by the archived ones
+        for (unsigned i=0; i<p_received->size(); i++)
+        {
+            CellPtr p_sent = cells[i].first;
+            CellPtr p_cell = (*p_received)[i].first;
+            Node<2>* p_sent_node = cells[i].second;
+            Node<2>* p_node = (*p_received)[i].second;
+
+            TS_ASSERT_EQUALS(p_node->GetIndex(), p_sent_node->GetIndex());
+            TS_ASSERT_EQUALS(p_node->IsBoundaryNode(), p_sent_node->IsBoundaryNode());
+            TS_ASSERT_DELTA(p_node->rGetLocation()[0], p_sent_node->rGetLocation()[0], 1e-12);
+            TS_ASSERT_DELTA(p_node->rGetLocation()[1], p_sent_node->rGetLocation()[1], 1e-12);
+
+            TS_ASSERT_EQUALS(p_cell->GetCellId(), p_sent->GetCellId());
+            TS_ASSERT_EQUALS(p_cell->IsLogged(), p_sent->IsLogged());
+            TS_ASSERT_EQUALS(p_cell->HasApoptosisBegun(), p_sent->HasApoptosisBegun());
+            TS_ASSERT_EQUALS(p_cell->IsDead(), p_sent->IsDead());
+            TS_ASSERT_DELTA(p_cell->GetBirthTime(), p_sent->GetBirthTime(), 1e-12);
+            TS_ASSERT_DELTA(p_cell->GetCellData()->GetItem("oxygen"), p_sent->GetCellData()->GetItem("oxygen"), 1e-12);
+            TS_ASSERT_EQUALS(p_cell->GetCellCycleModel()->GetCurrentCellCyclePhase(), p_sent->GetCellCycleModel()->GetCurrentCellCyclePhase());
+            TS_ASSERT_DELTA(p_cell->GetCellCycleModel()->GetG1Duration(), p_sent->GetCellCycleModel()->GetG1Duration(), 1e-12);
+            TS_ASSERT_EQUALS(p_cell->GetCellCycleModel()->GetDimension(), 2u);
+        }
+
+        // Shared properties are those of the registry on the receiving process
+        CellPtr p_cell_0_received = (*p_received)[0].first;
+        TS_ASSERT_EQUALS(p_cell_0_received->GetMutationState(), p_beta_catenin);
+        TS_ASSERT_EQUALS(p_cell_0_received->GetCellProliferativeType(), p_transit_type);
+        TS_ASSERT(p_cell_0_received->rGetCellPropertyCollection().HasProperty(p_shared_label));
+        TS_ASSERT_EQUALS(p_cell_0_received->GetAncestor(), 7u);
+        TS_ASSERT_DELTA(p_cell_0_received->GetCellData()->GetItem("drug"), 2.0, 1e-12);
+        TS_ASSERT_DELTA(p_cell_0_received->GetStartOfApoptosisTime(), p_cell_0->GetStartOfApoptosisTime(), 1e-12);
+        TS_ASSERT_DELTA(p_cell_0_received->GetApoptosisTime(), p_cell_0->GetApoptosisTime(), 1e-12);
+
+        FixedDurationGenerationBasedCellCycleModel* p_model_0_received
+            = static_cast<FixedDurationGenerationBasedCellCycleModel*>(p_cell_0_received->GetCellCycleModel());
+        TS_ASSERT_EQUALS(p_model_0_received->GetGeneration(), 3u);
+        TS_ASSERT_EQUALS(p_model_0_received->GetMaxTransitGenerations(), 5u);
+
+        Node<2>* p_node_0_received = (*p_received)[0].second;
+        TS_ASSERT_DELTA(p_node_0_received->GetRadius(), 0.6, 1e-12);
+        TS_ASSERT_EQUALS(p_node_0_received->GetNumNodeAttributes(), 1u);
+        TS_ASSERT_DELTA(p_node_0_received->rGetNodeAttributes()[0], 3.5, 1e-12);
+        TS_ASSERT(!(*p_received)[1].second->HasNodeAttributes());
+
+        CellPtr p_cell_1_received = (*p_received)[1].first;
+        TS_ASSERT_EQUALS(p_cell_1_received->GetMutationState(), p_wild_type);
+        GammaDistributedStochasticDurationCellCycleModel* p_model_1_received
+            = static_cast<GammaDistributedStochasticDurationCellCycleModel*>(p_cell_1_received->GetCellCycleModel());
+        TS_ASSERT_DELTA(p_model_1_received->GetShape(), 3.0, 1e-12);
+        TS_ASSERT_DELTA(p_model_1_received->GetScale(), 1.5, 1e-12);
+
+        // The unshared label is copied rather than shared
+        boost::shared_ptr<CellLabel> p_label_received
+            = boost::static_pointer_cast<CellLabel>(p_cell_1_received->rGetCellPropertyCollection().GetPropertiesType<CellLabel>().GetProperty());
+        TS_ASSERT_EQUALS(p_label_received->GetColour(), 3u);
+        TS_ASSERT(p_label_received != p_label);
+
+        TS_ASSERT(dynamic_cast<SimpleOxygenBasedCellCycleModel*>((*p_received)[2].first->GetCellCycleModel()) != NULL);
+
+        // The archived cell has the shared properties of this process too
+        CellPtr p_cell_2_received = (*p_received)[2].first;
+        TS_ASSERT_EQUALS(p_cell_2_received->GetMutationState(), p_wild_type);
+        TS_ASSERT_EQUALS(p_cell_2_received->GetCellProliferativeType(), p_stem_type);
+        TS_ASSERT(p_cell_2_received->rGetCellPropertyCollection().HasProperty(p_shared_label));
+
+        /*
+         * The received cells are counted by their shared properties. Once the sender stops counting
+         * the cells it sent, as NodeBasedCellPopulation::DeleteMovedCell() does, the counts are as before.
+         */
+        TS_ASSERT_EQUALS(p_wild_type->GetCellCount(), 4u);
+        TS_ASSERT_EQUALS(p_beta_catenin->GetCellCount(), 2u);
+        TS_ASSERT_EQUALS(p_shared_label->GetCellCount(), 4u);
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            cells[i].first->Kill();
+        }
+        TS_ASSERT_EQUALS(p_wild_type->GetCellCount(), 2u);
+        TS_ASSERT_EQUALS(p_beta_catenin->GetCellCount(), 1u);
+        TS_ASSERT_EQUALS(p_shared_label->GetCellCount(), 2u);
+
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            delete cells[i].second;
+            delete (*p_received)[i].second;
+        }
+    }
+
+    void TestSendAndReceiveCells() throw (Exception)
+    {
+        // Each process sends cells to the next process round a ring, and receives from the previous one
+        unsigned num_procs = PetscTools::GetNumProcs();
+        unsigned my_rank = PetscTools::GetMyRank();
+        unsigned next_process = (my_rank + 1) % num_procs;
+        unsigned previous_process = (my_rank + num_procs - 1) % num_procs;
+
+        boost::shared_ptr<AbstractCellProperty> p_wild_type(CellPropertyRegistry::Instance()->Get<WildTypeCellMutationState>());
+        boost::shared_ptr<AbstractCellProperty> p_stem_type(CellPropertyRegistry::Instance()->Get<StemCellProliferativeType>());
+
+        std::vector<std::pair<CellPtr, Node<2>* > > cells;
+        FixedDurationGenerationBasedCellCycleModel* p_model = new FixedDurationGenerationBasedCellCycleModel;
+        p_model->SetDimension(2);
+        CellPtr p_cell(new Cell(p_wild_type, p_model));
+        p_cell->SetCellProliferativeType(p_stem_type);
+        p_cell->GetCellData()->SetItem("rank", (double)my_rank);
+        p_cell->InitialiseCellCycleModel();
+        cells.push_back(std::make_pair(p_cell, new Node<2>(my_rank, false, 0.0, (double)my_rank)));
+
+        PackedCellCommunicator<2> communicator;
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<2>* > > > p_received
+            = communicator.SendRecvCells(cells, next_process, 123, previous_process, 123);
+
+        TS_ASSERT_EQUALS(p_received->size(), 1u);
+        TS_ASSERT_EQUALS((*p_received)[0].second->GetIndex(), previous_process);
+        TS_ASSERT_DELTA((*p_received)[0].second->rGetLocation()[1], (double)previous_process, 1e-12);
+        TS_ASSERT_DELTA((*p_received)[0].first->GetCellData()->GetItem("rank"), (double)previous_process, 1e-12);
+        TS_ASSERT_EQUALS((*p_received)[0].first->GetMutationState(), p_wild_type);
+        delete (*p_received)[0].second;
+
+        // Now the other way round without blocking, adding a cell that has to be archived
+        SimpleOxygenBasedCellCycleModel* p_archived_model = new SimpleOxygenBasedCellCycleModel;
+        p_archived_model->SetDimension(2);
+        CellPtr p_archived_cell(new Cell(p_wild_type, p_archived_model));
+        p_archived_cell->SetCellProliferativeType(p_stem_type);
+        p_archived_cell->GetCellData()->SetItem("rank", (double)my_rank);
+        p_archived_cell->InitialiseCellCycleModel();
+        cells.push_back(std::make_pair(p_archived_cell, new Node<2>(num_procs + my_rank, false, 1.0, (double)my_rank)));
+
+        communicator.ISendCells(cells, previous_process, 124);
+        communicator.IRecvCells(next_process, 124);
+        p_received = communicator.GetRecvCells();
+
+        TS_ASSERT_EQUALS(p_received->size(), 2u);
+        for (unsigned i=0; i<p_received->size(); i++)
+        {
+            TS_ASSERT_EQUALS((*p_received)[i].second->GetIndex(), i*num_procs + next_process);
+            TS_ASSERT_DELTA((*p_received)[i].first->GetCellData()->GetItem("rank"), (double)next_process, 1e-12);
+            TS_ASSERT_EQUALS((*p_received)[i].first->GetMutationState(), p_wild_type);
+            delete (*p_received)[i].second;
+        }
+        TS_ASSERT(dynamic_cast<SimpleOxygenBasedCellCycleModel*>((*p_received)[1].first->GetCellCycleModel()) != NULL);
+
+        // Each receive must be set up first
+        TS_ASSERT_THROWS_THIS(communicator.GetRecvCells(), "No receive has been set up by IRecvCells()");
+
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            delete cells[i].second;
+        }
+    }
+
+    void TestUnpackCellsExceptions() throw (Exception)
+    {
+        std::vector<std::pair<CellPtr, Node<2>* > > cells;
+        std::vector<char> buffer;
+        PackedCellCommunicator<2>::PackCells(cells, buffer);
+
+        boost::shared_ptr<std::vector<std::pair<CellPtr, Node<2>* > > > p_received
+            = PackedCellCommunicator<2>::UnpackCells(&buffer[0], buffer.size());
+        TS_ASSERT(p_received->empty());
+
+        TS_ASSERT_THROWS_THIS(PackedCellCommunicator<2>::UnpackCells(&buffer[0], 2u),
+                              "Packed cell buffer ended unexpectedly");
+
+        // The format version is the first entry in the buffer
+        unsigned bad_version = 0;
+        memcpy(&buffer[0], &bad_version, sizeof(unsigned));
+        TS_ASSERT_THROWS_THIS(PackedCellCommunicator<2>::UnpackCells(&buffer[0], buffer.size()),
+                              "Cannot unpack cells packed with format version 0; expected version 2");
+    }
+};
+
+#endif /*TESTPACKEDCELLCOMMUNICATOR_HPP_*/
@@ -384,6 +384,181 @@ public:
         TS_ASSERT_EQUALS(cell_population.rGetMesh().GetElement(1)->GetNumNodes(), 4u);
     }
 
+    void TestUpdateCellLocationsWithCheckerboardSweep() throw(Exception)
+    {
+        // Create a 2D PottsMesh with four cells
+        PottsMeshGenerator<2> generator(10, 2, 3, 10, 2, 3);
+        PottsMesh<2>* p_mesh = generator.GetMesh();
+
+        // Create cells
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+
+        // Create cell population
+        PottsBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // Test the checkerboard sweep settings
+        TS_ASSERT_EQUALS(cell_population.GetUseCheckerboardSweep(), false);
+        TS_ASSERT_EQUALS(cell_population.GetNumSweepThreads(), 1u);
+        cell_population.SetUseCheckerboardSweep(true);
+        TS_ASSERT_EQUALS(cell_population.GetUseCheckerboardSweep(), true);
+        TS_ASSERT_THROWS_THIS(cell_population.SetNumSweepThreads(0),
+                              "The number of sweep threads must be positive.");
+#ifdef _OPENMP
+        cell_population.SetNumSweepThreads(2);
+        TS_ASSERT_EQUALS(cell_population.GetNumSweepThreads(), 2u);
+#else
+        TS_ASSERT_THROWS_THIS(cell_population.SetNumSweepThreads(2),
+                              "Chaste was not compiled with OpenMP support, so checkerboard sweeps can only use one thread.");
+#endif // _OPENMP
+
+        // A regular 2D lattice needs four colours, and no two sites of the same colour are neighbours
+        cell_population.SetUpSiteColouring();
+        TS_ASSERT_EQUALS(cell_population.mSitesByColour.size(), 4u);
+        unsigned num_sites_coloured = 0;
+        for (unsigned colour=0; colour<cell_population.mSitesByColour.size(); colour++)
+        {
+            std::set<unsigned> sites(cell_population.mSitesByColour[colour].begin(), cell_population.mSitesByColour[colour].end());
+            num_sites_coloured += sites.size();
+            for (std::set<unsigned>::iterator site_iter = sites.begin(); site_iter != sites.end(); ++site_iter)
+            {
+                std::set<unsigned> neighbours = p_mesh->GetMooreNeighbouringNodeIndices(*site_iter);
+                for (std::set<unsigned>::iterator iter = neighbours.begin(); iter != neighbours.end(); ++iter)
+                {
+                    TS_ASSERT_EQUALS(sites.count(*iter), 0u);
+                }
+            }
+        }
+        TS_ASSERT_EQUALS(num_sites_coloured, p_mesh->GetNumNodes());
+
+        // Increase temperature: allows swaps to be more likely
+        cell_population.SetTemperature(10.0);
+        cell_population.SetNumSweepsPerTimestep(2);
+        MAKE_PTR(VolumeConstraintPottsUpdateRule<2>, p_volume_constraint_update_rule);
+        cell_population.AddUpdateRule(p_volume_constraint_update_rule);
+
+        // Run some sweeps, recording the elements' nodes
+        RandomNumberGenerator::Instance()->Reseed(7);
+        std::vector<std::set<unsigned> > element_nodes(p_mesh->GetNumElements());
+        unsigned num_nodes_in_elements_before = 0;
+        for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+        {
+            num_nodes_in_elements_before += p_mesh->GetElement(elem_index)->GetNumNodes();
+        }
+
+        for (unsigned i=0; i<3; i++)
+        {
+            cell_population.UpdateCellLocations(1.0);
+        }
+
+        unsigned num_nodes_in_elements_after = 0;
+        for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+        {
+            PottsElement<2>* p_element = p_mesh->GetElement(elem_index);
+            num_nodes_in_elements_after += p_element->GetNumNodes();
+            for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+            {
+                element_nodes[elem_index].insert(p_element->GetNodeGlobalIndex(local_index));
+
+                // Each site is in at most one element
+                TS_ASSERT_EQUALS(p_element->GetNode(local_index)->GetNumContainingElements(), 1u);
+            }
+        }
+        TS_ASSERT_EQUALS(cell_population.rGetCells().size(), 4u);
+        TS_ASSERT_DIFFERS(num_nodes_in_elements_after, 0u);
+        TS_ASSERT_LESS_THAN_EQUALS(num_nodes_in_elements_after, p_mesh->GetNumNodes());
+
+        // Repeating the sweeps from the same configuration with the same seed gives the same result
+        PottsMeshGenerator<2> generator2(10, 2, 3, 10, 2, 3);
+        PottsMesh<2>* p_mesh2 = generator2.GetMesh();
+        std::vector<CellPtr> cells2;
+        cells_generator.GenerateBasic(cells2, p_mesh2->GetNumElements());
+        PottsBasedCellPopulation<2> cell_population2(*p_mesh2, cells2);
+        cell_population2.SetUseCheckerboardSweep(true);
+        cell_population2.SetNumSweepThreads(cell_population.GetNumSweepThreads());
+        cell_population2.SetTemperature(10.0);
+        cell_population2.SetNumSweepsPerTimestep(2);
+        cell_population2.AddUpdateRule(p_volume_constraint_update_rule);
+
+        RandomNumberGenerator::Instance()->Reseed(7);
+        for (unsigned i=0; i<3; i++)
+        {
+            cell_population2.UpdateCellLocations(1.0);
+        }
+
+        for (unsigned elem_index=0; elem_index<p_mesh2->GetNumElements(); elem_index++)
+        {
+            PottsElement<2>* p_element = p_mesh2->GetElement(elem_index);
+            std::set<unsigned> nodes;
+            for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+            {
+                nodes.insert(p_element->GetNodeGlobalIndex(local_index));
+            }
+            TS_ASSERT(nodes == element_nodes[elem_index]);
+        }
+
+        // The colouring is recomputed if the lattice changes
+        p_mesh->DeleteNode(0);
+        cell_population.UpdateCellLocations(1.0);
+        num_sites_coloured = 0;
+        for (unsigned colour=0; colour<cell_population.mSitesByColour.size(); colour++)
+        {
+            num_sites_coloured += cell_population.mSitesByColour[colour].size();
+        }
+        TS_ASSERT_EQUALS(num_sites_coloured, p_mesh->GetNumNodes());
+        TS_ASSERT_EQUALS(num_sites_coloured, 99u);
+    }
+
+    void TestCachedElementSurfaceAreas() throw(Exception)
+    {
+        // Create a 2D PottsMesh with four cells
+        PottsMeshGenerator<2> generator(10, 2, 3, 10, 2, 3);
+        PottsMesh<2>* p_mesh = generator.GetMesh();
+
+        // Create cells
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, p_mesh->GetNumElements());
+
+        // Create cell population
+        PottsBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+        // Outside a sweep, surface areas are computed by the mesh
+        TS_ASSERT(cell_population.mElementSurfaceAreas.empty());
+        TS_ASSERT_DELTA(cell_population.GetSurfaceAreaOfElement(0), 12.0, 1e-12);
+
+        // Move sites between elements and the medium, checking the cache is kept up to date
+        cell_population.SetUpElementSurfaceAreas();
+        TS_ASSERT_EQUALS(cell_population.mElementSurfaceAreas.size(), 4u);
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        const std::vector<unsigned>& r_starts = p_mesh->rGetMooreNeighbourStarts();
+        const std::vector<unsigned>& r_neighbours = p_mesh->rGetMooreNeighbours();
+        for (unsigned i=0; i<200; i++)
+        {
+            unsigned node_index = p_gen->randMod(p_mesh->GetNumNodes());
+            unsigned num_neighbours = r_starts[node_index+1] - r_starts[node_index];
+            unsigned neighbour_index = r_neighbours[r_starts[node_index] + p_gen->randMod(num_neighbours)];
+
+            // Don't empty an element
+            std::set<unsigned> containing_elements = p_mesh->GetNode(node_index)->rGetContainingElementIndices();
+            if (!containing_elements.empty() && p_mesh->GetElement(*containing_elements.begin())->GetNumNodes() == 1)
+            {
+                continue;
+            }
+            cell_population.MoveNodeToNeighbourElement(node_index, neighbour_index);
+
+            for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+            {
+                TS_ASSERT_DELTA(cell_population.GetSurfaceAreaOfElement(elem_index), p_mesh->GetSurfaceAreaOfElement(elem_index), 1e-12);
+            }
+        }
+
+        // The cache is only used during UpdateCellLocations()
+        cell_population.UpdateCellLocations(1.0);
+        TS_ASSERT(cell_population.mElementSurfaceAreas.empty());
+    }
+
     ///\todo implement this test (#1666)
 //    void TestVoronoiMethods()
 //    {
@@ -645,6 +820,7 @@ public:
             static_cast<PottsBasedCellPopulation<2>*>(p_cell_population)->SetNumSweepsPerTimestep(3);
             static_cast<PottsBasedCellPopulation<2>*>(p_cell_population)->SetUpdateNodesInRandomOrder(false);
             static_cast<PottsBasedCellPopulation<2>*>(p_cell_population)->SetIterateRandomlyOverUpdateRuleCollection(true);
+            static_cast<PottsBasedCellPopulation<2>*>(p_cell_population)->SetUseCheckerboardSweep(true);
 
             // Archive the cell population
             (*p_arch) << static_cast<const SimulationTime&>(*p_simulation_time);
@@ -680,6 +856,8 @@ public:
             TS_ASSERT_EQUALS(p_static_population->GetNumSweepsPerTimestep(), 3u);
             TS_ASSERT_EQUALS(p_static_population->GetUpdateNodesInRandomOrder(), false);
             TS_ASSERT_EQUALS(p_static_population->GetIterateRandomlyOverUpdateRuleCollection(), true);
+            TS_ASSERT_EQUALS(p_static_population->GetUseCheckerboardSweep(), true);
+            TS_ASSERT_EQUALS(p_static_population->GetNumSweepThreads(), 1u);
 
             // Test that the update rule has been archived correctly
             std::vector<boost::shared_ptr<AbstractPottsUpdateRule<2> > > update_rule_collection = p_static_population->rGetUpdateRuleCollection();
@@ -0,0 +1,242 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTNUMERICALMETHODS_HPP_
+#define TESTNUMERICALMETHODS_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+// Must be included before other cell_based headers
+#include "CellBasedSimulationArchiver.hpp"
+
+#include "OffLatticeSimulation.hpp"
+#include "ForwardEulerNumericalMethod.hpp"
+#include "RungeKutta4NumericalMethod.hpp"
+#include "AdaptiveRungeKuttaNumericalMethod.hpp"
+#include "BackwardEulerNumericalMethod.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "MeshBasedCellPopulationWithGhostNodes.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "HoneycombMeshGenerator.hpp"
+#include "CellsGenerator.hpp"
+#include "FixedDurationGenerationBasedCellCycleModel.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestNumericalMethods : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Run a short simulation of a compressed square of 16 cells relaxing under
+     * linear springs, and return the final cell locations.
+     *
+     * @param pNumericalMethod the numerical method
+     * @param dt the time step
+     * @return the final location of each node
+     */
+    std::vector<c_vector<double, 2> > RunSimulation(boost::shared_ptr<AbstractNumericalMethod<2> > pNumericalMethod, double dt)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<16; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 0.6*(i%4) + 0.05*(i%3), 0.6*(i/4) + 0.05*(i%2)));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        // Differentiated cells so that there are no divisions
+        std::vector<CellPtr> cells;
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+        CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, mesh.GetNumNodes(), std::vector<unsigned>(), p_diff_type);
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        OffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestNumericalMethods");
+        simulator.SetDt(dt);
+        simulator.SetEndTime(0.1);
+        simulator.SetNumericalMethod(pNumericalMethod);
+
+        MAKE_PTR(GeneralisedLinearSpringForce<2>, p_force);
+        p_force->SetCutOffLength(1.5);
+        simulator.AddForce(p_force);
+
+        simulator.Solve();
+
+        std::vector<c_vector<double, 2> > locations;
+        for (unsigned i=0; i<16; i++)
+        {
+            locations.push_back(cell_population.GetNode(i)->rGetLocation());
+        }
+
+        // Tidy up
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+
+        return locations;
+    }
+
+    /**
+     * @return the largest distance between corresponding locations
+     *
+     * @param rLocations1 the first set of locations
+     * @param rLocations2 the second set of locations
+     */
+    double GetMaximumDifference(const std::vector<c_vector<double, 2> >& rLocations1,
+                                const std::vector<c_vector<double, 2> >& rLocations2)
+    {
+        double max_difference = 0.0;
+        for (unsigned i=0; i<rLocations1.size(); i++)
+        {
+            max_difference = std::max(max_difference, norm_2(rLocations1[i] - rLocations2[i]));
+        }
+        return max_difference;
+    }
+
+public:
+
+    void TestNumericalMethodsAgainstReferenceSolution() throw (Exception)
+    {
+        EXIT_IF_PARALLEL; // Only ForwardEulerNumericalMethod can be used in parallel
+
+        // The default method is forward Euler
+        {
+            NodesOnlyMesh<2> mesh;
+            std::vector<Node<2>*> nodes;
+            nodes.push_back(new Node<2>(0, false, 0.0, 0.0));
+            mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+            std::vector<CellPtr> cells;
+            CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+            cells_generator.GenerateBasic(cells, mesh.GetNumNodes());
+            NodeBasedCellPopulation<2> cell_population(mesh, cells);
+            OffLatticeSimulation<2> simulator(cell_population);
+            TS_ASSERT(boost::dynamic_pointer_cast<ForwardEulerNumericalMethod<2> >(simulator.GetNumericalMethod()));
+            delete nodes[0];
+        }
+
+        // Reference solution, using forward Euler with a very small time step
+        MAKE_PTR(ForwardEulerNumericalMethod<2>, p_forward_euler);
+        std::vector<c_vector<double, 2> > reference = RunSimulation(p_forward_euler, 0.1/1200);
+
+        // At the same time step, RK4 is far more accurate than forward Euler
+        std::vector<c_vector<double, 2> > forward_euler_locations = RunSimulation(p_forward_euler, 0.01);
+        MAKE_PTR(RungeKutta4NumericalMethod<2>, p_rk4);
+        std::vector<c_vector<double, 2> > rk4_locations = RunSimulation(p_rk4, 0.01);
+        double forward_euler_error = GetMaximumDifference(forward_euler_locations, reference);
+        double rk4_error = GetMaximumDifference(rk4_locations, reference);
+        TS_ASSERT_LESS_THAN(rk4_error, 0.005);
+        TS_ASSERT_LESS_THAN(rk4_error, 0.5*forward_euler_error);
+
+        // The adaptive method sub-steps to remain accurate with a much larger time step
+        MAKE_PTR(AdaptiveRungeKuttaNumericalMethod<2>, p_adaptive);
+        TS_ASSERT_DELTA(p_adaptive->GetTolerance(), 1e-4, 1e-12);
+        std::vector<c_vector<double, 2> > adaptive_locations = RunSimulation(p_adaptive, 0.05);
+        TS_ASSERT_LESS_THAN(GetMaximumDifference(adaptive_locations, reference), 0.005);
+        TS_ASSERT_LESS_THAN(1u, p_adaptive->GetNumSubStepsInLastStep());
+
+        // The backward Euler method is stable and first-order accurate
+        MAKE_PTR(BackwardEulerNumericalMethod<2>, p_backward_euler);
+        TS_ASSERT_DELTA(p_backward_euler->GetTolerance(), 1e-6, 1e-12);
+        TS_ASSERT_EQUALS(p_backward_euler->GetMaxNewtonIterations(), 10u);
+        std::vector<c_vector<double, 2> > backward_euler_locations = RunSimulation(p_backward_euler, 0.01);
+        TS_ASSERT_LESS_THAN(GetMaximumDifference(backward_euler_locations, reference), 0.05);
+        TS_ASSERT_LESS_THAN(0u, p_backward_euler->GetNumSubStepsInLastStep());
+    }
+
+    void TestUnsupportedCellPopulations() throw (Exception)
+    {
+        EXIT_IF_PARALLEL; // HoneycombMeshGenerator doesn't work in parallel
+
+        HoneycombMeshGenerator generator(2, 2, 1);
+        MutableMesh<2,2>* p_mesh = generator.GetMesh();
+        std::vector<unsigned> location_indices = generator.GetCellLocationIndices();
+
+        std::vector<CellPtr> cells;
+        CellsGenerator<FixedDurationGenerationBasedCellCycleModel, 2> cells_generator;
+        cells_generator.GenerateBasic(cells, location_indices.size(), location_indices);
+
+        MeshBasedCellPopulationWithGhostNodes<2> cell_population(*p_mesh, cells, location_indices);
+
+        RungeKutta4NumericalMethod<2> numerical_method;
+        numerical_method.SetCellPopulation(&cell_population);
+        TS_ASSERT_THROWS_THIS(numerical_method.UpdateAllNodePositions(0.01),
+                "Cell populations with ghost nodes, particles or the Buske update can only be used with ForwardEulerNumericalMethod.");
+    }
+
+    void TestArchiving() throw (Exception)
+    {
+        EXIT_IF_PARALLEL; // Beware of processes overwriting the identical archives of other processes
+        OutputFileHandler handler("archive", false);
+        std::string archive_filename = handler.GetOutputDirectoryFullPath() + "AdaptiveRungeKuttaNumericalMethod.arch";
+
+        {
+            AdaptiveRungeKuttaNumericalMethod<2> numerical_method;
+            numerical_method.SetTolerance(1e-3);
+
+            std::ofstream ofs(archive_filename.c_str());
+            boost::archive::text_oarchive output_arch(ofs);
+
+            // Serialize via pointer to most abstract class possible
+            AbstractNumericalMethod<2>* const p_numerical_method = &numerical_method;
+            output_arch << p_numerical_method;
+        }
+
+        {
+            AbstractNumericalMethod<2>* p_numerical_method;
+
+            std::ifstream ifs(archive_filename.c_str(), std::ios::binary);
+            boost::archive::text_iarchive input_arch(ifs);
+            input_arch >> p_numerical_method;
+
+            AdaptiveRungeKuttaNumericalMethod<2>* p_adaptive = dynamic_cast<AdaptiveRungeKuttaNumericalMethod<2>*>(p_numerical_method);
+            TS_ASSERT(p_adaptive != NULL);
+            TS_ASSERT_DELTA(p_adaptive->GetTolerance(), 1e-3, 1e-12);
+
+            // Tidy up
+            delete p_numerical_method;
+        }
+    }
+};
+
+#endif /*TESTNUMERICALMETHODS_HPP_*/
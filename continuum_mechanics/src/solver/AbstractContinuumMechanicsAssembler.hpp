@@ -49,6 +49,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscMatTools.hpp"
 #include "GaussianQuadratureRule.hpp"
 
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+
 
 /**
  *  Abstract class for assembling volume-integral parts of matrices and vectors in continuum
@@ -120,6 +123,22 @@ protected:
      */
     void DoAssemble();
 
+    /**
+     * Assemble the contributions of all owned elements, computing the element
+     * contributions with #mNumAssemblyThreads threads.  Called by DoAssemble().
+     */
+    void DoAssembleConcurrently();
+
+    /**
+     * Get the global indices of the rows/columns corresponding to an element's
+     * elemental matrix and vector.  Note that a different ordering is used for the
+     * elemental matrix compared to the global matrix; see comments about ordering above.
+     *
+     * @param rElement  the element
+     * @param pIndices  array of size STENCIL_SIZE to be filled in
+     */
+    void GetElementGlobalIndices(Element<DIM, DIM>& rElement, unsigned* pIndices);
+
 
     /**
      *  For a continuum mechanics problem in mixed form (displacement-pressure or velocity-pressure), the matrix
@@ -389,6 +408,12 @@ void AbstractContinuumMechanicsAssembler<DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MA
         PetscMatTools::Zero(this->mMatrixToAssemble);
     }
 
+    if (this->AssembleConcurrently())
+    {
+        DoAssembleConcurrently();
+        return;
+    }
+
     c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> a_elem = zero_matrix<double>(STENCIL_SIZE,STENCIL_SIZE);
     c_vector<double, STENCIL_SIZE> b_elem = zero_vector<double>(STENCIL_SIZE);
 
@@ -414,45 +439,129 @@ void AbstractContinuumMechanicsAssembler<DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MA
 
             AssembleOnElement(r_element, a_elem, b_elem);
 
-            // Note that a different ordering is used for the elemental matrix compared to the global matrix.
-            // See comments about ordering above.
             unsigned p_indices[STENCIL_SIZE];
-            // Work out the mapping for spatial terms
-            for (unsigned i=0; i<NUM_NODES_PER_ELEMENT; i++)
+            GetElementGlobalIndices(r_element, p_indices);
+
+            if (this->mAssembleMatrix)
             {
-                for (unsigned j=0; j<DIM; j++)
-                {
-                    // DIM+1 on the right-hand side here is the problem dimension
-                    p_indices[DIM*i+j] = (DIM+1)*r_element.GetNodeGlobalIndex(i) + j;
-                }
+                PetscMatTools::AddMultipleValues<STENCIL_SIZE>(this->mMatrixToAssemble, p_indices, a_elem);
+            }
+
+            if (this->mAssembleVector)
+            {
+                PetscVecTools::AddMultipleValues<STENCIL_SIZE>(this->mVectorToAssemble, p_indices, b_elem);
+            }
+        }
+    }
+}
+
+template<unsigned DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX>
+void AbstractContinuumMechanicsAssembler<DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX>::DoAssembleConcurrently()
+{
+    // Element contributions are computed a chunk at a time into separate slots, then added
+    // to the PETSc objects by this thread in element order, since PETSc insertion is not
+    // thread-safe.  This gives exactly the same result as the serial loop in DoAssemble().
+    std::vector<Element<DIM, DIM>*> chunk_elements;
+    chunk_elements.reserve(this->ASSEMBLY_CHUNK_SIZE);
+    std::vector<c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> > a_elems(this->ASSEMBLY_CHUNK_SIZE);
+    std::vector<c_vector<double, STENCIL_SIZE> > b_elems(this->ASSEMBLY_CHUNK_SIZE);
+
+    typename AbstractTetrahedralMesh<DIM, DIM>::ElementIterator iter = mpMesh->GetElementIteratorBegin();
+    while (iter != mpMesh->GetElementIteratorEnd())
+    {
+        // Gather the next chunk of elements to be assembled
+        chunk_elements.clear();
+        for ( ; iter != mpMesh->GetElementIteratorEnd() && chunk_elements.size() < this->ASSEMBLY_CHUNK_SIZE; ++iter)
+        {
+            Element<DIM, DIM>& r_element = *iter;
+            if (r_element.GetOwnership() == true)
+            {
+                chunk_elements.push_back(&r_element);
             }
-            // Work out the mapping for pressure terms
-            for (unsigned i=0; i<NUM_VERTICES_PER_ELEMENT; i++)
+        }
+
+        // OpenMP 2.5 loops need a signed index
+        const int num_chunk_elements = chunk_elements.size();
+
+        // Details of the failure with the lowest index in the chunk, if any
+        int failed_index = num_chunk_elements;
+        boost::scoped_ptr<Exception> p_failure;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(this->mNumAssemblyThreads)
+#endif // _OPENMP
+        for (int i=0; i<num_chunk_elements; i++)
+        {
+            // Exceptions can't propagate out of a parallel region, so record the failure instead
+            try
             {
-                p_indices[DIM*NUM_NODES_PER_ELEMENT + i] = (DIM+1)*r_element.GetNodeGlobalIndex(i)+DIM;
+                AssembleOnElement(*(chunk_elements[i]), a_elems[i], b_elems[i]);
             }
+            catch (Exception& e)
+            {
+#ifdef _OPENMP
+#pragma omp critical(AbstractContinuumMechanicsAssembler_Failure)
+#endif // _OPENMP
+                {
+                    if (i < failed_index)
+                    {
+                        failed_index = i;
+                        p_failure.reset(new Exception(e));
+                    }
+                }
+            }
+        }
+
+        if (p_failure)
+        {
+            throw Exception(*p_failure);
+        }
 
+        for (int i=0; i<num_chunk_elements; i++)
+        {
+            unsigned p_indices[STENCIL_SIZE];
+            GetElementGlobalIndices(*(chunk_elements[i]), p_indices);
 
             if (this->mAssembleMatrix)
             {
-                PetscMatTools::AddMultipleValues<STENCIL_SIZE>(this->mMatrixToAssemble, p_indices, a_elem);
+                PetscMatTools::AddMultipleValues<STENCIL_SIZE>(this->mMatrixToAssemble, p_indices, a_elems[i]);
             }
 
             if (this->mAssembleVector)
             {
-                PetscVecTools::AddMultipleValues<STENCIL_SIZE>(this->mVectorToAssemble, p_indices, b_elem);
+                PetscVecTools::AddMultipleValues<STENCIL_SIZE>(this->mVectorToAssemble, p_indices, b_elems[i]);
             }
         }
     }
 }
 
+template<unsigned DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX>
+void AbstractContinuumMechanicsAssembler<DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX>::GetElementGlobalIndices(Element<DIM, DIM>& rElement,
+                                                                                                               unsigned* pIndices)
+{
+    // Work out the mapping for spatial terms
+    for (unsigned i=0; i<NUM_NODES_PER_ELEMENT; i++)
+    {
+        for (unsigned j=0; j<DIM; j++)
+        {
+            // DIM+1 on the right-hand side here is the problem dimension
+            pIndices[DIM*i+j] = (DIM+1)*rElement.GetNodeGlobalIndex(i) + j;
+        }
+    }
+    // Work out the mapping for pressure terms
+    for (unsigned i=0; i<NUM_VERTICES_PER_ELEMENT; i++)
+    {
+        pIndices[DIM*NUM_NODES_PER_ELEMENT + i] = (DIM+1)*rElement.GetNodeGlobalIndex(i)+DIM;
+    }
+}
+
 template<unsigned DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX>
 void AbstractContinuumMechanicsAssembler<DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX>::AssembleOnElement(Element<DIM, DIM>& rElement,
                                                                                                          c_matrix<double, STENCIL_SIZE, STENCIL_SIZE >& rAElem,
                                                                                                          c_vector<double, STENCIL_SIZE>& rBElem)
 {
-    static c_matrix<double,DIM,DIM> jacobian;
-    static c_matrix<double,DIM,DIM> inverse_jacobian;
+    c_matrix<double,DIM,DIM> jacobian;
+    c_matrix<double,DIM,DIM> inverse_jacobian;
     double jacobian_determinant;
 
     mpMesh->GetInverseJacobianForElement(rElement.GetIndex(), jacobian, jacobian_determinant, inverse_jacobian);
@@ -469,10 +578,10 @@ void AbstractContinuumMechanicsAssembler<DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MA
 
 
     // Allocate memory for the basis functions values and derivative values
-    static c_vector<double, NUM_VERTICES_PER_ELEMENT> linear_phi;
-    static c_vector<double, NUM_NODES_PER_ELEMENT> quad_phi;
-    static c_matrix<double, DIM, NUM_NODES_PER_ELEMENT> grad_quad_phi;
-    static c_matrix<double, DIM, NUM_VERTICES_PER_ELEMENT> grad_linear_phi;
+    c_vector<double, NUM_VERTICES_PER_ELEMENT> linear_phi;
+    c_vector<double, NUM_NODES_PER_ELEMENT> quad_phi;
+    c_matrix<double, DIM, NUM_NODES_PER_ELEMENT> grad_quad_phi;
+    c_matrix<double, DIM, NUM_VERTICES_PER_ELEMENT> grad_linear_phi;
 
     c_vector<double,DIM> body_force;
 
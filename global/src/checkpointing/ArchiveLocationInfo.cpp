@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 std::string ArchiveLocationInfo::mDirAbsPath = "";
 std::string ArchiveLocationInfo::mMeshFilename = "mesh";
+bool ArchiveLocationInfo::mStateVariablesInSeparateArrays = false;
 
 void ArchiveLocationInfo::SetMeshPathname(const FileFinder& rDirectory, const std::string& rFilename)
 {
@@ -129,3 +130,13 @@ bool ArchiveLocationInfo::GetIsDirRelativeToChasteTestOutput()
     std::string::size_type pos = mDirAbsPath.find(chaste_output, 0);
     return (pos == 0);
 }
+
+void ArchiveLocationInfo::SetStateVariablesInSeparateArrays(bool separateArrays)
+{
+    mStateVariablesInSeparateArrays = separateArrays;
+}
+
+bool ArchiveLocationInfo::GetStateVariablesInSeparateArrays()
+{
+    return mStateVariablesInSeparateArrays;
+}
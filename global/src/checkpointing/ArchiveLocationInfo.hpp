@@ -64,6 +64,12 @@ private:
     /** Mesh filename (relative to #mDirAbsPath). */
     static std::string mMeshFilename;
 
+    /**
+     * Whether ODE systems should leave their state variables out of the archive, because
+     * the object that owns them writes them to a separate file.  Defaults to false.
+     */
+    static bool mStateVariablesInSeparateArrays;
+
 public:
 
     /**
@@ -138,6 +144,21 @@ public:
      * @return true if the directory provided is relative to CHASTE_TEST_OUTPUT.
      */
     static bool GetIsDirRelativeToChasteTestOutput();
+
+    /**
+     * Set whether ODE systems should leave their state variables out of the archive.
+     * This is used by AbstractCardiacTissue, which then writes the state variables of all
+     * its cells to a single raw array per process.  The same setting must be in force when
+     * the archive is loaded.
+     *
+     * @param separateArrays  whether state variables are written separately
+     */
+    static void SetStateVariablesInSeparateArrays(bool separateArrays);
+
+    /**
+     * @return whether ODE systems should leave their state variables out of the archive.
+     */
+    static bool GetStateVariablesInSeparateArrays();
 };
 
 #endif /*ARCHIVELOCATIONINFO_HPP_*/
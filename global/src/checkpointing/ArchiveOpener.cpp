@@ -36,7 +36,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Must be included before any other serialization headers
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
 
+#include <fstream>
 #include <sstream>
 #include <iostream>
 
@@ -46,14 +49,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Exception.hpp"
 #include "OutputFileHandler.hpp"
 
-/**
- * Specialization for input archives.
- * @param rDirectory
- * @param rFileNameBase
- * @param procId
- */
-template<>
-ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
+template<class Archive, class Stream>
+ArchiveOpener<Archive, Stream>::ArchiveOpener(
         const FileFinder& rDirectory,
         const std::string& rFileNameBase,
         unsigned procId)
@@ -61,6 +58,22 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
       mpPrivateStream(NULL),
       mpCommonArchive(NULL),
       mpPrivateArchive(NULL)
+{
+    if (Archive::is_loading::value)
+    {
+        OpenForReading(rDirectory, rFileNameBase, procId);
+    }
+    else
+    {
+        OpenForWriting(rDirectory, rFileNameBase, procId);
+    }
+}
+
+template<class Archive, class Stream>
+void ArchiveOpener<Archive, Stream>::OpenForReading(
+        const FileFinder& rDirectory,
+        const std::string& rFileNameBase,
+        unsigned procId)
 {
     // Figure out where things live
     ArchiveLocationInfo::SetArchiveDirectory(rDirectory);
@@ -69,7 +82,7 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
     common_path << ArchiveLocationInfo::GetArchiveDirectory() << rFileNameBase;
 
     // Try to open the main archive for replicated data
-    mpCommonStream = new std::ifstream(common_path.str().c_str(), std::ios::binary);
+    mpCommonStream = new Stream(common_path.str().c_str(), std::ios::binary);
     if (!mpCommonStream->is_open())
     {
         delete mpCommonStream;
@@ -78,7 +91,7 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
 
     try
     {
-        mpCommonArchive = new boost::archive::text_iarchive(*mpCommonStream);
+        mpCommonArchive = new Archive(*mpCommonStream);
     }
     catch (boost::archive::archive_exception& boost_exception)
     {
@@ -99,7 +112,7 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
     }
 
     // Try to open the secondary archive for distributed data
-    mpPrivateStream = new std::ifstream(private_path.c_str(), std::ios::binary);
+    mpPrivateStream = new Stream(private_path.c_str(), std::ios::binary);
     if (!mpPrivateStream->is_open())
     {
         delete mpPrivateStream;
@@ -107,35 +120,15 @@ ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::ArchiveOpener(
         delete mpCommonStream;
         EXCEPTION("Cannot load secondary archive file: " + private_path);
     }
-    mpPrivateArchive = new boost::archive::text_iarchive(*mpPrivateStream);
-    ProcessSpecificArchive<boost::archive::text_iarchive>::Set(mpPrivateArchive);
+    mpPrivateArchive = new Archive(*mpPrivateStream);
+    ProcessSpecificArchive<Archive>::Set(mpPrivateArchive);
 }
 
-template<>
-ArchiveOpener<boost::archive::text_iarchive, std::ifstream>::~ArchiveOpener()
-{
-    ProcessSpecificArchive<boost::archive::text_iarchive>::Set(NULL);
-    delete mpPrivateArchive;
-    delete mpPrivateStream;
-    delete mpCommonArchive;
-    delete mpCommonStream;
-}
-
-/**
- * Specialization for output archives.
- * @param rDirectory
- * @param rFileNameBase
- * @param procId
- */
-template<>
-ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
+template<class Archive, class Stream>
+void ArchiveOpener<Archive, Stream>::OpenForWriting(
         const FileFinder& rDirectory,
         const std::string& rFileNameBase,
         unsigned procId)
-    : mpCommonStream(NULL),
-      mpPrivateStream(NULL),
-      mpCommonArchive(NULL),
-      mpPrivateArchive(NULL)
 {
     // Check for user error
     if (procId != PetscTools::GetMyRank())
@@ -157,7 +150,7 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
     // Create master archive for replicated data
     if (PetscTools::AmMaster())
     {
-        mpCommonStream = new std::ofstream(common_path.str().c_str(), std::ios::binary | std::ios::trunc);
+        mpCommonStream = new Stream(common_path.str().c_str(), std::ios::binary | std::ios::trunc);
         if (!mpCommonStream->is_open())
         {
             delete mpCommonStream;
@@ -168,9 +161,9 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
     {
         // Non-master processes need to go through the serialization methods, but not write any data
 #ifdef _MSC_VER
-        mpCommonStream = new std::ofstream("NUL", std::ios::binary | std::ios::trunc);
+        mpCommonStream = new Stream("NUL", std::ios::binary | std::ios::trunc);
 #else
-        mpCommonStream = new std::ofstream("/dev/null", std::ios::binary | std::ios::trunc);
+        mpCommonStream = new Stream("/dev/null", std::ios::binary | std::ios::trunc);
 #endif
         #define COVERAGE_IGNORE
         if (!mpCommonStream->is_open())
@@ -180,10 +173,10 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
         }
         #undef COVERAGE_IGNORE
     }
-    mpCommonArchive = new boost::archive::text_oarchive(*mpCommonStream);
+    mpCommonArchive = new Archive(*mpCommonStream);
 
     // Create secondary archive for distributed data
-    mpPrivateStream = new std::ofstream(private_path.c_str(), std::ios::binary | std::ios::trunc);
+    mpPrivateStream = new Stream(private_path.c_str(), std::ios::binary | std::ios::trunc);
     if (!mpPrivateStream->is_open())
     {
         delete mpPrivateStream;
@@ -191,23 +184,32 @@ ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::ArchiveOpener(
         delete mpCommonStream;
         EXCEPTION("Failed to open secondary archive file for writing: " + private_path);
     }
-    mpPrivateArchive = new boost::archive::text_oarchive(*mpPrivateStream);
-    ProcessSpecificArchive<boost::archive::text_oarchive>::Set(mpPrivateArchive);
+    mpPrivateArchive = new Archive(*mpPrivateStream);
+    ProcessSpecificArchive<Archive>::Set(mpPrivateArchive);
 }
 
-template<>
-ArchiveOpener<boost::archive::text_oarchive, std::ofstream>::~ArchiveOpener()
+template<class Archive, class Stream>
+ArchiveOpener<Archive, Stream>::~ArchiveOpener()
 {
-    ProcessSpecificArchive<boost::archive::text_oarchive>::Set(NULL);
+    ProcessSpecificArchive<Archive>::Set(NULL);
     delete mpPrivateArchive;
     delete mpPrivateStream;
     delete mpCommonArchive;
     delete mpCommonStream;
 
-    /* In a parallel setting, make sure all processes have finished writing before
-     * continuing, to avoid nasty race conditions.
-     * For example, many tests will write an archive then immediately read it back
-     * in, which could easily break without this.
-     */
-    PetscTools::Barrier("~ArchiveOpener");
+    if (Archive::is_saving::value)
+    {
+        /* In a parallel setting, make sure all processes have finished writing before
+         * continuing, to avoid nasty race conditions.
+         * For example, many tests will write an archive then immediately read it back
+         * in, which could easily break without this.
+         */
+        PetscTools::Barrier("~ArchiveOpener");
+    }
 }
+
+// Explicit instantiation
+template class ArchiveOpener<boost::archive::text_iarchive, std::ifstream>;
+template class ArchiveOpener<boost::archive::text_oarchive, std::ofstream>;
+template class ArchiveOpener<boost::archive::binary_iarchive, std::ifstream>;
+template class ArchiveOpener<boost::archive::binary_oarchive, std::ofstream>;
@@ -53,9 +53,12 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * Internally the class uses ProcessSpecificArchive<Archive> to store the secondary archive.
  *
- * Note also that implementations of this templated class only exist for text archives, i.e.
- * Archive = boost::archive::text_iarchive (with Stream = std::ifstream), or
- * Archive = boost::archive::text_oarchive (with Stream = std::ofstream).
+ * Note also that implementations of this templated class only exist for text and binary archives, i.e.
+ * Archive = boost::archive::text_iarchive or boost::archive::binary_iarchive (with Stream = std::ifstream), or
+ * Archive = boost::archive::text_oarchive or boost::archive::binary_oarchive (with Stream = std::ofstream).
+ * Binary archives store the same object graph as text archives, without formatting numbers as text,
+ * but can only be read on a machine with the same architecture and Boost version as the one that
+ * wrote them.
  */
 template <class Archive, class Stream>
 class ArchiveOpener
@@ -103,6 +106,28 @@ public:
 
 private:
 
+    /**
+     * Open the archives for reading.  Called by the constructor for input archives.
+     *
+     * @param rDirectory  folder containing archive files.
+     * @param rFileNameBase  base name of archive files.
+     * @param procId  which secondary archive to read.
+     */
+    void OpenForReading(const FileFinder& rDirectory,
+                        const std::string& rFileNameBase,
+                        unsigned procId);
+
+    /**
+     * Open the archives for writing.  Called by the constructor for output archives.
+     *
+     * @param rDirectory  folder to write archive files to.
+     * @param rFileNameBase  base name of archive files.
+     * @param procId  must be this process' rank.
+     */
+    void OpenForWriting(const FileFinder& rDirectory,
+                        const std::string& rFileNameBase,
+                        unsigned procId);
+
     /** The file stream for the main archive. */
     Stream* mpCommonStream;
 
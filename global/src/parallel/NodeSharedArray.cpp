@@ -0,0 +1,244 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "NodeSharedArray.hpp"
+
+#include <cassert>
+
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+
+MPI_Comm NodeSharedArray::mWorldForCommunicators = MPI_COMM_NULL;
+MPI_Comm NodeSharedArray::mNodeCommunicator = MPI_COMM_NULL;
+MPI_Comm NodeSharedArray::mNodeLeaderCommunicator = MPI_COMM_NULL;
+
+NodeSharedArray::NodeSharedArray()
+    : mpData(NULL),
+      mSize(0u),
+      mIsShared(false)
+#if MPI_VERSION >= 3
+      , mHasWindow(false)
+#endif
+{
+}
+
+NodeSharedArray::~NodeSharedArray()
+{
+    // Singletons may be destroyed after MPI has been finalized, by which time
+    // the shared memory has been released anyway
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+#if MPI_VERSION >= 3
+    if (finalized && mHasWindow)
+    {
+        mHasWindow = false;
+        mpData = NULL;
+    }
+#endif // MPI_VERSION >= 3
+    Free();
+}
+
+void NodeSharedArray::Allocate(unsigned size, bool shared)
+{
+    Free();
+    mSize = size;
+    mIsShared = shared;
+
+#if MPI_VERSION >= 3
+    if (shared && GetNodeCommunicator() != MPI_COMM_SELF)
+    {
+        // All the memory is attached to the writer, so it is contiguous
+        MPI_Comm node_comm = GetNodeCommunicator();
+        int node_rank;
+        MPI_Comm_rank(node_comm, &node_rank);
+        MPI_Aint local_bytes = (node_rank == 0) ? size*sizeof(double) : 0;
+        double* p_local = NULL;
+        int ret = MPI_Win_allocate_shared(local_bytes, sizeof(double), MPI_INFO_NULL, node_comm, &p_local, &mWindow);
+        if (ret != MPI_SUCCESS)
+        {
+            EXCEPTION("Failed to allocate a node-shared array of size " << size << ".");
+        }
+        mHasWindow = true;
+
+        MPI_Aint writer_bytes;
+        int disp_unit;
+        MPI_Win_shared_query(mWindow, 0, &writer_bytes, &disp_unit, &mpData);
+        assert((unsigned) writer_bytes == size*sizeof(double));
+        if (size == 0u)
+        {
+            mpData = NULL;
+        }
+
+        // Shared memory is read and written directly, inside a single passive epoch
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, mWindow);
+        return;
+    }
+#endif // MPI_VERSION >= 3
+
+    // Each process has its own copy
+    if (size > 0u)
+    {
+        mpData = new double[size];
+    }
+}
+
+void NodeSharedArray::Free()
+{
+#if MPI_VERSION >= 3
+    if (mHasWindow)
+    {
+        MPI_Win_unlock_all(mWindow);
+        MPI_Win_free(&mWindow);
+        mHasWindow = false;
+        mpData = NULL;
+    }
+#endif // MPI_VERSION >= 3
+    delete[] mpData;
+    mpData = NULL;
+    mSize = 0u;
+}
+
+double* NodeSharedArray::GetData()
+{
+    return mpData;
+}
+
+const double* NodeSharedArray::GetData() const
+{
+    return mpData;
+}
+
+unsigned NodeSharedArray::GetSize() const
+{
+    return mSize;
+}
+
+bool NodeSharedArray::IsShared() const
+{
+    return mIsShared;
+}
+
+bool NodeSharedArray::IsWriter() const
+{
+    if (!mIsShared)
+    {
+        return true;
+    }
+    return (GetNodeLeaderCommunicator() != MPI_COMM_NULL);
+}
+
+void NodeSharedArray::Synchronise()
+{
+#if MPI_VERSION >= 3
+    if (mHasWindow)
+    {
+        MPI_Win_sync(mWindow);
+        MPI_Barrier(GetNodeCommunicator());
+        MPI_Win_sync(mWindow);
+    }
+#endif // MPI_VERSION >= 3
+}
+
+void NodeSharedArray::SumOverNodes()
+{
+    if (!mIsShared)
+    {
+        return;
+    }
+
+    Synchronise();
+    MPI_Comm leader_comm = GetNodeLeaderCommunicator();
+    if (leader_comm != MPI_COMM_NULL && mSize > 0u)
+    {
+        int num_nodes;
+        MPI_Comm_size(leader_comm, &num_nodes);
+        if (num_nodes > 1)
+        {
+            MPI_Allreduce(MPI_IN_PLACE, mpData, mSize, MPI_DOUBLE, MPI_SUM, leader_comm);
+        }
+    }
+    Synchronise();
+}
+
+MPI_Comm NodeSharedArray::GetNodeCommunicator()
+{
+    SetUpCommunicators();
+    return mNodeCommunicator;
+}
+
+MPI_Comm NodeSharedArray::GetNodeLeaderCommunicator()
+{
+    SetUpCommunicators();
+    return mNodeLeaderCommunicator;
+}
+
+void NodeSharedArray::SetUpCommunicators()
+{
+    MPI_Comm world = PetscTools::GetWorld();
+    if (world == mWorldForCommunicators)
+    {
+        return;
+    }
+
+    // Free communicators for a previous world
+    if (mNodeCommunicator != MPI_COMM_NULL && mNodeCommunicator != MPI_COMM_SELF)
+    {
+        MPI_Comm_free(&mNodeCommunicator);
+    }
+    if (mNodeLeaderCommunicator != MPI_COMM_NULL && mNodeLeaderCommunicator != MPI_COMM_SELF
+        && mNodeLeaderCommunicator != mWorldForCommunicators)
+    {
+        MPI_Comm_free(&mNodeLeaderCommunicator);
+    }
+    mWorldForCommunicators = world;
+
+    if (PetscTools::IsIsolated() || PetscTools::IsSequential())
+    {
+        mNodeCommunicator = MPI_COMM_SELF;
+        mNodeLeaderCommunicator = MPI_COMM_SELF;
+        return;
+    }
+
+#if MPI_VERSION >= 3
+    MPI_Comm_split_type(world, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &mNodeCommunicator);
+    int node_rank;
+    MPI_Comm_rank(mNodeCommunicator, &node_rank);
+    MPI_Comm_split(world, (node_rank == 0) ? 0 : MPI_UNDEFINED, 0, &mNodeLeaderCommunicator);
+#else
+    // Every process is a node of its own
+    mNodeCommunicator = MPI_COMM_SELF;
+    mNodeLeaderCommunicator = world;
+#endif // MPI_VERSION >= 3
+}
@@ -0,0 +1,159 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef NODESHAREDARRAY_HPP_
+#define NODESHAREDARRAY_HPP_
+
+#include <boost/utility.hpp>
+#include <mpi.h>
+
+/**
+ * An array of doubles which, when shared, is held once per shared-memory compute node
+ * rather than once per process.
+ *
+ * This is intended for large read-only data which every process needs a complete and
+ * identical copy of (e.g. lookup tables, or replicated vectors).  When built against an
+ * MPI-3 library, shared arrays live in an MPI shared-memory window allocated on the
+ * processes of each node.  One process per node (see IsWriter()) fills the array, and
+ * Synchronise() makes its writes visible to the others.  Without MPI-3, or when processes
+ * are isolated (see PetscTools::IsolateProcesses()), each process has its own copy and
+ * the same code still works.
+ *
+ * Allocating and freeing a shared array are collective operations over PetscTools::GetWorld(),
+ * as are Synchronise() and SumOverNodes().  An array allocated as not shared is just private
+ * memory, and none of its methods communicate.
+ */
+class NodeSharedArray : private boost::noncopyable
+{
+private:
+    /** The array data. */
+    double* mpData;
+
+    /** The length of the array. */
+    unsigned mSize;
+
+    /** Whether the array is shared between the processes on a node. */
+    bool mIsShared;
+
+#if MPI_VERSION >= 3
+    /** The shared-memory window holding the data, if shared on more than one process. */
+    MPI_Win mWindow;
+
+    /** Whether #mWindow has been allocated. */
+    bool mHasWindow;
+#endif
+
+    /** The communicator used for the current node communicators. */
+    static MPI_Comm mWorldForCommunicators;
+
+    /** Communicator for the processes on this node (see GetNodeCommunicator()). */
+    static MPI_Comm mNodeCommunicator;
+
+    /** Communicator for the lowest-ranked process on each node (see GetNodeLeaderCommunicator()). */
+    static MPI_Comm mNodeLeaderCommunicator;
+
+    /**
+     * Set up #mNodeCommunicator and #mNodeLeaderCommunicator, if PetscTools::GetWorld() has changed.
+     * Collective over PetscTools::GetWorld().
+     */
+    static void SetUpCommunicators();
+
+public:
+    /** Create an empty array. */
+    NodeSharedArray();
+
+    /** Destructor.  If the array is shared, this is collective (see Free()). */
+    ~NodeSharedArray();
+
+    /**
+     * Allocate the array, freeing any previous data.  The contents are not initialised.
+     *
+     * @param size  the number of entries
+     * @param shared  whether to hold the array once per node; if so, this is collective
+     */
+    void Allocate(unsigned size, bool shared=true);
+
+    /** Free the array.  Collective if the array is shared. */
+    void Free();
+
+    /** @return a pointer to the array data (NULL if the array is empty). */
+    double* GetData();
+
+    /** @return a pointer to the array data (NULL if the array is empty). */
+    const double* GetData() const;
+
+    /** @return the number of entries. */
+    unsigned GetSize() const;
+
+    /** @return whether the array is held once per node. */
+    bool IsShared() const;
+
+    /**
+     * @return whether this process should fill in the array: the lowest-ranked process on
+     * its node if the array is shared, and always if not.
+     */
+    bool IsWriter() const;
+
+    /**
+     * Make the writes made by each process to the array visible to the other processes on its node.
+     * Collective if the array is shared, and does nothing otherwise.
+     */
+    void Synchronise();
+
+    /**
+     * Add the arrays held on each node together, entry by entry, so that every node has the total.
+     * Synchronises before and after.  Collective if the array is shared; otherwise does nothing.
+     *
+     * This is useful for assembling replicated data: if each process fills only the entries it
+     * owns, and the writer on each node zeros the entries owned by other nodes, the sum is the
+     * complete data.
+     */
+    void SumOverNodes();
+
+    /**
+     * @return a communicator for the processes sharing memory with this one.  If processes
+     * are isolated, or MPI-3 is unavailable, this is just MPI_COMM_SELF.
+     * The first call is collective over PetscTools::GetWorld().
+     */
+    static MPI_Comm GetNodeCommunicator();
+
+    /**
+     * @return a communicator for the lowest-ranked process on each node, or MPI_COMM_NULL
+     * on the other processes.  The first call is collective over PetscTools::GetWorld().
+     */
+    static MPI_Comm GetNodeLeaderCommunicator();
+};
+
+#endif // NODESHAREDARRAY_HPP_
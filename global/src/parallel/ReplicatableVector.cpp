@@ -56,6 +56,13 @@ void ReplicatableVector::RemovePetscContext()
         mReplicated = NULL;
     }
 
+    if (mpSharedData != NULL)
+    {
+        delete mpSharedData;
+        mpSharedData = NULL;
+        mpData = NULL;
+    }
+
     if (mpData != NULL)
     {
         delete[] mpData;
@@ -63,13 +70,51 @@ void ReplicatableVector::RemovePetscContext()
     }
 }
 
+void ReplicatableVector::ReplicateWithinNodes(unsigned lo, unsigned hi)
+{
+    assert(mpSharedData != NULL);
+
+    // Find out which parts of the vector are known on this node
+    MPI_Comm node_comm = NodeSharedArray::GetNodeCommunicator();
+    int num_node_procs;
+    MPI_Comm_size(node_comm, &num_node_procs);
+    std::vector<unsigned> my_range(2);
+    my_range[0] = lo;
+    my_range[1] = hi;
+    std::vector<unsigned> node_ranges(2*num_node_procs);
+    MPI_Allgather(&my_range[0], 2, MPI_UNSIGNED, &node_ranges[0], 2, MPI_UNSIGNED, node_comm);
+
+    // The remainder is filled in from the other nodes
+    if (mpSharedData->IsWriter())
+    {
+        std::vector<bool> known_here(mSize, false);
+        for (int proc=0; proc<num_node_procs; proc++)
+        {
+            for (unsigned i=node_ranges[2*proc]; i<node_ranges[2*proc+1]; i++)
+            {
+                known_here[i] = true;
+            }
+        }
+        for (unsigned i=0; i<mSize; i++)
+        {
+            if (!known_here[i])
+            {
+                mpData[i] = 0.0;
+            }
+        }
+    }
+    mpSharedData->SumOverNodes();
+}
+
 // Constructors & destructors
 
 ReplicatableVector::ReplicatableVector()
     : mpData(NULL),
       mSize(0),
       mToAll(NULL),
-      mReplicated(NULL)
+      mReplicated(NULL),
+      mUseNodeSharedMemory(false),
+      mpSharedData(NULL)
 {
 }
 
@@ -77,7 +122,9 @@ ReplicatableVector::ReplicatableVector(Vec vec)
     : mpData(NULL),
       mSize(0),
       mToAll(NULL),
-      mReplicated(NULL)
+      mReplicated(NULL),
+      mUseNodeSharedMemory(false),
+      mpSharedData(NULL)
 {
     ReplicatePetscVector(vec);
 }
@@ -86,7 +133,9 @@ ReplicatableVector::ReplicatableVector(unsigned size)
     : mpData(NULL),
       mSize(0),
       mToAll(NULL),
-      mReplicated(NULL)
+      mReplicated(NULL),
+      mUseNodeSharedMemory(false),
+      mpSharedData(NULL)
 {
     Resize(size);
 }
@@ -110,6 +159,14 @@ void ReplicatableVector::Resize(unsigned size)
 
     mSize = size;
 
+    if (mUseNodeSharedMemory)
+    {
+        mpSharedData = new NodeSharedArray;
+        mpSharedData->Allocate(mSize);
+        mpData = mpSharedData->GetData();
+        return;
+    }
+
     try
     {
         mpData = new double[mSize];
@@ -125,6 +182,21 @@ void ReplicatableVector::Resize(unsigned size)
     PetscTools::ReplicateException(false);
 }
 
+void ReplicatableVector::SetUseNodeSharedMemory(bool useNodeSharedMemory)
+{
+    if (useNodeSharedMemory != mUseNodeSharedMemory)
+    {
+        mUseNodeSharedMemory = useNodeSharedMemory;
+        // Move to the new kind of memory
+        Resize(mSize);
+    }
+}
+
+bool ReplicatableVector::IsUsingNodeSharedMemory() const
+{
+    return mUseNodeSharedMemory;
+}
+
 double& ReplicatableVector::operator[](unsigned index)
 {
     assert(index < mSize);
@@ -135,6 +207,13 @@ double& ReplicatableVector::operator[](unsigned index)
 
 void ReplicatableVector::Replicate(unsigned lo, unsigned hi)
 {
+    if (mUseNodeSharedMemory)
+    {
+        // The local part is already in the shared memory
+        ReplicateWithinNodes(lo, hi);
+        return;
+    }
+
     // Create a PetSC vector with the array containing the distributed data
     Vec distributed_vec;
 
@@ -167,6 +246,23 @@ void ReplicatableVector::ReplicatePetscVector(Vec vec)
     {
         Resize(size);
     }
+    if (mUseNodeSharedMemory)
+    {
+        // Don't overwrite the previous values while another process on this node may be reading them
+        mpSharedData->Synchronise();
+
+        PetscInt lo, hi;
+        VecGetOwnershipRange(vec, &lo, &hi);
+        double* p_local;
+        VecGetArray(vec, &p_local);
+        for (PetscInt i=lo; i<hi; i++)
+        {
+            mpData[i] = p_local[i-lo];
+        }
+        VecRestoreArray(vec, &p_local);
+        ReplicateWithinNodes(lo, hi);
+        return;
+    }
     if (mReplicated == NULL)
     {
         // This creates mToAll (the scatter context) and mReplicated (to store values)
@@ -39,6 +39,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 #include <petscvec.h>
 
+#include "NodeSharedArray.hpp"
+
 /**
  * Helper class for replicating a PETSc vector.
  */
@@ -51,11 +53,28 @@ private:
     VecScatter mToAll;   /**< Variable holding information for replicating a PETSc vector. */
     Vec mReplicated;     /**< Vector to hold concentrated copy of replicated vector. */
 
+    /** Whether the data are held once per node.  See SetUseNodeSharedMemory(). */
+    bool mUseNodeSharedMemory;
+
+    /** Holds the data when #mUseNodeSharedMemory is set. */
+    NodeSharedArray* mpSharedData;
+
     /**
      * Clear data. Used in resize method and destructor.
      */
     void RemovePetscContext();
 
+    /**
+     * Complete replication into node-shared memory, once each process has written
+     * its own part of the vector.  The processes on each node exchange ownership
+     * ranges, the entries owned by other nodes are zeroed, and the node copies are
+     * summed.
+     *
+     * @param lo  The start of our ownership range
+     * @param hi  One past the end of our ownership range
+     */
+    void ReplicateWithinNodes(unsigned lo, unsigned hi);
+
 public:
 
     /**
@@ -97,6 +116,25 @@ public:
      */
     void Resize(unsigned size);
 
+    /**
+     * Hold the data once per shared-memory node, rather than once per process, using
+     * NodeSharedArray.  This suits large vectors which are only read between replications.
+     *
+     * Any current contents are lost.  Once set, Resize(), Replicate() and ReplicatePetscVector()
+     * become collective over the processes of each node (as well as all processes, for the latter two).
+     * Since the processes on a node share the data, a process must not write its part of the
+     * vector before calling Replicate() until all processes on its node have finished reading the
+     * previous values.  ReplicatePetscVector() takes care of this itself.
+     *
+     * @param useNodeSharedMemory  whether to share the data; must be the same on all processes
+     */
+    void SetUseNodeSharedMemory(bool useNodeSharedMemory=true);
+
+    /**
+     * @return whether the data are held once per node.  See SetUseNodeSharedMemory().
+     */
+    bool IsUsingNodeSharedMemory() const;
+
     /**
      * Access the vector.
      *
@@ -35,8 +35,41 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "HeartEventHandler.hpp"
 
+#include <iostream>
+
 const char* HeartEventHandler::EventName[] =  { "InMesh", "Init", "AssSys", "Ode",
                                            "Comms", "AssRhs", "NeuBCs", "DirBCs",
                                            "Ksp", "Output", "DataConversion",
                                            "PostProc", "User1", "User2",
                                            "User3","Total" };
+
+const char* HeartEventHandler::CounterName[] = { "OdeSubsteps", "OdeSubstepsAtBaseDt" };
+
+unsigned long HeartEventHandler::mCounters[] = { 0ul, 0ul };
+
+void HeartEventHandler::AddToCounter(CounterType counter, unsigned long amount)
+{
+    mCounters[counter] += amount;
+}
+
+unsigned long HeartEventHandler::GetCounter(CounterType counter)
+{
+    return mCounters[counter];
+}
+
+void HeartEventHandler::ResetCounters()
+{
+    for (unsigned counter=0; counter<NUM_COUNTERS; counter++)
+    {
+        mCounters[counter] = 0ul;
+    }
+}
+
+void HeartEventHandler::ReportCounters()
+{
+    for (unsigned counter=0; counter<NUM_COUNTERS; counter++)
+    {
+        std::cout << CounterName[counter] << "\t" << mCounters[counter] << "\n";
+    }
+    std::cout << std::flush;
+}
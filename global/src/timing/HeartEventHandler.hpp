@@ -71,6 +71,41 @@ public:
         USER3,
         EVERYTHING
     } EventType;
+
+    /** Definition of heart work counter types, which count work done rather than time taken. */
+    typedef enum
+    {
+        ODE_SUBSTEPS=0,                /**< Cell model substeps taken by AbstractCardiacTissue */
+        ODE_SUBSTEPS_AT_BASE_TIMESTEP, /**< Substeps those cells would have taken with their usual timestep */
+        NUM_COUNTERS
+    } CounterType;
+
+    /** Character array holding heart counter names. */
+    static const char* CounterName[NUM_COUNTERS];
+
+    /**
+     * Add to a work counter.
+     *
+     * @param counter  the counter
+     * @param amount  the amount to add
+     */
+    static void AddToCounter(CounterType counter, unsigned long amount);
+
+    /**
+     * @return the current value of a work counter.
+     * @param counter  the counter
+     */
+    static unsigned long GetCounter(CounterType counter);
+
+    /** Set all the work counters to zero. */
+    static void ResetCounters();
+
+    /** Print the work counters on this process to std::cout. */
+    static void ReportCounters();
+
+private:
+    /** The work counters. */
+    static unsigned long mCounters[NUM_COUNTERS];
 };
 
 #endif /*HEARTEVENTHANDLER_HPP_*/
@@ -99,6 +99,20 @@ public:
 
     }
 
+    void TestCounters() throw(Exception)
+    {
+        HeartEventHandler::ResetCounters();
+        HeartEventHandler::AddToCounter(HeartEventHandler::ODE_SUBSTEPS, 10ul);
+        HeartEventHandler::AddToCounter(HeartEventHandler::ODE_SUBSTEPS, 5ul);
+        HeartEventHandler::AddToCounter(HeartEventHandler::ODE_SUBSTEPS_AT_BASE_TIMESTEP, 100ul);
+        TS_ASSERT_EQUALS(HeartEventHandler::GetCounter(HeartEventHandler::ODE_SUBSTEPS), 15ul);
+        TS_ASSERT_EQUALS(HeartEventHandler::GetCounter(HeartEventHandler::ODE_SUBSTEPS_AT_BASE_TIMESTEP), 100ul);
+        HeartEventHandler::ReportCounters();
+
+        HeartEventHandler::ResetCounters();
+        TS_ASSERT_EQUALS(HeartEventHandler::GetCounter(HeartEventHandler::ODE_SUBSTEPS), 0ul);
+    }
+
     void TestEventExceptions() throw(Exception)
     {
         // Should not be able to end and event that has not yet begun
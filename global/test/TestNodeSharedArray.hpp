@@ -0,0 +1,178 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTNODESHAREDARRAY_HPP_
+#define TESTNODESHAREDARRAY_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "NodeSharedArray.hpp"
+#include "PetscTools.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestNodeSharedArray : public CxxTest::TestSuite
+{
+public:
+
+    void TestPrivateArray()
+    {
+        NodeSharedArray array;
+        TS_ASSERT_EQUALS(array.GetSize(), 0u);
+        TS_ASSERT(array.GetData() == NULL);
+
+        array.Allocate(10u, false);
+        TS_ASSERT_EQUALS(array.GetSize(), 10u);
+        TS_ASSERT_EQUALS(array.IsShared(), false);
+        TS_ASSERT_EQUALS(array.IsWriter(), true);
+
+        // Every process has its own copy, so nothing here communicates
+        for (unsigned i=0; i<10u; i++)
+        {
+            array.GetData()[i] = PetscTools::GetMyRank() + i;
+        }
+        array.Synchronise();
+        array.SumOverNodes();
+        for (unsigned i=0; i<10u; i++)
+        {
+            TS_ASSERT_EQUALS(array.GetData()[i], PetscTools::GetMyRank() + i);
+        }
+
+        array.Free();
+        TS_ASSERT_EQUALS(array.GetSize(), 0u);
+        TS_ASSERT(array.GetData() == NULL);
+    }
+
+    void TestSharedArray()
+    {
+        NodeSharedArray array;
+        array.Allocate(10u);
+        TS_ASSERT_EQUALS(array.GetSize(), 10u);
+        TS_ASSERT_EQUALS(array.IsShared(), true);
+
+        // One process per node fills the array, and the others see the values
+        if (array.IsWriter())
+        {
+            for (unsigned i=0; i<10u; i++)
+            {
+                array.GetData()[i] = 2.0*i;
+            }
+        }
+        array.Synchronise();
+        for (unsigned i=0; i<10u; i++)
+        {
+            TS_ASSERT_EQUALS(array.GetData()[i], 2.0*i);
+        }
+
+        // Reallocation gives an array of the new size
+        array.Allocate(0u);
+        TS_ASSERT_EQUALS(array.GetSize(), 0u);
+        array.Allocate(5u);
+        TS_ASSERT_EQUALS(array.GetSize(), 5u);
+    }
+
+    void TestSumOverNodes()
+    {
+        MPI_Comm node_comm = NodeSharedArray::GetNodeCommunicator();
+        int node_rank, node_size;
+        MPI_Comm_rank(node_comm, &node_rank);
+        MPI_Comm_size(node_comm, &node_size);
+        TS_ASSERT_LESS_THAN_EQUALS((unsigned) node_size, PetscTools::GetNumProcs());
+
+        // There is one writer per node
+        unsigned num_writers = (node_rank == 0) ? 1u : 0u;
+        unsigned total_writers;
+        MPI_Allreduce(&num_writers, &total_writers, 1, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+        TS_ASSERT_EQUALS((NodeSharedArray::GetNodeLeaderCommunicator() != MPI_COMM_NULL), (node_rank == 0));
+
+        // Each process writes its own entry, and the writers zero the others
+        const unsigned num_procs = PetscTools::GetNumProcs();
+        NodeSharedArray array;
+        array.Allocate(num_procs);
+        array.Synchronise();
+        if (array.IsWriter())
+        {
+            for (unsigned i=0; i<num_procs; i++)
+            {
+                array.GetData()[i] = 0.0;
+            }
+        }
+        array.Synchronise();
+        array.GetData()[PetscTools::GetMyRank()] = PetscTools::GetMyRank() + 1.0;
+        array.SumOverNodes();
+
+        for (unsigned i=0; i<num_procs; i++)
+        {
+            TS_ASSERT_EQUALS(array.GetData()[i], i + 1.0);
+        }
+        TS_ASSERT_LESS_THAN_EQUALS(total_writers, num_procs);
+        TS_ASSERT_LESS_THAN(0u, total_writers);
+    }
+
+    void TestIsolatedProcesses()
+    {
+        PetscTools::IsolateProcesses(true);
+        TS_ASSERT(NodeSharedArray::GetNodeCommunicator() == MPI_COMM_SELF);
+
+        // Each process is its own node
+        NodeSharedArray array;
+        array.Allocate(3u);
+        TS_ASSERT_EQUALS(array.IsWriter(), true);
+        for (unsigned i=0; i<3u; i++)
+        {
+            array.GetData()[i] = PetscTools::GetMyRank();
+        }
+        array.SumOverNodes();
+        for (unsigned i=0; i<3u; i++)
+        {
+            TS_ASSERT_EQUALS(array.GetData()[i], PetscTools::GetMyRank());
+        }
+        array.Free();
+
+        // The node communicators are set up again for the whole world
+        PetscTools::IsolateProcesses(false);
+        int node_size;
+        MPI_Comm_size(NodeSharedArray::GetNodeCommunicator(), &node_size);
+        TS_ASSERT_LESS_THAN_EQUALS((unsigned) node_size, PetscTools::GetNumProcs());
+        array.Allocate(1u);
+        if (array.IsWriter())
+        {
+            array.GetData()[0] = 1.0;
+        }
+        array.SumOverNodes();
+        TS_ASSERT_LESS_THAN_EQUALS(array.GetData()[0], PetscTools::GetNumProcs());
+    }
+};
+
+#endif // TESTNODESHAREDARRAY_HPP_
@@ -165,6 +165,75 @@ public:
 
         PetscTools::Destroy(petsc_vec);
     }
+
+    void TestReplicationInNodeSharedMemory()
+    {
+        ReplicatableVector rep_vector;
+        rep_vector.SetUseNodeSharedMemory();
+        TS_ASSERT_EQUALS(rep_vector.IsUsingNodeSharedMemory(), true);
+
+        for (int vec_size=0; vec_size<10; vec_size++)
+        {
+            int lo, hi;
+            Vec temp_vec = PetscTools::CreateVec(vec_size);
+            VecGetOwnershipRange(temp_vec,&lo,&hi);
+            PetscTools::Destroy(temp_vec); // vector no longer needed
+
+            rep_vector.Resize(vec_size);
+            TS_ASSERT_EQUALS(rep_vector.GetSize(), (unsigned) vec_size);
+            for (int global_index=lo; global_index<hi; global_index++)
+            {
+                rep_vector[global_index] = global_index;
+            }
+
+            rep_vector.Replicate(lo, hi);
+
+            for (int global_index=0; global_index<vec_size; global_index++)
+            {
+                TS_ASSERT_EQUALS(rep_vector[global_index], global_index);
+            }
+        }
+
+        // Back to a private copy on each process
+        rep_vector.SetUseNodeSharedMemory(false);
+        TS_ASSERT_EQUALS(rep_vector.IsUsingNodeSharedMemory(), false);
+        TS_ASSERT_EQUALS(rep_vector.GetSize(), 9u);
+    }
+
+    void TestPetscReplicationInNodeSharedMemory()
+    {
+        int lo, hi;
+        Vec petsc_vec = PetscTools::CreateVec(VEC_SIZE);
+        VecGetOwnershipRange(petsc_vec,&lo,&hi);
+
+        ReplicatableVector rep_vec;
+        rep_vec.SetUseNodeSharedMemory();
+
+        // Replicate twice, to check the previous values are overwritten
+        for (unsigned run=0; run<2; run++)
+        {
+            double* p_petsc_vec;
+            VecGetArray(petsc_vec, &p_petsc_vec);
+            for (int global_index=lo; global_index<hi; global_index++)
+            {
+                int local_index = global_index - lo;
+                p_petsc_vec[local_index] = global_index + 100.0*run;
+            }
+            VecRestoreArray(petsc_vec, &p_petsc_vec);
+            VecAssemblyBegin(petsc_vec);
+            VecAssemblyEnd(petsc_vec);
+
+            rep_vec.ReplicatePetscVector(petsc_vec);
+
+            TS_ASSERT_EQUALS(rep_vec.GetSize(), (unsigned) VEC_SIZE);
+            for (int global_index=0; global_index<VEC_SIZE; global_index++)
+            {
+                TS_ASSERT_EQUALS(rep_vec[global_index], global_index + 100.0*run);
+            }
+        }
+
+        PetscTools::Destroy(petsc_vec);
+    }
 };
 
 #endif /*TESTREPLICATABLEVECTOR_HPP_*/
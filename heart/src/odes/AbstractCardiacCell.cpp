@@ -67,6 +67,11 @@ void AbstractCardiacCell::SetTimestep(double dt)
     mDt = dt;
 }
 
+double AbstractCardiacCell::GetTimestep()
+{
+    return mDt;
+}
+
 void AbstractCardiacCell::SolveAndUpdateState(double tStart, double tEnd)
 {
     mpOdeSolver->SolveAndUpdateStateVariable(this, tStart, tEnd, mDt);
@@ -172,6 +172,11 @@ public:
      */
     void SetTimestep(double dt);
 
+    /**
+     * @return the timestep used for simulating this cell.
+     */
+    double GetTimestep();
+
     /**
      * Simulate this cell's behaviour between the time interval [tStart, tEnd],
      * with timestemp #mDt, updating the internal state variable values.
@@ -373,6 +373,13 @@ public:
      */
     const boost::shared_ptr<AbstractIvpOdeSolver> GetSolver() const;
 
+    /**
+     * Change the ODE solver used to simulate this cell.
+     *
+     * @param pSolver  the new solver
+     */
+    void SetSolver(boost::shared_ptr<AbstractIvpOdeSolver> pSolver);
+
     /**
      * Set whether to clamp the voltage by setting its derivative to zero.
      * @param clamp whether to clamp
@@ -61,6 +61,8 @@ class AbstractGeneralizedRushLarsenCardiacCell : public AbstractCardiacCell
 private:
     /** Needed for serialization. */
     friend class boost::serialization::access;
+    /** The batched tissue solver needs access to UpdateTransmembranePotential and ComputeOneStepExceptVoltage. */
+    friend class CardiacCellBatch;
     /**
      * Archive the member variables.
      *
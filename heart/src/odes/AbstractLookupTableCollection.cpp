@@ -35,10 +35,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractLookupTableCollection.hpp"
 
+#include <cassert>
 #include <cmath>
 
+#include "Exception.hpp"
+
 AbstractLookupTableCollection::AbstractLookupTableCollection()
-    : mDt(0.0)
+    : mDt(0.0),
+      mUseNodeSharedMemory(false)
 {
 }
 
@@ -62,17 +66,15 @@ void AbstractLookupTableCollection::GetTableProperties(const std::string& rKeyin
 
 void AbstractLookupTableCollection::SetTableProperties(const std::string& rKeyingVariableName, double min, double step, double max)
 {
-    // Check inputs
-    unsigned num_steps = (unsigned) ((max-min)/step+0.5);
-    ///\todo remove magic number? (#1884)
-    if (fabs(max - min - num_steps*step) > 1e-10)
-    {
-        EXCEPTION("Table step size does not divide range between table limits.");
-    }
+    CheckTableProperties(min, step, max);
     // Set state
     unsigned i = GetTableIndex(rKeyingVariableName);
     if ((min != mTableMins[i]) || (step != mTableSteps[i]) || (max != mTableMaxs[i]))
     {
+        if (mUseNodeSharedMemory)
+        {
+            EXCEPTION("Lookup tables in node-shared memory are read-only, so their properties can't be changed.");
+        }
         mNeedsRegeneration[i] = true;
     }
     mTableMins[i] = min;
@@ -85,11 +87,83 @@ void AbstractLookupTableCollection::SetTimestep(double dt)
 {
     if (mDt != dt)
     {
+        if (mUseNodeSharedMemory)
+        {
+            EXCEPTION("Lookup tables in node-shared memory are read-only, so their timestep can't be changed.");
+        }
         mNeedsRegeneration.assign(mNeedsRegeneration.size(), true);
     }
     mDt = dt;
 }
 
+double* AbstractLookupTableCollection::AllocateTableStorage(unsigned keyIndex)
+{
+    assert(keyIndex < mKeyingVariableNames.size());
+    if (mTableData.size() < mKeyingVariableNames.size())
+    {
+        mTableData.resize(mKeyingVariableNames.size());
+    }
+    if (!mTableData[keyIndex])
+    {
+        mTableData[keyIndex].reset(new NodeSharedArray);
+    }
+    const unsigned size = GetTableSize(mTableMins[keyIndex], mTableSteps[keyIndex], mTableMaxs[keyIndex]);
+    mTableData[keyIndex]->Allocate(size*mNumberOfTables[keyIndex], mUseNodeSharedMemory);
+    return mTableData[keyIndex]->GetData();
+}
+
+bool AbstractLookupTableCollection::IsTableStorageWriter(unsigned keyIndex) const
+{
+    if (keyIndex >= mTableData.size() || !mTableData[keyIndex])
+    {
+        return true;
+    }
+    return mTableData[keyIndex]->IsWriter();
+}
+
+void AbstractLookupTableCollection::MoveTablesToNodeSharedMemory()
+{
+    if (mUseNodeSharedMemory)
+    {
+        return;
+    }
+    mUseNodeSharedMemory = true;
+
+    // Regenerate everything in the new memory, which is written by one process per node
+    mNeedsRegeneration.assign(mNeedsRegeneration.size(), true);
+    RegenerateTables();
+
+    // Make the values visible to the other processes on each node
+    for (unsigned i=0; i<mTableData.size(); i++)
+    {
+        if (mTableData[i])
+        {
+            mTableData[i]->Synchronise();
+        }
+    }
+}
+
+bool AbstractLookupTableCollection::IsUsingNodeSharedMemory() const
+{
+    return mUseNodeSharedMemory;
+}
+
+void AbstractLookupTableCollection::CheckTableProperties(double min, double step, double max)
+{
+    unsigned num_steps = (unsigned) ((max-min)/step+0.5);
+    ///\todo remove magic number? (#1884)
+    if (fabs(max - min - num_steps*step) > 1e-10)
+    {
+        EXCEPTION("Table step size does not divide range between table limits.");
+    }
+}
+
+unsigned AbstractLookupTableCollection::GetTableSize(double min, double step, double max)
+{
+    // The same calculation as used by the PyCml generated code
+    return 1 + (unsigned)((max-min)/step+0.5);
+}
+
 unsigned AbstractLookupTableCollection::GetTableIndex(const std::string& rKeyingVariableName) const
 {
     unsigned i=0;
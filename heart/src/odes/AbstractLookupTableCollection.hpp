@@ -38,8 +38,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <string>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 #include "GenericEventHandler.hpp"
+#include "NodeSharedArray.hpp"
 
 /**
  * Base class for lookup tables used in optimised cells generated by PyCml.
@@ -100,6 +102,21 @@ public:
      */
     virtual void RegenerateTables()=0;
 
+    /**
+     * Regenerate the tables held by this class (see AllocateTableStorage()) in memory
+     * shared by all the processes on each node, so that a node holds one copy of the
+     * tables rather than one per process.  The tables are computed by one process per node.
+     *
+     * This must be called on all processes, and afterwards the tables are read-only:
+     * their properties and timestep may no longer be changed.
+     */
+    void MoveTablesToNodeSharedMemory();
+
+    /**
+     * @return whether the tables are held in node-shared memory.  See MoveTablesToNodeSharedMemory().
+     */
+    bool IsUsingNodeSharedMemory() const;
+
     /** Virtual destructor since we have a virtual method. */
     virtual ~AbstractLookupTableCollection();
 
@@ -127,6 +144,45 @@ protected:
      */
     unsigned GetTableIndex(const std::string& rKeyingVariableName) const;
 
+    /**
+     * Provide the memory for the tables keyed by one variable, sized from the current table
+     * properties, so that they may be moved into node-shared memory (see
+     * MoveTablesToNodeSharedMemory()).  Generated lookup table collections use this instead
+     * of allocating the tables themselves.  Any previous memory for these tables is released.
+     *
+     * @return a pointer to the table values, with the GetNumberOfTables() values for each
+     *     table point stored together
+     * @param keyIndex  the index of the keying variable
+     */
+    double* AllocateTableStorage(unsigned keyIndex);
+
+    /**
+     * @return whether this process should compute the values of the tables keyed by one
+     * variable.  This is false on all but one process per node when the tables are in
+     * node-shared memory, and true otherwise.
+     *
+     * @param keyIndex  the index of the keying variable
+     */
+    bool IsTableStorageWriter(unsigned keyIndex) const;
+
+    /**
+     * Check that table properties are consistent.
+     *
+     * @param min  the lower table bound
+     * @param step  the table spacing
+     * @param max  the upper table bound
+     */
+    static void CheckTableProperties(double min, double step, double max);
+
+    /**
+     * @return the number of points in a table.
+     *
+     * @param min  the lower table bound
+     * @param step  the table spacing
+     * @param max  the upper table bound
+     */
+    static unsigned GetTableSize(double min, double step, double max);
+
     /** Names of variables used to index lookup tables */
     std::vector<std::string> mKeyingVariableNames;
 
@@ -150,6 +206,15 @@ protected:
 
     /** Timestep to use in lookup tables */
     double mDt;
+
+    /**
+     * Memory for the tables keyed by each variable, if provided by AllocateTableStorage().
+     * Empty for tables allocated by the subclass.
+     */
+    std::vector<boost::shared_ptr<NodeSharedArray> > mTableData;
+
+    /** Whether tables held by this class live in node-shared memory.  See MoveTablesToNodeSharedMemory(). */
+    bool mUseNodeSharedMemory;
 };
 
 #endif // ABSTRACTLOOKUPTABLECOLLECTION_HPP_
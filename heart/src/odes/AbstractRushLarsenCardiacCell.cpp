@@ -146,6 +146,12 @@ void AbstractRushLarsenCardiacCell::SolveAndUpdateState(double tStart, double tE
     }
 }
 
+bool AbstractRushLarsenCardiacCell::GetRushLarsenUpdateInformation(std::vector<RushLarsenUpdateType>& rUpdateTypes,
+                                                                   std::vector<double>& rTimeScaleFactors)
+{
+    return false;
+}
+
 void AbstractRushLarsenCardiacCell::UpdateTransmembranePotential(const std::vector<double> &rDY)
 {
     unsigned v_index = GetVoltageIndex();
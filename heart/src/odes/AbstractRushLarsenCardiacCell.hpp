@@ -60,6 +60,8 @@ class AbstractRushLarsenCardiacCell : public AbstractCardiacCell
 private:
     /** Needed for serialization. */
     friend class boost::serialization::access;
+    /** The batched tissue solver needs access to EvaluateEquations and ComputeOneStepExceptVoltage. */
+    friend class CardiacCellBatch;
     /**
      * Archive the member variables.
      *
@@ -74,6 +76,17 @@ private:
     }
 
 public:
+    /**
+     * The kinds of update that ComputeOneStepExceptVoltage may apply to a state variable.
+     */
+    typedef enum RushLarsenUpdateType_
+    {
+        NO_UPDATE=0,          /**< Not updated (the transmembrane potential) */
+        FORWARD_EULER_UPDATE, /**< A forward Euler step using dy/dt */
+        ALPHA_BETA_UPDATE,    /**< A Rush-Larsen step using alpha and beta values */
+        TAU_INF_UPDATE        /**< A Rush-Larsen step using tau and inf values */
+    } RushLarsenUpdateType;
+
     /**
      * Standard constructor for a cell.
      *
@@ -130,6 +143,22 @@ public:
      */
     void SolveAndUpdateState(double tStart, double tEnd);
 
+    /**
+     * Describe the update that ComputeOneStepExceptVoltage applies to each state variable,
+     * so that the same update can be applied to many cells of this type at once
+     * (see CardiacCellBatch).
+     *
+     * PyCml overrides this method in the Rush-Larsen models it generates.  The default
+     * implementation returns false, in which case callers must use ComputeOneStepExceptVoltage.
+     *
+     * @param rUpdateTypes  filled in with the kind of update applied to each state variable
+     * @param rTimeScaleFactors  filled in with any units conversion factor multiplying the timestep
+     *     in the Rush-Larsen update of each variable (1 if there is no conversion)
+     * @return whether this model provides the information
+     */
+    virtual bool GetRushLarsenUpdateInformation(std::vector<RushLarsenUpdateType>& rUpdateTypes,
+                                                std::vector<double>& rTimeScaleFactors);
+
 private:
 #define COVERAGE_IGNORE
     /**
@@ -36,6 +36,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define CARDIACNEWTONSOLVER_HPP_
 
 #include <cmath>
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include "IsNan.hpp"
 #include "UblasCustomFunctions.hpp"
 #include "AbstractBackwardEulerCardiacCell.hpp"
@@ -47,7 +49,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * The class is templated by the size of the nonlinear system, and uses the
  * singleton pattern to ensure only 1 solver for any given system size is created.
- * This allows us to be both computationally and memory efficient.
+ * This allows us to be both computationally and memory efficient.  When compiled
+ * with OpenMP there is one solver per thread, since cells may be solved concurrently
+ * (see AbstractCardiacTissue::SetCellSolveThreading()) and the solver has working memory.
  *
  * It would be nice to have a test of this class directly, but you need a cardiac
  * cell in order to test it.  So all tests occur when testing particular cardiac
@@ -60,12 +64,28 @@ public:
     /**
      * Call this method to obtain a solver instance.
      *
-     * @return a single instance of the class
+     * @return a single instance of the class (for the calling thread, if compiled with OpenMP)
      */
     static CardiacNewtonSolver<SIZE, CELLTYPE>* Instance()
     {
+#ifdef _OPENMP
+        static CardiacNewtonSolver<SIZE, CELLTYPE>* p_thread_instance = NULL;
+#pragma omp threadprivate(p_thread_instance)
+        if (p_thread_instance == NULL)
+        {
+            p_thread_instance = new CardiacNewtonSolver<SIZE, CELLTYPE>;
+            // Keep ownership of every thread's solver, so they are freed at exit
+#pragma omp critical(CardiacNewtonSolver_Instance)
+            {
+                static std::vector<boost::shared_ptr<CardiacNewtonSolver<SIZE, CELLTYPE> > > thread_instances;
+                thread_instances.push_back(boost::shared_ptr<CardiacNewtonSolver<SIZE, CELLTYPE> >(p_thread_instance));
+            }
+        }
+        return p_thread_instance;
+#else
         static CardiacNewtonSolver<SIZE, CELLTYPE> inst;
         return &inst;
+#endif // _OPENMP
     }
 
     /**
@@ -132,6 +152,9 @@ public:
                     rCurrentGuess[relative_change_direction] += 0.8*mUpdate[relative_change_direction];
                     rCell.ComputeResidual(time, rCurrentGuess, mResidual.data());
                     norm_of_residual = norm_inf(mResidual);
+#ifdef _OPENMP
+#pragma omp critical(CardiacNewtonSolver_Warnings)
+#endif // _OPENMP
                     WARNING("Residual increasing and one direction changing radically - back tracking in that direction");
                 }
             }
@@ -151,6 +174,9 @@ public:
 #ifndef NDEBUG
         if (norm_of_residual > 2e-10)
         { //This line is for correlation - in case we use norm_of_residual as convergence criterion
+#ifdef _OPENMP
+#pragma omp critical(CardiacNewtonSolver_Warnings)
+#endif // _OPENMP
             WARN_ONCE_ONLY("Newton iteration terminated because update vector norm is small, but residual norm is not small.");
         }
 #endif // NDEBUG
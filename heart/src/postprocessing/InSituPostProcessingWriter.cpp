@@ -0,0 +1,628 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include <cfloat>
+#include <cmath>
+#include <sstream>
+
+#include "InSituPostProcessingWriter.hpp"
+#include "PostProcessingWriter.hpp"
+#include "Hdf5DataWriter.hpp"
+#include "OutputFileHandler.hpp"
+#include "HeartConfig.hpp"
+#include "DistributedVector.hpp"
+#include "DistributedVectorFactory.hpp"
+#include "Exception.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::InSituPostProcessingWriter(AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh)
+    : mrMesh(rMesh),
+      mPreviousTime(DBL_MAX)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+typename InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::ThresholdState& InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::rGetThresholdState(double threshold)
+{
+    if (mPreviousTime != DBL_MAX)
+    {
+        EXCEPTION("Maps must be requested before the first update.");
+    }
+
+    for (unsigned i=0; i<mThresholdStates.size(); i++)
+    {
+        if (mThresholdStates[i].mThreshold == threshold)
+        {
+            return mThresholdStates[i];
+        }
+    }
+
+    ThresholdState new_state;
+    new_state.mThreshold = threshold;
+    new_state.mUpstrokeTimeMap = false;
+    new_state.mMaxUpstrokeVelocityMap = false;
+    new_state.mAboveThresholdDepolarisationMap = false;
+    mThresholdStates.push_back(new_state);
+    return mThresholdStates.back();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::AddApdMap(double repolarisationPercentage, double threshold)
+{
+    if (repolarisationPercentage < 1.0 || repolarisationPercentage >= 100.0)
+    {
+        EXCEPTION("First argument of AddApdMap() is expected to be a percentage");
+    }
+    rGetThresholdState(threshold).mApdPercentages.push_back(repolarisationPercentage);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::AddUpstrokeTimeMap(double threshold)
+{
+    rGetThresholdState(threshold).mUpstrokeTimeMap = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::AddMaxUpstrokeVelocityMap(double threshold)
+{
+    rGetThresholdState(threshold).mMaxUpstrokeVelocityMap = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::AddAboveThresholdDepolarisationMap(double threshold)
+{
+    rGetThresholdState(threshold).mAboveThresholdDepolarisationMap = true;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::AddMapsRequestedInHeartConfig()
+{
+    if (HeartConfig::Instance()->IsApdMapsRequested())
+    {
+        std::vector<std::pair<double,double> > apd_maps;
+        HeartConfig::Instance()->GetApdMaps(apd_maps);
+        for (unsigned i=0; i<apd_maps.size(); i++)
+        {
+            AddApdMap(apd_maps[i].first, apd_maps[i].second);
+        }
+    }
+
+    if (HeartConfig::Instance()->IsUpstrokeTimeMapsRequested())
+    {
+        std::vector<double> upstroke_time_maps;
+        HeartConfig::Instance()->GetUpstrokeTimeMaps(upstroke_time_maps);
+        for (unsigned i=0; i<upstroke_time_maps.size(); i++)
+        {
+            AddUpstrokeTimeMap(upstroke_time_maps[i]);
+        }
+    }
+
+    if (HeartConfig::Instance()->IsMaxUpstrokeVelocityMapRequested())
+    {
+        std::vector<double> upstroke_velocity_maps;
+        HeartConfig::Instance()->GetMaxUpstrokeVelocityMaps(upstroke_velocity_maps);
+        for (unsigned i=0; i<upstroke_velocity_maps.size(); i++)
+        {
+            AddMaxUpstrokeVelocityMap(upstroke_velocity_maps[i]);
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::HasMaps() const
+{
+    return !mThresholdStates.empty();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::Update(double time, Vec solution)
+{
+    if (mPreviousTime != DBL_MAX && time <= mPreviousTime)
+    {
+        // Already seen this time step (e.g. the initial condition of a resumed solve)
+        return;
+    }
+
+    DistributedVectorFactory* p_factory = mrMesh.GetDistributedVectorFactory();
+    DistributedVector distributed_solution = p_factory->CreateDistributedVector(solution);
+    DistributedVector::Stripe voltage(distributed_solution, 0);
+
+    if (mPreviousTime == DBL_MAX)
+    {
+        // First call: set up the accumulators, initialised as in CellProperties::CalculateProperties()
+        NodeState initial_state;
+        initial_state.mAboveThreshold = false;
+        initial_state.mSwitchingPhase = false;
+        initial_state.mFoundAFlatBit = false;
+        initial_state.mMinimumVelocity = DBL_MAX;
+        initial_state.mCurrentRestingValue = DBL_MAX;
+        initial_state.mRestingValue = DBL_MAX;
+        initial_state.mPeak = -DBL_MAX;
+        initial_state.mMaxUpstrokeVelocity = -DBL_MAX;
+        initial_state.mTimeOfMaxUpstrokeVelocity = 0.0;
+        initial_state.mPreviousVelocity = 0.0;
+        initial_state.mPlateauDepolarisations = 0u;
+        initial_state.mApdStartPending = false;
+
+        for (unsigned i=0; i<mThresholdStates.size(); i++)
+        {
+            unsigned num_percentages = mThresholdStates[i].mApdPercentages.size();
+            initial_state.mApdTargets.assign(num_percentages, DBL_MAX);
+            initial_state.mApdStartTimes.assign(num_percentages, DBL_MAX);
+            initial_state.mApds.assign(num_percentages, std::vector<double>());
+            mThresholdStates[i].mNodes.assign(p_factory->GetLocalOwnership(), initial_state);
+        }
+
+        mPreviousVoltages.resize(p_factory->GetLocalOwnership());
+        for (DistributedVector::Iterator index = distributed_solution.Begin();
+             index != distributed_solution.End();
+             ++index)
+        {
+            mPreviousVoltages[index.Local] = voltage[index];
+        }
+    }
+    else
+    {
+        for (DistributedVector::Iterator index = distributed_solution.Begin();
+             index != distributed_solution.End();
+             ++index)
+        {
+            double v = voltage[index];
+            for (unsigned i=0; i<mThresholdStates.size(); i++)
+            {
+                UpdateNode(mThresholdStates[i].mNodes[index.Local], mThresholdStates[i],
+                           mPreviousTime, mPreviousVoltages[index.Local], time, v);
+            }
+            mPreviousVoltages[index.Local] = v;
+        }
+    }
+    distributed_solution.Restore();
+
+    mPreviousTime = time;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::UpdateNode(NodeState& rState, const ThresholdState& rThreshold,
+                                                                    double prevTime, double prevV, double time, double v)
+{
+    const double threshold = rThreshold.mThreshold;
+    const double resting_potential_gradient_threshold = 1e-2; // As in CellProperties
+    double voltage_derivative = (time == prevTime) ? 0.0 : (v - prevV) / (time - prevTime);
+
+    // Look for the max upstroke velocity and when it happens (could be below or above threshold).
+    if (voltage_derivative >= rState.mMaxUpstrokeVelocity)
+    {
+        rState.mMaxUpstrokeVelocity = voltage_derivative;
+        rState.mTimeOfMaxUpstrokeVelocity = time;
+    }
+
+    // Remember the rising stretch of trace, which contains the start of the next APD
+    if (!rThreshold.mApdPercentages.empty())
+    {
+        if (v < prevV)
+        {
+            if (rState.mApdStartPending)
+            {
+                // The peak has just been passed
+                FindApdStartTimes(rState, rThreshold);
+            }
+            rState.mRisingSamples.clear();
+        }
+        else if (!rState.mAboveThreshold || rState.mApdStartPending)
+        {
+            if (rState.mRisingSamples.empty())
+            {
+                rState.mRisingSamples.push_back(std::make_pair(prevTime, prevV));
+            }
+            rState.mRisingSamples.push_back(std::make_pair(time, v));
+        }
+
+        // Check for repolarisation past the target voltage
+        for (unsigned p=0; p<rState.mApdTargets.size(); p++)
+        {
+            double target = rState.mApdTargets[p];
+            if (target != DBL_MAX && prevV > v && prevV >= target && v <= target)
+            {
+                // Linear interpolation of target crossing time.
+                double end_time = prevTime + (target-prevV)/(v-prevV)*(time-prevTime);
+                rState.mApds[p].push_back(end_time - rState.mApdStartTimes[p]);
+                rState.mApdTargets[p] = DBL_MAX;
+            }
+        }
+    }
+
+    if (!rState.mAboveThreshold)
+    {
+        // While below threshold, find the resting value by checking where the velocity is minimal
+        // i.e. when it is flattest. If we can't find a flat bit, instead go for the minimum voltage
+        // seen before the threshold.
+        if (fabs(voltage_derivative)<=rState.mMinimumVelocity && fabs(voltage_derivative)<=resting_potential_gradient_threshold)
+        {
+            rState.mMinimumVelocity = fabs(voltage_derivative);
+            rState.mCurrentRestingValue = prevV;
+            rState.mFoundAFlatBit = true;
+        }
+        else if (prevV < rState.mCurrentRestingValue && !rState.mFoundAFlatBit)
+        {
+            rState.mCurrentRestingValue = prevV;
+        }
+
+        // If we cross the threshold, this counts as an AP
+        if (v>threshold && prevV <= threshold)
+        {
+            rState.mRestingValue = rState.mCurrentRestingValue;
+            rState.mMinimumVelocity = DBL_MAX;
+            rState.mCurrentRestingValue = DBL_MAX;
+
+            rState.mSwitchingPhase = true;
+            rState.mFoundAFlatBit = false;
+            rState.mAboveThreshold = true;
+
+            // Any APD of the previous AP which never repolarised is abandoned
+            rState.mApdTargets.assign(rState.mApdTargets.size(), DBL_MAX);
+            rState.mApdStartPending = !rThreshold.mApdPercentages.empty();
+        }
+    }
+
+    // Deliberately not an 'else': processing continues straight on after an upstroke
+    if (rState.mAboveThreshold)
+    {
+        // While above threshold, look for the peak potential for the current AP
+        if (v>rState.mPeak)
+        {
+            rState.mPeak = v;
+        }
+
+        // Check whether we have above threshold depolarisations, but not if we have just switched
+        // from below threshold at this time step.
+        if (rState.mPreviousVelocity<=0 && voltage_derivative>0 && !rState.mSwitchingPhase)
+        {
+            rState.mPlateauDepolarisations++;
+        }
+        rState.mSwitchingPhase = false;
+
+        // If we cross the threshold again, the AP is over and we register all the parameters.
+        if (v<threshold && prevV >= threshold)
+        {
+            rState.mMaxUpstrokeVelocities.push_back(rState.mMaxUpstrokeVelocity);
+            rState.mUpstrokeTimes.push_back(rState.mTimeOfMaxUpstrokeVelocity);
+            rState.mAboveThresholdDepolarisations.push_back(rState.mPlateauDepolarisations);
+
+            rState.mPeak = threshold;
+            rState.mMaxUpstrokeVelocity = -DBL_MAX;
+            rState.mTimeOfMaxUpstrokeVelocity = 0.0;
+            rState.mPlateauDepolarisations = 0u;
+            rState.mAboveThreshold = false;
+        }
+    }
+
+    rState.mPreviousVelocity = voltage_derivative;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::FindApdStartTimes(NodeState& rState, const ThresholdState& rThreshold)
+{
+    rState.mApdStartPending = false;
+
+    const std::vector<std::pair<double, double> >& r_samples = rState.mRisingSamples;
+    for (unsigned p=0; p<rThreshold.mApdPercentages.size(); p++)
+    {
+        double target = rState.mRestingValue + 0.01*(100-rThreshold.mApdPercentages[p])*(rState.mPeak-rState.mRestingValue);
+
+        // Find where the rising trace crosses the target voltage
+        for (unsigned i=1; i<r_samples.size(); i++)
+        {
+            double prev_v = r_samples[i-1].second;
+            double v = r_samples[i].second;
+            if (prev_v<v && prev_v<=target && v>=target)
+            {
+                // Linear interpolation of target crossing time.
+                double prev_t = r_samples[i-1].first;
+                rState.mApdStartTimes[p] = prev_t + (target-prev_v)/(v-prev_v)*(r_samples[i].first-prev_t);
+                rState.mApdTargets[p] = target;
+                break;
+            }
+        }
+        // If the trace was already above the target when it started rising, no APD can be measured
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WriteHdf5Map(const std::vector<std::vector<double> >& rData,
+                                                                      const FileFinder& rDirectory,
+                                                                      const std::string& rHdf5File,
+                                                                      const std::string& rDatasetName,
+                                                                      const std::string& rDatasetUnit)
+{
+    DistributedVectorFactory* p_factory = mrMesh.GetDistributedVectorFactory();
+    FileFinder test_output("", RelativeTo::ChasteTestOutput);
+    Hdf5DataWriter writer(*p_factory,
+                          rDirectory.GetRelativePath(test_output),  // Path relative to CHASTE_TEST_OUTPUT
+                          rHdf5File,
+                          false, // to wiping
+                          true,  // to extending
+                          rDatasetName); // dataset name
+
+    int map_id = writer.DefineVariable(rDatasetName, rDatasetUnit);
+    writer.DefineFixedDimension(mrMesh.GetNumNodes());
+    writer.DefineUnlimitedDimension("PaceNumber", "dimensionless");
+    if (HeartConfig::Instance()->GetOutputUsingOriginalNodeOrdering())
+    {
+        // This does nothing if the mesh hasn't been permuted
+        writer.ApplyPermutation(mrMesh.rGetNodePermutation());
+    }
+    writer.EndDefineMode();
+
+    //Determine the maximum number of paces
+    unsigned local_max_paces = 0u;
+    for (unsigned node_index = 0; node_index < rData.size(); ++node_index)
+    {
+        if (rData[node_index].size() > local_max_paces)
+        {
+             local_max_paces = rData[node_index].size();
+        }
+    }
+
+    unsigned max_paces = 0u;
+    MPI_Allreduce(&local_max_paces, &max_paces, 1, MPI_UNSIGNED, MPI_MAX, PETSC_COMM_WORLD);
+
+    for (unsigned pace_idx = 0; pace_idx < max_paces; pace_idx++)
+    {
+        Vec map_vec = p_factory->CreateVec();
+        DistributedVector distributed_vector = p_factory->CreateDistributedVector(map_vec);
+        for (DistributedVector::Iterator index = distributed_vector.Begin();
+             index!= distributed_vector.End();
+             ++index)
+        {
+            unsigned node_idx = index.Local;
+            // pad with -999 if no pace defined at this node
+            if (pace_idx < rData[node_idx].size() )
+            {
+                distributed_vector[index] = rData[node_idx][pace_idx];
+            }
+            else
+            {
+                distributed_vector[index] = -999.0;
+            }
+        }
+        distributed_vector.Restore();
+        writer.PutVector(map_id, map_vec);
+        PetscTools::Destroy(map_vec);
+        writer.PutUnlimitedVariable(pace_idx);
+        writer.AdvanceAlongUnlimitedDimension();
+    }
+    writer.Close();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WriteTextMap(std::vector<std::vector<double> >& rData, const std::string& rFileName)
+{
+    const std::vector<unsigned>& r_permutation = mrMesh.rGetNodePermutation();
+    if (!r_permutation.empty() && HeartConfig::Instance()->GetOutputUsingOriginalNodeOrdering())
+    {
+        // Flatten the local rows, so they can be sent to the master process
+        std::vector<unsigned> row_lengths(rData.size());
+        std::vector<double> values;
+        for (unsigned row=0; row<rData.size(); row++)
+        {
+            row_lengths[row] = rData[row].size();
+            values.insert(values.end(), rData[row].begin(), rData[row].end());
+        }
+
+        // Note that this is collective the first time it is called
+        DistributedVectorFactory* p_factory = mrMesh.GetDistributedVectorFactory();
+        std::vector<unsigned>& r_lows = p_factory->rGetGlobalLows();
+
+        if (PetscTools::AmMaster())
+        {
+            // Collect the rows of every process, in the simulation's node ordering
+            std::vector<std::vector<double> > all_rows(rData);
+            all_rows.reserve(p_factory->GetProblemSize());
+            for (unsigned process=1; process<PetscTools::GetNumProcs(); process++)
+            {
+                unsigned hi = (process+1 < r_lows.size()) ? r_lows[process+1] : p_factory->GetProblemSize();
+                unsigned num_rows = hi - r_lows[process];
+                MPI_Status status;
+                status.MPI_ERROR = MPI_SUCCESS; //For MPICH2
+
+                std::vector<unsigned> remote_lengths(num_rows);
+                unsigned num_values = 0;
+                if (num_rows > 0)
+                {
+                    MPI_Recv(&remote_lengths[0], num_rows, MPI_UNSIGNED, process, 0, PETSC_COMM_WORLD, &status);
+                    for (unsigned row=0; row<num_rows; row++)
+                    {
+                        num_values += remote_lengths[row];
+                    }
+                }
+                std::vector<double> remote_values(num_values);
+                if (num_values > 0)
+                {
+                    MPI_Recv(&remote_values[0], num_values, MPI_DOUBLE, process, 1, PETSC_COMM_WORLD, &status);
+                }
+
+                std::vector<double>::const_iterator it = remote_values.begin();
+                for (unsigned row=0; row<num_rows; row++)
+                {
+                    all_rows.push_back(std::vector<double>(it, it + remote_lengths[row]));
+                    it += remote_lengths[row];
+                }
+            }
+            assert(all_rows.size() == r_permutation.size());
+
+            // The node with original index i is now indexed by r_permutation[i]
+            rData.resize(r_permutation.size());
+            for (unsigned original_index=0; original_index<r_permutation.size(); original_index++)
+            {
+                rData[original_index] = all_rows[r_permutation[original_index]];
+            }
+        }
+        else
+        {
+            if (!row_lengths.empty())
+            {
+                MPI_Ssend(&row_lengths[0], row_lengths.size(), MPI_UNSIGNED, 0, 0, PETSC_COMM_WORLD);
+            }
+            if (!values.empty())
+            {
+                MPI_Ssend(&values[0], values.size(), MPI_DOUBLE, 0, 1, PETSC_COMM_WORLD);
+            }
+            rData.clear();
+        }
+    }
+
+    PostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WriteGenericFileToMeshalyzer(rData, "", rFileName);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void InSituPostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WriteMaps(const FileFinder& rDirectory, const std::string& rHdf5File)
+{
+    // Hdf5DataWriter can only add datasets to an existing file
+    OutputFileHandler handler(rDirectory, false);
+    if (PetscTools::AmMaster())
+    {
+        FileFinder h5_file(rHdf5File + ".h5", rDirectory);
+        if (!h5_file.Exists())
+        {
+            // There are no simulation results to add the maps to, so start an empty file
+            hid_t file_id = H5Fcreate(h5_file.GetAbsolutePath().c_str(), H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
+            if (file_id < 0)
+            {
+                PetscTools::ReplicateBool(true);
+                EXCEPTION("Unable to create HDF5 file for in-situ post-processing maps: " + h5_file.GetAbsolutePath());
+            }
+            H5Fclose(file_id);
+        }
+        PetscTools::ReplicateBool(false);
+    }
+    else
+    {
+        if (PetscTools::ReplicateBool(false))
+        {
+            EXCEPTION("Unable to create HDF5 file for in-situ post-processing maps");
+        }
+    }
+
+    for (unsigned i=0; i<mThresholdStates.size(); i++)
+    {
+        const ThresholdState& r_threshold = mThresholdStates[i];
+        std::string threshold_string = PostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::ConvertToHdf5FriendlyString(r_threshold.mThreshold);
+        unsigned num_local_nodes = r_threshold.mNodes.size();
+
+        for (unsigned p=0; p<r_threshold.mApdPercentages.size(); p++)
+        {
+            std::vector<std::vector<double> > output_data(num_local_nodes);
+            for (unsigned node=0; node<num_local_nodes; node++)
+            {
+                output_data[node] = r_threshold.mNodes[node].mApds[p];
+                if (output_data[node].empty())
+                {
+                    output_data[node].push_back(0);
+                }
+            }
+
+            // HDF5 shouldn't have minus signs in the data names..
+            std::stringstream dataset_name;
+            dataset_name << "Apd_" << r_threshold.mApdPercentages[p];
+            WriteHdf5Map(output_data, rDirectory, rHdf5File, dataset_name.str() + threshold_string + "_Map", "msec");
+        }
+
+        if (r_threshold.mUpstrokeTimeMap || r_threshold.mMaxUpstrokeVelocityMap)
+        {
+            std::vector<std::vector<double> > upstroke_times(num_local_nodes);
+            std::vector<std::vector<double> > upstroke_velocities(num_local_nodes);
+            for (unsigned node=0; node<num_local_nodes; node++)
+            {
+                const NodeState& r_state = r_threshold.mNodes[node];
+                upstroke_times[node] = r_state.mUpstrokeTimes;
+                upstroke_velocities[node] = r_state.mMaxUpstrokeVelocities;
+                if (r_state.mAboveThreshold)
+                {
+                    // Include the AP in progress, as CellProperties does
+                    upstroke_times[node].push_back(r_state.mTimeOfMaxUpstrokeVelocity);
+                    upstroke_velocities[node].push_back(r_state.mMaxUpstrokeVelocity);
+                }
+                if (upstroke_times[node].empty())
+                {
+                    upstroke_times[node].push_back(0);
+                    upstroke_velocities[node].push_back(0);
+                }
+            }
+
+            if (r_threshold.mUpstrokeTimeMap)
+            {
+                WriteHdf5Map(upstroke_times, rDirectory, rHdf5File, "UpstrokeTimeMap" + threshold_string, "msec");
+            }
+            if (r_threshold.mMaxUpstrokeVelocityMap)
+            {
+                WriteHdf5Map(upstroke_velocities, rDirectory, rHdf5File, "MaxUpstrokeVelocityMap" + threshold_string, "mV_per_msec");
+            }
+        }
+
+        if (r_threshold.mAboveThresholdDepolarisationMap)
+        {
+            // One row per node: <number of upstrokes> <number of above-threshold depolarisations>
+            std::vector<std::vector<double> > output_data(num_local_nodes);
+            for (unsigned node=0; node<num_local_nodes; node++)
+            {
+                const NodeState& r_state = r_threshold.mNodes[node];
+                unsigned num_upstrokes = r_state.mUpstrokeTimes.size();
+                unsigned num_depolarisations = 0u;
+                for (unsigned ap=0; ap<r_state.mAboveThresholdDepolarisations.size(); ap++)
+                {
+                    num_depolarisations += r_state.mAboveThresholdDepolarisations[ap];
+                }
+                if (r_state.mAboveThreshold)
+                {
+                    num_upstrokes++;
+                }
+                output_data[node].push_back((double) num_upstrokes);
+                output_data[node].push_back((double) num_depolarisations);
+            }
+            // PostProcessingWriter also writes this map as text
+            WriteTextMap(output_data, "AboveThresholdDepolarisations" + threshold_string + ".dat");
+        }
+    }
+}
+
+/////////////////////////////////////////////////////////////////////
+// Explicit instantiation
+/////////////////////////////////////////////////////////////////////
+
+template class InSituPostProcessingWriter<1,1>;
+template class InSituPostProcessingWriter<1,2>;
+template class InSituPostProcessingWriter<2,2>;
+template class InSituPostProcessingWriter<1,3>;
+template class InSituPostProcessingWriter<3,3>;
@@ -0,0 +1,291 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef INSITUPOSTPROCESSINGWRITER_HPP_
+#define INSITUPOSTPROCESSINGWRITER_HPP_
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "AbstractTetrahedralMesh.hpp"
+#include "FileFinder.hpp"
+#include "PetscTools.hpp"
+
+/**
+ * Calculate activation and action potential maps "in situ", i.e. by updating per-node
+ * accumulators with the voltage at each printing time step as a simulation runs, rather
+ * than by re-reading the complete HDF5 results file afterwards as PostProcessingWriter does.
+ * This means the maps can be produced without writing voltage output at all.
+ *
+ * The following maps are supported:
+ * - APD map (for a given percentage repolarisation and upstroke threshold)
+ * - Upstroke time map
+ * - Max upstroke velocity map
+ * - Above-threshold depolarisations
+ *
+ * The state machine used to detect action potentials, upstrokes and resting/peak potentials
+ * is the same as that of CellProperties, so the maps match those computed by PostProcessingWriter
+ * from data at the same time steps.  The only difference is in the APD calculation: the start of
+ * the action potential is found when the voltage first falls after the peak, by interpolating
+ * the target voltage within the preceding rising stretch of the trace (which is all that is
+ * remembered), and the peak used for the target is the highest voltage reached up to that point.
+ *
+ * Each node's data are stored on the process which owns it.  The maps are written by WriteMaps as
+ * datasets in the HDF5 results file, exactly as PostProcessingWriter writes them, so the HDF5 converters
+ * pick them up in the same way.
+ *
+ * The accumulators are not archived, so the maps can't be calculated for a simulation resumed from
+ * a checkpoint (AbstractCardiacProblem::PreSolveChecks() throws in that case).
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class InSituPostProcessingWriter
+{
+private:
+
+    /** The state of the accumulators for one upstroke threshold at a single node. */
+    struct NodeState
+    {
+        /** Whether the voltage is currently above threshold, i.e. during an action potential. */
+        bool mAboveThreshold;
+        /** Whether the threshold was crossed upwards at the last time step. */
+        bool mSwitchingPhase;
+        /** Whether a flat bit of trace has been found since the last action potential. */
+        bool mFoundAFlatBit;
+        /** The minimum rate of change of voltage found below threshold since the last action potential. */
+        double mMinimumVelocity;
+        /** The resting potential found so far since the last action potential. */
+        double mCurrentRestingValue;
+        /** The resting potential registered at the start of the current/last action potential. */
+        double mRestingValue;
+        /** The peak potential of the current action potential. */
+        double mPeak;
+        /** The maximum upstroke velocity since the last action potential ended. */
+        double mMaxUpstrokeVelocity;
+        /** The time of #mMaxUpstrokeVelocity. */
+        double mTimeOfMaxUpstrokeVelocity;
+        /** The rate of change of voltage at the previous time step. */
+        double mPreviousVelocity;
+        /** The number of above-threshold depolarisations during the current action potential. */
+        unsigned mPlateauDepolarisations;
+
+        /** Upstroke times (of maximum upstroke velocity) of completed action potentials. */
+        std::vector<double> mUpstrokeTimes;
+        /** Maximum upstroke velocities of completed action potentials. */
+        std::vector<double> mMaxUpstrokeVelocities;
+        /** Above-threshold depolarisations of completed action potentials. */
+        std::vector<unsigned> mAboveThresholdDepolarisations;
+
+        /** Whether the start times of APDs for the current action potential are still to be found. */
+        bool mApdStartPending;
+        /** The (time, voltage) samples of the current rising stretch of trace, while #mApdStartPending. */
+        std::vector<std::pair<double, double> > mRisingSamples;
+        /** For each APD percentage, the target voltage for the current action potential (DBL_MAX if not waiting to repolarise). */
+        std::vector<double> mApdTargets;
+        /** For each APD percentage, the start time for the current action potential. */
+        std::vector<double> mApdStartTimes;
+        /** For each APD percentage, the APDs of completed action potentials. */
+        std::vector<std::vector<double> > mApds;
+    };
+
+    /** All the maps requested for a given upstroke threshold, and the per-node accumulators for it. */
+    struct ThresholdState
+    {
+        /** The voltage used to signify an upstroke. */
+        double mThreshold;
+        /** The APD percentages requested. */
+        std::vector<double> mApdPercentages;
+        /** Whether an upstroke time map was requested. */
+        bool mUpstrokeTimeMap;
+        /** Whether a max upstroke velocity map was requested. */
+        bool mMaxUpstrokeVelocityMap;
+        /** Whether an above-threshold depolarisations map was requested. */
+        bool mAboveThresholdDepolarisationMap;
+        /** The accumulators for each locally owned node. */
+        std::vector<NodeState> mNodes;
+    };
+
+    /** The mesh, used for its DistributedVectorFactory. */
+    AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& mrMesh;
+
+    /** The accumulators, one for each distinct upstroke threshold. */
+    std::vector<ThresholdState> mThresholdStates;
+
+    /** The time of the last update (DBL_MAX before the first one). */
+    double mPreviousTime;
+
+    /** The voltage at each locally owned node at the last update. */
+    std::vector<double> mPreviousVoltages;
+
+    /**
+     * Get the accumulators for a threshold, creating them if necessary.
+     *
+     * @param threshold  the upstroke threshold
+     * @return the accumulators for this threshold
+     */
+    ThresholdState& rGetThresholdState(double threshold);
+
+    /**
+     * Update the accumulators for one node with a new time step.
+     *
+     * @param rState  the accumulators for this node and threshold
+     * @param rThreshold  the threshold and requested maps
+     * @param prevTime  the time of the previous sample
+     * @param prevV  the voltage at the previous sample
+     * @param time  the time of the new sample
+     * @param v  the voltage at the new sample
+     */
+    void UpdateNode(NodeState& rState, const ThresholdState& rThreshold,
+                    double prevTime, double prevV, double time, double v);
+
+    /**
+     * Fill in the APD start times for the current action potential once its peak has been passed.
+     *
+     * @param rState  the accumulators for this node and threshold
+     * @param rThreshold  the threshold and requested APD percentages
+     */
+    void FindApdStartTimes(NodeState& rState, const ThresholdState& rThreshold);
+
+    /**
+     * Write a map as a new dataset in an HDF5 file, with one entry per node and action potential,
+     * as PostProcessingWriter::WriteOutputDataToHdf5() does.  Nodes with fewer action potentials
+     * are padded with -999.  If the mesh has been permuted and HeartConfig asks for output using
+     * the original node ordering, the nodes are put into the original ordering, as they are in
+     * the simulation results.
+     *
+     * @param rData  the values for the locally owned nodes
+     * @param rDirectory  the directory containing the HDF5 file
+     * @param rHdf5File  the base name of the HDF5 file
+     * @param rDatasetName  the name of the new dataset, and of its only variable
+     * @param rDatasetUnit  the units of the values
+     */
+    void WriteHdf5Map(const std::vector<std::vector<double> >& rData,
+                      const FileFinder& rDirectory,
+                      const std::string& rHdf5File,
+                      const std::string& rDatasetName,
+                      const std::string& rDatasetUnit);
+
+    /**
+     * Write a map as a text file, one row per node, as PostProcessingWriter does for the
+     * above-threshold depolarisations map.  If the mesh has been permuted and HeartConfig asks
+     * for output using the original node ordering, the rows are first gathered onto the master
+     * process and put into the original ordering.
+     *
+     * @param rData  the rows for the locally owned nodes (emptied if the rows are gathered)
+     * @param rFileName  the name of the file to write, in the HeartConfig output directory
+     */
+    void WriteTextMap(std::vector<std::vector<double> >& rData, const std::string& rFileName);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rMesh  the mesh the simulation is being run on
+     */
+    InSituPostProcessingWriter(AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>& rMesh);
+
+    /**
+     * Request an APD map.  Must be called before the first call to Update.
+     *
+     * @param repolarisationPercentage  eg. 90.0 for APD90
+     * @param threshold  Vm used to signify the upstroke (mV)
+     */
+    void AddApdMap(double repolarisationPercentage, double threshold);
+
+    /**
+     * Request an upstroke time map.  Must be called before the first call to Update.
+     *
+     * @param threshold  Vm used to signify the upstroke (mV)
+     */
+    void AddUpstrokeTimeMap(double threshold);
+
+    /**
+     * Request a max upstroke velocity map.  Must be called before the first call to Update.
+     *
+     * @param threshold  Vm used to signify the upstroke (mV)
+     */
+    void AddMaxUpstrokeVelocityMap(double threshold);
+
+    /**
+     * Request a map of the number of upstrokes and above-threshold depolarisations at each node.
+     * Must be called before the first call to Update.
+     *
+     * @param threshold  used to signify the upstroke (mV) AND to specify above which voltage value the depolarisations are counted
+     */
+    void AddAboveThresholdDepolarisationMap(double threshold);
+
+    /**
+     * Request all the APD, upstroke time and max upstroke velocity maps requested in HeartConfig.
+     */
+    void AddMapsRequestedInHeartConfig();
+
+    /**
+     * @return whether any maps have been requested.
+     */
+    bool HasMaps() const;
+
+    /**
+     * Update the accumulators with the solution at a new time step.  Updates for a time
+     * no later than the previous one are ignored, so when a problem is solved again for
+     * longer its initial condition may safely be passed in again.
+     *
+     * @param time  the simulation time
+     * @param solution  the solution vector; if striped, the voltage is taken from the first stripe
+     */
+    void Update(double time, Vec solution);
+
+    /**
+     * Write the requested maps to an HDF5 file, normally the results file of the simulation.
+     * The APD, upstroke time and max upstroke velocity maps are added to it as new datasets,
+     * with the names and layout used by PostProcessingWriter: one entry for each node and action
+     * potential, with a single 0 for nodes with no (complete) action potential.  Action potentials
+     * still in progress are included in the upstroke maps, as in CellProperties.  If the file
+     * doesn't exist (e.g. because the simulation output was turned off) an empty one is created
+     * to hold the maps.  The above-threshold depolarisations map is written to a text file in
+     * the HeartConfig output directory, as PostProcessingWriter does.
+     *
+     * The nodes are in the original node ordering of a permuted mesh if
+     * HeartConfig::GetOutputUsingOriginalNodeOrdering() is set, and in the simulation's node
+     * ordering otherwise.  This is a collective operation, and should only be called once for
+     * each file.
+     *
+     * @param rDirectory  the directory containing the HDF5 file
+     * @param rHdf5File  the base name of the HDF5 file (without the ".h5")
+     */
+    void WriteMaps(const FileFinder& rDirectory, const std::string& rHdf5File);
+};
+
+#endif /*INSITUPOSTPROCESSINGWRITER_HPP_*/
@@ -74,7 +74,11 @@ void PostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WritePostProcessingFiles()
 
     // Please note that only the master processor should write to file.
     // Each of the private methods called here takes care of checking.
-    if (HeartConfig::Instance()->IsApdMapsRequested())
+
+    // These maps are produced by InSituPostProcessingWriter during the solve if requested
+    bool in_situ = HeartConfig::Instance()->GetUseInSituPostProcessing();
+
+    if (HeartConfig::Instance()->IsApdMapsRequested() && !in_situ)
     {
         std::vector<std::pair<double,double> > apd_maps;
         HeartConfig::Instance()->GetApdMaps(apd_maps);
@@ -84,7 +88,7 @@ void PostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WritePostProcessingFiles()
         }
     }
 
-    if (HeartConfig::Instance()->IsUpstrokeTimeMapsRequested())
+    if (HeartConfig::Instance()->IsUpstrokeTimeMapsRequested() && !in_situ)
     {
         std::vector<double> upstroke_time_maps;
         HeartConfig::Instance()->GetUpstrokeTimeMaps(upstroke_time_maps);
@@ -94,7 +98,7 @@ void PostProcessingWriter<ELEMENT_DIM, SPACE_DIM>::WritePostProcessingFiles()
         }
     }
 
-    if (HeartConfig::Instance()->IsMaxUpstrokeVelocityMapRequested())
+    if (HeartConfig::Instance()->IsMaxUpstrokeVelocityMapRequested() && !in_situ)
     {
         std::vector<double> upstroke_velocity_maps;
         HeartConfig::Instance()->GetMaxUpstrokeVelocityMaps(upstroke_velocity_maps);
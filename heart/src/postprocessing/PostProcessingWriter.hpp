@@ -86,7 +86,8 @@ public:
 
     /**
      *  Write out data files. The data that is written depends on which maps have been requested using
-     *  either the XML file or HeartConfig
+     *  either the XML file or HeartConfig.  APD, upstroke time and max upstroke velocity maps are skipped
+     *  if they are being calculated in situ (see HeartConfig::SetUseInSituPostProcessing).
      */
     void WritePostProcessingFiles();
 
@@ -112,6 +113,34 @@ public:
      */
     void WriteAboveThresholdDepolarisationFile(double threshold);
 
+    /**
+     * Method for opening a file and writing one row per node
+     * line 1: <first scalar data for node 0> <second scalar data for node 0> ...
+     * line 2: <first scalar data for node 1> <second scalar data for node 1> ...
+     * etc.
+     *
+     * The file is written to the HeartConfig output directory.  This is a collective operation.
+     *
+     * @param  rDataPayload vector data for each node.  Each node's data are represented by a vector of scalars (variable length)
+     * @param  rFolder subfolder for postprocessing in which to put the data.
+     * @param  rFileName where to put the data.
+     */
+    static void WriteGenericFileToMeshalyzer(std::vector<std::vector<double> >& rDataPayload, const std::string& rFolder, const std::string& rFileName);
+
+    /**
+     * Convert a string with numbers in it into alphanumeric plus underscores.
+     *
+     * e.g.
+     * 20 -> "_20"
+     * -20 -> "_minus_20"
+     * 30.2 -> "_30pt20"
+     * -11.238 -> "_minus_11pt23" (always does decimals to (floor) 2d.p.)
+     *
+     * @param threshold  A numerical threshold which may contain minuses or a decimal point.
+     * @return  A string version of the number without minuses or decimal points.
+     */
+    static std::string ConvertToHdf5FriendlyString(double threshold);
+
 private:
 
     /**
@@ -196,17 +225,6 @@ private:
      */
     void WriteConductionVelocityMap(unsigned originNode, std::vector<double> distancesFromOriginNode);
 
-    /**
-     * Method for opening a file and writing one row per node
-     * line 1: <first scalar data for node 0> <second scalar data for node 0> ...
-     * line 2: <first scalar data for node 1> <second scalar data for node 1> ...
-     * etc.
-     * @param  rDataPayload vector data for each node.  Each node's data are represented by a vector of scalars (variable length)
-     * @param  rFolder subfolder for postprocessing in which to put the data.
-     * @param  rFileName where to put the data.
-     */
-    void WriteGenericFileToMeshalyzer(std::vector<std::vector<double> >& rDataPayload, const std::string& rFolder, const std::string& rFileName);
-
     /**
      * Put the post-processed data into the main HDF5 results file.
      *
@@ -221,21 +239,6 @@ private:
                                const std::string& rDatasetUnit,
                                const std::string& rUnlimitedVariableName = "PaceNumber",
                                const std::string& rUnlimitedVariableUnit = "dimensionless");
-
-    /**
-     * Convert a string with numbers in it into alphanumeric plus underscores.
-     *
-     * e.g.
-     * 20 -> "_20"
-     * -20 -> "_minus_20"
-     * 30.2 -> "_30pt20"
-     * -11.238 -> "_minus_11pt23" (always does decimals to (floor) 2d.p.)
-     *
-     * @param threshold  A numerical threshold which may contain minuses or a decimal point.
-     * @return  A string version of the number without minuses or decimal points.
-     */
-    std::string ConvertToHdf5FriendlyString(double threshold);
-
 };
 
 #endif /*POSTPROCESSINGWRITER_HPP_*/
@@ -63,7 +63,8 @@ AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::AbstractCardiacProble
       mSolution(NULL),
       mCurrentTime(0.0),
       mpTimeAdaptivityController(NULL),
-      mpWriter(NULL)
+      mpWriter(NULL),
+      mpInSituPostProcessingWriter(NULL)
 {
     assert(mNodesToOutput.empty());
     if (!mpCellFactory)
@@ -91,7 +92,8 @@ AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::AbstractCardiacProble
       mSolution(NULL),
       mCurrentTime(0.0),
       mpTimeAdaptivityController(NULL),
-      mpWriter(NULL)
+      mpWriter(NULL),
+      mpInSituPostProcessingWriter(NULL)
 {
 }
 
@@ -99,6 +101,7 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::~AbstractCardiacProblem()
 {
     delete mpCardiacTissue;
+    delete mpInSituPostProcessingWriter;
     if (mSolution)
     {
         PetscTools::Destroy(mSolution);
@@ -240,6 +243,17 @@ void AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::PreSolveChecks()
             EXCEPTION("Either explicitly specify not to print output (call PrintOutput(false)) or specify the output directory and filename prefix");
         }
     }
+    if (HeartConfig::Instance()->GetUseInSituPostProcessing() && !mpInSituPostProcessingWriter && mCurrentTime > 0.0)
+    {
+        // The accumulators for the maps start with the first solve, and aren't archived
+        InSituPostProcessingWriter<ELEMENT_DIM,SPACE_DIM> requested_maps(*mpMesh);
+        requested_maps.AddMapsRequestedInHeartConfig();
+        if (requested_maps.HasMaps())
+        {
+            EXCEPTION("In-situ post-processing maps can only be calculated from the start of a simulation, "
+                      "not for a simulation resumed from a checkpoint or already solved without them.");
+        }
+    }
 
     double end_time = HeartConfig::Instance()->GetSimulationDuration();
     double pde_time = HeartConfig::Instance()->GetPdeTimeStep();
@@ -452,6 +466,18 @@ void AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::Solve()
         progress_reporter_dir = ""; // progress printed to CHASTE_TEST_OUTPUT
     }
 
+    if (HeartConfig::Instance()->GetUseInSituPostProcessing())
+    {
+        HeartEventHandler::BeginEvent(HeartEventHandler::POST_PROC);
+        if (!mpInSituPostProcessingWriter)
+        {
+            mpInSituPostProcessingWriter = new InSituPostProcessingWriter<ELEMENT_DIM,SPACE_DIM>(*mpMesh);
+            mpInSituPostProcessingWriter->AddMapsRequestedInHeartConfig();
+        }
+        mpInSituPostProcessingWriter->Update(stepper.GetTime(), initial_condition);
+        HeartEventHandler::EndEvent(HeartEventHandler::POST_PROC);
+    }
+
     /*
      * Create a progress reporter so users can track how much has gone and
      * estimate how much time is left. Note this has to be done after the
@@ -549,6 +575,14 @@ void AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::Solve()
             HeartEventHandler::EndEvent(HeartEventHandler::WRITE_OUTPUT);
         }
 
+        if (mpInSituPostProcessingWriter)
+        {
+            // Update activation and APD maps with this printing time step
+            HeartEventHandler::BeginEvent(HeartEventHandler::POST_PROC);
+            mpInSituPostProcessingWriter->Update(stepper.GetTime(), mSolution);
+            HeartEventHandler::EndEvent(HeartEventHandler::POST_PROC);
+        }
+
         progress_reporter.Update(stepper.GetTime());
 
         OnEndOfTimestep(stepper.GetTime());
@@ -568,16 +602,25 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 void AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::CloseFilesAndPostProcess()
 {
     // Close files
-    if (!mPrintOutput)
-    {
-        // Nothing to do
-        return;
-    }
     delete mpWriter;
     mpWriter = NULL;
 
     FileFinder test_output(HeartConfig::Instance()->GetOutputDirectory(), RelativeTo::ChasteTestOutput);
 
+    // Maps calculated during the solve are added to the results file (which is created if there is no output)
+    if (mpInSituPostProcessingWriter && mpInSituPostProcessingWriter->HasMaps())
+    {
+        HeartEventHandler::BeginEvent(HeartEventHandler::POST_PROC);
+        mpInSituPostProcessingWriter->WriteMaps(test_output, HeartConfig::Instance()->GetOutputFilenamePrefix());
+        HeartEventHandler::EndEvent(HeartEventHandler::POST_PROC);
+    }
+
+    if (!mPrintOutput)
+    {
+        // Nothing else to do
+        return;
+    }
+
     /********************************************************************************
      * Run all post processing.
      *
@@ -836,6 +879,9 @@ bool AbstractCardiacProblem<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::InitialiseWriter
         mpWriter->EndDefineMode();
     }
 
+    // Stage output in memory if requested; the cache is flushed when the writer is closed
+    mpWriter->SetCacheSize(HeartConfig::Instance()->GetOutputCacheSize());
+
     return extend_file;
 }
 
@@ -62,6 +62,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedVectorFactory.hpp"
 #include "Hdf5DataReader.hpp"
 #include "Hdf5DataWriter.hpp"
+#include "InSituPostProcessingWriter.hpp"
 #include "Warnings.hpp"
 
 /*
@@ -451,6 +452,13 @@ protected:
      */
     Hdf5DataWriter* mpWriter;
 
+    /**
+     * Calculates postprocessing maps during the solve, if requested with
+     * HeartConfig::SetUseInSituPostProcessing.  Not archived, so PreSolveChecks()
+     * refuses to calculate maps for a simulation resumed from a checkpoint.
+     */
+    InSituPostProcessingWriter<ELEMENT_DIM,SPACE_DIM>* mpInSituPostProcessingWriter;
+
 public:
     /**
      * Constructor
@@ -495,7 +503,8 @@ public:
      *  Performs a series of checks before solving.
      *  It checks whether the cardiac pde has been defined,
      *  whether the simulation time is greater than zero and
-     *  whether the output directory is specified (or the output is set not to be produced).
+     *  whether the output directory is specified (or the output is set not to be produced)
+     *  and that any in-situ post-processing maps will cover the whole simulation.
      *  It throws exceptions if any of the above checks fails.
      */
     virtual void PreSolveChecks();
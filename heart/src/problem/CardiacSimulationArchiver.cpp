@@ -70,25 +70,49 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "HeartConfigRelatedCellFactory.hpp"
 
 
+template<class PROBLEM_CLASS>
+template<class ARCHIVE>
+void CardiacSimulationArchiver<PROBLEM_CLASS>::SaveArchive(PROBLEM_CLASS& rSimulationToArchive,
+                                                           const FileFinder& rDirectory)
+{
+    // Open the archive files
+    ArchiveOpener<ARCHIVE, std::ofstream> archive_opener(rDirectory, "archive.arch");
+    ARCHIVE* p_main_archive = archive_opener.GetCommonArchive();
+
+    // And save
+    PROBLEM_CLASS* const p_simulation_to_archive = &rSimulationToArchive;
+    (*p_main_archive) & p_simulation_to_archive;
+}
+
 template<class PROBLEM_CLASS>
 void CardiacSimulationArchiver<PROBLEM_CLASS>::Save(PROBLEM_CLASS& rSimulationToArchive,
                                                     const std::string& rDirectory,
-                                                    bool clearDirectory)
+                                                    bool clearDirectory,
+                                                    bool binaryArchive)
 {
     // Clear directory if requested (and make sure it exists)
     OutputFileHandler handler(rDirectory, clearDirectory);
 
-    // Nest the archive writing, so the ArchiveOpener goes out of scope before
-    // the method ends.
+    // The archive files are closed by the time this returns
+    FileFinder dir(rDirectory, RelativeTo::ChasteTestOutput);
+    if (binaryArchive)
+    {
+        // Cell state variables go in raw per-process arrays, leaving the archives to hold the object graph
+        ArchiveLocationInfo::SetStateVariablesInSeparateArrays(true);
+        try
+        {
+            SaveArchive<boost::archive::binary_oarchive>(rSimulationToArchive, dir);
+        }
+        catch (Exception &e)
+        {
+            ArchiveLocationInfo::SetStateVariablesInSeparateArrays(false);
+            throw e;
+        }
+        ArchiveLocationInfo::SetStateVariablesInSeparateArrays(false);
+    }
+    else
     {
-        // Open the archive files
-        FileFinder dir(rDirectory, RelativeTo::ChasteTestOutput);
-        ArchiveOpener<boost::archive::text_oarchive, std::ofstream> archive_opener(dir, "archive.arch");
-        boost::archive::text_oarchive* p_main_archive = archive_opener.GetCommonArchive();
-
-        // And save
-        PROBLEM_CLASS* const p_simulation_to_archive = &rSimulationToArchive;
-        (*p_main_archive) & p_simulation_to_archive;
+        SaveArchive<boost::archive::text_oarchive>(rSimulationToArchive, dir);
     }
 
     // Write the info file
@@ -104,7 +128,7 @@ void CardiacSimulationArchiver<PROBLEM_CLASS>::Save(PROBLEM_CLASS& rSimulationTo
         }
         PetscTools::ReplicateBool(false);
         unsigned archive_version = 0; // Note that Boost version numbers are per-class; this only needs to change if we change the Load/Save methods here
-        info_file << PetscTools::GetNumProcs() << " " << archive_version;
+        info_file << PetscTools::GetNumProcs() << " " << archive_version << " " << (binaryArchive ? "binary" : "text");
     }
     else
     {
@@ -131,6 +155,45 @@ PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::Load(const FileFinder&
     return CardiacSimulationArchiver<PROBLEM_CLASS>::Migrate(rDirectory);
 }
 
+template<class PROBLEM_CLASS>
+template<class ARCHIVE>
+PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::LoadArchive(const FileFinder& rDirectory,
+                                                                     unsigned numProcs,
+                                                                     unsigned archiveVersion)
+{
+    PROBLEM_CLASS *p_unarchived_simulation;
+
+    // Figure out which process-specific archive to load first.  If we're loading on the same number of
+    // processes, we must load our own one, or the mesh gets confused.  Otherwise, start with 0 to make
+    // sure it exists.
+    unsigned initial_archive = numProcs == PetscTools::GetNumProcs() ? PetscTools::GetMyRank() : 0u;
+
+    // Load the master and initial process-specific archive files.
+    // This will also set up ArchiveLocationInfo for us.
+    ArchiveOpener<ARCHIVE, std::ifstream> archive_opener(rDirectory, "archive.arch", initial_archive);
+    ARCHIVE* p_main_archive = archive_opener.GetCommonArchive();
+    (*p_main_archive) >> p_unarchived_simulation;
+
+    // Work out how many more process-specific files to load
+    DistributedVectorFactory* p_factory = p_unarchived_simulation->rGetMesh().GetDistributedVectorFactory();
+    assert(p_factory != NULL);
+    unsigned original_num_procs = p_factory->GetOriginalFactory()->GetNumProcs();
+    assert(original_num_procs == numProcs); // Paranoia
+
+    // Merge in the extra data
+    for (unsigned archive_num=0; archive_num<original_num_procs; archive_num++)
+    {
+        if (archive_num != initial_archive)
+        {
+            std::string archive_path = ArchiveLocationInfo::GetProcessUniqueFilePath("archive.arch", archive_num);
+            std::ifstream ifs(archive_path.c_str(), std::ios::binary);
+            ARCHIVE archive(ifs);
+            p_unarchived_simulation->LoadExtraArchive(archive, archiveVersion);
+        }
+    }
+
+    return p_unarchived_simulation;
+}
 
 template<class PROBLEM_CLASS>
 PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::Migrate(const FileFinder& rDirectory)
@@ -153,52 +216,44 @@ PROBLEM_CLASS* CardiacSimulationArchiver<PROBLEM_CLASS>::Migrate(const FileFinde
     unsigned num_procs, archive_version;
     info_file >> num_procs >> archive_version;
 
+    // Checkpoints written before binary archives were available don't record their format
+    std::string archive_format = "text";
+    info_file >> archive_format;
+    if (archive_format != "text" && archive_format != "binary")
+    {
+        EXCEPTION("Unknown archive format '" + archive_format + "' in archive information file: " + info_path);
+    }
+
     PROBLEM_CLASS *p_unarchived_simulation;
 
     // Avoid the DistributedVectorFactory throwing a 'wrong number of processes' exception when loading,
     // and make it get the original DistributedVectorFactory from the archive so we can compare against
     // num_procs.
     DistributedVectorFactory::SetCheckNumberOfProcessesOnLoad(false);
-    // Put what follows in a try-catch to make sure we reset this
+    // Binary checkpoints keep the cell state variables in separate per-process arrays.
+    ArchiveLocationInfo::SetStateVariablesInSeparateArrays(archive_format == "binary");
+    // Put what follows in a try-catch to make sure we reset these
     try
     {
-        // Figure out which process-specific archive to load first.  If we're loading on the same number of
-        // processes, we must load our own one, or the mesh gets confused.  Otherwise, start with 0 to make
-        // sure it exists.
-        unsigned initial_archive = num_procs == PetscTools::GetNumProcs() ? PetscTools::GetMyRank() : 0u;
-
-        // Load the master and initial process-specific archive files.
-        // This will also set up ArchiveLocationInfo for us.
-        ArchiveOpener<boost::archive::text_iarchive, std::ifstream> archive_opener(rDirectory, "archive.arch", initial_archive);
-        boost::archive::text_iarchive* p_main_archive = archive_opener.GetCommonArchive();
-        (*p_main_archive) >> p_unarchived_simulation;
-
-        // Work out how many more process-specific files to load
-        DistributedVectorFactory* p_factory = p_unarchived_simulation->rGetMesh().GetDistributedVectorFactory();
-        assert(p_factory != NULL);
-        unsigned original_num_procs = p_factory->GetOriginalFactory()->GetNumProcs();
-        assert(original_num_procs == num_procs); // Paranoia
-
-        // Merge in the extra data
-        for (unsigned archive_num=0; archive_num<original_num_procs; archive_num++)
+        if (archive_format == "binary")
+        {
+            p_unarchived_simulation = LoadArchive<boost::archive::binary_iarchive>(rDirectory, num_procs, archive_version);
+        }
+        else
         {
-            if (archive_num != initial_archive)
-            {
-                std::string archive_path = ArchiveLocationInfo::GetProcessUniqueFilePath("archive.arch", archive_num);
-                std::ifstream ifs(archive_path.c_str());
-                boost::archive::text_iarchive archive(ifs);
-                p_unarchived_simulation->LoadExtraArchive(archive, archive_version);
-            }
+            p_unarchived_simulation = LoadArchive<boost::archive::text_iarchive>(rDirectory, num_procs, archive_version);
         }
     }
     catch (Exception &e)
     {
         DistributedVectorFactory::SetCheckNumberOfProcessesOnLoad(true);
+        ArchiveLocationInfo::SetStateVariablesInSeparateArrays(false);
         throw e;
     }
 
     // Done.
     DistributedVectorFactory::SetCheckNumberOfProcessesOnLoad(true);
+    ArchiveLocationInfo::SetStateVariablesInSeparateArrays(false);
     return p_unarchived_simulation;
 }
 
@@ -51,6 +51,28 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template<class PROBLEM_CLASS>
 class CardiacSimulationArchiver
 {
+private:
+    /**
+     * Write the archive files for a simulation using the given type of Boost archive.
+     *
+     * @param rSimulationToArchive object defining the simulation to archive
+     * @param rDirectory directory where the archive files will be stored
+     */
+    template<class ARCHIVE>
+    static void SaveArchive(PROBLEM_CLASS& rSimulationToArchive, const FileFinder& rDirectory);
+
+    /**
+     * Load a simulation from archive files written with the given type of Boost archive,
+     * merging in the process-specific archives of every process that saved it.
+     *
+     * @param rDirectory directory where the archive files are located
+     * @param numProcs number of processes the simulation was saved on
+     * @param archiveVersion version of the archive, from the information file
+     * @return a pointer to the unarchived cardiac problem class
+     */
+    template<class ARCHIVE>
+    static PROBLEM_CLASS* LoadArchive(const FileFinder& rDirectory, unsigned numProcs, unsigned archiveVersion);
+
 public:
     /**
      * Archives a simulation in the directory specified.
@@ -61,8 +83,16 @@ public:
      * @param rDirectory directory where the multiple files defining the checkpoint will be stored
      *     (relative to CHASTE_TEST_OUTPUT)
      * @param clearDirectory whether the directory needs to be cleared or not.
+     * @param binaryArchive whether to write a binary checkpoint rather than text archives.
+     *     The common and process-specific archives are then Boost binary archives, which hold
+     *     just the object graph: the state variables of all the cells on each process are written
+     *     as a single raw array of doubles, in the file cell_state_variables.raw.<rank>.  (The
+     *     solution is always written to HDF5, and the mesh permutation becomes a raw array in the
+     *     binary common archive.)  Binary checkpoints can only be loaded on a machine with the same
+     *     architecture and Boost version.  The format is recorded in the information file, so Load()
+     *     handles either kind, on any number of processes.
      */
-    static void Save(PROBLEM_CLASS& rSimulationToArchive, const std::string& rDirectory, bool clearDirectory=true);
+    static void Save(PROBLEM_CLASS& rSimulationToArchive, const std::string& rDirectory, bool clearDirectory=true, bool binaryArchive=false);
 
 
     /**
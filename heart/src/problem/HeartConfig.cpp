@@ -205,8 +205,14 @@ HeartConfig* HeartConfig::Instance()
 HeartConfig::HeartConfig()
     : mUseMassLumping(false),
       mUseMassLumpingForPrecond(false),
+      mUseMatrixFreeOperators(false),
+      mUseElementMatrixCache(false),
+      mUseCvodeWarmRestarts(false),
+      mUseCvodeBandedLinearSolver(false),
       mUseFixedNumberIterations(false),
-      mEvaluateNumItsEveryNSolves(UINT_MAX)
+      mEvaluateNumItsEveryNSolves(UINT_MAX),
+      mOutputCacheSize(0u),
+      mUseInSituPostProcessing(false)
 {
     assert(mpInstance.get() == NULL);
     mUseFixedSchemaLocation = true;
@@ -2883,6 +2889,46 @@ bool HeartConfig::GetUseMassLumpingForPrecond()
     return mUseMassLumpingForPrecond;
 }
 
+void HeartConfig::SetUseMatrixFreeOperators(bool useMatrixFree)
+{
+    mUseMatrixFreeOperators = useMatrixFree;
+}
+
+bool HeartConfig::GetUseMatrixFreeOperators()
+{
+    return mUseMatrixFreeOperators;
+}
+
+void HeartConfig::SetUseElementMatrixCache(bool useCache)
+{
+    mUseElementMatrixCache = useCache;
+}
+
+bool HeartConfig::GetUseElementMatrixCache()
+{
+    return mUseElementMatrixCache;
+}
+
+void HeartConfig::SetUseCvodeWarmRestarts(bool useWarmRestarts)
+{
+    mUseCvodeWarmRestarts = useWarmRestarts;
+}
+
+bool HeartConfig::GetUseCvodeWarmRestarts()
+{
+    return mUseCvodeWarmRestarts;
+}
+
+void HeartConfig::SetUseCvodeBandedLinearSolver(bool useBanded)
+{
+    mUseCvodeBandedLinearSolver = useBanded;
+}
+
+bool HeartConfig::GetUseCvodeBandedLinearSolver()
+{
+    return mUseCvodeBandedLinearSolver;
+}
+
 void HeartConfig::SetUseReactionDiffusionOperatorSplitting(bool useOperatorSplitting)
 {
     mUseReactionDiffusionOperatorSplitting = useOperatorSplitting;
@@ -2909,6 +2955,26 @@ unsigned HeartConfig::GetEvaluateNumItsEveryNSolves()
     return mEvaluateNumItsEveryNSolves;
 }
 
+void HeartConfig::SetOutputCacheSize(unsigned numPrintingSteps)
+{
+    mOutputCacheSize = numPrintingSteps;
+}
+
+unsigned HeartConfig::GetOutputCacheSize()
+{
+    return mOutputCacheSize;
+}
+
+void HeartConfig::SetUseInSituPostProcessing(bool useInSitu)
+{
+    mUseInSituPostProcessing = useInSitu;
+}
+
+bool HeartConfig::GetUseInSituPostProcessing()
+{
+    return mUseInSituPostProcessing;
+}
+
 //
 // Purkinje methods
 //
@@ -698,6 +698,30 @@ public:
      */
     bool GetUseMassLumpingForPrecond();
 
+    /**
+     * @return whether the FE solvers apply their mass and stiffness operators element by
+     * element rather than assembling them into sparse matrices (see Set method documentation).
+     */
+    bool GetUseMatrixFreeOperators();
+
+    /**
+     * @return whether the FE solvers cache the element matrices of their system matrix
+     * (see Set method documentation).
+     */
+    bool GetUseElementMatrixCache();
+
+    /**
+     * @return whether CVODE cells in tissue simulations restart with their previous step size
+     * (see Set method documentation).
+     */
+    bool GetUseCvodeWarmRestarts();
+
+    /**
+     * @return whether CVODE cells in tissue simulations may use a banded linear solver
+     * (see Set method documentation).
+     */
+    bool GetUseCvodeBandedLinearSolver();
+
     /**
      *  @return whether to use Strang operator splitting of the reaction and diffusion terms (see
      *  Set method documentation).
@@ -714,6 +738,18 @@ public:
      */
     unsigned GetEvaluateNumItsEveryNSolves();
 
+    /**
+     *  @return the number of printing time steps of output held in memory before being written to disk
+     *  (see Set method documentation).
+     */
+    unsigned GetOutputCacheSize();
+
+    /**
+     *  @return whether activation and APD maps are calculated in situ during the solve (see
+     *  Set method documentation).
+     */
+    bool GetUseInSituPostProcessing();
+
 
     ///////////////////////////////////////////////////////////////
     //
@@ -1119,6 +1155,46 @@ public:
      */
     void SetUseMassLumpingForPrecond(bool useMassLumping = true);
 
+    /**
+     * Apply the mass and stiffness operators of the FE solvers element by element (as a
+     * PETSc shell matrix), instead of assembling and storing them as sparse matrices. This
+     * roughly halves the memory used by the monodomain solver and the bidomain right-hand
+     * side. Only the "jacobi" and "none" preconditioners may be used with a matrix-free
+     * monodomain system matrix, since no assembled matrix is available to build any other.
+     *
+     * @param useMatrixFree Whether to use matrix-free operators (defaults to true).
+     */
+    void SetUseMatrixFreeOperators(bool useMatrixFree = true);
+
+    /**
+     * Compute the element matrices of the monodomain and bidomain system matrices only once,
+     * split into the part multiplied by 1/dt and the rest, and reassemble the system matrix
+     * (e.g. after a change of time step) from these. This costs storage for two element
+     * matrices per element, and is not used if the tissue has a conductivity modifier, as
+     * the modified conductivities may change during the simulation.
+     *
+     * @param useCache Whether to cache the element matrices (defaults to true).
+     */
+    void SetUseElementMatrixCache(bool useCache = true);
+
+    /**
+     * Make CVODE cells in tissue simulations detect the change of voltage made by the PDE solve,
+     * and restart from the new state with the step size they had reached (see
+     * AbstractCvodeSystem::SetUseWarmRestarts()). By default they are set to ignore changes of
+     * state between solves, and only restart if the time is inconsistent.
+     *
+     * @param useWarmRestarts Whether to use warm restarts (defaults to true).
+     */
+    void SetUseCvodeWarmRestarts(bool useWarmRestarts = true);
+
+    /**
+     * Allow CVODE cells in tissue simulations to use a banded linear solver when their Jacobian
+     * has a narrow band (see AbstractCvodeSystem::SetUseBandedLinearSolver()).
+     *
+     * @param useBanded Whether to allow a banded linear solver (defaults to true).
+     */
+    void SetUseCvodeBandedLinearSolver(bool useBanded = true);
+
     /**
      * Use Strang operator splitting of the diffusion (conductivity) term and the reaction (ionic current) term,
      * instead of solving the full reaction-diffusion PDE. This does NOT refer to operator splitting of the
@@ -1137,6 +1213,26 @@ public:
      */
     void SetUseFixedNumberIterationsLinearSolver(bool useFixedNumberIterations = true, unsigned evaluateNumItsEveryNSolves=UINT_MAX);
 
+    /**
+     * Hold HDF5 output in memory for several printing time steps, rather than stalling every process in
+     * a collective write at each one.  The cached time steps are written in a single operation when the
+     * cache is full, and whenever the output file is closed (i.e. at the end of each call to Solve(),
+     * and hence before any checkpoint is taken).
+     *
+     * @param numPrintingSteps  the number of printing time steps to cache (0, the default, writes each one immediately)
+     */
+    void SetOutputCacheSize(unsigned numPrintingSteps);
+
+    /**
+     * Calculate the requested APD, upstroke time and max upstroke velocity maps in situ, by updating
+     * per-node accumulators at each printing time step (see InSituPostProcessingWriter), rather than
+     * by re-reading the HDF5 results file at the end of the simulation.  The maps are then written
+     * as text files in the output directory, and are produced even if no results file is written.
+     *
+     * @param useInSitu  Whether to calculate the maps in situ (defaults to true)
+     */
+    void SetUseInSituPostProcessing(bool useInSitu = true);
+
     /**
      * @return whether HeartConfig has a drug concentration and any IC50s set up
      */
@@ -1279,6 +1375,26 @@ private:
      */
     bool mUseMassLumpingForPrecond;
 
+    /**
+     * Flag telling whether to apply the FE operators matrix-free or not.
+     */
+    bool mUseMatrixFreeOperators;
+
+    /**
+     * Flag telling whether to cache the element matrices of the system matrix or not.
+     */
+    bool mUseElementMatrixCache;
+
+    /**
+     * Flag telling whether CVODE cells in tissue use warm restarts or not.
+     */
+    bool mUseCvodeWarmRestarts;
+
+    /**
+     * Flag telling whether CVODE cells in tissue may use a banded linear solver or not.
+     */
+    bool mUseCvodeBandedLinearSolver;
+
     /**
      *  @return whether to use Strang operator splitting of the diffusion and reaction terms (see
      *  Set method documentation).
@@ -1312,6 +1428,16 @@ private:
      */
     unsigned mEvaluateNumItsEveryNSolves;
 
+    /**
+     * The number of printing time steps of output to hold in memory before writing to disk.
+     */
+    unsigned mOutputCacheSize;
+
+    /**
+     * Whether to calculate postprocessing maps in situ during the solve.
+     */
+    bool mUseInSituPostProcessing;
+
     /**
      * CheckSimulationIsDefined is a convenience method for checking if the "<"Simulation">" element
      * has been defined and therefore is safe to use the Simulation().get() pointer to access
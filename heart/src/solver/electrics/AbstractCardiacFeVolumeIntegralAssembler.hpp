@@ -37,12 +37,23 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ABSTRACTCARDIACFEVOLUMEINTEGRALASSEMBLER_HPP_
 #define ABSTRACTCARDIACFEVOLUMEINTEGRALASSEMBLER_HPP_
 
+#include <algorithm>
+#include <vector>
+
 #include "AbstractFeVolumeIntegralAssembler.hpp"
 #include "HeartConfig.hpp"
 #include "AbstractCardiacTissue.hpp"
+#include "PdeSimulationTime.hpp"
 
 /**
  *  Simple implementation of AbstractFeVolumeIntegralAssembler which provides access to a cardiac tissue
+ *
+ *  The element matrices of the cardiac matrix assemblers have the form (1/dt) A_e + B_e, where
+ *  A_e and B_e only depend on the element geometry and the conductivities. Concrete classes
+ *  which get 1/dt from GetPdeTimeStepInverse() (rather than from PdeSimulationTime directly)
+ *  can have A_e and B_e computed once for each element by BuildElementMatrixCache(), after
+ *  which reassembling the matrix (e.g. when dt changes) just combines the cached matrices,
+ *  without recomputing any Jacobians, basis gradients or conductivity tensors.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX, InterpolationLevel INTERPOLATION_LEVEL>
 class AbstractCardiacFeVolumeIntegralAssembler
@@ -55,6 +66,80 @@ protected:
     /** Local cache of the configuration singleton pointer*/
     HeartConfig* mpConfig;
 
+    /** Whether BuildElementMatrixCache() has been called (and the cache not cleared since). */
+    bool mElementMatrixCacheBuilt;
+
+    /**
+     * The value returned by GetPdeTimeStepInverse() while the cache is being built, or
+     * a negative number when the cache is not being built.
+     */
+    double mTimeStepInverseForCache;
+
+    /** The lowest index of an element with cached matrices. */
+    unsigned mFirstCachedElementIndex;
+
+    /**
+     * The index into the cached matrices of each element the assembler is used on, stored at
+     * the element's index less #mFirstCachedElementIndex (UNSIGNED_UNSET for elements without
+     * cached matrices), so that it only spans the indices of the elements this process assembles on.
+     */
+    std::vector<unsigned> mElementMatrixCacheIndices;
+
+    /** The part of each cached element matrix which is multiplied by 1/dt. */
+    std::vector<c_matrix<double, PROBLEM_DIM*(ELEMENT_DIM+1), PROBLEM_DIM*(ELEMENT_DIM+1)> > mCachedTimeStepElementMatrices;
+
+    /** The part of each cached element matrix which does not depend on dt. */
+    std::vector<c_matrix<double, PROBLEM_DIM*(ELEMENT_DIM+1), PROBLEM_DIM*(ELEMENT_DIM+1)> > mCachedConstantElementMatrices;
+
+    /**
+     * @return the inverse of the PDE time step to be used in ComputeMatrixTerm(). This is
+     * the value in PdeSimulationTime, except while BuildElementMatrixCache() is running.
+     */
+    double GetPdeTimeStepInverse()
+    {
+        if (mTimeStepInverseForCache >= 0.0)
+        {
+            return mTimeStepInverseForCache;
+        }
+        return PdeSimulationTime::GetPdeTimeStepInverse();
+    }
+
+    /**
+     * Overridden AssembleOnElement() method, which uses the cached element matrices (if
+     * they have been built) when only the matrix is being assembled.
+     *
+     * @param rElement The element to assemble on.
+     * @param rAElem The element's contribution to the LHS matrix.
+     * @param rBElem The element's contribution to the RHS vector.
+     */
+    void AssembleOnElement(Element<ELEMENT_DIM,SPACE_DIM>& rElement,
+                           c_matrix<double, PROBLEM_DIM*(ELEMENT_DIM+1), PROBLEM_DIM*(ELEMENT_DIM+1) >& rAElem,
+                           c_vector<double, PROBLEM_DIM*(ELEMENT_DIM+1)>& rBElem)
+    {
+        if (!mElementMatrixCacheBuilt || this->mAssembleVector)
+        {
+            AbstractFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX,INTERPOLATION_LEVEL>::AssembleOnElement(rElement, rAElem, rBElem);
+            return;
+        }
+
+        assert(rElement.GetIndex() - mFirstCachedElementIndex < mElementMatrixCacheIndices.size());
+        const unsigned cache_index = mElementMatrixCacheIndices[rElement.GetIndex() - mFirstCachedElementIndex];
+        assert(cache_index != UNSIGNED_UNSET);
+        noalias(rAElem) = PdeSimulationTime::GetPdeTimeStepInverse()*mCachedTimeStepElementMatrices[cache_index]
+                          + mCachedConstantElementMatrices[cache_index];
+    }
+
+    /**
+     * Overridden CanAssembleConcurrently() method.
+     *
+     * @return false if the tissue has a conductivity modifier, since modified
+     * conductivity tensors are cached in the modifier.
+     */
+    bool CanAssembleConcurrently()
+    {
+        return !mpCardiacTissue->HasConductivityModifier();
+    }
+
 public:
 
     /**
@@ -66,10 +151,97 @@ public:
                                              AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* pTissue)
         : AbstractFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX,INTERPOLATION_LEVEL>(pMesh),
           mpCardiacTissue(pTissue),
-          mpConfig(HeartConfig::Instance())
+          mpConfig(HeartConfig::Instance()),
+          mElementMatrixCacheBuilt(false),
+          mTimeStepInverseForCache(-1.0),
+          mFirstCachedElementIndex(0)
     {
         assert(pTissue);
     }
+
+    /**
+     * Compute and store the two parts of the element matrix of each element this process
+     * assembles on. Until ClearElementMatrixCache() is called, AssembleMatrix() then uses
+     * the stored matrices, so this must only be used if the mesh and conductivities do not
+     * change.
+     */
+    void BuildElementMatrixCache()
+    {
+        ClearElementMatrixCache();
+
+        bool assemble_matrix = this->mAssembleMatrix;
+        bool assemble_vector = this->mAssembleVector;
+        this->mAssembleMatrix = true;
+        this->mAssembleVector = false;
+
+        c_matrix<double, PROBLEM_DIM*(ELEMENT_DIM+1), PROBLEM_DIM*(ELEMENT_DIM+1)> a_elem;
+        c_vector<double, PROBLEM_DIM*(ELEMENT_DIM+1)> b_elem;
+
+        // Find the range of indices of the elements to cache
+        std::vector<unsigned> cached_element_indices;
+        for (typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ElementIterator iter = this->mpMesh->GetElementIteratorBegin();
+             iter != this->mpMesh->GetElementIteratorEnd();
+             ++iter)
+        {
+            if (iter->GetOwnership() == true && this->ElementAssemblyCriterion(*iter) == true)
+            {
+                cached_element_indices.push_back(iter->GetIndex());
+            }
+        }
+        if (!cached_element_indices.empty())
+        {
+            mFirstCachedElementIndex = *std::min_element(cached_element_indices.begin(), cached_element_indices.end());
+            unsigned last_index = *std::max_element(cached_element_indices.begin(), cached_element_indices.end());
+            mElementMatrixCacheIndices.assign(last_index - mFirstCachedElementIndex + 1, UNSIGNED_UNSET);
+        }
+        mCachedConstantElementMatrices.reserve(cached_element_indices.size());
+        mCachedTimeStepElementMatrices.reserve(cached_element_indices.size());
+
+        for (typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ElementIterator iter = this->mpMesh->GetElementIteratorBegin();
+             iter != this->mpMesh->GetElementIteratorEnd();
+             ++iter)
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>& r_element = *iter;
+            if (r_element.GetOwnership() == true && this->ElementAssemblyCriterion(r_element) == true)
+            {
+                // The element matrix is affine in 1/dt, so evaluate it at 1/dt = 0 and 1
+                mTimeStepInverseForCache = 0.0;
+                AbstractFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX,INTERPOLATION_LEVEL>::AssembleOnElement(r_element, a_elem, b_elem);
+                mCachedConstantElementMatrices.push_back(a_elem);
+
+                mTimeStepInverseForCache = 1.0;
+                AbstractFeVolumeIntegralAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX,INTERPOLATION_LEVEL>::AssembleOnElement(r_element, a_elem, b_elem);
+                mCachedTimeStepElementMatrices.push_back(a_elem - mCachedConstantElementMatrices.back());
+
+                mElementMatrixCacheIndices[r_element.GetIndex() - mFirstCachedElementIndex] = mCachedConstantElementMatrices.size() - 1;
+            }
+        }
+
+        mTimeStepInverseForCache = -1.0;
+        this->mAssembleMatrix = assemble_matrix;
+        this->mAssembleVector = assemble_vector;
+        mElementMatrixCacheBuilt = true;
+    }
+
+    /**
+     * Free the cached element matrices, so that the matrix is assembled from scratch again.
+     */
+    void ClearElementMatrixCache()
+    {
+        mElementMatrixCacheBuilt = false;
+        mFirstCachedElementIndex = 0;
+        mElementMatrixCacheIndices.clear();
+        mCachedTimeStepElementMatrices.clear();
+        mCachedConstantElementMatrices.clear();
+    }
+
+    /**
+     * @return whether the cached element matrices are in use
+     */
+    bool IsElementMatrixCacheBuilt()
+    {
+        return mElementMatrixCacheBuilt;
+    }
 };
 
 #endif /*ABSTRACTCARDIACFEVOLUMEINTEGRALASSEMBLER_HPP_*/
@@ -89,7 +89,7 @@ void AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::Increme
 {
     // interpolate ionic current
     unsigned node_global_index = pNode->GetIndex();
-    mIionicInterp  += phiI * this->mpCardiacTissue->rGetIionicCacheReplicated()[ node_global_index ];
+    mIionicInterp  += phiI * this->mpCardiacTissue->GetIionicCacheValue(node_global_index);
     // and state variables
     std::vector<double> state_vars = this->mpCardiacTissue->GetCardiacCellOrHaloCell(node_global_index)->GetStdVecStateVariables();
     for (unsigned i=0; i<mStateVariablesAtQuadPoint.size(); i++)
@@ -111,22 +111,26 @@ bool AbstractCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM>::Element
     double DELTA_IIONIC = 1; // tolerance
 
     //The criterion and the correction both need the ionic cache, so we better make sure that it's up-to-date
-    assert(this->mpCardiacTissue->GetDoCacheReplication());
-    ReplicatableVector& r_cache = this->mpCardiacTissue->rGetIionicCacheReplicated();
+    assert(this->mpCardiacTissue->GetDoCacheReplication() || this->mpCardiacTissue->GetUseDistributedCaches());
+    c_vector<double, ELEMENT_DIM+1> iionic;
+    for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+    {
+        iionic[i] = this->mpCardiacTissue->GetIionicCacheValue(rElement.GetNodeGlobalIndex(i));
+    }
 
-    double diionic = fabs(r_cache[rElement.GetNodeGlobalIndex(0)] - r_cache[rElement.GetNodeGlobalIndex(1)]);
+    double diionic = fabs(iionic[0] - iionic[1]);
 
     if (ELEMENT_DIM > 1)
     {
-        diionic = std::max(diionic, fabs(r_cache[rElement.GetNodeGlobalIndex(0)] - r_cache[rElement.GetNodeGlobalIndex(2)]) );
-        diionic = std::max(diionic, fabs(r_cache[rElement.GetNodeGlobalIndex(1)] - r_cache[rElement.GetNodeGlobalIndex(2)]) );
+        diionic = std::max(diionic, fabs(iionic[0] - iionic[2]) );
+        diionic = std::max(diionic, fabs(iionic[1] - iionic[2]) );
     }
 
     if (ELEMENT_DIM > 2)
     {
-        diionic = std::max(diionic, fabs(r_cache[rElement.GetNodeGlobalIndex(0)] - r_cache[rElement.GetNodeGlobalIndex(3)]) );
-        diionic = std::max(diionic, fabs(r_cache[rElement.GetNodeGlobalIndex(1)] - r_cache[rElement.GetNodeGlobalIndex(3)]) );
-        diionic = std::max(diionic, fabs(r_cache[rElement.GetNodeGlobalIndex(2)] - r_cache[rElement.GetNodeGlobalIndex(3)]) );
+        diionic = std::max(diionic, fabs(iionic[0] - iionic[3]) );
+        diionic = std::max(diionic, fabs(iionic[1] - iionic[3]) );
+        diionic = std::max(diionic, fabs(iionic[2] - iionic[3]) );
     }
 
     bool will_assemble = (diionic > DELTA_IIONIC);
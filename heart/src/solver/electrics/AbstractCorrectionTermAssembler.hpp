@@ -76,6 +76,16 @@ protected:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<SPACE_DIM>* pNode);
 
+    /**
+     * Overridden CanAssembleConcurrently() method.
+     *
+     * @return false, since the state variables and ionic current are interpolated into member variables.
+     */
+    bool CanAssembleConcurrently()
+    {
+        return false;
+    }
+
     /**
      * @return true if we should assemble the correction term for this element.
      * Checks if there is a sufficiently steep ionic current gradient to make the expense worthwhile, by checking
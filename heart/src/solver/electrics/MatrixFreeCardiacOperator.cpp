@@ -0,0 +1,348 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "MatrixFreeCardiacOperator.hpp"
+
+#include <map>
+#include "HeartRegionCodes.hpp"
+#include "PetscTools.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::MatrixFreeCardiacOperator(
+        AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
+        AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
+        unsigned problemDim,
+        bool useMassLumping,
+        bool skipBathElements)
+    : mpMesh(pMesh),
+      mpTissue(pTissue),
+      mProblemDim(problemDim),
+      mUseMassLumping(useMassLumping)
+{
+    assert(pMesh);
+    assert(problemDim > 0);
+
+    DistributedVectorFactory* p_factory = mpMesh->GetDistributedVectorFactory();
+    unsigned lo = p_factory->GetLow();
+    unsigned hi = p_factory->GetHigh();
+
+    // Work out which elements this process applies the operator on, and the (possibly halo)
+    // vector entries needed to do so
+    std::map<unsigned, PetscInt> halo_index_of_node;
+    std::vector<PetscInt> halo_vector_entries;
+    for (typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ElementIterator iter = mpMesh->GetElementIteratorBegin();
+         iter != mpMesh->GetElementIteratorEnd();
+         ++iter)
+    {
+        Element<ELEMENT_DIM, SPACE_DIM>& r_element = *iter;
+        if (!r_element.GetOwnership()
+            || (skipBathElements && HeartRegionCode::IsRegionBath(r_element.GetUnsignedAttribute())))
+        {
+            continue;
+        }
+
+        mElementIndices.push_back(r_element.GetIndex());
+        for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+        {
+            unsigned node_index = r_element.GetNodeGlobalIndex(i);
+
+            std::map<unsigned, PetscInt>::iterator it = halo_index_of_node.find(node_index);
+            if (it == halo_index_of_node.end())
+            {
+                it = halo_index_of_node.insert(std::make_pair(node_index, (PetscInt)halo_vector_entries.size())).first;
+                halo_vector_entries.push_back(node_index*mProblemDim);
+            }
+            mElementHaloIndices.push_back(it->second);
+
+            if (node_index >= lo && node_index < hi)
+            {
+                mElementLocalRows.push_back((node_index-lo)*mProblemDim);
+            }
+            else
+            {
+                mElementLocalRows.push_back(-1);
+            }
+        }
+    }
+
+    // Set up the scatter into the halo vector
+    Vec template_vec = p_factory->CreateVec(mProblemDim);
+    VecCreateSeq(PETSC_COMM_SELF, halo_vector_entries.size(), &mHaloValues);
+
+    IS halo_entries;
+    PetscInt* p_entries = halo_vector_entries.empty() ? NULL : &halo_vector_entries[0];
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR >= 2) //PETSc 3.2 or later
+    ISCreateGeneral(PETSC_COMM_SELF, halo_vector_entries.size(), p_entries, PETSC_COPY_VALUES, &halo_entries);
+#else
+    ISCreateGeneral(PETSC_COMM_SELF, halo_vector_entries.size(), p_entries, &halo_entries);
+#endif
+    VecScatterCreate(template_vec, halo_entries, mHaloValues, PETSC_NULL, &mHaloScatter);
+    ISDestroy(PETSC_DESTROY_PARAM(halo_entries));
+    PetscTools::Destroy(template_vec);
+
+    // Wrap the operator in a shell matrix
+    PetscInt local_size = (hi-lo)*mProblemDim;
+    PetscInt global_size = mpMesh->GetNumNodes()*mProblemDim;
+    MatCreateShell(PETSC_COMM_WORLD, local_size, local_size, global_size, global_size, (void*)this, &mShellMatrix);
+    MatShellSetOperation(mShellMatrix, MATOP_MULT, (void(*)(void)) &MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::ShellMult);
+    MatShellSetOperation(mShellMatrix, MATOP_GET_DIAGONAL, (void(*)(void)) &MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::ShellGetDiagonal);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::~MatrixFreeCardiacOperator()
+{
+    PetscTools::Destroy(mShellMatrix);
+    PetscTools::Destroy(mHaloValues);
+    VecScatterDestroy(PETSC_DESTROY_PARAM(mHaloScatter));
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::ComputeElementFactors(double massScaleFactor)
+{
+    // The volume of the reference element is 1/ELEMENT_DIM!
+    double reference_volume = 1.0;
+    for (unsigned i=2; i<=ELEMENT_DIM; i++)
+    {
+        reference_volume /= i;
+    }
+
+    mScaledElementVolumes.resize(mElementIndices.size());
+    mElementStiffnessFactors.resize(mpTissue ? mElementIndices.size() : 0u);
+
+    c_matrix<double, SPACE_DIM, ELEMENT_DIM> jacobian;
+    c_matrix<double, ELEMENT_DIM, SPACE_DIM> inverse_jacobian;
+    double jacobian_determinant;
+
+    for (unsigned i=0; i<mElementIndices.size(); i++)
+    {
+        mpMesh->GetInverseJacobianForElement(mElementIndices[i], jacobian, jacobian_determinant, inverse_jacobian);
+        double volume = reference_volume*jacobian_determinant;
+        mScaledElementVolumes[i] = massScaleFactor*volume;
+
+        if (mpTissue)
+        {
+            const c_matrix<double, SPACE_DIM, SPACE_DIM>& r_sigma_i = mpTissue->rGetIntracellularConductivityTensor(mElementIndices[i]);
+            c_matrix<double, ELEMENT_DIM, SPACE_DIM> temp = prod(inverse_jacobian, r_sigma_i);
+            mElementStiffnessFactors[i] = volume*prod(temp, trans(inverse_jacobian));
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::ApplyOnElement(unsigned cacheIndex,
+                                                                       const c_vector<double,ELEMENT_DIM+1>& rU,
+                                                                       c_vector<double,ELEMENT_DIM+1>& rResult)
+{
+    // Mass term: the consistent mass matrix is |e|(1+delta_ij)/((d+1)(d+2)), and
+    // lumping puts its row sums |e|/(d+1) on the diagonal
+    double scaled_volume = mScaledElementVolumes[cacheIndex];
+    if (mUseMassLumping)
+    {
+        rResult = (scaled_volume/(ELEMENT_DIM+1))*rU;
+    }
+    else
+    {
+        double sum_u = 0.0;
+        for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+        {
+            sum_u += rU(i);
+        }
+        double factor = scaled_volume/((ELEMENT_DIM+1)*(ELEMENT_DIM+2));
+        for (unsigned i=0; i<ELEMENT_DIM+1; i++)
+        {
+            rResult(i) = factor*(sum_u + rU(i));
+        }
+    }
+
+    // Stiffness term: the reference basis gradients are -1 (in every direction) for node 0
+    // and the unit vectors for the other nodes, so grad_phi^T D grad_phi u reduces to
+    // applying D to the differences u_i - u_0
+    if (mpTissue)
+    {
+        c_vector<double, ELEMENT_DIM> reference_grad_u;
+        for (unsigned i=0; i<ELEMENT_DIM; i++)
+        {
+            reference_grad_u(i) = rU(i+1) - rU(0);
+        }
+        c_vector<double, ELEMENT_DIM> flux = prod(mElementStiffnessFactors[cacheIndex], reference_grad_u);
+        for (unsigned i=0; i<ELEMENT_DIM; i++)
+        {
+            rResult(0) -= flux(i);
+            rResult(i+1) += flux(i);
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::Apply(Vec x, Vec y)
+{
+    assert(mScaledElementVolumes.size() == mElementIndices.size()); // ComputeElementFactors() must have been called
+
+//PETSc-3.x.x or PETSc-2.3.3
+#if ( (PETSC_VERSION_MAJOR == 3) || (PETSC_VERSION_MAJOR == 2 && PETSC_VERSION_MINOR == 3 && PETSC_VERSION_SUBMINOR == 3)) //2.3.3 or 3.x.x
+    VecScatterBegin(mHaloScatter, x, mHaloValues, INSERT_VALUES, SCATTER_FORWARD);
+    VecScatterEnd  (mHaloScatter, x, mHaloValues, INSERT_VALUES, SCATTER_FORWARD);
+#else
+//PETSc-2.3.2 or previous
+    VecScatterBegin(x, mHaloValues, INSERT_VALUES, SCATTER_FORWARD, mHaloScatter);
+    VecScatterEnd  (x, mHaloValues, INSERT_VALUES, SCATTER_FORWARD, mHaloScatter);
+#endif
+
+    double* p_halo_values;
+    double* p_y;
+    PetscInt local_size;
+    VecGetArray(mHaloValues, &p_halo_values);
+    VecGetArray(y, &p_y);
+    VecGetLocalSize(y, &local_size);
+
+    for (PetscInt row=0; row<local_size; row++)
+    {
+        p_y[row] = 0.0;
+    }
+
+    c_vector<double, ELEMENT_DIM+1> u;
+    c_vector<double, ELEMENT_DIM+1> result;
+    for (unsigned i=0; i<mElementIndices.size(); i++)
+    {
+        const unsigned offset = i*(ELEMENT_DIM+1);
+        for (unsigned j=0; j<ELEMENT_DIM+1; j++)
+        {
+            u(j) = p_halo_values[mElementHaloIndices[offset+j]];
+        }
+
+        ApplyOnElement(i, u, result);
+
+        for (unsigned j=0; j<ELEMENT_DIM+1; j++)
+        {
+            PetscInt row = mElementLocalRows[offset+j];
+            if (row >= 0)
+            {
+                p_y[row] += result(j);
+            }
+        }
+    }
+
+    VecRestoreArray(y, &p_y);
+    VecRestoreArray(mHaloValues, &p_halo_values);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::GetDiagonal(Vec diagonal)
+{
+    assert(mScaledElementVolumes.size() == mElementIndices.size()); // ComputeElementFactors() must have been called
+
+    double* p_diagonal;
+    PetscInt local_size;
+    VecGetArray(diagonal, &p_diagonal);
+    VecGetLocalSize(diagonal, &local_size);
+
+    for (PetscInt row=0; row<local_size; row++)
+    {
+        p_diagonal[row] = 0.0;
+    }
+
+    double mass_factor = mUseMassLumping ? 1.0/(ELEMENT_DIM+1) : 2.0/((ELEMENT_DIM+1)*(ELEMENT_DIM+2));
+    for (unsigned i=0; i<mElementIndices.size(); i++)
+    {
+        c_vector<double, ELEMENT_DIM+1> element_diagonal;
+        for (unsigned j=0; j<ELEMENT_DIM+1; j++)
+        {
+            element_diagonal(j) = mass_factor*mScaledElementVolumes[i];
+        }
+
+        if (mpTissue)
+        {
+            const c_matrix<double, ELEMENT_DIM, ELEMENT_DIM>& r_factors = mElementStiffnessFactors[i];
+            for (unsigned j=0; j<ELEMENT_DIM; j++)
+            {
+                for (unsigned k=0; k<ELEMENT_DIM; k++)
+                {
+                    element_diagonal(0) += r_factors(j,k);
+                }
+                element_diagonal(j+1) += r_factors(j,j);
+            }
+        }
+
+        const unsigned offset = i*(ELEMENT_DIM+1);
+        for (unsigned j=0; j<ELEMENT_DIM+1; j++)
+        {
+            PetscInt row = mElementLocalRows[offset+j];
+            if (row >= 0)
+            {
+                p_diagonal[row] += element_diagonal(j);
+            }
+        }
+    }
+
+    VecRestoreArray(diagonal, &p_diagonal);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+Mat MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::GetMatrix()
+{
+    return mShellMatrix;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+PetscErrorCode MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::ShellMult(Mat matrix, Vec x, Vec y)
+{
+    MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>* p_operator;
+    MatShellGetContext(matrix, (void**)&p_operator);
+    assert(p_operator != NULL);
+
+    p_operator->Apply(x, y);
+    return 0;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+PetscErrorCode MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>::ShellGetDiagonal(Mat matrix, Vec diagonal)
+{
+    MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>* p_operator;
+    MatShellGetContext(matrix, (void**)&p_operator);
+    assert(p_operator != NULL);
+
+    p_operator->GetDiagonal(diagonal);
+    return 0;
+}
+
+///////////////////////////////////////////////////////
+// explicit instantiation
+///////////////////////////////////////////////////////
+
+template class MatrixFreeCardiacOperator<1,1>;
+template class MatrixFreeCardiacOperator<1,2>;
+template class MatrixFreeCardiacOperator<1,3>;
+template class MatrixFreeCardiacOperator<2,2>;
+template class MatrixFreeCardiacOperator<3,3>;
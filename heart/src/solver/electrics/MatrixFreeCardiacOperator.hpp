@@ -0,0 +1,210 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef MATRIXFREECARDIACOPERATOR_HPP_
+#define MATRIXFREECARDIACOPERATOR_HPP_
+
+#include <vector>
+#include <petscvec.h>
+#include <petscmat.h>
+
+#include "UblasIncludes.hpp"
+#include "AbstractTetrahedralMesh.hpp"
+#include "AbstractCardiacTissue.hpp"
+
+/**
+ *  Applies the linear FE operator
+ *
+ *  A = alpha M + K
+ *
+ *  without assembling it, where M is the (optionally lumped) mass matrix, K the
+ *  intracellular stiffness matrix (omitted if no tissue is given) and alpha a scale
+ *  factor (e.g. chi*C/dt for the monodomain system matrix).
+ *
+ *  For linear simplices the basis gradients are constant on each element, so all the
+ *  operator needs per element is its volume and the matrix
+ *
+ *  D = |e| J^{-1} sigma_i J^{-T}
+ *
+ *  which are computed once by ComputeElementFactors() (when the assembled matrices would
+ *  otherwise have been assembled). A matrix-vector product then gathers the values at
+ *  the nodes of the locally owned elements through a VecScatter and adds each element's
+ *  contribution to the locally owned rows, which costs a small multiple of the work of
+ *  a sparse matrix-vector product but stores O(#elements) numbers instead of
+ *  O(#nonzeros).
+ *
+ *  The operator is exposed as a PETSc shell matrix (see GetMatrix()) implementing
+ *  MatMult and MatGetDiagonal, so it can be used by LinearSystem with the "jacobi"
+ *  (or "none") preconditioner.
+ *
+ *  The operator can act on one component of an interleaved multi-variable vector (e.g.
+ *  the voltage in [V_1, phi_e_1, ..., V_n, phi_e_n]), giving zero in the rows of the
+ *  other components. This reproduces the bidomain mass matrix, for which bath elements
+ *  can also be skipped.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class MatrixFreeCardiacOperator
+{
+private:
+
+    /** The mesh. */
+    AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* mpMesh;
+
+    /** The tissue providing the intracellular conductivities, or NULL for a pure mass operator. */
+    AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* mpTissue;
+
+    /** The number of interleaved variables in the vectors the operator acts on. */
+    unsigned mProblemDim;
+
+    /** Whether to apply the lumped mass matrix rather than the consistent one. */
+    bool mUseMassLumping;
+
+    /** Global indices of the locally owned elements the operator is applied on. */
+    std::vector<unsigned> mElementIndices;
+
+    /**
+     * Index into the halo vector of the value at each node of each element in
+     * mElementIndices, (ELEMENT_DIM+1) entries per element.
+     */
+    std::vector<PetscInt> mElementHaloIndices;
+
+    /**
+     * Local row (in the distributed vectors) of each node of each element in
+     * mElementIndices, or -1 if the node is not owned by this process.
+     */
+    std::vector<PetscInt> mElementLocalRows;
+
+    /** The mass scale factor alpha times the volume of each element in mElementIndices. */
+    std::vector<double> mScaledElementVolumes;
+
+    /** The matrix D of each element in mElementIndices (empty if there is no stiffness term). */
+    std::vector<c_matrix<double,ELEMENT_DIM,ELEMENT_DIM> > mElementStiffnessFactors;
+
+    /** Sequential vector holding the values at the nodes of all elements in mElementIndices. */
+    Vec mHaloValues;
+
+    /** Scatter from a distributed vector to mHaloValues. */
+    VecScatter mHaloScatter;
+
+    /** The shell matrix wrapping this operator. */
+    Mat mShellMatrix;
+
+    /**
+     * Compute the contribution of one element to y = Ax.
+     *
+     * @param cacheIndex  the index of the element in mElementIndices
+     * @param rU  the values of x at the nodes of the element
+     * @param rResult  filled in with the contribution to y at the nodes of the element
+     */
+    void ApplyOnElement(unsigned cacheIndex,
+                        const c_vector<double,ELEMENT_DIM+1>& rU,
+                        c_vector<double,ELEMENT_DIM+1>& rResult);
+
+public:
+
+    /**
+     * Constructor. Works out the elements and halo values needed by this process.
+     *
+     * @param pMesh  the mesh
+     * @param pTissue  the tissue providing the intracellular conductivities, or NULL to apply
+     *     the mass matrix only
+     * @param problemDim  the number of interleaved variables in the vectors acted on (the
+     *     operator acts on the first)
+     * @param useMassLumping  whether to apply the lumped mass matrix
+     * @param skipBathElements  whether to leave out bath elements (as the bidomain mass
+     *     matrix does)
+     */
+    MatrixFreeCardiacOperator(AbstractTetrahedralMesh<ELEMENT_DIM,SPACE_DIM>* pMesh,
+                              AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>* pTissue,
+                              unsigned problemDim,
+                              bool useMassLumping,
+                              bool skipBathElements=false);
+
+    /**
+     * Destructor. Destroys the shell matrix.
+     */
+    ~MatrixFreeCardiacOperator();
+
+    /**
+     * (Re)compute the cached element volumes and stiffness factors. This replaces assembling
+     * the matrix, and must be called before the operator is applied and whenever the mass
+     * scale factor or the conductivities change.
+     *
+     * @param massScaleFactor  the factor alpha multiplying the mass matrix
+     */
+    void ComputeElementFactors(double massScaleFactor=1.0);
+
+    /**
+     * Compute y = Ax.
+     *
+     * @param x  the distributed vector to apply the operator to
+     * @param y  the distributed vector to put the result in (same layout as x)
+     */
+    void Apply(Vec x, Vec y);
+
+    /**
+     * Get the diagonal of A, e.g. for Jacobi preconditioning.
+     *
+     * @param diagonal  the distributed vector to put the diagonal in
+     */
+    void GetDiagonal(Vec diagonal);
+
+    /**
+     * @return the PETSc shell matrix wrapping this operator. It is destroyed with the
+     * operator, so should not be destroyed by the caller.
+     */
+    Mat GetMatrix();
+
+    /**
+     * MatMult callback for the shell matrix.
+     *
+     * @param matrix  the shell matrix, whose context is the operator
+     * @param x  the vector to multiply
+     * @param y  the result
+     * @return the PETSc error code (always 0)
+     */
+    static PetscErrorCode ShellMult(Mat matrix, Vec x, Vec y);
+
+    /**
+     * MatGetDiagonal callback for the shell matrix.
+     *
+     * @param matrix  the shell matrix, whose context is the operator
+     * @param diagonal  the vector to put the diagonal in
+     * @return the PETSc error code (always 0)
+     */
+    static PetscErrorCode ShellGetDiagonal(Mat matrix, Vec diagonal);
+};
+
+#endif /*MATRIXFREECARDIACOPERATOR_HPP_*/
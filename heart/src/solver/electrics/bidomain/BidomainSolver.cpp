@@ -56,9 +56,19 @@ void BidomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSoluti
     PetscInt ownership_range_hi;
     VecGetOwnershipRange(r_template, &ownership_range_lo, &ownership_range_hi);
     PetscInt local_size = ownership_range_hi - ownership_range_lo;
-    PetscTools::SetupMat(mMassMatrix, 2*this->mpMesh->GetNumNodes(), 2*this->mpMesh->GetNumNodes(),
-                         2*this->mpMesh->CalculateMaximumNodeConnectivityPerProcess(),
-                         local_size, local_size);
+
+    if (HeartConfig::Instance()->GetUseMatrixFreeOperators())
+    {
+        // Consistent mass matrix in the voltage-voltage block only, bath elements excluded,
+        // as assembled by the BidomainMassMatrixAssembler
+        mpMatrixFreeMassOperator = new MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>(this->mpMesh, NULL, 2, false, true);
+    }
+    else
+    {
+        PetscTools::SetupMat(mMassMatrix, 2*this->mpMesh->GetNumNodes(), 2*this->mpMesh->GetNumNodes(),
+                             2*this->mpMesh->CalculateMaximumNodeConnectivityPerProcess(),
+                             local_size, local_size);
+    }
 }
 
 
@@ -77,18 +87,35 @@ void BidomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(
     /////////////////////////////////////////
     if (computeMatrix)
     {
+        if (HeartConfig::Instance()->GetUseElementMatrixCache()
+            && !mpBidomainAssembler->IsElementMatrixCacheBuilt()
+            && !this->mpBidomainTissue->HasConductivityModifier())
+        {
+            HeartEventHandler::BeginEvent(HeartEventHandler::ASSEMBLE_SYSTEM);
+            mpBidomainAssembler->BuildElementMatrixCache();
+            HeartEventHandler::EndEvent(HeartEventHandler::ASSEMBLE_SYSTEM);
+        }
+
         mpBidomainAssembler->SetMatrixToAssemble(this->mpLinearSystem->rGetLhsMatrix());
         mpBidomainAssembler->AssembleMatrix();
 
-        // the BidomainMassMatrixAssembler deals with the mass matrix
-        // for both bath and nonbath problems
-        assert(SPACE_DIM==ELEMENT_DIM);
-        BidomainMassMatrixAssembler<SPACE_DIM> mass_matrix_assembler(this->mpMesh);
-        mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix);
-        mass_matrix_assembler.Assemble();
-
-        this->mpLinearSystem->SwitchWriteModeLhsMatrix();
-        PetscMatTools::Finalise(mMassMatrix);
+        if (mpMatrixFreeMassOperator)
+        {
+            mpMatrixFreeMassOperator->ComputeElementFactors();
+            this->mpLinearSystem->SwitchWriteModeLhsMatrix();
+        }
+        else
+        {
+            // the BidomainMassMatrixAssembler deals with the mass matrix
+            // for both bath and nonbath problems
+            assert(SPACE_DIM==ELEMENT_DIM);
+            BidomainMassMatrixAssembler<SPACE_DIM> mass_matrix_assembler(this->mpMesh);
+            mass_matrix_assembler.SetMatrixToAssemble(mMassMatrix);
+            mass_matrix_assembler.Assemble();
+
+            this->mpLinearSystem->SwitchWriteModeLhsMatrix();
+            PetscMatTools::Finalise(mMassMatrix);
+        }
     }
 
 
@@ -118,8 +145,8 @@ void BidomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(
              ++index)
         {
             double V = distributed_current_solution_vm[index];
-            double F = - Am*this->mpBidomainTissue->rGetIionicCacheReplicated()[index.Global]
-                       - this->mpBidomainTissue->rGetIntracellularStimulusCacheReplicated()[index.Global];
+            double F = - Am*this->mpBidomainTissue->GetIionicCacheValue(index.Global)
+                       - this->mpBidomainTissue->GetIntracellularStimulusCacheValue(index.Global);
 
             dist_vec_matrix_based_vm[index] = Am*Cm*V*PdeSimulationTime::GetPdeTimeStepInverse() + F;
             dist_vec_matrix_based_phie[index] = 0.0;
@@ -135,8 +162,8 @@ void BidomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(
             if ( !HeartRegionCode::IsRegionBath( this->mpMesh->GetNode(index.Global)->GetRegion() ))
             {
                 double V = distributed_current_solution_vm[index];
-                double F = - Am*this->mpBidomainTissue->rGetIionicCacheReplicated()[index.Global]
-                           - this->mpBidomainTissue->rGetIntracellularStimulusCacheReplicated()[index.Global];
+                double F = - Am*this->mpBidomainTissue->GetIionicCacheValue(index.Global)
+                           - this->mpBidomainTissue->GetIntracellularStimulusCacheValue(index.Global);
 
                 dist_vec_matrix_based_vm[index] = Am*Cm*V*PdeSimulationTime::GetPdeTimeStepInverse() + F;
             }
@@ -155,7 +182,14 @@ void BidomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(
     //////////////////////////////////////////
     // b = Mz
     //////////////////////////////////////////
-    MatMult(mMassMatrix, mVecForConstructingRhs, this->mpLinearSystem->rGetRhsVector());
+    if (mpMatrixFreeMassOperator)
+    {
+        mpMatrixFreeMassOperator->Apply(mVecForConstructingRhs, this->mpLinearSystem->rGetRhsVector());
+    }
+    else
+    {
+        MatMult(mMassMatrix, mVecForConstructingRhs, this->mpLinearSystem->rGetRhsVector());
+    }
 
     // assembling RHS is not finished yet, as Neumann bcs are added below, but
     // the event will be begun again inside mpBidomainAssembler->AssembleVector();
@@ -209,6 +243,7 @@ BidomainSolver<ELEMENT_DIM,SPACE_DIM>::BidomainSolver(
     // Tell tissue there's no need to replicate ionic caches
     pTissue->SetCacheReplication(false);
     mVecForConstructingRhs = NULL;
+    mpMatrixFreeMassOperator = NULL;
 
     // create assembler
     if(bathSimulation)
@@ -227,8 +262,11 @@ BidomainSolver<ELEMENT_DIM,SPACE_DIM>::BidomainSolver(
     {
         mpBidomainCorrectionTermAssembler
             = new BidomainCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,this->mpBidomainTissue);
-        //We are going to need those caches after all
-        pTissue->SetCacheReplication(true);
+        //We are going to need those caches after all (distributed caches also hold the halo values needed)
+        if (!pTissue->GetUseDistributedCaches())
+        {
+            pTissue->SetCacheReplication(true);
+        }
     }
     else
     {
@@ -245,9 +283,14 @@ BidomainSolver<ELEMENT_DIM,SPACE_DIM>::~BidomainSolver()
     if(mVecForConstructingRhs)
     {
         PetscTools::Destroy(mVecForConstructingRhs);
-        PetscTools::Destroy(mMassMatrix);
+        if (!mpMatrixFreeMassOperator)
+        {
+            PetscTools::Destroy(mMassMatrix);
+        }
     }
 
+    delete mpMatrixFreeMassOperator;
+
     if(mpBidomainCorrectionTermAssembler)
     {
         delete mpBidomainCorrectionTermAssembler;
@@ -50,6 +50,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BidomainMassMatrixAssembler.hpp"
 #include "BidomainCorrectionTermAssembler.hpp"
 #include "BidomainNeumannSurfaceTermAssembler.hpp"
+#include "MatrixFreeCardiacOperator.hpp"
 
 #include <boost/numeric/ublas/vector_proxy.hpp>
 
@@ -77,6 +78,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  case the vector [c_correction, 0] is added to the above, and another assembler is
  *  used to create the c_correction.
  *
+ *  If HeartConfig::GetUseMatrixFreeOperators() is set, the mass matrix is not assembled
+ *  but applied element by element by a MatrixFreeCardiacOperator. The LHS matrix is
+ *  still assembled, as the Dirichlet and bath boundary conditions and the block
+ *  preconditioners need its entries.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class BidomainSolver : public AbstractBidomainSolver<ELEMENT_DIM,SPACE_DIM>
@@ -93,6 +98,9 @@ private:
      */
     Vec mVecForConstructingRhs;
 
+    /** If using matrix-free operators, applies the mass matrix (used instead of mMassMatrix) */
+    MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>* mpMatrixFreeMassOperator;
+
     /** The bidomain assembler, used to set up the LHS matrix */
     BidomainAssembler<ELEMENT_DIM,SPACE_DIM>* mpBidomainAssembler;
 
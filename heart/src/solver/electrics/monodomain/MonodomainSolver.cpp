@@ -48,8 +48,26 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
     /////////////////////////////////////////
     // set up LHS matrix (and mass matrix)
     /////////////////////////////////////////
-    if(computeMatrix)
+    if(computeMatrix && mpMatrixFreeLhsOperator)
     {
+        HeartEventHandler::BeginEvent(HeartEventHandler::ASSEMBLE_SYSTEM);
+        double Am = HeartConfig::Instance()->GetSurfaceAreaToVolumeRatio();
+        double Cm = HeartConfig::Instance()->GetCapacitance();
+        mpMatrixFreeLhsOperator->ComputeElementFactors(Am*Cm*PdeSimulationTime::GetPdeTimeStepInverse());
+        mpMatrixFreeMassOperator->ComputeElementFactors();
+        HeartEventHandler::EndEvent(HeartEventHandler::ASSEMBLE_SYSTEM);
+    }
+    else if(computeMatrix)
+    {
+        if (HeartConfig::Instance()->GetUseElementMatrixCache()
+            && !mpMonodomainAssembler->IsElementMatrixCacheBuilt()
+            && !mpMonodomainTissue->HasConductivityModifier())
+        {
+            HeartEventHandler::BeginEvent(HeartEventHandler::ASSEMBLE_SYSTEM);
+            mpMonodomainAssembler->BuildElementMatrixCache();
+            HeartEventHandler::EndEvent(HeartEventHandler::ASSEMBLE_SYSTEM);
+        }
+
         mpMonodomainAssembler->SetMatrixToAssemble(this->mpLinearSystem->rGetLhsMatrix());
         mpMonodomainAssembler->AssembleMatrix();
 
@@ -95,8 +113,8 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
          ++index)
     {
         double V = distributed_current_solution[index];
-        double F = - Am*this->mpMonodomainTissue->rGetIionicCacheReplicated()[index.Global]
-                   - this->mpMonodomainTissue->rGetIntracellularStimulusCacheReplicated()[index.Global];
+        double F = - Am*this->mpMonodomainTissue->GetIionicCacheValue(index.Global)
+                   - this->mpMonodomainTissue->GetIntracellularStimulusCacheValue(index.Global);
 
         dist_vec_matrix_based[index] = Am*Cm*V*PdeSimulationTime::GetPdeTimeStepInverse() + F;
     }
@@ -105,7 +123,14 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::SetupLinearSystem(Vec currentSolut
     //////////////////////////////////////////
     // b = Mz
     //////////////////////////////////////////
-    MatMult(mMassMatrix, mVecForConstructingRhs, this->mpLinearSystem->rGetRhsVector());
+    if (mpMatrixFreeMassOperator)
+    {
+        mpMatrixFreeMassOperator->Apply(mVecForConstructingRhs, this->mpLinearSystem->rGetRhsVector());
+    }
+    else
+    {
+        MatMult(mMassMatrix, mVecForConstructingRhs, this->mpLinearSystem->rGetRhsVector());
+    }
 
     // assembling RHS is not finished yet, as Neumann bcs are added below, but
     // the event will be begun again inside mpMonodomainAssembler->AssembleVector();
@@ -141,8 +166,30 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolu
         return;
     }
 
-    // call base class version...
-    AbstractLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>::InitialiseForSolve(initialSolution);
+    if (HeartConfig::Instance()->GetUseMatrixFreeOperators())
+    {
+        // Only Jacobi preconditioning can be done without the matrix entries
+        std::string pc_type = HeartConfig::Instance()->GetKSPPreconditioner();
+        if ((pc_type != "jacobi" && pc_type != "none") || HeartConfig::Instance()->GetUseMassLumpingForPrecond())
+        {
+            EXCEPTION("Matrix-free operators can only be used with the jacobi preconditioner (or none), and without mass lumping in the preconditioner.");
+        }
+
+        bool use_mass_lumping = HeartConfig::Instance()->GetUseMassLumping();
+        mpMatrixFreeLhsOperator = new MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>(this->mpMesh, mpMonodomainTissue, 1, use_mass_lumping);
+        mpMatrixFreeMassOperator = new MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>(this->mpMesh, NULL, 1, use_mass_lumping);
+
+        // The linear system and the operator each destroy their reference to the shell matrix
+        Mat lhs_matrix = mpMatrixFreeLhsOperator->GetMatrix();
+        PetscObjectReference((PetscObject) lhs_matrix);
+        Vec rhs_vector = this->mpMesh->GetDistributedVectorFactory()->CreateVec();
+        this->mpLinearSystem = new LinearSystem(this->mpMesh->GetNumNodes(), lhs_matrix, rhs_vector);
+    }
+    else
+    {
+        // call base class version...
+        AbstractLinearPdeSolver<ELEMENT_DIM,SPACE_DIM,1>::InitialiseForSolve(initialSolution);
+    }
 
     //..then do a bit extra
     if(HeartConfig::Instance()->GetUseAbsoluteTolerance())
@@ -167,9 +214,12 @@ void MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::InitialiseForSolve(Vec initialSolu
     PetscInt ownership_range_hi;
     VecGetOwnershipRange(r_template, &ownership_range_lo, &ownership_range_hi);
     PetscInt local_size = ownership_range_hi - ownership_range_lo;
-    PetscTools::SetupMat(mMassMatrix, this->mpMesh->GetNumNodes(), this->mpMesh->GetNumNodes(),
-                         this->mpMesh->CalculateMaximumNodeConnectivityPerProcess(),
-                         local_size, local_size);
+    if (!mpMatrixFreeMassOperator)
+    {
+        PetscTools::SetupMat(mMassMatrix, this->mpMesh->GetNumNodes(), this->mpMesh->GetNumNodes(),
+                             this->mpMesh->CalculateMaximumNodeConnectivityPerProcess(),
+                             local_size, local_size);
+    }
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -199,13 +249,18 @@ MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::MonodomainSolver(
     // Tell tissue there's no need to replicate ionic caches
     pTissue->SetCacheReplication(false);
     mVecForConstructingRhs = NULL;
+    mpMatrixFreeLhsOperator = NULL;
+    mpMatrixFreeMassOperator = NULL;
 
     if(HeartConfig::Instance()->GetUseStateVariableInterpolation())
     {
         mpMonodomainCorrectionTermAssembler
             = new MonodomainCorrectionTermAssembler<ELEMENT_DIM,SPACE_DIM>(this->mpMesh,this->mpMonodomainTissue);
-        //We are going to need those caches after all
-        pTissue->SetCacheReplication(true);
+        //We are going to need those caches after all (distributed caches also hold the halo values needed)
+        if (!pTissue->GetUseDistributedCaches())
+        {
+            pTissue->SetCacheReplication(true);
+        }
     }
     else
     {
@@ -222,9 +277,15 @@ MonodomainSolver<ELEMENT_DIM,SPACE_DIM>::~MonodomainSolver()
     if(mVecForConstructingRhs)
     {
         PetscTools::Destroy(mVecForConstructingRhs);
-        PetscTools::Destroy(mMassMatrix);
+        if (!mpMatrixFreeMassOperator)
+        {
+            PetscTools::Destroy(mMassMatrix);
+        }
     }
 
+    delete mpMatrixFreeLhsOperator;
+    delete mpMatrixFreeMassOperator;
+
     if(mpMonodomainCorrectionTermAssembler)
     {
         delete mpMonodomainCorrectionTermAssembler;
@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "MonodomainCorrectionTermAssembler.hpp"
 #include "MonodomainTissue.hpp"
 #include "MonodomainAssembler.hpp"
+#include "MatrixFreeCardiacOperator.hpp"
 
 /**
  *  A monodomain solver, which uses various assemblers to set up the
@@ -66,6 +67,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  In this case the equation is
  *  ( (chi*C/dt) M  + K ) V^{n+1} = (chi*C/dt) M V^{n} + M F^{n} + c_surf + c_correction
  *  and another assembler is used to create the c_correction.
+ *
+ *  If HeartConfig::GetUseMatrixFreeOperators() is set, neither the LHS matrix nor the
+ *  mass matrix are assembled. Instead they are applied element by element by
+ *  MatrixFreeCardiacOperator objects, the first of which is wrapped in a shell matrix
+ *  and solved with the "jacobi" (or no) preconditioner.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class MonodomainSolver
@@ -99,6 +105,11 @@ private:
      */
     Vec mVecForConstructingRhs;
 
+    /** If using matrix-free operators, applies the LHS matrix (chi*C/dt) M  + K */
+    MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>* mpMatrixFreeLhsOperator;
+
+    /** If using matrix-free operators, applies the mass matrix (used instead of mMassMatrix) */
+    MatrixFreeCardiacOperator<ELEMENT_DIM,SPACE_DIM>* mpMatrixFreeMassOperator;
 
     /**
      *  Implementation of SetupLinearSystem() which uses the assembler to compute the
@@ -120,7 +131,9 @@ public:
     void PrepareForSetupLinearSystem(Vec currentSolution);
 
     /**
-     *  Overloaded InitialiseForSolve
+     *  Overloaded InitialiseForSolve. If using matrix-free operators, this sets up the
+     *  linear system with a shell LHS matrix, and throws if the preconditioner needs the
+     *  matrix entries.
      *
      *  @param initialSolution initial solution
      */
@@ -42,6 +42,11 @@ AbstractStimulusFunction::~AbstractStimulusFunction()
 {
 }
 
+bool AbstractStimulusFunction::GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses)
+{
+    return false;
+}
+
 void AbstractStimulusFunction::Clear()
 {
     //Needed in one or more derived classes
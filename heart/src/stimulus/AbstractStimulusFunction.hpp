@@ -40,9 +40,25 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ClassIsAbstract.hpp"
 
 #include <cfloat>
+#include <vector>
 
 #include "Exception.hpp"
 
+/**
+ * A square pulse of stimulus, as used by StimulusSchedule to find out when a
+ * stimulus may be non-zero.
+ */
+struct StimulusPulse
+{
+    /** The time at which the pulse starts. */
+    double mStart;
+
+    /** How long the pulse lasts. */
+    double mDuration;
+
+    /** The size of the pulse. */
+    double mMagnitude;
+};
 
 /**
  * Represents an abstract stimulus function. Sub-classes will implement the
@@ -73,6 +89,21 @@ public:
      */
     virtual double GetStimulus(double time) = 0;
 
+    /**
+     * Describe this stimulus as a list of square pulses, so that a StimulusSchedule
+     * need only evaluate it when one of them is under way.  Outside the pulses, the
+     * stimulus must be zero.
+     *
+     * The default implementation returns false, meaning that the stimulus may be
+     * non-zero at any time.
+     *
+     * @param startTime  the start of the time window of interest
+     * @param endTime  the end of the time window of interest
+     * @param rPulses  the pulses which overlap the window are appended to this
+     * @return whether the stimulus is described by pulses
+     */
+    virtual bool GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses);
+
     /**
      * Destructor.
      */
@@ -53,6 +53,19 @@ double MultiStimulus::GetStimulus(double time)
     return total_stimulus;
 }
 
+bool MultiStimulus::GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses)
+{
+    for (unsigned stimulus_index = 0; stimulus_index < mStimuli.size(); ++stimulus_index)
+    {
+        if (!mStimuli[stimulus_index]->GetPulses(startTime, endTime, rPulses))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 MultiStimulus::~MultiStimulus()
 {
     Clear();
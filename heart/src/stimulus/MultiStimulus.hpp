@@ -98,6 +98,16 @@ public:
      */
      virtual double GetStimulus(double time);
 
+     /**
+      * Combine the pulses of the component stimuli.
+      *
+      * @param startTime  the start of the time window
+      * @param endTime  the end of the time window
+      * @param rPulses  the pulses are appended to this
+      * @return whether all the component stimuli are described by pulses
+      */
+     virtual bool GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses);
+
      /**
       * Clear is responsible for managing the memory of
       * delegated stimuli
@@ -35,6 +35,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
 #include "RegularStimulus.hpp"
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 
@@ -80,6 +81,38 @@ double RegularStimulus::GetStimulus(double time)
     }
 }
 
+bool RegularStimulus::GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses)
+{
+    if (mMagnitudeOfStimulus == 0.0)
+    {
+        return true;
+    }
+
+    // The first wave which could overlap the window
+    double first_wave = 0.0;
+    if (startTime > mStartTime + mDuration)
+    {
+        first_wave = floor((startTime - mStartTime - mDuration)/mPeriod);
+    }
+    const double last_start = std::min(endTime, mStopTime);
+    for (double wave = first_wave; ; wave += 1.0)
+    {
+        StimulusPulse pulse;
+        pulse.mStart = mStartTime + wave*mPeriod;
+        if (pulse.mStart > last_start)
+        {
+            break;
+        }
+        pulse.mDuration = std::min(mDuration, mStopTime - pulse.mStart);
+        pulse.mMagnitude = mMagnitudeOfStimulus;
+        if (pulse.mStart + pulse.mDuration >= startTime)
+        {
+            rPulses.push_back(pulse);
+        }
+    }
+    return true;
+}
+
 double RegularStimulus::GetPeriod()
 {
     return mPeriod;
@@ -101,6 +101,17 @@ public:
      */
     double GetStimulus(double time);
 
+    /**
+     * Describe the square waves which overlap a time window.  Subclasses which are
+     * non-zero at other times must override this.
+     *
+     * @param startTime  the start of the time window
+     * @param endTime  the end of the time window
+     * @param rPulses  the pulses are appended to this
+     * @return true
+     */
+    bool GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses);
+
     /**
      * @return the pacing cycle length or period of the stimulus.
      */
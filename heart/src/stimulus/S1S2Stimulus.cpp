@@ -63,6 +63,11 @@ double S1S2Stimulus::GetStimulus(double time)
     return this->mStimuli[mS2Index]->GetStimulus(time);
 }
 
+bool S1S2Stimulus::GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses)
+{
+    return this->mStimuli[mS2Index]->GetPulses(startTime, endTime, rPulses);
+}
+
 void S1S2Stimulus::SetS2ExperimentPeriodIndex(unsigned index)
 {
     if (index < mNumS2FrequencyValues)
@@ -114,6 +114,16 @@ public:
      */
      double GetStimulus(double time);
 
+     /**
+      * Describe the pulses of the current S2 experiment.
+      *
+      * @param startTime  the start of the time window
+      * @param endTime  the end of the time window
+      * @param rPulses  the pulses are appended to this
+      * @return true if the experiment is described by pulses
+      */
+     bool GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses);
+
      /**
       * Allows us to move to the 'next' S2 frequency.
       *
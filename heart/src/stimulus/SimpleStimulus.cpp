@@ -75,6 +75,19 @@ double SimpleStimulus::GetStimulus(double time)
     }
 }
 
+bool SimpleStimulus::GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses)
+{
+    if (mMagnitudeOfStimulus != 0.0 && mTimeOfStimulus <= endTime && startTime <= mDuration+mTimeOfStimulus)
+    {
+        StimulusPulse pulse;
+        pulse.mStart = mTimeOfStimulus;
+        pulse.mDuration = mDuration;
+        pulse.mMagnitude = mMagnitudeOfStimulus;
+        rPulses.push_back(pulse);
+    }
+    return true;
+}
+
 
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
@@ -101,6 +101,16 @@ public:
      * @param time  time at which to return the stimulus
      */
     double GetStimulus(double time);
+
+    /**
+     * Describe the stimulus pulse, if it overlaps a time window.
+     *
+     * @param startTime  the start of the time window
+     * @param endTime  the end of the time window
+     * @param rPulses  the pulse is appended to this
+     * @return true
+     */
+    bool GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses);
 };
 
 
@@ -0,0 +1,169 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "StimulusSchedule.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+/**
+ * Events are widened by this much (in ms) at each end, so that rounding in the
+ * stimulus functions' own tests of whether a pulse is under way can't make the
+ * schedule miss it.
+ */
+static const double EVENT_TOLERANCE = 1e-6;
+
+StimulusSchedule::StimulusSchedule(double horizon)
+    : mHorizon(horizon),
+      mIsCompiled(false),
+      mWindowStart(0.0),
+      mWindowEnd(0.0),
+      mLastQueryStart(0.0),
+      mNextEvent(0u),
+      mNumQueries(0u)
+{
+    assert(horizon > 0.0);
+}
+
+void StimulusSchedule::AddNode(unsigned nodeIndex, boost::shared_ptr<AbstractStimulusFunction> pStimulus)
+{
+    std::map<AbstractStimulusFunction*, unsigned>::iterator it = mNodeSetIndices.find(pStimulus.get());
+    if (it == mNodeSetIndices.end())
+    {
+        it = mNodeSetIndices.insert(std::make_pair(pStimulus.get(), mStimuli.size())).first;
+        mStimuli.push_back(pStimulus);
+        mNodeSets.push_back(std::vector<unsigned>());
+        mLastQueryFound.push_back(0u);
+    }
+    mNodeSets[it->second].push_back(nodeIndex);
+    mIsCompiled = false;
+}
+
+void StimulusSchedule::Reset()
+{
+    mIsCompiled = false;
+}
+
+unsigned StimulusSchedule::GetNumNodeSets() const
+{
+    return mNodeSets.size();
+}
+
+const std::vector<unsigned>& StimulusSchedule::rGetNodeSet(unsigned nodeSetIndex) const
+{
+    assert(nodeSetIndex < mNodeSets.size());
+    return mNodeSets[nodeSetIndex];
+}
+
+double StimulusSchedule::GetStimulus(unsigned nodeSetIndex, double time)
+{
+    assert(nodeSetIndex < mStimuli.size());
+    return mStimuli[nodeSetIndex]->GetStimulus(time);
+}
+
+void StimulusSchedule::CompileTimeline(double startTime, double endTime)
+{
+    mTimeline.clear();
+    mEventsUnderway.clear();
+    mUndescribedNodeSets.clear();
+    mNextEvent = 0u;
+
+    std::vector<StimulusPulse> pulses;
+    for (unsigned node_set=0; node_set<mStimuli.size(); node_set++)
+    {
+        pulses.clear();
+        if (!mStimuli[node_set]->GetPulses(startTime - EVENT_TOLERANCE, endTime + EVENT_TOLERANCE, pulses))
+        {
+            mUndescribedNodeSets.push_back(node_set);
+            continue;
+        }
+        for (unsigned i=0; i<pulses.size(); i++)
+        {
+            if (pulses[i].mMagnitude != 0.0)
+            {
+                Event event;
+                event.mStart = pulses[i].mStart - EVENT_TOLERANCE;
+                event.mEnd = pulses[i].mStart + pulses[i].mDuration + EVENT_TOLERANCE;
+                event.mNodeSet = node_set;
+                mTimeline.push_back(event);
+            }
+        }
+    }
+    std::sort(mTimeline.begin(), mTimeline.end());
+
+    mWindowStart = startTime;
+    mWindowEnd = endTime;
+    mIsCompiled = true;
+}
+
+const std::vector<unsigned>& StimulusSchedule::rGetPossiblyStimulatedNodeSets(double startTime, double endTime)
+{
+    assert(startTime <= endTime);
+    if (!mIsCompiled || startTime < mLastQueryStart || endTime > mWindowEnd)
+    {
+        CompileTimeline(startTime, std::max(endTime, startTime + mHorizon));
+    }
+    mLastQueryStart = startTime;
+
+    // Start the events which have begun by the end of the interval
+    while (mNextEvent < mTimeline.size() && mTimeline[mNextEvent].mStart <= endTime)
+    {
+        mEventsUnderway.push_back(mTimeline[mNextEvent++]);
+    }
+
+    // Forget those which finished before the interval, and list the node sets of the rest
+    mNumQueries++;
+    mPossiblyStimulatedNodeSets.clear();
+    unsigned num_underway = 0u;
+    for (unsigned i=0; i<mEventsUnderway.size(); i++)
+    {
+        const Event& r_event = mEventsUnderway[i];
+        if (r_event.mEnd < startTime)
+        {
+            continue;
+        }
+        mEventsUnderway[num_underway++] = r_event;
+        if (mLastQueryFound[r_event.mNodeSet] != mNumQueries)
+        {
+            mLastQueryFound[r_event.mNodeSet] = mNumQueries;
+            mPossiblyStimulatedNodeSets.push_back(r_event.mNodeSet);
+        }
+    }
+    mEventsUnderway.resize(num_underway);
+
+    mPossiblyStimulatedNodeSets.insert(mPossiblyStimulatedNodeSets.end(),
+                                       mUndescribedNodeSets.begin(), mUndescribedNodeSets.end());
+    return mPossiblyStimulatedNodeSets;
+}
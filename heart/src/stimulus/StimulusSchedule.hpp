@@ -0,0 +1,198 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef STIMULUSSCHEDULE_HPP_
+#define STIMULUSSCHEDULE_HPP_
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractStimulusFunction.hpp"
+
+/**
+ * A timeline of the stimuli applied to a set of nodes (e.g. the cells owned by a
+ * tissue), which can find the nodes that may be stimulated at a given time without
+ * evaluating every node's stimulus function.
+ *
+ * Nodes sharing a stimulus function object form a node set.  The pulses of each set's
+ * stimulus (see AbstractStimulusFunction::GetPulses()) are compiled into a list of
+ * events sorted by start time, covering a window of time which is moved on as the
+ * schedule is queried.  Stimulus functions which can't be described by pulses are
+ * treated as being under way at all times.
+ *
+ * The timeline is only used to choose which node sets to look at: the stimulus itself
+ * is given by the set's stimulus function, evaluated once for the whole set, so results
+ * are unchanged.  If a stimulus function is altered, call Reset().
+ */
+class StimulusSchedule
+{
+private:
+    /** A pulse of stimulus applied to a node set. */
+    struct Event
+    {
+        /** The time at which the pulse starts, less a tolerance. */
+        double mStart;
+
+        /** The time at which the pulse ends, plus a tolerance. */
+        double mEnd;
+
+        /** The node set stimulated. */
+        unsigned mNodeSet;
+
+        /**
+         * Compare events by start time.
+         *
+         * @param rOther  the event to compare with
+         * @return whether this event starts first
+         */
+        bool operator<(const Event& rOther) const
+        {
+            return mStart < rOther.mStart;
+        }
+    };
+
+    /** The stimulus function of each node set. */
+    std::vector<boost::shared_ptr<AbstractStimulusFunction> > mStimuli;
+
+    /** The nodes in each node set. */
+    std::vector<std::vector<unsigned> > mNodeSets;
+
+    /** Map from stimulus function to node set. */
+    std::map<AbstractStimulusFunction*, unsigned> mNodeSetIndices;
+
+    /** The length of time covered each time the timeline is compiled. */
+    double mHorizon;
+
+    /** Whether #mTimeline covers the window from #mWindowStart to #mWindowEnd. */
+    bool mIsCompiled;
+
+    /** The start of the window covered by the timeline. */
+    double mWindowStart;
+
+    /** The end of the window covered by the timeline. */
+    double mWindowEnd;
+
+    /** The start of the last query, since queries must go forward in time. */
+    double mLastQueryStart;
+
+    /** The events in the window, sorted by start time. */
+    std::vector<Event> mTimeline;
+
+    /** The index in #mTimeline of the next event to start. */
+    unsigned mNextEvent;
+
+    /** The events which have started, and hadn't finished at the last query. */
+    std::vector<Event> mEventsUnderway;
+
+    /** The node sets whose stimulus functions aren't described by pulses. */
+    std::vector<unsigned> mUndescribedNodeSets;
+
+    /** The node sets found by the last query. */
+    std::vector<unsigned> mPossiblyStimulatedNodeSets;
+
+    /** For each node set, the last query which found it, to avoid listing it twice. */
+    std::vector<unsigned> mLastQueryFound;
+
+    /** The number of queries made. */
+    unsigned mNumQueries;
+
+    /**
+     * Compile the timeline for a window of time.
+     *
+     * @param startTime  the start of the window
+     * @param endTime  the end of the window
+     */
+    void CompileTimeline(double startTime, double endTime);
+
+public:
+    /**
+     * Create an empty schedule.
+     *
+     * @param horizon  the length of time covered each time the timeline is compiled (defaults to 1s)
+     */
+    StimulusSchedule(double horizon=1000.0);
+
+    /**
+     * Add a node to the schedule.
+     *
+     * @param nodeIndex  the index of the node (as understood by the caller)
+     * @param pStimulus  the stimulus applied to the node
+     */
+    void AddNode(unsigned nodeIndex, boost::shared_ptr<AbstractStimulusFunction> pStimulus);
+
+    /**
+     * Discard the compiled timeline, so it is compiled afresh from the stimulus functions
+     * when next needed.
+     */
+    void Reset();
+
+    /**
+     * @return the number of node sets (distinct stimulus functions) in the schedule.
+     */
+    unsigned GetNumNodeSets() const;
+
+    /**
+     * @return the indices of the nodes in a node set.
+     *
+     * @param nodeSetIndex  the node set
+     */
+    const std::vector<unsigned>& rGetNodeSet(unsigned nodeSetIndex) const;
+
+    /**
+     * @return the stimulus applied to the nodes of a node set.
+     *
+     * @param nodeSetIndex  the node set
+     * @param time  the time at which to evaluate the stimulus
+     */
+    double GetStimulus(unsigned nodeSetIndex, double time);
+
+    /**
+     * Find the node sets which may be stimulated at some time from startTime to endTime.
+     * Node sets not listed are not stimulated at any time in the interval.
+     *
+     * The work done is proportional to the number of pulses under way rather than the
+     * number of nodes, except when the timeline has to be compiled for a new window of
+     * time.  Queries are expected to move forward in time; going back recompiles the
+     * timeline.
+     *
+     * @param startTime  the start of the interval
+     * @param endTime  the end of the interval
+     * @return the indices of the node sets, valid until the next query
+     */
+    const std::vector<unsigned>& rGetPossiblyStimulatedNodeSets(double startTime, double endTime);
+};
+
+#endif /*STIMULUSSCHEDULE_HPP_*/
@@ -48,6 +48,11 @@ double ZeroStimulus::GetStimulus(double time)
     return 0.0;
 }
 
+bool ZeroStimulus::GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses)
+{
+    return true;
+}
+
 
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
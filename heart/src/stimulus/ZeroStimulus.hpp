@@ -67,6 +67,16 @@ public:
     virtual ~ZeroStimulus();
 
     double GetStimulus(double time);
+
+    /**
+     * This stimulus has no pulses.
+     *
+     * @param startTime  the start of the time window
+     * @param endTime  the end of the time window
+     * @param rPulses  left unchanged
+     * @return true
+     */
+    bool GetPulses(double startTime, double endTime, std::vector<StimulusPulse>& rPulses);
 };
 
 #include "SerializationExportWrapper.hpp"
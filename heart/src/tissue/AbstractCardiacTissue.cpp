@@ -36,6 +36,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "AbstractCardiacTissue.hpp"
 
 #include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <set>
 
 #include "DistributedVector.hpp"
 #include "AxisymmetricConductivityTensors.hpp"
@@ -58,7 +63,17 @@ AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::AbstractCardiacTissue(
       mHasPurkinje(false),
       mDoCacheReplication(true),
       mMeshUnarchived(false),
-      mExchangeHalos(exchangeHalos)
+      mExchangeHalos(exchangeHalos),
+      mUseDistributedCaches(false),
+      mUseBatchedCellSolve(false),
+      mNumCellSolveThreads(1u),
+      mCellSolveChunkSize(16u),
+      mCellsPreparedForThreadedSolve(false),
+      mMaxCellTimestepMultiple(1u),
+      mQuiescentVoltageRate(0.1),
+      mTimeOfLastCellSolve(DOUBLE_UNSET),
+      mNumActiveCells(0u),
+      mUseStimulusSchedule(false)
 {
     //This constructor is called from the Initialise() method of the CardiacProblem class
     assert(pCellFactory != NULL);
@@ -181,7 +196,17 @@ AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::AbstractCardiacTissue(AbstractTetr
       mHasPurkinje(false),
       mDoCacheReplication(true),
       mMeshUnarchived(true),
-      mExchangeHalos(false)
+      mExchangeHalos(false),
+      mUseDistributedCaches(false),
+      mUseBatchedCellSolve(false),
+      mNumCellSolveThreads(1u),
+      mCellSolveChunkSize(16u),
+      mCellsPreparedForThreadedSolve(false),
+      mMaxCellTimestepMultiple(1u),
+      mQuiescentVoltageRate(0.1),
+      mTimeOfLastCellSolve(DOUBLE_UNSET),
+      mNumActiveCells(0u),
+      mUseStimulusSchedule(false)
 {
     mIionicCacheReplicated.Resize(mpDistributedVectorFactory->GetProblemSize());
     mIntracellularStimulusCacheReplicated.Resize(mpDistributedVectorFactory->GetProblemSize());
@@ -193,6 +218,8 @@ AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::AbstractCardiacTissue(AbstractTetr
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::~AbstractCardiacTissue()
 {
+    DeleteCellBatches();
+
     // Delete cells
     for (std::vector<AbstractCardiacCellInterface*>::iterator iter = mCellsDistributed.begin();
          iter != mCellsDistributed.end();
@@ -348,6 +375,10 @@ void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::CreateIntracellularConductivi
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetCacheReplication(bool doCacheReplication)
 {
+    if (doCacheReplication && mUseDistributedCaches)
+    {
+        EXCEPTION("The caches cannot be replicated while distributed caches are in use.");
+    }
     mDoCacheReplication = doCacheReplication;
 }
 
@@ -357,6 +388,467 @@ bool AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetDoCacheReplication()
     return mDoCacheReplication;
 }
 
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetUseDistributedCaches(bool useDistributedCaches)
+{
+    if (useDistributedCaches == mUseDistributedCaches)
+    {
+        return;
+    }
+
+    if (useDistributedCaches)
+    {
+        if (mHasPurkinje)
+        {
+            EXCEPTION("Distributed caches are not supported for tissues with Purkinje cells.");
+        }
+
+        // Find the halo nodes, unless this was already done for exchanging halo cells
+        if (mNodesToSendPerProcess.empty())
+        {
+            mpMesh->CalculateNodeExchange(mNodesToSendPerProcess, mNodesToReceivePerProcess);
+            CalculateHaloNodesFromNodeExchange();
+            for (unsigned local_index = 0; local_index < mHaloNodes.size(); local_index++)
+            {
+                mHaloGlobalToLocalIndexMap[mHaloNodes[local_index]] = local_index;
+            }
+        }
+
+        unsigned num_local_nodes = mpDistributedVectorFactory->GetLocalOwnership();
+        mIionicCacheDistributed.assign(num_local_nodes + mHaloNodes.size(), 0.0);
+        mIntracellularStimulusCacheDistributed.assign(num_local_nodes + mHaloNodes.size(), 0.0);
+
+        // Free the replicated caches
+        mDoCacheReplication = false;
+        mIionicCacheReplicated.Resize(0u);
+        mIntracellularStimulusCacheReplicated.Resize(0u);
+    }
+    else
+    {
+        std::vector<double>().swap(mIionicCacheDistributed);
+        std::vector<double>().swap(mIntracellularStimulusCacheDistributed);
+        mIionicCacheReplicated.Resize(mpDistributedVectorFactory->GetProblemSize());
+        mIntracellularStimulusCacheReplicated.Resize(mpDistributedVectorFactory->GetProblemSize());
+    }
+    mUseDistributedCaches = useDistributedCaches;
+
+    // The stimulus cache has been reallocated, so needs setting up again
+    mpStimulusSchedule.reset();
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetUseDistributedCaches()
+{
+    return mUseDistributedCaches;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+unsigned AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetDistributedCacheIndex(unsigned globalIndex)
+{
+    assert(mUseDistributedCaches);
+    if (mpDistributedVectorFactory->IsGlobalIndexLocal(globalIndex))
+    {
+        return globalIndex - mpDistributedVectorFactory->GetLow();
+    }
+    std::map<unsigned, unsigned>::const_iterator halo_position = mHaloGlobalToLocalIndexMap.find(globalIndex);
+    if (halo_position == mHaloGlobalToLocalIndexMap.end())
+    {
+        EXCEPTION("Requested node/halo " << globalIndex << " does not belong to processor " << PetscTools::GetMyRank());
+    }
+    return mpDistributedVectorFactory->GetLocalOwnership() + halo_position->second;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+double AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetIionicCacheValue(unsigned globalIndex)
+{
+    if (mUseDistributedCaches)
+    {
+        return mIionicCacheDistributed[GetDistributedCacheIndex(globalIndex)];
+    }
+    return mIionicCacheReplicated[globalIndex];
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+double AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetIntracellularStimulusCacheValue(unsigned globalIndex)
+{
+    if (mUseDistributedCaches)
+    {
+        return mIntracellularStimulusCacheDistributed[GetDistributedCacheIndex(globalIndex)];
+    }
+    return mIntracellularStimulusCacheReplicated[globalIndex];
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetUseBatchedCellSolve(bool useBatchedCellSolve)
+{
+    if (!useBatchedCellSolve)
+    {
+        DeleteCellBatches();
+    }
+    mUseBatchedCellSolve = useBatchedCellSolve;
+
+    // Which cells are adaptable depends on which are batched
+    mAdaptableCells.clear();
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetUseBatchedCellSolve()
+{
+    return mUseBatchedCellSolve;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetCellSolveThreading(unsigned numThreads, unsigned chunkSize)
+{
+    if (numThreads == 0u || chunkSize == 0u)
+    {
+        EXCEPTION("The number of cell solve threads and the chunk size must both be positive.");
+    }
+#ifndef _OPENMP
+    if (numThreads > 1u)
+    {
+        EXCEPTION("Chaste was not compiled with OpenMP support, so cell models can only be solved by one thread.");
+    }
+#endif // _OPENMP
+    mNumCellSolveThreads = numThreads;
+    mCellSolveChunkSize = chunkSize;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+unsigned AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetNumCellSolveThreads()
+{
+    return mNumCellSolveThreads;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+unsigned AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetCellSolveChunkSize()
+{
+    return mCellSolveChunkSize;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetActivityAdaptiveCellTimesteps(unsigned maxTimestepMultiple,
+                                                                                    double quiescentVoltageRate)
+{
+    if (maxTimestepMultiple == 0u || quiescentVoltageRate <= 0.0)
+    {
+        EXCEPTION("The maximum cell timestep multiple and the quiescent voltage rate must both be positive.");
+    }
+    mMaxCellTimestepMultiple = maxTimestepMultiple;
+    mQuiescentVoltageRate = quiescentVoltageRate;
+
+    // Start afresh, as there is no record of the voltages at the last solve
+    mAdaptableCells.clear();
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+unsigned AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetMaxCellTimestepMultiple()
+{
+    return mMaxCellTimestepMultiple;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetUpActivityAdaptiveCellTimesteps()
+{
+    const unsigned num_local_cells = mCellsDistributed.size();
+    mAdaptableCells.assign(num_local_cells, NULL);
+    mBaseCellTimesteps.assign(num_local_cells, 0.0);
+    mAdaptedCellTimesteps.assign(num_local_cells, 0.0);
+    mCellVoltagesAtLastSolve.assign(num_local_cells, DOUBLE_UNSET);
+    mTimeOfLastCellSolve = DOUBLE_UNSET;
+
+    for (unsigned local_index=0; local_index<num_local_cells; local_index++)
+    {
+        if (mUseBatchedCellSolve && mIsCellBatched[local_index])
+        {
+            continue;
+        }
+        AbstractCardiacCellInterface* p_cell = mCellsDistributed[local_index];
+        AbstractCardiacCell* p_ode_cell = dynamic_cast<AbstractCardiacCell*>(p_cell);
+        if (p_ode_cell != NULL && dynamic_cast<FakeBathCell*>(p_cell) == NULL)
+        {
+            mAdaptableCells[local_index] = p_ode_cell;
+            mBaseCellTimesteps[local_index] = p_ode_cell->GetTimestep();
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::ChooseActivityAdaptiveCellTimesteps(DistributedVector::Stripe& rVoltage,
+                                                                                       double time,
+                                                                                       double nextTime)
+{
+    if (mAdaptableCells.empty())
+    {
+        SetUpActivityAdaptiveCellTimesteps();
+    }
+
+    const unsigned num_local_cells = mCellsDistributed.size();
+    const unsigned index_low = mpDistributedVectorFactory->GetLow();
+    const double interval = nextTime - time;
+    const bool have_previous_voltages = (mTimeOfLastCellSolve != DOUBLE_UNSET && time > mTimeOfLastCellSolve);
+    const double previous_interval = time - mTimeOfLastCellSolve;
+
+    mCellSolveOrder.resize(num_local_cells);
+    unsigned num_active = 0;
+    unsigned num_quiescent = 0;
+    unsigned long substeps = 0;
+    unsigned long substeps_at_base_timestep = 0;
+
+    // Mark the cells which may be stimulated at any point during the solve
+    const std::vector<unsigned>* p_stimulated_node_sets = NULL;
+    if (mpStimulusSchedule)
+    {
+        p_stimulated_node_sets = &(mpStimulusSchedule->rGetPossiblyStimulatedNodeSets(time, nextTime));
+        SetCellsPossiblyStimulated(*p_stimulated_node_sets, true);
+    }
+
+    for (unsigned local_index=0; local_index<num_local_cells; local_index++)
+    {
+        AbstractCardiacCell* p_cell = mAdaptableCells[local_index];
+        if (p_cell == NULL)
+        {
+            // Solved as usual, after the active cells
+            mCellSolveOrder[num_local_cells - 1 - num_quiescent++] = local_index;
+            continue;
+        }
+
+        const double voltage = rVoltage[index_low + local_index];
+        const double base_dt = mBaseCellTimesteps[local_index];
+        const unsigned base_steps = std::max(1u, (unsigned) ceil(interval/base_dt - 1e-6));
+
+        double rate = DBL_MAX;
+        if (have_previous_voltages && mCellVoltagesAtLastSolve[local_index] != DOUBLE_UNSET)
+        {
+            rate = fabs(voltage - mCellVoltagesAtLastSolve[local_index])/previous_interval;
+        }
+        mCellVoltagesAtLastSolve[local_index] = voltage;
+
+        bool is_stimulated;
+        if (mpStimulusSchedule)
+        {
+            is_stimulated = mIsCellPossiblyStimulated[local_index];
+        }
+        else
+        {
+            is_stimulated = (p_cell->GetIntracellularStimulus(time) != 0.0
+                             || p_cell->GetIntracellularStimulus(nextTime) != 0.0);
+        }
+
+        unsigned multiple = 1u;
+        if (rate < mQuiescentVoltageRate && !is_stimulated)
+        {
+            multiple = mMaxCellTimestepMultiple;
+            if (rate*mMaxCellTimestepMultiple > mQuiescentVoltageRate)
+            {
+                multiple = std::max(1u, (unsigned) floor(mQuiescentVoltageRate/rate));
+            }
+        }
+
+        const unsigned steps = std::max(1u, (unsigned) ceil(interval/(multiple*base_dt) - 1e-6));
+        if (steps < base_steps)
+        {
+            mAdaptedCellTimesteps[local_index] = interval/steps;
+            mCellSolveOrder[num_local_cells - 1 - num_quiescent++] = local_index;
+            substeps += steps;
+        }
+        else
+        {
+            mAdaptedCellTimesteps[local_index] = base_dt;
+            mCellSolveOrder[num_active++] = local_index;
+            substeps += base_steps;
+        }
+        substeps_at_base_timestep += base_steps;
+    }
+    assert(num_active + num_quiescent == num_local_cells);
+
+    if (p_stimulated_node_sets != NULL)
+    {
+        SetCellsPossiblyStimulated(*p_stimulated_node_sets, false);
+    }
+
+    mNumActiveCells = num_active;
+    mTimeOfLastCellSolve = time;
+    HeartEventHandler::AddToCounter(HeartEventHandler::ODE_SUBSTEPS, substeps);
+    HeartEventHandler::AddToCounter(HeartEventHandler::ODE_SUBSTEPS_AT_BASE_TIMESTEP, substeps_at_base_timestep);
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::UseAdaptedCellTimestep(unsigned localIndex)
+{
+    if (mMaxCellTimestepMultiple > 1u && mAdaptableCells[localIndex] != NULL)
+    {
+        mAdaptableCells[localIndex]->SetTimestep(mAdaptedCellTimesteps[localIndex]);
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::RestoreBaseCellTimestep(unsigned localIndex)
+{
+    if (mMaxCellTimestepMultiple > 1u && mAdaptableCells[localIndex] != NULL)
+    {
+        mAdaptableCells[localIndex]->SetTimestep(mBaseCellTimesteps[localIndex]);
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetUseStimulusSchedule(bool useStimulusSchedule)
+{
+    mUseStimulusSchedule = useStimulusSchedule;
+
+    // Compiled afresh on the next solve, in case the stimuli have changed
+    mpStimulusSchedule.reset();
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetUseStimulusSchedule()
+{
+    return mUseStimulusSchedule;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetUpStimulusSchedule()
+{
+    const unsigned num_local_cells = mCellsDistributed.size();
+    const unsigned index_low = mpDistributedVectorFactory->GetLow();
+
+    mpStimulusSchedule.reset(new StimulusSchedule);
+    for (unsigned local_index=0; local_index<num_local_cells; local_index++)
+    {
+        mpStimulusSchedule->AddNode(local_index, mCellsDistributed[local_index]->GetStimulusFunction());
+
+        // Only stimulated cells are written from now on
+        if (mUseDistributedCaches)
+        {
+            mIntracellularStimulusCacheDistributed[local_index] = 0.0;
+        }
+        else
+        {
+            mIntracellularStimulusCacheReplicated[index_low + local_index] = 0.0;
+        }
+    }
+    mScheduledStimulusCells.clear();
+    mIsCellPossiblyStimulated.assign(num_local_cells, false);
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetCellsPossiblyStimulated(const std::vector<unsigned>& rNodeSets, bool value)
+{
+    for (unsigned i=0; i<rNodeSets.size(); i++)
+    {
+        const std::vector<unsigned>& r_cells = mpStimulusSchedule->rGetNodeSet(rNodeSets[i]);
+        for (unsigned j=0; j<r_cells.size(); j++)
+        {
+            mIsCellPossiblyStimulated[r_cells[j]] = value;
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::UpdateStimulusCacheFromSchedule(double nextTime)
+{
+    assert(mpStimulusSchedule);
+    if (mCellsDistributed.empty())
+    {
+        return;
+    }
+    const unsigned index_low = mpDistributedVectorFactory->GetLow();
+    double* p_cache = mUseDistributedCaches ? &mIntracellularStimulusCacheDistributed[0]
+                                            : &mIntracellularStimulusCacheReplicated[index_low];
+
+    for (unsigned i=0; i<mScheduledStimulusCells.size(); i++)
+    {
+        p_cache[mScheduledStimulusCells[i]] = 0.0;
+    }
+    mScheduledStimulusCells.clear();
+
+    const std::vector<unsigned>& r_node_sets = mpStimulusSchedule->rGetPossiblyStimulatedNodeSets(nextTime, nextTime);
+    for (unsigned i=0; i<r_node_sets.size(); i++)
+    {
+        const double stimulus = mpStimulusSchedule->GetStimulus(r_node_sets[i], nextTime);
+        if (stimulus != 0.0)
+        {
+            const std::vector<unsigned>& r_cells = mpStimulusSchedule->rGetNodeSet(r_node_sets[i]);
+            for (unsigned j=0; j<r_cells.size(); j++)
+            {
+                p_cache[r_cells[j]] = stimulus;
+            }
+            mScheduledStimulusCells.insert(mScheduledStimulusCells.end(), r_cells.begin(), r_cells.end());
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::PrepareCellsForThreadedSolve()
+{
+    std::set<AbstractIvpOdeSolver*> solvers_in_use;
+    for (unsigned local_index=0; local_index<mCellsDistributed.size(); local_index++)
+    {
+        AbstractCardiacCellInterface* p_cell = mCellsDistributed[local_index];
+
+        // Lookup table singletons are created on first use, so make sure that happens now
+        p_cell->GetLookupTableCollection();
+
+        // Solvers have working memory, so can't be shared between cells solved concurrently
+        boost::shared_ptr<AbstractIvpOdeSolver> p_solver = p_cell->GetSolver();
+        if (p_solver)
+        {
+            if (solvers_in_use.find(p_solver.get()) != solvers_in_use.end())
+            {
+                p_solver = p_solver->CreateCopy();
+                p_cell->SetSolver(p_solver);
+            }
+            solvers_in_use.insert(p_solver.get());
+        }
+    }
+    mCellsPreparedForThreadedSolve = true;
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetUpCellBatches()
+{
+    DeleteCellBatches();
+    mIsCellBatched.assign(mCellsDistributed.size(), false);
+
+    for (unsigned local_index=0; local_index<mCellsDistributed.size(); local_index++)
+    {
+        AbstractCardiacCellInterface* p_cell = mCellsDistributed[local_index];
+        if (CardiacCellBatch::GetBatchSolverType(p_cell) == CardiacCellBatch::NOT_BATCHABLE)
+        {
+            continue;
+        }
+
+        // There are generally only a handful of different cell models, so a linear search is fine
+        bool added_to_batch = false;
+        for (unsigned batch=0; batch<mCellBatches.size(); batch++)
+        {
+            unsigned first_local_index = mCellBatches[batch]->rGetLocalIndices()[0];
+            if (CardiacCellBatch::AreCompatible(mCellsDistributed[first_local_index], p_cell))
+            {
+                mCellBatches[batch]->AddCell(p_cell, local_index);
+                added_to_batch = true;
+                break;
+            }
+        }
+        if (!added_to_batch)
+        {
+            mCellBatches.push_back(new CardiacCellBatch(p_cell, local_index));
+        }
+        mIsCellBatched[local_index] = true;
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::DeleteCellBatches()
+{
+    for (unsigned batch=0; batch<mCellBatches.size(); batch++)
+    {
+        delete mCellBatches[batch];
+    }
+    mCellBatches.clear();
+    mIsCellBatched.clear();
+}
+
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 const c_matrix<double, SPACE_DIM, SPACE_DIM>& AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::rGetIntracellularConductivityTensor(unsigned elementIndex)
 {
@@ -398,8 +890,8 @@ template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 AbstractCardiacCellInterface* AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::GetCardiacCellOrHaloCell( unsigned globalIndex )
 {
     std::map<unsigned, unsigned>::const_iterator node_position;
-    // First search the halo
-    if ((node_position=mHaloGlobalToLocalIndexMap.find(globalIndex)) != mHaloGlobalToLocalIndexMap.end())
+    // First search the halo (the halo map is also set up for distributed caches, without halo cells)
+    if (mExchangeHalos && (node_position=mHaloGlobalToLocalIndexMap.find(globalIndex)) != mHaloGlobalToLocalIndexMap.end())
     {
         //Found a halo node
         return mHaloCellsDistributed[node_position->second];
@@ -478,60 +970,81 @@ void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SolveCellSystems(Vec existing
     DistributedVector::Stripe voltage(dist_solution, 0);
     try
     {
-        double voltage_before_update;
-        for (DistributedVector::Iterator index = dist_solution.Begin();
-             index != dist_solution.End();
-             ++index)
+        if (mUseStimulusSchedule && !mpStimulusSchedule)
         {
-            voltage_before_update = voltage[index];
-            mCellsDistributed[index.Local]->SetVoltage( voltage_before_update );
+            SetUpStimulusSchedule();
+        }
 
-            // Added a try-catch here to provide more output to screen when an error occurs.
-            /// \todo This may want to go to std::cerr ??
-            try
+        if (mUseBatchedCellSolve)
+        {
+            if (mIsCellBatched.empty())
             {
-                if (!updateVoltage)
-                {
-                    // solve
-                    // Note: Voltage is not being updated. The voltage is updated in the PDE solve.
-                    mCellsDistributed[index.Local]->ComputeExceptVoltage(time, nextTime);
-                }
-                else
-                {
-                    // solve, including updating the voltage (for the operator-splitting implementation of the monodomain solver)
-                    mCellsDistributed[index.Local]->SolveAndUpdateState(time, nextTime);
-                    voltage[index] = mCellsDistributed[index.Local]->GetVoltage();
-                }
+                SetUpCellBatches();
             }
-            catch (Exception &e)
+            for (unsigned batch=0; batch<mCellBatches.size(); batch++)
             {
-                std::cout << std::setprecision(16);
-                std::cout << "Global node " << index.Global << " had problems with ODE solve between "
-                        "t = " << time << " and " << nextTime << "ms.\n";
+                SolveCellBatch(*mCellBatches[batch], voltage, time, nextTime, updateVoltage);
+            }
+        }
 
-                std::cout << "Voltage at this node before solve was " << voltage_before_update << "mV\n"
-                        "(this SHOULD NOT necessarily be the same as the one in the state variables,\n"
-                        "which can be ignored and stay at the initial condition - the voltage is dictated by PDE instead of state variable.)\n";
+        if (mMaxCellTimestepMultiple > 1u)
+        {
+            ChooseActivityAdaptiveCellTimesteps(voltage, time, nextTime);
+        }
 
-                std::cout << "Stimulus current (NB converted to micro-Amps per cm^3) applied here is equal to:\n\t"
-                    << mCellsDistributed[index.Local]->GetIntracellularStimulus(time) << " at t = " << time     << "ms,\n\t"
-                    << mCellsDistributed[index.Local]->GetIntracellularStimulus(nextTime) << " at t = " << nextTime << "ms.\n";
+        if (mNumCellSolveThreads > 1u)
+        {
+            SolveCellSystemsThreaded(voltage, time, nextTime, updateVoltage);
+        }
+        else
+        {
+            double voltage_before_update;
+            for (DistributedVector::Iterator index = dist_solution.Begin();
+                 index != dist_solution.End();
+                 ++index)
+            {
+                if (mUseBatchedCellSolve && mIsCellBatched[index.Local])
+                {
+                    // Already solved as part of a batch
+                    continue;
+                }
 
-                std::cout << "Cell model: " << dynamic_cast<AbstractUntemplatedParameterisedSystem*>(mCellsDistributed[index.Local])->GetSystemName() << "\n";
+                voltage_before_update = voltage[index];
+                mCellsDistributed[index.Local]->SetVoltage( voltage_before_update );
+                UseAdaptedCellTimestep(index.Local);
 
-                std::cout << "All state variables are now:\n";
-                std::vector<double> state_vars = mCellsDistributed[index.Local]->GetStdVecStateVariables();
-                std::vector<std::string> state_var_names = mCellsDistributed[index.Local]->rGetStateVariableNames();
-                for (unsigned i=0; i<state_vars.size(); i++)
+                // Added a try-catch here to provide more output to screen when an error occurs.
+                /// \todo This may want to go to std::cerr ??
+                try
                 {
-                    std::cout << "\t" << state_var_names[i] << "\t:\t" << state_vars[i] << "\n";
+                    if (!updateVoltage)
+                    {
+                        // solve
+                        // Note: Voltage is not being updated. The voltage is updated in the PDE solve.
+                        mCellsDistributed[index.Local]->ComputeExceptVoltage(time, nextTime);
+                    }
+                    else
+                    {
+                        // solve, including updating the voltage (for the operator-splitting implementation of the monodomain solver)
+                        mCellsDistributed[index.Local]->SolveAndUpdateState(time, nextTime);
+                        voltage[index] = mCellsDistributed[index.Local]->GetVoltage();
+                    }
                 }
-                std::cout << std::flush;
-                throw e;
+                catch (Exception &e)
+                {
+                    ReportCellSolveFailure(index.Global, voltage_before_update, time, nextTime);
+                    throw e;
+                }
+                RestoreBaseCellTimestep(index.Local);
+
+                // update the Iionic and stimulus caches
+                UpdateCaches(index.Global, index.Local, nextTime);
             }
+        }
 
-            // update the Iionic and stimulus caches
-            UpdateCaches(index.Global, index.Local, nextTime);
+        if (mpStimulusSchedule)
+        {
+            UpdateStimulusCacheFromSchedule(nextTime);
         }
 
         if (updateVoltage)
@@ -665,18 +1178,218 @@ void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SolveCellSystems(Vec existing
     {
         ReplicateCaches();
     }
+    else if ( mUseDistributedCaches )
+    {
+        ExchangeCacheHalos();
+    }
     HeartEventHandler::EndEvent(HeartEventHandler::COMMUNICATION);
 }
 
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SolveCellBatch(CardiacCellBatch& rBatch,
+                                                                  DistributedVector::Stripe& rVoltage,
+                                                                  double time,
+                                                                  double nextTime,
+                                                                  bool updateVoltage)
+{
+    const std::vector<unsigned>& r_local_indices = rBatch.rGetLocalIndices();
+    const unsigned num_cells = r_local_indices.size();
+    const unsigned index_low = mpDistributedVectorFactory->GetLow();
+
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        mCellsDistributed[r_local_indices[i]]->SetVoltage(rVoltage[index_low + r_local_indices[i]]);
+    }
+
+    try
+    {
+        rBatch.Solve(time, nextTime, updateVoltage);
+    }
+    catch (Exception &e)
+    {
+        // The voltage stripe is only written to after a successful solve
+        unsigned global_index = index_low + r_local_indices[rBatch.GetFailedCellIndex()];
+        ReportCellSolveFailure(global_index, rVoltage[global_index], time, nextTime);
+        throw e;
+    }
+
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        unsigned local_index = r_local_indices[i];
+        if (updateVoltage)
+        {
+            rVoltage[index_low + local_index] = mCellsDistributed[local_index]->GetVoltage();
+        }
+        UpdateCaches(index_low + local_index, local_index, nextTime);
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SolveCellSystemsThreaded(DistributedVector::Stripe& rVoltage,
+                                                                            double time,
+                                                                            double nextTime,
+                                                                            bool updateVoltage)
+{
+    if (!mCellsPreparedForThreadedSolve)
+    {
+        PrepareCellsForThreadedSolve();
+    }
+
+    // OpenMP 2.5 loops need a signed index
+    const int num_local_cells = mCellsDistributed.size();
+
+    // Details of the failed cell with the lowest index, if any
+    int failed_local_index = num_local_cells;
+    double failed_voltage_before_update = 0.0;
+    boost::scoped_ptr<Exception> p_failure;
+
+    if (mMaxCellTimestepMultiple > 1u)
+    {
+        // Active cells take many more substeps, so hand them out first and one at a time,
+        // then share out the cheap quiescent cells in chunks
+        const int num_active_cells = mNumActiveCells;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(mNumCellSolveThreads)
+#endif // _OPENMP
+        {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 1) nowait
+#endif // _OPENMP
+            for (int i=0; i<num_active_cells; i++)
+            {
+                SolveCellForThreadedSolve(mCellSolveOrder[i], rVoltage, time, nextTime, updateVoltage,
+                                          failed_local_index, failed_voltage_before_update, p_failure);
+            }
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, mCellSolveChunkSize)
+#endif // _OPENMP
+            for (int i=num_active_cells; i<num_local_cells; i++)
+            {
+                SolveCellForThreadedSolve(mCellSolveOrder[i], rVoltage, time, nextTime, updateVoltage,
+                                          failed_local_index, failed_voltage_before_update, p_failure);
+            }
+        }
+    }
+    else
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, mCellSolveChunkSize) num_threads(mNumCellSolveThreads)
+#endif // _OPENMP
+        for (int local_index=0; local_index<num_local_cells; local_index++)
+        {
+            SolveCellForThreadedSolve(local_index, rVoltage, time, nextTime, updateVoltage,
+                                      failed_local_index, failed_voltage_before_update, p_failure);
+        }
+    }
+
+    if (p_failure)
+    {
+        ReportCellSolveFailure(mpDistributedVectorFactory->GetLow() + failed_local_index, failed_voltage_before_update, time, nextTime);
+        throw Exception(*p_failure);
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SolveCellForThreadedSolve(unsigned localIndex,
+                                                                             DistributedVector::Stripe& rVoltage,
+                                                                             double time,
+                                                                             double nextTime,
+                                                                             bool updateVoltage,
+                                                                             int& rFailedLocalIndex,
+                                                                             double& rFailedVoltageBeforeUpdate,
+                                                                             boost::scoped_ptr<Exception>& rpFailure)
+{
+    if (mUseBatchedCellSolve && mIsCellBatched[localIndex])
+    {
+        return;
+    }
+
+    const unsigned global_index = mpDistributedVectorFactory->GetLow() + localIndex;
+    AbstractCardiacCellInterface* p_cell = mCellsDistributed[localIndex];
+    const double voltage_before_update = rVoltage[global_index];
+    p_cell->SetVoltage(voltage_before_update);
+    UseAdaptedCellTimestep(localIndex);
+
+    // Exceptions can't propagate out of a parallel region, so record the failure instead
+    try
+    {
+        if (!updateVoltage)
+        {
+            p_cell->ComputeExceptVoltage(time, nextTime);
+        }
+        else
+        {
+            p_cell->SolveAndUpdateState(time, nextTime);
+            rVoltage[global_index] = p_cell->GetVoltage();
+        }
+        RestoreBaseCellTimestep(localIndex);
+        UpdateCaches(global_index, localIndex, nextTime);
+    }
+    catch (Exception& e)
+    {
+#ifdef _OPENMP
+#pragma omp critical(AbstractCardiacTissue_CellSolveFailure)
+#endif // _OPENMP
+        {
+            if ((int)localIndex < rFailedLocalIndex)
+            {
+                rFailedLocalIndex = localIndex;
+                rFailedVoltageBeforeUpdate = voltage_before_update;
+                rpFailure.reset(new Exception(e));
+            }
+        }
+    }
+}
+
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::ReportCellSolveFailure(unsigned globalIndex,
+                                                                          double voltageBeforeUpdate,
+                                                                          double time,
+                                                                          double nextTime)
+{
+    AbstractCardiacCellInterface* p_cell = mCellsDistributed[globalIndex - mpDistributedVectorFactory->GetLow()];
+
+    std::cout << std::setprecision(16);
+    std::cout << "Global node " << globalIndex << " had problems with ODE solve between "
+            "t = " << time << " and " << nextTime << "ms.\n";
+
+    std::cout << "Voltage at this node before solve was " << voltageBeforeUpdate << "mV\n"
+            "(this SHOULD NOT necessarily be the same as the one in the state variables,\n"
+            "which can be ignored and stay at the initial condition - the voltage is dictated by PDE instead of state variable.)\n";
+
+    std::cout << "Stimulus current (NB converted to micro-Amps per cm^3) applied here is equal to:\n\t"
+        << p_cell->GetIntracellularStimulus(time) << " at t = " << time     << "ms,\n\t"
+        << p_cell->GetIntracellularStimulus(nextTime) << " at t = " << nextTime << "ms.\n";
+
+    std::cout << "Cell model: " << dynamic_cast<AbstractUntemplatedParameterisedSystem*>(p_cell)->GetSystemName() << "\n";
+
+    std::cout << "All state variables are now:\n";
+    std::vector<double> state_vars = p_cell->GetStdVecStateVariables();
+    std::vector<std::string> state_var_names = p_cell->rGetStateVariableNames();
+    for (unsigned i=0; i<state_vars.size(); i++)
+    {
+        std::cout << "\t" << state_var_names[i] << "\t:\t" << state_vars[i] << "\n";
+    }
+    std::cout << std::flush;
+}
+
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 ReplicatableVector& AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::rGetIionicCacheReplicated()
 {
+    if (mUseDistributedCaches)
+    {
+        EXCEPTION("The ionic current cache is distributed; use GetIionicCacheValue() instead.");
+    }
     return mIionicCacheReplicated;
 }
 
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 ReplicatableVector& AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::rGetIntracellularStimulusCacheReplicated()
 {
+    if (mUseDistributedCaches)
+    {
+        EXCEPTION("The intracellular stimulus cache is distributed; use GetIntracellularStimulusCacheValue() instead.");
+    }
     return mIntracellularStimulusCacheReplicated;
 }
 
@@ -697,8 +1410,22 @@ ReplicatableVector& AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::rGetPurkinjeIn
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::UpdateCaches(unsigned globalIndex, unsigned localIndex, double nextTime)
 {
-    mIionicCacheReplicated[globalIndex] = mCellsDistributed[localIndex]->GetIIonic();
-    mIntracellularStimulusCacheReplicated[globalIndex] = mCellsDistributed[localIndex]->GetIntracellularStimulus(nextTime);
+    if (mUseDistributedCaches)
+    {
+        mIionicCacheDistributed[localIndex] = mCellsDistributed[localIndex]->GetIIonic();
+        if (!mpStimulusSchedule)
+        {
+            mIntracellularStimulusCacheDistributed[localIndex] = mCellsDistributed[localIndex]->GetIntracellularStimulus(nextTime);
+        }
+    }
+    else
+    {
+        mIionicCacheReplicated[globalIndex] = mCellsDistributed[localIndex]->GetIIonic();
+        if (!mpStimulusSchedule)
+        {
+            mIntracellularStimulusCacheReplicated[globalIndex] = mCellsDistributed[localIndex]->GetIntracellularStimulus(nextTime);
+        }
+    }
 }
 
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
@@ -726,6 +1453,55 @@ void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::ReplicateCaches()
     //}
 }
 
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::ExchangeCacheHalos()
+{
+    assert(mUseDistributedCaches);
+    const unsigned index_low = mpDistributedVectorFactory->GetLow();
+    const unsigned num_local_nodes = mpDistributedVectorFactory->GetLocalOwnership();
+
+    for ( unsigned rank_offset = 1; rank_offset < PetscTools::GetNumProcs(); rank_offset++ )
+    {
+        unsigned send_to      = (PetscTools::GetMyRank() + rank_offset) % (PetscTools::GetNumProcs());
+        unsigned receive_from = (PetscTools::GetMyRank() + PetscTools::GetNumProcs()- rank_offset ) % (PetscTools::GetNumProcs());
+
+        unsigned number_of_nodes_to_send    = mNodesToSendPerProcess[send_to].size();
+        unsigned number_of_nodes_to_receive = mNodesToReceivePerProcess[receive_from].size();
+
+        // Pack send buffer with the ionic and stimulus currents for each node
+        boost::scoped_array<double> send_data(new double[2*number_of_nodes_to_send]);
+        for (unsigned node = 0; node < number_of_nodes_to_send; node++)
+        {
+            unsigned local_index = mNodesToSendPerProcess[send_to][node] - index_low;
+            send_data[2*node] = mIionicCacheDistributed[local_index];
+            send_data[2*node+1] = mIntracellularStimulusCacheDistributed[local_index];
+        }
+
+        boost::scoped_array<double> receive_data(new double[2*number_of_nodes_to_receive]);
+
+        // Send and receive
+        int ret;
+        MPI_Status status;
+        ret = MPI_Sendrecv(send_data.get(), 2*number_of_nodes_to_send,
+                           MPI_DOUBLE,
+                           send_to, 0,
+                           receive_data.get(), 2*number_of_nodes_to_receive,
+                           MPI_DOUBLE,
+                           receive_from, 0,
+                           PETSC_COMM_WORLD, &status);
+        UNUSED_OPT(ret);
+        assert ( ret == MPI_SUCCESS);
+
+        // Unpack
+        for (unsigned node = 0; node < number_of_nodes_to_receive; node++)
+        {
+            unsigned cache_index = num_local_nodes + mHaloGlobalToLocalIndexMap[mNodesToReceivePerProcess[receive_from][node]];
+            mIionicCacheDistributed[cache_index] = receive_data[2*node];
+            mIntracellularStimulusCacheDistributed[cache_index] = receive_data[2*node+1];
+        }
+    }
+}
+
 template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
 const std::vector<AbstractCardiacCellInterface*>& AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::rGetCellsDistributed() const
 {
@@ -754,6 +1530,12 @@ void AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::SetConductivityModifier(Abstr
     mpConductivityModifier = pModifier;
 }
 
+template <unsigned ELEMENT_DIM,unsigned SPACE_DIM>
+bool AbstractCardiacTissue<ELEMENT_DIM,SPACE_DIM>::HasConductivityModifier() const
+{
+    return (mpConductivityModifier != NULL);
+}
+
 
 /////////////////////////////////////////////////////////////////////
 // Explicit instantiation
@@ -37,7 +37,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <set>
 #include <vector>
+#include <fstream>
 #include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "UblasMatrixInclude.hpp"
 
@@ -51,11 +53,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/serialization/split_member.hpp>
 
 #include "AbstractCardiacCellInterface.hpp"
+#include "AbstractCardiacCell.hpp"
 #include "FakeBathCell.hpp"
 #include "AbstractCardiacCellFactory.hpp"
 #include "AbstractConductivityTensors.hpp"
 #include "AbstractPurkinjeCellFactory.hpp"
 #include "ReplicatableVector.hpp"
+#include "DistributedVector.hpp"
+#include "CardiacCellBatch.hpp"
+#include "StimulusSchedule.hpp"
 #include "HeartConfig.hpp"
 #include "ArchiveLocationInfo.hpp"
 #include "AbstractDynamicallyLoadableEntity.hpp"
@@ -215,6 +221,13 @@ private:
         // not archiving mpConductivityModifier for the time being (mechanics simulations are only use-case at the moment, and they
         // do not get archived...). mpConductivityModifier has to be reset to NULL upon load.
         mpConductivityModifier = NULL;
+
+        // archive & mUseBatchedCellSolve; - a run-time performance option, so not archived.
+        // archive & mNumCellSolveThreads; - likewise.
+        // archive & mUseDistributedCaches; - likewise; set up again by the solver or user.
+        // archive & mMaxCellTimestepMultiple; - likewise, and cells are always archived with their base timestep.
+        // archive & mUseStimulusSchedule; - likewise; the schedule is compiled on the first solve.
+        // mCellBatches are set up on the first solve if needed.
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
@@ -334,6 +347,249 @@ protected:
      */
     std::vector<std::vector<unsigned> > mNodesToReceivePerProcess;
 
+    /**
+     * Whether the ionic and stimulus current caches only hold values at the nodes owned by
+     * this process and its halo nodes, rather than at every node.  See SetUseDistributedCaches().
+     */
+    bool mUseDistributedCaches;
+
+    /**
+     * The ionic current cache when #mUseDistributedCaches is set: values at owned nodes, by
+     * local index, followed by values at halo nodes, in the order of #mHaloNodes.
+     */
+    std::vector<double> mIionicCacheDistributed;
+
+    /** The stimulus current cache when #mUseDistributedCaches is set, laid out as #mIionicCacheDistributed. */
+    std::vector<double> mIntracellularStimulusCacheDistributed;
+
+    /**
+     * Send the distributed cache values at owned nodes to the processes which have them as halo
+     * nodes, using #mNodesToSendPerProcess and #mNodesToReceivePerProcess.
+     */
+    void ExchangeCacheHalos();
+
+    /**
+     * @return the index into the distributed caches of a node owned by this process or a halo node.
+     * @param globalIndex  the global index of the node
+     */
+    unsigned GetDistributedCacheIndex(unsigned globalIndex);
+
+    /**
+     * Whether to solve cells of the same model type together, in batches, rather than
+     * one at a time.  See SetUseBatchedCellSolve().  Defaults to false.
+     */
+    bool mUseBatchedCellSolve;
+
+    /**
+     * Batches of compatible local cells, used when #mUseBatchedCellSolve is set.
+     * Created by SetUpCellBatches() on the first solve.
+     */
+    std::vector<CardiacCellBatch*> mCellBatches;
+
+    /**
+     * Whether each local cell (indexed as #mCellsDistributed) belongs to one of #mCellBatches.
+     * Empty until SetUpCellBatches() has been called.
+     */
+    std::vector<bool> mIsCellBatched;
+
+    /**
+     * The number of threads used to solve the local cells in SolveCellSystems().
+     * See SetCellSolveThreading().  Defaults to 1.
+     */
+    unsigned mNumCellSolveThreads;
+
+    /** The number of consecutive cells handed to a thread at a time when solving with more than one thread. */
+    unsigned mCellSolveChunkSize;
+
+    /** Whether PrepareCellsForThreadedSolve() has been called. */
+    bool mCellsPreparedForThreadedSolve;
+
+    /**
+     * The largest multiple of its own timestep that a quiescent cell may take as a substep.
+     * See SetActivityAdaptiveCellTimesteps().  Defaults to 1, meaning every cell always uses its own timestep.
+     */
+    unsigned mMaxCellTimestepMultiple;
+
+    /** Rate of change of voltage (mV/ms) below which a cell is considered quiescent. */
+    double mQuiescentVoltageRate;
+
+    /**
+     * The local cells whose timestep may be adapted, indexed as #mCellsDistributed (NULL for
+     * other cells).  Empty until SetUpActivityAdaptiveCellTimesteps() has been called.
+     */
+    std::vector<AbstractCardiacCell*> mAdaptableCells;
+
+    /** The timestep each adaptable cell had when it was created, indexed as #mCellsDistributed. */
+    std::vector<double> mBaseCellTimesteps;
+
+    /** The timestep chosen for each adaptable cell for the current solve, indexed as #mCellsDistributed. */
+    std::vector<double> mAdaptedCellTimesteps;
+
+    /** The voltage at each local node at the start of the previous solve (DOUBLE_UNSET before the first). */
+    std::vector<double> mCellVoltagesAtLastSolve;
+
+    /** The start time of the previous solve of the cell models. */
+    double mTimeOfLastCellSolve;
+
+    /**
+     * The order in which the threaded solve visits the local cells when timesteps are
+     * adapted: the #mNumActiveCells active cells first, followed by the rest.
+     */
+    std::vector<unsigned> mCellSolveOrder;
+
+    /** The number of cells at the start of #mCellSolveOrder that are solved with their base timestep. */
+    unsigned mNumActiveCells;
+
+    /** Whether to use a StimulusSchedule for the stimulus cache.  See SetUseStimulusSchedule(). */
+    bool mUseStimulusSchedule;
+
+    /**
+     * The schedule of the stimuli applied to the local cells, indexed by local index.  Set up
+     * by SolveCellSystems() when #mUseStimulusSchedule is set; while it exists, UpdateCaches()
+     * leaves the stimulus cache to UpdateStimulusCacheFromSchedule().
+     */
+    boost::scoped_ptr<StimulusSchedule> mpStimulusSchedule;
+
+    /** The local indices of the cells given a non-zero entry in the stimulus cache at the last solve. */
+    std::vector<unsigned> mScheduledStimulusCells;
+
+    /**
+     * Whether each local cell may be stimulated during the current solve, when the schedule
+     * is used by ChooseActivityAdaptiveCellTimesteps().
+     */
+    std::vector<bool> mIsCellPossiblyStimulated;
+
+    /**
+     * Make the local cells safe to solve concurrently: cells sharing an ODE solver are given
+     * their own copy of it, and any lookup tables are created up front.  (Backward Euler cells
+     * need nothing here, as CardiacNewtonSolver keeps a solver for each thread.)
+     */
+    void PrepareCellsForThreadedSolve();
+
+    /**
+     * Solve the local cells which aren't in a batch using #mNumCellSolveThreads threads,
+     * and update the caches.
+     *
+     * The cells are handed out dynamically in chunks of #mCellSolveChunkSize, so that cells
+     * with very different costs (e.g. adaptive solvers taking many steps near an upstroke)
+     * are balanced between threads.  If any cells fail to solve, the failure at the lowest
+     * global index is reported and rethrown, as it would be by the serial loop.
+     *
+     * @param rVoltage  the voltage stripe of the current solution
+     * @param time  the current simulation time
+     * @param nextTime  when to simulate the cells until
+     * @param updateVoltage  whether to also solve for the voltage
+     */
+    void SolveCellSystemsThreaded(DistributedVector::Stripe& rVoltage,
+                                  double time, double nextTime, bool updateVoltage);
+
+    /**
+     * Solve a single cell for SolveCellSystemsThreaded(), recording rather than throwing any failure.
+     *
+     * @param localIndex  the local index of the cell
+     * @param rVoltage  the voltage stripe of the current solution
+     * @param time  the current simulation time
+     * @param nextTime  when to simulate the cell until
+     * @param updateVoltage  whether to also solve for the voltage
+     * @param rFailedLocalIndex  the lowest local index of a failed cell so far
+     * @param rFailedVoltageBeforeUpdate  the voltage given to that cell
+     * @param rpFailure  the exception thrown by that cell
+     */
+    void SolveCellForThreadedSolve(unsigned localIndex, DistributedVector::Stripe& rVoltage,
+                                   double time, double nextTime, bool updateVoltage,
+                                   int& rFailedLocalIndex, double& rFailedVoltageBeforeUpdate,
+                                   boost::scoped_ptr<Exception>& rpFailure);
+
+    /**
+     * Find the local cells whose timestep may be adapted (see SetActivityAdaptiveCellTimesteps())
+     * and record their base timesteps.  Batched cells, bath cells and cells which aren't
+     * AbstractCardiacCell subclasses (e.g. CVODE cells, which adapt their own steps) are left alone.
+     */
+    void SetUpActivityAdaptiveCellTimesteps();
+
+    /**
+     * Choose the timestep for each adaptable cell for a solve from time to nextTime, fill in
+     * #mCellSolveOrder, and add the substeps to the HeartEventHandler counters.
+     *
+     * A cell is active, and keeps its base timestep, if it is being stimulated or its voltage
+     * changed faster than #mQuiescentVoltageRate over the previous solve.  Otherwise the substep
+     * is enlarged in proportion to how quiescent the cell is, up to #mMaxCellTimestepMultiple times
+     * the base timestep, and rounded down to divide the interval evenly.
+     *
+     * @param rVoltage  the voltage stripe of the current solution
+     * @param time  the current simulation time
+     * @param nextTime  when the cells will be simulated until
+     */
+    void ChooseActivityAdaptiveCellTimesteps(DistributedVector::Stripe& rVoltage, double time, double nextTime);
+
+    /**
+     * Give a cell the timestep chosen by ChooseActivityAdaptiveCellTimesteps(), if it is adaptable.
+     *
+     * @param localIndex  the local index of the cell
+     */
+    void UseAdaptedCellTimestep(unsigned localIndex);
+
+    /**
+     * Give a cell back its base timestep after a solve, if it is adaptable.
+     *
+     * @param localIndex  the local index of the cell
+     */
+    void RestoreBaseCellTimestep(unsigned localIndex);
+
+    /**
+     * Create #mpStimulusSchedule from the stimulus functions of the local cells, and zero the
+     * local entries of the stimulus cache, which from then on only holds values for stimulated cells.
+     */
+    void SetUpStimulusSchedule();
+
+    /**
+     * Set the entries of #mIsCellPossiblyStimulated for the cells in some node sets of #mpStimulusSchedule.
+     *
+     * @param rNodeSets  the node sets
+     * @param value  the value to set
+     */
+    void SetCellsPossiblyStimulated(const std::vector<unsigned>& rNodeSets, bool value);
+
+    /**
+     * Fill in the stimulus cache at nextTime from #mpStimulusSchedule: the entries set last time
+     * are zeroed, and each node set which may be stimulated evaluates its stimulus function once.
+     *
+     * @param nextTime  the time at which to evaluate the stimuli
+     */
+    void UpdateStimulusCacheFromSchedule(double nextTime);
+
+    /**
+     * Group the local cells into batches of the same model type, for solving by
+     * SolveCellSystems() when #mUseBatchedCellSolve is set.  Cells which can't be
+     * batched (see CardiacCellBatch::GetBatchSolverType) are left to be solved individually.
+     */
+    void SetUpCellBatches();
+
+    /** Delete any existing cell batches. */
+    void DeleteCellBatches();
+
+    /**
+     * Solve the cells in a batch, and update the caches.
+     *
+     * @param rBatch  the batch
+     * @param rVoltage  the voltage stripe of the current solution
+     * @param time  the current simulation time
+     * @param nextTime  when to simulate the cells until
+     * @param updateVoltage  whether to also solve for the voltage
+     */
+    void SolveCellBatch(CardiacCellBatch& rBatch, DistributedVector::Stripe& rVoltage,
+                        double time, double nextTime, bool updateVoltage);
+
+    /**
+     * Print diagnostic information to screen when the ODE solve for a cell fails.
+     *
+     * @param globalIndex  global index of the node at which the solve failed
+     * @param voltageBeforeUpdate  the voltage passed in from the PDE solution
+     * @param time  the start of the failed solve
+     * @param nextTime  the end of the failed solve
+     */
+    void ReportCellSolveFailure(unsigned globalIndex, double voltageBeforeUpdate, double time, double nextTime);
+
     /**
      * If the mesh is a tetrahedral mesh then all elements and nodes are known.
      * The halo nodes to the ones which are actually used as cardiac cells
@@ -390,6 +646,139 @@ public:
      */
     bool GetDoCacheReplication();
 
+    /**
+     * Set whether to store the ionic and stimulus current caches only at the nodes owned by this
+     * process and at its halo nodes, rather than replicating them on every process.
+     *
+     * This avoids the memory and all-to-all communication of ReplicateCaches(), which grow with
+     * the size of the mesh rather than the size of each process's partition.  Halo values are
+     * exchanged with neighbouring processes after each SolveCellSystems().  The caches must then be
+     * read with GetIionicCacheValue() and GetIntracellularStimulusCacheValue(), as
+     * rGetIionicCacheReplicated() and rGetIntracellularStimulusCacheReplicated() are not available.
+     *
+     * Not supported for tissues with Purkinje cells, nor for ExtendedBidomainTissue.
+     *
+     * @param useDistributedCaches  whether to use distributed caches
+     */
+    virtual void SetUseDistributedCaches(bool useDistributedCaches=true);
+
+    /**
+     * @return whether the ionic and stimulus caches are distributed.  See SetUseDistributedCaches().
+     */
+    bool GetUseDistributedCaches();
+
+    /**
+     * @return the ionic current cache value at a node
+     * @param globalIndex  the global index of a node owned by this process or, if the cache is
+     *     replicated or distributed, a halo node
+     */
+    double GetIionicCacheValue(unsigned globalIndex);
+
+    /**
+     * @return the intracellular stimulus cache value at a node
+     * @param globalIndex  the global index of a node owned by this process or, if the cache is
+     *     replicated or distributed, a halo node
+     */
+    double GetIntracellularStimulusCacheValue(unsigned globalIndex);
+
+    /**
+     * Set whether to solve the cell models in batches.
+     *
+     * When set, SolveCellSystems() groups local cells of the same concrete model type
+     * and timestep, which are solved using forward Euler, Rush-Larsen or GRL1/GRL2, and
+     * advances each group together (see CardiacCellBatch).  The results are identical to
+     * solving the cells one at a time, but with less overhead per cell.  Other cells
+     * (e.g. CVODE or backward Euler models) are still solved individually.
+     *
+     * Note that batching assumes cells solved with forward Euler do not override
+     * ComputeExceptVoltage or SolveAndUpdateState.  Batches are not used for Purkinje cells.
+     *
+     * @param useBatchedCellSolve  whether to solve cells in batches
+     */
+    void SetUseBatchedCellSolve(bool useBatchedCellSolve=true);
+
+    /**
+     * @return whether cell models are solved in batches.  See SetUseBatchedCellSolve().
+     */
+    bool GetUseBatchedCellSolve();
+
+    /**
+     * Set the number of shared-memory threads used to solve the cell models on this process.
+     *
+     * This requires Chaste to have been compiled with OpenMP support (e.g. build=GccOpt_openmp);
+     * otherwise only one thread may be requested.  Cells which share an ODE solver will be given
+     * their own copy of it on the next solve, so the solver must support
+     * AbstractIvpOdeSolver::CreateCopy().
+     *
+     * Any cell batches (see SetUseBatchedCellSolve()) are still solved by a single thread,
+     * as are Purkinje cells.
+     *
+     * @param numThreads  the number of threads to use
+     * @param chunkSize  the number of consecutive cells to give a thread at a time (defaults to 16)
+     */
+    void SetCellSolveThreading(unsigned numThreads, unsigned chunkSize=16u);
+
+    /**
+     * @return the number of threads used to solve the cell models.  See SetCellSolveThreading().
+     */
+    unsigned GetNumCellSolveThreads();
+
+    /**
+     * @return the number of cells given to a thread at a time.  See SetCellSolveThreading().
+     */
+    unsigned GetCellSolveChunkSize();
+
+    /**
+     * Let each cell choose its own number of ODE substeps per PDE timestep, from how active it is.
+     *
+     * Cells which are being stimulated, or whose voltage changed by more than quiescentVoltageRate
+     * mV/ms over the previous PDE step, are solved with their usual timestep.  Quieter cells
+     * (at rest, or on the plateau) take fewer, larger substeps, up to maxTimestepMultiple times
+     * their usual timestep and never longer than the PDE timestep.  This applies to cells solved by
+     * forward Euler, Rush-Larsen, GRL or backward Euler; it does not affect batched cells (see
+     * SetUseBatchedCellSolve()), Purkinje cells, or CVODE cells, which already adapt their steps.
+     *
+     * When solving with more than one thread (see SetCellSolveThreading()) the active cells are
+     * handed out first, one at a time, so that a wavefront doesn't leave one thread with most of
+     * the work.  The substeps taken and those the usual timestep would have needed are added to
+     * the HeartEventHandler::ODE_SUBSTEPS and HeartEventHandler::ODE_SUBSTEPS_AT_BASE_TIMESTEP counters.
+     *
+     * Note that larger steps reduce the accuracy of the quiescent cells, and explicit solvers
+     * may become unstable if maxTimestepMultiple is too large for the cell model.
+     *
+     * @param maxTimestepMultiple  the largest multiple of a cell's timestep to use (1 switches this off)
+     * @param quiescentVoltageRate  the rate of change of voltage (mV/ms) below which a cell is quiescent
+     */
+    void SetActivityAdaptiveCellTimesteps(unsigned maxTimestepMultiple, double quiescentVoltageRate=0.1);
+
+    /**
+     * @return the largest multiple of a cell's timestep used for quiescent cells.
+     * See SetActivityAdaptiveCellTimesteps().
+     */
+    unsigned GetMaxCellTimestepMultiple();
+
+    /**
+     * Fill the intracellular stimulus cache from a compiled schedule of the cells' stimuli (see
+     * StimulusSchedule), rather than evaluating every cell's stimulus function after every solve.
+     * The work is then proportional to the number of cells being stimulated.  Cells with no
+     * stimulus pulse under way are given zero; the others are given exactly what their stimulus
+     * function returns, evaluated once for all the cells sharing it.  When activity-adaptive
+     * timesteps are used, the schedule also tells which cells are stimulated at any point
+     * during a PDE step.
+     *
+     * The schedule is compiled from the cells' stimulus functions on the next solve.  If these
+     * functions are replaced or altered afterwards, call this method again to recompile it.
+     * Purkinje cells and ExtendedBidomainTissue, which solve their cells separately, are unaffected.
+     *
+     * @param useStimulusSchedule  whether to use the schedule
+     */
+    void SetUseStimulusSchedule(bool useStimulusSchedule=true);
+
+    /**
+     * @return whether the stimulus cache is filled from a schedule.  See SetUseStimulusSchedule().
+     */
+    bool GetUseStimulusSchedule();
+
     /** @return the intracellular conductivity tensor for the given element
      * @param elementIndex  index of the element of interest
      */
@@ -505,12 +894,19 @@ public:
      */
     void SetConductivityModifier(AbstractConductivityModifier<ELEMENT_DIM,SPACE_DIM>* pModifier);
 
+    /**
+     * @return whether a conductivity modifier has been set with SetConductivityModifier().
+     */
+    bool HasConductivityModifier() const;
+
     /**
      * Save our tissue to an archive.
      *
      * Writes:
      *  -# #mpDistributedVectorFactory
      *  -# number of cells on this process
+     *  -# if ArchiveLocationInfo::GetStateVariablesInSeparateArrays(), the rank of this process and
+     *     the number of values in its cell state variables file (see SaveCellStateVariables())
      *  -# each cell pointer in turn, interleaved with Purkinje cells if present
      *
      * @param archive  the process-specific archive to write cells to.
@@ -524,6 +920,13 @@ public:
         archive & mpDistributedVectorFactory; // Needed when loading
         const unsigned num_cells = r_cells_distributed.size();
         archive & num_cells;
+        if (ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+        {
+            const unsigned rank = PetscTools::GetMyRank();
+            const unsigned num_values = SaveCellStateVariables(rank);
+            archive & rank;
+            archive & num_values;
+        }
         for (unsigned i=0; i<num_cells; i++)
         {
             AbstractDynamicallyLoadableEntity* p_entity = dynamic_cast<AbstractDynamicallyLoadableEntity*>(r_cells_distributed[i]);
@@ -571,6 +974,18 @@ public:
         archive & p_factory;
         unsigned num_cells;
         archive & num_cells;
+
+        // The cells in this archive won't contain their state variables if they were saved separately
+        std::vector<double> state_variables;
+        unsigned state_variables_offset = 0u;
+        if (ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+        {
+            unsigned rank, num_values;
+            archive & rank;
+            archive & num_values;
+            LoadCellStateVariables(rank, num_values, state_variables);
+        }
+
         if (mCellsDistributed.empty())
         {
             mCellsDistributed.resize(p_mesh_factory->GetLocalOwnership());
@@ -654,6 +1069,14 @@ public:
             {
                 archive & p_purkinje_cell;
             }
+            if (ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+            {
+                SetCellStateVariables(p_cell, state_variables, state_variables_offset);
+                if (mHasPurkinje)
+                {
+                    SetCellStateVariables(p_purkinje_cell, state_variables, state_variables_offset);
+                }
+            }
             // Check if it's a fake cell
             FakeBathCell* p_fake = dynamic_cast<FakeBathCell*>(p_cell);
             if (p_fake)
@@ -713,6 +1136,8 @@ public:
             }
         }
 
+        assert(state_variables_offset == state_variables.size());
+
         // Delete any unused fake cells
         for (std::set<FakeBathCell*>::iterator it = fake_cells_non_local.begin();
              it != fake_cells_non_local.end();
@@ -724,6 +1149,91 @@ public:
             }
         }
     }
+
+    /**
+     * Write the state variables of all the cells on this process, in the order they are archived,
+     * to a raw array of doubles in the file "cell_state_variables.raw.<rank>" in the archive directory.
+     * This is much smaller and quicker to write than archiving each cell's state variables as part of
+     * the cell, and the file may be memory-mapped by other tools.
+     *
+     * @param rank  the rank of this process, used to name the file
+     * @return the number of values written
+     */
+    unsigned SaveCellStateVariables(unsigned rank) const
+    {
+        std::vector<double> state_variables;
+        const std::vector<AbstractCardiacCellInterface*> & r_cells_distributed = rGetCellsDistributed();
+        for (unsigned i=0; i<r_cells_distributed.size(); i++)
+        {
+            std::vector<double> cell_state = r_cells_distributed[i]->GetStdVecStateVariables();
+            state_variables.insert(state_variables.end(), cell_state.begin(), cell_state.end());
+            if (mHasPurkinje)
+            {
+                std::vector<double> purkinje_state = rGetPurkinjeCellsDistributed()[i]->GetStdVecStateVariables();
+                state_variables.insert(state_variables.end(), purkinje_state.begin(), purkinje_state.end());
+            }
+        }
+
+        std::string path = ArchiveLocationInfo::GetProcessUniqueFilePath("cell_state_variables.raw", rank);
+        std::ofstream raw_file(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!raw_file.is_open())
+        {
+            EXCEPTION("Unable to open cell state variables file: " + path);
+        }
+        if (!state_variables.empty())
+        {
+            raw_file.write(reinterpret_cast<const char*>(&state_variables[0]), state_variables.size()*sizeof(double));
+        }
+        return state_variables.size();
+    }
+
+    /**
+     * Read the state variables written by SaveCellStateVariables() on a given process.
+     *
+     * @param rank  the rank of the process that wrote the file
+     * @param numValues  the number of values it wrote
+     * @param rStateVariables  filled in with the values
+     */
+    void LoadCellStateVariables(unsigned rank, unsigned numValues, std::vector<double>& rStateVariables)
+    {
+        std::string path = ArchiveLocationInfo::GetProcessUniqueFilePath("cell_state_variables.raw", rank);
+        std::ifstream raw_file(path.c_str(), std::ios::binary);
+        if (!raw_file.is_open())
+        {
+            EXCEPTION("Unable to open cell state variables file: " + path);
+        }
+        raw_file.seekg(0, std::ios::end);
+        if (raw_file.tellg() != std::streampos(numValues*sizeof(double)))
+        {
+            EXCEPTION("Cell state variables file has the wrong size: " + path);
+        }
+        raw_file.seekg(0, std::ios::beg);
+        rStateVariables.resize(numValues);
+        if (numValues > 0)
+        {
+            raw_file.read(reinterpret_cast<char*>(&rStateVariables[0]), numValues*sizeof(double));
+        }
+    }
+
+    /**
+     * Set the state variables of a cell just loaded from an archive written with
+     * ArchiveLocationInfo::GetStateVariablesInSeparateArrays().
+     *
+     * @param pCell  the cell
+     * @param rStateVariables  the state variables of all the cells in the archive
+     * @param rOffset  the position of this cell's state variables; moved on past them
+     */
+    void SetCellStateVariables(AbstractCardiacCellInterface* pCell,
+                               const std::vector<double>& rStateVariables,
+                               unsigned& rOffset)
+    {
+        const unsigned num_state_variables = pCell->GetNumberOfStateVariables();
+        assert(rOffset + num_state_variables <= rStateVariables.size());
+        std::vector<double> cell_state(rStateVariables.begin() + rOffset,
+                                       rStateVariables.begin() + rOffset + num_state_variables);
+        pCell->SetStateVariables(cell_state);
+        rOffset += num_state_variables;
+    }
 };
 
 TEMPLATED_CLASS_IS_ABSTRACT_2_UNSIGNED(AbstractCardiacTissue)
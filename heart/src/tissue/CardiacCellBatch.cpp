@@ -0,0 +1,439 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "CardiacCellBatch.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <typeinfo>
+
+#include "AbstractGeneralizedRushLarsenCardiacCell.hpp"
+#include "EulerIvpOdeSolver.hpp"
+#include "FakeBathCell.hpp"
+#include "TimeStepper.hpp"
+#include "Exception.hpp"
+
+CardiacCellBatch::BatchSolverType CardiacCellBatch::GetBatchSolverType(AbstractCardiacCellInterface* pCell)
+{
+    if (dynamic_cast<FakeBathCell*>(pCell))
+    {
+        return NOT_BATCHABLE;
+    }
+
+    AbstractRushLarsenCardiacCell* p_rush_larsen_cell = dynamic_cast<AbstractRushLarsenCardiacCell*>(pCell);
+    if (p_rush_larsen_cell)
+    {
+        std::vector<AbstractRushLarsenCardiacCell::RushLarsenUpdateType> update_types;
+        std::vector<double> time_scale_factors;
+        if (p_rush_larsen_cell->GetRushLarsenUpdateInformation(update_types, time_scale_factors))
+        {
+            return RUSH_LARSEN;
+        }
+        return NOT_BATCHABLE;
+    }
+
+    if (dynamic_cast<AbstractGeneralizedRushLarsenCardiacCell*>(pCell))
+    {
+        return GENERALIZED_RUSH_LARSEN;
+    }
+
+    AbstractCardiacCell* p_cell = dynamic_cast<AbstractCardiacCell*>(pCell);
+    if (p_cell)
+    {
+        boost::shared_ptr<AbstractIvpOdeSolver> p_solver = p_cell->GetSolver();
+        if (p_solver && typeid(*p_solver) == typeid(EulerIvpOdeSolver))
+        {
+            return FORWARD_EULER;
+        }
+    }
+
+    // CVODE cells, backward Euler cells and cells using other solvers are solved one at a time
+    return NOT_BATCHABLE;
+}
+
+bool CardiacCellBatch::AreCompatible(AbstractCardiacCellInterface* pCell, AbstractCardiacCellInterface* pOtherCell)
+{
+    BatchSolverType solver_type = GetBatchSolverType(pCell);
+    if (solver_type == NOT_BATCHABLE
+        || typeid(*pCell) != typeid(*pOtherCell)
+        || solver_type != GetBatchSolverType(pOtherCell))
+    {
+        return false;
+    }
+    // Both cells are AbstractCardiacCell subclasses if we get this far
+    return static_cast<AbstractCardiacCell*>(pCell)->GetTimestep() == static_cast<AbstractCardiacCell*>(pOtherCell)->GetTimestep();
+}
+
+CardiacCellBatch::CardiacCellBatch(AbstractCardiacCellInterface* pFirstCell, unsigned localIndex)
+    : mSolverType(GetBatchSolverType(pFirstCell)),
+      mNumStateVariables(pFirstCell->GetNumberOfStateVariables()),
+      mVoltageIndex(pFirstCell->GetVoltageIndex()),
+      mFailedCellIndex(UNSIGNED_UNSET)
+{
+    assert(mSolverType != NOT_BATCHABLE);
+    AbstractCardiacCell* p_cell = static_cast<AbstractCardiacCell*>(pFirstCell);
+    mDt = p_cell->GetTimestep();
+
+    if (mSolverType == RUSH_LARSEN)
+    {
+        static_cast<AbstractRushLarsenCardiacCell*>(p_cell)->GetRushLarsenUpdateInformation(mRushLarsenUpdateTypes,
+                                                                                          mRushLarsenTimeScaleFactors);
+        assert(mRushLarsenUpdateTypes.size() == mNumStateVariables);
+        assert(mRushLarsenTimeScaleFactors.size() == mNumStateVariables);
+    }
+
+    mCellY.resize(mNumStateVariables);
+    mCellDY.resize(mNumStateVariables);
+    mCellAlphaOrTau.resize(mNumStateVariables);
+    mCellBetaOrInf.resize(mNumStateVariables);
+
+    mCells.push_back(p_cell);
+    mLocalIndices.push_back(localIndex);
+}
+
+void CardiacCellBatch::AddCell(AbstractCardiacCellInterface* pCell, unsigned localIndex)
+{
+    assert(AreCompatible(mCells[0], pCell));
+    mCells.push_back(static_cast<AbstractCardiacCell*>(pCell));
+    mLocalIndices.push_back(localIndex);
+}
+
+unsigned CardiacCellBatch::GetNumCells() const
+{
+    return mCells.size();
+}
+
+CardiacCellBatch::BatchSolverType CardiacCellBatch::GetSolverType() const
+{
+    return mSolverType;
+}
+
+const std::vector<unsigned>& CardiacCellBatch::rGetLocalIndices() const
+{
+    return mLocalIndices;
+}
+
+unsigned CardiacCellBatch::GetFailedCellIndex() const
+{
+    return mFailedCellIndex;
+}
+
+void CardiacCellBatch::Solve(double tStart, double tEnd, bool updateVoltage)
+{
+    mFailedCellIndex = UNSIGNED_UNSET;
+    const unsigned num_cells = mCells.size();
+
+    if (!updateVoltage)
+    {
+        // This also fixes the voltage used to evaluate the other derivatives
+        for (unsigned j=0; j<num_cells; j++)
+        {
+            mCells[j]->SetVoltageDerivativeToZero(true);
+        }
+    }
+
+    /*
+     * Check state variables are still in range exactly when the single-cell solves would:
+     * after every step for Rush-Larsen cells, but only at the end of the interval (and only
+     * when the voltage is held fixed) for cells using EulerIvpOdeSolver.  When the voltage
+     * is held fixed the checks are only made in debug builds.
+     */
+    bool verify_state_variables = updateVoltage;
+#ifndef NDEBUG
+    verify_state_variables = true;
+#endif // NDEBUG
+
+    try
+    {
+        switch (mSolverType)
+        {
+            case FORWARD_EULER:
+                SolveForwardEuler(tStart, tEnd, updateVoltage);
+                if (verify_state_variables && !updateVoltage)
+                {
+                    VerifyStateVariables();
+                }
+                break;
+            case RUSH_LARSEN:
+                SolveRushLarsen(tStart, tEnd, updateVoltage, verify_state_variables);
+                break;
+            case GENERALIZED_RUSH_LARSEN:
+                SolveGeneralizedRushLarsen(tStart, tEnd, updateVoltage, verify_state_variables);
+                break;
+            default:
+                NEVER_REACHED;
+        }
+    }
+    catch (Exception& e)
+    {
+        if (!updateVoltage)
+        {
+            for (unsigned j=0; j<num_cells; j++)
+            {
+                mCells[j]->SetVoltageDerivativeToZero(false);
+            }
+        }
+        throw e;
+    }
+
+    if (!updateVoltage)
+    {
+        for (unsigned j=0; j<num_cells; j++)
+        {
+            mCells[j]->SetVoltageDerivativeToZero(false);
+        }
+    }
+}
+
+void CardiacCellBatch::VerifyStateVariables()
+{
+    for (unsigned j=0; j<mCells.size(); j++)
+    {
+        mFailedCellIndex = j;
+        mCells[j]->VerifyStateVariables();
+    }
+    mFailedCellIndex = UNSIGNED_UNSET;
+}
+
+void CardiacCellBatch::GatherStateVariables()
+{
+    const unsigned num_cells = mCells.size();
+    mStateVariables.resize(mNumStateVariables*num_cells);
+    for (unsigned j=0; j<num_cells; j++)
+    {
+        const std::vector<double>& r_y = mCells[j]->rGetStateVariables();
+        for (unsigned i=0; i<mNumStateVariables; i++)
+        {
+            mStateVariables[i*num_cells + j] = r_y[i];
+        }
+    }
+}
+
+void CardiacCellBatch::ScatterStateVariables()
+{
+    const unsigned num_cells = mCells.size();
+    for (unsigned j=0; j<num_cells; j++)
+    {
+        GetCellStateVariables(j, mCells[j]->rGetStateVariables());
+    }
+}
+
+void CardiacCellBatch::GetCellStateVariables(unsigned cellIndex, std::vector<double>& rY)
+{
+    const unsigned num_cells = mCells.size();
+    for (unsigned i=0; i<mNumStateVariables; i++)
+    {
+        rY[i] = mStateVariables[i*num_cells + cellIndex];
+    }
+}
+
+void CardiacCellBatch::SolveForwardEuler(double tStart, double tEnd, bool updateVoltage)
+{
+    const unsigned num_cells = mCells.size();
+    GatherStateVariables();
+    mDerivatives.resize(mStateVariables.size());
+
+    TimeStepper stepper(tStart, tEnd, mDt);
+    while (!stepper.IsTimeAtEnd())
+    {
+        const double time = stepper.GetTime();
+        const double dt = stepper.GetNextTimeStep();
+
+        // Evaluate the model equations cell by cell...
+        for (unsigned j=0; j<num_cells; j++)
+        {
+            GetCellStateVariables(j, mCellY);
+            try
+            {
+                mCells[j]->EvaluateYDerivatives(time, mCellY, mCellDY);
+            }
+            catch (Exception& e)
+            {
+                mFailedCellIndex = j;
+                ScatterStateVariables();
+                throw e;
+            }
+            for (unsigned i=0; i<mNumStateVariables; i++)
+            {
+                mDerivatives[i*num_cells + j] = mCellDY[i];
+            }
+        }
+
+        // ...then update each state variable for the whole batch at once
+        for (unsigned i=0; i<mNumStateVariables; i++)
+        {
+            if (i == mVoltageIndex && !updateVoltage)
+            {
+                continue;
+            }
+            double* p_y = &mStateVariables[i*num_cells];
+            const double* p_dy = &mDerivatives[i*num_cells];
+            for (unsigned j=0; j<num_cells; j++)
+            {
+                p_y[j] += dt*p_dy[j];
+            }
+        }
+
+        stepper.AdvanceOneTimeStep();
+    }
+
+    ScatterStateVariables();
+}
+
+void CardiacCellBatch::SolveRushLarsen(double tStart, double tEnd, bool updateVoltage, bool verifyEachStep)
+{
+    const unsigned num_cells = mCells.size();
+    GatherStateVariables();
+    mDerivatives.resize(mStateVariables.size());
+    mAlphaOrTau.resize(mStateVariables.size());
+    mBetaOrInf.resize(mStateVariables.size());
+
+    TimeStepper stepper(tStart, tEnd, mDt);
+    while (!stepper.IsTimeAtEnd())
+    {
+        const double time = stepper.GetTime();
+
+        // Evaluate the model equations cell by cell.  The generated EvaluateEquations
+        // reads the cell's own state, so this has to be kept up to date.
+        for (unsigned j=0; j<num_cells; j++)
+        {
+            AbstractRushLarsenCardiacCell* p_cell = static_cast<AbstractRushLarsenCardiacCell*>(mCells[j]);
+            GetCellStateVariables(j, p_cell->rGetStateVariables());
+            try
+            {
+                p_cell->EvaluateEquations(time, mCellDY, mCellAlphaOrTau, mCellBetaOrInf);
+            }
+            catch (Exception& e)
+            {
+                mFailedCellIndex = j;
+                ScatterStateVariables();
+                throw e;
+            }
+            for (unsigned i=0; i<mNumStateVariables; i++)
+            {
+                mDerivatives[i*num_cells + j] = mCellDY[i];
+                mAlphaOrTau[i*num_cells + j] = mCellAlphaOrTau[i];
+                mBetaOrInf[i*num_cells + j] = mCellBetaOrInf[i];
+            }
+        }
+
+        // Update each state variable for the whole batch at once
+        for (unsigned i=0; i<mNumStateVariables; i++)
+        {
+            double* p_y = &mStateVariables[i*num_cells];
+            const double* p_dy = &mDerivatives[i*num_cells];
+            const double* p_alpha_or_tau = &mAlphaOrTau[i*num_cells];
+            const double* p_beta_or_inf = &mBetaOrInf[i*num_cells];
+            const double scaled_dt = mDt*mRushLarsenTimeScaleFactors[i];
+
+            switch (mRushLarsenUpdateTypes[i])
+            {
+                case AbstractRushLarsenCardiacCell::NO_UPDATE:
+                    // The transmembrane potential is updated by forward Euler, if at all
+                    if (updateVoltage)
+                    {
+                        for (unsigned j=0; j<num_cells; j++)
+                        {
+                            p_y[j] += mDt*p_dy[j];
+                        }
+                    }
+                    break;
+                case AbstractRushLarsenCardiacCell::FORWARD_EULER_UPDATE:
+                    for (unsigned j=0; j<num_cells; j++)
+                    {
+                        p_y[j] += mDt*p_dy[j];
+                    }
+                    break;
+                case AbstractRushLarsenCardiacCell::ALPHA_BETA_UPDATE:
+                    for (unsigned j=0; j<num_cells; j++)
+                    {
+                        const double tau_inv = p_alpha_or_tau[j] + p_beta_or_inf[j];
+                        const double y_inf = p_alpha_or_tau[j] / tau_inv;
+                        p_y[j] = y_inf + (p_y[j] - y_inf)*exp(-scaled_dt*tau_inv);
+                    }
+                    break;
+                case AbstractRushLarsenCardiacCell::TAU_INF_UPDATE:
+                    for (unsigned j=0; j<num_cells; j++)
+                    {
+                        p_y[j] = p_beta_or_inf[j] + (p_y[j] - p_beta_or_inf[j])*exp(-scaled_dt/p_alpha_or_tau[j]);
+                    }
+                    break;
+                default:
+                    NEVER_REACHED;
+            }
+        }
+
+        if (verifyEachStep)
+        {
+            ScatterStateVariables();
+            VerifyStateVariables();
+        }
+
+        stepper.AdvanceOneTimeStep();
+    }
+
+    ScatterStateVariables();
+}
+
+void CardiacCellBatch::SolveGeneralizedRushLarsen(double tStart, double tEnd, bool updateVoltage, bool verifyEachStep)
+{
+    const unsigned num_cells = mCells.size();
+    for (unsigned j=0; j<num_cells; j++)
+    {
+        AbstractGeneralizedRushLarsenCardiacCell* p_cell = static_cast<AbstractGeneralizedRushLarsenCardiacCell*>(mCells[j]);
+        try
+        {
+            TimeStepper stepper(tStart, tEnd, mDt);
+            while (!stepper.IsTimeAtEnd())
+            {
+                if (updateVoltage)
+                {
+                    p_cell->UpdateTransmembranePotential(stepper.GetTime());
+                }
+                p_cell->ComputeOneStepExceptVoltage(stepper.GetTime());
+                if (verifyEachStep)
+                {
+                    p_cell->VerifyStateVariables();
+                }
+                stepper.AdvanceOneTimeStep();
+            }
+        }
+        catch (Exception& e)
+        {
+            mFailedCellIndex = j;
+            throw e;
+        }
+    }
+}
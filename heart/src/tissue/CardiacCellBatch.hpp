@@ -0,0 +1,242 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef CARDIACCELLBATCH_HPP_
+#define CARDIACCELLBATCH_HPP_
+
+#include <vector>
+#include <boost/utility.hpp>
+
+#include "AbstractCardiacCellInterface.hpp"
+#include "AbstractRushLarsenCardiacCell.hpp"
+
+/**
+ * A group of cardiac cells of the same concrete model type, all owned by this process,
+ * which are advanced together by AbstractCardiacTissue::SolveCellSystems when batched
+ * cell solves are switched on (see AbstractCardiacTissue::SetUseBatchedCellSolve).
+ *
+ * During a solve the state variables of the whole batch are held in a single
+ * structure-of-arrays block, where state variable i of cell j lives at
+ * mStateVariables[i*mNumCells + j].  The model equations are still evaluated by each
+ * cell's generated code, but all the timestepping arithmetic is done as simple loops
+ * over the cells of the batch, which the compiler can vectorise.  The cell objects
+ * remain the definitive store of state, parameters and stimuli between solves, so they
+ * act as a view onto the batch for output, checkpointing and halo exchange.
+ *
+ * The following kinds of cell can be batched:
+ *  - AbstractCardiacCell subclasses solved with an EulerIvpOdeSolver;
+ *  - AbstractRushLarsenCardiacCell subclasses which implement
+ *    AbstractRushLarsenCardiacCell::GetRushLarsenUpdateInformation (all PyCml-generated models do);
+ *  - AbstractGeneralizedRushLarsenCardiacCell subclasses (GRL1 and GRL2).  The GRL update
+ *    needs partial derivatives which only the generated code can compute, so these cells
+ *    are stepped in place by the batch time loop rather than through the state block.
+ */
+class CardiacCellBatch : private boost::noncopyable
+{
+public:
+    /** The timestepping kernels available for a batch. */
+    typedef enum BatchSolverType_
+    {
+        NOT_BATCHABLE=0,
+        FORWARD_EULER,
+        RUSH_LARSEN,
+        GENERALIZED_RUSH_LARSEN
+    } BatchSolverType;
+
+    /**
+     * @return which batch kernel (if any) can solve the given cell.
+     *
+     * @param pCell  the cell
+     */
+    static BatchSolverType GetBatchSolverType(AbstractCardiacCellInterface* pCell);
+
+    /**
+     * @return whether two cells can live in the same batch: they must be of the same
+     * concrete type, use the same batch kernel and have the same timestep.
+     *
+     * @param pCell  a cell
+     * @param pOtherCell  another cell
+     */
+    static bool AreCompatible(AbstractCardiacCellInterface* pCell, AbstractCardiacCellInterface* pOtherCell);
+
+    /**
+     * Constructor.  The first cell determines the model type of the batch.
+     *
+     * @param pFirstCell  the first cell of the batch
+     * @param localIndex  its index within AbstractCardiacTissue's vector of distributed cells
+     */
+    CardiacCellBatch(AbstractCardiacCellInterface* pFirstCell, unsigned localIndex);
+
+    /**
+     * Add a further cell to the batch.
+     *
+     * @param pCell  the cell, which must be compatible with those already in the batch
+     * @param localIndex  its index within AbstractCardiacTissue's vector of distributed cells
+     */
+    void AddCell(AbstractCardiacCellInterface* pCell, unsigned localIndex);
+
+    /** @return the number of cells in this batch. */
+    unsigned GetNumCells() const;
+
+    /** @return the kernel used to solve this batch. */
+    BatchSolverType GetSolverType() const;
+
+    /** @return the local (i.e. distributed vector) indices of the cells in this batch. */
+    const std::vector<unsigned>& rGetLocalIndices() const;
+
+    /**
+     * @return the position within this batch of the cell whose solve failed, if the
+     * last call to Solve threw an exception.
+     */
+    unsigned GetFailedCellIndex() const;
+
+    /**
+     * Simulate all the cells in the batch between the two times provided.  The voltage of
+     * each cell should already have been set with SetVoltage.
+     *
+     * If the solve fails the exception is propagated, with GetFailedCellIndex() identifying
+     * the offending cell, whose state variables are those at the time of failure.
+     *
+     * @param tStart  the start of the time interval
+     * @param tEnd  the end of the time interval
+     * @param updateVoltage  whether to also solve for the voltage (as in
+     *     AbstractCardiacCellInterface::SolveAndUpdateState) rather than holding it fixed
+     *     (as in AbstractCardiacCellInterface::ComputeExceptVoltage)
+     */
+    void Solve(double tStart, double tEnd, bool updateVoltage);
+
+private:
+    /** The cells in this batch (all batchable models are AbstractCardiacCell subclasses). */
+    std::vector<AbstractCardiacCell*> mCells;
+
+    /** Their indices within AbstractCardiacTissue's vector of distributed cells. */
+    std::vector<unsigned> mLocalIndices;
+
+    /** The kernel used to solve this batch. */
+    BatchSolverType mSolverType;
+
+    /** The number of state variables in this cell model. */
+    unsigned mNumStateVariables;
+
+    /** The index of the transmembrane potential within the state variables. */
+    unsigned mVoltageIndex;
+
+    /** The ODE timestep shared by all cells in the batch. */
+    double mDt;
+
+    /** Position within the batch of the cell whose solve failed, if any. */
+    unsigned mFailedCellIndex;
+
+    /** Structure-of-arrays state variable block; variable i of cell j is at [i*GetNumCells() + j]. */
+    std::vector<double> mStateVariables;
+
+    /** Structure-of-arrays block of derivatives, laid out as #mStateVariables. */
+    std::vector<double> mDerivatives;
+
+    /** Structure-of-arrays block of alpha or tau values (Rush-Larsen only), laid out as #mStateVariables. */
+    std::vector<double> mAlphaOrTau;
+
+    /** Structure-of-arrays block of beta or inf values (Rush-Larsen only), laid out as #mStateVariables. */
+    std::vector<double> mBetaOrInf;
+
+    /** The update applied to each variable by a Rush-Larsen step. */
+    std::vector<AbstractRushLarsenCardiacCell::RushLarsenUpdateType> mRushLarsenUpdateTypes;
+
+    /** Units conversion factors applied to the timestep in each Rush-Larsen update. */
+    std::vector<double> mRushLarsenTimeScaleFactors;
+
+    /** Working memory for the state of a single cell. */
+    std::vector<double> mCellY;
+
+    /** Working memory for the derivatives of a single cell. */
+    std::vector<double> mCellDY;
+
+    /** Working memory for the alpha or tau values of a single cell. */
+    std::vector<double> mCellAlphaOrTau;
+
+    /** Working memory for the beta or inf values of a single cell. */
+    std::vector<double> mCellBetaOrInf;
+
+    /**
+     * Check the state variables of every cell are in range.  If not, the exception is
+     * propagated with #mFailedCellIndex identifying the offending cell.
+     */
+    void VerifyStateVariables();
+
+    /** Copy the state of every cell into #mStateVariables. */
+    void GatherStateVariables();
+
+    /** Copy #mStateVariables back into the cells. */
+    void ScatterStateVariables();
+
+    /**
+     * Copy the state of one cell in the block into a vector.
+     *
+     * @param cellIndex  position of the cell in the batch
+     * @param rY  vector to fill in
+     */
+    void GetCellStateVariables(unsigned cellIndex, std::vector<double>& rY);
+
+    /**
+     * Advance the batch using forward Euler steps.
+     *
+     * @param tStart  the start of the time interval
+     * @param tEnd  the end of the time interval
+     * @param updateVoltage  whether to update the voltage too
+     */
+    void SolveForwardEuler(double tStart, double tEnd, bool updateVoltage);
+
+    /**
+     * Advance the batch using Rush-Larsen steps.
+     *
+     * @param tStart  the start of the time interval
+     * @param tEnd  the end of the time interval
+     * @param updateVoltage  whether to update the voltage too (with forward Euler)
+     * @param verifyEachStep  whether to check the state variables are in range after each step
+     */
+    void SolveRushLarsen(double tStart, double tEnd, bool updateVoltage, bool verifyEachStep);
+
+    /**
+     * Advance the batch using the models' own GRL1 or GRL2 steps.
+     *
+     * @param tStart  the start of the time interval
+     * @param tEnd  the end of the time interval
+     * @param updateVoltage  whether to update the voltage too
+     * @param verifyEachStep  whether to check the state variables are in range after each step
+     */
+    void SolveGeneralizedRushLarsen(double tStart, double tEnd, bool updateVoltage, bool verifyEachStep);
+};
+
+#endif // CARDIACCELLBATCH_HPP_
@@ -422,6 +422,15 @@ boost::shared_ptr<AbstractStimulusFunction> ExtendedBidomainTissue<SPACE_DIM>::G
     return mExtracellularStimuliDistributed[globalIndex - this->mpDistributedVectorFactory->GetLow()];
 }
 
+template <unsigned SPACE_DIM>
+void ExtendedBidomainTissue<SPACE_DIM>::SetUseDistributedCaches(bool useDistributedCaches)
+{
+    if (useDistributedCaches)
+    {
+        EXCEPTION("Distributed caches are not supported for extended bidomain tissues.");
+    }
+}
+
 template <unsigned SPACE_DIM>
 void ExtendedBidomainTissue<SPACE_DIM>::SolveCellSystems(Vec existingSolution, double time, double nextTime, bool updateVoltage)
 {
@@ -409,6 +409,14 @@ public:
       */
      void SetUserSuppliedExtracellularStimulus(bool flag);
 
+     /**
+      * Overridden method.  Distributed caches are not supported, since the extended bidomain
+      * solver reads the replicated caches of both cells, the extracellular stimulus and ggap.
+      *
+      * @param useDistributedCaches  whether to use distributed caches (must be false)
+      */
+     void SetUseDistributedCaches(bool useDistributedCaches=true);
+
 
      /**
       * This method is the equivalent of SaveCardiacCells in the abstract class but save both cells of the extended bidomain tissue
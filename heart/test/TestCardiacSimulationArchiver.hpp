@@ -45,6 +45,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedVector.hpp"
 #include "DistributedVectorFactory.hpp"
 #include "ArchiveOpener.hpp"
+#include "ArchiveLocationInfo.hpp"
 #include "ChasteSyscalls.hpp"
 
 #include "AbstractCardiacCellInterface.hpp"
@@ -263,6 +264,114 @@ public:
         }
     }
 
+    void TestBinaryArchivingWithHelperClass()
+    {
+        std::string archive_dir("bidomain_problem_binary_archive_helper");
+
+        // Save, as above but with binary archives
+        {
+            HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+            HeartConfig::Instance()->SetExtracellularConductivities(Create_c_vector(0.0005));
+            HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1mm_10_elements");
+            HeartConfig::Instance()->SetOutputDirectory("BiProblemBinaryArchiveHelper");
+            HeartConfig::Instance()->SetOutputFilenamePrefix("BidomainLR91_1d");
+            HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+            HeartConfig::Instance()->SetCapacitance(1.0);
+            HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01, 0.01, 0.1);
+
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+            BidomainProblem<1> bidomain_problem( &cell_factory );
+
+            bidomain_problem.Initialise();
+            HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+            bidomain_problem.Solve();
+
+            CardiacSimulationArchiver<BidomainProblem<1> >::Save(bidomain_problem, archive_dir, false, true);
+            // And the same state as a text checkpoint, to compare against
+            CardiacSimulationArchiver<BidomainProblem<1> >::Save(bidomain_problem, archive_dir + "_text", false);
+            TS_ASSERT(!ArchiveLocationInfo::GetStateVariablesInSeparateArrays());
+
+            // The state variables of the cells on this process are a raw array of doubles
+            unsigned num_local_cells = bidomain_problem.rGetMesh().GetDistributedVectorFactory()->GetLocalOwnership();
+            FileFinder raw_file(ArchiveLocationInfo::GetProcessUniqueFilePath("cell_state_variables.raw"), RelativeTo::Absolute);
+            TS_ASSERT(raw_file.Exists());
+            std::ifstream raw_stream(raw_file.GetAbsolutePath().c_str(), std::ios::binary | std::ios::ate);
+            TS_ASSERT_EQUALS(raw_stream.tellg(), std::streampos(num_local_cells*8u*sizeof(double))); // LR91 has 8 state variables
+        }
+
+        // Loading the binary checkpoint gives the same cells and solution as loading the text one
+        {
+            BidomainProblem<1>* p_text_problem = CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir + "_text");
+            BidomainProblem<1>* p_binary_problem = CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir);
+            TS_ASSERT(!ArchiveLocationInfo::GetStateVariablesInSeparateArrays());
+
+            DistributedVectorFactory* p_factory = p_binary_problem->rGetMesh().GetDistributedVectorFactory();
+            for (unsigned node_index=p_factory->GetLow(); node_index<p_factory->GetHigh(); node_index++)
+            {
+                std::vector<double> text_state = p_text_problem->GetTissue()->GetCardiacCell(node_index)->GetStdVecStateVariables();
+                std::vector<double> binary_state = p_binary_problem->GetTissue()->GetCardiacCell(node_index)->GetStdVecStateVariables();
+                TS_ASSERT_EQUALS(binary_state.size(), text_state.size());
+                for (unsigned i=0; i<binary_state.size(); i++)
+                {
+                    // Allow for rounding in the text archive
+                    TS_ASSERT_DELTA(binary_state[i], text_state[i], 1e-12*std::max(1.0, fabs(text_state[i])));
+                }
+            }
+
+            ReplicatableVector text_solution(p_text_problem->GetSolution());
+            ReplicatableVector binary_solution(p_binary_problem->GetSolution());
+            TS_ASSERT_EQUALS(binary_solution.GetSize(), text_solution.GetSize());
+            for (unsigned index=0; index<binary_solution.GetSize(); index++)
+            {
+                TS_ASSERT_EQUALS(binary_solution[index], text_solution[index]);
+            }
+
+            delete p_text_problem;
+            delete p_binary_problem;
+        }
+
+        // The format is recorded in the information file
+        FileFinder info_file(archive_dir + "/archive.info", RelativeTo::ChasteTestOutput);
+        {
+            std::ifstream info_stream(info_file.GetAbsolutePath().c_str());
+            unsigned num_procs, archive_version;
+            std::string archive_format;
+            info_stream >> num_procs >> archive_version >> archive_format;
+            TS_ASSERT_EQUALS(num_procs, PetscTools::GetNumProcs());
+            TS_ASSERT_EQUALS(archive_format, "binary");
+        }
+
+        // Load and run on to the end of the original simulation
+        {
+            HeartConfig::Instance()->SetOutputDirectory("BiProblemBinaryArchiveHelper_moved");
+            BidomainProblem<1>* p_bidomain_problem = CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir);
+
+            HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+            p_bidomain_problem->Solve();
+
+            ReplicatableVector solution_replicated(p_bidomain_problem->GetSolution());
+            TS_ASSERT_EQUALS(solution_replicated.GetSize(), mSolutionReplicated1d2ms.size());
+            for (unsigned index=0; index<solution_replicated.GetSize(); index++)
+            {
+                // Shouldn't differ from the original run at all
+                TS_ASSERT_DELTA(solution_replicated[index], mSolutionReplicated1d2ms[index], 5e-11);
+            }
+
+            delete p_bidomain_problem;
+        }
+
+        // An information file naming an unknown format
+        PetscTools::Barrier("TestBinaryArchivingWithHelperClass");
+        if (PetscTools::AmMaster())
+        {
+            std::ofstream info_stream(info_file.GetAbsolutePath().c_str());
+            info_stream << PetscTools::GetNumProcs() << " 0 xml";
+        }
+        PetscTools::Barrier("TestBinaryArchivingWithHelperClass-2");
+        TS_ASSERT_THROWS_CONTAINS(CardiacSimulationArchiver<BidomainProblem<1> >::Load(archive_dir),
+                                  "Unknown archive format 'xml' in archive information file: ");
+    }
+
     /**
      *  Test used to generate data for the acceptance test resume_bidomain. We run the same simulation as in save_bidomain
      *  and archive it. resume_bidomain will load it and resume the simulation.
@@ -1252,6 +1252,18 @@ public:
         HeartConfig::Instance()->SetUseFixedNumberIterationsLinearSolver(true, 20);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseFixedNumberIterationsLinearSolver(), true);
         TS_ASSERT_EQUALS(HeartConfig::Instance()->GetEvaluateNumItsEveryNSolves(), 20u);
+
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetOutputCacheSize(), 0u);
+        HeartConfig::Instance()->SetOutputCacheSize(10u);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetOutputCacheSize(), 10u);
+        HeartConfig::Instance()->SetOutputCacheSize(0u);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetOutputCacheSize(), 0u);
+
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseInSituPostProcessing(), false);
+        HeartConfig::Instance()->SetUseInSituPostProcessing();
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseInSituPostProcessing(), true);
+        HeartConfig::Instance()->SetUseInSituPostProcessing(false);
+        TS_ASSERT_EQUALS(HeartConfig::Instance()->GetUseInSituPostProcessing(), false);
     }
 
     void TestPostProcessingFunctions() throw (Exception)
@@ -211,6 +211,12 @@ public:
             TS_ASSERT_EQUALS(extended_bidomain_tissue.rGetIntracellularStimulusCacheReplicatedSecondCell()[node_index], 0);
         }
 
+        // The solver reads replicated caches, so distributed caches are rejected
+        TS_ASSERT_THROWS_THIS(extended_bidomain_tissue.SetUseDistributedCaches(),
+                              "Distributed caches are not supported for extended bidomain tissues.");
+        TS_ASSERT_EQUALS(extended_bidomain_tissue.GetUseDistributedCaches(), false);
+        extended_bidomain_tissue.SetUseDistributedCaches(false);
+
         PetscTools::Destroy(extended_vec);
     }
 
@@ -0,0 +1,165 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTLOOKUPTABLECOLLECTION_HPP_
+#define TESTLOOKUPTABLECOLLECTION_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include "AbstractLookupTableCollection.hpp"
+
+#include "FakePetscSetup.hpp"
+
+/**
+ * Tables keyed on voltage, held by the base class.  There is also a second keying
+ * variable whose tables aren't held by the base class.
+ */
+class SimpleLookupTableCollection : public AbstractLookupTableCollection
+{
+public:
+    SimpleLookupTableCollection()
+    {
+        mKeyingVariableNames.push_back("membrane_voltage");
+        mKeyingVariableNames.push_back("time");
+        for (unsigned i=0; i<2; i++)
+        {
+            mNumberOfTables.push_back(2u);
+            mTableMins.push_back(-100.0);
+            mTableSteps.push_back(0.5);
+            mTableStepInverses.push_back(2.0);
+            mTableMaxs.push_back(50.0);
+            mNeedsRegeneration.push_back(true);
+        }
+        RegenerateTables();
+    }
+
+    void RegenerateTables()
+    {
+        if (mNeedsRegeneration[0])
+        {
+            double* p_tables = AllocateTableStorage(0);
+            const unsigned size = GetTableSize(mTableMins[0], mTableSteps[0], mTableMaxs[0]);
+            if (IsTableStorageWriter(0))
+            {
+                for (unsigned i=0; i<size; i++)
+                {
+                    const double v = mTableMins[0] + i*mTableSteps[0];
+                    p_tables[2*i] = 2.0*v + 1.0;
+                    p_tables[2*i+1] = v*v;
+                }
+            }
+            mNeedsRegeneration[0] = false;
+        }
+    }
+
+    /**
+     * @return the value of a voltage table at a table point.
+     *
+     * @param pointIndex  the index of the table point
+     * @param tableIndex  which table
+     */
+    double GetTableValue(unsigned pointIndex, unsigned tableIndex) const
+    {
+        return mTableData[0]->GetData()[pointIndex*mNumberOfTables[0] + tableIndex];
+    }
+
+    /** @return the number of values held for the voltage tables. */
+    unsigned GetTableStorageSize() const
+    {
+        return mTableData[0]->GetSize();
+    }
+
+    /** @return whether this process computes the tables keyed on time, which we don't hold. */
+    bool IsTimeTableStorageWriter() const
+    {
+        return IsTableStorageWriter(1);
+    }
+};
+
+class TestLookupTableCollection : public CxxTest::TestSuite
+{
+public:
+    void TestTableStorage() throw(Exception)
+    {
+        SimpleLookupTableCollection tables;
+
+        // The values for each table point are stored together
+        TS_ASSERT_EQUALS(tables.GetTableStorageSize(), 2u*301u);
+        TS_ASSERT_DELTA(tables.GetTableValue(0u, 0u), -199.0, 1e-12);
+        TS_ASSERT_DELTA(tables.GetTableValue(0u, 1u), 10000.0, 1e-12);
+        TS_ASSERT_DELTA(tables.GetTableValue(240u, 0u), 41.0, 1e-12);
+        TS_ASSERT_DELTA(tables.GetTableValue(240u, 1u), 400.0, 1e-12);
+        TS_ASSERT_DELTA(tables.GetTableValue(300u, 1u), 2500.0, 1e-12);
+
+        // Tables whose memory we don't hold are always filled by their owner
+        TS_ASSERT_EQUALS(tables.IsTimeTableStorageWriter(), true);
+
+        // Changing the table properties changes the storage
+        tables.SetTableProperties("membrane_voltage", -50.0, 0.25, 60.0);
+        tables.RegenerateTables();
+        TS_ASSERT_EQUALS(tables.GetTableStorageSize(), 2u*441u);
+        TS_ASSERT_DELTA(tables.GetTableValue(0u, 0u), -99.0, 1e-12);
+        TS_ASSERT_DELTA(tables.GetTableValue(440u, 1u), 3600.0, 1e-12);
+
+        TS_ASSERT_THROWS_THIS(tables.SetTableProperties("membrane_voltage", -50.0, 0.3, 60.0),
+                              "Table step size does not divide range between table limits.");
+    }
+
+    void TestTablesInNodeSharedMemory() throw(Exception)
+    {
+        SimpleLookupTableCollection tables;
+        TS_ASSERT_EQUALS(tables.IsUsingNodeSharedMemory(), false);
+        tables.MoveTablesToNodeSharedMemory();
+        TS_ASSERT_EQUALS(tables.IsUsingNodeSharedMemory(), true);
+
+        // The tables hold the same values as before
+        TS_ASSERT_EQUALS(tables.GetTableStorageSize(), 2u*301u);
+        TS_ASSERT_DELTA(tables.GetTableValue(0u, 0u), -199.0, 1e-12);
+        TS_ASSERT_DELTA(tables.GetTableValue(240u, 1u), 400.0, 1e-12);
+
+        // Moving again does nothing, and unchanged settings are fine
+        tables.MoveTablesToNodeSharedMemory();
+        tables.SetTableProperties("membrane_voltage", -100.0, 0.5, 50.0);
+        tables.SetTimestep(0.0);
+
+        // The tables are now read-only
+        TS_ASSERT_THROWS_THIS(tables.SetTableProperties("membrane_voltage", -50.0, 0.25, 60.0),
+                              "Lookup tables in node-shared memory are read-only, so their properties can't be changed.");
+        TS_ASSERT_THROWS_THIS(tables.SetTimestep(0.1),
+                              "Lookup tables in node-shared memory are read-only, so their timestep can't be changed.");
+    }
+};
+
+#endif // TESTLOOKUPTABLECOLLECTION_HPP_
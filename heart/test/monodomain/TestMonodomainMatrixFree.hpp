@@ -0,0 +1,163 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef TESTMONODOMAINMATRIXFREE_HPP_
+#define TESTMONODOMAINMATRIXFREE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "LuoRudy1991BackwardEuler.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "MonodomainProblem.hpp"
+#include "BidomainProblem.hpp"
+#include "ReplicatableVector.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+class TestMonodomainMatrixFree : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * Solve a 2D monodomain problem with the current configuration.
+     *
+     * @param rOutputDirectory  the output directory (and filename prefix)
+     * @return the final voltage
+     */
+    std::vector<double> SolveSheet(const std::string& rOutputDirectory)
+    {
+        HeartConfig::Instance()->SetOutputDirectory(rOutputDirectory);
+        HeartConfig::Instance()->SetOutputFilenamePrefix(rOutputDirectory);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,2> cell_factory(-3e5, 1.0);
+        MonodomainProblem<2> monodomain_problem( &cell_factory );
+        monodomain_problem.Initialise();
+        monodomain_problem.Solve();
+
+        ReplicatableVector solution(monodomain_problem.GetSolution());
+        std::vector<double> voltage(solution.GetSize());
+        for (unsigned i=0; i<solution.GetSize(); i++)
+        {
+            voltage[i] = solution[i];
+        }
+        return voltage;
+    }
+
+public:
+
+    void TestCompareSheetPlaneStimulus() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        HeartConfig::Instance()->SetSimulationDuration(5); //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01,0.1,0.1);
+        HeartConfig::Instance()->SetSheetDimensions(0.3, 0.3, 0.05);
+        HeartConfig::Instance()->SetKSPPreconditioner("jacobi");
+        HeartConfig::Instance()->SetUseAbsoluteTolerance(1e-10);
+
+        std::vector<double> standard_solution = SolveSheet("CompareSheetStandard");
+
+        HeartConfig::Instance()->SetUseMatrixFreeOperators();
+        std::vector<double> matrix_free_solution = SolveSheet("CompareSheetMatrixFree");
+
+        // The operators are the same, so only the linear solver tolerance separates the solutions
+        TS_ASSERT_EQUALS(standard_solution.size(), matrix_free_solution.size());
+        for (unsigned i=0; i<standard_solution.size(); i++)
+        {
+            TS_ASSERT_DELTA(standard_solution[i], matrix_free_solution[i], 1e-6);
+        }
+
+        // And the same with mass lumping
+        HeartConfig::Instance()->SetUseMassLumping();
+        matrix_free_solution = SolveSheet("CompareSheetMatrixFreeLumped");
+        HeartConfig::Instance()->SetUseMatrixFreeOperators(false);
+        standard_solution = SolveSheet("CompareSheetStandardLumped");
+
+        for (unsigned i=0; i<standard_solution.size(); i++)
+        {
+            TS_ASSERT_DELTA(standard_solution[i], matrix_free_solution[i], 1e-6);
+        }
+    }
+
+    void TestBidomainMatrixFreeRhs() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        HeartConfig::Instance()->SetSimulationDuration(2); //ms
+        HeartConfig::Instance()->SetOdePdeAndPrintingTimeSteps(0.01,0.1,0.1);
+        HeartConfig::Instance()->SetFibreLength(1.0, 0.01);
+        HeartConfig::Instance()->SetUseAbsoluteTolerance(1e-10);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,1> cell_factory;
+
+        HeartConfig::Instance()->SetOutputDirectory("BidomainStandardRhs");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("BidomainStandardRhs");
+        BidomainProblem<1> standard_problem( &cell_factory );
+        standard_problem.Initialise();
+        standard_problem.Solve();
+        ReplicatableVector standard_solution(standard_problem.GetSolution());
+
+        HeartConfig::Instance()->SetUseMatrixFreeOperators();
+        HeartConfig::Instance()->SetOutputDirectory("BidomainMatrixFreeRhs");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("BidomainMatrixFreeRhs");
+        BidomainProblem<1> matrix_free_problem( &cell_factory );
+        matrix_free_problem.Initialise();
+        matrix_free_problem.Solve();
+        ReplicatableVector matrix_free_solution(matrix_free_problem.GetSolution());
+
+        TS_ASSERT_EQUALS(standard_solution.GetSize(), matrix_free_solution.GetSize());
+        for (unsigned i=0; i<standard_solution.GetSize(); i++)
+        {
+            TS_ASSERT_DELTA(standard_solution[i], matrix_free_solution[i], 1e-6);
+        }
+    }
+
+    void TestMatrixFreeExceptions() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        HeartConfig::Instance()->SetSimulationDuration(0.1); //ms
+        HeartConfig::Instance()->SetFibreLength(1.0, 0.1);
+        HeartConfig::Instance()->SetOutputDirectory("MatrixFreeExceptions");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("MatrixFreeExceptions");
+        HeartConfig::Instance()->SetUseMatrixFreeOperators();
+        HeartConfig::Instance()->SetKSPPreconditioner("bjacobi");
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,1> cell_factory;
+        MonodomainProblem<1> monodomain_problem( &cell_factory );
+        monodomain_problem.Initialise();
+
+        TS_ASSERT_THROWS_THIS(monodomain_problem.Solve(),
+                "Matrix-free operators can only be used with the jacobi preconditioner (or none), and without mass lumping in the preconditioner.");
+    }
+};
+
+#endif /* TESTMONODOMAINMATRIXFREE_HPP_ */
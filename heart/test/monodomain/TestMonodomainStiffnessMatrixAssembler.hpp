@@ -38,6 +38,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TetrahedralMesh.hpp"
 #include "MonodomainStiffnessMatrixAssembler.hpp"
+#include "MonodomainAssembler.hpp"
+#include "PdeSimulationTime.hpp"
 #include "PetscSetupAndFinalize.hpp"
 #include "LuoRudy1991.hpp"
 #include "PlaneStimulusCellFactory.hpp"
@@ -133,6 +135,59 @@ public:
         PetscTools::Destroy(mat);
     }
 
+    void TestMonodomainAssemblerWithElementMatrixCache() throw(Exception)
+    {
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 0.5, 0.3);
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 2> cell_factory;
+        cell_factory.SetMesh(&mesh);
+        MonodomainTissue<2> monodomain_tissue( &cell_factory );
+
+        Mat mat;
+        Mat cached_mat;
+        PetscTools::SetupMat(mat, mesh.GetNumNodes(), mesh.GetNumNodes(), 9);
+        PetscTools::SetupMat(cached_mat, mesh.GetNumNodes(), mesh.GetNumNodes(), 9);
+
+        MonodomainAssembler<2,2> assembler(&mesh, &monodomain_tissue);
+        MonodomainAssembler<2,2> cached_assembler(&mesh, &monodomain_tissue);
+        TS_ASSERT_EQUALS(cached_assembler.IsElementMatrixCacheBuilt(), false);
+        cached_assembler.BuildElementMatrixCache();
+        TS_ASSERT_EQUALS(cached_assembler.IsElementMatrixCacheBuilt(), true);
+
+        // The cached element matrices must give the same matrix for any time step
+        double time_steps[2] = {0.01, 0.025};
+        for (unsigned step=0; step<2; step++)
+        {
+            PdeSimulationTime::SetPdeTimeStepAndNextTime(time_steps[step], time_steps[step]);
+
+            assembler.SetMatrixToAssemble(mat);
+            assembler.AssembleMatrix();
+            PetscMatTools::Finalise(mat);
+
+            cached_assembler.SetMatrixToAssemble(cached_mat);
+            cached_assembler.AssembleMatrix();
+            PetscMatTools::Finalise(cached_mat);
+
+            int lo, hi;
+            MatGetOwnershipRange(mat, &lo, &hi);
+            for (unsigned i=lo; i<(unsigned)hi; i++)
+            {
+                for (unsigned j=0; j<mesh.GetNumNodes(); j++)
+                {
+                    double value = PetscMatTools::GetElement(mat, i, j);
+                    TS_ASSERT_DELTA(PetscMatTools::GetElement(cached_mat, i, j), value, 1e-9*(1.0+fabs(value)));
+                }
+            }
+        }
+
+        cached_assembler.ClearElementMatrixCache();
+        TS_ASSERT_EQUALS(cached_assembler.IsElementMatrixCacheBuilt(), false);
+
+        PetscTools::Destroy(mat);
+        PetscTools::Destroy(cached_mat);
+    }
+
 };
 
 #endif /* TESTMONODOMAINSTIFFNESSMATRIX_HPP_ */
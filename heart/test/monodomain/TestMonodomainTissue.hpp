@@ -47,6 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "SimpleStimulus.hpp"
 #include "EulerIvpOdeSolver.hpp"
 #include "LuoRudy1991.hpp"
+#include "LuoRudy1991BackwardEuler.hpp"
 #include "MonodomainTissue.hpp"
 #include "OdeSolution.hpp"
 #include "AbstractCardiacCellFactory.hpp"
@@ -59,6 +60,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ArchiveOpener.hpp"
 #include "DiFrancescoNoble1985.hpp"
 #include "MonodomainProblem.hpp"
+#include "HeartEventHandler.hpp"
+#include "CardiacCellBatch.hpp"
+#include "AbstractRushLarsenCardiacCell.hpp" // Needed for chaste_libs=0 build
+#include "AbstractGeneralizedRushLarsenCardiacCell.hpp" // Needed for chaste_libs=0 build
+#include "CellMLToSharedLibraryConverter.hpp"
+#include "DynamicCellModelLoader.hpp"
+#include "FileFinder.hpp"
+#include "OutputFileHandler.hpp"
+#include "OdeSystemInformation.hpp"
 
 #include "PetscSetupAndFinalize.hpp"
 
@@ -94,6 +104,161 @@ public:
     }
 };
 
+/**
+ * As MyCardiacCellFactory, but creating cells of a dynamically loaded model, so that
+ * Rush-Larsen and generalised Rush-Larsen variants can be used.
+ */
+class DynamicCellFactory : public AbstractCardiacCellFactory<1>
+{
+private:
+    DynamicCellModelLoaderPtr mpLoader;
+    boost::shared_ptr<SimpleStimulus> mpStimulus;
+
+public:
+
+    DynamicCellFactory(DynamicCellModelLoaderPtr pLoader)
+        : AbstractCardiacCellFactory<1>(),
+          mpLoader(pLoader),
+          mpStimulus(new SimpleStimulus(-80.0, 0.5))
+    {
+    }
+
+    AbstractCardiacCellInterface* CreateCardiacCellForTissueNode(Node<1>* pNode)
+    {
+        if (pNode->GetIndex()==0)
+        {
+            return mpLoader->CreateCell(mpSolver, mpStimulus);
+        }
+        else
+        {
+            return mpLoader->CreateCell(mpSolver, mpZeroStimulus);
+        }
+    }
+};
+
+/**
+ * A cell which always fails to solve, saying where it is, to test how failed cell solves are reported.
+ */
+class FailingCell : public CellLuoRudy1991FromCellML
+{
+private:
+    unsigned mNodeIndex;
+
+public:
+    FailingCell(boost::shared_ptr<AbstractIvpOdeSolver> pSolver,
+                boost::shared_ptr<AbstractStimulusFunction> pIntracellularStimulus,
+                unsigned nodeIndex)
+        : CellLuoRudy1991FromCellML(pSolver, pIntracellularStimulus),
+          mNodeIndex(nodeIndex)
+    {
+    }
+
+    void SolveAndUpdateState(double tStart, double tEnd)
+    {
+        EXCEPTION("Cell at node " << mNodeIndex << " failed to solve.");
+    }
+
+    void ComputeExceptVoltage(double tStart, double tEnd)
+    {
+        EXCEPTION("Cell at node " << mNodeIndex << " failed to solve.");
+    }
+};
+
+/**
+ * As MyCardiacCellFactory, but the cells at nodes 3, 4 and 7 fail to solve.
+ */
+class FailingCellFactory : public AbstractCardiacCellFactory<1>
+{
+public:
+    AbstractCardiacCell* CreateCardiacCellForTissueNode(Node<1>* pNode)
+    {
+        unsigned node_index = pNode->GetIndex();
+        if (node_index==3 || node_index==4 || node_index==7)
+        {
+            return new FailingCell(mpSolver, mpZeroStimulus, node_index);
+        }
+        else
+        {
+            return new CellLuoRudy1991FromCellML(mpSolver, mpZeroStimulus);
+        }
+    }
+};
+
+/**
+ * A Rush-Larsen cell whose second state variable grows at unit rate from zero,
+ * and is out of range once it exceeds 0.555.
+ */
+class OutOfRangeRushLarsenCell : public AbstractRushLarsenCardiacCell
+{
+public:
+    OutOfRangeRushLarsenCell(boost::shared_ptr<AbstractStimulusFunction> pIntracellularStimulus)
+        : AbstractRushLarsenCardiacCell(2, 0, pIntracellularStimulus)
+    {
+        mpSystemInfo = OdeSystemInformation<OutOfRangeRushLarsenCell>::Instance();
+        Init();
+    }
+
+    double GetIIonic(const std::vector<double>* pStateVariables=NULL)
+    {
+        return 0.0;
+    }
+
+    bool GetRushLarsenUpdateInformation(std::vector<RushLarsenUpdateType>& rUpdateTypes,
+                                        std::vector<double>& rTimeScaleFactors)
+    {
+        rUpdateTypes.assign(2, NO_UPDATE);
+        rUpdateTypes[1] = FORWARD_EULER_UPDATE;
+        rTimeScaleFactors.assign(2, 1.0);
+        return true;
+    }
+
+    void VerifyStateVariables()
+    {
+        if (rGetStateVariables()[1] > 0.555)
+        {
+            EXCEPTION("x has gone out of range.");
+        }
+    }
+
+protected:
+    void EvaluateEquations(double time, std::vector<double>& rDY,
+                           std::vector<double>& rAlphaOrTau, std::vector<double>& rBetaOrInf)
+    {
+        rDY[0] = 0.0;
+        rDY[1] = 1.0;
+    }
+
+    void ComputeOneStepExceptVoltage(const std::vector<double>& rDY,
+                                     const std::vector<double>& rAlphaOrTau,
+                                     const std::vector<double>& rBetaOrInf)
+    {
+        rGetStateVariables()[1] += mDt*rDY[1];
+    }
+};
+
+template<>
+void OdeSystemInformation<OutOfRangeRushLarsenCell>::Initialise(void)
+{
+    this->mVariableNames.push_back("V");
+    this->mVariableUnits.push_back("mV");
+    this->mInitialConditions.push_back(0.0);
+
+    this->mVariableNames.push_back("x");
+    this->mVariableUnits.push_back("dimensionless");
+    this->mInitialConditions.push_back(0.0);
+
+    this->mInitialised = true;
+}
+
+class OutOfRangeRushLarsenCellFactory : public AbstractCardiacCellFactory<1>
+{
+public:
+    AbstractCardiacCell* CreateCardiacCellForTissueNode(Node<1>* pNode)
+    {
+        return new OutOfRangeRushLarsenCell(mpZeroStimulus);
+    }
+};
+
 class PurkinjeCellFactory : public AbstractPurkinjeCellFactory<2>
 {
 private:
@@ -296,6 +461,431 @@ public:
         PetscTools::Destroy(voltage2);
     }
 
+    void TestBatchedSolveCellSystems() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, stimulated at node 0
+
+        MyCardiacCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> tissue( &cell_factory );
+        MonodomainTissue<1> batched_tissue( &cell_factory );
+        TS_ASSERT_EQUALS(batched_tissue.GetUseBatchedCellSolve(), false);
+        batched_tissue.SetUseBatchedCellSolve();
+        TS_ASSERT_EQUALS(batched_tissue.GetUseBatchedCellSolve(), true);
+
+        unsigned num_nodes = mesh.GetNumNodes();
+        Vec voltage = PetscTools::CreateAndSetVec(num_nodes, -81.4354);
+        Vec batched_voltage = PetscTools::CreateAndSetVec(num_nodes, -81.4354);
+
+        // Without updating the voltage, then updating it too (as the operator-splitting solver does)
+        tissue.SolveCellSystems(voltage, 0.0, 1.0, false);
+        batched_tissue.SolveCellSystems(batched_voltage, 0.0, 1.0, false);
+        tissue.SolveCellSystems(voltage, 1.0, 2.0, true);
+        batched_tissue.SolveCellSystems(batched_voltage, 1.0, 2.0, true);
+
+        ReplicatableVector voltage_repl(voltage);
+        ReplicatableVector batched_voltage_repl(batched_voltage);
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            TS_ASSERT_DELTA(batched_voltage_repl[i], voltage_repl[i], 1e-12);
+            TS_ASSERT_DELTA(batched_tissue.rGetIionicCacheReplicated()[i], tissue.rGetIionicCacheReplicated()[i], 1e-12);
+            TS_ASSERT_DELTA(batched_tissue.rGetIntracellularStimulusCacheReplicated()[i],
+                            tissue.rGetIntracellularStimulusCacheReplicated()[i], 1e-12);
+
+            if (mesh.GetDistributedVectorFactory()->IsGlobalIndexLocal(i))
+            {
+                std::vector<double> state = tissue.GetCardiacCell(i)->GetStdVecStateVariables();
+                std::vector<double> batched_state = batched_tissue.GetCardiacCell(i)->GetStdVecStateVariables();
+                TS_ASSERT_EQUALS(batched_state.size(), state.size());
+                for (unsigned j=0; j<state.size(); j++)
+                {
+                    TS_ASSERT_DELTA(batched_state[j], state[j], 1e-12);
+                }
+            }
+        }
+
+        // Switching batching off again falls back to solving cells individually
+        batched_tissue.SetUseBatchedCellSolve(false);
+        TS_ASSERT_EQUALS(batched_tissue.GetUseBatchedCellSolve(), false);
+        batched_tissue.SolveCellSystems(batched_voltage, 2.0, 3.0, true);
+        tissue.SolveCellSystems(voltage, 2.0, 3.0, true);
+        ReplicatableVector voltage_repl2(voltage);
+        ReplicatableVector batched_voltage_repl2(batched_voltage);
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            TS_ASSERT_DELTA(batched_voltage_repl2[i], voltage_repl2[i], 1e-12);
+        }
+
+        // The batch solver types of individual cells
+        TS_ASSERT_EQUALS(CardiacCellBatch::GetBatchSolverType(tissue.GetCardiacCell(mesh.GetDistributedVectorFactory()->GetLow())),
+                         CardiacCellBatch::FORWARD_EULER);
+
+        PetscTools::Destroy(voltage);
+        PetscTools::Destroy(batched_voltage);
+    }
+
+    void TestBatchedSolveRushLarsenCellSystems() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, stimulated at node 0
+        unsigned num_nodes = mesh.GetNumNodes();
+
+        std::vector<std::string> variants;
+        std::vector<CardiacCellBatch::BatchSolverType> solver_types;
+        variants.push_back("rush-larsen");
+        solver_types.push_back(CardiacCellBatch::RUSH_LARSEN);
+        variants.push_back("grl1");
+        solver_types.push_back(CardiacCellBatch::GENERALIZED_RUSH_LARSEN);
+        variants.push_back("grl2");
+        solver_types.push_back(CardiacCellBatch::GENERALIZED_RUSH_LARSEN);
+
+        for (unsigned variant=0; variant<variants.size(); variant++)
+        {
+            // Convert the model, preserving generated sources
+            CellMLToSharedLibraryConverter converter(true);
+            OutputFileHandler handler("TestBatchedSolveRushLarsenCellSystems/" + variants[variant]);
+            FileFinder cellml_file("heart/src/odes/cellml/LuoRudy1991.cellml", RelativeTo::ChasteSourceRoot);
+            FileFinder copied_file = handler.CopyFileTo(cellml_file);
+            std::vector<std::string> args(1, "--" + variants[variant]);
+            converter.CreateOptionsFile(handler, "LuoRudy1991", args);
+            DynamicCellModelLoaderPtr p_loader = converter.Convert(copied_file);
+
+            DynamicCellFactory cell_factory(p_loader);
+            cell_factory.SetMesh(&mesh);
+
+            MonodomainTissue<1> batched_tissue( &cell_factory );
+            batched_tissue.SetUseBatchedCellSolve();
+
+            Vec batched_voltage = PetscTools::CreateAndSetVec(num_nodes, -81.4354);
+            batched_tissue.SolveCellSystems(batched_voltage, 0.0, 1.0, false);
+            ReplicatableVector batched_voltage_repl(batched_voltage);
+
+            // Compare with the same cells solved one at a time
+            for (unsigned i=0; i<num_nodes; i++)
+            {
+                TS_ASSERT_DELTA(batched_voltage_repl[i], -81.4354, 1e-12);
+
+                if (mesh.GetDistributedVectorFactory()->IsGlobalIndexLocal(i))
+                {
+                    AbstractCardiacCellInterface* p_batched_cell = batched_tissue.GetCardiacCell(i);
+                    TS_ASSERT_EQUALS(CardiacCellBatch::GetBatchSolverType(p_batched_cell), solver_types[variant]);
+
+                    AbstractCardiacCellInterface* p_cell = cell_factory.CreateCardiacCellForTissueNode(mesh.GetNode(i));
+                    p_cell->SetVoltage(-81.4354);
+                    p_cell->ComputeExceptVoltage(0.0, 1.0);
+
+                    std::vector<double> state = p_cell->GetStdVecStateVariables();
+                    std::vector<double> batched_state = p_batched_cell->GetStdVecStateVariables();
+                    TS_ASSERT_EQUALS(batched_state.size(), state.size());
+                    for (unsigned j=0; j<state.size(); j++)
+                    {
+                        TS_ASSERT_DELTA(batched_state[j], state[j], 1e-10);
+                    }
+                    TS_ASSERT_DELTA(batched_tissue.rGetIionicCacheReplicated()[i], p_cell->GetIIonic(), 1e-10);
+
+                    delete p_cell;
+                }
+            }
+
+            PetscTools::Destroy(batched_voltage);
+        }
+    }
+
+    void TestBatchedSolveStateVariableChecks() throw(Exception)
+    {
+        // Other processes would just be told that another process failed
+        EXIT_IF_PARALLEL;
+
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        OutOfRangeRushLarsenCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> batched_tissue( &cell_factory );
+        batched_tissue.SetUseBatchedCellSolve();
+
+        Vec batched_voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), 0.0);
+        TS_ASSERT_THROWS_THIS(batched_tissue.SolveCellSystems(batched_voltage, 0.0, 1.0, true),
+                              "x has gone out of range.");
+        TS_ASSERT_EQUALS(CardiacCellBatch::GetBatchSolverType(batched_tissue.GetCardiacCell(0)),
+                         CardiacCellBatch::RUSH_LARSEN);
+
+        // As when a cell is solved on its own, the failure is found at the step where it happens
+        AbstractCardiacCellInterface* p_cell = cell_factory.CreateCardiacCellForTissueNode(mesh.GetNode(0));
+        TS_ASSERT_THROWS_THIS(p_cell->SolveAndUpdateState(0.0, 1.0), "x has gone out of range.");
+        TS_ASSERT_DELTA(p_cell->GetStdVecStateVariables()[1], 0.56, 1e-9);
+        TS_ASSERT_DELTA(batched_tissue.GetCardiacCell(0)->GetStdVecStateVariables()[1],
+                        p_cell->GetStdVecStateVariables()[1], 1e-12);
+        delete p_cell;
+
+        PetscTools::Destroy(batched_voltage);
+    }
+
+    void TestThreadedSolveCellSystems() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, stimulated at node 0
+
+        MyCardiacCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> tissue( &cell_factory );
+        MonodomainTissue<1> threaded_tissue( &cell_factory );
+        TS_ASSERT_EQUALS(threaded_tissue.GetNumCellSolveThreads(), 1u);
+        TS_ASSERT_EQUALS(threaded_tissue.GetCellSolveChunkSize(), 16u);
+
+        TS_ASSERT_THROWS_THIS(threaded_tissue.SetCellSolveThreading(0u),
+                              "The number of cell solve threads and the chunk size must both be positive.");
+        TS_ASSERT_THROWS_THIS(threaded_tissue.SetCellSolveThreading(2u, 0u),
+                              "The number of cell solve threads and the chunk size must both be positive.");
+#ifdef _OPENMP
+        threaded_tissue.SetCellSolveThreading(4u, 2u);
+        TS_ASSERT_EQUALS(threaded_tissue.GetNumCellSolveThreads(), 4u);
+        TS_ASSERT_EQUALS(threaded_tissue.GetCellSolveChunkSize(), 2u);
+#else
+        TS_ASSERT_THROWS_THIS(threaded_tissue.SetCellSolveThreading(4u, 2u),
+                              "Chaste was not compiled with OpenMP support, so cell models can only be solved by one thread.");
+        threaded_tissue.SetCellSolveThreading(1u, 2u);
+        TS_ASSERT_EQUALS(threaded_tissue.GetCellSolveChunkSize(), 2u);
+#endif // _OPENMP
+
+        unsigned num_nodes = mesh.GetNumNodes();
+        Vec voltage = PetscTools::CreateAndSetVec(num_nodes, -81.4354);
+        Vec threaded_voltage = PetscTools::CreateAndSetVec(num_nodes, -81.4354);
+
+        tissue.SolveCellSystems(voltage, 0.0, 1.0, false);
+        threaded_tissue.SolveCellSystems(threaded_voltage, 0.0, 1.0, false);
+        tissue.SolveCellSystems(voltage, 1.0, 2.0, true);
+        threaded_tissue.SolveCellSystems(threaded_voltage, 1.0, 2.0, true);
+
+        ReplicatableVector voltage_repl(voltage);
+        ReplicatableVector threaded_voltage_repl(threaded_voltage);
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            TS_ASSERT_DELTA(threaded_voltage_repl[i], voltage_repl[i], 1e-12);
+            TS_ASSERT_DELTA(threaded_tissue.rGetIionicCacheReplicated()[i], tissue.rGetIionicCacheReplicated()[i], 1e-12);
+        }
+
+#ifdef _OPENMP
+        // Cells which shared the factory's solver now each have their own
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        if (p_factory->GetLocalOwnership() > 1u)
+        {
+            TS_ASSERT_DIFFERS(threaded_tissue.GetCardiacCell(p_factory->GetLow())->GetSolver().get(),
+                              threaded_tissue.GetCardiacCell(p_factory->GetLow()+1)->GetSolver().get());
+        }
+#endif // _OPENMP
+
+        PetscTools::Destroy(voltage);
+        PetscTools::Destroy(threaded_voltage);
+    }
+
+    void TestThreadedSolveBackwardEulerCellSystems() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, stimulated at node 0
+
+        // Backward Euler cells share a Newton solver for each model, rather than having an ODE solver
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,1> cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> tissue( &cell_factory );
+        MonodomainTissue<1> threaded_tissue( &cell_factory );
+#ifdef _OPENMP
+        threaded_tissue.SetCellSolveThreading(4u, 1u);
+#endif // _OPENMP
+
+        unsigned num_nodes = mesh.GetNumNodes();
+        Vec voltage = PetscTools::CreateAndSetVec(num_nodes, -83.853);
+        Vec threaded_voltage = PetscTools::CreateAndSetVec(num_nodes, -83.853);
+
+        for (unsigned step=0; step<3; step++)
+        {
+            tissue.SolveCellSystems(voltage, step, step+1.0, true);
+            threaded_tissue.SolveCellSystems(threaded_voltage, step, step+1.0, true);
+        }
+
+        ReplicatableVector voltage_repl(voltage);
+        ReplicatableVector threaded_voltage_repl(threaded_voltage);
+        TS_ASSERT_LESS_THAN(-20.0, voltage_repl[0]); // Upstroke, so the Newton solves do some work
+        for (unsigned i=0; i<num_nodes; i++)
+        {
+            TS_ASSERT_DELTA(threaded_voltage_repl[i], voltage_repl[i], 1e-12);
+            TS_ASSERT_DELTA(threaded_tissue.rGetIionicCacheReplicated()[i], tissue.rGetIionicCacheReplicated()[i], 1e-12);
+        }
+
+        PetscTools::Destroy(voltage);
+        PetscTools::Destroy(threaded_voltage);
+    }
+
+    void TestThreadedSolveCellFailure() throw(Exception)
+    {
+        // Other processes would just be told that another process failed
+        EXIT_IF_PARALLEL;
+
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes
+
+        FailingCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> tissue( &cell_factory );
+#ifdef _OPENMP
+        // Chunks of one cell, so the failing cells are solved by different threads in any order
+        tissue.SetCellSolveThreading(4u, 1u);
+#endif // _OPENMP
+
+        // The failure at the lowest index is reported and rethrown, whichever thread finds it first
+        Vec voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -83.853);
+        TS_ASSERT_THROWS_THIS(tissue.SolveCellSystems(voltage, 0.0, 1.0, false),
+                              "Cell at node 3 failed to solve.");
+        TS_ASSERT_THROWS_THIS(tissue.SolveCellSystems(voltage, 0.0, 1.0, true),
+                              "Cell at node 3 failed to solve.");
+
+        PetscTools::Destroy(voltage);
+    }
+
+    void TestActivityAdaptiveCellTimesteps() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, stimulated at node 0
+
+        PlaneStimulusCellFactory<CellLuoRudy1991FromCellMLBackwardEuler,1> cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> tissue( &cell_factory );
+        MonodomainTissue<1> adaptive_tissue( &cell_factory );
+        TS_ASSERT_EQUALS(adaptive_tissue.GetMaxCellTimestepMultiple(), 1u);
+
+        TS_ASSERT_THROWS_THIS(adaptive_tissue.SetActivityAdaptiveCellTimesteps(0u),
+                              "The maximum cell timestep multiple and the quiescent voltage rate must both be positive.");
+        TS_ASSERT_THROWS_THIS(adaptive_tissue.SetActivityAdaptiveCellTimesteps(10u, 0.0),
+                              "The maximum cell timestep multiple and the quiescent voltage rate must both be positive.");
+        adaptive_tissue.SetActivityAdaptiveCellTimesteps(10u, 1.0);
+        TS_ASSERT_EQUALS(adaptive_tissue.GetMaxCellTimestepMultiple(), 10u);
+#ifdef _OPENMP
+        adaptive_tissue.SetCellSolveThreading(2u, 4u);
+#endif // _OPENMP
+
+        unsigned num_nodes = mesh.GetNumNodes();
+        Vec voltage = PetscTools::CreateAndSetVec(num_nodes, -83.853);
+        Vec adaptive_voltage = PetscTools::CreateAndSetVec(num_nodes, -83.853);
+
+        HeartEventHandler::ResetCounters();
+        for (unsigned step=0; step<3; step++)
+        {
+            tissue.SolveCellSystems(voltage, step, step+1.0, true);
+            adaptive_tissue.SolveCellSystems(adaptive_voltage, step, step+1.0, true);
+        }
+
+        // The stimulated cell is active throughout, so is solved exactly as before;
+        // the resting cells barely move even with ten times the timestep
+        ReplicatableVector voltage_repl(voltage);
+        ReplicatableVector adaptive_voltage_repl(adaptive_voltage);
+        TS_ASSERT_DELTA(adaptive_voltage_repl[0], voltage_repl[0], 1e-12);
+        TS_ASSERT_LESS_THAN(-20.0, voltage_repl[0]);
+        for (unsigned i=1; i<num_nodes; i++)
+        {
+            TS_ASSERT_DELTA(adaptive_voltage_repl[i], voltage_repl[i], 1e-2);
+        }
+
+        // Cells are left with their usual timestep
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned i=p_factory->GetLow(); i<p_factory->GetHigh(); i++)
+        {
+            TS_ASSERT_DELTA(dynamic_cast<AbstractCardiacCell*>(adaptive_tissue.GetCardiacCell(i))->GetTimestep(), 0.01, 1e-12);
+        }
+
+        // Every cell takes 100 substeps in the first solve, as there's no record of its activity yet.
+        // After that the resting cells take 10.
+        unsigned num_local = p_factory->GetLocalOwnership();
+        unsigned num_local_active = p_factory->IsGlobalIndexLocal(0) ? 1u : 0u;
+        TS_ASSERT_EQUALS(HeartEventHandler::GetCounter(HeartEventHandler::ODE_SUBSTEPS_AT_BASE_TIMESTEP), 300ul*num_local);
+        TS_ASSERT_EQUALS(HeartEventHandler::GetCounter(HeartEventHandler::ODE_SUBSTEPS),
+                         100ul*num_local + 2ul*(100ul*num_local_active + 10ul*(num_local - num_local_active)));
+
+        // Switching adaptivity off again uses the usual timestep for every cell
+        adaptive_tissue.SetActivityAdaptiveCellTimesteps(1u);
+        HeartEventHandler::ResetCounters();
+        adaptive_tissue.SolveCellSystems(adaptive_voltage, 3.0, 4.0, true);
+        TS_ASSERT_EQUALS(HeartEventHandler::GetCounter(HeartEventHandler::ODE_SUBSTEPS), 0ul);
+
+        PetscTools::Destroy(voltage);
+        PetscTools::Destroy(adaptive_voltage);
+    }
+
+    void TestStimulusSchedule() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 nodes, stimulated at node 0 until t=0.5
+
+        MyCardiacCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> tissue( &cell_factory );
+        MonodomainTissue<1> scheduled_tissue( &cell_factory );
+        MonodomainTissue<1> distributed_scheduled_tissue( &cell_factory );
+        TS_ASSERT(!scheduled_tissue.GetUseStimulusSchedule());
+        scheduled_tissue.SetUseStimulusSchedule();
+        TS_ASSERT(scheduled_tissue.GetUseStimulusSchedule());
+        distributed_scheduled_tissue.SetUseStimulusSchedule();
+        distributed_scheduled_tissue.SetUseDistributedCaches();
+
+        Vec voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -83.853);
+        DistributedVectorFactory* p_factory = mesh.GetDistributedVectorFactory();
+        for (unsigned step=0; step<4; step++)
+        {
+            // The cache is filled at the end of each step: stimulated, on the boundary, then off
+            double time = 0.25*step;
+            tissue.SolveCellSystems(voltage, time, time+0.25);
+            scheduled_tissue.SolveCellSystems(voltage, time, time+0.25);
+            distributed_scheduled_tissue.SolveCellSystems(voltage, time, time+0.25);
+
+            for (unsigned i=p_factory->GetLow(); i<p_factory->GetHigh(); i++)
+            {
+                TS_ASSERT_EQUALS(scheduled_tissue.rGetIntracellularStimulusCacheReplicated()[i],
+                                 tissue.rGetIntracellularStimulusCacheReplicated()[i]);
+                TS_ASSERT_EQUALS(distributed_scheduled_tissue.GetIntracellularStimulusCacheValue(i),
+                                 tissue.rGetIntracellularStimulusCacheReplicated()[i]);
+                TS_ASSERT_EQUALS(scheduled_tissue.rGetIionicCacheReplicated()[i],
+                                 tissue.rGetIionicCacheReplicated()[i]);
+            }
+            if (p_factory->IsGlobalIndexLocal(0))
+            {
+                TS_ASSERT_EQUALS(scheduled_tissue.rGetIntracellularStimulusCacheReplicated()[0], step<2 ? -80.0 : 0.0);
+            }
+        }
+
+        // A new stimulus is picked up once the schedule is recompiled
+        boost::shared_ptr<SimpleStimulus> p_stimulus(new SimpleStimulus(-50.0, 1.0, 1.0));
+        for (unsigned i=p_factory->GetLow(); i<p_factory->GetHigh(); i++)
+        {
+            tissue.GetCardiacCell(i)->SetIntracellularStimulusFunction(p_stimulus);
+            scheduled_tissue.GetCardiacCell(i)->SetIntracellularStimulusFunction(p_stimulus);
+        }
+        scheduled_tissue.SetUseStimulusSchedule();
+        tissue.SolveCellSystems(voltage, 1.0, 1.25);
+        scheduled_tissue.SolveCellSystems(voltage, 1.0, 1.25);
+        for (unsigned i=p_factory->GetLow(); i<p_factory->GetHigh(); i++)
+        {
+            TS_ASSERT_EQUALS(scheduled_tissue.rGetIntracellularStimulusCacheReplicated()[i], -50.0);
+            TS_ASSERT_EQUALS(tissue.rGetIntracellularStimulusCacheReplicated()[i], -50.0);
+        }
+
+        PetscTools::Destroy(voltage);
+    }
+
     void TestNodeExchange() throw(Exception)
     {
         HeartConfig::Instance()->Reset();
@@ -416,6 +1006,74 @@ public:
         PetscTools::Destroy(voltage2);
     }
 
+    void TestDistributedCaches() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        DistributedTetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(0.1, 1.0); // 11 node mesh
+
+        MyCardiacCellFactory cell_factory;
+        cell_factory.SetMesh(&mesh);
+
+        MonodomainTissue<1> replicated_tissue( &cell_factory );
+        MonodomainTissue<1> distributed_tissue( &cell_factory );
+        TS_ASSERT(replicated_tissue.GetDoCacheReplication());
+        TS_ASSERT(!distributed_tissue.GetUseDistributedCaches());
+
+        distributed_tissue.SetUseDistributedCaches();
+        TS_ASSERT(distributed_tissue.GetUseDistributedCaches());
+        TS_ASSERT(!distributed_tissue.GetDoCacheReplication());
+        TS_ASSERT_THROWS_THIS(distributed_tissue.SetCacheReplication(true),
+                              "The caches cannot be replicated while distributed caches are in use.");
+        TS_ASSERT_THROWS_THIS(distributed_tissue.rGetIionicCacheReplicated(),
+                              "The ionic current cache is distributed; use GetIionicCacheValue() instead.");
+        TS_ASSERT_THROWS_THIS(distributed_tissue.rGetIntracellularStimulusCacheReplicated(),
+                              "The intracellular stimulus cache is distributed; use GetIntracellularStimulusCacheValue() instead.");
+
+        Vec voltage = PetscTools::CreateAndSetVec(mesh.GetNumNodes(), -81.4354);
+        replicated_tissue.SolveCellSystems(voltage, 0, 1);
+        distributed_tissue.SolveCellSystems(voltage, 0, 1);
+
+        // Every node of a locally owned element is either owned or a halo node, and should
+        // match the replicated cache
+        for (AbstractTetrahedralMesh<1,1>::ElementIterator iter = mesh.GetElementIteratorBegin();
+             iter != mesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            if (iter->GetOwnership())
+            {
+                for (unsigned i=0; i<2; i++)
+                {
+                    unsigned node_index = iter->GetNodeGlobalIndex(i);
+                    TS_ASSERT_DELTA(distributed_tissue.GetIionicCacheValue(node_index),
+                                    replicated_tissue.rGetIionicCacheReplicated()[node_index], 1e-12);
+                    TS_ASSERT_DELTA(distributed_tissue.GetIntracellularStimulusCacheValue(node_index),
+                                    replicated_tissue.GetIntracellularStimulusCacheValue(node_index), 1e-12);
+                }
+            }
+        }
+
+        // Nodes which are neither owned nor halos aren't available
+        if (PetscTools::GetNumProcs() > 2u && PetscTools::AmMaster())
+        {
+            TS_ASSERT_THROWS_CONTAINS(distributed_tissue.GetIionicCacheValue(mesh.GetNumNodes()-1),
+                                      "does not belong to processor");
+        }
+
+        // Going back to replicated caches
+        distributed_tissue.SetUseDistributedCaches(false);
+        distributed_tissue.SetCacheReplication(true);
+        distributed_tissue.SolveCellSystems(voltage, 1, 2);
+        replicated_tissue.SolveCellSystems(voltage, 1, 2);
+        for (unsigned node_index=0; node_index<mesh.GetNumNodes(); node_index++)
+        {
+            TS_ASSERT_DELTA(distributed_tissue.rGetIionicCacheReplicated()[node_index],
+                            replicated_tissue.rGetIionicCacheReplicated()[node_index], 1e-12);
+        }
+
+        PetscTools::Destroy(voltage);
+    }
+
     void TestSaveAndLoadCardiacTissue() throw (Exception)
     {
         HeartConfig::Instance()->Reset();
@@ -0,0 +1,381 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTINSITUPOSTPROCESSINGWRITER_HPP_
+#define TESTINSITUPOSTPROCESSINGWRITER_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+#include "InSituPostProcessingWriter.hpp"
+#include "CellProperties.hpp"
+#include "TetrahedralMesh.hpp"
+#include "DistributedVector.hpp"
+#include "OutputFileHandler.hpp"
+#include "FileFinder.hpp"
+#include "HeartConfig.hpp"
+#include "Hdf5DataReader.hpp"
+#include "MonodomainProblem.hpp"
+#include "PlaneStimulusCellFactory.hpp"
+#include "LuoRudy1991.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+class TestInSituPostProcessingWriter : public CxxTest::TestSuite
+{
+private:
+
+    /**
+     * A synthetic action potential train, with the wave arriving 1ms later at each node:
+     * a 2ms upstroke from -85 to 40, a sloping plateau to -9 at 100ms, then
+     * linear repolarisation to rest at 150ms.  Paced every 200ms.
+     */
+    double SyntheticVoltage(unsigned nodeIndex, double time)
+    {
+        double s = fmod(time - 10.0 - nodeIndex, 200.0);
+        if (time < 10.0 + nodeIndex || s >= 150.0)
+        {
+            return -85.0;
+        }
+        else if (s < 2.0)
+        {
+            return -85.0 + 62.5*s;
+        }
+        else if (s < 100.0)
+        {
+            return 40.0 - 0.5*(s-2.0);
+        }
+        return -9.0 - 76.0*(s-100.0)/50.0;
+    }
+
+    /**
+     * Read a map written by InSituPostProcessingWriter to an HDF5 dataset: one row of values per node,
+     * without the padding.
+     */
+    std::vector<std::vector<double> > ReadHdf5Map(const std::string& rHdf5File, const std::string& rDatasetName)
+    {
+        FileFinder output_dir(HeartConfig::Instance()->GetOutputDirectory(), RelativeTo::ChasteTestOutput);
+        Hdf5DataReader reader(output_dir, rHdf5File, rDatasetName);
+        TS_ASSERT_EQUALS(reader.GetVariableNames().size(), 1u);
+        TS_ASSERT_EQUALS(reader.GetVariableNames()[0], rDatasetName);
+
+        std::vector<std::vector<double> > map(reader.GetNumberOfRows());
+        for (unsigned node_index=0; node_index<map.size(); node_index++)
+        {
+            std::vector<double> values = reader.GetVariableOverTime(rDatasetName, node_index);
+            for (unsigned i=0; i<values.size(); i++)
+            {
+                if (values[i] != -999.0)
+                {
+                    map[node_index].push_back(values[i]);
+                }
+            }
+        }
+        return map;
+    }
+
+    /** Read a map written by InSituPostProcessingWriter to a text file: one row of values per node. */
+    std::vector<std::vector<double> > ReadTextMap(const std::string& rFileName)
+    {
+        FileFinder map_file(HeartConfig::Instance()->GetOutputDirectory() + "/" + rFileName, RelativeTo::ChasteTestOutput);
+        TS_ASSERT(map_file.Exists());
+        std::ifstream file(map_file.GetAbsolutePath().c_str());
+        std::vector<std::vector<double> > map;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+            std::stringstream line_stream(line);
+            std::vector<double> row;
+            double value;
+            while (line_stream >> value)
+            {
+                row.push_back(value);
+            }
+            map.push_back(row);
+        }
+        return map;
+    }
+
+    void CompareVectors(const std::vector<double>& rInSitu, const std::vector<double>& rExpected)
+    {
+        TS_ASSERT_EQUALS(rInSitu.size(), rExpected.size());
+        for (unsigned i=0; i<std::min(rInSitu.size(), rExpected.size()); i++)
+        {
+            TS_ASSERT_DELTA(rInSitu[i], rExpected[i], 1e-9);
+        }
+    }
+
+public:
+
+    void TestMapsMatchCellProperties() throw(Exception)
+    {
+        HeartConfig::Instance()->SetOutputDirectory("TestInSituPostProcessingWriter");
+        OutputFileHandler handler("TestInSituPostProcessingWriter"); // Wipe the folder
+
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(1.0, 9.0);
+        unsigned num_nodes = mesh.GetNumNodes();
+
+        InSituPostProcessingWriter<1,1> in_situ(mesh);
+        TS_ASSERT_EQUALS(in_situ.HasMaps(), false);
+        TS_ASSERT_THROWS_THIS(in_situ.AddApdMap(0.5, -30.0),
+                              "First argument of AddApdMap() is expected to be a percentage");
+        in_situ.AddApdMap(90.0, -30.0);
+        in_situ.AddApdMap(50.0, -30.0);
+        in_situ.AddUpstrokeTimeMap(-30.0);
+        in_situ.AddMaxUpstrokeVelocityMap(-30.0);
+        in_situ.AddAboveThresholdDepolarisationMap(-30.0);
+        in_situ.AddUpstrokeTimeMap(0.0);
+        TS_ASSERT_EQUALS(in_situ.HasMaps(), true);
+
+        // Two complete action potentials and the start of a third
+        std::vector<double> times;
+        Vec voltage = mesh.GetDistributedVectorFactory()->CreateVec();
+        for (unsigned step=0; step<=840; step++)
+        {
+            double time = 0.5*step;
+            times.push_back(time);
+
+            DistributedVector distributed_voltage = mesh.GetDistributedVectorFactory()->CreateDistributedVector(voltage);
+            for (DistributedVector::Iterator index = distributed_voltage.Begin();
+                 index != distributed_voltage.End();
+                 ++index)
+            {
+                distributed_voltage[index] = SyntheticVoltage(index.Global, time);
+            }
+            distributed_voltage.Restore();
+
+            in_situ.Update(time, voltage);
+
+            // Repeated time steps are ignored
+            in_situ.Update(time, voltage);
+        }
+        PetscTools::Destroy(voltage);
+
+        TS_ASSERT_THROWS_THIS(in_situ.AddUpstrokeTimeMap(10.0), "Maps must be requested before the first update.");
+
+        // There is no results file, so one is created to hold the maps
+        FileFinder output_dir("TestInSituPostProcessingWriter", RelativeTo::ChasteTestOutput);
+        in_situ.WriteMaps(output_dir, "InSituMaps");
+        TS_ASSERT(FileFinder("InSituMaps.h5", output_dir).Exists());
+
+        std::vector<std::vector<double> > apd90_map = ReadHdf5Map("InSituMaps", "Apd_90_minus_30_Map");
+        std::vector<std::vector<double> > apd50_map = ReadHdf5Map("InSituMaps", "Apd_50_minus_30_Map");
+        std::vector<std::vector<double> > upstroke_time_map = ReadHdf5Map("InSituMaps", "UpstrokeTimeMap_minus_30");
+        std::vector<std::vector<double> > upstroke_velocity_map = ReadHdf5Map("InSituMaps", "MaxUpstrokeVelocityMap_minus_30");
+        std::vector<std::vector<double> > depolarisations_map = ReadTextMap("AboveThresholdDepolarisations_minus_30.dat");
+        std::vector<std::vector<double> > upstroke_time_map_0 = ReadHdf5Map("InSituMaps", "UpstrokeTimeMap_0");
+        TS_ASSERT_EQUALS(apd90_map.size(), num_nodes);
+        TS_ASSERT_EQUALS(upstroke_time_map.size(), num_nodes);
+        TS_ASSERT_EQUALS(depolarisations_map.size(), num_nodes);
+        TS_ASSERT_EQUALS(upstroke_time_map_0.size(), num_nodes);
+
+        // Compare with the calculations done on the whole voltage trace
+        for (unsigned node_index=0; node_index<num_nodes; node_index++)
+        {
+            std::vector<double> trace;
+            for (unsigned i=0; i<times.size(); i++)
+            {
+                trace.push_back(SyntheticVoltage(node_index, times[i]));
+            }
+            CellProperties cell_props(trace, times, -30.0);
+            CompareVectors(apd90_map[node_index], cell_props.GetAllActionPotentialDurations(90.0));
+            CompareVectors(apd50_map[node_index], cell_props.GetAllActionPotentialDurations(50.0));
+            CompareVectors(upstroke_time_map[node_index], cell_props.GetTimesAtMaxUpstrokeVelocity());
+            CompareVectors(upstroke_velocity_map[node_index], cell_props.GetMaxUpstrokeVelocities());
+
+            // Two complete APs, and the third has started
+            TS_ASSERT_EQUALS(apd90_map[node_index].size(), 2u);
+            TS_ASSERT_EQUALS(upstroke_time_map[node_index].size(), 3u);
+            // Target is -72.5mV, crossed 0.2ms into the upstroke and 63.5*50/76 ms into repolarisation
+            TS_ASSERT_DELTA(apd90_map[node_index][0], 100.0 + 63.5*50.0/76.0 - 0.2, 1e-9);
+
+            // Three upstrokes, but no depolarisations on the plateau
+            TS_ASSERT_EQUALS(depolarisations_map[node_index].size(), 2u);
+            TS_ASSERT_DELTA(depolarisations_map[node_index][0], 3.0, 1e-12);
+            TS_ASSERT_DELTA(depolarisations_map[node_index][1], 0.0, 1e-12);
+
+            CellProperties cell_props_0(trace, times, 0.0);
+            CompareVectors(upstroke_time_map_0[node_index], cell_props_0.GetTimesAtMaxUpstrokeVelocity());
+        }
+    }
+
+    void TestMapsOfPermutedMesh() throw(Exception)
+    {
+        HeartConfig::Instance()->SetOutputDirectory("TestInSituPostProcessingWriterPermuted");
+        OutputFileHandler handler("TestInSituPostProcessingWriterPermuted"); // Wipe the folder
+
+        // Reverse the node ordering
+        TetrahedralMesh<1,1> mesh;
+        mesh.ConstructRegularSlabMesh(1.0, 9.0);
+        unsigned num_nodes = mesh.GetNumNodes();
+        std::vector<unsigned> permutation(num_nodes);
+        for (unsigned original_index=0; original_index<num_nodes; original_index++)
+        {
+            permutation[original_index] = num_nodes - 1 - original_index;
+        }
+        mesh.PermuteNodes(permutation);
+        TS_ASSERT_EQUALS(mesh.rGetNodePermutation().size(), num_nodes);
+
+        InSituPostProcessingWriter<1,1> in_situ(mesh);
+        in_situ.AddUpstrokeTimeMap(-30.0);
+        in_situ.AddAboveThresholdDepolarisationMap(-30.0);
+
+        // The wave still travels along the original node ordering
+        std::vector<double> times;
+        Vec voltage = mesh.GetDistributedVectorFactory()->CreateVec();
+        for (unsigned step=0; step<=500; step++)
+        {
+            double time = 0.5*step;
+            times.push_back(time);
+
+            DistributedVector distributed_voltage = mesh.GetDistributedVectorFactory()->CreateDistributedVector(voltage);
+            for (DistributedVector::Iterator index = distributed_voltage.Begin();
+                 index != distributed_voltage.End();
+                 ++index)
+            {
+                unsigned original_index = num_nodes - 1 - index.Global;
+                distributed_voltage[index] = SyntheticVoltage(original_index, time);
+            }
+            distributed_voltage.Restore();
+
+            in_situ.Update(time, voltage);
+        }
+        PetscTools::Destroy(voltage);
+
+        bool original_ordering = HeartConfig::Instance()->GetOutputUsingOriginalNodeOrdering();
+        for (unsigned use_original=0; use_original<2; use_original++)
+        {
+            HeartConfig::Instance()->SetOutputUsingOriginalNodeOrdering(use_original == 1u);
+            std::string hdf5_file = (use_original == 1u) ? "InSituMapsOriginalOrdering" : "InSituMaps";
+            FileFinder output_dir("TestInSituPostProcessingWriterPermuted", RelativeTo::ChasteTestOutput);
+            in_situ.WriteMaps(output_dir, hdf5_file);
+
+            std::vector<std::vector<double> > upstroke_time_map = ReadHdf5Map(hdf5_file, "UpstrokeTimeMap_minus_30");
+            std::vector<std::vector<double> > depolarisations_map = ReadTextMap("AboveThresholdDepolarisations_minus_30.dat");
+            TS_ASSERT_EQUALS(upstroke_time_map.size(), num_nodes);
+            TS_ASSERT_EQUALS(depolarisations_map.size(), num_nodes);
+
+            for (unsigned row=0; row<std::min(num_nodes, (unsigned)upstroke_time_map.size()); row++)
+            {
+                // Rows are in the simulation's ordering unless the original ordering is requested
+                unsigned original_index = (use_original == 1u) ? row : num_nodes - 1 - row;
+                std::vector<double> trace;
+                for (unsigned i=0; i<times.size(); i++)
+                {
+                    trace.push_back(SyntheticVoltage(original_index, times[i]));
+                }
+                CellProperties cell_props(trace, times, -30.0);
+                CompareVectors(upstroke_time_map[row], cell_props.GetTimesAtMaxUpstrokeVelocity());
+                TS_ASSERT_EQUALS(upstroke_time_map[row].size(), 2u);
+                TS_ASSERT_DELTA(depolarisations_map[row][0], 2.0, 1e-12);
+            }
+        }
+        HeartConfig::Instance()->SetOutputUsingOriginalNodeOrdering(original_ordering);
+    }
+
+    void TestMapsInResultsFile() throw(Exception)
+    {
+        HeartConfig::Instance()->Reset();
+        HeartConfig::Instance()->SetIntracellularConductivities(Create_c_vector(0.0005));
+        HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+        HeartConfig::Instance()->SetMeshFileName("mesh/test/data/1D_0_to_1mm_10_elements");
+        HeartConfig::Instance()->SetOutputDirectory("TestInSituMapsInResultsFile");
+        HeartConfig::Instance()->SetOutputFilenamePrefix("MonodomainLR91_1d");
+        HeartConfig::Instance()->SetSurfaceAreaToVolumeRatio(1.0);
+        HeartConfig::Instance()->SetCapacitance(1.0);
+        std::vector<double> upstroke_time_maps(1, -30.0);
+        HeartConfig::Instance()->SetUpstrokeTimeMaps(upstroke_time_maps);
+        HeartConfig::Instance()->SetUseInSituPostProcessing();
+
+        {
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+            MonodomainProblem<1> monodomain_problem(&cell_factory);
+            monodomain_problem.Initialise();
+            monodomain_problem.Solve();
+        }
+
+        // The map is a dataset in the results file, alongside the voltage
+        std::vector<std::vector<double> > upstroke_time_map = ReadHdf5Map("MonodomainLR91_1d", "UpstrokeTimeMap_minus_30");
+        TS_ASSERT_EQUALS(upstroke_time_map.size(), 11u);
+        FileFinder output_dir("TestInSituMapsInResultsFile", RelativeTo::ChasteTestOutput);
+        Hdf5DataReader reader(output_dir, "MonodomainLR91_1d");
+        TS_ASSERT_EQUALS(reader.GetVariableNames()[0], "V");
+        std::vector<double> times = reader.GetUnlimitedDimensionValues();
+        // The stimulated end has an upstroke within the first 2ms
+        TS_ASSERT_EQUALS(upstroke_time_map[0].size(), 1u);
+        TS_ASSERT_LESS_THAN(0.0, upstroke_time_map[0][0]);
+        for (unsigned node_index=0; node_index<upstroke_time_map.size(); node_index++)
+        {
+            std::vector<double> voltages = reader.GetVariableOverTime("V", node_index);
+            std::vector<double> expected(1, 0.0);
+            try
+            {
+                CellProperties cell_props(voltages, times, -30.0);
+                expected = cell_props.GetTimesAtMaxUpstrokeVelocity();
+            }
+            catch (Exception&)
+            {
+                // No upstroke: the map has a single 0
+            }
+            CompareVectors(upstroke_time_map[node_index], expected);
+        }
+
+        // The maps can't cover the first part of the simulation if they weren't being calculated
+        {
+            HeartConfig::Instance()->SetUseInSituPostProcessing(false);
+            HeartConfig::Instance()->SetSimulationDuration(1.0); //ms
+            PlaneStimulusCellFactory<CellLuoRudy1991FromCellML, 1> cell_factory;
+            MonodomainProblem<1> monodomain_problem(&cell_factory);
+            monodomain_problem.Initialise();
+            monodomain_problem.Solve();
+
+            HeartConfig::Instance()->SetUseInSituPostProcessing();
+            HeartConfig::Instance()->SetSimulationDuration(2.0); //ms
+            TS_ASSERT_THROWS_THIS(monodomain_problem.Solve(),
+                                  "In-situ post-processing maps can only be calculated from the start of a simulation, "
+                                  "not for a simulation resumed from a checkpoint or already solved without them.");
+        }
+        HeartConfig::Instance()->Reset();
+    }
+};
+
+#endif /*TESTINSITUPOSTPROCESSINGWRITER_HPP_*/
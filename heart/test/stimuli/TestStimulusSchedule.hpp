@@ -0,0 +1,196 @@
+/*
+
+Copyright (c) 2005-2014, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTSTIMULUSSCHEDULE_HPP_
+#define TESTSTIMULUSSCHEDULE_HPP_
+
+#include <cxxtest/TestSuite.h>
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "StimulusSchedule.hpp"
+#include "SimpleStimulus.hpp"
+#include "RegularStimulus.hpp"
+#include "RegularStimulusZeroNetCharge.hpp"
+#include "MultiStimulus.hpp"
+#include "S1S2Stimulus.hpp"
+#include "ZeroStimulus.hpp"
+#include "TimeStepper.hpp"
+
+/** A stimulus which can't be described by pulses. */
+class RampStimulus : public AbstractStimulusFunction
+{
+public:
+    double GetStimulus(double time)
+    {
+        return time < 5.0 ? time : 0.0;
+    }
+};
+
+class TestStimulusSchedule : public CxxTest::TestSuite
+{
+public:
+    void TestPulses()
+    {
+        std::vector<StimulusPulse> pulses;
+
+        SimpleStimulus simple(-10.0, 2.0, 5.0);
+        TS_ASSERT(simple.GetPulses(0.0, 4.9, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 0u);
+        TS_ASSERT(simple.GetPulses(6.0, 8.0, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 1u);
+        TS_ASSERT_EQUALS(pulses[0].mStart, 5.0);
+        TS_ASSERT_DELTA(pulses[0].mDuration, 2.0, 1e-12);
+        TS_ASSERT_EQUALS(pulses[0].mMagnitude, -10.0);
+
+        // Waves at 10, 110, 210 and 310 (stopped during the last one)
+        pulses.clear();
+        RegularStimulus regular(-5.0, 1.0, 100.0, 10.0, 310.5);
+        TS_ASSERT(regular.GetPulses(105.0, 1000.0, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 3u);
+        TS_ASSERT_EQUALS(pulses[0].mStart, 110.0);
+        TS_ASSERT_EQUALS(pulses[2].mStart, 310.0);
+        TS_ASSERT_DELTA(pulses[0].mDuration, 1.0, 1e-12);
+        TS_ASSERT_DELTA(pulses[2].mDuration, 0.5, 1e-12);
+        pulses.clear();
+        TS_ASSERT(regular.GetPulses(0.0, 9.0, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 0u);
+        TS_ASSERT(regular.GetPulses(10.5, 10.5, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 1u);
+
+        // Zero magnitude and zero stimuli have no pulses
+        pulses.clear();
+        RegularStimulus grounded(0.0, 1.0, 100.0, 10.0);
+        TS_ASSERT(grounded.GetPulses(0.0, 1000.0, pulses));
+        ZeroStimulus zero;
+        TS_ASSERT(zero.GetPulses(0.0, 1000.0, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 0u);
+
+        // Multiple stimuli combine their pulses, unless one of them can't be described
+        MultiStimulus multi;
+        multi.AddStimulus(boost::shared_ptr<AbstractStimulusFunction>(new SimpleStimulus(-10.0, 2.0, 5.0)));
+        multi.AddStimulus(boost::shared_ptr<AbstractStimulusFunction>(new RegularStimulus(-5.0, 1.0, 100.0, 10.0)));
+        TS_ASSERT(multi.GetPulses(0.0, 150.0, pulses));
+        TS_ASSERT_EQUALS(pulses.size(), 3u);
+        multi.AddStimulus(boost::shared_ptr<AbstractStimulusFunction>(new RampStimulus));
+        TS_ASSERT(!multi.GetPulses(0.0, 150.0, pulses));
+        RampStimulus ramp;
+        TS_ASSERT(!ramp.GetPulses(0.0, 150.0, pulses));
+
+        // S1-S2 stimuli describe the chosen experiment
+        std::vector<double> s2_periods;
+        s2_periods.push_back(300.0);
+        s2_periods.push_back(200.0);
+        S1S2Stimulus s1s2(-20.0, 1.0, 1000.0, 500.0, 0.0, s2_periods);
+        pulses.clear();
+        TS_ASSERT(s1s2.GetPulses(900.0, 1500.0, pulses));
+        unsigned num_pulses_300 = pulses.size();
+        s1s2.SetS2ExperimentPeriodIndex(1u);
+        pulses.clear();
+        TS_ASSERT(s1s2.GetPulses(900.0, 1500.0, pulses));
+        TS_ASSERT_EQUALS(num_pulses_300, 2u);  // 1000 and 1300
+        TS_ASSERT_EQUALS(pulses.size(), 3u);   // 1000, 1200 and 1400
+    }
+
+    void TestScheduleMatchesStimulusFunctions()
+    {
+        // Node sets: regular pacing, a single pulse, a zero-net-charge electrode, an S1-S2 protocol,
+        // a stimulus that isn't described by pulses, and no stimulus
+        std::vector<boost::shared_ptr<AbstractStimulusFunction> > stimuli;
+        stimuli.push_back(boost::shared_ptr<AbstractStimulusFunction>(new RegularStimulus(-5.0, 1.0, 100.0, 10.0)));
+        stimuli.push_back(boost::shared_ptr<AbstractStimulusFunction>(new SimpleStimulus(-10.0, 2.0, 5.0)));
+        stimuli.push_back(boost::shared_ptr<AbstractStimulusFunction>(new RegularStimulusZeroNetCharge(-3.0, 2.0, 150.0, 20.0)));
+        std::vector<double> s2_periods(1u, 170.0);
+        stimuli.push_back(boost::shared_ptr<AbstractStimulusFunction>(new S1S2Stimulus(-20.0, 1.0, 400.0, 200.0, 0.0, s2_periods)));
+        stimuli.push_back(boost::shared_ptr<AbstractStimulusFunction>(new RampStimulus));
+        stimuli.push_back(boost::shared_ptr<AbstractStimulusFunction>(new ZeroStimulus));
+
+        // A short horizon, so the timeline is compiled several times
+        StimulusSchedule schedule(250.0);
+        const unsigned num_nodes = 30u;
+        for (unsigned node=0; node<num_nodes; node++)
+        {
+            schedule.AddNode(node, stimuli[node%stimuli.size()]);
+        }
+        TS_ASSERT_EQUALS(schedule.GetNumNodeSets(), stimuli.size());
+        TS_ASSERT_EQUALS(schedule.rGetNodeSet(1u).size(), num_nodes/stimuli.size());
+        TS_ASSERT_EQUALS(schedule.rGetNodeSet(1u)[1], 1u + stimuli.size());
+
+        const double dt = 0.01;
+        unsigned max_sets_found = 0u;
+        TimeStepper stepper(0.0, 1000.0, dt);
+        while (!stepper.IsTimeAtEnd())
+        {
+            const double time = stepper.GetNextTime();
+            std::vector<double> scheduled(num_nodes, 0.0);
+            const std::vector<unsigned>& r_sets = schedule.rGetPossiblyStimulatedNodeSets(time, time);
+            max_sets_found = std::max(max_sets_found, (unsigned) r_sets.size());
+            for (unsigned i=0; i<r_sets.size(); i++)
+            {
+                const double stimulus = schedule.GetStimulus(r_sets[i], time);
+                for (unsigned j=0; j<schedule.rGetNodeSet(r_sets[i]).size(); j++)
+                {
+                    scheduled[schedule.rGetNodeSet(r_sets[i])[j]] = stimulus;
+                }
+            }
+            for (unsigned node=0; node<num_nodes; node++)
+            {
+                TS_ASSERT_EQUALS(scheduled[node], stimuli[node%stimuli.size()]->GetStimulus(time));
+            }
+            stepper.AdvanceOneTimeStep();
+        }
+        // Never more than two pulse trains under way, plus the ramp
+        TS_ASSERT_LESS_THAN_EQUALS(max_sets_found, 3u);
+
+        // An interval query finds pulses entirely within it
+        const std::vector<unsigned>& r_sets = schedule.rGetPossiblyStimulatedNodeSets(1000.2, 1009.8);
+        TS_ASSERT_EQUALS(r_sets.size(), 1u);
+        TS_ASSERT_EQUALS(r_sets[0], 4u);
+        TS_ASSERT_EQUALS(schedule.rGetPossiblyStimulatedNodeSets(1009.0, 1010.5).size(), 2u);
+
+        // Going back in time recompiles the timeline
+        TS_ASSERT_EQUALS(schedule.rGetPossiblyStimulatedNodeSets(5.5, 5.5).size(), 2u);
+
+        // Changes to the stimuli are picked up after a reset
+        static_cast<S1S2Stimulus*>(stimuli[3].get())->SetS2ExperimentPeriodIndex(0u);
+        boost::static_pointer_cast<RegularStimulus>(stimuli[0])->SetStartTime(6.0);
+        TS_ASSERT_EQUALS(schedule.rGetPossiblyStimulatedNodeSets(6.5, 6.5).size(), 2u);
+        schedule.Reset();
+        TS_ASSERT_EQUALS(schedule.rGetPossiblyStimulatedNodeSets(6.5, 6.5).size(), 3u);
+    }
+};
+
+#endif /*TESTSTIMULUSSCHEDULE_HPP_*/
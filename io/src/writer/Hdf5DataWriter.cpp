@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * Implementation file for Hdf5DataWriter class.
  *
  */
+#include <algorithm>
 #include <set>
 #include <cstring> //For strcmp etc. Needed in gcc-4.4
 #include <boost/scoped_array.hpp>
@@ -76,7 +77,11 @@ Hdf5DataWriter::Hdf5DataWriter(DistributedVectorFactory& rVectorFactory,
       mSingleIncompleteOutputMatrix(NULL),
       mDoubleIncompleteOutputMatrix(NULL),
       mUseOptimalChunkSizeAlgorithm(true),
-      mNumberOfChunks(0u)
+      mNumberOfChunks(0u),
+      mCacheSize(0u),
+      mCacheFirstTimeStep(0u),
+      mCacheHasData(false),
+      mCurrentTimeStepCached(false)
 {
     mChunkSize[0] = 0;
     mChunkSize[1] = 0;
@@ -753,8 +758,12 @@ void Hdf5DataWriter::PutVector(int variableID, Vec petscVector)
         EXCEPTION("Vector size doesn't match fixed dimension");
     }
 
-    // Make sure that everything is actually extended to the correct dimension.
-    PossiblyExtend();
+    // Make sure that everything is actually extended to the correct dimension
+    // (when caching this is deferred until the cache is written).
+    if (mCacheSize == 0)
+    {
+        PossiblyExtend();
+    }
 
     Vec output_petsc_vector;
 
@@ -774,68 +783,82 @@ void Hdf5DataWriter::PutVector(int variableID, Vec petscVector)
         MatMult(mSinglePermutation, petscVector, output_petsc_vector);
     }
 
-    // Define a dataset in memory for this process
-    hid_t memspace=0;
-    if (mNumberOwned != 0)
-    {
-        hsize_t v_size[1] = {mNumberOwned};
-        memspace = H5Screate_simple(1, v_size, NULL);
-    }
-
-    // Select hyperslab in the file
-    hsize_t count[DATASET_DIMS] = {1, mNumberOwned, 1};
-    hsize_t offset_dims[DATASET_DIMS] = {mCurrentTimeStep, mOffset, (unsigned)(variableID)};
-    hid_t file_dataspace = H5Dget_space(mVariablesDatasetId);
-
-    // Create property list for collective dataset
-    hid_t property_list_id = H5Pcreate(H5P_DATASET_XFER);
-    H5Pset_dxpl_mpio(property_list_id, H5FD_MPIO_COLLECTIVE);
-
-    H5Sselect_hyperslab(file_dataspace, H5S_SELECT_SET, offset_dims, NULL, count, NULL);
-
     double* p_petsc_vector;
     VecGetArray(output_petsc_vector, &p_petsc_vector);
 
-    if (mIsDataComplete)
-    {
-        H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, file_dataspace, property_list_id, p_petsc_vector);
-    }
-    else
+    // Work out which values this process contributes to the file
+    double* p_data = p_petsc_vector;
+    Vec incomplete_output_vector = NULL;
+    double* p_petsc_vector_incomplete = NULL;
+    boost::scoped_array<double> local_data;
+    if (!mIsDataComplete)
     {
         if (mUseMatrixForIncompleteData)
         {
             // Make a vector of the required size
-            output_petsc_vector = PetscTools::CreateVec(mFileFixedDimensionSize, mNumberOwned);
+            incomplete_output_vector = PetscTools::CreateVec(mFileFixedDimensionSize, mNumberOwned);
 
             // Fill the vector by multiplying complete data by incomplete output matrix
-            MatMult(mSingleIncompleteOutputMatrix, petscVector, output_petsc_vector);
+            MatMult(mSingleIncompleteOutputMatrix, petscVector, incomplete_output_vector);
 
-            double* p_petsc_vector_incomplete;
-            VecGetArray(output_petsc_vector, &p_petsc_vector_incomplete);
-            H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, file_dataspace, property_list_id, p_petsc_vector_incomplete);
+            VecGetArray(incomplete_output_vector, &p_petsc_vector_incomplete);
+            p_data = p_petsc_vector_incomplete;
         }
         else
         {
             // Make a local copy of the data you own
-            boost::scoped_array<double> local_data(new double[mNumberOwned]);
+            local_data.reset(new double[mNumberOwned]);
             for (unsigned i=0; i<mNumberOwned; i++)
             {
                 local_data[i] = p_petsc_vector[ mIncompleteNodeIndices[mOffset+i]-mLo ];
-
             }
-            H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, file_dataspace, property_list_id, local_data.get());
+            p_data = local_data.get();
         }
     }
 
-    VecRestoreArray(output_petsc_vector, &p_petsc_vector);
+    if (mCacheSize > 0)
+    {
+        CacheLocalData(p_data, variableID, 1u);
+    }
+    else
+    {
+        // Define a dataset in memory for this process
+        hid_t memspace=0;
+        if (mNumberOwned != 0)
+        {
+            hsize_t v_size[1] = {mNumberOwned};
+            memspace = H5Screate_simple(1, v_size, NULL);
+        }
 
-    H5Pclose(property_list_id);
-    H5Sclose(file_dataspace);
-    if (mNumberOwned !=0)
+        // Select hyperslab in the file
+        hsize_t count[DATASET_DIMS] = {1, mNumberOwned, 1};
+        hsize_t offset_dims[DATASET_DIMS] = {mCurrentTimeStep, mOffset, (unsigned)(variableID)};
+        hid_t file_dataspace = H5Dget_space(mVariablesDatasetId);
+
+        // Create property list for collective dataset
+        hid_t property_list_id = H5Pcreate(H5P_DATASET_XFER);
+        H5Pset_dxpl_mpio(property_list_id, H5FD_MPIO_COLLECTIVE);
+
+        H5Sselect_hyperslab(file_dataspace, H5S_SELECT_SET, offset_dims, NULL, count, NULL);
+
+        H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, file_dataspace, property_list_id, p_data);
+
+        H5Pclose(property_list_id);
+        H5Sclose(file_dataspace);
+        if (mNumberOwned !=0)
+        {
+            H5Sclose(memspace);
+        }
+    }
+
+    if (incomplete_output_vector)
     {
-        H5Sclose(memspace);
+        VecRestoreArray(incomplete_output_vector, &p_petsc_vector_incomplete);
+        PetscTools::Destroy(incomplete_output_vector);
     }
 
+    VecRestoreArray(output_petsc_vector, &p_petsc_vector);
+
     if (petscVector != output_petsc_vector)
     {
         // Free local vector
@@ -876,8 +899,18 @@ void Hdf5DataWriter::PutStripedVector(std::vector<int> variableIDs, Vec petscVec
         EXCEPTION("Vector size doesn't match fixed dimension");
     }
 
+    // Incomplete data and striped vector is supported only for NUM_STRIPES=2...for the moment
+    if (!mIsDataComplete && NUM_STRIPES > 2)
+    {
+        EXCEPTION("The PutStripedVector functionality for incomplete data is supported for only 2 stripes");
+    }
+
     // Make sure that everything is actually extended to the correct dimension
-    PossiblyExtend();
+    // (when caching this is deferred until the cache is written).
+    if (mCacheSize == 0)
+    {
+        PossiblyExtend();
+    }
 
     Vec output_petsc_vector;
 
@@ -896,79 +929,86 @@ void Hdf5DataWriter::PutStripedVector(std::vector<int> variableIDs, Vec petscVec
         // Apply the permutation matrix
         MatMult(mDoublePermutation, petscVector, output_petsc_vector);
     }
-    // Define a dataset in memory for this process
-    hid_t memspace=0;
-    if (mNumberOwned !=0)
-    {
-        hsize_t v_size[1] = {mNumberOwned*NUM_STRIPES};
-        memspace = H5Screate_simple(1, v_size, NULL);
-    }
 
-    // Select hyperslab in the file
-    hsize_t start[DATASET_DIMS] = {mCurrentTimeStep, mOffset, (unsigned)(firstVariableID)};
-    hsize_t stride[DATASET_DIMS] = {1, 1, 1};//we are imposing contiguous variables, hence the stride is 1 (3rd component)
-    hsize_t block_size[DATASET_DIMS] = {1, mNumberOwned, 1};
-    hsize_t number_blocks[DATASET_DIMS] = {1, 1, NUM_STRIPES};
+    double* p_petsc_vector;
+    VecGetArray(output_petsc_vector, &p_petsc_vector);
 
-    hid_t hyperslab_space = H5Dget_space(mVariablesDatasetId);
-    H5Sselect_hyperslab(hyperslab_space, H5S_SELECT_SET, start, stride, number_blocks, block_size);
+    // Work out which values this process contributes to the file
+    double* p_data = p_petsc_vector;
+    Vec incomplete_output_vector = NULL;
+    double* p_petsc_vector_incomplete = NULL;
+    boost::scoped_array<double> local_data;
+    if (!mIsDataComplete)
+    {
+        if (mUseMatrixForIncompleteData)
+        {
+            // Make a vector of the required size
+            incomplete_output_vector = PetscTools::CreateVec(2*mFileFixedDimensionSize, 2*mNumberOwned);
 
-    // Create property list for collective dataset write, and write! Finally.
-    hid_t property_list_id = H5Pcreate(H5P_DATASET_XFER);
-    H5Pset_dxpl_mpio(property_list_id, H5FD_MPIO_COLLECTIVE);
+            // Fill the vector by multiplying complete data by incomplete output matrix
+            MatMult(mDoubleIncompleteOutputMatrix, petscVector, incomplete_output_vector);
 
-    double* p_petsc_vector;
-    VecGetArray(output_petsc_vector, &p_petsc_vector);
+            VecGetArray(incomplete_output_vector, &p_petsc_vector_incomplete);
+            p_data = p_petsc_vector_incomplete;
+        }
+        else
+        {
+            // Make a local copy of the data you own
+            local_data.reset(new double[mNumberOwned*NUM_STRIPES]);
+            for (unsigned i=0; i<mNumberOwned; i++)
+            {
+                unsigned local_node_number = mIncompleteNodeIndices[mOffset+i] - mLo;
+                local_data[NUM_STRIPES*i]   = p_petsc_vector[ local_node_number*NUM_STRIPES ];
+                local_data[NUM_STRIPES*i+1] = p_petsc_vector[ local_node_number*NUM_STRIPES + 1];
+            }
+            p_data = local_data.get();
+        }
+    }
 
-    if (mIsDataComplete)
+    if (mCacheSize > 0)
     {
-        H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, property_list_id, p_petsc_vector);
+        CacheLocalData(p_data, firstVariableID, NUM_STRIPES);
     }
     else
     {
-        if (variableIDs.size() < 3) // incomplete data and striped vector is supported only for NUM_STRIPES=2...for the moment
+        // Define a dataset in memory for this process
+        hid_t memspace=0;
+        if (mNumberOwned !=0)
         {
-            if (mUseMatrixForIncompleteData)
-            {
-                // Make a vector of the required size
-                output_petsc_vector = PetscTools::CreateVec(2*mFileFixedDimensionSize, 2*mNumberOwned);
+            hsize_t v_size[1] = {mNumberOwned*NUM_STRIPES};
+            memspace = H5Screate_simple(1, v_size, NULL);
+        }
 
-                // Fill the vector by multiplying complete data by incomplete output matrix
-                MatMult(mDoubleIncompleteOutputMatrix, petscVector, output_petsc_vector);
+        // Select hyperslab in the file
+        hsize_t start[DATASET_DIMS] = {mCurrentTimeStep, mOffset, (unsigned)(firstVariableID)};
+        hsize_t stride[DATASET_DIMS] = {1, 1, 1};//we are imposing contiguous variables, hence the stride is 1 (3rd component)
+        hsize_t block_size[DATASET_DIMS] = {1, mNumberOwned, 1};
+        hsize_t number_blocks[DATASET_DIMS] = {1, 1, NUM_STRIPES};
 
-                double* p_petsc_vector_incomplete;
-                VecGetArray(output_petsc_vector, &p_petsc_vector_incomplete);
+        hid_t hyperslab_space = H5Dget_space(mVariablesDatasetId);
+        H5Sselect_hyperslab(hyperslab_space, H5S_SELECT_SET, start, stride, number_blocks, block_size);
 
-                H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, property_list_id, p_petsc_vector_incomplete);
-            }
-            else
-            {
-                // Make a local copy of the data you own
-                boost::scoped_array<double> local_data(new double[mNumberOwned*NUM_STRIPES]);
-                for (unsigned i=0; i<mNumberOwned; i++)
-                {
-                    unsigned local_node_number = mIncompleteNodeIndices[mOffset+i] - mLo;
-                    local_data[NUM_STRIPES*i]   = p_petsc_vector[ local_node_number*NUM_STRIPES ];
-                    local_data[NUM_STRIPES*i+1] = p_petsc_vector[ local_node_number*NUM_STRIPES + 1];
-                }
+        // Create property list for collective dataset write, and write! Finally.
+        hid_t property_list_id = H5Pcreate(H5P_DATASET_XFER);
+        H5Pset_dxpl_mpio(property_list_id, H5FD_MPIO_COLLECTIVE);
 
-                H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, property_list_id, local_data.get());
-            }
-        }
-        else
+        H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, hyperslab_space, property_list_id, p_data);
+
+        H5Sclose(hyperslab_space);
+        if (mNumberOwned != 0)
         {
-            EXCEPTION("The PutStripedVector functionality for incomplete data is supported for only 2 stripes");
+            H5Sclose(memspace);
         }
+        H5Pclose(property_list_id);
     }
 
-    VecRestoreArray(output_petsc_vector, &p_petsc_vector);
-
-    H5Sclose(hyperslab_space);
-    if (mNumberOwned != 0)
+    if (incomplete_output_vector)
     {
-        H5Sclose(memspace);
+        VecRestoreArray(incomplete_output_vector, &p_petsc_vector_incomplete);
+        PetscTools::Destroy(incomplete_output_vector);
     }
-    H5Pclose(property_list_id);
+
+    VecRestoreArray(output_petsc_vector, &p_petsc_vector);
 
     if (petscVector != output_petsc_vector)
     {
@@ -989,6 +1029,15 @@ void Hdf5DataWriter::PutUnlimitedVariable(double value)
         EXCEPTION("PutUnlimitedVariable() called but no unlimited dimension has been set");
     }
 
+    if (mCacheSize > 0)
+    {
+        // Every process keeps a copy so that the cache bookkeeping stays collective; only the master writes it
+        unsigned slot = GetCurrentCacheSlot();
+        mUnlimitedCache[slot] = value;
+        mUnlimitedCached[slot] = true;
+        return;
+    }
+
     // Make sure that everything is actually extended to the correct dimension.
     PossiblyExtend();
 
@@ -1020,6 +1069,12 @@ void Hdf5DataWriter::Close()
         return; // Nothing to do...
     }
 
+    if (mCacheSize > 0)
+    {
+        // Flush everything, including the time step currently being filled
+        WriteCachedTimeSteps(mCurrentTimeStep - mCacheFirstTimeStep + (mCurrentTimeStepCached ? 1 : 0));
+    }
+
     H5Dclose(mVariablesDatasetId);
     if (mIsUnlimitedDimensionSet)
     {
@@ -1069,6 +1124,15 @@ void Hdf5DataWriter::AdvanceAlongUnlimitedDimension()
         mDatasetDims[0]++;
         mNeedExtend = true;
     }
+
+    if (mCacheSize > 0)
+    {
+        mCurrentTimeStepCached = false;
+        if (mCurrentTimeStep - mCacheFirstTimeStep >= mCacheSize)
+        {
+            WriteCache();
+        }
+    }
 }
 
 void Hdf5DataWriter::PossiblyExtend()
@@ -1329,3 +1393,210 @@ void Hdf5DataWriter::SetChunkSize()
         }
     }
 }
+
+void Hdf5DataWriter::SetCacheSize(unsigned numTimeSteps)
+{
+    if (mCurrentTimeStepCached)
+    {
+        EXCEPTION("Cannot change the cache size part way through writing a time step.");
+    }
+
+    // Write out anything held under the old cache size
+    WriteCache();
+
+    mCacheSize = numTimeSteps;
+    mCacheFirstTimeStep = mCurrentTimeStep;
+    mCacheHasData = false;
+    mDataCache.clear();
+    mUnlimitedCache.clear();
+    mVariablesCached.clear();
+    mUnlimitedCached.clear();
+}
+
+unsigned Hdf5DataWriter::GetCacheSize() const
+{
+    return mCacheSize;
+}
+
+void Hdf5DataWriter::WriteCache()
+{
+    if (mCacheSize == 0 || mIsInDefineMode)
+    {
+        return;
+    }
+    WriteCachedTimeSteps(mCurrentTimeStep - mCacheFirstTimeStep);
+}
+
+unsigned Hdf5DataWriter::GetCurrentCacheSlot()
+{
+    assert(mCacheSize > 0);
+    assert(mCurrentTimeStep >= mCacheFirstTimeStep);
+    unsigned slot = mCurrentTimeStep - mCacheFirstTimeStep;
+    assert(slot < mCacheSize);
+
+    // Allocate on first use, since the number of variables isn't known until define mode ends
+    if (mUnlimitedCache.empty())
+    {
+        mDataCache.assign(mCacheSize*mNumberOwned*mVariables.size(), 0.0);
+        mUnlimitedCache.assign(mCacheSize, 0.0);
+        mVariablesCached.assign(mCacheSize*mVariables.size(), false);
+        mUnlimitedCached.assign(mCacheSize, false);
+    }
+
+    mCacheHasData = true;
+    mCurrentTimeStepCached = true;
+    return slot;
+}
+
+void Hdf5DataWriter::CacheLocalData(const double* pData, unsigned firstVariableID, unsigned numVariables)
+{
+    const unsigned num_file_variables = mVariables.size();
+    unsigned slot = GetCurrentCacheSlot();
+    double* p_slot = &mDataCache[0] + slot*mNumberOwned*num_file_variables;
+    for (unsigned i=0; i<mNumberOwned; i++)
+    {
+        for (unsigned var=0; var<numVariables; var++)
+        {
+            p_slot[i*num_file_variables + firstVariableID + var] = pData[i*numVariables + var];
+        }
+    }
+    for (unsigned var=0; var<numVariables; var++)
+    {
+        mVariablesCached[slot*num_file_variables + firstVariableID + var] = true;
+    }
+}
+
+void Hdf5DataWriter::WriteCachedTimeSteps(unsigned numTimeSteps)
+{
+    assert(numTimeSteps <= mCacheSize);
+    if (!mCacheHasData || numTimeSteps == 0)
+    {
+        // Nothing to write: all processes take this branch together, as data is always cached collectively
+        mCacheFirstTimeStep += numTimeSteps;
+        return;
+    }
+
+    /*
+     * Extend the dataset to cover the time steps being written.  AdvanceAlongUnlimitedDimension()
+     * may already have requested a row for the time step being filled; that isn't added to the
+     * file until data is written to it, matching the behaviour without a cache.
+     */
+    if (mNeedExtend)
+    {
+        hsize_t requested_length = mDatasetDims[0];
+        mDatasetDims[0] = std::min(requested_length, (hsize_t)(mCacheFirstTimeStep + numTimeSteps));
+        PossiblyExtend();
+        if (mDatasetDims[0] < requested_length)
+        {
+            mDatasetDims[0] = requested_length;
+            mNeedExtend = true;
+        }
+    }
+
+    const unsigned num_variables = mVariables.size();
+    const unsigned slot_size = mNumberOwned*num_variables;
+
+    // Define a dataset in memory for this process, shaped as the (time step, node, variable) hyperslab it fills
+    hid_t memspace=0;
+    if (mNumberOwned != 0)
+    {
+        hsize_t cache_dims[DATASET_DIMS] = {numTimeSteps, mNumberOwned, num_variables};
+        memspace = H5Screate_simple(DATASET_DIMS, cache_dims, NULL);
+    }
+
+    hid_t file_dataspace = H5Dget_space(mVariablesDatasetId);
+    if (std::find(mVariablesCached.begin(), mVariablesCached.begin() + numTimeSteps*num_variables, false)
+        == mVariablesCached.begin() + numTimeSteps*num_variables)
+    {
+        // Every variable was put at every time step, so write the whole hyperslab
+        hsize_t count[DATASET_DIMS] = {numTimeSteps, mNumberOwned, num_variables};
+        hsize_t offset_dims[DATASET_DIMS] = {mCacheFirstTimeStep, mOffset, 0};
+        H5Sselect_hyperslab(file_dataspace, H5S_SELECT_SET, offset_dims, NULL, count, NULL);
+    }
+    else
+    {
+        // Select only the (time step, variable) columns that were put, in memory and in the file alike
+        H5Sselect_none(file_dataspace);
+        if (mNumberOwned != 0)
+        {
+            H5Sselect_none(memspace);
+            hsize_t count[DATASET_DIMS] = {1, mNumberOwned, 1};
+            H5S_seloper_t select_operation = H5S_SELECT_SET;
+            for (unsigned time_step=0; time_step<numTimeSteps; time_step++)
+            {
+                for (unsigned var=0; var<num_variables; var++)
+                {
+                    if (mVariablesCached[time_step*num_variables + var])
+                    {
+                        hsize_t memory_offset[DATASET_DIMS] = {time_step, 0, var};
+                        hsize_t file_offset[DATASET_DIMS] = {mCacheFirstTimeStep + time_step, mOffset, var};
+                        H5Sselect_hyperslab(memspace, select_operation, memory_offset, NULL, count, NULL);
+                        H5Sselect_hyperslab(file_dataspace, select_operation, file_offset, NULL, count, NULL);
+                        select_operation = H5S_SELECT_OR;
+                    }
+                }
+            }
+        }
+    }
+
+    // Create property list for collective dataset
+    hid_t property_list_id = H5Pcreate(H5P_DATASET_XFER);
+    H5Pset_dxpl_mpio(property_list_id, H5FD_MPIO_COLLECTIVE);
+
+    H5Dwrite(mVariablesDatasetId, H5T_NATIVE_DOUBLE, memspace, file_dataspace, property_list_id,
+             mDataCache.empty() ? NULL : &mDataCache[0]);
+
+    H5Pclose(property_list_id);
+    H5Sclose(file_dataspace);
+    if (mNumberOwned != 0)
+    {
+        H5Sclose(memspace);
+    }
+
+    // The unlimited variable is only written by the master
+    if (mIsUnlimitedDimensionSet && PetscTools::AmMaster())
+    {
+        hsize_t size[1] = {numTimeSteps};
+        hid_t time_memspace = H5Screate_simple(1, size, NULL);
+        hid_t hyperslab_space = H5Dget_space(mUnlimitedDatasetId);
+        H5Sselect_none(time_memspace);
+        H5Sselect_none(hyperslab_space);
+
+        // Only the time steps for which PutUnlimitedVariable() was called
+        hsize_t time_count[1] = {1};
+        H5S_seloper_t select_operation = H5S_SELECT_SET;
+        for (unsigned time_step=0; time_step<numTimeSteps; time_step++)
+        {
+            if (mUnlimitedCached[time_step])
+            {
+                hsize_t memory_offset[1] = {time_step};
+                hsize_t time_offset[1] = {mCacheFirstTimeStep + time_step};
+                H5Sselect_hyperslab(time_memspace, select_operation, memory_offset, NULL, time_count, NULL);
+                H5Sselect_hyperslab(hyperslab_space, select_operation, time_offset, NULL, time_count, NULL);
+                select_operation = H5S_SELECT_OR;
+            }
+        }
+
+        if (H5Sget_select_npoints(hyperslab_space) > 0)
+        {
+            H5Dwrite(mUnlimitedDatasetId, H5T_NATIVE_DOUBLE, time_memspace, hyperslab_space, H5P_DEFAULT, &mUnlimitedCache[0]);
+        }
+
+        H5Sclose(hyperslab_space);
+        H5Sclose(time_memspace);
+    }
+
+    // Move any data for a partially written time step to the front, and clear the rest
+    unsigned num_remaining = mCacheSize - numTimeSteps;
+    std::copy(mDataCache.begin() + numTimeSteps*slot_size, mDataCache.end(), mDataCache.begin());
+    std::fill(mDataCache.begin() + num_remaining*slot_size, mDataCache.end(), 0.0);
+    std::copy(mUnlimitedCache.begin() + numTimeSteps, mUnlimitedCache.end(), mUnlimitedCache.begin());
+    std::fill(mUnlimitedCache.begin() + num_remaining, mUnlimitedCache.end(), 0.0);
+    std::copy(mVariablesCached.begin() + numTimeSteps*num_variables, mVariablesCached.end(), mVariablesCached.begin());
+    std::fill(mVariablesCached.begin() + num_remaining*num_variables, mVariablesCached.end(), false);
+    std::copy(mUnlimitedCached.begin() + numTimeSteps, mUnlimitedCached.end(), mUnlimitedCached.begin());
+    std::fill(mUnlimitedCached.begin() + num_remaining, mUnlimitedCached.end(), false);
+
+    mCacheFirstTimeStep += numTimeSteps;
+    mCacheHasData = mCurrentTimeStepCached;
+}
@@ -90,6 +90,15 @@ private:
     hsize_t mNumberOfChunks;                  /**< The total number of chunks in the dataset */
     hsize_t mFixedChunkSize[DATASET_DIMS];          /**< User-provided chunk size */
 
+    unsigned mCacheSize;                            /**< The number of time steps held in memory before being written to disk (0 means write immediately) */
+    long unsigned mCacheFirstTimeStep;              /**< The time step stored in the first slot of the cache */
+    bool mCacheHasData;                             /**< Whether any data has been cached since the cache was last written */
+    bool mCurrentTimeStepCached;                    /**< Whether any data has been cached for #mCurrentTimeStep */
+    std::vector<double> mDataCache;                 /**< Cached data owned by this process, laid out as the (time step, node, variable) hyperslab it occupies in the file */
+    std::vector<double> mUnlimitedCache;            /**< Cached values of the unlimited variable */
+    std::vector<bool> mVariablesCached;             /**< Which variables have been cached for each time step in the cache, laid out as (time step, variable) */
+    std::vector<bool> mUnlimitedCached;             /**< Which time steps in the cache have a cached value of the unlimited variable */
+
 
     /**
      * Check name of variable is allowed, i.e. contains only alphanumeric & _, and isn't blank.
@@ -141,6 +150,33 @@ private:
      */
     void SetChunkSize();
 
+    /**
+     * Get the cache slot for #mCurrentTimeStep, allocating the cache on first use
+     * and marking the time step as containing data.
+     *
+     * @return the index of the current time step within the cache.
+     */
+    unsigned GetCurrentCacheSlot();
+
+    /**
+     * Copy data owned by this process into the cache slot for the current time step.
+     *
+     * @param pData  the data, with numVariables values per owned node
+     * @param firstVariableID  the id of the (first) variable being written
+     * @param numVariables  the number of consecutive variables striped in pData
+     */
+    void CacheLocalData(const double* pData, unsigned firstVariableID, unsigned numVariables);
+
+    /**
+     * Write the first numTimeSteps slots of the cache to disk with a single collective
+     * write, and move any remaining data to the front of the cache.  Only the variables
+     * actually put for each time step are written, so the rest of the file is left alone,
+     * as when writing without a cache.
+     *
+     * @param numTimeSteps  the number of cached time steps to write
+     */
+    void WriteCachedTimeSteps(unsigned numTimeSteps);
+
 public:
 
     /**
@@ -295,6 +331,31 @@ public:
                            const unsigned& rNodesPerChunk,
                            const unsigned& rVariablesPerChunk);
 
+    /**
+     * Hold output in memory for the given number of time steps, rather than writing to
+     * disk every time PutVector(), PutStripedVector() or PutUnlimitedVariable() is called.
+     * The Put methods then just copy the locally owned data into a staging buffer, and
+     * the whole block of cached time steps is written with a single collective call when
+     * the cache fills up, when WriteCache() is called or when the file is closed.
+     *
+     * @param numTimeSteps  the number of time steps to cache (0, the default, disables caching)
+     */
+    void SetCacheSize(unsigned numTimeSteps);
+
+    /**
+     * @return the number of time steps held in memory before being written to disk.
+     */
+    unsigned GetCacheSize() const;
+
+    /**
+     * Write all completed time steps held in the cache to disk.  Data already cached for
+     * the current time step is kept until the next write, since more variables may yet be
+     * added to it.  This is a collective operation.  It happens automatically when the
+     * cache is full and when the file is closed, but may be called explicitly, e.g. before
+     * taking a checkpoint.
+     */
+    void WriteCache();
+
 };
 
 #endif /*HDF5DATAWRITER_HPP_*/
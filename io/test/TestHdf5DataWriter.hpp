@@ -1626,6 +1626,183 @@ public:
 
         PetscTools::Destroy(petsc_data_long);
     }
+
+    void TestHdf5DataWriterFullFormatStripedCached() throw(Exception)
+    {
+        int number_nodes = 100;
+        DistributedVectorFactory factory(number_nodes);
+
+        Hdf5DataWriter writer(factory, "TestHdf5DataWriter", "hdf5_test_full_format_striped_cached", false);
+        writer.DefineFixedDimension(number_nodes);
+
+        int node_id = writer.DefineVariable("Node", "dimensionless");
+        int vm_id = writer.DefineVariable("V_m", "millivolts");
+        int phi_e_id = writer.DefineVariable("Phi_e", "millivolts");
+        int ina_id = writer.DefineVariable("I_Na", "milliamperes");
+
+        std::vector<int> striped_variable_IDs;
+        striped_variable_IDs.push_back(vm_id);
+        striped_variable_IDs.push_back(phi_e_id);
+
+        // No length estimate, so the dataset has to be extended as cached time steps are written
+        writer.DefineUnlimitedDimension("Time", "msec");
+
+        writer.EndDefineMode();
+
+        // Cache 3 time steps, so the last of the 10 is written by Close()
+        TS_ASSERT_EQUALS(writer.GetCacheSize(), 0u);
+        writer.SetCacheSize(3u);
+        TS_ASSERT_EQUALS(writer.GetCacheSize(), 3u);
+
+        Vec petsc_data_short = factory.CreateVec();
+        DistributedVector distributed_vector_short = factory.CreateDistributedVector(petsc_data_short);
+
+        Vec node_number = factory.CreateVec();
+        DistributedVector distributed_node_number = factory.CreateDistributedVector(node_number);
+
+        for (DistributedVector::Iterator index = distributed_vector_short.Begin();
+             index!= distributed_vector_short.End();
+             ++index)
+        {
+            distributed_node_number[index] = index.Global;
+            distributed_vector_short[index] = -0.5;
+        }
+        distributed_node_number.Restore();
+        distributed_vector_short.Restore();
+
+        Vec petsc_data_long = factory.CreateVec(2);
+        DistributedVector distributed_vector_long = factory.CreateDistributedVector(petsc_data_long);
+        DistributedVector::Stripe vm_stripe(distributed_vector_long, 0);
+        DistributedVector::Stripe phi_e_stripe(distributed_vector_long,1 );
+
+        for (unsigned time_step=0; time_step<10; time_step++)
+        {
+            for (DistributedVector::Iterator index = distributed_vector_long.Begin();
+                 index!= distributed_vector_long.End();
+                 ++index)
+            {
+                vm_stripe[index] =  time_step*1000 + index.Global*2;
+                phi_e_stripe[index] =  time_step*1000 + index.Global*2+1;
+            }
+            distributed_vector_long.Restore();
+
+            writer.PutVector(node_id, node_number);
+            writer.PutVector(ina_id, petsc_data_short);
+
+            if (time_step == 4)
+            {
+                // Explicitly write part way through a time step; the partial step must be kept
+                writer.WriteCache();
+                TS_ASSERT_THROWS_THIS(writer.SetCacheSize(5u),
+                                      "Cannot change the cache size part way through writing a time step.");
+            }
+
+            writer.PutStripedVector(striped_variable_IDs, petsc_data_long);
+            writer.PutUnlimitedVariable(time_step);
+            writer.AdvanceAlongUnlimitedDimension();
+        }
+
+        writer.Close();
+
+        // Identical to writing every time step immediately
+        TS_ASSERT(CompareFilesViaHdf5DataReader("TestHdf5DataWriter", "hdf5_test_full_format_striped_cached", true,
+                                                "io/test/data", "hdf5_test_full_format_striped", false));
+
+        PetscTools::Destroy(node_number);
+        PetscTools::Destroy(petsc_data_long);
+        PetscTools::Destroy(petsc_data_short);
+    }
+
+    void TestHdf5DataWriterCachedPartialTimeSteps() throw(Exception)
+    {
+        int number_nodes = 100;
+        DistributedVectorFactory factory(number_nodes);
+
+        Vec node_petsc = factory.CreateVec();
+        Vec ina_petsc = factory.CreateVec();
+        DistributedVector node_data = factory.CreateDistributedVector(node_petsc);
+        DistributedVector ina_data = factory.CreateDistributedVector(ina_petsc);
+
+        // Write two complete time steps without a cache
+        {
+            Hdf5DataWriter writer(factory, "TestHdf5DataWriter", "hdf5_test_cached_partial", false);
+            writer.DefineFixedDimension(number_nodes);
+            int node_id = writer.DefineVariable("Node", "dimensionless");
+            int ina_id = writer.DefineVariable("I_Na", "milliamperes");
+            writer.DefineUnlimitedDimension("Time", "msec");
+            writer.EndDefineMode();
+
+            for (unsigned time_step=0; time_step<2; time_step++)
+            {
+                for (DistributedVector::Iterator index = node_data.Begin();
+                     index != node_data.End();
+                     ++index)
+                {
+                    node_data[index] = index.Global;
+                    ina_data[index] = time_step*1000 + index.Global;
+                }
+                node_data.Restore();
+                ina_data.Restore();
+
+                writer.PutVector(node_id, node_petsc);
+                writer.PutVector(ina_id, ina_petsc);
+                writer.PutUnlimitedVariable(time_step);
+                writer.AdvanceAlongUnlimitedDimension();
+            }
+            writer.Close();
+        }
+
+        /*
+         * Extending the file starts on its last time step.  Overwrite only I_Na there with a cache,
+         * then add a complete time step: Node and the time at the last existing step must be kept.
+         */
+        {
+            Hdf5DataWriter writer(factory, "TestHdf5DataWriter", "hdf5_test_cached_partial", false, true);
+            int node_id = writer.GetVariableByName("Node");
+            int ina_id = writer.GetVariableByName("I_Na");
+            writer.SetCacheSize(3u);
+
+            for (DistributedVector::Iterator index = ina_data.Begin();
+                 index != ina_data.End();
+                 ++index)
+            {
+                ina_data[index] = -1.0*index.Global;
+            }
+            ina_data.Restore();
+            writer.PutVector(ina_id, ina_petsc);
+            writer.AdvanceAlongUnlimitedDimension();
+
+            writer.PutVector(node_id, node_petsc);
+            writer.PutVector(ina_id, ina_petsc);
+            writer.PutUnlimitedVariable(2.0);
+            writer.AdvanceAlongUnlimitedDimension();
+            writer.Close();
+        }
+
+        Hdf5DataReader reader("TestHdf5DataWriter", "hdf5_test_cached_partial");
+        std::vector<double> times = reader.GetUnlimitedDimensionValues();
+        TS_ASSERT_EQUALS(times.size(), 3u);
+        TS_ASSERT_DELTA(times[1], 1.0, 1e-12);
+        TS_ASSERT_DELTA(times[2], 2.0, 1e-12);
+
+        for (unsigned time_step=1; time_step<3; time_step++)
+        {
+            reader.GetVariableOverNodes(node_petsc, "Node", time_step);
+            reader.GetVariableOverNodes(ina_petsc, "I_Na", time_step);
+            DistributedVector node_read = factory.CreateDistributedVector(node_petsc);
+            DistributedVector ina_read = factory.CreateDistributedVector(ina_petsc);
+            for (DistributedVector::Iterator index = node_read.Begin();
+                 index != node_read.End();
+                 ++index)
+            {
+                TS_ASSERT_DELTA(node_read[index], index.Global, 1e-12);
+                TS_ASSERT_DELTA(ina_read[index], -1.0*index.Global, 1e-12);
+            }
+        }
+
+        PetscTools::Destroy(node_petsc);
+        PetscTools::Destroy(ina_petsc);
+    }
 };
 
 #endif /*TESTHDF5DATAWRITER_HPP_*/
@@ -225,14 +225,18 @@ LinearSystem::LinearSystem(Vec residualVector, Mat jacobianMatrix)
         mSize = (unsigned)mat_size;
         MatGetOwnershipRange(mLhsMatrix, &mOwnershipRangeLo, &mOwnershipRangeHi);
 
-        MatInfo matrix_info;
-        MatGetInfo(mLhsMatrix, MAT_GLOBAL_MAX, &matrix_info);
+        // Shell (matrix-free) matrices have no storage to query
+        if (!PetscMatTools::IsShell(mLhsMatrix))
+        {
+            MatInfo matrix_info;
+            MatGetInfo(mLhsMatrix, MAT_GLOBAL_MAX, &matrix_info);
 
-        /*
-         * Assuming that mLhsMatrix was created with PetscTools::SetupMat, the value
-         * below should be equivalent to what was used as preallocation in that call.
-         */
-        mRowPreallocation = (unsigned) matrix_info.nz_allocated / mSize;
+            /*
+             * Assuming that mLhsMatrix was created with PetscTools::SetupMat, the value
+             * below should be equivalent to what was used as preallocation in that call.
+             */
+            mRowPreallocation = (unsigned) matrix_info.nz_allocated / mSize;
+        }
     }
     assert(!mRhsVector || !mLhsMatrix || vec_size == mat_size);
 
@@ -664,9 +668,16 @@ Vec LinearSystem::Solve(Vec lhsGuess)
      *    VecView(mRhsVector,    PETSC_VIEWER_STDOUT_WORLD);
      */
 
-    // Double check that the non-zero pattern hasn't changed
+    // Double check that the non-zero pattern hasn't changed (shell matrices don't have one)
     MatInfo mat_info;
-    MatGetInfo(mLhsMatrix, MAT_GLOBAL_SUM, &mat_info);
+    if (PetscMatTools::IsShell(mLhsMatrix))
+    {
+        mat_info.nz_used = 0.0;
+    }
+    else
+    {
+        MatGetInfo(mLhsMatrix, MAT_GLOBAL_SUM, &mat_info);
+    }
 
     if (!mKspIsSetup)
     {
@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscMatTools.hpp"
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 
 ///////////////////////////////////////////////////////////////////////////////////
@@ -411,3 +412,15 @@ void PetscMatTools::TurnOffVariableAllocationError(Mat matrix)
 #endif
 }
 
+bool PetscMatTools::IsShell(Mat matrix)
+{
+#if (PETSC_VERSION_MAJOR == 3 && PETSC_VERSION_MINOR <= 3) //PETSc 3.0 to PETSc 3.3
+    //The PETSc developers changed this one, but later changed it back again!
+    const MatType type;
+#else
+    MatType type;
+#endif
+    MatGetType(matrix, &type);
+    return (strcmp(type, MATSHELL) == 0);
+}
+
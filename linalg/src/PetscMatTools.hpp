@@ -223,6 +223,14 @@ public:
      */
     static void TurnOffVariableAllocationError(Mat matrix);
 
+    /**
+     * @return whether the matrix is a shell matrix, i.e. one which is only available through
+     * its action on vectors, so its entries and storage information cannot be queried.
+     *
+     * @param matrix The matrix
+     */
+    static bool IsShell(Mat matrix);
+
     /**
      * Add multiple values to a matrix.
      *
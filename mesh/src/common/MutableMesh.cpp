@@ -35,6 +35,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <map>
 #include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <iterator>
 
 #include "MutableMesh.hpp"
 #include "OutputFileHandler.hpp"
@@ -47,16 +50,24 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #undef REAL
 #undef VOID
 
+/**
+ * Tolerance used by the orientation and in-circle tests during incremental remeshing.
+ * Near-degenerate configurations are left to a full remesh.
+ */
+static const double INCREMENTAL_REMESH_TOLERANCE = 1e-10;
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MutableMesh<ELEMENT_DIM, SPACE_DIM>::MutableMesh()
-    : mAddedNodes(false)
+    : mAddedNodes(false),
+      mUseIncrementalReMesh(false),
+      mCanReMeshIncrementally(false)
 {
     this->mMeshChangesDuringSimulation = true;
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MutableMesh<ELEMENT_DIM, SPACE_DIM>::MutableMesh(std::vector<Node<SPACE_DIM> *> nodes)
+    : mUseIncrementalReMesh(false)
 {
     this->mMeshChangesDuringSimulation = true;
     Clear();
@@ -79,7 +90,8 @@ MutableMesh<ELEMENT_DIM, SPACE_DIM>::~MutableMesh()
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 unsigned MutableMesh<ELEMENT_DIM, SPACE_DIM>::AddNode(Node<SPACE_DIM>* pNewNode)
 {
-    if (mDeletedNodeIndices.empty())
+    // Deleted nodes stay in the triangulation until an incremental remesh removes them
+    if (mDeletedNodeIndices.empty() || mUseIncrementalReMesh)
     {
         pNewNode->SetIndex(this->mNodes.size());
         this->mNodes.push_back(pNewNode);
@@ -123,6 +135,7 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::Clear()
     mDeletedBoundaryElementIndices.clear();
     mDeletedNodeIndices.clear();
     mAddedNodes = false;
+    mCanReMeshIncrementally = false;
 
     TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::Clear();
 }
@@ -263,6 +276,7 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElement(unsigned index)
 {
     assert(!this->mElements[index]->IsDeleted());
+    mCanReMeshIncrementally = false;
     this->mElements[index]->MarkAsDeleted();
     mDeletedElementIndices.push_back(index);
 
@@ -307,6 +321,7 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::MoveMergeNode(unsigned index,
     {
         EXCEPTION("Trying to move a deleted node");
     }
+    mCanReMeshIncrementally = false;
 
     if (index == targetIndex)
     {
@@ -462,6 +477,7 @@ unsigned MutableMesh<ELEMENT_DIM, SPACE_DIM>::RefineElement(
     {
         EXCEPTION("RefineElement could not be started (point is not in element)");
     }
+    mCanReMeshIncrementally = false;
 
     // Add a new node from the point that is passed to RefineElement
     unsigned new_node_index = AddNode(new Node<SPACE_DIM>(0, point.rGetLocation()));
@@ -515,6 +531,7 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::DeleteBoundaryNodeAt(unsigned index)
     {
         EXCEPTION(" You may only delete a boundary node ");
     }
+    mCanReMeshIncrementally = false;
 
     this->mNodes[index]->MarkAsDeleted();
     mDeletedNodeIndices.push_back(index);
@@ -773,6 +790,11 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(NodeMap& map)
     }
     else if (SPACE_DIM==2)  // In 2D, remesh using triangle via library calls
     {
+        if (mUseIncrementalReMesh && mCanReMeshIncrementally && ReMeshIncrementally(map))
+        {
+            return;
+        }
+
         struct triangulateio mesher_input, mesher_output;
         this->InitialiseTriangulateIo(mesher_input);
         this->InitialiseTriangulateIo(mesher_output);
@@ -787,6 +809,8 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(NodeMap& map)
         //Tidy up triangle
         this->FreeTriangulateIo(mesher_input);
         this->FreeTriangulateIo(mesher_output);
+
+        mCanReMeshIncrementally = true;
     }
     else // in 3D, remesh using tetgen
     {
@@ -809,6 +833,511 @@ void MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh()
     ReMesh(map);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableMesh<ELEMENT_DIM, SPACE_DIM>::SetUseIncrementalReMesh(bool useIncrementalReMesh)
+{
+    if (useIncrementalReMesh && !(ELEMENT_DIM == 2 && SPACE_DIM == 2))
+    {
+        EXCEPTION("Incremental remeshing is only implemented for 2D meshes.");
+    }
+    mUseIncrementalReMesh = useIncrementalReMesh;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::GetUseIncrementalReMesh() const
+{
+    return mUseIncrementalReMesh;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::ReMeshIncrementally(NodeMap& rMap)
+{
+    assert(ELEMENT_DIM == 2 && SPACE_DIM == 2);
+
+    // Deleted nodes stay in the triangulation until they are removed below, so their locations are needed too
+    mLocationsForIncrementalReMesh.resize(this->mNodes.size());
+    for (unsigned node_index=0; node_index<this->mNodes.size(); node_index++)
+    {
+        mLocationsForIncrementalReMesh[node_index] = this->mNodes[node_index]->GetPoint().rGetLocation();
+    }
+    bool success = TryToReMeshIncrementally(rMap);
+    mLocationsForIncrementalReMesh.clear();
+
+    return success;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::TryToReMeshIncrementally(NodeMap& rMap)
+{
+    // The nodes may only have moved so far that every element is still anticlockwise...
+    std::vector<std::pair<unsigned, unsigned> > edges_to_check;
+    unsigned start_element = UINT_MAX;
+    for (unsigned elem_index=0; elem_index<this->mElements.size(); elem_index++)
+    {
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[elem_index];
+        if (!p_element->IsDeleted())
+        {
+            if (GetNormalisedOrientation(p_element->GetNodeGlobalIndex(0), p_element->GetNodeGlobalIndex(1), p_element->GetNodeGlobalIndex(2))
+                    <= INCREMENTAL_REMESH_TOLERANCE)
+            {
+                return false;
+            }
+
+            // Each interior edge is traversed in opposite directions by its two elements, so add it once
+            for (unsigned i=0; i<3; i++)
+            {
+                unsigned node_a = p_element->GetNodeGlobalIndex(i);
+                unsigned node_b = p_element->GetNodeGlobalIndex((i+1)%3);
+                if (node_a < node_b)
+                {
+                    edges_to_check.push_back(std::make_pair(node_a, node_b));
+                }
+            }
+            start_element = elem_index;
+        }
+    }
+
+    // ...and the boundary is still the convex hull
+    if (start_element == UINT_MAX || !HasConvexBoundary())
+    {
+        return false;
+    }
+
+    if (!FlipEdgesUntilDelaunay(edges_to_check))
+    {
+        return false;
+    }
+
+    // Insert any nodes added since the last remesh
+    for (unsigned node_index=0; node_index<this->mNodes.size(); node_index++)
+    {
+        Node<SPACE_DIM>* p_node = this->mNodes[node_index];
+        if (!p_node->IsDeleted() && p_node->GetNumContainingElements() == 0)
+        {
+            if (!InsertNodeIntoTriangulation(node_index, start_element, edges_to_check)
+                || !FlipEdgesUntilDelaunay(edges_to_check))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Remove any nodes marked as deleted since the last remesh
+    for (unsigned node_index=0; node_index<this->mNodes.size(); node_index++)
+    {
+        Node<SPACE_DIM>* p_node = this->mNodes[node_index];
+        if (p_node->IsDeleted() && p_node->GetNumContainingElements() > 0)
+        {
+            if (!RemoveNodeFromTriangulation(node_index, edges_to_check)
+                || !FlipEdgesUntilDelaunay(edges_to_check))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Size of the Jacobian caches for any new elements, so that ReIndex() can move them
+    this->RefreshJacobianCachedData();
+
+    mAddedNodes = false;
+    ReIndex(rMap);
+
+    // A full remesh creates new nodes, so leave the nodes in the same state
+    for (unsigned node_index=0; node_index<this->mNodes.size(); node_index++)
+    {
+        this->mNodes[node_index]->ClearAppliedForce();
+    }
+
+    return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::FlipEdgesUntilDelaunay(std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck)
+{
+    unsigned num_flips = 0;
+    unsigned max_num_flips = 10*this->mElements.size() + 100;
+
+    while (!rEdgesToCheck.empty())
+    {
+        unsigned node_a = rEdgesToCheck.back().first;
+        unsigned node_b = rEdgesToCheck.back().second;
+        rEdgesToCheck.pop_back();
+
+        // Boundary edges, and edges removed by an earlier flip, are skipped
+        std::vector<unsigned> shared_elements = GetElementsSharingEdge(node_a, node_b);
+        if (shared_elements.size() != 2)
+        {
+            continue;
+        }
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element_1 = this->mElements[shared_elements[0]];
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element_2 = this->mElements[shared_elements[1]];
+
+        // The nodes opposite the edge in each element
+        unsigned node_c = p_element_1->GetNodeGlobalIndex(0) + p_element_1->GetNodeGlobalIndex(1) + p_element_1->GetNodeGlobalIndex(2) - node_a - node_b;
+        unsigned node_d = p_element_2->GetNodeGlobalIndex(0) + p_element_2->GetNodeGlobalIndex(1) + p_element_2->GetNodeGlobalIndex(2) - node_a - node_b;
+
+        // Order the edge so that element 1 is (a,b,c) and element 2 is (b,a,d), both anticlockwise
+        if (GetNormalisedOrientation(node_a, node_b, node_c) < 0.0)
+        {
+            std::swap(node_a, node_b);
+        }
+
+        if (IsNodeInCircumcircle(node_a, node_b, node_c, node_d))
+        {
+            // The quadrilateral a,d,b,c must be convex for the flipped elements to be valid
+            if (GetNormalisedOrientation(node_a, node_d, node_c) <= INCREMENTAL_REMESH_TOLERANCE
+                || GetNormalisedOrientation(node_d, node_b, node_c) <= INCREMENTAL_REMESH_TOLERANCE)
+            {
+                return false;
+            }
+
+            // Replace edge ab by cd, so the elements become (a,d,c) and (b,c,d)
+            p_element_1->ReplaceNode(this->mNodes[node_b], this->mNodes[node_d]);
+            p_element_2->ReplaceNode(this->mNodes[node_a], this->mNodes[node_c]);
+
+            rEdgesToCheck.push_back(std::make_pair(node_a, node_d));
+            rEdgesToCheck.push_back(std::make_pair(node_d, node_b));
+            rEdgesToCheck.push_back(std::make_pair(node_b, node_c));
+            rEdgesToCheck.push_back(std::make_pair(node_c, node_a));
+
+            num_flips++;
+            if (num_flips > max_num_flips)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::InsertNodeIntoTriangulation(unsigned nodeIndex,
+                                                                      unsigned& rStartElement,
+                                                                      std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck)
+{
+    unsigned element_index = rStartElement;
+
+    // Walk towards the node, crossing any edge that the node lies beyond
+    for (unsigned step=0; step<=this->mElements.size(); step++)
+    {
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[element_index];
+        bool moved = false;
+        bool is_on_edge = false;
+        for (unsigned i=0; i<3 && !moved; i++)
+        {
+            unsigned node_a = p_element->GetNodeGlobalIndex(i);
+            unsigned node_b = p_element->GetNodeGlobalIndex((i+1)%3);
+            double orientation = GetNormalisedOrientation(node_a, node_b, nodeIndex);
+
+            if (orientation < -INCREMENTAL_REMESH_TOLERANCE)
+            {
+                std::vector<unsigned> shared_elements = GetElementsSharingEdge(node_a, node_b);
+                if (shared_elements.size() != 2)
+                {
+                    // The node is outside the mesh
+                    return false;
+                }
+                element_index = (shared_elements[0] == element_index) ? shared_elements[1] : shared_elements[0];
+                moved = true;
+            }
+            else if (orientation <= INCREMENTAL_REMESH_TOLERANCE)
+            {
+                is_on_edge = true;
+            }
+        }
+
+        if (!moved)
+        {
+            if (is_on_edge)
+            {
+                return false;
+            }
+
+            // Split the element (a,b,c) into (p,b,c), (a,p,c) and (a,b,p)
+            Node<SPACE_DIM>* p_node_a = p_element->GetNode(0);
+            Node<SPACE_DIM>* p_node_b = p_element->GetNode(1);
+            Node<SPACE_DIM>* p_node_c = p_element->GetNode(2);
+            Node<SPACE_DIM>* p_new_node = this->mNodes[nodeIndex];
+
+            Element<ELEMENT_DIM, SPACE_DIM>* p_new_element = new Element<ELEMENT_DIM, SPACE_DIM>(*p_element, this->mElements.size());
+            this->mElements.push_back(p_new_element);
+            p_new_element->ReplaceNode(p_node_a, p_new_node);
+
+            p_new_element = new Element<ELEMENT_DIM, SPACE_DIM>(*p_element, this->mElements.size());
+            this->mElements.push_back(p_new_element);
+            p_new_element->ReplaceNode(p_node_b, p_new_node);
+
+            p_element->ReplaceNode(p_node_c, p_new_node);
+
+            rEdgesToCheck.push_back(std::make_pair(p_node_a->GetIndex(), p_node_b->GetIndex()));
+            rEdgesToCheck.push_back(std::make_pair(p_node_b->GetIndex(), p_node_c->GetIndex()));
+            rEdgesToCheck.push_back(std::make_pair(p_node_c->GetIndex(), p_node_a->GetIndex()));
+
+            rStartElement = element_index;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::RemoveNodeFromTriangulation(unsigned nodeIndex,
+                                                                      std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck)
+{
+    Node<SPACE_DIM>* p_node = this->mNodes[nodeIndex];
+    if (p_node->IsBoundaryNode())
+    {
+        return false;
+    }
+
+    // Chain the far edges of the elements containing the node into an anticlockwise polygon
+    std::map<unsigned, unsigned> next_node;
+    for (typename Node<SPACE_DIM>::ContainingElementIterator it = p_node->ContainingElementsBegin();
+         it != p_node->ContainingElementsEnd();
+         ++it)
+    {
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[*it];
+        unsigned local_index = 0;
+        while (p_element->GetNodeGlobalIndex(local_index) != nodeIndex)
+        {
+            local_index++;
+        }
+        next_node[p_element->GetNodeGlobalIndex((local_index+1)%3)] = p_element->GetNodeGlobalIndex((local_index+2)%3);
+    }
+
+    std::vector<unsigned> polygon;
+    polygon.push_back(next_node.begin()->first);
+    while (polygon.size() < next_node.size())
+    {
+        std::map<unsigned, unsigned>::iterator it = next_node.find(polygon.back());
+        if (it == next_node.end() || it->second == polygon[0])
+        {
+            return false;
+        }
+        polygon.push_back(it->second);
+    }
+    if (polygon.size() < 3 || next_node[polygon.back()] != polygon[0])
+    {
+        return false;
+    }
+
+    /*
+     * Reduce the number of elements around the node to three by flipping the edge from
+     * the node to a convex vertex of the polygon, which cuts that vertex off the polygon.
+     */
+    while (polygon.size() > 3)
+    {
+        unsigned num_vertices = polygon.size();
+        bool found_ear = false;
+        for (unsigned i=0; i<num_vertices && !found_ear; i++)
+        {
+            unsigned prev = polygon[(i+num_vertices-1)%num_vertices];
+            unsigned curr = polygon[i];
+            unsigned next = polygon[(i+1)%num_vertices];
+            if (GetNormalisedOrientation(prev, curr, next) > INCREMENTAL_REMESH_TOLERANCE
+                && GetNormalisedOrientation(nodeIndex, prev, next) > INCREMENTAL_REMESH_TOLERANCE)
+            {
+                // Element 1 is (node,curr,next) and element 2 is (node,prev,curr)
+                std::vector<unsigned> shared_elements = GetElementsSharingEdge(nodeIndex, curr);
+                assert(shared_elements.size() == 2);
+                Element<ELEMENT_DIM, SPACE_DIM>* p_element_1 = this->mElements[shared_elements[0]];
+                Element<ELEMENT_DIM, SPACE_DIM>* p_element_2 = this->mElements[shared_elements[1]];
+                if (p_element_1->GetNodeGlobalIndex(0) != next
+                    && p_element_1->GetNodeGlobalIndex(1) != next
+                    && p_element_1->GetNodeGlobalIndex(2) != next)
+                {
+                    std::swap(p_element_1, p_element_2);
+                }
+
+                // The elements become (node,prev,next) and (curr,next,prev)
+                p_element_1->ReplaceNode(this->mNodes[curr], this->mNodes[prev]);
+                p_element_2->ReplaceNode(p_node, this->mNodes[next]);
+
+                rEdgesToCheck.push_back(std::make_pair(prev, curr));
+                rEdgesToCheck.push_back(std::make_pair(curr, next));
+                rEdgesToCheck.push_back(std::make_pair(next, prev));
+
+                polygon.erase(polygon.begin() + i);
+                found_ear = true;
+            }
+        }
+        if (!found_ear)
+        {
+            return false;
+        }
+    }
+    if (GetNormalisedOrientation(polygon[0], polygon[1], polygon[2]) <= INCREMENTAL_REMESH_TOLERANCE)
+    {
+        return false;
+    }
+
+    // Merge the three remaining elements into one, reusing the first and deleting the others
+    std::vector<unsigned> star_elements(p_node->rGetContainingElementIndices().begin(), p_node->rGetContainingElementIndices().end());
+    assert(star_elements.size() == 3);
+
+    Element<ELEMENT_DIM, SPACE_DIM>* p_merged_element = this->mElements[star_elements[0]];
+    unsigned missing_node = polygon[0] + polygon[1] + polygon[2];
+    for (unsigned i=0; i<3; i++)
+    {
+        if (p_merged_element->GetNodeGlobalIndex(i) != nodeIndex)
+        {
+            missing_node -= p_merged_element->GetNodeGlobalIndex(i);
+        }
+    }
+    p_merged_element->ReplaceNode(p_node, this->mNodes[missing_node]);
+
+    for (unsigned i=1; i<3; i++)
+    {
+        this->mElements[star_elements[i]]->MarkAsDeleted();
+        mDeletedElementIndices.push_back(star_elements[i]);
+    }
+
+    for (unsigned i=0; i<3; i++)
+    {
+        rEdgesToCheck.push_back(std::make_pair(polygon[i], polygon[(i+1)%3]));
+    }
+
+    return true;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::HasConvexBoundary()
+{
+    // Orient each boundary edge so that the mesh lies to its left
+    std::map<unsigned, unsigned> next_boundary_node;
+    for (unsigned i=0; i<this->mBoundaryElements.size(); i++)
+    {
+        if (this->mBoundaryElements[i]->IsDeleted())
+        {
+            continue;
+        }
+        unsigned node_a = this->mBoundaryElements[i]->GetNodeGlobalIndex(0);
+        unsigned node_b = this->mBoundaryElements[i]->GetNodeGlobalIndex(1);
+
+        std::vector<unsigned> shared_elements = GetElementsSharingEdge(node_a, node_b);
+        if (shared_elements.size() != 1)
+        {
+            return false;
+        }
+        Element<ELEMENT_DIM, SPACE_DIM>* p_element = this->mElements[shared_elements[0]];
+        unsigned node_c = p_element->GetNodeGlobalIndex(0) + p_element->GetNodeGlobalIndex(1) + p_element->GetNodeGlobalIndex(2) - node_a - node_b;
+        if (GetNormalisedOrientation(node_a, node_b, node_c) < 0.0)
+        {
+            std::swap(node_a, node_b);
+        }
+        if (!next_boundary_node.insert(std::make_pair(node_a, node_b)).second)
+        {
+            return false;
+        }
+    }
+    if (next_boundary_node.empty())
+    {
+        return false;
+    }
+
+    // The boundary must be a single loop that never turns clockwise and turns anticlockwise once in total
+    unsigned start_node = next_boundary_node.begin()->first;
+    unsigned current_node = start_node;
+    unsigned num_edges = 0;
+    double total_turn = 0.0;
+    do
+    {
+        std::map<unsigned, unsigned>::iterator it = next_boundary_node.find(current_node);
+        if (it == next_boundary_node.end())
+        {
+            return false;
+        }
+        unsigned next = it->second;
+        it = next_boundary_node.find(next);
+        if (it == next_boundary_node.end())
+        {
+            return false;
+        }
+        unsigned next_next = it->second;
+
+        if (GetNormalisedOrientation(current_node, next, next_next) < -INCREMENTAL_REMESH_TOLERANCE)
+        {
+            return false;
+        }
+
+        const c_vector<double, SPACE_DIM>& r_current = mLocationsForIncrementalReMesh[current_node];
+        const c_vector<double, SPACE_DIM>& r_next = mLocationsForIncrementalReMesh[next];
+        const c_vector<double, SPACE_DIM>& r_next_next = mLocationsForIncrementalReMesh[next_next];
+        double u_x = r_next[0] - r_current[0];
+        double u_y = r_next[1] - r_current[1];
+        double v_x = r_next_next[0] - r_next[0];
+        double v_y = r_next_next[1] - r_next[1];
+        total_turn += atan2(u_x*v_y - u_y*v_x, u_x*v_x + u_y*v_y);
+
+        current_node = next;
+        num_edges++;
+    }
+    while (current_node != start_node && num_edges <= next_boundary_node.size());
+
+    return (num_edges == next_boundary_node.size() && fabs(total_turn - 2.0*M_PI) < 1e-6);
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<unsigned> MutableMesh<ELEMENT_DIM, SPACE_DIM>::GetElementsSharingEdge(unsigned nodeAIndex, unsigned nodeBIndex)
+{
+    const std::set<unsigned>& r_elements_a = this->mNodes[nodeAIndex]->rGetContainingElementIndices();
+    const std::set<unsigned>& r_elements_b = this->mNodes[nodeBIndex]->rGetContainingElementIndices();
+
+    std::vector<unsigned> shared_elements;
+    std::set_intersection(r_elements_a.begin(), r_elements_a.end(),
+                          r_elements_b.begin(), r_elements_b.end(),
+                          std::back_inserter(shared_elements));
+    return shared_elements;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double MutableMesh<ELEMENT_DIM, SPACE_DIM>::GetNormalisedOrientation(unsigned nodeAIndex, unsigned nodeBIndex, unsigned nodeCIndex)
+{
+    const c_vector<double, SPACE_DIM>& r_a = mLocationsForIncrementalReMesh[nodeAIndex];
+    const c_vector<double, SPACE_DIM>& r_b = mLocationsForIncrementalReMesh[nodeBIndex];
+    const c_vector<double, SPACE_DIM>& r_c = mLocationsForIncrementalReMesh[nodeCIndex];
+
+    double ab_x = r_b[0] - r_a[0];
+    double ab_y = r_b[1] - r_a[1];
+    double ac_x = r_c[0] - r_a[0];
+    double ac_y = r_c[1] - r_a[1];
+
+    double norm = sqrt((ab_x*ab_x + ab_y*ab_y)*(ac_x*ac_x + ac_y*ac_y));
+    if (norm == 0.0)
+    {
+        return 0.0;
+    }
+    return (ab_x*ac_y - ab_y*ac_x)/norm;
+}
+
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MutableMesh<ELEMENT_DIM, SPACE_DIM>::IsNodeInCircumcircle(unsigned nodeAIndex, unsigned nodeBIndex, unsigned nodeCIndex, unsigned nodeDIndex)
+{
+    const c_vector<double, SPACE_DIM>& r_a = mLocationsForIncrementalReMesh[nodeAIndex];
+    const c_vector<double, SPACE_DIM>& r_b = mLocationsForIncrementalReMesh[nodeBIndex];
+    const c_vector<double, SPACE_DIM>& r_c = mLocationsForIncrementalReMesh[nodeCIndex];
+    const c_vector<double, SPACE_DIM>& r_d = mLocationsForIncrementalReMesh[nodeDIndex];
+
+    double ad_x = r_a[0] - r_d[0];
+    double ad_y = r_a[1] - r_d[1];
+    double bd_x = r_b[0] - r_d[0];
+    double bd_y = r_b[1] - r_d[1];
+    double cd_x = r_c[0] - r_d[0];
+    double cd_y = r_c[1] - r_d[1];
+
+    double ad_squared = ad_x*ad_x + ad_y*ad_y;
+    double bd_squared = bd_x*bd_x + bd_y*bd_y;
+    double cd_squared = cd_x*cd_x + cd_y*cd_y;
+
+    double determinant = ad_squared*(bd_x*cd_y - cd_x*bd_y)
+                       + bd_squared*(cd_x*ad_y - ad_x*cd_y)
+                       + cd_squared*(ad_x*bd_y - bd_x*ad_y);
+
+    // Scale by the fourth power of the largest distance so that the test does not depend on the size of the mesh
+    double scale = std::max(ad_squared, std::max(bd_squared, cd_squared));
+    return (determinant > INCREMENTAL_REMESH_TOLERANCE*scale*scale);
+}
+
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::vector<c_vector<unsigned, 5> > MutableMesh<ELEMENT_DIM, SPACE_DIM>::SplitLongEdges(double cutoffLength)
 {
@@ -910,6 +1439,7 @@ template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 c_vector<unsigned, 3> MutableMesh<ELEMENT_DIM, SPACE_DIM>::SplitEdge(Node<SPACE_DIM>* pNodeA, Node<SPACE_DIM>* pNodeB)
 {
     c_vector<unsigned, 3> new_node_index_vector;
+    mCanReMeshIncrementally = false;
 
     std::set<unsigned> elements_of_node_a = pNodeA->rGetContainingElementIndices();
     std::set<unsigned> elements_of_node_b = pNodeB->rGetContainingElementIndices();
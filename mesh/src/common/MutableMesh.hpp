@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define MUTABLEMESH_HPP_
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/split_member.hpp>
 
@@ -81,6 +82,8 @@ class MutableMesh : public TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>
                 archive & is_particle;
             }
         }
+
+        archive & mUseIncrementalReMesh;
     }
 
     /**
@@ -116,6 +119,11 @@ class MutableMesh : public TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>
             }
         }
 
+        if (version > 0)
+        {
+            archive & mUseIncrementalReMesh;
+        }
+
         // If ELEMENT_DIM=SPACEDIM Do a remesh after archiving has finished to get right number of boundary nodes etc.
         // NOTE - Subclasses must archive their member variables BEFORE calling this method.
         if(ELEMENT_DIM==SPACE_DIM)
@@ -150,8 +158,113 @@ protected:
     /** Whether any nodes have been added to the mesh. */
     bool mAddedNodes;
 
+    /**
+     * Whether ReMesh() should first try to repair the existing triangulation by
+     * edge flips, node insertion and node removal, rather than rebuilding it.
+     * Defaults to false.
+     */
+    bool mUseIncrementalReMesh;
+
+    /**
+     * Whether the elements still form the triangulation of the convex hull of the
+     * nodes left by the last call to ReMesh(), so that it may be repaired incrementally.
+     * Any other change to the connectivity of the mesh resets this flag.
+     */
+    bool mCanReMeshIncrementally;
+
 private:
 
+    /**
+     * The locations of all nodes, including those marked as deleted, during
+     * an incremental remesh. Empty at other times.
+     */
+    std::vector<c_vector<double, SPACE_DIM> > mLocationsForIncrementalReMesh;
+
+    /**
+     * Try to restore a Delaunay triangulation after a 2D remesh without rebuilding it.
+     * Locally non-Delaunay edges are flipped, nodes added since the last remesh are
+     * inserted into the triangles containing them and nodes marked as deleted are
+     * removed by retriangulating the polygon around them. The mesh is then re-indexed.
+     *
+     * @param rMap the NodeMap to fill in, as for ReMesh()
+     * @return whether this succeeded; if not, a full remesh must be carried out
+     */
+    bool ReMeshIncrementally(NodeMap& rMap);
+
+    /**
+     * Carry out the work of ReMeshIncrementally(), once the node locations have been stored.
+     *
+     * @param rMap the NodeMap to fill in, as for ReMesh()
+     * @return whether this succeeded
+     */
+    bool TryToReMeshIncrementally(NodeMap& rMap);
+
+    /**
+     * Apply Lawson's edge flipping algorithm to a set of edges, flipping each edge that
+     * is not locally Delaunay and then checking the four edges surrounding it.
+     *
+     * @param rEdgesToCheck pairs of node indices of the edges to check (emptied by this method)
+     * @return false if a flip would invert an element or too many flips were needed
+     */
+    bool FlipEdgesUntilDelaunay(std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck);
+
+    /**
+     * Insert a node that is not in any element into the triangulation, by walking
+     * to the element containing it and splitting that element into three.
+     *
+     * @param nodeIndex the global index of the node
+     * @param rStartElement the element at which to start the walk; on return, the element found
+     * @param rEdgesToCheck the edges that may no longer be Delaunay are appended to this
+     * @return false if the node lies outside the mesh or on an existing edge
+     */
+    bool InsertNodeIntoTriangulation(unsigned nodeIndex, unsigned& rStartElement, std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck);
+
+    /**
+     * Remove a node from the triangulation by flipping edges until it is contained in
+     * three elements, then merging these. The two elements no longer needed are marked
+     * as deleted.
+     *
+     * @param nodeIndex the global index of the node
+     * @param rEdgesToCheck the edges that may no longer be Delaunay are appended to this
+     * @return false if the node is on the boundary or its polygon cannot be triangulated
+     */
+    bool RemoveNodeFromTriangulation(unsigned nodeIndex, std::vector<std::pair<unsigned, unsigned> >& rEdgesToCheck);
+
+    /**
+     * @return whether the boundary elements form a single convex loop around the mesh,
+     * so that the triangulation covers the convex hull of its nodes.
+     */
+    bool HasConvexBoundary();
+
+    /**
+     * @return the indices of the elements containing both of the given nodes
+     *
+     * @param nodeAIndex the global index of the first node
+     * @param nodeBIndex the global index of the second node
+     */
+    std::vector<unsigned> GetElementsSharingEdge(unsigned nodeAIndex, unsigned nodeBIndex);
+
+    /**
+     * @return the sine of the angle at node A from node B to node C, which is positive
+     * when A, B and C are anticlockwise (2D only), or zero if two of the nodes coincide.
+     *
+     * @param nodeAIndex the global index of node A
+     * @param nodeBIndex the global index of node B
+     * @param nodeCIndex the global index of node C
+     */
+    double GetNormalisedOrientation(unsigned nodeAIndex, unsigned nodeBIndex, unsigned nodeCIndex);
+
+    /**
+     * @return whether node D lies strictly inside the circumcircle of the anticlockwise
+     * triangle A, B, C (2D only).
+     *
+     * @param nodeAIndex the global index of node A
+     * @param nodeBIndex the global index of node B
+     * @param nodeCIndex the global index of node C
+     * @param nodeDIndex the global index of node D
+     */
+    bool IsNodeInCircumcircle(unsigned nodeAIndex, unsigned nodeBIndex, unsigned nodeCIndex, unsigned nodeDIndex);
+
 #define COVERAGE_IGNORE
     /**
      * @return true if the mesh is Voronoi local to the given element.
@@ -313,12 +426,36 @@ public:
 #undef COVERAGE_IGNORE
 
     /**
-     * Re-mesh a mesh using triangle (via library calls) or tetgen
+     * Re-mesh a mesh using triangle (via library calls) or tetgen.
+     *
+     * In 2D, if incremental remeshing has been switched on with SetUseIncrementalReMesh(),
+     * the triangulation left by the previous remesh is repaired instead where possible,
+     * and triangle is only called if this fails.
+     *
      * @param map is a NodeMap which associates the indices of nodes in the old mesh
      * with indices of nodes in the new mesh.  This should be created with the correct size (NumAllNodes)
      */
     virtual void ReMesh(NodeMap& map);
 
+    /**
+     * Set whether ReMesh() should repair the existing triangulation by edge flips and
+     * node insertion and removal, falling back to a full remesh when the mesh has changed
+     * in a way this cannot handle (for example, a boundary node moving inwards or being
+     * deleted). This results in a different element numbering to a full remesh. While it
+     * is switched on, AddNode() does not reuse the indices of deleted nodes.
+     *
+     * This is only implemented for 2D meshes: 3D meshes are always remeshed in full with
+     * tetgen, as repairing a tetrahedralisation would need 2-3 and 3-2 face flips.
+     *
+     * @param useIncrementalReMesh whether to remesh incrementally
+     */
+    void SetUseIncrementalReMesh(bool useIncrementalReMesh);
+
+    /**
+     * @return whether ReMesh() repairs the existing triangulation where possible.
+     */
+    bool GetUseIncrementalReMesh() const;
+
     /**
      * Alternative version of remesh which takes no parameters, i.e. does not require a NodeMap.
      * It will create one and call the other ReMesh method.
@@ -359,6 +496,23 @@ public:
 #undef COVERAGE_IGNORE
 };
 
+namespace boost {
+namespace serialization {
+/**
+ * Specify a version number for archive backwards compatibility.
+ *
+ * This is how to do BOOST_CLASS_VERSION(MutableMesh, 1)
+ * with a templated class.
+ */
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+struct version<MutableMesh<ELEMENT_DIM, SPACE_DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(1);
+};
+} // namespace serialization
+} // namespace boost
+
 #include "SerializationExportWrapper.hpp"
 EXPORT_TEMPLATE_CLASS_ALL_DIMS(MutableMesh)
 
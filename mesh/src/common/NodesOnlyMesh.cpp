@@ -45,7 +45,9 @@ NodesOnlyMesh<SPACE_DIM>::NodesOnlyMesh()
           mMinimumNodeDomainBoundarySeparation(1.0),
           mMaxAddedNodeIndex(0u),
           mpBoxCollection(NULL),
-          mCalculateNodeNeighbours(true)
+          mCalculateNodeNeighbours(true),
+          mUseCartesianDecomposition(false),
+          mUseFlatCellList(false)
 {
 }
 
@@ -269,39 +271,42 @@ void NodesOnlyMesh<SPACE_DIM>::UpdateNodeIndices()
 template<unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::CalculateNodesOutsideLocalDomain()
 {
-    mNodesToSendRight.clear();
-    mNodesToSendLeft.clear();
+    mNodesToSendPerProcess.clear();
 
     for (typename AbstractMesh<SPACE_DIM, SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
             node_iter != this->GetNodeIteratorEnd();
             ++node_iter)
     {
         unsigned owning_process = mpBoxCollection->GetProcessOwningNode(&(*node_iter));
-        if (owning_process == PetscTools::GetMyRank())
+        if (owning_process != PetscTools::GetMyRank())
         {
-            // Do nothing.
-        }
-        else if (owning_process == PetscTools::GetMyRank() + 1)
-        {
-            mNodesToSendRight.push_back(node_iter->GetIndex());
-        }
-        else if (owning_process == PetscTools::GetMyRank() - 1)
-        {
-            mNodesToSendLeft.push_back(node_iter->GetIndex());
+            mNodesToSendPerProcess[owning_process].push_back(node_iter->GetIndex());
         }
     }
 }
 
+template<unsigned SPACE_DIM>
+std::vector<unsigned>& NodesOnlyMesh<SPACE_DIM>::rGetNodesToSend(unsigned processIndex)
+{
+    return mNodesToSendPerProcess[processIndex];
+}
+
+template<unsigned SPACE_DIM>
+std::vector<unsigned>& NodesOnlyMesh<SPACE_DIM>::rGetHaloNodesToSend(unsigned processIndex)
+{
+    return mpBoxCollection->rGetHaloNodesToSend(processIndex);
+}
+
 template<unsigned SPACE_DIM>
 std::vector<unsigned>& NodesOnlyMesh<SPACE_DIM>::rGetNodesToSendLeft()
 {
-    return mNodesToSendLeft;
+    return rGetNodesToSend(PetscTools::GetMyRank() - 1);
 }
 
 template<unsigned SPACE_DIM>
 std::vector<unsigned>& NodesOnlyMesh<SPACE_DIM>::rGetNodesToSendRight()
 {
-    return mNodesToSendRight;
+    return rGetNodesToSend(PetscTools::GetMyRank() + 1);
 }
 
 template<unsigned SPACE_DIM>
@@ -316,6 +321,31 @@ std::vector<unsigned>& NodesOnlyMesh<SPACE_DIM>::rGetHaloNodesToSendLeft()
     return mpBoxCollection->rGetHaloNodesLeft();
 }
 
+template<unsigned SPACE_DIM>
+const std::vector<unsigned>& NodesOnlyMesh<SPACE_DIM>::rGetNeighbourProcesses()
+{
+    assert(mpBoxCollection);
+    return mpBoxCollection->rGetNeighbourProcesses();
+}
+
+template<unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::SetUseCartesianDecomposition(bool useCartesianDecomposition)
+{
+    mUseCartesianDecomposition = useCartesianDecomposition;
+}
+
+template<unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::SetUseFlatCellList(bool useFlatCellList)
+{
+    mUseFlatCellList = useFlatCellList;
+
+    // Nodes are placed in the new storage at the next call to UpdateBoxCollection()
+    if (mpBoxCollection)
+    {
+        mpBoxCollection->SetUseFlatCellList(mUseFlatCellList);
+    }
+}
+
 template<unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::AddNodeWithFixedIndex(Node<SPACE_DIM>* pNewNode)
 {
@@ -458,9 +488,6 @@ void NodesOnlyMesh<SPACE_DIM>::EnlargeBoxCollection()
 {
     assert(mpBoxCollection);
 
-    int num_local_rows = mpBoxCollection->GetNumLocalRows();
-    int new_local_rows = num_local_rows + (int)(PetscTools::AmTopMost()) + (int)(PetscTools::AmMaster());
-
     c_vector<double, 2*SPACE_DIM> current_domain_size = mpBoxCollection->rGetDomainSize();
     c_vector<double, 2*SPACE_DIM> new_domain_size;
 
@@ -471,7 +498,28 @@ void NodesOnlyMesh<SPACE_DIM>::EnlargeBoxCollection()
         new_domain_size[2*d+1] = current_domain_size[2*d+1] + (mMaximumInteractionDistance - fudge);
     }
 
-    SetUpBoxCollection(mMaximumInteractionDistance, new_domain_size, new_local_rows);
+    if (mUseCartesianDecomposition)
+    {
+        // Processes on the edge of the process grid take the new boxes on their outer faces.
+        std::vector<std::vector<unsigned> > new_boundaries = mpBoxCollection->rGetProcessBoxBoundaries();
+        for (unsigned d=0; d < SPACE_DIM; d++)
+        {
+            for (unsigned i=1; i<new_boundaries[d].size(); i++)
+            {
+                new_boundaries[d][i]++;
+            }
+            new_boundaries[d].back()++;
+        }
+
+        SetUpCartesianBoxCollection(mMaximumInteractionDistance, new_domain_size, mpBoxCollection->GetNumProcessesEachDirection(), new_boundaries);
+    }
+    else
+    {
+        int num_local_rows = mpBoxCollection->GetNumLocalRows();
+        int new_local_rows = num_local_rows + (int)(PetscTools::AmTopMost()) + (int)(PetscTools::AmMaster());
+
+        SetUpBoxCollection(mMaximumInteractionDistance, new_domain_size, new_local_rows);
+    }
 }
 
 template<unsigned SPACE_DIM>
@@ -547,17 +595,47 @@ void NodesOnlyMesh<SPACE_DIM>::SetUpBoxCollection(const std::vector<Node<SPACE_D
 template<unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::SetUpBoxCollection(double cutOffLength, c_vector<double, 2*SPACE_DIM> domainSize, int numLocalRows, bool isPeriodic)
 {
+     if (mUseCartesianDecomposition && !isPeriodic)
+     {
+         // Let the box collection choose the process grid.
+         c_vector<unsigned, SPACE_DIM> num_processes_each_direction = scalar_vector<unsigned>(SPACE_DIM, 0u);
+         SetUpCartesianBoxCollection(cutOffLength, domainSize, num_processes_each_direction);
+         return;
+     }
+
      ClearBoxCollection();
 
      mpBoxCollection = new DistributedBoxCollection<SPACE_DIM>(cutOffLength, domainSize, isPeriodic, numLocalRows);
      mpBoxCollection->SetupLocalBoxesHalfOnly();
      mpBoxCollection->SetupHaloBoxes();
      mpBoxCollection->SetCalculateNodeNeighbours(mCalculateNodeNeighbours);
+     mpBoxCollection->SetUseFlatCellList(mUseFlatCellList);
+}
+
+template<unsigned SPACE_DIM>
+void NodesOnlyMesh<SPACE_DIM>::SetUpCartesianBoxCollection(double cutOffLength,
+                                                           c_vector<double, 2*SPACE_DIM> domainSize,
+                                                           c_vector<unsigned, SPACE_DIM> numProcessesEachDirection,
+                                                           std::vector<std::vector<unsigned> > processBoxBoundaries)
+{
+     ClearBoxCollection();
+
+     mpBoxCollection = new DistributedBoxCollection<SPACE_DIM>(cutOffLength, domainSize, numProcessesEachDirection, processBoxBoundaries);
+     mpBoxCollection->SetupLocalBoxesHalfOnly();
+     mpBoxCollection->SetupHaloBoxes();
+     mpBoxCollection->SetCalculateNodeNeighbours(mCalculateNodeNeighbours);
+     mpBoxCollection->SetUseFlatCellList(mUseFlatCellList);
 }
 
 template<unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::AddNodesToBoxes()
 {
+     if (mUseFlatCellList)
+     {
+          mpBoxCollection->UpdateFlatCellList(this->mNodes);
+          return;
+     }
+
      // Put the nodes in the boxes.
      for (typename AbstractMesh<SPACE_DIM, SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
                node_iter != this->GetNodeIteratorEnd();
@@ -571,6 +649,18 @@ void NodesOnlyMesh<SPACE_DIM>::AddNodesToBoxes()
 template<unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::AddHaloNodesToBoxes()
 {
+    if (mUseFlatCellList)
+    {
+        std::vector<Node<SPACE_DIM>*> halo_nodes;
+        halo_nodes.reserve(mHaloNodes.size());
+        for (unsigned i=0; i<mHaloNodes.size(); i++)
+        {
+            halo_nodes.push_back(mHaloNodes[i].get());
+        }
+        mpBoxCollection->AddHaloNodesToFlatCellList(halo_nodes);
+        return;
+    }
+
     // Add halo nodes
     for (typename std::vector<boost::shared_ptr<Node<SPACE_DIM> > >::iterator halo_node_iter = mHaloNodes.begin();
             halo_node_iter != mHaloNodes.end();
@@ -586,8 +676,12 @@ void NodesOnlyMesh<SPACE_DIM>::UpdateBoxCollection()
 {
     assert(mpBoxCollection);
 
-    // Remove node pointers from boxes in BoxCollection.
-    mpBoxCollection->EmptyBoxes();
+    // Remove node pointers from boxes in BoxCollection. The flat cell list is instead
+    // updated in place, so that its sort can be reused if no node has changed box.
+    if (!mUseFlatCellList)
+    {
+        mpBoxCollection->EmptyBoxes();
+    }
 
     AddNodesToBoxes();
 
@@ -611,10 +705,6 @@ void NodesOnlyMesh<SPACE_DIM>::ResizeBoxCollection()
 template<unsigned SPACE_DIM>
 void NodesOnlyMesh<SPACE_DIM>::LoadBalanceMesh()
 {
-    std::vector<int> local_node_distribution = mpBoxCollection->CalculateNumberOfNodesInEachStrip();
-
-    unsigned new_rows = mpBoxCollection->LoadBalance(local_node_distribution);
-
     c_vector<double, 2*SPACE_DIM> current_domain_size = mpBoxCollection->rGetDomainSize();
 
     // This ensures the domain will stay the same size.
@@ -624,7 +714,21 @@ void NodesOnlyMesh<SPACE_DIM>::LoadBalanceMesh()
         current_domain_size[2*d] = current_domain_size[2*d] + fudge;
         current_domain_size[2*d+1] = current_domain_size[2*d+1] - fudge;
     }
-    SetUpBoxCollection(mMaximumInteractionDistance, current_domain_size, new_rows);
+
+    if (mUseCartesianDecomposition)
+    {
+        std::vector<std::vector<unsigned> > new_boundaries = mpBoxCollection->CalculateBalancedProcessBoundaries();
+
+        SetUpCartesianBoxCollection(mMaximumInteractionDistance, current_domain_size, mpBoxCollection->GetNumProcessesEachDirection(), new_boundaries);
+    }
+    else
+    {
+        std::vector<int> local_node_distribution = mpBoxCollection->CalculateNumberOfNodesInEachStrip();
+
+        unsigned new_rows = mpBoxCollection->LoadBalance(local_node_distribution);
+
+        SetUpBoxCollection(mMaximumInteractionDistance, current_domain_size, new_rows);
+    }
 }
 
 template<unsigned SPACE_DIM>
@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NODESONLYMESH_HPP_
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/map.hpp>
 
@@ -74,6 +75,14 @@ private:
     {
         archive & mMaximumInteractionDistance;
         archive & mMinimumNodeDomainBoundarySeparation;
+        if (version > 0)
+        {
+            archive & mUseCartesianDecomposition;
+        }
+        if (version > 1)
+        {
+            archive & mUseFlatCellList;
+        }
         archive & boost::serialization::base_object<MutableMesh<SPACE_DIM, SPACE_DIM> >(*this);
     }
 
@@ -98,11 +107,8 @@ private:
     /** A list of the global indices of nodes that have been deleted from this process and can be reused. */
     std::vector<unsigned> mDeletedGlobalNodeIndices;
 
-    /** A list of global indices of nodes that need to be moved to the right hand process. */
-    std::vector<unsigned> mNodesToSendRight;
-
-    /** A list of global indices of nodes that need to be moved to the left hand process. */
-    std::vector<unsigned> mNodesToSendLeft;
+    /** Lists of global indices of nodes that need to be moved to each neighbouring process, keyed by process rank. */
+    std::map<unsigned, std::vector<unsigned> > mNodesToSendPerProcess;
 
     /**A list of flags showing which initial nodes passed to ConstructNodesWithoutMesh
      * were created on this process. */
@@ -118,6 +124,18 @@ private:
     /** Whether to calculate node neighbours in the box collection. Switch off for efficiency */
     bool mCalculateNodeNeighbours;
 
+    /**
+     * Whether to split the box collection between processes in every direction (a Cartesian process grid),
+     * rather than in strips along the last direction only. Defaults to false.
+     */
+    bool mUseCartesianDecomposition;
+
+    /**
+     * Whether the box collection stores the nodes in each box in a flat, sorted cell list
+     * rather than a std::set per box. Defaults to false.
+     */
+    bool mUseFlatCellList;
+
     /**
      * Calculate the next unique global index available on this
      * process. Uses a hashing function to ensure that a unique
@@ -187,8 +205,18 @@ protected:
      */
      virtual void SetUpBoxCollection(double cutOffLength, c_vector<double, 2*SPACE_DIM> domainSize, int numLocalRows = PETSC_DECIDE, bool isPeriodic = false);
 
-     /** @return mpBoxCollection */
-     DistributedBoxCollection<SPACE_DIM>* GetBoxCollection();
+    /**
+     * Set up a box collection split between processes on a Cartesian process grid.
+     *
+     * @param cutOffLength the cut off length for node neighbours.
+     * @param domainSize the size of the domain containing the nodes.
+     * @param numProcessesEachDirection the number of processes in each direction; zero entries are chosen by the box collection.
+     * @param processBoxBoundaries the box co-ordinates at which each direction is split between processes (defaults to an even split).
+     */
+     void SetUpCartesianBoxCollection(double cutOffLength,
+                                      c_vector<double, 2*SPACE_DIM> domainSize,
+                                      c_vector<unsigned, SPACE_DIM> numProcessesEachDirection,
+                                      std::vector<std::vector<unsigned> > processBoxBoundaries = std::vector<std::vector<unsigned> >());
 
 public:
 
@@ -198,6 +226,9 @@ public:
     /**  Over-written destructor to delete pointer to BoxCollection. */
     virtual ~NodesOnlyMesh();
 
+    /** @return mpBoxCollection */
+    DistributedBoxCollection<SPACE_DIM>* GetBoxCollection();
+
     /**
      * Construct the mesh using only nodes. No mesh is created, but the nodes are stored.
      * The original vector of nodes is deep-copied: new node objects are made with are
@@ -345,30 +376,74 @@ public:
     void AddHaloNodesToBoxes();
 
     /**
-     * Work out which nodes lie outside the local domain and add their indices to the vectors #mNodesToSendLeft and #mNodesToSendRight.
+     * Work out which nodes lie outside the local domain and add their indices to #mNodesToSendPerProcess.
      */
     void CalculateNodesOutsideLocalDomain();
 
     /**
-     * @return #mNodesToSendLeft.
+     * @return the indices of nodes that need to be moved to a neighbouring process.
+     *
+     * @param processIndex the rank of the neighbouring process.
+     */
+    std::vector<unsigned>& rGetNodesToSend(unsigned processIndex);
+
+    /**
+     * @return the indices of halo nodes, owned by this process, that are needed by a neighbouring process.
+     *
+     * @param processIndex the rank of the neighbouring process.
+     */
+    std::vector<unsigned>& rGetHaloNodesToSend(unsigned processIndex);
+
+    /**
+     * Equivalent to rGetNodesToSend() for the process to the left, when the box collection is split into strips.
+     *
+     * @return the indices of nodes that need to be moved to the left hand process.
      */
     std::vector<unsigned>& rGetNodesToSendLeft();
 
     /**
-     * @return #mNodesToSendRight.
+     * Equivalent to rGetNodesToSend() for the process to the right, when the box collection is split into strips.
+     *
+     * @return the indices of nodes that need to be moved to the right hand process.
      */
     std::vector<unsigned>& rGetNodesToSendRight();
 
     /**
+     * Equivalent to rGetHaloNodesToSend() for the process to the right, when the box collection is split into strips.
+     *
      * @return the indices of halo nodes, owned by this process, on the right hand boundary.
      */
     std::vector<unsigned>& rGetHaloNodesToSendRight();
 
     /**
+     * Equivalent to rGetHaloNodesToSend() for the process to the left, when the box collection is split into strips.
+     *
      * @return the indices of halo nodes, owned by this process, on the left hand boundary.
      */
     std::vector<unsigned>& rGetHaloNodesToSendLeft();
 
+    /**
+     * @return the ranks of the processes whose part of the box collection touches this process's part, in ascending order.
+     */
+    const std::vector<unsigned>& rGetNeighbourProcesses();
+
+    /**
+     * Set whether to split the box collection between processes on a Cartesian process grid,
+     * rather than in strips. Not supported for periodic meshes.
+     *
+     * @param useCartesianDecomposition whether to use a Cartesian decomposition.
+     */
+    void SetUseCartesianDecomposition(bool useCartesianDecomposition);
+
+    /**
+     * Set whether the box collection should store the nodes in each box in a flat cell list,
+     * which is cheaper to rebuild every time step than a std::set per box.
+     * See DistributedBoxCollection::SetUseFlatCellList().
+     *
+     * @param useFlatCellList whether to use a flat cell list.
+     */
+    void SetUseFlatCellList(bool useFlatCellList);
+
     /**
      * Add a temporary halo node on this process.
      * @param pNewNode a shared pointer to the new node to add.
@@ -417,7 +492,8 @@ public:
 
     /**
      * Re-allocate the underlaying BoxCollection rows based on the load-balance algorithm implemented
-     * in the box collection.
+     * in the box collection. With a Cartesian decomposition the boundaries between processes are
+     * moved in every direction.
      */
     void LoadBalanceMesh();
 
@@ -429,6 +505,25 @@ public:
     void ConstructFromMeshReader(AbstractMeshReader<SPACE_DIM, SPACE_DIM>& rMeshReader);
 };
 
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Specify a version number for archive backwards compatibility.
+ *
+ * This is how to do BOOST_CLASS_VERSION(NodesOnlyMesh, 2)
+ * with a templated class.
+ */
+template <unsigned SPACE_DIM>
+struct version<NodesOnlyMesh<SPACE_DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(2);
+};
+} // namespace serialization
+} // namespace boost
+
 #include "SerializationExportWrapper.hpp"
 EXPORT_TEMPLATE_CLASS_SAME_DIMS(NodesOnlyMesh)
 
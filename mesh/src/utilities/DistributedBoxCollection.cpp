@@ -35,17 +35,62 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "DistributedBoxCollection.hpp"
 #include "Exception.hpp"
 #include "MathsCustomFunctions.hpp"
+#include <algorithm>
 
 // Static member for "fudge factor" is instantiated here
 template<unsigned DIM>
 const double DistributedBoxCollection<DIM>::msFudge = 5e-14;
 
+/**
+ * Orders (box co-ordinates, box index) pairs along a Morton (Z-order) curve, without forming the
+ * interleaved key, by comparing the co-ordinate whose most significant differing bit is highest.
+ */
+template<unsigned DIM>
+struct MortonOrderLess
+{
+    /**
+     * @return whether a has a less significant highest set bit than b
+     *
+     * @param a the first value
+     * @param b the second value
+     */
+    static bool LessMostSignificantBit(unsigned a, unsigned b)
+    {
+        return (a < b) && (a < (a ^ b));
+    }
+
+    /**
+     * @return whether the first box comes before the second box on the Morton curve
+     *
+     * @param rFirst the co-ordinates and index of the first box
+     * @param rSecond the co-ordinates and index of the second box
+     */
+    bool operator()(const std::pair<c_vector<unsigned, DIM>, unsigned>& rFirst,
+                    const std::pair<c_vector<unsigned, DIM>, unsigned>& rSecond) const
+    {
+        unsigned most_significant_dim = DIM-1;
+        unsigned most_significant_difference = 0;
+        for (unsigned d=DIM; d-- > 0; )
+        {
+            unsigned difference = rFirst.first(d) ^ rSecond.first(d);
+            if (LessMostSignificantBit(most_significant_difference, difference))
+            {
+                most_significant_dim = d;
+                most_significant_difference = difference;
+            }
+        }
+        return rFirst.first(most_significant_dim) < rSecond.first(most_significant_dim);
+    }
+};
+
 template<unsigned DIM>
 DistributedBoxCollection<DIM>::DistributedBoxCollection(double boxWidth, c_vector<double, 2*DIM> domainSize, bool isPeriodicInX, int localRows)
     : mBoxWidth(boxWidth),
       mIsPeriodicInX(isPeriodicInX),
       mAreLocalBoxesSet(false),
-      mCalculateNodeNeighbours(true)
+      mCalculateNodeNeighbours(true),
+      mUseFlatCellList(false),
+      mNumOwnedCells(0)
 {
     // Periodicity only works in 2d and in serial.
     if (isPeriodicInX)
@@ -53,13 +98,153 @@ DistributedBoxCollection<DIM>::DistributedBoxCollection(double boxWidth, c_vecto
         assert(DIM==2 && PetscTools::IsSequential());
     }
 
+    SetDomainSize(domainSize);
+
+    // Split rows / faces of boxes between processes, i.e. only have more than one process in the last direction.
+    mNumProcessesEachDirection = scalar_vector<unsigned>(DIM, 1u);
+    mNumProcessesEachDirection(DIM-1) = PetscTools::GetNumProcs();
+
+    EnsureEnoughBoxesForProcesses();
+
+    // Make a distributed vector factory to split the rows of boxes between processes.
+    mpDistributedBoxStackFactory = new DistributedVectorFactory(mNumBoxesEachDirection(DIM-1), localRows);
+
+    mProcessBoxBoundaries.resize(DIM);
+    for (unsigned d=0; d<DIM-1; d++)
+    {
+        mProcessBoxBoundaries[d].push_back(0u);
+        mProcessBoxBoundaries[d].push_back(mNumBoxesEachDirection(d));
+    }
+    mProcessBoxBoundaries[DIM-1] = mpDistributedBoxStackFactory->rGetGlobalLows();
+    mProcessBoxBoundaries[DIM-1].push_back(mNumBoxesEachDirection(DIM-1));
+
+    SetupLocalRegion();
+}
+
+template<unsigned DIM>
+DistributedBoxCollection<DIM>::DistributedBoxCollection(double boxWidth, c_vector<double, 2*DIM> domainSize, c_vector<unsigned, DIM> numProcessesEachDirection,
+                                                        std::vector<std::vector<unsigned> > processBoxBoundaries)
+    : mBoxWidth(boxWidth),
+      mIsPeriodicInX(false),
+      mAreLocalBoxesSet(false),
+      mCalculateNodeNeighbours(true),
+      mUseFlatCellList(false),
+      mNumOwnedCells(0)
+{
+    SetDomainSize(domainSize);
+
+    // Work out which directions of the process grid have been left for us to choose.
+    unsigned num_procs = PetscTools::GetNumProcs();
+    unsigned num_fixed_procs = 1;
+    std::vector<unsigned> free_directions;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if (numProcessesEachDirection(d) == 0)
+        {
+            numProcessesEachDirection(d) = 1;
+            free_directions.push_back(d);
+        }
+        else
+        {
+            num_fixed_procs *= numProcessesEachDirection(d);
+        }
+    }
+
+    if ((num_procs % num_fixed_procs != 0) || (free_directions.empty() && num_fixed_procs != num_procs))
+    {
+        EXCEPTION("The process grid does not match the number of processes");
+    }
+
+    // Give each prime factor of the remaining number of processes (largest first) to the free direction with the most boxes per process.
+    std::vector<unsigned> prime_factors;
+    unsigned remaining_procs = num_procs/num_fixed_procs;
+    for (unsigned factor=2; remaining_procs > 1; factor++)
+    {
+        while (remaining_procs % factor == 0)
+        {
+            prime_factors.push_back(factor);
+            remaining_procs /= factor;
+        }
+    }
+    for (std::vector<unsigned>::reverse_iterator factor_iter = prime_factors.rbegin();
+         factor_iter != prime_factors.rend();
+         ++factor_iter)
+    {
+        // Ties go to the last direction, so that e.g. a cube on two processes is split into strips.
+        unsigned best_direction = free_directions.back();
+        for (std::vector<unsigned>::reverse_iterator direction_iter = free_directions.rbegin();
+             direction_iter != free_directions.rend();
+             ++direction_iter)
+        {
+            if (mNumBoxesEachDirection(*direction_iter)*numProcessesEachDirection(best_direction)
+                    > mNumBoxesEachDirection(best_direction)*numProcessesEachDirection(*direction_iter))
+            {
+                best_direction = *direction_iter;
+            }
+        }
+        numProcessesEachDirection(best_direction) *= *factor_iter;
+    }
+
+    mNumProcessesEachDirection = numProcessesEachDirection;
+
+    EnsureEnoughBoxesForProcesses();
+
+    if (processBoxBoundaries.empty())
+    {
+        // Split the boxes in each direction as evenly as possible (in the same way as PETSC_DECIDE).
+        processBoxBoundaries.resize(DIM);
+        for (unsigned d=0; d<DIM; d++)
+        {
+            unsigned num_slabs = mNumProcessesEachDirection(d);
+            unsigned num_boxes = mNumBoxesEachDirection(d);
+            for (unsigned i=0; i<=num_slabs; i++)
+            {
+                processBoxBoundaries[d].push_back(i*(num_boxes/num_slabs) + std::min(i, num_boxes%num_slabs));
+            }
+        }
+    }
+
+    bool are_boundaries_valid = (processBoxBoundaries.size() == DIM);
+    for (unsigned d=0; are_boundaries_valid && d<DIM; d++)
+    {
+        std::vector<unsigned>& r_boundaries = processBoxBoundaries[d];
+        are_boundaries_valid = (r_boundaries.size() == mNumProcessesEachDirection(d) + 1)
+                                && (r_boundaries[0] == 0)
+                                && (r_boundaries.back() == mNumBoxesEachDirection(d));
+        for (unsigned i=1; are_boundaries_valid && i<r_boundaries.size(); i++)
+        {
+            are_boundaries_valid = (r_boundaries[i-1] < r_boundaries[i]);
+        }
+    }
+    if (!are_boundaries_valid)
+    {
+        EXCEPTION("The process box boundaries do not match the process grid and the number of boxes");
+    }
+
+    mProcessBoxBoundaries = processBoxBoundaries;
+
+    SetupLocalRegion();
+
+    // Describe the rows / faces of boxes this process spans in the last direction.
+    mpDistributedBoxStackFactory = new DistributedVectorFactory(mMinBoxCoordinates(DIM-1), mMaxBoxCoordinates(DIM-1) + 1, mNumBoxesEachDirection(DIM-1));
+}
+
+template<unsigned DIM>
+DistributedBoxCollection<DIM>::~DistributedBoxCollection()
+{
+    delete mpDistributedBoxStackFactory;
+}
+
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::SetDomainSize(c_vector<double, 2*DIM> domainSize)
+{
     // If the domain size is not 'divisible' (i.e. fmod(width, box_size) > 0.0) we swell the domain to enforce this.
     for (unsigned i=0; i<DIM; i++)
     {
-        double r = fmod((domainSize[2*i+1]-domainSize[2*i]), boxWidth);
+        double r = fmod((domainSize[2*i+1]-domainSize[2*i]), mBoxWidth);
         if (r > 0.0)
         {
-            domainSize[2*i+1] += boxWidth - r;
+            domainSize[2*i+1] += mBoxWidth - r;
         }
     }
 
@@ -77,16 +262,35 @@ DistributedBoxCollection<DIM>::DistributedBoxCollection(double boxWidth, c_vecto
             counter += mBoxWidth;
         }
     }
+}
 
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::EnsureEnoughBoxesForProcesses()
+{
     // Make sure there are enough boxes for the number of processes.
-    if (mNumBoxesEachDirection(DIM-1) < PetscTools::GetNumProcs())
+    for (unsigned d=0; d<DIM; d++)
     {
-        mDomainSize[2*DIM - 1] += (PetscTools::GetNumProcs() - mNumBoxesEachDirection(DIM-1))*mBoxWidth;
-        mNumBoxesEachDirection(DIM-1) = PetscTools::GetNumProcs();
+        if (mNumBoxesEachDirection(d) < mNumProcessesEachDirection(d))
+        {
+            mDomainSize[2*d + 1] += (mNumProcessesEachDirection(d) - mNumBoxesEachDirection(d))*mBoxWidth;
+            mNumBoxesEachDirection(d) = mNumProcessesEachDirection(d);
+        }
     }
+}
 
-    // Make a distributed vectory factory to split the rows of boxes between processes.
-    mpDistributedBoxStackFactory = new DistributedVectorFactory(mNumBoxesEachDirection(DIM-1), localRows);
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::SetupLocalRegion()
+{
+    // Work out where this process lies in the process grid. Processes are numbered with x varying fastest, like boxes.
+    unsigned rank = PetscTools::GetMyRank();
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mProcessCoordinates(d) = rank % mNumProcessesEachDirection(d);
+        rank /= mNumProcessesEachDirection(d);
+
+        mMinBoxCoordinates(d) = mProcessBoxBoundaries[d][mProcessCoordinates(d)];
+        mMaxBoxCoordinates(d) = mProcessBoxBoundaries[d][mProcessCoordinates(d) + 1] - 1;
+    }
 
     // Calculate how many boxes in a row / face. A useful piece of data in the class.
     mNumBoxesInAFace = 1;
@@ -95,33 +299,231 @@ DistributedBoxCollection<DIM>::DistributedBoxCollection(double boxWidth, c_vecto
         mNumBoxesInAFace *= mNumBoxesEachDirection(i-1);
     }
 
-    unsigned num_boxes = mNumBoxesInAFace * (mpDistributedBoxStackFactory->GetHigh() - mpDistributedBoxStackFactory->GetLow());
+    mNumBoxes = mNumBoxesInAFace * mNumBoxesEachDirection(DIM-1);
+
+    mMinBoxIndex = CalculateGlobalIndex(mMinBoxCoordinates);
+    mMaxBoxIndex = CalculateGlobalIndex(mMaxBoxCoordinates);
 
-    mMinBoxIndex = mpDistributedBoxStackFactory->GetLow() * mNumBoxesInAFace;
-    mMaxBoxIndex = mpDistributedBoxStackFactory->GetHigh() * mNumBoxesInAFace - 1;
+    unsigned num_boxes = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        num_boxes *= mMaxBoxCoordinates(d) - mMinBoxCoordinates(d) + 1;
+    }
 
     /*
      * The location of the Boxes doesn't matter as it isn't actually used so we don't bother to work it out.
      * The reason it isn't used is because this class works out which box a node lies in without refernece to actual
      * box locations, only their global index within the collection.
+     *
+     * The boxes are stored with x varying fastest, so that they are in order of global index.
      */
     c_vector<double, 2*DIM> arbitrary_location;
+    c_vector<unsigned, DIM> box_coords = mMinBoxCoordinates;
     for (unsigned i=0; i<num_boxes; i++)
     {
         Box<DIM> new_box(arbitrary_location);
         mBoxes.push_back(new_box);
 
-        unsigned global_index = mMinBoxIndex + i;
+        unsigned global_index = CalculateGlobalIndex(box_coords);
         mBoxesMapping[global_index] = mBoxes.size() - 1;
+
+        // Move on to the next box
+        for (unsigned d=0; d<DIM; d++)
+        {
+            if (box_coords(d) < mMaxBoxCoordinates(d))
+            {
+                box_coords(d)++;
+                break;
+            }
+            box_coords(d) = mMinBoxCoordinates(d);
+        }
     }
 
-    mNumBoxes = mNumBoxesInAFace * mNumBoxesEachDirection(DIM-1);
+    // The neighbouring processes are those whose process grid co-ordinates differ from ours by at most one in each direction.
+    mNeighbourProcesses.clear();
+    for (unsigned i=0; i<SmallPow(3u, DIM); i++)
+    {
+        c_vector<unsigned, DIM> process_coords;
+        bool is_in_grid = true;
+        bool is_this_process = true;
+
+        unsigned remainder = i;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            int offset = (int)(remainder % 3) - 1;
+            remainder /= 3;
+
+            int coord = (int)mProcessCoordinates(d) + offset;
+            if (coord < 0 || coord >= (int)mNumProcessesEachDirection(d))
+            {
+                is_in_grid = false;
+                break;
+            }
+            process_coords(d) = (unsigned)coord;
+            is_this_process = is_this_process && (offset == 0);
+        }
+
+        if (is_in_grid && !is_this_process)
+        {
+            mNeighbourProcesses.push_back(CalculateProcessRank(process_coords));
+        }
+    }
+    std::sort(mNeighbourProcesses.begin(), mNeighbourProcesses.end());
 }
 
 template<unsigned DIM>
-DistributedBoxCollection<DIM>::~DistributedBoxCollection()
+unsigned DistributedBoxCollection<DIM>::CalculateProcessRank(c_vector<unsigned, DIM> processCoordinates) const
 {
-    delete mpDistributedBoxStackFactory;
+    unsigned rank = 0;
+    unsigned stride = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        rank += stride*processCoordinates(d);
+        stride *= mNumProcessesEachDirection(d);
+    }
+
+    return rank;
+}
+
+template<unsigned DIM>
+unsigned DistributedBoxCollection<DIM>::CalculateLocalIndex(unsigned globalIndex)
+{
+    // Strips of boxes are contiguous in global index
+    if (IsStripDecomposition())
+    {
+        return globalIndex - mMinBoxIndex;
+    }
+
+    c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(globalIndex);
+
+    unsigned local_index = 0;
+    unsigned stride = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        local_index += stride*(box_coords(d) - mMinBoxCoordinates(d));
+        stride *= mMaxBoxCoordinates(d) - mMinBoxCoordinates(d) + 1;
+    }
+
+    return local_index;
+}
+
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::AddBoxesAtOffsets(unsigned globalIndex, const std::vector<c_vector<int, DIM> >& rOffsets, bool onlyNonOwned, std::set<unsigned>& rBoxes)
+{
+    c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(globalIndex);
+
+    for (unsigned i=0; i<rOffsets.size(); i++)
+    {
+        c_vector<unsigned, DIM> neighbour_coords;
+        bool is_in_domain = true;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            int num_boxes = (int)mNumBoxesEachDirection(d);
+            int coord = (int)box_coords(d) + rOffsets[i](d);
+
+            // If the domain is periodic in x, boxes off either side wrap around
+            if (d == 0 && mIsPeriodicInX)
+            {
+                coord = (coord + num_boxes) % num_boxes;
+            }
+
+            if (coord < 0 || coord >= num_boxes)
+            {
+                is_in_domain = false;
+                break;
+            }
+            neighbour_coords(d) = (unsigned)coord;
+        }
+
+        if (is_in_domain)
+        {
+            unsigned neighbour_index = CalculateGlobalIndex(neighbour_coords);
+            if (!onlyNonOwned || !GetBoxOwnership(neighbour_index))
+            {
+                rBoxes.insert(neighbour_index);
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+std::vector<c_vector<int, DIM> > DistributedBoxCollection<DIM>::GetNeighbourOffsets(bool includeAll)
+{
+    std::vector<c_vector<int, DIM> > offsets;
+
+    if (includeAll)
+    {
+        // All 3^DIM - 1 nearest neighbours
+        for (unsigned i=0; i<SmallPow(3u, DIM); i++)
+        {
+            c_vector<int, DIM> offset;
+            bool is_zero = true;
+            unsigned remainder = i;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                offset(d) = (int)(remainder % 3) - 1;
+                remainder /= 3;
+                is_zero = is_zero && (offset(d) == 0);
+            }
+            if (!is_zero)
+            {
+                offsets.push_back(offset);
+            }
+        }
+    }
+    else
+    {
+        /*
+         * Half of the nearest neighbours, so that each pair of neighbouring boxes is only looked at once:
+         * the box to the right in 1d; the box to the right and the three above in 2d; and in 3d the 2d half
+         * in each of the three neighbouring layers, plus the box directly behind.
+         */
+        const int half_offsets_2d[4][2] = {{1,0}, {-1,1}, {0,1}, {1,1}};
+
+        switch (DIM)
+        {
+            case 1:
+            {
+                c_vector<int, DIM> offset;
+                offset(0) = 1;
+                offsets.push_back(offset);
+                break;
+            }
+            case 2:
+            {
+                for (unsigned i=0; i<4; i++)
+                {
+                    c_vector<int, DIM> offset;
+                    offset(0) = half_offsets_2d[i][0];
+                    offset(1) = half_offsets_2d[i][1];
+                    offsets.push_back(offset);
+                }
+                break;
+            }
+            case 3:
+            {
+                for (int layer=-1; layer<=1; layer++)
+                {
+                    for (unsigned i=0; i<4; i++)
+                    {
+                        c_vector<int, DIM> offset;
+                        offset(0) = half_offsets_2d[i][0];
+                        offset(1) = half_offsets_2d[i][1];
+                        offset(2) = layer;
+                        offsets.push_back(offset);
+                    }
+                }
+                c_vector<int, DIM> offset = scalar_vector<int>(DIM, 0);
+                offset(2) = 1;
+                offsets.push_back(offset);
+                break;
+            }
+            default:
+                NEVER_REACHED;
+        }
+    }
+
+    return offsets;
 }
 
 template<unsigned DIM>
@@ -135,43 +537,62 @@ void DistributedBoxCollection<DIM>::EmptyBoxes()
     {
         mHaloBoxes[i].ClearNodes();
     }
+    if (mUseFlatCellList)
+    {
+        mCellNodeStarts.assign(mCellBoxIndices.size() + 1, 0u);
+        mCellNodes.clear();
+        mCachedNodes.clear();
+        mCachedNodeCells.clear();
+    }
 }
 
 template<unsigned DIM>
 void DistributedBoxCollection<DIM>::SetupHaloBoxes()
 {
-    // Get top-most and bottom-most value of Distributed Box Stack.
-    unsigned Hi = mpDistributedBoxStackFactory->GetHigh();
-    unsigned Lo = mpDistributedBoxStackFactory->GetLow();
+    std::vector<c_vector<int, DIM> > neighbour_offsets = GetNeighbourOffsets(true);
 
-    // If I am not the top-most process, add halo structures to the right.
-    if (!PetscTools::AmTopMost())
+    // Any box touching a box owned by this process, but owned by another process, is a halo box.
+    for (std::map<unsigned, unsigned>::iterator box_iter = mBoxesMapping.begin();
+         box_iter != mBoxesMapping.end();
+         ++box_iter)
     {
-        for (unsigned i=0; i < mNumBoxesInAFace; i++)
+        unsigned global_index = box_iter->first;
+
+        std::set<unsigned> halo_boxes;
+        AddBoxesAtOffsets(global_index, neighbour_offsets, true, halo_boxes);
+
+        for (std::set<unsigned>::iterator halo_iter = halo_boxes.begin();
+             halo_iter != halo_boxes.end();
+             ++halo_iter)
         {
-            c_vector<double, 2*DIM> arbitrary_location; // See comment in constructor.
-            Box<DIM> new_box(arbitrary_location);
-            mHaloBoxes.push_back(new_box);
+            if (mHaloBoxesMapping.find(*halo_iter) == mHaloBoxesMapping.end())
+            {
+                c_vector<double, 2*DIM> arbitrary_location; // See comment in SetupLocalRegion().
+                Box<DIM> new_box(arbitrary_location);
+                mHaloBoxes.push_back(new_box);
+
+                mHaloBoxesMapping[*halo_iter] = mHaloBoxes.size() - 1;
+            }
 
-            unsigned global_index = Hi * mNumBoxesInAFace + i;
-            mHaloBoxesMapping[global_index] = mHaloBoxes.size()-1;
-            mHalosRight.push_back(global_index - mNumBoxesInAFace);
+            // The local box is, in turn, a halo of the process owning this box.
+            std::vector<unsigned>& r_boxes_to_send = mHaloBoxesToSend[CalculateProcessOwningBox(*halo_iter)];
+            if (r_boxes_to_send.empty() || r_boxes_to_send.back() != global_index)
+            {
+                r_boxes_to_send.push_back(global_index);
+            }
         }
     }
 
-    // If I am not the bottom-most process, add halo structures to the left.
-    if (!PetscTools::AmMaster())
+    // With strips, the only neighbours are the processes either side.
+    if (IsStripDecomposition())
     {
-        for (unsigned i=0; i< mNumBoxesInAFace; i++)
+        if (!PetscTools::AmTopMost())
         {
-            c_vector<double, 2*DIM> arbitrary_location; // See comment in constructor.
-            Box<DIM> new_box(arbitrary_location);
-            mHaloBoxes.push_back(new_box);
-
-            unsigned global_index = (Lo - 1) * mNumBoxesInAFace + i;
-            mHaloBoxesMapping[global_index] = mHaloBoxes.size() - 1;
-
-            mHalosLeft.push_back(global_index  + mNumBoxesInAFace);
+            mHalosRight = mHaloBoxesToSend[PetscTools::GetMyRank() + 1];
+        }
+        if (!PetscTools::AmMaster())
+        {
+            mHalosLeft = mHaloBoxesToSend[PetscTools::GetMyRank() - 1];
         }
     }
 }
@@ -179,26 +600,33 @@ void DistributedBoxCollection<DIM>::SetupHaloBoxes()
 template<unsigned DIM>
 void DistributedBoxCollection<DIM>::UpdateHaloBoxes()
 {
-    mHaloNodesLeft.clear();
-    for (unsigned i=0; i<mHalosLeft.size(); i++)
+    mHaloNodesToSend.clear();
+    for (std::map<unsigned, std::vector<unsigned> >::iterator process_iter = mHaloBoxesToSend.begin();
+         process_iter != mHaloBoxesToSend.end();
+         ++process_iter)
     {
-        for (typename std::set<Node<DIM>* >::iterator iter=this->rGetBox(mHalosLeft[i]).rGetNodesContained().begin();
-                iter!=this->rGetBox(mHalosLeft[i]).rGetNodesContained().end();
-                iter++)
-        {
-            mHaloNodesLeft.push_back((*iter)->GetIndex());
-        }
-    }
+        std::vector<unsigned>& r_halo_nodes = mHaloNodesToSend[process_iter->first];
+        std::vector<unsigned>& r_halo_boxes = process_iter->second;
 
-    // Send right
-    mHaloNodesRight.clear();
-    for (unsigned i=0; i<mHalosRight.size(); i++)
-    {
-        for (typename std::set<Node<DIM>* >::iterator iter=this->rGetBox(mHalosRight[i]).rGetNodesContained().begin();
-                iter!=this->rGetBox(mHalosRight[i]).rGetNodesContained().end();
-                iter++)
+        for (unsigned i=0; i<r_halo_boxes.size(); i++)
         {
-            mHaloNodesRight.push_back((*iter)->GetIndex());
+            if (mUseFlatCellList)
+            {
+                unsigned cell = CalculateCellFromCoordinates(CalculateCoordinateIndices(r_halo_boxes[i]));
+                for (unsigned j=mCellNodeStarts[cell]; j<mCellNodeStarts[cell+1]; j++)
+                {
+                    r_halo_nodes.push_back(mCellNodes[j]->GetIndex());
+                }
+            }
+            else
+            {
+                for (typename std::set<Node<DIM>* >::iterator iter=this->rGetBox(r_halo_boxes[i]).rGetNodesContained().begin();
+                        iter!=this->rGetBox(r_halo_boxes[i]).rGetNodesContained().end();
+                        iter++)
+                {
+                    r_halo_nodes.push_back((*iter)->GetIndex());
+                }
+            }
         }
     }
 }
@@ -206,30 +634,75 @@ void DistributedBoxCollection<DIM>::UpdateHaloBoxes()
 template<unsigned DIM>
 unsigned DistributedBoxCollection<DIM>::GetNumLocalRows() const
 {
-    return mpDistributedBoxStackFactory->GetHigh() - mpDistributedBoxStackFactory->GetLow();
+    return mMaxBoxCoordinates(DIM-1) - mMinBoxCoordinates(DIM-1) + 1;
 }
 
 template<unsigned DIM>
 bool DistributedBoxCollection<DIM>::GetBoxOwnership(unsigned globalIndex)
 {
-    return (!(globalIndex<mMinBoxIndex) && !(mMaxBoxIndex<globalIndex));
+    bool is_owned = (!(globalIndex<mMinBoxIndex) && !(mMaxBoxIndex<globalIndex));
+
+    // In a Cartesian decomposition the local boxes are not contiguous in global index, so check each co-ordinate.
+    if (is_owned && !IsStripDecomposition())
+    {
+        c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(globalIndex);
+        for (unsigned d=0; d<DIM; d++)
+        {
+            if ((box_coords(d) < mMinBoxCoordinates(d)) || (mMaxBoxCoordinates(d) < box_coords(d)))
+            {
+                is_owned = false;
+                break;
+            }
+        }
+    }
+
+    return is_owned;
 }
 
 template<unsigned DIM>
 bool DistributedBoxCollection<DIM>::GetHaloBoxOwnership(unsigned globalIndex)
 {
-    bool is_halo_right = ((globalIndex > mMaxBoxIndex) && !(globalIndex > mMaxBoxIndex + mNumBoxesInAFace));
-    bool is_halo_left = ((globalIndex < mMinBoxIndex) && !(globalIndex < mMinBoxIndex - mNumBoxesInAFace));
+    if (PetscTools::IsSequential() || GetBoxOwnership(globalIndex))
+    {
+        return false;
+    }
+
+    // Halo boxes lie within one box of the region owned by this process.
+    c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(globalIndex);
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if ((box_coords(d) + 1 < mMinBoxCoordinates(d)) || (mMaxBoxCoordinates(d) + 1 < box_coords(d)))
+        {
+            return false;
+        }
+    }
 
-    return (PetscTools::IsParallel() && (is_halo_right || is_halo_left));
+    return true;
 }
 
 template<unsigned DIM>
 bool DistributedBoxCollection<DIM>::IsInteriorBox(unsigned globalIndex)
 {
-    bool is_on_boundary = !(globalIndex < mMaxBoxIndex - mNumBoxesInAFace) || (globalIndex < mMinBoxIndex + mNumBoxesInAFace);
+    if (PetscTools::IsSequential())
+    {
+        return true;
+    }
+    if (!GetBoxOwnership(globalIndex))
+    {
+        return false;
+    }
 
-    return (PetscTools::IsSequential() || !(is_on_boundary));
+    // A box is on the boundary if it lies on a face of the local region in a direction that is split between processes.
+    c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(globalIndex);
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if ((mNumProcessesEachDirection(d) > 1) && (box_coords(d) == mMinBoxCoordinates(d) || box_coords(d) == mMaxBoxCoordinates(d)))
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 template<unsigned DIM>
@@ -260,6 +733,17 @@ unsigned DistributedBoxCollection<DIM>::CalculateContainingBox(Node<DIM>* pNode)
 
 template<unsigned DIM>
 unsigned DistributedBoxCollection<DIM>::CalculateContainingBox(c_vector<double, DIM>& rLocation)
+{
+    unsigned containing_box_index = CalculateGlobalIndex(CalculateContainingBoxCoordinates(rLocation));
+
+    // This index must be less than the total number of boxes
+    assert(containing_box_index < mNumBoxes);
+
+    return containing_box_index;
+}
+
+template<unsigned DIM>
+c_vector<unsigned, DIM> DistributedBoxCollection<DIM>::CalculateContainingBoxCoordinates(const c_vector<double, DIM>& rLocation)
 {
     // The node must lie inside the boundary of the box collection
     for (unsigned i=0; i<DIM; i++)
@@ -282,22 +766,7 @@ unsigned DistributedBoxCollection<DIM>::CalculateContainingBox(c_vector<double,
         }
     }
 
-    // Use these to compute the index of the containing box
-    unsigned containing_box_index = 0;
-    for (unsigned i=0; i<DIM; i++)
-    {
-        unsigned temp = 1;
-        for (unsigned j=0; j<i; j++)
-        {
-            temp *= mNumBoxesEachDirection(j);
-        }
-        containing_box_index += temp*containing_box_indices[i];
-    }
-
-    // This index must be less than the total number of boxes
-    assert(containing_box_index < mNumBoxes);
-
-    return containing_box_index;
+    return containing_box_indices;
 }
 
 template<unsigned DIM>
@@ -341,8 +810,8 @@ c_vector<unsigned, DIM> DistributedBoxCollection<DIM>::CalculateCoordinateIndice
 template<unsigned DIM>
 Box<DIM>& DistributedBoxCollection<DIM>::rGetBox(unsigned boxIndex)
 {
-    assert(!(boxIndex<mMinBoxIndex) && !(mMaxBoxIndex<boxIndex));
-    return mBoxes[boxIndex-mMinBoxIndex];
+    assert(GetBoxOwnership(boxIndex));
+    return mBoxes[CalculateLocalIndex(boxIndex)];
 }
 
 template<unsigned DIM>
@@ -388,12 +857,17 @@ double DistributedBoxCollection<DIM>::GetBoxWidth() const
 template<unsigned DIM>
 unsigned DistributedBoxCollection<DIM>::GetNumRowsOfBoxes() const
 {
-    return mpDistributedBoxStackFactory->GetHigh() - mpDistributedBoxStackFactory->GetLow();
+    return mMaxBoxCoordinates(DIM-1) - mMinBoxCoordinates(DIM-1) + 1;
 }
 
 template<unsigned DIM>
 int DistributedBoxCollection<DIM>::LoadBalance(std::vector<int> localDistribution)
 {
+    if (!IsStripDecomposition())
+    {
+        EXCEPTION("LoadBalance() only applies to a strip decomposition; use CalculateBalancedProcessBoundaries() instead");
+    }
+
     MPI_Status status;
 
     int proc_right = (PetscTools::AmTopMost()) ? MPI_PROC_NULL : (int)PetscTools::GetMyRank() + 1;
@@ -488,577 +962,53 @@ void DistributedBoxCollection<DIM>::SetupLocalBoxesHalfOnly()
     }
     else
     {
-        switch (DIM)
-        {
-            case 1:
-            {
-                // We only need to look for neighbours in the current and successive boxes plus some others for halos
-                mLocalBoxes.clear();
-
-                // Iterate over the global box indices
-                for (unsigned global_index = mMinBoxIndex; global_index<mMaxBoxIndex+1; global_index++)
-                {
-                    std::set<unsigned> local_boxes;
-
-                    // Insert the current box
-                    local_boxes.insert(global_index);
-
-                    // Set some bools to find out where we are
-                    bool right = (global_index==mNumBoxesEachDirection(0)-1);
-                    bool left = (global_index == 0);
-                    bool proc_left = (global_index == mpDistributedBoxStackFactory->GetLow());
-
-                    // If we're not at the right-most box, then insert the box to the right
-                    if (!right)
-                    {
-                        local_boxes.insert(global_index+1);
-                    }
-                    // If we're on a left process boundary and not on process 0, insert the (halo) box to the left
-                    if (proc_left && !left)
-                    {
-                        local_boxes.insert(global_index-1);
-                    }
-
-                    mLocalBoxes.push_back(local_boxes);
-                }
-                break;
-            }
-            case 2:
-            {
-                // We only need to look for neighbours in the current box and half the neighbouring boxes plus some others for halos
-                mLocalBoxes.clear();
-
-                for (unsigned global_index = mMinBoxIndex; global_index<mMaxBoxIndex+1; global_index++)
-                {
-                    std::set<unsigned> local_boxes;
-
-                    // Set up bools to find out where we are
-                    bool left = (global_index%mNumBoxesEachDirection(0) == 0);
-                    bool right = (global_index%mNumBoxesEachDirection(0) == mNumBoxesEachDirection(0)-1);
-                    bool top = !(global_index < mNumBoxesEachDirection(0)*mNumBoxesEachDirection(1) - mNumBoxesEachDirection(0));
-                    bool bottom = (global_index < mNumBoxesEachDirection(0));
-                    bool bottom_proc = (CalculateCoordinateIndices(global_index)[1] == mpDistributedBoxStackFactory->GetLow());
-
-                    // Insert the current box
-                    local_boxes.insert(global_index);
-
-                    // If we're on the bottom of the process boundary, but not the bottom of the domain add boxes below
-                    if(!bottom && bottom_proc)
-                    {
-                        local_boxes.insert(global_index - mNumBoxesEachDirection(0));
-                        if(!left)
-                        {
-                            local_boxes.insert(global_index - mNumBoxesEachDirection(0) - 1);
-                        }
-                        if(!right)
-                        {
-                            local_boxes.insert(global_index - mNumBoxesEachDirection(0) + 1);
-                        }
-                    }
-
-                    // If we're not at the top of the domain insert boxes above
-                    if(!top)
-                    {
-                        local_boxes.insert(global_index + mNumBoxesEachDirection(0));
-
-                        if(!right)
-                        {
-                            local_boxes.insert(global_index + mNumBoxesEachDirection(0) + 1);
-                        }
-                        if(!left)
-                        {
-                            local_boxes.insert(global_index + mNumBoxesEachDirection(0) - 1);
-                        }
-                        else if ( (global_index % mNumBoxesEachDirection(0) == 0) && (mIsPeriodicInX) ) // If we're on the left edge but its periodic include the box on the far right and up one.
-                        {
-                            local_boxes.insert(global_index +  2 * mNumBoxesEachDirection(0) - 1);
-                        }
-                    }
-
-                    // If we're not on the far right hand side inseryt box to the right
-                    if(!right)
-                    {
-                        local_boxes.insert(global_index + 1);
-                    }
-                    // If we're on the right edge but it's periodic include the box on the far left of the domain
-                    else if ( (global_index % mNumBoxesEachDirection(0) == mNumBoxesEachDirection(0)-1) && (mIsPeriodicInX) )
-                    {
-                        local_boxes.insert(global_index - mNumBoxesEachDirection(0) + 1);
-                        // If we're also not on the top-most row, then insert the box above- on the far left of the domain
-                        if (global_index < mBoxes.size() - mNumBoxesEachDirection(0))
-                        {
-                            local_boxes.insert(global_index + 1);
-                        }
-                    }
-
-                    mLocalBoxes.push_back(local_boxes);
-                }
-                break;
-            }
-            case 3:
-            {
-                // We only need to look for neighbours in the current box and half the neighbouring boxes plus some others for halos
-                mLocalBoxes.clear();
-                unsigned num_boxes_xy = mNumBoxesEachDirection(0)*mNumBoxesEachDirection(1);
-
-
-                for (unsigned global_index = mMinBoxIndex; global_index<mMaxBoxIndex+1; global_index++)
-                {
-                    std::set<unsigned> local_boxes;
-
-                    // Set some bools to find out where we are
-                    bool top = !(global_index % num_boxes_xy < num_boxes_xy - mNumBoxesEachDirection(0));
-                    bool bottom = (global_index % num_boxes_xy < mNumBoxesEachDirection(0));
-                    bool left = (global_index % mNumBoxesEachDirection(0) == 0);
-                    bool right = (global_index % mNumBoxesEachDirection(0) == mNumBoxesEachDirection(0) - 1);
-                    bool front = (global_index < num_boxes_xy);
-                    bool back = !(global_index < num_boxes_xy*mNumBoxesEachDirection(2) - num_boxes_xy);
-                    bool proc_front = (CalculateCoordinateIndices(global_index)[2] == mpDistributedBoxStackFactory->GetLow());
-                    bool proc_back = (CalculateCoordinateIndices(global_index)[2] == mpDistributedBoxStackFactory->GetHigh()-1);
-
-                    // Insert the current box
-                    local_boxes.insert(global_index);
-
-                    // If we're not on the front face, add appropriate boxes on the closer face
-                    if(!front)
-                    {
-                        // If we're not on the top of the domain
-                        if(!top)
-                        {
-                            local_boxes.insert( global_index - num_boxes_xy + mNumBoxesEachDirection(0) );
-                            if(!left)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy + mNumBoxesEachDirection(0) - 1);
-                            }
-                            if(!right)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy + mNumBoxesEachDirection(0) + 1);
-                            }
-                        }
-                        if(!right)
-                        {
-                            local_boxes.insert( global_index - num_boxes_xy + 1);
-                        }
-
-                        // If we are on the front of the process we have to add extra boxes as they are halos.
-                        if(proc_front)
-                        {
-                            local_boxes.insert( global_index - num_boxes_xy );
-
-                            if(!left)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy - 1);
-                            }
-                            if(!bottom)
-                            {
-                                local_boxes.insert( global_index - num_boxes_xy - mNumBoxesEachDirection(0));
-
-                                if(!left)
-                                {
-                                    local_boxes.insert( global_index - num_boxes_xy - mNumBoxesEachDirection(0) - 1);
-                                }
-                                if(!right)
-                                {
-                                    local_boxes.insert( global_index - num_boxes_xy - mNumBoxesEachDirection(0) + 1);
-                                }
-                            }
-
-                        }
-                    }
-                    if(!right)
-                    {
-                        local_boxes.insert( global_index + 1);
-                    }
-                    // If we're not on the very top add boxes above
-                    if(!top)
-                    {
-                        local_boxes.insert( global_index + mNumBoxesEachDirection(0));
-
-                        if(!right)
-                        {
-                            local_boxes.insert( global_index + mNumBoxesEachDirection(0) + 1);
-                        }
-                        if(!left)
-                        {
-                            local_boxes.insert( global_index + mNumBoxesEachDirection(0) - 1);
-                        }
-                    }
-
-                    // If we're not on the back add boxes behind
-                    if(!back)
-                    {
-                        local_boxes.insert(global_index + num_boxes_xy);
-
-                        if(!right)
-                        {
-                            local_boxes.insert(global_index + num_boxes_xy + 1);
-                        }
-                        if(!top)
-                        {
-                            local_boxes.insert(global_index + num_boxes_xy + mNumBoxesEachDirection(0));
-                            if(!right)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy + mNumBoxesEachDirection(0) + 1);
-                            }
-                            if(!left)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy + mNumBoxesEachDirection(0) - 1);
-                            }
-                        }
-                        // If we are on the back proc we should make sure we get everything in the face further back
-                        if(proc_back)
-                        {
-                            if(!left)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy - 1);
-                            }
-                            if(!bottom)
-                            {
-                                local_boxes.insert(global_index + num_boxes_xy - mNumBoxesEachDirection(0));
-
-                                if(!left)
-                                {
-                                    local_boxes.insert(global_index + num_boxes_xy - mNumBoxesEachDirection(0) - 1);
-                                }
-                                if(!right)
-                                {
-                                    local_boxes.insert(global_index + num_boxes_xy - mNumBoxesEachDirection(0) + 1);
-                                }
-                            }
-                        }
-                    }
-                    mLocalBoxes.push_back(local_boxes);
-                }
-
-                break;
-            }
-            default:
-                NEVER_REACHED;
-        }
-        mAreLocalBoxesSet=true;
-    }
-}
-
+        std::vector<c_vector<int, DIM> > half_offsets = GetNeighbourOffsets(false);
+        std::vector<c_vector<int, DIM> > all_offsets = GetNeighbourOffsets(true);
 
+        mLocalBoxes.clear();
 
-template<unsigned DIM>
-void DistributedBoxCollection<DIM>::SetupAllLocalBoxes()
-{
-    mAreLocalBoxesSet = true;
-    switch (DIM)
-    {
-        case 1:
+        // Iterate over the owned boxes in order of global index
+        for (std::map<unsigned, unsigned>::iterator box_iter = mBoxesMapping.begin();
+             box_iter != mBoxesMapping.end();
+             ++box_iter)
         {
-            for (unsigned i=mMinBoxIndex; i<mMaxBoxIndex+1; i++)
-            {
-                std::set<unsigned> local_boxes;
-
-                local_boxes.insert(i);
-
-                // add the two neighbours
-                if (i!=0)
-                {
-                    local_boxes.insert(i-1);
-                }
-                if (i+1 != mNumBoxesEachDirection(0))
-                {
-                    local_boxes.insert(i+1);
-                }
+            std::set<unsigned> local_boxes;
 
-                mLocalBoxes.push_back(local_boxes);
-            }
-            break;
-        }
-        case 2:
-        {
-            mLocalBoxes.clear();
+            // Insert the current box
+            local_boxes.insert(box_iter->first);
 
-            unsigned M = mNumBoxesEachDirection(0);
-            unsigned N = mNumBoxesEachDirection(1);
+            // We only need to look for neighbours in half of the neighbouring boxes...
+            AddBoxesAtOffsets(box_iter->first, half_offsets, false, local_boxes);
 
-            std::vector<bool> is_xmin(N*M); // far left
-            std::vector<bool> is_xmax(N*M); // far right
-            std::vector<bool> is_ymin(N*M); // bottom
-            std::vector<bool> is_ymax(N*M); // top
+            // ...plus all of the neighbouring halo boxes, as no other process adds these pairs for us
+            AddBoxesAtOffsets(box_iter->first, all_offsets, true, local_boxes);
 
-            for (unsigned i=0; i<M*N; i++)
-            {
-                is_xmin[i] = (i%M==0);
-                is_xmax[i] = ((i+1)%M==0);
-                is_ymin[i] = (i%(M*N)<M);
-                is_ymax[i] = (i%(M*N)>=(N-1)*M);
-            }
-
-            for (unsigned i=mMinBoxIndex; i<mMaxBoxIndex+1; i++)
-            {
-                std::set<unsigned> local_boxes;
-
-                local_boxes.insert(i);
-
-                // add the box to the left
-                if (!is_xmin[i])
-                {
-                    local_boxes.insert(i-1);
-                }
-                else // Add Periodic Box if needed
-                {
-                    if(mIsPeriodicInX)
-                    {
-                        local_boxes.insert(i+M-1);
-                    }
-                }
-
-                // add the box to the right
-                if (!is_xmax[i])
-                {
-                    local_boxes.insert(i+1);
-                }
-                else // Add Periodic Box if needed
-                {
-                    if(mIsPeriodicInX)
-                    {
-                        local_boxes.insert(i-M+1);
-                    }
-                }
-
-                // add the one below
-                if (!is_ymin[i])
-                {
-                    local_boxes.insert(i-M);
-                }
-
-                // add the one above
-                if (!is_ymax[i])
-                {
-                    local_boxes.insert(i+M);
-                }
-
-                // add the four corner boxes
-
-                if ( (!is_xmin[i]) && (!is_ymin[i]) )
-                {
-                    local_boxes.insert(i-1-M);
-                }
-                if ( (!is_xmin[i]) && (!is_ymax[i]) )
-                {
-                    local_boxes.insert(i-1+M);
-                }
-                if ( (!is_xmax[i]) && (!is_ymin[i]) )
-                {
-                    local_boxes.insert(i+1-M);
-                }
-                if ( (!is_xmax[i]) && (!is_ymax[i]) )
-                {
-                    local_boxes.insert(i+1+M);
-                }
-
-                // Add Periodic Corner Boxes if needed
-                if(mIsPeriodicInX)
-                {
-                    if( (is_xmin[i]) && (!is_ymin[i]) )
-                    {
-                        local_boxes.insert(i-1);
-                    }
-                    if ( (is_xmin[i]) && (!is_ymax[i]) )
-                    {
-                        local_boxes.insert(i-1+2*M);
-                    }
-                    if ( (is_xmax[i]) && (!is_ymin[i]) )
-                    {
-                        local_boxes.insert(i+1-2*M);
-                    }
-                    if ( (is_xmax[i]) && (!is_ymax[i]) )
-                    {
-                        local_boxes.insert(i+1);
-                    }
-                }
-
-                mLocalBoxes.push_back(local_boxes);
-            }
-            break;
+            mLocalBoxes.push_back(local_boxes);
         }
-        case 3:
-        {
-            mLocalBoxes.clear();
-
-            unsigned M = mNumBoxesEachDirection(0);
-            unsigned N = mNumBoxesEachDirection(1);
-            unsigned P = mNumBoxesEachDirection(2);
-
-            std::vector<bool> is_xmin(N*M*P); // far left
-            std::vector<bool> is_xmax(N*M*P); // far right
-            std::vector<bool> is_ymin(N*M*P); // nearest
-            std::vector<bool> is_ymax(N*M*P); // furthest
-            std::vector<bool> is_zmin(N*M*P); // bottom layer
-            std::vector<bool> is_zmax(N*M*P); // top layer
-
-            for (unsigned i=0; i<M*N*P; i++)
-            {
-                is_xmin[i] = (i%M==0);
-                is_xmax[i] = ((i+1)%M==0);
-                is_ymin[i] = (i%(M*N)<M);
-                is_ymax[i] = (i%(M*N)>=(N-1)*M);
-                is_zmin[i] = (i<M*N);
-                is_zmax[i] = (i>=M*N*(P-1));
-            }
 
-            for (unsigned i=mMinBoxIndex; i<mMaxBoxIndex+1; i++)
-            {
-                std::set<unsigned> local_boxes;
-
-                // add itself as a local box
-                local_boxes.insert(i);
-
-                // now add all 26 other neighbours.....
-
-                // add the box left
-                if (!is_xmin[i])
-                {
-                    local_boxes.insert(i-1);
-
-                    // plus some others towards the left
-                    if (!is_ymin[i])
-                    {
-                        local_boxes.insert(i-1-M);
-                    }
-
-                    if (!is_ymax[i])
-                    {
-                        local_boxes.insert(i-1+M);
-                    }
-
-                    if (!is_zmin[i])
-                    {
-                        local_boxes.insert(i-1-M*N);
-                    }
-
-                    if (!is_zmax[i])
-                    {
-                        local_boxes.insert(i-1+M*N);
-                    }
-                }
-
-                // add the box to the right
-                if (!is_xmax[i])
-                {
-                    local_boxes.insert(i+1);
-
-                    // plus some others towards the right
-                    if (!is_ymin[i])
-                    {
-                        local_boxes.insert(i+1-M);
-                    }
-
-                    if (!is_ymax[i])
-                    {
-                        local_boxes.insert(i+1+M);
-                    }
-
-                    if (!is_zmin[i])
-                    {
-                        local_boxes.insert(i+1-M*N);
-                    }
-
-                    if (!is_zmax[i])
-                    {
-                        local_boxes.insert(i+1+M*N);
-                    }
-                }
-
-                // add the boxes next along the y axis
-                if (!is_ymin[i])
-                {
-                    local_boxes.insert(i-M);
-
-                    // and more in this plane
-                    if (!is_zmin[i])
-                    {
-                        local_boxes.insert(i-M-M*N);
-                    }
-
-                    if (!is_zmax[i])
-                    {
-                        local_boxes.insert(i-M+M*N);
-                    }
-                }
-
-                // add the boxes next along the y axis
-                if (!is_ymax[i])
-                {
-                    local_boxes.insert(i+M);
-
-                    // and more in this plane
-                    if (!is_zmin[i])
-                    {
-                        local_boxes.insert(i+M-M*N);
-                    }
-
-                    if (!is_zmax[i])
-                    {
-                        local_boxes.insert(i+M+M*N);
-                    }
-                }
-
-                // add the box directly above
-                if (!is_zmin[i])
-                {
-                    local_boxes.insert(i-N*M);
-                }
-
-                // add the box directly below
-                if (!is_zmax[i])
-                {
-                    local_boxes.insert(i+N*M);
-                }
-
-                // finally, the 8 corners are left
-
-                if ( (!is_xmin[i]) && (!is_ymin[i]) && (!is_zmin[i]) )
-                {
-                    local_boxes.insert(i-1-M-M*N);
-                }
-
-                if ( (!is_xmin[i]) && (!is_ymin[i]) && (!is_zmax[i]) )
-                {
-                    local_boxes.insert(i-1-M+M*N);
-                }
-
-                if ( (!is_xmin[i]) && (!is_ymax[i]) && (!is_zmin[i]) )
-                {
-                    local_boxes.insert(i-1+M-M*N);
-                }
-
-                if ( (!is_xmin[i]) && (!is_ymax[i]) && (!is_zmax[i]) )
-                {
-                    local_boxes.insert(i-1+M+M*N);
-                }
+        mAreLocalBoxesSet = true;
+    }
+}
 
-                if ( (!is_xmax[i]) && (!is_ymin[i]) && (!is_zmin[i]) )
-                {
-                    local_boxes.insert(i+1-M-M*N);
-                }
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::SetupAllLocalBoxes()
+{
+    mAreLocalBoxesSet = true;
 
-                if ( (!is_xmax[i]) && (!is_ymin[i]) && (!is_zmax[i]) )
-                {
-                    local_boxes.insert(i+1-M+M*N);
-                }
+    std::vector<c_vector<int, DIM> > all_offsets = GetNeighbourOffsets(true);
 
-                if ( (!is_xmax[i]) && (!is_ymax[i]) && (!is_zmin[i]) )
-                {
-                    local_boxes.insert(i+1+M-M*N);
-                }
+    mLocalBoxes.clear();
+    for (std::map<unsigned, unsigned>::iterator box_iter = mBoxesMapping.begin();
+         box_iter != mBoxesMapping.end();
+         ++box_iter)
+    {
+        std::set<unsigned> local_boxes;
 
-                if ( (!is_xmax[i]) && (!is_ymax[i]) && (!is_zmax[i]) )
-                {
-                    local_boxes.insert(i+1+M+M*N);
-                }
+        // Insert the current box and all of its neighbours
+        local_boxes.insert(box_iter->first);
+        AddBoxesAtOffsets(box_iter->first, all_offsets, false, local_boxes);
 
-                mLocalBoxes.push_back(local_boxes);
-            }
-            break;
-        }
-        default:
-            NEVER_REACHED;
+        mLocalBoxes.push_back(local_boxes);
     }
 }
 
@@ -1066,8 +1016,8 @@ template<unsigned DIM>
 std::set<unsigned> DistributedBoxCollection<DIM>::GetLocalBoxes(unsigned boxIndex)
 {
     // Make sure the box is locally owned
-    assert(!(boxIndex < mMinBoxIndex) && !(mMaxBoxIndex<boxIndex));
-    return mLocalBoxes[boxIndex-mMinBoxIndex];
+    assert(GetBoxOwnership(boxIndex));
+    return mLocalBoxes[CalculateLocalIndex(boxIndex)];
 }
 
 template<unsigned DIM>
@@ -1090,30 +1040,158 @@ template<unsigned DIM>
 unsigned DistributedBoxCollection<DIM>::GetProcessOwningNode(Node<DIM>* pNode)
 {
     unsigned box_index = CalculateContainingBox(pNode);
-    unsigned containing_process = PetscTools::GetMyRank();
+    c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(box_index);
 
-    if (box_index > mMaxBoxIndex)
+    // Nodes can only move into the region of a neighbouring process
+    c_vector<unsigned, DIM> process_coords = mProcessCoordinates;
+    for (unsigned d=0; d<DIM; d++)
     {
-        containing_process++;
+        if (box_coords(d) > mMaxBoxCoordinates(d))
+        {
+            process_coords(d)++;
+        }
+        else if (box_coords(d) < mMinBoxCoordinates(d))
+        {
+            process_coords(d)--;
+        }
     }
-    else if (box_index < mMinBoxIndex)
+
+    return CalculateProcessRank(process_coords);
+}
+
+template<unsigned DIM>
+unsigned DistributedBoxCollection<DIM>::CalculateProcessOwningBox(unsigned globalIndex)
+{
+    c_vector<unsigned, DIM> box_coords = CalculateCoordinateIndices(globalIndex);
+
+    c_vector<unsigned, DIM> process_coords;
+    for (unsigned d=0; d<DIM; d++)
     {
-        containing_process--;
+        std::vector<unsigned>& r_boundaries = mProcessBoxBoundaries[d];
+        process_coords(d) = (std::upper_bound(r_boundaries.begin(), r_boundaries.end(), box_coords(d)) - r_boundaries.begin()) - 1;
     }
 
-    return containing_process;
+    return CalculateProcessRank(process_coords);
+}
+
+template<unsigned DIM>
+std::vector<unsigned>& DistributedBoxCollection<DIM>::rGetHaloNodesToSend(unsigned processIndex)
+{
+    return mHaloNodesToSend[processIndex];
 }
 
 template<unsigned DIM>
 std::vector<unsigned>& DistributedBoxCollection<DIM>::rGetHaloNodesRight()
 {
-    return mHaloNodesRight;
+    assert(IsStripDecomposition());
+    return mHaloNodesToSend[PetscTools::GetMyRank() + 1];
 }
 
 template<unsigned DIM>
 std::vector<unsigned>& DistributedBoxCollection<DIM>::rGetHaloNodesLeft()
 {
-    return mHaloNodesLeft;
+    assert(IsStripDecomposition());
+    return mHaloNodesToSend[PetscTools::GetMyRank() - 1];
+}
+
+template<unsigned DIM>
+c_vector<unsigned, DIM> DistributedBoxCollection<DIM>::GetNumProcessesEachDirection() const
+{
+    return mNumProcessesEachDirection;
+}
+
+template<unsigned DIM>
+const std::vector<std::vector<unsigned> >& DistributedBoxCollection<DIM>::rGetProcessBoxBoundaries() const
+{
+    return mProcessBoxBoundaries;
+}
+
+template<unsigned DIM>
+bool DistributedBoxCollection<DIM>::IsStripDecomposition() const
+{
+    for (unsigned d=0; d<DIM-1; d++)
+    {
+        if (mNumProcessesEachDirection(d) > 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& DistributedBoxCollection<DIM>::rGetNeighbourProcesses() const
+{
+    return mNeighbourProcesses;
+}
+
+template<unsigned DIM>
+std::vector<std::vector<unsigned> > DistributedBoxCollection<DIM>::CalculateBalancedProcessBoundaries()
+{
+    std::vector<std::vector<unsigned> > boundaries(DIM);
+
+    for (unsigned d=0; d<DIM; d++)
+    {
+        unsigned num_slabs = mNumProcessesEachDirection(d);
+        unsigned num_boxes = mNumBoxesEachDirection(d);
+
+        if (num_slabs == 1)
+        {
+            boundaries[d] = mProcessBoxBoundaries[d];
+            continue;
+        }
+
+        // Count the nodes in each layer of boxes normal to this direction, over all processes
+        std::vector<unsigned> local_layer_loads(num_boxes, 0u);
+        for (std::map<unsigned, unsigned>::iterator iter = mBoxesMapping.begin();
+             iter != mBoxesMapping.end();
+             ++iter)
+        {
+            c_vector<unsigned, DIM> coords = CalculateCoordinateIndices(iter->first);
+            local_layer_loads[coords(d)] += GetNumNodesInBox(iter->first);
+        }
+
+        std::vector<unsigned> layer_loads(num_boxes, 0u);
+        MPI_Allreduce(&local_layer_loads[0], &layer_loads[0], num_boxes, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+
+        std::vector<double> cumulative_loads(num_boxes + 1, 0.0);
+        for (unsigned i=0; i<num_boxes; i++)
+        {
+            cumulative_loads[i+1] = cumulative_loads[i] + layer_loads[i];
+        }
+        double total_load = cumulative_loads[num_boxes];
+
+        // If there are no nodes there is nothing to balance
+        if (total_load == 0.0)
+        {
+            boundaries[d] = mProcessBoxBoundaries[d];
+            continue;
+        }
+
+        /*
+         * Move each boundary towards the place where the load below it is closest to its ideal share.
+         * Boundaries move by at most one box, so that nodes only ever have to move to a neighbouring
+         * process, and every slab of processes keeps at least one layer of boxes.
+         */
+        boundaries[d].push_back(0u);
+        for (unsigned slab=1; slab<num_slabs; slab++)
+        {
+            double target_load = total_load*slab/num_slabs;
+            unsigned old_boundary = mProcessBoxBoundaries[d][slab];
+            unsigned boundary = std::max(old_boundary - 1, boundaries[d][slab-1] + 1);
+            unsigned max_boundary = std::min(old_boundary + 1, num_boxes - (num_slabs - slab));
+
+            while ((boundary < max_boundary)
+                   && (fabs(cumulative_loads[boundary+1] - target_load) < fabs(cumulative_loads[boundary] - target_load)))
+            {
+                boundary++;
+            }
+            boundaries[d].push_back(boundary);
+        }
+        boundaries[d].push_back(num_boxes);
+    }
+
+    return boundaries;
 }
 
 template<unsigned DIM>
@@ -1123,23 +1201,56 @@ void DistributedBoxCollection<DIM>::SetCalculateNodeNeighbours(bool calculateNod
 }
 
 template<unsigned DIM>
-void DistributedBoxCollection<DIM>::CalculateNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
+void DistributedBoxCollection<DIM>::ResetNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
 {
     rNodePairs.clear();
     rNodeNeighbours.clear();
 
-    // Create an empty neighbours set for each node
-    for (unsigned i=0; i<rNodes.size(); i++)
+    mPairRowNodes.clear();
+    mPairNeighbours.clear();
+    mPairRowStarts.assign(1, 0u);
+
+    if (mUseFlatCellList)
+    {
+        if (mCalculateNodeNeighbours)
+        {
+            // The owned nodes are at the front of the flat cell list
+            for (unsigned i=0; i<mCellNodeStarts[mNumOwnedCells]; i++)
+            {
+                rNodeNeighbours[mCellNodes[i]->GetIndex()] = std::set<unsigned>();
+            }
+        }
+    }
+    else
     {
-        unsigned node_index = rNodes[i]->GetIndex();
+        // Create an empty neighbours set for each node
+        for (unsigned i=0; i<rNodes.size(); i++)
+        {
+            unsigned node_index = rNodes[i]->GetIndex();
+
+            // Get the box containing this node
+            unsigned box_index = CalculateContainingBox(rNodes[i]);
+
+            if (GetBoxOwnership(box_index))
+            {
+                rNodeNeighbours[node_index] = std::set<unsigned>();
+            }
+        }
+    }
+}
 
-        // Get the box containing this node
-        unsigned box_index = CalculateContainingBox(rNodes[i]);
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::CalculateNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
+{
+    ResetNodePairs(rNodes, rNodePairs, rNodeNeighbours);
 
-        if (GetBoxOwnership(box_index))
+    if (mUseFlatCellList)
+    {
+        for (unsigned cell=0; cell<mNumOwnedCells; cell++)
         {
-            rNodeNeighbours[node_index] = std::set<unsigned>();
+            AddPairsFromCell(cell, rNodePairs, rNodeNeighbours);
         }
+        return;
     }
 
     for (std::map<unsigned, unsigned>::iterator map_iter = mBoxesMapping.begin();
@@ -1156,21 +1267,18 @@ void DistributedBoxCollection<DIM>::CalculateNodePairs(std::vector<Node<DIM>*>&
 template<unsigned DIM>
 void DistributedBoxCollection<DIM>::CalculateInteriorNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
 {
-    rNodePairs.clear();
-    rNodeNeighbours.clear();
+    ResetNodePairs(rNodes, rNodePairs, rNodeNeighbours);
 
-    // Create an empty neighbours set for each node
-    for (unsigned i=0; i<rNodes.size(); i++)
+    if (mUseFlatCellList)
     {
-        unsigned node_index = rNodes[i]->GetIndex();
-
-        // Get the box containing this node
-        unsigned box_index = CalculateContainingBox(rNodes[i]);
-
-        if (GetBoxOwnership(box_index))
+        for (unsigned cell=0; cell<mNumOwnedCells; cell++)
         {
-            rNodeNeighbours[node_index] = std::set<unsigned>();
+            if (mIsInteriorCell[cell])
+            {
+                AddPairsFromCell(cell, rNodePairs, rNodeNeighbours);
+            }
         }
+        return;
     }
 
     for (std::map<unsigned, unsigned>::iterator map_iter = mBoxesMapping.begin();
@@ -1190,6 +1298,18 @@ void DistributedBoxCollection<DIM>::CalculateInteriorNodePairs(std::vector<Node<
 template<unsigned DIM>
 void DistributedBoxCollection<DIM>::CalculateBoundaryNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
 {
+    if (mUseFlatCellList)
+    {
+        for (unsigned cell=0; cell<mNumOwnedCells; cell++)
+        {
+            if (!mIsInteriorCell[cell])
+            {
+                AddPairsFromCell(cell, rNodePairs, rNodeNeighbours);
+            }
+        }
+        return;
+    }
+
     for (std::map<unsigned, unsigned>::iterator map_iter = mBoxesMapping.begin();
             map_iter != mBoxesMapping.end();
             ++map_iter)
@@ -1204,6 +1324,48 @@ void DistributedBoxCollection<DIM>::CalculateBoundaryNodePairs(std::vector<Node<
     }
 }
 
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::AddPairsFromCell(unsigned cell, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
+{
+    unsigned cell_end = mCellNodeStarts[cell+1];
+    for (unsigned i=mCellNodeStarts[cell]; i<cell_end; i++)
+    {
+        Node<DIM>* p_node = mCellNodes[i];
+        mPairRowNodes.push_back(p_node);
+
+        // Nodes later in the same cell, so that each pair is only stored once
+        for (unsigned j=i+1; j<cell_end; j++)
+        {
+            mPairNeighbours.push_back(mCellNodes[j]);
+        }
+
+        // Nodes in the neighbouring cells
+        for (unsigned k=mCellNeighbourStarts[cell]; k<mCellNeighbourStarts[cell+1]; k++)
+        {
+            unsigned other_cell = mCellNeighbours[k];
+            for (unsigned j=mCellNodeStarts[other_cell]; j<mCellNodeStarts[other_cell+1]; j++)
+            {
+                mPairNeighbours.push_back(mCellNodes[j]);
+            }
+        }
+
+        unsigned row_start = mPairRowStarts.back();
+        mPairRowStarts.push_back(mPairNeighbours.size());
+
+        for (unsigned j=row_start; j<mPairNeighbours.size(); j++)
+        {
+            rNodePairs.push_back(std::pair<Node<DIM>*, Node<DIM>*>(p_node, mPairNeighbours[j]));
+            if (mCalculateNodeNeighbours)
+            {
+                unsigned node_index = p_node->GetIndex();
+                unsigned other_node_index = mPairNeighbours[j]->GetIndex();
+                rNodeNeighbours[node_index].insert(other_node_index);
+                rNodeNeighbours[other_node_index].insert(node_index);
+            }
+        }
+    }
+}
+
 template<unsigned DIM>
 void DistributedBoxCollection<DIM>::AddPairsFromBox(unsigned boxIndex, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours)
 {
@@ -1283,21 +1445,294 @@ void DistributedBoxCollection<DIM>::AddPairsFromBox(unsigned boxIndex, std::vect
 template<unsigned DIM>
 std::vector<int> DistributedBoxCollection<DIM>::CalculateNumberOfNodesInEachStrip()
 {
-    std::vector<int> cell_numbers(mpDistributedBoxStackFactory->GetHigh() - mpDistributedBoxStackFactory->GetLow(), 0);
+    std::vector<int> cell_numbers(GetNumRowsOfBoxes(), 0);
 
     for (std::map<unsigned, unsigned>::iterator iter = mBoxesMapping.begin();
             iter != mBoxesMapping.end();
             ++iter)
     {
         c_vector<unsigned, DIM> coords = CalculateCoordinateIndices(iter->first);
-        unsigned location_in_vector = coords[DIM-1]-mpDistributedBoxStackFactory->GetLow();
+        unsigned location_in_vector = coords[DIM-1] - mMinBoxCoordinates(DIM-1);
 
-        cell_numbers[location_in_vector] += mBoxes[iter->second].rGetNodesContained().size();
+        cell_numbers[location_in_vector] += GetNumNodesInBox(iter->first);
     }
 
     return cell_numbers;
 }
 
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::SetUseFlatCellList(bool useFlatCellList)
+{
+    mUseFlatCellList = useFlatCellList;
+
+    if (mUseFlatCellList)
+    {
+        assert(mAreLocalBoxesSet);
+        SetupFlatCellList();
+    }
+    else
+    {
+        mCellBoxIndices.clear();
+        mNumOwnedCells = 0;
+        mCellLookup.clear();
+        mCellNeighbourStarts.clear();
+        mCellNeighbours.clear();
+        mIsInteriorCell.clear();
+        mCellNodeStarts.clear();
+        mCellNodes.clear();
+        mCachedNodes.clear();
+        mCachedNodeCells.clear();
+    }
+
+    // Nodes must be placed in boxes again using the new storage
+    EmptyBoxes();
+}
+
+template<unsigned DIM>
+bool DistributedBoxCollection<DIM>::GetUseFlatCellList() const
+{
+    return mUseFlatCellList;
+}
+
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::SetupFlatCellList()
+{
+    // Sort the owned boxes, then the halo boxes, along a Morton curve
+    std::vector<std::pair<c_vector<unsigned, DIM>, unsigned> > owned_boxes;
+    for (std::map<unsigned, unsigned>::iterator iter = mBoxesMapping.begin();
+         iter != mBoxesMapping.end();
+         ++iter)
+    {
+        owned_boxes.push_back(std::make_pair(CalculateCoordinateIndices(iter->first), iter->first));
+    }
+    std::sort(owned_boxes.begin(), owned_boxes.end(), MortonOrderLess<DIM>());
+
+    std::vector<std::pair<c_vector<unsigned, DIM>, unsigned> > halo_boxes;
+    for (std::map<unsigned, unsigned>::iterator iter = mHaloBoxesMapping.begin();
+         iter != mHaloBoxesMapping.end();
+         ++iter)
+    {
+        halo_boxes.push_back(std::make_pair(CalculateCoordinateIndices(iter->first), iter->first));
+    }
+    std::sort(halo_boxes.begin(), halo_boxes.end(), MortonOrderLess<DIM>());
+
+    mNumOwnedCells = owned_boxes.size();
+    owned_boxes.insert(owned_boxes.end(), halo_boxes.begin(), halo_boxes.end());
+
+    mCellBoxIndices.clear();
+    for (unsigned cell=0; cell<owned_boxes.size(); cell++)
+    {
+        mCellBoxIndices.push_back(owned_boxes[cell].second);
+    }
+
+    // The lookup covers the owned boxes and one layer of boxes around them
+    unsigned lookup_size = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mCellLookupOrigin(d) = (mMinBoxCoordinates(d) > 0) ? mMinBoxCoordinates(d) - 1 : 0;
+        unsigned top = std::min(mMaxBoxCoordinates(d) + 1, mNumBoxesEachDirection(d) - 1);
+        mCellLookupExtents(d) = top - mCellLookupOrigin(d) + 1;
+        lookup_size *= mCellLookupExtents(d);
+    }
+
+    mCellLookup.assign(lookup_size, UNSIGNED_UNSET);
+    for (unsigned cell=0; cell<owned_boxes.size(); cell++)
+    {
+        unsigned position = 0;
+        unsigned stride = 1;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            position += (owned_boxes[cell].first(d) - mCellLookupOrigin(d))*stride;
+            stride *= mCellLookupExtents(d);
+        }
+        mCellLookup[position] = cell;
+    }
+
+    // Convert the local boxes of each owned box to neighbouring cells
+    mCellNeighbourStarts.assign(1, 0u);
+    mCellNeighbours.clear();
+    mIsInteriorCell.clear();
+    for (unsigned cell=0; cell<mNumOwnedCells; cell++)
+    {
+        unsigned box_index = mCellBoxIndices[cell];
+        std::set<unsigned> local_boxes = GetLocalBoxes(box_index);
+        for (std::set<unsigned>::iterator iter = local_boxes.begin();
+             iter != local_boxes.end();
+             ++iter)
+        {
+            if (*iter != box_index)
+            {
+                unsigned other_cell = CalculateCellFromCoordinates(CalculateCoordinateIndices(*iter));
+                assert(other_cell != UNSIGNED_UNSET);
+                mCellNeighbours.push_back(other_cell);
+            }
+        }
+        std::sort(mCellNeighbours.begin() + mCellNeighbourStarts.back(), mCellNeighbours.end());
+        mCellNeighbourStarts.push_back(mCellNeighbours.size());
+
+        mIsInteriorCell.push_back(IsInteriorBox(box_index));
+    }
+
+    mCellNodeStarts.assign(mCellBoxIndices.size() + 1, 0u);
+    mCellNodes.clear();
+    mCachedNodes.clear();
+    mCachedNodeCells.clear();
+
+    mPairRowNodes.clear();
+    mPairNeighbours.clear();
+    mPairRowStarts.assign(1, 0u);
+}
+
+template<unsigned DIM>
+unsigned DistributedBoxCollection<DIM>::CalculateCellFromCoordinates(const c_vector<unsigned, DIM>& rCoordinateIndices) const
+{
+    unsigned position = 0;
+    unsigned stride = 1;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        if ((rCoordinateIndices(d) < mCellLookupOrigin(d)) || (rCoordinateIndices(d) >= mCellLookupOrigin(d) + mCellLookupExtents(d)))
+        {
+            return UNSIGNED_UNSET;
+        }
+        position += (rCoordinateIndices(d) - mCellLookupOrigin(d))*stride;
+        stride *= mCellLookupExtents(d);
+    }
+    return mCellLookup[position];
+}
+
+template<unsigned DIM>
+unsigned DistributedBoxCollection<DIM>::GetNumNodesInBox(unsigned globalIndex)
+{
+    if (mUseFlatCellList)
+    {
+        unsigned cell = CalculateCellFromCoordinates(CalculateCoordinateIndices(globalIndex));
+        assert(cell < mNumOwnedCells);
+        return mCellNodeStarts[cell+1] - mCellNodeStarts[cell];
+    }
+    return rGetBox(globalIndex).rGetNodesContained().size();
+}
+
+template<unsigned DIM>
+bool DistributedBoxCollection<DIM>::UpdateFlatCellList(const std::vector<Node<DIM>*>& rNodes)
+{
+    assert(mUseFlatCellList);
+
+    std::vector<Node<DIM>*> nodes;
+    std::vector<unsigned> node_cells;
+    nodes.reserve(rNodes.size());
+    node_cells.reserve(rNodes.size());
+    for (unsigned i=0; i<rNodes.size(); i++)
+    {
+        if (!rNodes[i]->IsDeleted())
+        {
+            unsigned cell = CalculateCellFromCoordinates(CalculateContainingBoxCoordinates(rNodes[i]->rGetLocation()));
+            assert(cell < mNumOwnedCells);
+            nodes.push_back(rNodes[i]);
+            node_cells.push_back(cell);
+        }
+    }
+
+    unsigned num_cells = mCellBoxIndices.size();
+    unsigned num_owned_nodes = nodes.size();
+
+    if ((node_cells == mCachedNodeCells) && (nodes == mCachedNodes))
+    {
+        // No node has changed box, so the sorted nodes are still valid; just remove any halo nodes
+        mCellNodes.resize(num_owned_nodes);
+        for (unsigned cell=mNumOwnedCells; cell<num_cells; cell++)
+        {
+            mCellNodeStarts[cell+1] = num_owned_nodes;
+        }
+        return false;
+    }
+
+    // Counting sort of the nodes by cell
+    mCellNodeStarts.assign(num_cells + 1, 0u);
+    for (unsigned i=0; i<num_owned_nodes; i++)
+    {
+        mCellNodeStarts[node_cells[i]+1]++;
+    }
+    for (unsigned cell=0; cell<num_cells; cell++)
+    {
+        mCellNodeStarts[cell+1] += mCellNodeStarts[cell];
+    }
+
+    std::vector<unsigned> next_slot(mCellNodeStarts.begin(), mCellNodeStarts.end() - 1);
+    mCellNodes.resize(num_owned_nodes);
+    for (unsigned i=0; i<num_owned_nodes; i++)
+    {
+        mCellNodes[next_slot[node_cells[i]]++] = nodes[i];
+    }
+
+    mCachedNodes.swap(nodes);
+    mCachedNodeCells.swap(node_cells);
+
+    return true;
+}
+
+template<unsigned DIM>
+void DistributedBoxCollection<DIM>::AddHaloNodesToFlatCellList(const std::vector<Node<DIM>*>& rHaloNodes)
+{
+    assert(mUseFlatCellList);
+
+    unsigned num_cells = mCellBoxIndices.size();
+    unsigned num_owned_nodes = mCellNodeStarts[mNumOwnedCells];
+
+    // Counting sort of the halo nodes by cell, after the owned nodes
+    std::vector<unsigned> halo_node_cells(rHaloNodes.size());
+    for (unsigned cell=mNumOwnedCells; cell<num_cells; cell++)
+    {
+        mCellNodeStarts[cell+1] = 0;
+    }
+    for (unsigned i=0; i<rHaloNodes.size(); i++)
+    {
+        unsigned cell = CalculateCellFromCoordinates(CalculateContainingBoxCoordinates(rHaloNodes[i]->rGetLocation()));
+        assert((cell != UNSIGNED_UNSET) && (cell >= mNumOwnedCells));
+        halo_node_cells[i] = cell;
+        mCellNodeStarts[cell+1]++;
+    }
+    for (unsigned cell=mNumOwnedCells; cell<num_cells; cell++)
+    {
+        mCellNodeStarts[cell+1] += mCellNodeStarts[cell];
+    }
+
+    std::vector<unsigned> next_slot(mCellNodeStarts.begin(), mCellNodeStarts.end() - 1);
+    mCellNodes.resize(num_owned_nodes + rHaloNodes.size());
+    for (unsigned i=0; i<rHaloNodes.size(); i++)
+    {
+        mCellNodes[next_slot[halo_node_cells[i]]++] = rHaloNodes[i];
+    }
+}
+
+template<unsigned DIM>
+std::vector<Node<DIM>*> DistributedBoxCollection<DIM>::GetNodesInFlatCell(unsigned globalIndex)
+{
+    assert(mUseFlatCellList);
+
+    unsigned cell = CalculateCellFromCoordinates(CalculateCoordinateIndices(globalIndex));
+    assert(cell != UNSIGNED_UNSET);
+
+    return std::vector<Node<DIM>*>(mCellNodes.begin() + mCellNodeStarts[cell], mCellNodes.begin() + mCellNodeStarts[cell+1]);
+}
+
+template<unsigned DIM>
+const std::vector<Node<DIM>*>& DistributedBoxCollection<DIM>::rGetPairRowNodes() const
+{
+    return mPairRowNodes;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& DistributedBoxCollection<DIM>::rGetPairRowStarts() const
+{
+    return mPairRowStarts;
+}
+
+template<unsigned DIM>
+const std::vector<Node<DIM>*>& DistributedBoxCollection<DIM>::rGetPairNeighbours() const
+{
+    return mPairNeighbours;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // Explicit instantiation
 /////////////////////////////////////////////////////////////////////////////
@@ -36,6 +36,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define DISTRIBUTEDBOXCOLLECTION_HPP_
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/vector.hpp>
 
 #include "Node.hpp"
@@ -62,17 +63,17 @@ private:
     /** A vector of boxes owned on other processes sharing a boundary with this process */
     std::vector< Box<DIM> > mHaloBoxes;
 
-    /** A vector of the global indices of boxes, owned by this process, but on a boundary with right process. */
-    std::vector<unsigned> mHalosRight;
+    /** The global indices of boxes, owned by this process, that are halos of each neighbouring process (keyed by process rank). */
+    std::map<unsigned, std::vector<unsigned> > mHaloBoxesToSend;
 
-    /** A vector of the global indices of boxes, owned by this process, but on a boundary with left process. */
-    std::vector<unsigned> mHalosLeft;
+    /** The indices of nodes, lying locally, that are halos of each neighbouring process (keyed by process rank). */
+    std::map<unsigned, std::vector<unsigned> > mHaloNodesToSend;
 
-    /** Set of Nodes that are halos of adjacent right process, but lie locally */
-    std::vector<unsigned> mHaloNodesRight;
+    /** The global indices of boxes that are halos of the process to the right, when the boxes are split into strips. */
+    std::vector<unsigned> mHalosRight;
 
-    /** Set of Nodes that are halos of adjacent left process, but lie locally */
-    std::vector<unsigned> mHaloNodesLeft;
+    /** The global indices of boxes that are halos of the process to the left, when the boxes are split into strips. */
+    std::vector<unsigned> mHalosLeft;
 
     /** Map of global to local indices of boxes. **/
     std::map<unsigned, unsigned> mBoxesMapping;
@@ -104,6 +105,30 @@ private:
     /** The largest index of the boxes owned by this process. */
     unsigned mMaxBoxIndex;
 
+    /** The smallest co-ordinate indices of the boxes owned by this process. */
+    c_vector<unsigned, DIM> mMinBoxCoordinates;
+
+    /** The largest co-ordinate indices of the boxes owned by this process. */
+    c_vector<unsigned, DIM> mMaxBoxCoordinates;
+
+    /** The number of processes in each direction of the Cartesian process grid. */
+    c_vector<unsigned, DIM> mNumProcessesEachDirection;
+
+    /** The co-ordinates of this process in the process grid. */
+    c_vector<unsigned, DIM> mProcessCoordinates;
+
+    /**
+     * For each direction, the first box co-ordinate owned by each slab of processes in the process grid,
+     * followed by the number of boxes in that direction.
+     */
+    std::vector<std::vector<unsigned> > mProcessBoxBoundaries;
+
+    /** The ranks of the processes owning boxes that touch the boxes owned by this process, in increasing order. */
+    std::vector<unsigned> mNeighbourProcesses;
+
+    /** A distributed vector factory describing the rows / faces (2d, 3d) of boxes spanned by this process in the last direction. */
+    DistributedVectorFactory* mpDistributedBoxStackFactory;
+
     /** Whether the domain is periodic in the X dimension Note this currently only works for DIM=2.*/
     bool mIsPeriodicInX;
 
@@ -113,12 +138,64 @@ private:
     /** A fudge (box swelling) factor to deal with 32-bit floating point issues. */
     static const double msFudge;
 
-    /** A distributed vector factory that governs ownership of rows of boxes */
-    DistributedVectorFactory* mpDistributedBoxStackFactory;
-
     /** A flag that can be set to not save rNodeNeighbours in CalculateNodePairs - for efficiency */
     bool mCalculateNodeNeighbours;
 
+    /**
+     * Whether the nodes in each box are stored in the flat cell list below, rather than
+     * in the std::set held by each Box. Defaults to false.
+     */
+    bool mUseFlatCellList;
+
+    /**
+     * The global indices of the boxes in the flat cell list ('cells'). Boxes owned by this process
+     * come first, followed by the halo boxes, each sorted along a Morton (Z-order) curve so that
+     * boxes close in space are close in memory.
+     */
+    std::vector<unsigned> mCellBoxIndices;
+
+    /** The number of cells in mCellBoxIndices owned by this process. */
+    unsigned mNumOwnedCells;
+
+    /** The smallest box co-ordinates covered by mCellLookup (the local boxes padded by one layer of halo boxes). */
+    c_vector<unsigned, DIM> mCellLookupOrigin;
+
+    /** The number of boxes in each direction covered by mCellLookup. */
+    c_vector<unsigned, DIM> mCellLookupExtents;
+
+    /** Dense map from box co-ordinates (relative to mCellLookupOrigin, x fastest) to cell, or UNSIGNED_UNSET. */
+    std::vector<unsigned> mCellLookup;
+
+    /** For each owned cell, the start of its entries in mCellNeighbours (compressed row storage). */
+    std::vector<unsigned> mCellNeighbourStarts;
+
+    /** The cells (other than itself) whose nodes may interact with the nodes in each owned cell, as given by GetLocalBoxes(). */
+    std::vector<unsigned> mCellNeighbours;
+
+    /** Whether each owned cell is an interior box (see IsInteriorBox()). */
+    std::vector<bool> mIsInteriorCell;
+
+    /** For each cell, the start of its nodes in mCellNodes (compressed row storage, with a final entry for the end). */
+    std::vector<unsigned> mCellNodeStarts;
+
+    /** Pointers to the nodes in each cell, sorted by cell. */
+    std::vector<Node<DIM>*> mCellNodes;
+
+    /** The nodes passed to the last call to UpdateFlatCellList(), in the order given, used to detect when no re-sort is needed. */
+    std::vector<Node<DIM>*> mCachedNodes;
+
+    /** The cell containing each node in mCachedNodes. */
+    std::vector<unsigned> mCachedNodeCells;
+
+    /** The first node of each row of the neighbour-pair output when using the flat cell list. */
+    std::vector<Node<DIM>*> mPairRowNodes;
+
+    /** The start of each row of mPairNeighbours, with a final entry for the end (compressed row storage). */
+    std::vector<unsigned> mPairRowStarts;
+
+    /** The second node of each pair, listed by row. */
+    std::vector<Node<DIM>*> mPairNeighbours;
+
     /** Needed for serialization **/
     friend class boost::serialization::access;
 
@@ -134,6 +211,102 @@ private:
         //All methods over-ridden below.
     }
 
+    /**
+     * Swell the domain so that it is divisible by the box width, and count the boxes in each direction.
+     * Used by the constructors.
+     *
+     * @param domainSize the size of the domain, in the form (xmin, xmax, ymin, ymax) (etc)
+     */
+    void SetDomainSize(c_vector<double, 2*DIM> domainSize);
+
+    /**
+     * Make sure there is at least one box for each process in each direction of the process grid,
+     * swelling the domain if necessary. Used by the constructors.
+     */
+    void EnsureEnoughBoxesForProcesses();
+
+    /**
+     * Create the boxes owned by this process, and work out which processes neighbour it,
+     * once #mNumProcessesEachDirection and #mProcessBoxBoundaries have been set. Used by the constructors.
+     */
+    void SetupLocalRegion();
+
+    /**
+     * @param processCoordinates the co-ordinates of a process in the process grid.
+     * @return the rank of that process.
+     */
+    unsigned CalculateProcessRank(c_vector<unsigned, DIM> processCoordinates) const;
+
+    /**
+     * @param globalIndex the global index of a box owned by this process.
+     * @return the index of the box in #mBoxes and #mLocalBoxes.
+     */
+    unsigned CalculateLocalIndex(unsigned globalIndex);
+
+    /**
+     * Add to a set the global indices of the boxes lying at each of a list of offsets from a given box,
+     * skipping any that lie outside the domain. Offsets in x wrap around if the domain is periodic in x.
+     *
+     * @param globalIndex the global index of the box.
+     * @param rOffsets the offsets, in boxes, in each direction.
+     * @param onlyNonOwned whether to only add boxes not owned by this process.
+     * @param rBoxes the set to add the box indices to.
+     */
+    void AddBoxesAtOffsets(unsigned globalIndex, const std::vector<c_vector<int, DIM> >& rOffsets, bool onlyNonOwned, std::set<unsigned>& rBoxes);
+
+    /**
+     * @param includeAll whether to include all nearest-neighbour offsets, or just the half used by SetupLocalBoxesHalfOnly().
+     * @return the offsets, in boxes, from a box to its neighbouring boxes.
+     */
+    std::vector<c_vector<int, DIM> > GetNeighbourOffsets(bool includeAll);
+
+    /**
+     * Calculate the co-ordinate indices of the box containing a given location.
+     *
+     * @param rLocation the location
+     * @return the co-ordinate indices of the containing box
+     */
+    c_vector<unsigned, DIM> CalculateContainingBoxCoordinates(const c_vector<double, DIM>& rLocation);
+
+    /**
+     * Set up the cells, cell lookup and cell neighbour lists of the flat cell list from the local and halo boxes.
+     */
+    void SetupFlatCellList();
+
+    /**
+     * @return the cell of the flat cell list holding the box with given co-ordinate indices,
+     * or UNSIGNED_UNSET if the box is neither owned nor a halo box.
+     *
+     * @param rCoordinateIndices the co-ordinate indices of the box
+     */
+    unsigned CalculateCellFromCoordinates(const c_vector<unsigned, DIM>& rCoordinateIndices) const;
+
+    /**
+     * @return the number of nodes in a box owned by this process.
+     *
+     * @param globalIndex the global index of the box
+     */
+    unsigned GetNumNodesInBox(unsigned globalIndex);
+
+    /**
+     * Add the pairs of nodes with the first node in a given owned cell of the flat cell list, both to the
+     * neighbour-pair output of this class and to the vector and map provided.
+     *
+     * @param cell the owned cell
+     * @param rNodePairs the return value, a set of pairs of nodes
+     * @param rNodeNeighbours the other return value, the neighbours of each node.
+     */
+    void AddPairsFromCell(unsigned cell, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours);
+
+    /**
+     * Clear the neighbour-pair output and the vector and map provided, and add an empty neighbour set for each owned node.
+     *
+     * @param rNodes all the nodes to be consider
+     * @param rNodePairs the return value, a set of pairs of nodes
+     * @param rNodeNeighbours the other return value, the neighbours of each node.
+     */
+    void ResetNodePairs(std::vector<Node<DIM>*>& rNodes, std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& rNodePairs, std::map<unsigned, std::set<unsigned> >& rNodeNeighbours);
+
 public:
 
     /**
@@ -144,9 +317,25 @@ public:
      */
     DistributedBoxCollection(double boxWidth, c_vector<double, 2*DIM> domainSize, bool isPeriodicInX = false, int localRows = PETSC_DECIDE);
 
+    /**
+     * Constructor for a Cartesian decomposition of the boxes between processes. Rather than each process
+     * owning a strip of rows / faces (2d, 3d) of boxes, the processes form a grid and each owns a
+     * rectangular / cuboidal (2d, 3d) block of boxes. This gives much smaller halos on large numbers of processes.
+     *
+     * Any zero entries of numProcessesEachDirection are filled in automatically, giving more
+     * processes to directions containing more boxes (c.f. MPI_Dims_create()).
+     *
+     * @param boxWidth the width of each box (cut-off length in NodeBasedCellPopulation simulations)
+     * @param domainSize the size of the domain, in the form (xmin, xmax, ymin, ymax) (etc)
+     * @param numProcessesEachDirection the number of processes in each direction of the process grid.
+     * @param processBoxBoundaries for each direction, the first box co-ordinate owned by each slab of processes,
+     *     followed by the number of boxes in that direction.  Defaults to an even split.
+     */
+    DistributedBoxCollection(double boxWidth, c_vector<double, 2*DIM> domainSize, c_vector<unsigned, DIM> numProcessesEachDirection,
+                             std::vector<std::vector<unsigned> > processBoxBoundaries = std::vector<std::vector<unsigned> >());
 
     /**
-     * Destructor - frees memory allocated to distributed vector.
+     * Destructor.
      */
     ~DistributedBoxCollection();
 
@@ -158,13 +347,13 @@ public:
     /**
      * Setup the halo box structure on this process.
      *
-     * Sets up the containers mHaloBoxes, mHalosRight, mHalosLeft
+     * Sets up the containers mHaloBoxes and mHaloBoxesToSend (and mHalosRight, mHalosLeft for a strip decomposition)
      */
     void SetupHaloBoxes();
 
     /**
      * Update the halo boxes on this process, by transferring
-     * the nodes to be sent into the lists mHaloNodesRight / Left.
+     * the nodes to be sent to each neighbouring process into mHaloNodesToSend.
      */
     void UpdateHaloBoxes();
 
@@ -274,6 +463,43 @@ public:
      */
     int LoadBalance(std::vector<int> localDistribution);
 
+    /**
+     * Work out new process box boundaries that balance the number of nodes in each slab of processes
+     * of the process grid, in each direction. This is the counterpart of LoadBalance() for Cartesian
+     * decompositions; the result can be passed to the Cartesian constructor. Each boundary moves by at
+     * most one box, so nodes only ever have to move to a neighbouring process. Must be called collectively.
+     *
+     * @return the new process box boundaries (see #mProcessBoxBoundaries).
+     */
+    std::vector<std::vector<unsigned> > CalculateBalancedProcessBoundaries();
+
+    /**
+     * @return the number of processes in each direction of the process grid.
+     */
+    c_vector<unsigned, DIM> GetNumProcessesEachDirection() const;
+
+    /**
+     * @return #mProcessBoxBoundaries
+     */
+    const std::vector<std::vector<unsigned> >& rGetProcessBoxBoundaries() const;
+
+    /**
+     * @return whether the boxes are split between processes in strips of rows / faces (2d, 3d),
+     * i.e. there is only more than one process in the last direction of the process grid.
+     */
+    bool IsStripDecomposition() const;
+
+    /**
+     * @return #mNeighbourProcesses
+     */
+    const std::vector<unsigned>& rGetNeighbourProcesses() const;
+
+    /**
+     * @param globalIndex the global index of the box.
+     * @return the rank of the process owning the box.
+     */
+    unsigned CalculateProcessOwningBox(unsigned globalIndex);
+
     /**
      *  Set up the local boxes (ie itself and its nearest-neighbours) for each of the boxes.
      *  This method just sets up half of the local boxes (for example, in 1D, local boxes for box0 = {1}
@@ -308,7 +534,8 @@ public:
 
     /**
      * Get the process that should own this node.
-     * Currently only returns +/-1 of this process so assumes nodes don't move too far. //\ todo this should be fixed.
+     * Only returns this process or one of #mNeighbourProcesses, so assumes nodes don't move too far
+     * (a node further away is passed to the neighbouring process in its direction).
      *
      * @param pNode the node to be tested
      * @return the ID of the process that should own the node.
@@ -316,12 +543,22 @@ public:
     unsigned GetProcessOwningNode(Node<DIM>* pNode);
 
     /**
-     * @return #mHaloNodesRight the list of nodes that are close to the right boundary
+     * @param processIndex the rank of a neighbouring process.
+     * @return the list of nodes lying locally that are halos of that process.
+     */
+    std::vector<unsigned>& rGetHaloNodesToSend(unsigned processIndex);
+
+    /**
+     * Equivalent to rGetHaloNodesToSend() for the process to the right, when the boxes are split into strips.
+     *
+     * @return the list of nodes that are close to the right boundary
      */
     std::vector<unsigned>& rGetHaloNodesRight();
 
     /**
-     * @return #mHaloNodesRight the list of nodes that are close to the left boundary
+     * Equivalent to rGetHaloNodesToSend() for the process to the left, when the boxes are split into strips.
+     *
+     * @return the list of nodes that are close to the left boundary
      */
     std::vector<unsigned>& rGetHaloNodesLeft();
 
@@ -332,6 +569,54 @@ public:
      */
     void SetCalculateNodeNeighbours(bool calculateNodeNeighbours);
 
+    /**
+     * Set whether to store the nodes in each box in a flat cell list: nodes are counting-sorted by box into
+     * one contiguous array, with boxes in Morton order, instead of being inserted into a std::set per box.
+     * Node pairs are then also available in compressed row form from rGetPairRowNodes(), rGetPairRowStarts()
+     * and rGetPairNeighbours(). Must be called after the local and halo boxes have been set up.
+     *
+     * When using the flat cell list and mCalculateNodeNeighbours is false, rNodeNeighbours is left empty
+     * by the CalculateNodePairs() methods.
+     *
+     * @param useFlatCellList whether to use the flat cell list
+     */
+    void SetUseFlatCellList(bool useFlatCellList);
+
+    /** @return whether the nodes in each box are stored in the flat cell list. */
+    bool GetUseFlatCellList() const;
+
+    /**
+     * Place the nodes owned by this process in the flat cell list, removing any halo nodes.
+     * If the nodes are the same, in the same order and in the same boxes as at the last call,
+     * the previous sort is reused.
+     *
+     * @param rNodes the nodes owned by this process (deleted nodes are ignored)
+     * @return whether the nodes had to be re-sorted
+     */
+    bool UpdateFlatCellList(const std::vector<Node<DIM>*>& rNodes);
+
+    /**
+     * Place halo nodes in the halo boxes of the flat cell list, replacing any already there.
+     *
+     * @param rHaloNodes the halo nodes
+     */
+    void AddHaloNodesToFlatCellList(const std::vector<Node<DIM>*>& rHaloNodes);
+
+    /** @return the nodes contained in the box with a given global index, from the flat cell list (in no particular order).
+     *
+     * @param globalIndex the global index of an owned or halo box
+     */
+    std::vector<Node<DIM>*> GetNodesInFlatCell(unsigned globalIndex);
+
+    /** @return the first node of each row of the neighbour-pair output from the last call(s) to the CalculateNodePairs() methods. */
+    const std::vector<Node<DIM>*>& rGetPairRowNodes() const;
+
+    /** @return the start of each row in rGetPairNeighbours(), followed by its size. */
+    const std::vector<unsigned>& rGetPairRowStarts() const;
+
+    /** @return the second node of each pair, listed by row. */
+    const std::vector<Node<DIM>*>& rGetPairNeighbours() const;
+
     /**
      *  Compute all the pairs of (potentially) connected nodes for cell_based simulations, ie nodes which are in a
      *  local box to the box containing the first node. **Note: the user still has to check that the node
@@ -379,6 +664,25 @@ public:
     std::vector<int> CalculateNumberOfNodesInEachStrip();
 };
 
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Specify a version number for archive backwards compatibility.
+ *
+ * This is how to do BOOST_CLASS_VERSION(DistributedBoxCollection, 1)
+ * with a templated class.
+ */
+template <unsigned DIM>
+struct version<DistributedBoxCollection<DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(1);
+};
+} // namespace serialization
+} // namespace boost
+
 #include "SerializationExportWrapper.hpp"
 // Declare identifier for the serializer
 EXPORT_TEMPLATE_CLASS_SAME_DIMS(DistributedBoxCollection)
@@ -395,33 +699,33 @@ template<class Archive, unsigned DIM>
 inline void save_construct_data(
     Archive & ar, const DistributedBoxCollection<DIM> * t, const unsigned int file_version)
 {
-    // Save the number of rows that each process owns, so that on loading we can resume with
-    // good load balance
-    int num_local_rows = (int)(t->GetNumRowsOfBoxes());
-    std::vector<int> num_rows(PetscTools::GetNumProcs());
-    MPI_Gather(&num_local_rows, 1, MPI_INT, &num_rows[0], 1, MPI_INT, 0, PETSC_COMM_WORLD);
-    
-    if (PetscTools::AmMaster())
-    {
-        bool are_boxes_set = t->GetAreLocalBoxesSet();
-        ar << are_boxes_set;
+    bool are_boxes_set = t->GetAreLocalBoxesSet();
+    ar << are_boxes_set;
 
-        c_vector<double, 2*DIM> domain_size = t->rGetDomainSize();
-        for (unsigned i=0; i<2*DIM; i++)
-        {
-            ar << domain_size[i];
-        }
+    c_vector<double, 2*DIM> domain_size = t->rGetDomainSize();
+    for (unsigned i=0; i<2*DIM; i++)
+    {
+        ar << domain_size[i];
+    }
 
-        double box_width = t->GetBoxWidth();
-        ar << box_width;
+    double box_width = t->GetBoxWidth();
+    ar << box_width;
 
-        unsigned num_procs = PetscTools::GetNumProcs();
-        ar << num_procs;
+    unsigned num_procs = PetscTools::GetNumProcs();
+    ar << num_procs;
 
-        std::vector<int> const const_num_rows = num_rows; 
-        ar << const_num_rows;
+    // Save the process grid and the boxes owned by each slab of processes, so that on loading
+    // we can resume with good load balance
+    c_vector<unsigned, DIM> num_procs_each_direction = t->GetNumProcessesEachDirection();
+    for (unsigned i=0; i<DIM; i++)
+    {
+        ar << num_procs_each_direction[i];
     }
+
+    std::vector<std::vector<unsigned> > const boundaries = t->rGetProcessBoxBoundaries();
+    ar << boundaries;
 }
+
 /**
  * De-serialize constructor parameters and initialize a DistributedBoxCollection.
  */
@@ -452,16 +756,52 @@ inline void load_construct_data(
     unsigned num_original_procs;
     ar >> num_original_procs;
 
-    int num_rows = PETSC_DECIDE;
-    std::vector<int> original_rows;
-    ar >> original_rows;
-    if (num_original_procs == PetscTools::GetNumProcs())
+    if (file_version == 0)
     {
-        num_rows = original_rows[PetscTools::GetMyRank()];
+        // Older archives were always split into strips, and saved the number of rows on each process
+        int num_rows = PETSC_DECIDE;
+        std::vector<int> original_rows;
+        ar >> original_rows;
+        if (num_original_procs == PetscTools::GetNumProcs())
+        {
+            num_rows = original_rows[PetscTools::GetMyRank()];
+        }
+
+        // Invoke inplace constructor to initialise instance. Assume non-periodic
+        ::new(t)DistributedBoxCollection<DIM>(cut_off, domain_size, false, num_rows);
     }
+    else
+    {
+        c_vector<unsigned, DIM> num_procs_each_direction;
+        bool is_strip_decomposition = true;
+        for (unsigned i=0; i<DIM; i++)
+        {
+            ar >> num_procs_each_direction[i];
+            if (i < DIM-1 && num_procs_each_direction[i] > 1)
+            {
+                is_strip_decomposition = false;
+            }
+        }
+
+        std::vector<std::vector<unsigned> > boundaries;
+        ar >> boundaries;
 
-    // Invoke inplace constructor to initialise instance. Assume non-periodic
-    ::new(t)DistributedBoxCollection<DIM>(cut_off, domain_size, false, num_rows);
+        // Invoke inplace constructor to initialise instance. Assume non-periodic
+        if (num_original_procs == PetscTools::GetNumProcs())
+        {
+            ::new(t)DistributedBoxCollection<DIM>(cut_off, domain_size, num_procs_each_direction, boundaries);
+        }
+        else if (is_strip_decomposition)
+        {
+            ::new(t)DistributedBoxCollection<DIM>(cut_off, domain_size, false, PETSC_DECIDE);
+        }
+        else
+        {
+            // Choose a new process grid for the new number of processes
+            c_vector<unsigned, DIM> new_num_procs_each_direction = scalar_vector<unsigned>(DIM, 0u);
+            ::new(t)DistributedBoxCollection<DIM>(cut_off, domain_size, new_num_procs_each_direction);
+        }
+    }
 
     if (are_boxes_set)
     {
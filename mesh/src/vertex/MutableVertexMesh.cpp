@@ -38,6 +38,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Warnings.hpp"
 #include "LogFile.hpp"
 
+#include <cfloat>
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::MutableVertexMesh(std::vector<Node<SPACE_DIM>*> nodes,
                                                std::vector<VertexElement<ELEMENT_DIM,SPACE_DIM>*> vertexElements,
@@ -262,6 +264,8 @@ unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::AddElement(VertexElement<ELE
         this->mElements[new_element_index] = pNewElement;
     }
     pNewElement->RegisterWithNodes();
+    this->InvalidateElementGeometry(new_element_index);
+
     return pNewElement->GetIndex();
 }
 
@@ -269,6 +273,7 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::SetNode(unsigned nodeIndex, ChastePoint<SPACE_DIM> point)
 {
     this->mNodes[nodeIndex]->SetPoint(point);
+    this->InvalidateGeometryOfElementsContainingNode(nodeIndex);
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -593,6 +598,9 @@ unsigned MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DivideElement(VertexElement<
         }
     }
 
+    this->InvalidateElementGeometry(pElement->GetIndex());
+    this->InvalidateElementGeometry(new_element_index);
+
     return new_element_index;
 }
 
@@ -618,6 +626,7 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DeleteElementPriorToReMesh(unsig
     // Mark this element as deleted
     this->mElements[index]->MarkAsDeleted();
     mDeletedElementIndices.push_back(index);
+    this->InvalidateElementGeometry(index);
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -700,6 +709,7 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::DivideEdge(Node<SPACE_DIM>* pNod
 
         // Add new node to this element
         this->GetElement(*iter)->AddNode(p_new_node, index);
+        this->InvalidateElementGeometry(*iter);
     }
 }
 
@@ -738,6 +748,9 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::RemoveDeletedNodesAndElements(Ve
         this->mElements[i]->ResetIndex(i);
     }
 
+    // Element indices may have changed, so the cached element geometry is no longer valid
+    this->InvalidateElementGeometryCache();
+
     // Remove deleted nodes
     RemoveDeletedNodes();
 }
@@ -806,6 +819,9 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::ReMesh(VertexElementMap& rElemen
         }
 
         RemoveDeletedNodes();
+
+        // Any rearrangement above may have changed the geometry of an element
+        this->InvalidateElementGeometryCache();
     }
     else // 3D
     {
@@ -914,75 +930,289 @@ bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForT2Swaps(VertexElementMap
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 bool MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::CheckForIntersections()
 {
-    // If checking for internal intersections as well as on the boundary, then check that no nodes have overlapped any elements...
-    if (mCheckForInternalIntersections)
+    /*
+     * If checking for internal intersections as well as on the boundary, then check that no nodes
+     * have overlapped any elements; otherwise, just check that no boundary nodes have overlapped
+     * any boundary elements.
+     */
+    std::vector<std::pair<unsigned, unsigned> > candidates;
+    FindIntersectionCandidates(!mCheckForInternalIntersections, candidates);
+
+    /*
+     * Resolve as many of the intersections as possible in this pass. A swap only changes the
+     * elements around the overlapped element and the intersecting node, so we record these and
+     * leave any other intersection involving them to the next pass, when it will be found again
+     * if it still exists.
+     */
+    std::set<unsigned> modified_element_indices;
+    bool swap_performed = false;
+    for (unsigned i=0; i<candidates.size(); i++)
     {
-        ///\todo Change to only loop over neighbouring elements (see #2401)
-        for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
-             node_iter != this->GetNodeIteratorEnd();
-             ++node_iter)
+        Node<SPACE_DIM>* p_node = this->GetNode(candidates[i].first);
+        unsigned elem_index = candidates[i].second;
+
+        if (p_node->IsDeleted() || modified_element_indices.count(elem_index) > 0)
+        {
+            continue;
+        }
+        std::set<unsigned> node_elem_indices = p_node->rGetContainingElementIndices();
+        bool node_affected = false;
+        for (std::set<unsigned>::iterator iter = node_elem_indices.begin();
+             iter != node_elem_indices.end();
+             ++iter)
         {
-            assert(!(node_iter->IsDeleted()));
+            if (modified_element_indices.count(*iter) > 0)
+            {
+                node_affected = true;
+                break;
+            }
+        }
+        if (node_affected)
+        {
+            continue;
+        }
 
-            for (typename VertexMesh<ELEMENT_DIM, SPACE_DIM>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
-                 elem_iter != this->GetElementIteratorEnd();
-                 ++elem_iter)
+        // Record every element sharing a node with the overlapped element or the node's elements
+        node_elem_indices.insert(elem_index);
+        for (std::set<unsigned>::iterator iter = node_elem_indices.begin();
+             iter != node_elem_indices.end();
+             ++iter)
+        {
+            VertexElement<ELEMENT_DIM, SPACE_DIM>* p_element = this->GetElement(*iter);
+            for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
             {
-                unsigned elem_index = elem_iter->GetIndex();
+                const std::set<unsigned>& r_elem_indices = p_element->GetNode(local_index)->rGetContainingElementIndices();
+                modified_element_indices.insert(r_elem_indices.begin(), r_elem_indices.end());
+            }
+        }
 
-                // Check that the node is not part of this element
-                if (node_iter->rGetContainingElementIndices().count(elem_index) == 0)
+        if (mCheckForInternalIntersections)
+        {
+            PerformIntersectionSwap(p_node, elem_index);
+        }
+        else
+        {
+            PerformT3Swap(p_node, elem_index);
+        }
+        swap_performed = true;
+    }
+
+    return swap_performed;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::FindIntersectionCandidates(bool boundaryOnly,
+                                                                           std::vector<std::pair<unsigned, unsigned> >& rCandidates)
+{
+    rCandidates.clear();
+
+    // Compute the bounding box of each element to be checked
+    std::vector<unsigned> element_indices;
+    std::vector<c_vector<double, SPACE_DIM> > lower_corners;
+    std::vector<c_vector<double, SPACE_DIM> > upper_corners;
+    double total_extent = 0.0;
+    unsigned num_finite_extents = 0;
+
+    for (typename VertexMesh<ELEMENT_DIM, SPACE_DIM>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
+         elem_iter != this->GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        if (boundaryOnly && !elem_iter->IsElementOnBoundary())
+        {
+            continue;
+        }
+
+        /*
+         * Nodes are located relative to the first vertex using GetVectorFromAtoB(), as in
+         * ElementIncludesPoint(). If this differs from a node's stored location then the element
+         * crosses a periodic boundary, and in that dimension it may contain points anywhere.
+         */
+        c_vector<double, SPACE_DIM> first_vertex = elem_iter->GetNodeLocation(0);
+        c_vector<double, SPACE_DIM> lower = first_vertex;
+        c_vector<double, SPACE_DIM> upper = first_vertex;
+        std::vector<bool> is_periodic(SPACE_DIM, false);
+        for (unsigned local_index=1; local_index<elem_iter->GetNumNodes(); local_index++)
+        {
+            const c_vector<double, SPACE_DIM>& r_location = elem_iter->GetNodeLocation(local_index);
+            c_vector<double, SPACE_DIM> location = first_vertex + this->GetVectorFromAtoB(first_vertex, r_location);
+            for (unsigned d=0; d<SPACE_DIM; d++)
+            {
+                lower[d] = std::min(lower[d], location[d]);
+                upper[d] = std::max(upper[d], location[d]);
+                if (fabs(location[d] - r_location[d]) > 1e-10*(1.0 + fabs(r_location[d])))
                 {
-                    if (this->ElementIncludesPoint(node_iter->rGetLocation(), elem_index))
-                    {
-                        PerformIntersectionSwap(&(*node_iter), elem_index);
-                        return true;
-                    }
+                    is_periodic[d] = true;
                 }
             }
         }
+
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            if (is_periodic[d])
+            {
+                lower[d] = -DBL_MAX;
+                upper[d] = DBL_MAX;
+            }
+            else
+            {
+                total_extent += upper[d] - lower[d];
+                num_finite_extents++;
+            }
+        }
+
+        element_indices.push_back(elem_iter->GetIndex());
+        lower_corners.push_back(lower);
+        upper_corners.push_back(upper);
     }
-    else
+
+    // Find the nodes to be checked and the region they occupy
+    std::vector<unsigned> node_indices;
+    c_vector<double, SPACE_DIM> grid_min = zero_vector<double>(SPACE_DIM);
+    c_vector<double, SPACE_DIM> grid_max = zero_vector<double>(SPACE_DIM);
+    for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
+         node_iter != this->GetNodeIteratorEnd();
+         ++node_iter)
     {
-        // ...otherwise, just check that no boundary nodes have overlapped any boundary elements
-        std::set<unsigned> boundary_element_indices;
-        for (typename VertexMesh<ELEMENT_DIM, SPACE_DIM>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
-             elem_iter != this->GetElementIteratorEnd();
-             ++elem_iter)
+        assert(!(node_iter->IsDeleted()));
+        if (boundaryOnly && !node_iter->IsBoundaryNode())
+        {
+            continue;
+        }
+
+        const c_vector<double, SPACE_DIM>& r_location = node_iter->rGetLocation();
+        for (unsigned d=0; d<SPACE_DIM; d++)
         {
-            if (elem_iter->IsElementOnBoundary())
+            grid_min[d] = node_indices.empty() ? r_location[d] : std::min(grid_min[d], r_location[d]);
+            grid_max[d] = node_indices.empty() ? r_location[d] : std::max(grid_max[d], r_location[d]);
+        }
+        node_indices.push_back(node_iter->GetIndex());
+    }
+
+    if (element_indices.empty() || node_indices.empty())
+    {
+        return;
+    }
+
+    /*
+     * Set up a uniform grid over the nodes with a spacing of about one element, and store each
+     * element in every grid cell that its bounding box overlaps. The spacing is increased if
+     * needed so that there are not many more grid cells than elements.
+     */
+    double spacing = (num_finite_extents > 0) ? total_extent/num_finite_extents : 0.0;
+    for (unsigned d=0; d<SPACE_DIM; d++)
+    {
+        spacing = std::max(spacing, 1e-3*(grid_max[d] - grid_min[d]));
+    }
+    if (spacing <= 0.0)
+    {
+        spacing = 1.0;
+    }
+
+    c_vector<unsigned, SPACE_DIM> num_cells;
+    unsigned total_num_cells;
+    while (true)
+    {
+        total_num_cells = 1;
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            num_cells[d] = (unsigned) floor((grid_max[d] - grid_min[d])/spacing) + 1;
+            total_num_cells *= num_cells[d];
+        }
+        if (total_num_cells <= 4*element_indices.size() + 16)
+        {
+            break;
+        }
+        spacing *= 2.0;
+    }
+
+    std::vector<std::vector<unsigned> > grid_cell_elements(total_num_cells);
+    for (unsigned i=0; i<element_indices.size(); i++)
+    {
+        // Find the range of grid cells overlapped by this element, clamped to the grid
+        c_vector<unsigned, SPACE_DIM> first_cell;
+        c_vector<unsigned, SPACE_DIM> last_cell;
+        for (unsigned d=0; d<SPACE_DIM; d++)
+        {
+            double lower = std::max(lower_corners[i][d], grid_min[d]);
+            double upper = std::min(upper_corners[i][d], grid_max[d]);
+            first_cell[d] = std::min((unsigned) floor(std::max(0.0, (lower - grid_min[d])/spacing)), num_cells[d]-1);
+            last_cell[d] = std::min((unsigned) floor(std::max(0.0, (upper - grid_min[d])/spacing)), num_cells[d]-1);
+            if (upper_corners[i][d] < grid_min[d] || lower_corners[i][d] > grid_max[d])
             {
-                boundary_element_indices.insert(elem_iter->GetIndex());
+                // The element can't contain any of the nodes
+                last_cell[d] = UNSIGNED_UNSET;
             }
         }
 
-        for (typename AbstractMesh<ELEMENT_DIM,SPACE_DIM>::NodeIterator node_iter = this->GetNodeIteratorBegin();
-             node_iter != this->GetNodeIteratorEnd();
-             ++node_iter)
+        bool overlaps_grid = true;
+        for (unsigned d=0; d<SPACE_DIM; d++)
         {
-            if (node_iter->IsBoundaryNode())
+            overlaps_grid = overlaps_grid && (last_cell[d] != UNSIGNED_UNSET);
+        }
+        if (!overlaps_grid)
+        {
+            continue;
+        }
+
+        // Loop over the cells in the range, with the lowest dimension varying fastest
+        c_vector<unsigned, SPACE_DIM> cell = first_cell;
+        while (true)
+        {
+            unsigned cell_index = 0;
+            for (unsigned d=SPACE_DIM; d>0; d--)
             {
-                assert(!(node_iter->IsDeleted()));
+                cell_index = cell_index*num_cells[d-1] + cell[d-1];
+            }
+            grid_cell_elements[cell_index].push_back(i);
 
-                for (std::set<unsigned>::iterator elem_iter = boundary_element_indices.begin();
-                     elem_iter != boundary_element_indices.end();
-                     ++elem_iter)
-                {
-                    // Check that the node is not part of this element
-                    if (node_iter->rGetContainingElementIndices().count(*elem_iter) == 0)
-                    {
-                        if (this->ElementIncludesPoint(node_iter->rGetLocation(), *elem_iter))
-                        {
-                            PerformT3Swap(&(*node_iter), *elem_iter);
-                            return true;
-                        }
-                    }
-                }
+            unsigned d = 0;
+            while (d<SPACE_DIM && cell[d] == last_cell[d])
+            {
+                cell[d] = first_cell[d];
+                d++;
             }
+            if (d == SPACE_DIM)
+            {
+                break;
+            }
+            cell[d]++;
         }
     }
 
-    return false;
+    // Test each node against the elements stored in its grid cell, which are in increasing index order
+    for (unsigned i=0; i<node_indices.size(); i++)
+    {
+        Node<SPACE_DIM>* p_node = this->GetNode(node_indices[i]);
+        const c_vector<double, SPACE_DIM>& r_location = p_node->rGetLocation();
+
+        unsigned cell_index = 0;
+        for (unsigned d=SPACE_DIM; d>0; d--)
+        {
+            unsigned cell = std::min((unsigned) floor((r_location[d-1] - grid_min[d-1])/spacing), num_cells[d-1]-1);
+            cell_index = cell_index*num_cells[d-1] + cell;
+        }
+
+        const std::vector<unsigned>& r_cell_elements = grid_cell_elements[cell_index];
+        for (unsigned j=0; j<r_cell_elements.size(); j++)
+        {
+            unsigned k = r_cell_elements[j];
+
+            bool in_bounding_box = true;
+            for (unsigned d=0; d<SPACE_DIM; d++)
+            {
+                in_bounding_box = in_bounding_box && (r_location[d] >= lower_corners[k][d]) && (r_location[d] <= upper_corners[k][d]);
+            }
+
+            // Check that the node is not part of this element
+            if (in_bounding_box
+                && p_node->rGetContainingElementIndices().count(element_indices[k]) == 0
+                && this->ElementIncludesPoint(r_location, element_indices[k]))
+            {
+                rCandidates.push_back(std::make_pair(node_indices[i], element_indices[k]));
+                break;
+            }
+        }
+    }
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1692,6 +1922,9 @@ void MutableVertexMesh<ELEMENT_DIM, SPACE_DIM>::PerformT2Swap(VertexElement<ELEM
 
     mDeletedElementIndices.push_back(rElement.GetIndex());
     rElement.MarkAsDeleted();
+
+    // The neighbouring elements have all been rearranged
+    this->InvalidateElementGeometryCache();
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
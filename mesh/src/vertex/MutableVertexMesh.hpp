@@ -146,10 +146,25 @@ protected:
      * Check if any elements have become intersected and correct this by implementing the appropriate
      * local remeshing operation (a T3 swap or node merge).
      *
+     * All intersections found in one pass that do not share elements are resolved in that pass.
+     *
      * @return whether to recheck the mesh again
      */
     bool CheckForIntersections();
 
+    /**
+     * Helper method for CheckForIntersections().
+     *
+     * Find the nodes that overlap an element not containing them. The elements' bounding boxes are
+     * stored in a uniform grid of about one element's width, so each node is only tested against
+     * the elements near it and the cost is roughly linear in the size of the mesh.
+     *
+     * @param boundaryOnly whether to check only boundary nodes against boundary elements
+     * @param rCandidates filled with pairs of (node index, element index), in node index order,
+     *                    giving the lowest-indexed element overlapped by each node
+     */
+    void FindIntersectionCandidates(bool boundaryOnly, std::vector<std::pair<unsigned, unsigned> >& rCandidates);
+
     /**
      * Helper method for ReMesh(), called by CheckForT1Swaps().
      *
@@ -573,6 +573,8 @@ void VertexMesh<ELEMENT_DIM, SPACE_DIM>::Clear()
     }
     mFaces.clear();
 
+    InvalidateElementGeometryCache();
+
     // Delete nodes
     for (unsigned i=0; i<this->mNodes.size(); i++)
     {
@@ -1476,6 +1478,146 @@ c_vector<double, SPACE_DIM> VertexMesh<ELEMENT_DIM, SPACE_DIM>::GetPerimeterGrad
 }
 
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void VertexMesh<ELEMENT_DIM, SPACE_DIM>::ResizeElementGeometryCache(unsigned index)
+{
+    if (index >= mElementVolumeIsCached.size())
+    {
+        unsigned new_size = std::max((unsigned)mElements.size(), index+1);
+        mCachedElementVolumes.resize(new_size);
+        mCachedElementSurfaceAreas.resize(new_size);
+        mCachedElementCentroids.resize(new_size, zero_vector<double>(SPACE_DIM));
+        mCachedElementEdgeLengths.resize(new_size);
+        mElementVolumeIsCached.resize(new_size, false);
+        mElementSurfaceAreaIsCached.resize(new_size, false);
+        mElementCentroidIsCached.resize(new_size, false);
+        mElementEdgeLengthsAreCached.resize(new_size, false);
+    }
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double VertexMesh<ELEMENT_DIM, SPACE_DIM>::GetCachedVolumeOfElement(unsigned index)
+{
+    ResizeElementGeometryCache(index);
+    if (!mElementVolumeIsCached[index])
+    {
+        mCachedElementVolumes[index] = GetVolumeOfElement(index);
+        mElementVolumeIsCached[index] = true;
+    }
+    return mCachedElementVolumes[index];
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double VertexMesh<ELEMENT_DIM, SPACE_DIM>::GetCachedSurfaceAreaOfElement(unsigned index)
+{
+    ResizeElementGeometryCache(index);
+    if (!mElementSurfaceAreaIsCached[index])
+    {
+        if (ELEMENT_DIM == 2)
+        {
+            // The perimeter of a polygon is the sum of its (cached) edge lengths
+            const std::vector<double>& r_edge_lengths = rGetCachedEdgeLengthsOfElement(index);
+            double perimeter = 0.0;
+            for (unsigned i=0; i<r_edge_lengths.size(); i++)
+            {
+                perimeter += r_edge_lengths[i];
+            }
+            mCachedElementSurfaceAreas[index] = perimeter;
+        }
+        else
+        {
+            mCachedElementSurfaceAreas[index] = GetSurfaceAreaOfElement(index);
+        }
+        mElementSurfaceAreaIsCached[index] = true;
+    }
+    return mCachedElementSurfaceAreas[index];
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+c_vector<double, SPACE_DIM> VertexMesh<ELEMENT_DIM, SPACE_DIM>::GetCachedCentroidOfElement(unsigned index)
+{
+    ResizeElementGeometryCache(index);
+    if (!mElementCentroidIsCached[index])
+    {
+        mCachedElementCentroids[index] = GetCentroidOfElement(index);
+        mElementCentroidIsCached[index] = true;
+    }
+    return mCachedElementCentroids[index];
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+const std::vector<double>& VertexMesh<ELEMENT_DIM, SPACE_DIM>::rGetCachedEdgeLengthsOfElement(unsigned index)
+{
+    assert(ELEMENT_DIM == 2);
+
+    ResizeElementGeometryCache(index);
+    if (!mElementEdgeLengthsAreCached[index])
+    {
+        VertexElement<ELEMENT_DIM, SPACE_DIM>* p_element = GetElement(index);
+        unsigned num_nodes = p_element->GetNumNodes();
+
+        std::vector<double>& r_edge_lengths = mCachedElementEdgeLengths[index];
+        r_edge_lengths.resize(num_nodes);
+
+        unsigned this_node_index = p_element->GetNodeGlobalIndex(0);
+        for (unsigned local_index=0; local_index<num_nodes; local_index++)
+        {
+            unsigned next_node_index = p_element->GetNodeGlobalIndex((local_index+1)%num_nodes);
+            r_edge_lengths[local_index] = this->GetDistanceBetweenNodes(this_node_index, next_node_index);
+            this_node_index = next_node_index;
+        }
+        mElementEdgeLengthsAreCached[index] = true;
+    }
+    return mCachedElementEdgeLengths[index];
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void VertexMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateElementGeometry(unsigned index)
+{
+    if (index < mElementVolumeIsCached.size())
+    {
+        mElementVolumeIsCached[index] = false;
+        mElementSurfaceAreaIsCached[index] = false;
+        mElementCentroidIsCached[index] = false;
+        mElementEdgeLengthsAreCached[index] = false;
+    }
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void VertexMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateGeometryOfElementsContainingNode(unsigned nodeIndex)
+{
+    const std::set<unsigned>& r_containing_elements = this->mNodes[nodeIndex]->rGetContainingElementIndices();
+    for (std::set<unsigned>::const_iterator iter = r_containing_elements.begin();
+         iter != r_containing_elements.end();
+         ++iter)
+    {
+        InvalidateElementGeometry(*iter);
+    }
+}
+
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void VertexMesh<ELEMENT_DIM, SPACE_DIM>::InvalidateElementGeometryCache()
+{
+    mElementVolumeIsCached.assign(mElementVolumeIsCached.size(), false);
+    mElementSurfaceAreaIsCached.assign(mElementSurfaceAreaIsCached.size(), false);
+    mElementCentroidIsCached.assign(mElementCentroidIsCached.size(), false);
+    mElementEdgeLengthsAreCached.assign(mElementEdgeLengthsAreCached.size(), false);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void VertexMesh<ELEMENT_DIM, SPACE_DIM>::RefreshMesh()
+{
+    InvalidateElementGeometryCache();
+}
+
+
 //////////////////////////////////////////////////////////////////////
 //                        3D-specific methods                       //
 //////////////////////////////////////////////////////////////////////
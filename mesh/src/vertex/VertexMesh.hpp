@@ -101,6 +101,41 @@ protected:
      */
     TetrahedralMesh<ELEMENT_DIM, SPACE_DIM>* mpDelaunayMesh;
 
+    /** Cached volume (or area in 2D) of each element, indexed by element index. */
+    std::vector<double> mCachedElementVolumes;
+
+    /** Cached surface area (or perimeter in 2D) of each element, indexed by element index. */
+    std::vector<double> mCachedElementSurfaceAreas;
+
+    /** Cached centroid of each element, indexed by element index. */
+    std::vector<c_vector<double, SPACE_DIM> > mCachedElementCentroids;
+
+    /**
+     * Cached edge lengths of each 2D element, indexed by element index. The ith entry
+     * for an element is the length of the edge from its ith node to its (i+1)th node.
+     */
+    std::vector<std::vector<double> > mCachedElementEdgeLengths;
+
+    /** Whether each entry of mCachedElementVolumes is up to date. */
+    std::vector<bool> mElementVolumeIsCached;
+
+    /** Whether each entry of mCachedElementSurfaceAreas is up to date. */
+    std::vector<bool> mElementSurfaceAreaIsCached;
+
+    /** Whether each entry of mCachedElementCentroids is up to date. */
+    std::vector<bool> mElementCentroidIsCached;
+
+    /** Whether each entry of mCachedElementEdgeLengths is up to date. */
+    std::vector<bool> mElementEdgeLengthsAreCached;
+
+    /**
+     * Make sure that the element geometry cache has an entry for the element
+     * with a given index, enlarging the cache if required.
+     *
+     * @param index  the global index of a specified vertex element
+     */
+    void ResizeElementGeometryCache(unsigned index);
+
     /**
      * Solve node mapping method. This overridden method is required
      * as it is pure virtual in the base class.
@@ -441,6 +476,77 @@ public:
      */
     c_vector<double, SPACE_DIM> GetPerimeterGradientOfElementAtNode(VertexElement<ELEMENT_DIM,SPACE_DIM>* pElement, unsigned localIndex);
 
+    /**
+     * Get the volume (or area in 2D) of an element, using the element geometry cache.
+     *
+     * The value is computed by GetVolumeOfElement() the first time it is requested
+     * and reused until the element is invalidated, which happens when one of its nodes
+     * is moved by SetNode() or the element is rearranged by a mutable mesh. Code that
+     * moves nodes directly through Node::rGetModifiableLocation() must call
+     * InvalidateGeometryOfElementsContainingNode() or InvalidateElementGeometryCache().
+     *
+     * @param index  the global index of a specified vertex element
+     *
+     * @return the volume of the element
+     */
+    double GetCachedVolumeOfElement(unsigned index);
+
+    /**
+     * Get the surface area (or perimeter in 2D) of an element, using the element
+     * geometry cache. See GetCachedVolumeOfElement().
+     *
+     * @param index  the global index of a specified vertex element
+     *
+     * @return the surface area of the element
+     */
+    double GetCachedSurfaceAreaOfElement(unsigned index);
+
+    /**
+     * Get the centroid of an element, using the element geometry cache.
+     * See GetCachedVolumeOfElement().
+     *
+     * @param index  the global index of a specified vertex element
+     *
+     * @return the centroid of the element
+     */
+    c_vector<double, SPACE_DIM> GetCachedCentroidOfElement(unsigned index);
+
+    /**
+     * Get the edge lengths of a 2D element, using the element geometry cache.
+     * See GetCachedVolumeOfElement().
+     *
+     * @param index  the global index of a specified vertex element
+     *
+     * @return the lengths of the edges of the element, the ith entry being the length
+     *     of the edge from its ith node to its (i+1)th node
+     */
+    const std::vector<double>& rGetCachedEdgeLengthsOfElement(unsigned index);
+
+    /**
+     * Mark the cached geometry of an element as out of date.
+     *
+     * @param index  the global index of a specified vertex element
+     */
+    void InvalidateElementGeometry(unsigned index);
+
+    /**
+     * Mark the cached geometry of every element containing a given node as out of date.
+     *
+     * @param nodeIndex  the global index of a specified node
+     */
+    void InvalidateGeometryOfElementsContainingNode(unsigned nodeIndex);
+
+    /**
+     * Mark the cached geometry of every element as out of date.
+     */
+    void InvalidateElementGeometryCache();
+
+    /**
+     * Overridden RefreshMesh() method. This is called when the whole mesh is moved by
+     * Scale(), Translate() or Rotate(), so calls InvalidateElementGeometryCache().
+     */
+    void RefreshMesh();
+
     /**
      * Compute the second moments and product moment of area for a given 2D element
      * about its centroid. These are:
@@ -1201,6 +1201,7 @@ public:
 
             NodeMap map(p_mesh->GetNumNodes());
             static_cast<MutableMesh<2,2>* >(p_mesh)->ReMesh(map);
+            static_cast<MutableMesh<2,2>* >(p_mesh)->SetUseIncrementalReMesh(true);
 
             // Record values to test
             for (MutableMesh<2,2>::NodeIterator it = static_cast<MutableMesh<2,2>* >(p_mesh)->GetNodeIteratorBegin();
@@ -1247,6 +1248,8 @@ public:
             TS_ASSERT_EQUALS(num_elements, p_mesh2->GetNumElements());
             TS_ASSERT_EQUALS(total_num_nodes, p_mesh2->GetNumAllNodes());
             TS_ASSERT_EQUALS(total_num_elements, p_mesh2->GetNumAllElements());
+            MutableMesh<2,2>* p_mutable_mesh2 = static_cast<MutableMesh<2,2>* >(p_mesh2);
+            TS_ASSERT_EQUALS(p_mutable_mesh2->GetUseIncrementalReMesh(), true);
 
             // Test recorded node locations
             unsigned counter = 0;
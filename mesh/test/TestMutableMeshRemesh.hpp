@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cxxtest/TestSuite.h>
 #include <cmath>
+#include <set>
 #include "MutableMesh.hpp"
 #include "TrianglesMeshReader.hpp"
 
@@ -56,6 +57,38 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class TestMutableMeshRemesh : public CxxTest::TestSuite
 {
+private:
+
+    /** @return the edges of a 2D mesh as ordered pairs of node indices */
+    std::set<std::pair<unsigned, unsigned> > GetEdges(MutableMesh<2,2>& rMesh)
+    {
+        std::set<std::pair<unsigned, unsigned> > edges;
+        for (MutableMesh<2,2>::ElementIterator iter = rMesh.GetElementIteratorBegin();
+             iter != rMesh.GetElementIteratorEnd();
+             ++iter)
+        {
+            for (unsigned i=0; i<3; i++)
+            {
+                unsigned node_a = iter->GetNodeGlobalIndex(i);
+                unsigned node_b = iter->GetNodeGlobalIndex((i+1)%3);
+                edges.insert(std::make_pair(std::min(node_a, node_b), std::max(node_a, node_b)));
+            }
+        }
+        return edges;
+    }
+
+    /** @return the edges of a mesh built from scratch by triangle on the nodes of the given mesh */
+    std::set<std::pair<unsigned, unsigned> > GetEdgesOfFullReMesh(MutableMesh<2,2>& rMesh)
+    {
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<rMesh.GetNumNodes(); i++)
+        {
+            nodes.push_back(new Node<2>(i, rMesh.GetNode(i)->rGetLocation(), false));
+        }
+        MutableMesh<2,2> full_mesh(nodes);
+        return GetEdges(full_mesh);
+    }
+
 public:
 
     /**
@@ -349,6 +382,12 @@ public:
         MutableMesh<3,3> mesh(nodes);
         double area = mesh.GetVolume();
 
+        // 3D meshes are always remeshed in full
+        TS_ASSERT_THROWS_THIS(mesh.SetUseIncrementalReMesh(true),
+                              "Incremental remeshing is only implemented for 2D meshes.");
+        mesh.SetUseIncrementalReMesh(false);
+        TS_ASSERT_EQUALS(mesh.GetUseIncrementalReMesh(), false);
+
         unsigned num_nodes_before = mesh.GetNumNodes();
         unsigned num_elements_before = mesh.GetNumElements();
         unsigned num_boundary_elements_before = mesh.GetNumBoundaryElements();
@@ -879,6 +918,93 @@ public:
             TS_ASSERT_EQUALS(changeHistory[4][4], UNSIGNED_UNSET);
         }
     }
+
+    void TestIncrementalReMesh2d() throw (Exception)
+    {
+        // Jittered square lattice of nodes, with a square boundary
+        std::vector<Node<2>*> nodes;
+        for (unsigned j=0; j<10; j++)
+        {
+            for (unsigned i=0; i<10; i++)
+            {
+                double x = i;
+                double y = j;
+                if (i>0 && i<9 && j>0 && j<9)
+                {
+                    x += 0.2*sin(1.3*i + 2.1*j);
+                    y += 0.2*cos(0.7*i + 1.9*j);
+                }
+                nodes.push_back(new Node<2>(nodes.size(), i==0 || i==9 || j==0 || j==9, x, y));
+            }
+        }
+        MutableMesh<2,2> mesh(nodes);
+        TS_ASSERT_EQUALS(mesh.GetUseIncrementalReMesh(), false);
+        mesh.SetUseIncrementalReMesh(true);
+        TS_ASSERT_EQUALS(mesh.GetUseIncrementalReMesh(), true);
+
+        unsigned num_elements = mesh.GetNumElements();
+        Node<2>* p_node_11 = mesh.GetNode(11);
+
+        // Move the interior nodes so that some edges are no longer Delaunay
+        for (unsigned index=0; index<mesh.GetNumNodes(); index++)
+        {
+            Node<2>* p_node = mesh.GetNode(index);
+            if (!p_node->IsBoundaryNode())
+            {
+                p_node->rGetModifiableLocation()[0] += 0.3*sin(3.7*index);
+                p_node->rGetModifiableLocation()[1] += 0.3*cos(2.3*index);
+            }
+        }
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), false);
+
+        NodeMap map(mesh.GetNumNodes());
+        mesh.ReMesh(map);
+        TS_ASSERT(map.IsIdentityMap());
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), num_elements);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+        TS_ASSERT(GetEdges(mesh) == GetEdgesOfFullReMesh(mesh));
+
+        // The mesh was repaired rather than rebuilt, so the nodes are the same objects
+        TS_ASSERT_EQUALS(mesh.GetNode(11), p_node_11);
+
+        // Add two nodes and delete two others, as for cell division and death
+        mesh.DeleteNodePriorToReMesh(23);
+        mesh.DeleteNodePriorToReMesh(24);
+        unsigned new_index = mesh.AddNode(new Node<2>(0, false, 4.51, 5.47));
+        TS_ASSERT_EQUALS(new_index, 100u);
+        mesh.AddNode(new Node<2>(0, false, 6.23, 2.61));
+
+        NodeMap map2(mesh.GetNumAllNodes());
+        mesh.ReMesh(map2);
+        TS_ASSERT_EQUALS(mesh.GetNumNodes(), 100u);
+        TS_ASSERT_EQUALS(mesh.GetNumAllNodes(), 100u);
+        TS_ASSERT_EQUALS(mesh.GetNumElements(), num_elements);
+        TS_ASSERT_EQUALS(mesh.GetNumAllElements(), num_elements);
+        TS_ASSERT(map2.IsDeleted(23));
+        TS_ASSERT(map2.IsDeleted(24));
+        TS_ASSERT_EQUALS(map2.GetNewIndex(25), 23u);
+        TS_ASSERT_EQUALS(map2.GetNewIndex(100), 98u);
+        TS_ASSERT_DELTA(mesh.GetNode(98)->rGetLocation()[0], 4.51, 1e-12);
+        TS_ASSERT_EQUALS(mesh.GetNode(11), p_node_11);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+        TS_ASSERT(GetEdges(mesh) == GetEdgesOfFullReMesh(mesh));
+
+        // The elements still cover the square and are numbered consecutively
+        TS_ASSERT_DELTA(mesh.GetVolume(), 81.0, 1e-9);
+        for (unsigned elem_index=0; elem_index<mesh.GetNumElements(); elem_index++)
+        {
+            TS_ASSERT_EQUALS(mesh.GetElement(elem_index)->GetIndex(), elem_index);
+        }
+
+        // Moving a boundary node inwards makes the boundary non-convex, so the mesh is rebuilt
+        mesh.GetNode(5)->rGetModifiableLocation()[1] = 0.2;
+        NodeMap map3(mesh.GetNumAllNodes());
+        mesh.ReMesh(map3);
+        TS_ASSERT(map3.IsIdentityMap());
+        TS_ASSERT(mesh.GetNode(11) != p_node_11);
+        TS_ASSERT_EQUALS(mesh.CheckIsVoronoi(), true);
+        TS_ASSERT(GetEdges(mesh) == GetEdgesOfFullReMesh(mesh));
+    }
 };
 
 #endif /*TESTMUTABLEMESHREMESH_HPP_*/
@@ -959,6 +959,102 @@ public:
             }
         }
     }
+
+    void TestLoadBalanceMeshWithCartesianDecomposition()  throw (Exception)
+    {
+        // Test designed for np=2
+        if (PetscTools::GetNumProcs() == 2)
+        {
+            std::vector<Node<2>*> nodes;
+            nodes.push_back(new Node<2>(0, true,  0.0, 0.0));
+            nodes.push_back(new Node<2>(1, false, 0.0, 1.0));
+            nodes.push_back(new Node<2>(2, false, 0.0, 2.0));
+            nodes.push_back(new Node<2>(3, false, 0.0, 3.0));
+            nodes.push_back(new Node<2>(4, false, 0.0, 4.0));
+            nodes.push_back(new Node<2>(5, false, 0.0, 5.0));
+            nodes.push_back(new Node<2>(6, false, 0.0, 5.5));
+            nodes.push_back(new Node<2>(7, false, 0.0, 11.0));
+
+            NodesOnlyMesh<2> mesh;
+            mesh.SetUseCartesianDecomposition(true);
+            mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+            // There is only one column of boxes, so the processes are stacked in y
+            c_vector<unsigned, 2> num_procs_each_direction = mesh.mpBoxCollection->GetNumProcessesEachDirection();
+            TS_ASSERT_EQUALS(num_procs_each_direction[0], 1u);
+            TS_ASSERT_EQUALS(num_procs_each_direction[1], 2u);
+            TS_ASSERT_EQUALS(mesh.mpBoxCollection->rGetProcessBoxBoundaries()[1][1], 4u);
+
+            TS_ASSERT_EQUALS(mesh.GetNumNodes(), PetscTools::AmMaster() ? 7u : 1u);
+
+            mesh.AddNodesToBoxes();
+            mesh.LoadBalanceMesh();
+
+            // The boundary between the processes moves down by one row of boxes
+            TS_ASSERT_EQUALS(mesh.mpBoxCollection->rGetProcessBoxBoundaries()[1][1], 3u);
+            TS_ASSERT_EQUALS(mesh.mpBoxCollection->GetNumLocalRows(), PetscTools::AmMaster() ? 3u : 5u);
+
+            // Enlarging the box collection keeps the process grid, adding a row of boxes to each end
+            mesh.EnlargeBoxCollection();
+            TS_ASSERT_EQUALS(mesh.mpBoxCollection->rGetProcessBoxBoundaries()[1][1], 4u);
+            TS_ASSERT_EQUALS(mesh.mpBoxCollection->GetNumLocalRows(), PetscTools::AmMaster() ? 4u : 6u);
+
+            // Nodes in boxes owned by the other process are sent there
+            mesh.CalculateNodesOutsideLocalDomain();
+            TS_ASSERT_EQUALS(mesh.rGetNodesToSend(1 - PetscTools::GetMyRank()).size(), PetscTools::AmMaster() ? 2u : 0u);
+
+            // Tidy up
+            for (unsigned i=0; i<nodes.size(); i++)
+            {
+                delete nodes[i];
+            }
+        }
+    }
+
+    void TestFlatCellList() throw (Exception)
+    {
+        EXIT_IF_PARALLEL;    // Halo nodes are only added by the cell population
+
+        TrianglesMeshReader<2,2> mesh_reader("mesh/test/data/disk_984_elements");
+        TetrahedralMesh<2,2> generating_mesh;
+        generating_mesh.ConstructFromMeshReader(mesh_reader);
+
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(generating_mesh, 0.2);
+        mesh.UpdateBoxCollection();
+
+        NodesOnlyMesh<2> flat_mesh;
+        flat_mesh.ConstructNodesWithoutMesh(generating_mesh, 0.2);
+        TS_ASSERT(!flat_mesh.GetBoxCollection()->GetUseFlatCellList());
+        flat_mesh.SetUseFlatCellList(true);
+        TS_ASSERT(flat_mesh.GetBoxCollection()->GetUseFlatCellList());
+        flat_mesh.UpdateBoxCollection();
+
+        std::vector<std::pair<Node<2>*, Node<2>*> > pairs;
+        std::map<unsigned, std::set<unsigned> > neighbours;
+        mesh.CalculateInteriorNodePairs(pairs, neighbours);
+        mesh.CalculateBoundaryNodePairs(pairs, neighbours);
+
+        std::vector<std::pair<Node<2>*, Node<2>*> > flat_pairs;
+        std::map<unsigned, std::set<unsigned> > flat_neighbours;
+        flat_mesh.CalculateInteriorNodePairs(flat_pairs, flat_neighbours);
+        flat_mesh.CalculateBoundaryNodePairs(flat_pairs, flat_neighbours);
+
+        // The same node neighbours are found, in a different order
+        TS_ASSERT_EQUALS(flat_pairs.size(), pairs.size());
+        TS_ASSERT_EQUALS(flat_neighbours.size(), 543u);
+        TS_ASSERT(flat_neighbours == neighbours);
+        TS_ASSERT_EQUALS(flat_mesh.GetBoxCollection()->rGetPairRowStarts().back(), flat_pairs.size());
+
+        // The flat cell list is kept when the box collection is enlarged
+        flat_mesh.GetNode(0)->rGetModifiableLocation()[0] += 1.0;
+        flat_mesh.ResizeBoxCollection();
+        TS_ASSERT(flat_mesh.GetBoxCollection()->GetUseFlatCellList());
+        flat_mesh.UpdateBoxCollection();
+        flat_mesh.CalculateInteriorNodePairs(flat_pairs, flat_neighbours);
+        flat_mesh.CalculateBoundaryNodePairs(flat_pairs, flat_neighbours);
+        TS_ASSERT_EQUALS(flat_neighbours.size(), 543u);
+    }
 };
 
 #endif /*TESTNODESONLYMESH_HPP_*/
@@ -38,6 +38,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cxxtest/TestSuite.h>
 
 #include "CheckpointArchiveTypes.hpp"
+#include <sstream>
 
 #include "TetrahedralMesh.hpp"
 #include "DistributedBoxCollection.hpp"
@@ -2008,6 +2009,105 @@ public:
          }
     }
 
+    void TestArchivingCartesianDistributedBoxCollection() throw(Exception)
+    {
+        FileFinder archive_dir("archive", RelativeTo::ChasteTestOutput);
+        std::string archive_file = "cartesian_box_collection.arch";
+
+        c_vector<double, 6> domain_size;
+        for (unsigned i=0; i<3; i++)
+        {
+            domain_size[2*i] = 0.0;
+            domain_size[2*i+1] = 6.0;
+        }
+
+        c_vector<unsigned, 3> process_grid;
+        std::vector<std::vector<unsigned> > boundaries;
+        {
+            c_vector<unsigned, 3> num_procs_each_direction = zero_vector<unsigned>(3);
+            DistributedBoxCollection<3>* p_box_collection = new DistributedBoxCollection<3>(1.0, domain_size, num_procs_each_direction);
+            p_box_collection->SetupLocalBoxesHalfOnly();
+            process_grid = p_box_collection->GetNumProcessesEachDirection();
+            boundaries = p_box_collection->rGetProcessBoxBoundaries();
+
+            {
+                // Create an output archive
+                ArchiveOpener<boost::archive::text_oarchive, std::ofstream> arch_opener(archive_dir, archive_file);
+                boost::archive::text_oarchive* p_arch = arch_opener.GetCommonArchive();
+
+                // Make a const pointer
+                DistributedBoxCollection<3>* const p_const_box_collection = p_box_collection;
+                (*p_arch) << p_const_box_collection;
+            }
+
+            // Tidy up
+            delete p_box_collection;
+        }
+
+        {
+            DistributedBoxCollection<3>* p_box_collection;
+
+            ArchiveOpener<boost::archive::text_iarchive, std::ifstream> arch_opener(archive_dir, archive_file);
+            boost::archive::text_iarchive* p_arch = arch_opener.GetCommonArchive();
+
+            (*p_arch) >> p_box_collection;
+
+            // The process grid and the boxes owned by each process are restored
+            TS_ASSERT(p_box_collection->GetAreLocalBoxesSet());
+            TS_ASSERT_EQUALS(p_box_collection->GetNumBoxes(), 216u);
+            for (unsigned d=0; d<3; d++)
+            {
+                TS_ASSERT_EQUALS(p_box_collection->GetNumProcessesEachDirection()[d], process_grid[d]);
+                TS_ASSERT_EQUALS(p_box_collection->rGetProcessBoxBoundaries()[d], boundaries[d]);
+            }
+
+            delete p_box_collection;
+        }
+    }
+
+    void TestLoadArchiveWithoutProcessGrid() throw(Exception)
+    {
+        /*
+         * Archives written before the process grid was added (version 0) hold the number of rows
+         * owned by each process instead. Write the fields of such an archive, in order, and load them.
+         */
+        unsigned num_procs = PetscTools::GetNumProcs();
+        std::vector<int> num_rows(num_procs, 2);
+        num_rows[0] = 3;
+
+        std::stringstream old_layout;
+        {
+            boost::archive::text_oarchive output_arch(old_layout);
+            bool are_boxes_set = true;
+            output_arch << are_boxes_set;
+
+            double domain_size[4] = {0.0, 2.0, 0.0, 2.0*num_procs + 1.0};
+            for (unsigned i=0; i<4; i++)
+            {
+                output_arch << domain_size[i];
+            }
+
+            double box_width = 1.0;
+            output_arch << box_width;
+            output_arch << num_procs;
+
+            std::vector<int> const const_num_rows = num_rows;
+            output_arch << const_num_rows;
+        }
+
+        boost::archive::text_iarchive input_arch(old_layout);
+        DistributedBoxCollection<2>* p_box_collection = static_cast<DistributedBoxCollection<2>*>(::operator new(sizeof(DistributedBoxCollection<2>)));
+        boost::serialization::load_construct_data(input_arch, p_box_collection, 0u);
+
+        // The boxes are split into strips with the same number of rows on each process as before
+        TS_ASSERT(p_box_collection->IsStripDecomposition());
+        TS_ASSERT(p_box_collection->GetAreLocalBoxesSet());
+        TS_ASSERT_EQUALS(p_box_collection->GetNumBoxes(), 2*(2*num_procs + 1));
+        TS_ASSERT_EQUALS(p_box_collection->GetNumRowsOfBoxes(), (unsigned)num_rows[PetscTools::GetMyRank()]);
+
+        delete p_box_collection;
+    }
+
     void TestLoadBalanceFunction() throw (Exception)
     {
         // This test is designed for 3 process environment. Tests that an equal spread of load results
@@ -2146,6 +2246,315 @@ public:
             delete nodes[i];
         }
     }
+
+    void TestCartesianDecomposition3d() throw (Exception)
+    {
+        // A 6x6x6 collection of boxes, with the process grid chosen by the box collection
+        c_vector<double, 6> domain_size;
+        for (unsigned i=0; i<3; i++)
+        {
+            domain_size[2*i] = 0.0;
+            domain_size[2*i+1] = 6.0;
+        }
+
+        c_vector<unsigned, 3> num_procs_each_direction = scalar_vector<unsigned>(3, 0u);
+        DistributedBoxCollection<3> box_collection(1.0, domain_size, num_procs_each_direction);
+
+        c_vector<unsigned, 3> process_grid = box_collection.GetNumProcessesEachDirection();
+        TS_ASSERT_EQUALS(process_grid[0]*process_grid[1]*process_grid[2], PetscTools::GetNumProcs());
+        TS_ASSERT_EQUALS(box_collection.IsStripDecomposition(), (process_grid[0] == 1 && process_grid[1] == 1));
+        if (PetscTools::GetNumProcs() == 2)
+        {
+            // A cube on two processes is split into strips
+            TS_ASSERT_EQUALS(process_grid[2], 2u);
+        }
+
+        // Every box is owned by exactly one process, which any process can work out
+        unsigned num_boxes = box_collection.GetNumBoxes();
+        TS_ASSERT_EQUALS(num_boxes, 216u);
+
+        std::vector<unsigned> local_ownership(num_boxes, 0u);
+        unsigned num_local_boxes = 0;
+        for (unsigned i=0; i<num_boxes; i++)
+        {
+            if (box_collection.GetBoxOwnership(i))
+            {
+                local_ownership[i] = 1;
+                num_local_boxes++;
+                TS_ASSERT_EQUALS(box_collection.CalculateProcessOwningBox(i), PetscTools::GetMyRank());
+            }
+        }
+        TS_ASSERT_EQUALS(num_local_boxes, box_collection.GetNumLocalBoxes());
+
+        std::vector<unsigned> ownership(num_boxes, 0u);
+        MPI_Allreduce(&local_ownership[0], &ownership[0], num_boxes, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+        for (unsigned i=0; i<num_boxes; i++)
+        {
+            TS_ASSERT_EQUALS(ownership[i], 1u);
+        }
+
+        box_collection.SetupHaloBoxes();
+        box_collection.SetupLocalBoxesHalfOnly();
+
+        // Halo boxes are owned by neighbouring processes, and every neighbouring process needs some of our boxes
+        const std::vector<unsigned>& r_neighbours = box_collection.rGetNeighbourProcesses();
+        for (unsigned i=0; i<num_boxes; i++)
+        {
+            if (box_collection.GetHaloBoxOwnership(i))
+            {
+                unsigned owner = box_collection.CalculateProcessOwningBox(i);
+                TS_ASSERT(std::find(r_neighbours.begin(), r_neighbours.end(), owner) != r_neighbours.end());
+                TS_ASSERT_THROWS_NOTHING(box_collection.rGetHaloBox(i));
+            }
+        }
+        TS_ASSERT_EQUALS(box_collection.mHaloBoxesToSend.size(), r_neighbours.size());
+
+        /*
+         * Each pair of neighbouring boxes should be looked at once, except for pairs split between two
+         * processes which are looked at on both. There are 3*6*6*5 + 6*6*5*5 + 4*5*5*5 = 1940 such pairs.
+         */
+        unsigned local_pair_count = 0;
+        for (unsigned i=0; i<num_boxes; i++)
+        {
+            if (box_collection.GetBoxOwnership(i))
+            {
+                std::set<unsigned> local_boxes = box_collection.GetLocalBoxes(i);
+                for (std::set<unsigned>::iterator iter = local_boxes.begin(); iter != local_boxes.end(); ++iter)
+                {
+                    if (*iter != i)
+                    {
+                        local_pair_count += box_collection.GetBoxOwnership(*iter) ? 2 : 1;
+                    }
+                }
+            }
+        }
+        unsigned pair_count = 0;
+        MPI_Allreduce(&local_pair_count, &pair_count, 1, MPI_UNSIGNED, MPI_SUM, PetscTools::GetWorld());
+        TS_ASSERT_EQUALS(pair_count, 2*1940u);
+
+        // Put a node in every box in the bottom half of the domain, and rebalance
+        std::vector<Node<3>* > nodes;
+        for (unsigned i=0; i<num_boxes; i++)
+        {
+            if (box_collection.GetBoxOwnership(i) && box_collection.CalculateCoordinateIndices(i)[2] < 3)
+            {
+                nodes.push_back(new Node<3>(i, false));
+                box_collection.rGetBox(i).AddNode(nodes.back());
+            }
+        }
+
+        std::vector<std::vector<unsigned> > old_boundaries = box_collection.rGetProcessBoxBoundaries();
+        std::vector<std::vector<unsigned> > new_boundaries = box_collection.CalculateBalancedProcessBoundaries();
+        for (unsigned d=0; d<3; d++)
+        {
+            TS_ASSERT_EQUALS(new_boundaries[d].size(), process_grid[d] + 1);
+            TS_ASSERT_EQUALS(new_boundaries[d].front(), 0u);
+            TS_ASSERT_EQUALS(new_boundaries[d].back(), 6u);
+            for (unsigned i=1; i<new_boundaries[d].size(); i++)
+            {
+                TS_ASSERT_LESS_THAN(new_boundaries[d][i-1], new_boundaries[d][i]);
+                TS_ASSERT_LESS_THAN_EQUALS(new_boundaries[d][i], old_boundaries[d][i] + 1);
+                TS_ASSERT_LESS_THAN_EQUALS(old_boundaries[d][i], new_boundaries[d][i] + 1);
+            }
+        }
+        if (PetscTools::GetNumProcs() == 2)
+        {
+            // The boundary moves down towards the nodes
+            TS_ASSERT_EQUALS(old_boundaries[2][1], 3u);
+            TS_ASSERT_EQUALS(new_boundaries[2][1], 2u);
+        }
+
+        // The new boundaries can be used to build a new box collection
+        DistributedBoxCollection<3> new_box_collection(1.0, domain_size, process_grid, new_boundaries);
+        TS_ASSERT_EQUALS(new_box_collection.GetNumBoxes(), num_boxes);
+
+        // Process grids and boundaries that don't fit are rejected
+        c_vector<unsigned, 3> bad_process_grid = scalar_vector<unsigned>(3, 1u);
+        bad_process_grid[2] = PetscTools::GetNumProcs() + 1;
+        TS_ASSERT_THROWS_THIS(DistributedBoxCollection<3>(1.0, domain_size, bad_process_grid),
+                              "The process grid does not match the number of processes");
+
+        new_boundaries[0].push_back(7u);
+        TS_ASSERT_THROWS_THIS(DistributedBoxCollection<3>(1.0, domain_size, process_grid, new_boundaries),
+                              "The process box boundaries do not match the process grid and the number of boxes");
+
+        // Tidy up
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+    void TestFlatCellList3d() throw (Exception)
+    {
+        c_vector<double, 2*3> domain_size;
+        for (unsigned i=0; i<3; i++)
+        {
+            domain_size(2*i) = 0.0;
+            domain_size(2*i+1) = 6.0;
+        }
+
+        // Irregularly spaced nodes, several to a box
+        std::vector<Node<3>* > nodes;
+        for (unsigned i=0; i<10; i++)
+        {
+            for (unsigned j=0; j<10; j++)
+            {
+                for (unsigned k=0; k<10; k++)
+                {
+                    double x = 0.05 + 0.59*i + 0.01*((j+k)%3);
+                    double y = 0.05 + 0.59*j + 0.01*((i+k)%4);
+                    double z = 0.05 + 0.59*k + 0.01*((i+j)%5);
+                    nodes.push_back(new Node<3>(nodes.size(), false, x, y, z));
+                }
+            }
+        }
+
+        // Compare a box collection using std::sets with one using the flat cell list, on a Cartesian process grid
+        c_vector<unsigned, 3> process_grid = zero_vector<unsigned>(3);
+        DistributedBoxCollection<3> box_collection(1.0, domain_size, process_grid);
+        box_collection.SetupLocalBoxesHalfOnly();
+        box_collection.SetupHaloBoxes();
+
+        DistributedBoxCollection<3> flat_box_collection(1.0, domain_size, process_grid);
+        flat_box_collection.SetupLocalBoxesHalfOnly();
+        flat_box_collection.SetupHaloBoxes();
+        TS_ASSERT(!flat_box_collection.GetUseFlatCellList());
+        flat_box_collection.SetUseFlatCellList(true);
+        TS_ASSERT(flat_box_collection.GetUseFlatCellList());
+
+        std::vector<Node<3>* > owned_nodes;
+        std::vector<Node<3>* > halo_nodes;
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            unsigned box_index = box_collection.CalculateContainingBox(nodes[i]);
+            if (box_collection.GetBoxOwnership(box_index))
+            {
+                box_collection.rGetBox(box_index).AddNode(nodes[i]);
+                owned_nodes.push_back(nodes[i]);
+            }
+            else if (box_collection.GetHaloBoxOwnership(box_index))
+            {
+                halo_nodes.push_back(nodes[i]);
+            }
+        }
+
+        TS_ASSERT(flat_box_collection.UpdateFlatCellList(owned_nodes));
+
+        // The same nodes are in each box
+        for (unsigned i=0; i<owned_nodes.size(); i++)
+        {
+            unsigned box_index = box_collection.CalculateContainingBox(owned_nodes[i]);
+            std::vector<Node<3>* > flat_nodes = flat_box_collection.GetNodesInFlatCell(box_index);
+            std::set<Node<3>* > flat_nodes_set(flat_nodes.begin(), flat_nodes.end());
+            TS_ASSERT(flat_nodes_set == box_collection.rGetBox(box_index).rGetNodesContained());
+        }
+
+        // The same halo nodes are to be sent to each neighbouring process
+        box_collection.UpdateHaloBoxes();
+        flat_box_collection.UpdateHaloBoxes();
+        const std::vector<unsigned>& r_neighbours = box_collection.rGetNeighbourProcesses();
+        for (unsigned i=0; i<r_neighbours.size(); i++)
+        {
+            std::vector<unsigned> halos = box_collection.rGetHaloNodesToSend(r_neighbours[i]);
+            std::vector<unsigned> flat_halos = flat_box_collection.rGetHaloNodesToSend(r_neighbours[i]);
+            std::sort(halos.begin(), halos.end());
+            std::sort(flat_halos.begin(), flat_halos.end());
+            TS_ASSERT(halos == flat_halos);
+        }
+
+        // Interior pairs are calculated before halo nodes arrive, then boundary pairs
+        std::vector<std::pair<Node<3>*, Node<3>* > > pairs;
+        std::map<unsigned, std::set<unsigned> > neighbours;
+        box_collection.CalculateInteriorNodePairs(nodes, pairs, neighbours);
+
+        std::vector<std::pair<Node<3>*, Node<3>* > > flat_pairs;
+        std::map<unsigned, std::set<unsigned> > flat_neighbours;
+        flat_box_collection.CalculateInteriorNodePairs(nodes, flat_pairs, flat_neighbours);
+        TS_ASSERT_EQUALS(flat_pairs.size(), pairs.size());
+
+        for (unsigned i=0; i<halo_nodes.size(); i++)
+        {
+            box_collection.rGetHaloBox(box_collection.CalculateContainingBox(halo_nodes[i])).AddNode(halo_nodes[i]);
+        }
+        flat_box_collection.AddHaloNodesToFlatCellList(halo_nodes);
+
+        box_collection.CalculateBoundaryNodePairs(nodes, pairs, neighbours);
+        flat_box_collection.CalculateBoundaryNodePairs(nodes, flat_pairs, flat_neighbours);
+
+        std::set<std::pair<unsigned, unsigned> > pair_indices;
+        for (unsigned i=0; i<pairs.size(); i++)
+        {
+            unsigned a = pairs[i].first->GetIndex();
+            unsigned b = pairs[i].second->GetIndex();
+            pair_indices.insert(std::make_pair(std::min(a,b), std::max(a,b)));
+        }
+        std::set<std::pair<unsigned, unsigned> > flat_pair_indices;
+        for (unsigned i=0; i<flat_pairs.size(); i++)
+        {
+            unsigned a = flat_pairs[i].first->GetIndex();
+            unsigned b = flat_pairs[i].second->GetIndex();
+            flat_pair_indices.insert(std::make_pair(std::min(a,b), std::max(a,b)));
+        }
+        TS_ASSERT_EQUALS(flat_pairs.size(), pairs.size());
+        TS_ASSERT_EQUALS(flat_pair_indices.size(), flat_pairs.size());
+        TS_ASSERT(flat_pair_indices == pair_indices);
+        TS_ASSERT(flat_neighbours == neighbours);
+
+        // The compressed row output holds the same pairs, with one row per owned node
+        const std::vector<Node<3>* >& r_row_nodes = flat_box_collection.rGetPairRowNodes();
+        const std::vector<unsigned>& r_row_starts = flat_box_collection.rGetPairRowStarts();
+        const std::vector<Node<3>* >& r_pair_neighbours = flat_box_collection.rGetPairNeighbours();
+        TS_ASSERT_EQUALS(r_row_nodes.size(), owned_nodes.size());
+        TS_ASSERT_EQUALS(r_row_starts.size(), owned_nodes.size() + 1);
+        TS_ASSERT_EQUALS(r_row_starts.back(), flat_pairs.size());
+        unsigned num_csr_pairs_found = 0;
+        for (unsigned row=0; row<r_row_nodes.size(); row++)
+        {
+            for (unsigned j=r_row_starts[row]; j<r_row_starts[row+1]; j++)
+            {
+                unsigned a = r_row_nodes[row]->GetIndex();
+                unsigned b = r_pair_neighbours[j]->GetIndex();
+                num_csr_pairs_found += pair_indices.count(std::make_pair(std::min(a,b), std::max(a,b)));
+            }
+        }
+        TS_ASSERT_EQUALS(num_csr_pairs_found, pairs.size());
+
+        // Re-sorting is only needed when a node changes box
+        TS_ASSERT(!flat_box_collection.UpdateFlatCellList(owned_nodes));
+        if (!halo_nodes.empty())
+        {
+            // Halo nodes are removed by the update
+            TS_ASSERT_EQUALS(flat_box_collection.GetNodesInFlatCell(box_collection.CalculateContainingBox(halo_nodes[0])).size(), 0u);
+        }
+
+        if (!owned_nodes.empty())
+        {
+            Node<3>* p_node = owned_nodes[0];
+            unsigned old_box = flat_box_collection.CalculateContainingBox(p_node);
+            c_vector<double, 3> old_location = p_node->rGetLocation();
+
+            p_node->rGetModifiableLocation()[0] += 0.01;
+            TS_ASSERT(!flat_box_collection.UpdateFlatCellList(owned_nodes));
+
+            p_node->rGetModifiableLocation()[0] += 1.0;
+            unsigned new_box = flat_box_collection.CalculateContainingBox(p_node);
+            TS_ASSERT_DIFFERS(new_box, old_box);
+            if (flat_box_collection.GetBoxOwnership(new_box))
+            {
+                TS_ASSERT(flat_box_collection.UpdateFlatCellList(owned_nodes));
+                std::vector<Node<3>* > new_box_nodes = flat_box_collection.GetNodesInFlatCell(new_box);
+                TS_ASSERT(std::find(new_box_nodes.begin(), new_box_nodes.end(), p_node) != new_box_nodes.end());
+            }
+            p_node->rGetModifiableLocation() = old_location;
+        }
+
+        // Tidy up
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
 };
 
 #endif /*TESTBOXCOLLECTION_HPP_*/
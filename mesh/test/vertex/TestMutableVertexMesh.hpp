@@ -375,6 +375,91 @@ public:
         TS_ASSERT_DELTA(point3[1], 1.9, 1e-6);
     }
 
+    void TestElementGeometryCache() throw (Exception)
+    {
+        // Create mesh with a pentagonal element 0 and a triangular element 1, which share node 2
+        VertexMeshReader<2,2> mesh_reader("mesh/test/data/TestVertexMeshWriter/vertex_mesh_2d");
+        MutableVertexMesh<2,2> mesh;
+        mesh.ConstructFromMeshReader(mesh_reader);
+
+        // The cached geometry agrees with that computed directly
+        for (unsigned elem_index=0; elem_index<mesh.GetNumElements(); elem_index++)
+        {
+            TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(elem_index), mesh.GetVolumeOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedSurfaceAreaOfElement(elem_index), mesh.GetSurfaceAreaOfElement(elem_index), 1e-12);
+
+            c_vector<double, 2> cached_centroid = mesh.GetCachedCentroidOfElement(elem_index);
+            c_vector<double, 2> centroid = mesh.GetCentroidOfElement(elem_index);
+            TS_ASSERT_DELTA(cached_centroid[0], centroid[0], 1e-12);
+            TS_ASSERT_DELTA(cached_centroid[1], centroid[1], 1e-12);
+
+            TS_ASSERT_EQUALS(mesh.rGetCachedEdgeLengthsOfElement(elem_index).size(), mesh.GetElement(elem_index)->GetNumNodes());
+        }
+
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 0.75, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetCachedSurfaceAreaOfElement(1), 6.1796, 1e-4);
+        std::vector<double> edge_lengths = mesh.rGetCachedEdgeLengthsOfElement(1);
+        TS_ASSERT_DELTA(edge_lengths[0], 1.1180, 1e-4);
+        TS_ASSERT_DELTA(edge_lengths[1], 3.0000, 1e-4);
+        TS_ASSERT_DELTA(edge_lengths[2], 2.0616, 1e-4);
+
+        // Moving a node with SetNode() updates the cached geometry of the elements containing it
+        double volume_of_element_0 = mesh.GetCachedVolumeOfElement(0);
+        ChastePoint<2> point(2.0, 4.0);
+        mesh.SetNode(6, point);
+
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 1.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetCachedSurfaceAreaOfElement(1), 8.1594, 1e-4);
+        TS_ASSERT_DELTA(mesh.rGetCachedEdgeLengthsOfElement(1)[1], 4.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetCachedCentroidOfElement(1)[1], 5.0/3.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(0), volume_of_element_0, 1e-12);
+
+        // Moving a node directly is not seen until the containing elements are invalidated
+        mesh.GetNode(6)->rGetModifiableLocation()[1] = 3.0;
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 1.0, 1e-6);
+
+        mesh.InvalidateGeometryOfElementsContainingNode(6);
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 0.75, 1e-6);
+
+        mesh.GetNode(6)->rGetModifiableLocation()[1] = 4.0;
+        mesh.InvalidateElementGeometryCache();
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 1.0, 1e-6);
+
+        // Scaling, translating or rotating the whole mesh updates the cached geometry of every element
+        mesh.Scale(2.0, 1.0);
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 2.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(0), 2.0*volume_of_element_0, 1e-6);
+
+        mesh.Translate(1.0, -2.0);
+        mesh.Rotate(0.5*M_PI);
+        for (unsigned elem_index=0; elem_index<mesh.GetNumElements(); elem_index++)
+        {
+            TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(elem_index), mesh.GetVolumeOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedSurfaceAreaOfElement(elem_index), mesh.GetSurfaceAreaOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedCentroidOfElement(elem_index)[0], mesh.GetCentroidOfElement(elem_index)[0], 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedCentroidOfElement(elem_index)[1], mesh.GetCentroidOfElement(elem_index)[1], 1e-12);
+        }
+
+        mesh.Rotate(-0.5*M_PI);
+        mesh.Translate(-1.0, 2.0);
+        mesh.Scale(0.5, 1.0);
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(1), 1.0, 1e-6);
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(0), volume_of_element_0, 1e-6);
+
+        // Dividing an element updates the cached geometry of both daughter elements
+        unsigned new_element_index = mesh.DivideElement(mesh.GetElement(0), 0, 2, true);
+        TS_ASSERT_EQUALS(new_element_index, 2u);
+
+        for (unsigned elem_index=0; elem_index<mesh.GetNumElements(); elem_index++)
+        {
+            TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(elem_index), mesh.GetVolumeOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedSurfaceAreaOfElement(elem_index), mesh.GetSurfaceAreaOfElement(elem_index), 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedCentroidOfElement(elem_index)[0], mesh.GetCentroidOfElement(elem_index)[0], 1e-12);
+            TS_ASSERT_DELTA(mesh.GetCachedCentroidOfElement(elem_index)[1], mesh.GetCentroidOfElement(elem_index)[1], 1e-12);
+        }
+        TS_ASSERT_DELTA(mesh.GetCachedVolumeOfElement(0) + mesh.GetCachedVolumeOfElement(2), volume_of_element_0, 1e-12);
+    }
+
     void TestAddNodeAndReMesh() throw (Exception)
     {
         // Create mesh
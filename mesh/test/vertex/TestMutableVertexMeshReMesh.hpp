@@ -40,6 +40,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "VertexMeshWriter.hpp"
 #include "MutableVertexMesh.hpp"
+#include "HoneycombVertexMeshGenerator.hpp"
+#include "CylindricalHoneycombVertexMeshGenerator.hpp"
 #include "FileComparison.hpp"
 #include "Warnings.hpp"
 
@@ -48,6 +50,49 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class TestMutableVertexMeshReMesh : public CxxTest::TestSuite
 {
+private:
+
+    /**
+     * Check that MutableVertexMesh::FindIntersectionCandidates() finds the same
+     * intersections as testing every node against every element.
+     *
+     * @param rMesh the mesh
+     * @param boundaryOnly whether to check only boundary nodes against boundary elements
+     * @return the number of intersections found
+     */
+    unsigned CompareIntersectionCandidatesWithAllPairs(MutableVertexMesh<2,2>& rMesh, bool boundaryOnly)
+    {
+        std::vector<std::pair<unsigned, unsigned> > expected_candidates;
+        for (AbstractMesh<2,2>::NodeIterator node_iter = rMesh.GetNodeIteratorBegin();
+             node_iter != rMesh.GetNodeIteratorEnd();
+             ++node_iter)
+        {
+            if (boundaryOnly && !node_iter->IsBoundaryNode())
+            {
+                continue;
+            }
+            for (VertexMesh<2,2>::VertexElementIterator elem_iter = rMesh.GetElementIteratorBegin();
+                 elem_iter != rMesh.GetElementIteratorEnd();
+                 ++elem_iter)
+            {
+                unsigned elem_index = elem_iter->GetIndex();
+                if ((!boundaryOnly || elem_iter->IsElementOnBoundary())
+                    && node_iter->rGetContainingElementIndices().count(elem_index) == 0
+                    && rMesh.ElementIncludesPoint(node_iter->rGetLocation(), elem_index))
+                {
+                    expected_candidates.push_back(std::make_pair(node_iter->GetIndex(), elem_index));
+                    break;
+                }
+            }
+        }
+
+        std::vector<std::pair<unsigned, unsigned> > candidates;
+        rMesh.FindIntersectionCandidates(boundaryOnly, candidates);
+        TS_ASSERT(candidates == expected_candidates);
+
+        return candidates.size();
+    }
+
 public:
 
     void TestPerformNodeMerge() throw(Exception)
@@ -2265,6 +2310,122 @@ public:
         TS_ASSERT_DELTA(vertex_mesh.GetSurfaceAreaOfElement(3), 2.3062, 1e-4);
     }
 
+    void TestFindIntersectionCandidates() throw(Exception)
+    {
+        // Create a honeycomb mesh and a periodic honeycomb mesh, and move some of their nodes into neighbouring elements
+        HoneycombVertexMeshGenerator generator(8, 8);
+        MutableVertexMesh<2,2>* p_mesh = generator.GetMesh();
+        CylindricalHoneycombVertexMeshGenerator cylindrical_generator(8, 8);
+        MutableVertexMesh<2,2>* p_cylindrical_mesh = cylindrical_generator.GetCylindricalMesh();
+
+        TS_ASSERT_EQUALS(CompareIntersectionCandidatesWithAllPairs(*p_mesh, false), 0u);
+        TS_ASSERT_EQUALS(CompareIntersectionCandidatesWithAllPairs(*p_cylindrical_mesh, false), 0u);
+
+        for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index+=5)
+        {
+            ChastePoint<2> point = p_mesh->GetNode(node_index)->GetPoint();
+            point.SetCoordinate(0u, point[0] + 0.8*cos(0.7*node_index));
+            point.SetCoordinate(1u, point[1] + 0.8*sin(0.7*node_index));
+            p_mesh->SetNode(node_index, point);
+        }
+        for (unsigned node_index=0; node_index<p_cylindrical_mesh->GetNumNodes(); node_index+=5)
+        {
+            // Nodes on the left and right are moved across the periodic boundary
+            ChastePoint<2> point = p_cylindrical_mesh->GetNode(node_index)->GetPoint();
+            point.SetCoordinate(0u, point[0] + 0.8*cos(0.7*node_index));
+            point.SetCoordinate(1u, point[1] + 0.8*sin(0.7*node_index));
+            p_cylindrical_mesh->SetNode(node_index, point);
+        }
+
+        // The grid search finds the same intersections as testing every pair
+        TS_ASSERT_LESS_THAN(0u, CompareIntersectionCandidatesWithAllPairs(*p_mesh, false));
+        TS_ASSERT_LESS_THAN(0u, CompareIntersectionCandidatesWithAllPairs(*p_cylindrical_mesh, false));
+        CompareIntersectionCandidatesWithAllPairs(*p_mesh, true);
+        CompareIntersectionCandidatesWithAllPairs(*p_cylindrical_mesh, true);
+    }
+
+    void TestCheckForIntersectionsResolvesIndependentIntersectionsInOnePass() throw(Exception)
+    {
+        /*
+         * Create a mesh comprising two separate copies of the mesh used in TestPerformIntersectionSwap(),
+         * the second shifted two units to the right.
+         */
+        std::vector<Node<2>*> nodes;
+        std::vector<VertexElement<2,2>*> vertex_elements;
+        for (unsigned copy=0; copy<2; copy++)
+        {
+            double x_offset = 2.0*copy;
+            unsigned first_node = nodes.size();
+            nodes.push_back(new Node<2>(first_node,   true,  x_offset + 0.0, 0.0));
+            nodes.push_back(new Node<2>(first_node+1, true,  x_offset + 1.0, 0.0));
+            nodes.push_back(new Node<2>(first_node+2, true,  x_offset + 1.0, 1.0));
+            nodes.push_back(new Node<2>(first_node+3, true,  x_offset + 0.0, 1.0));
+            nodes.push_back(new Node<2>(first_node+4, false, x_offset + 0.4, 0.5));
+            nodes.push_back(new Node<2>(first_node+5, false, x_offset + 0.6, 0.5));
+
+            unsigned node_indices_elem_0[3] = {2, 3, 5};
+            unsigned node_indices_elem_1[4] = {2, 5, 4, 1};
+            unsigned node_indices_elem_2[3] = {1, 4, 0};
+            unsigned node_indices_elem_3[4] = {0, 4, 5, 3};
+            std::vector<Node<2>*> nodes_elem_0, nodes_elem_1, nodes_elem_2, nodes_elem_3;
+            for (unsigned i=0; i<3; i++)
+            {
+                nodes_elem_0.push_back(nodes[first_node + node_indices_elem_0[i]]);
+                nodes_elem_2.push_back(nodes[first_node + node_indices_elem_2[i]]);
+            }
+            for (unsigned i=0; i<4; i++)
+            {
+                nodes_elem_1.push_back(nodes[first_node + node_indices_elem_1[i]]);
+                nodes_elem_3.push_back(nodes[first_node + node_indices_elem_3[i]]);
+            }
+
+            unsigned first_element = vertex_elements.size();
+            vertex_elements.push_back(new VertexElement<2,2>(first_element, nodes_elem_0));
+            vertex_elements.push_back(new VertexElement<2,2>(first_element+1, nodes_elem_1));
+            vertex_elements.push_back(new VertexElement<2,2>(first_element+2, nodes_elem_2));
+            vertex_elements.push_back(new VertexElement<2,2>(first_element+3, nodes_elem_3));
+        }
+
+        MutableVertexMesh<2,2> vertex_mesh(nodes, vertex_elements);
+        vertex_mesh.SetCheckForInternalIntersections(true);
+
+        // Move nodes 4 and 10 so that they overlap elements 0 and 4 respectively
+        for (unsigned copy=0; copy<2; copy++)
+        {
+            ChastePoint<2> point = vertex_mesh.GetNode(6*copy + 4)->GetPoint();
+            point.SetCoordinate(1u, 0.7);
+            vertex_mesh.SetNode(6*copy + 4, point);
+        }
+
+        std::vector<std::pair<unsigned, unsigned> > candidates;
+        vertex_mesh.FindIntersectionCandidates(false, candidates);
+        TS_ASSERT_EQUALS(candidates.size(), 2u);
+
+        // Both intersections are resolved by a single pass
+        TS_ASSERT_EQUALS(vertex_mesh.CheckForIntersections(), true);
+        vertex_mesh.FindIntersectionCandidates(false, candidates);
+        TS_ASSERT_EQUALS(candidates.size(), 0u);
+
+        // Test that each element contains the correct nodes following the rearrangement
+        unsigned node_indices_element_0[4] = {2, 3, 4, 5};
+        unsigned node_indices_element_1[3] = {2, 5, 1};
+        unsigned node_indices_element_2[4] = {1, 5, 4, 0};
+        unsigned node_indices_element_3[3] = {0, 4, 3};
+        for (unsigned copy=0; copy<2; copy++)
+        {
+            for (unsigned i=0; i<4; i++)
+            {
+                TS_ASSERT_EQUALS(vertex_mesh.GetElement(4*copy)->GetNodeGlobalIndex(i), 6*copy + node_indices_element_0[i]);
+                TS_ASSERT_EQUALS(vertex_mesh.GetElement(4*copy + 2)->GetNodeGlobalIndex(i), 6*copy + node_indices_element_2[i]);
+                if (i < 3)
+                {
+                    TS_ASSERT_EQUALS(vertex_mesh.GetElement(4*copy + 1)->GetNodeGlobalIndex(i), 6*copy + node_indices_element_1[i]);
+                    TS_ASSERT_EQUALS(vertex_mesh.GetElement(4*copy + 3)->GetNodeGlobalIndex(i), 6*copy + node_indices_element_3[i]);
+                }
+            }
+        }
+    }
+
     void TestPerformIntersectionSwapOtherWayRound() throw(Exception)
     {
         /*
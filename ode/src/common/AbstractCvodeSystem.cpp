@@ -37,6 +37,8 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <sstream>
 #include <cassert>
+#include <cfloat>
+#include <cmath>
 
 #include "AbstractCvodeSystem.hpp"
 #include "Exception.hpp"
@@ -49,6 +51,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cvode/cvode.h>
 #include <sundials/sundials_nvector.h>
 #include <cvode/cvode_dense.h>
+#include <cvode/cvode_band.h>
 
 
 //#include "Debug.hpp"
@@ -118,6 +121,48 @@ int AbstractCvodeSystemRhsAdaptor(realtype t, N_Vector y, N_Vector ydot, void *p
     return 0;
 }
 
+#if CHASTE_SUNDIALS_VERSION >= 20400
+/**
+ * Callback function provided to CVODE to evaluate the Jacobian when a banded linear solver
+ * is in use (see AbstractCvodeSystem::EvaluateBandedAnalyticJacobian).
+ *
+ * @param N  the size of the ODE system
+ * @param mupper  the upper bandwidth
+ * @param mlower  the lower bandwidth
+ * @param t  current time
+ * @param y  state variable vector
+ * @param ydot  derivatives vector
+ * @param jacobian  the banded Jacobian to fill in
+ * @param pData  pointer to the system being simulated
+ * @param tmp1  working memory
+ * @param tmp2  working memory
+ * @param tmp3  working memory
+ * @return 0 on success, -1 on failure
+ */
+#if CHASTE_SUNDIALS_VERSION >= 20500
+int AbstractCvodeSystemBandJacAdaptor(long int N, long int mupper, long int mlower,
+#else
+int AbstractCvodeSystemBandJacAdaptor(int N, int mupper, int mlower,
+#endif
+                                      realtype t, N_Vector y, N_Vector ydot, DlsMat jacobian,
+                                      void *pData, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+    assert(pData != NULL);
+    AbstractCvodeSystem* p_ode_system = (AbstractCvodeSystem*) pData;
+    try
+    {
+        p_ode_system->EvaluateBandedAnalyticJacobian((long)(N), (long)(mupper), (long)(mlower),
+                                                     t, y, ydot, jacobian, tmp1, tmp2, tmp3);
+    }
+    catch (const Exception &e)
+    {
+        std::cerr << "CVODE Jacobian Exception: " << e.GetMessage() << std::endl << std::flush;
+        return -1;
+    }
+    return 0;
+}
+#endif // CHASTE_SUNDIALS_VERSION >= 20400
+
 AbstractCvodeSystem::AbstractCvodeSystem(unsigned numberOfStateVariables)
     : AbstractParameterisedSystem<N_Vector>(numberOfStateVariables),
       mLastSolutionState(NULL),
@@ -130,6 +175,10 @@ AbstractCvodeSystem::AbstractCvodeSystem(unsigned numberOfStateVariables)
       mForceReset(true),
 #endif
       mForceMinimalReset(false),
+      mUseWarmRestarts(false),
+      mUseBandedLinearSolver(false),
+      mUsingBandedLinearSolver(false),
+      mpDenseJacobianWorkspace(NULL),
       mUseAnalyticJacobian(false),
       mpCvodeMem(NULL),
       mMaxSteps(0),
@@ -332,6 +381,35 @@ void AbstractCvodeSystem::SetMinimalReset(bool minimalReset)
 }
 
 
+void AbstractCvodeSystem::SetUseWarmRestarts(bool useWarmRestarts)
+{
+    mUseWarmRestarts = useWarmRestarts;
+    if (mUseWarmRestarts)
+    {
+        SetMinimalReset(false);
+    }
+}
+
+bool AbstractCvodeSystem::GetUseWarmRestarts()
+{
+    return mUseWarmRestarts;
+}
+
+void AbstractCvodeSystem::SetUseBandedLinearSolver(bool useBanded)
+{
+    if (useBanded != mUseBandedLinearSolver)
+    {
+        mUseBandedLinearSolver = useBanded;
+        // The linear solver is only attached when CVODE is set up from scratch
+        FreeCvodeMemory();
+    }
+}
+
+bool AbstractCvodeSystem::IsUsingBandedLinearSolver()
+{
+    return mUsingBandedLinearSolver;
+}
+
 void AbstractCvodeSystem::ResetSolver()
 {
     DeleteVector(mLastSolutionState);
@@ -348,6 +426,8 @@ void AbstractCvodeSystem::SetupCvode(N_Vector initialConditions,
     // Find out if we need to (re-)initialise
     //std::cout << "!mpCvodeMem = " << !mpCvodeMem << ", mForceReset = " << mForceReset << ", !mLastSolutionState = " << !mLastSolutionState << ", comp doubles = " << !CompareDoubles::WithinAnyTolerance(tStart, mLastSolutionTime) << "\n";
     bool reinit = !mpCvodeMem || mForceReset || !mLastSolutionState || !CompareDoubles::WithinAnyTolerance(tStart, mLastSolutionTime);
+    // Whether we are carrying on in time, and would not re-initialise but for a change in the state
+    bool only_state_changed = !reinit;
     if (!reinit && !mForceMinimalReset)
     {
         const unsigned size = GetNumberOfStateVariables();
@@ -384,20 +464,18 @@ void AbstractCvodeSystem::SetupCvode(N_Vector initialConditions,
                     CV_SS, mRelTol, &mAbsTol);
 #endif
         // Attach a linear solver for Newton iteration
-        CVDense(mpCvodeMem, NV_LENGTH_S(initialConditions));
-
-        if (mUseAnalyticJacobian)
-        {
-#if CHASTE_SUNDIALS_VERSION >= 20400
-            CVDlsSetDenseJacFn(mpCvodeMem, AbstractCvodeSystemJacAdaptor);
-#else
-            CVDenseSetJacFn(mpCvodeMem, AbstractCvodeSystemJacAdaptor, (void*)(this));
-#endif
-        }
+        AttachLinearSolver(initialConditions, tStart);
     }
     else if (reinit)
     {
         //std::cout << "Resetting CVODE solver\n";
+        double init_step = 0.0; // i.e. let CVODE estimate it
+        if (mUseWarmRestarts && only_state_changed && mLastInternalStepSize > 0.0)
+        {
+            // Carry on with the step size we had reached, scaled down if the state has jumped
+            // by more than the solver tolerances
+            init_step = std::min((double)maxDt, mLastInternalStepSize/std::max(1.0, GetWeightedChangeSinceLastSolve()));
+        }
 #if CHASTE_SUNDIALS_VERSION >= 20400
         CVodeReInit(mpCvodeMem, tStart, initialConditions);
         CVodeSStolerances(mpCvodeMem, mRelTol, mAbsTol);
@@ -405,6 +483,7 @@ void AbstractCvodeSystem::SetupCvode(N_Vector initialConditions,
         CVodeReInit(mpCvodeMem, AbstractCvodeSystemRhsAdaptor, tStart, initialConditions,
                     CV_SS, mRelTol, &mAbsTol);
 #endif
+        CVodeSetInitStep(mpCvodeMem, init_step);
     }
 
     // Set max dt and change max steps if wanted
@@ -417,6 +496,127 @@ void AbstractCvodeSystem::SetupCvode(N_Vector initialConditions,
 }
 
 
+void AbstractCvodeSystem::AttachLinearSolver(N_Vector initialConditions, realtype tStart)
+{
+    const unsigned size = GetNumberOfStateVariables();
+    mUsingBandedLinearSolver = false;
+
+#if CHASTE_SUNDIALS_VERSION >= 20400
+    if (mUseBandedLinearSolver)
+    {
+        unsigned upper_bandwidth;
+        unsigned lower_bandwidth;
+        ComputeJacobianBandwidths(initialConditions, tStart, upper_bandwidth, lower_bandwidth);
+
+        // A band storing more than half the matrix doesn't save anything over the dense solver
+        if (2*(upper_bandwidth + lower_bandwidth + 1) <= size)
+        {
+            CVBand(mpCvodeMem, size, upper_bandwidth, lower_bandwidth);
+            mUsingBandedLinearSolver = true;
+
+            if (mUseAnalyticJacobian)
+            {
+                mpDenseJacobianWorkspace = NewDenseMat(size, size);
+                CVDlsSetBandJacFn(mpCvodeMem, AbstractCvodeSystemBandJacAdaptor);
+            }
+            return;
+        }
+    }
+#endif // CHASTE_SUNDIALS_VERSION >= 20400
+
+    CVDense(mpCvodeMem, size);
+
+    if (mUseAnalyticJacobian)
+    {
+#if CHASTE_SUNDIALS_VERSION >= 20400
+        CVDlsSetDenseJacFn(mpCvodeMem, AbstractCvodeSystemJacAdaptor);
+#else
+        CVDenseSetJacFn(mpCvodeMem, AbstractCvodeSystemJacAdaptor, (void*)(this));
+#endif
+    }
+}
+
+
+void AbstractCvodeSystem::ComputeJacobianBandwidths(N_Vector y, realtype time,
+                                                    unsigned& rUpperBandwidth, unsigned& rLowerBandwidth)
+{
+    const unsigned size = GetNumberOfStateVariables();
+    rUpperBandwidth = 0u;
+    rLowerBandwidth = 0u;
+
+    N_Vector y_nudged = N_VClone(y);
+    N_Vector ydot = N_VClone(y);
+    N_Vector ydot_nudged = N_VClone(y);
+    N_VScale(1.0, y, y_nudged);
+    EvaluateYDerivatives(time, y, ydot);
+
+    for (unsigned j=0; j<size; j++)
+    {
+        double y_j = GetVectorComponent(y, j);
+        SetVectorComponent(y_nudged, j, y_j + sqrt(DBL_EPSILON)*std::max(fabs(y_j), 1.0));
+        EvaluateYDerivatives(time, y_nudged, ydot_nudged);
+        SetVectorComponent(y_nudged, j, y_j);
+
+        for (unsigned i=0; i<size; i++)
+        {
+            if (GetVectorComponent(ydot_nudged, i) != GetVectorComponent(ydot, i))
+            {
+                // Entry (i,j) of the Jacobian is non-zero
+                if (j > i)
+                {
+                    rUpperBandwidth = std::max(rUpperBandwidth, j-i);
+                }
+                else
+                {
+                    rLowerBandwidth = std::max(rLowerBandwidth, i-j);
+                }
+            }
+        }
+    }
+
+    DeleteVector(y_nudged);
+    DeleteVector(ydot);
+    DeleteVector(ydot_nudged);
+}
+
+
+#if CHASTE_SUNDIALS_VERSION >= 20400
+void AbstractCvodeSystem::EvaluateBandedAnalyticJacobian(long int N, long int upperBandwidth, long int lowerBandwidth,
+                                                         realtype time, N_Vector y, N_Vector ydot,
+                                                         DlsMat jacobian,
+                                                         N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+    assert(mpDenseJacobianWorkspace != NULL);
+    SetToZero(mpDenseJacobianWorkspace);
+    EvaluateAnalyticJacobian(N, time, y, ydot, mpDenseJacobianWorkspace, tmp1, tmp2, tmp3);
+
+    for (long int j=0; j<N; j++)
+    {
+        for (long int i=std::max(0L, j-upperBandwidth); i<=std::min(N-1, j+lowerBandwidth); i++)
+        {
+            BAND_ELEM(jacobian, i, j) = DENSE_ELEM(mpDenseJacobianWorkspace, i, j);
+        }
+    }
+}
+#endif // CHASTE_SUNDIALS_VERSION >= 20400
+
+
+double AbstractCvodeSystem::GetWeightedChangeSinceLastSolve()
+{
+    assert(mLastSolutionState);
+    const unsigned size = GetNumberOfStateVariables();
+    double sum_squares = 0.0;
+    for (unsigned i=0; i<size; i++)
+    {
+        double y_i = GetVectorComponent(mStateVariables, i);
+        double weight = mRelTol*fabs(y_i) + mAbsTol;
+        double change = (y_i - GetVectorComponent(mLastSolutionState, i))/weight;
+        sum_squares += change*change;
+    }
+    return sqrt(sum_squares/size);
+}
+
+
 void AbstractCvodeSystem::RecordStoppingPoint(double stopTime)
 {
 //    DebugSteps(mpCvodeMem, this);
@@ -445,6 +645,15 @@ void AbstractCvodeSystem::FreeCvodeMemory()
         CVodeFree(&mpCvodeMem);
     }
     mpCvodeMem = NULL;
+    mUsingBandedLinearSolver = false;
+
+#if CHASTE_SUNDIALS_VERSION >= 20400
+    if (mpDenseJacobianWorkspace)
+    {
+        DestroyMat(mpDenseJacobianWorkspace);
+        mpDenseJacobianWorkspace = NULL;
+    }
+#endif
 }
 
 
@@ -47,11 +47,13 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Chaste includes
 #include "OdeSolution.hpp"
 #include "AbstractParameterisedSystem.hpp"
+#include "ArchiveLocationInfo.hpp"
 #include "Exception.hpp"
 #include "VectorHelperFunctions.hpp"
 
 // Serialiazation
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
 #include "ClassIsAbstract.hpp"
@@ -115,6 +117,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * SetMinimalReset(true) - ignore changes in state vars and just reset if the time is inconsistent.
  *
+ * SetUseWarmRestarts(true) - as the default, but when only the state variables have changed
+ * (e.g. the voltage of a cell in a tissue simulation) CVODE restarts with the step size it had
+ * reached, reduced according to the size of the change, instead of ramping up from its own
+ * (very small) estimate of the initial step.
+ *
+ * By default CVODE solves its Newton systems with a dense linear solver. SetUseBandedLinearSolver()
+ * allows a banded solver to be used instead if the Jacobian sparsity pattern (found by probing
+ * the right-hand side at the initial conditions) has a narrow enough band.
+ *
  */
 class AbstractCvodeSystem : public AbstractParameterisedSystem<N_Vector>
 {
@@ -137,9 +148,12 @@ private:
         archive & mNumberOfStateVariables;
         archive & mUseAnalyticJacobian;
 
-        // Convert from N_Vector to std::vector for serialization
-        const std::vector<double> state_vars = MakeStdVec(mStateVariables);
-        archive & state_vars;
+        if (!ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+        {
+            // Convert from N_Vector to std::vector for serialization
+            const std::vector<double> state_vars = MakeStdVec(mStateVariables);
+            archive & state_vars;
+        }
         const std::vector<double> params = MakeStdVec(mParameters);
         archive & params;
         archive & rGetParameterNames();
@@ -151,6 +165,8 @@ private:
         archive & mAbsTol;
         archive & mMaxSteps;
         archive & mLastInternalStepSize;
+        archive & mUseWarmRestarts;
+        archive & mUseBandedLinearSolver;
 
         // We don't bother archiving CVODE's internal data, because it is missing then we'll just
         // get a new solver being initialised after a save/load.
@@ -172,9 +188,13 @@ private:
         archive & mNumberOfStateVariables;
         archive & mUseAnalyticJacobian;
 
-        std::vector<double> state_vars;
-        archive & state_vars;
-        CopyFromStdVector(state_vars,mStateVariables);
+        // Otherwise our owner sets the state variables after loading us
+        if (!ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+        {
+            std::vector<double> state_vars;
+            archive & state_vars;
+            CopyFromStdVector(state_vars,mStateVariables);
+        }
 
         std::vector<double> parameters;
         archive & parameters;
@@ -188,6 +208,11 @@ private:
         archive & mAbsTol;
         archive & mMaxSteps;
         archive & mLastInternalStepSize;
+        if (version > 0)
+        {
+            archive & mUseWarmRestarts;
+            archive & mUseBandedLinearSolver;
+        }
 
         // We don't bother archiving CVODE's internal data, because it is missing then we'll just
         // get a new solver being initialised after a save/load.
@@ -208,6 +233,34 @@ private:
                     realtype tStart,
                     realtype maxDt);
 
+    /**
+     * Attach the linear solver for CVODE's Newton iteration to #mpCvodeMem: a banded one if
+     * #mUseBandedLinearSolver is set and the Jacobian band is narrow enough, otherwise a dense one.
+     *
+     * @param initialConditions  initial conditions (where the sparsity pattern is probed)
+     * @param tStart  start time of simulation
+     */
+    void AttachLinearSolver(N_Vector initialConditions, realtype tStart);
+
+    /**
+     * Find the upper and lower bandwidths of the Jacobian, by perturbing each state variable in
+     * turn and seeing which derivatives change. Entries which happen to vanish at this point
+     * are treated as zero.
+     *
+     * @param y  the state at which to probe the Jacobian
+     * @param time  the time at which to probe the Jacobian
+     * @param rUpperBandwidth  filled in with the upper bandwidth
+     * @param rLowerBandwidth  filled in with the lower bandwidth
+     */
+    void ComputeJacobianBandwidths(N_Vector y, realtype time,
+                                   unsigned& rUpperBandwidth, unsigned& rLowerBandwidth);
+
+    /**
+     * @return the weighted root-mean-square norm (using the solver tolerances) of the difference
+     * between the current state variables and those at the end of the last solve.
+     */
+    double GetWeightedChangeSinceLastSolve();
+
     /**
      * Record where the last solve got to so we know whether to re-initialise.
      * @param stopTime  the finishing time
@@ -237,6 +290,21 @@ private:
     /** Whether to ignore changes in the state variables when deciding whether to reset. */
     bool mForceMinimalReset;
 
+    /** Whether to restart with the last step size when only the state variables have changed. */
+    bool mUseWarmRestarts;
+
+    /** Whether a banded linear solver may be used if the Jacobian has a narrow band. */
+    bool mUseBandedLinearSolver;
+
+    /** Whether the linear solver attached to #mpCvodeMem is a banded one. */
+    bool mUsingBandedLinearSolver;
+
+    /**
+     * If a banded linear solver is in use with an analytic Jacobian, a dense matrix for
+     * EvaluateAnalyticJacobian() to fill in, from which the band is copied (otherwise NULL).
+     */
+    CHASTE_CVODE_DENSE_MATRIX mpDenseJacobianWorkspace;
+
 protected:
 
     /** Whether to use an analytic Jacobian. */
@@ -315,6 +383,28 @@ public:
         EXCEPTION("No analytic Jacobian has been defined for this system.");
     }
 
+#if CHASTE_SUNDIALS_VERSION >= 20400
+    /**
+     * Used by the banded Jacobian adaptor in the .cpp file when a banded linear solver is in
+     * use: evaluates the analytic Jacobian into a dense workspace and copies the band.
+     *
+     * @param N  the size of the ODE system
+     * @param upperBandwidth  the upper bandwidth of the Jacobian
+     * @param lowerBandwidth  the lower bandwidth of the Jacobian
+     * @param time  the current time
+     * @param y  the current state variables
+     * @param ydot  the current set of derivatives
+     * @param jacobian  the banded Jacobian to fill in
+     * @param tmp1  working memory provided by CVODE
+     * @param tmp2  working memory provided by CVODE
+     * @param tmp3  working memory provided by CVODE
+     */
+    void EvaluateBandedAnalyticJacobian(long int N, long int upperBandwidth, long int lowerBandwidth,
+                                        realtype time, N_Vector y, N_Vector ydot,
+                                        DlsMat jacobian,
+                                        N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
+#endif
+
     /**
      * Set whether to automatically re-initialise CVODE on every call to Solve, or
      * whether to attempt to guess when re-initialisation is needed. For example
@@ -337,6 +427,39 @@ public:
      */
     void SetMinimalReset(bool minimalReset);
 
+    /**
+     * Set whether to keep CVODE's step size when the solver has to be re-initialised only
+     * because the state variables have changed since the last solve (for example because a
+     * tissue simulation has updated the voltage). CVODE's internal history cannot be updated
+     * with the new state, so the solver is still re-initialised, but its first step is the last
+     * step size taken, divided by the weighted RMS norm of the change (when this exceeds 1).
+     * If called with a true argument, will call SetMinimalReset(false), since changes in the
+     * state must then be detected.
+     *
+     * @param useWarmRestarts  whether to restart with the previous step size
+     */
+    void SetUseWarmRestarts(bool useWarmRestarts=true);
+
+    /**
+     * @return whether warm restarts are used (see SetUseWarmRestarts()).
+     */
+    bool GetUseWarmRestarts();
+
+    /**
+     * Set whether CVODE may use a banded linear solver, chosen when the solver is set up if
+     * the bandwidth of the Jacobian is less than half the number of state variables.
+     * Only supported with Sundials 2.4 or later; otherwise the dense solver is always used.
+     *
+     * @param useBanded  whether a banded linear solver may be used
+     */
+    void SetUseBandedLinearSolver(bool useBanded=true);
+
+    /**
+     * @return whether a banded linear solver is actually in use (only known once the solver
+     * has been set up by a Solve call).
+     */
+    bool IsUsingBandedLinearSolver();
+
     /**
      * Successive calls to Solve will attempt to intelligently determine whether
      * to re-initialise the internal CVODE solver, or whether we are simply
@@ -477,6 +600,7 @@ public:
 };
 
 CLASS_IS_ABSTRACT(AbstractCvodeSystem)
+BOOST_CLASS_VERSION(AbstractCvodeSystem, 1u)
 
 #endif //_ABSTRACTCVODESYSTEM_HPP_
 #endif // CHASTE_CVODE
@@ -48,6 +48,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ClassIsAbstract.hpp"
 
 #include "AbstractParameterisedSystem.hpp"
+#include "ArchiveLocationInfo.hpp"
 #include "Exception.hpp"
 
 /**
@@ -107,7 +108,10 @@ private:
         // to a standard vector before archiving, this doesn't hurt too much.
         archive & mNumberOfStateVariables;
         archive & mUseAnalyticJacobian;
-        archive & mStateVariables;
+        if (!ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+        {
+            archive & mStateVariables;
+        }
         archive & mParameters;
 
         if (version > 0)
@@ -130,7 +134,11 @@ private:
     {
         archive & mNumberOfStateVariables;
         archive & mUseAnalyticJacobian;
-        archive & mStateVariables;
+        // Otherwise our owner sets the state variables after loading us
+        if (!ArchiveLocationInfo::GetStateVariablesInSeparateArrays())
+        {
+            archive & mStateVariables;
+        }
         std::vector<double> parameters;
         archive & parameters;
 
@@ -71,3 +71,8 @@ double AbstractIvpOdeSolver::GetStoppingTime()
 {
     return mStoppingTime;
 }
+
+boost::shared_ptr<AbstractIvpOdeSolver> AbstractIvpOdeSolver::CreateCopy() const
+{
+    EXCEPTION("This ODE solver does not support creating a copy of itself.");
+}
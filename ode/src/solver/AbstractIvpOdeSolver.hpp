@@ -37,6 +37,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define _ABSTRACTIVPODESOLVER_HPP_
 
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 #include "ChasteSerialization.hpp"
 #include "ClassIsAbstract.hpp"
@@ -154,6 +155,18 @@ public:
      */
     double GetStoppingTime();
 
+    /**
+     * Create a new solver of the same type and with the same settings as this one,
+     * but with its own working memory.  This allows ODE systems which would
+     * otherwise share a solver to be solved concurrently.
+     *
+     * The default implementation throws an exception; solvers which can be copied
+     * should override it.
+     *
+     * @return a new solver
+     */
+    virtual boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
     /**
      * Constructor.
      */
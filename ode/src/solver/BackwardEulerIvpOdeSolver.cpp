@@ -250,6 +250,13 @@ void BackwardEulerIvpOdeSolver::ForceUseOfNumericalJacobian()
     mForceUseOfNumericalJacobian = true;
 }
 
+boost::shared_ptr<AbstractIvpOdeSolver> BackwardEulerIvpOdeSolver::CreateCopy() const
+{
+    BackwardEulerIvpOdeSolver* p_copy = new BackwardEulerIvpOdeSolver(mSizeOfOdeSystem);
+    p_copy->mNumericalJacobianEpsilon = mNumericalJacobianEpsilon;
+    p_copy->mForceUseOfNumericalJacobian = mForceUseOfNumericalJacobian;
+    return boost::shared_ptr<AbstractIvpOdeSolver>(p_copy);
+}
 
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
@@ -207,6 +207,11 @@ public:
      */
     void ForceUseOfNumericalJacobian();
 
+    /**
+     * @return a new solver for systems of the same size, with the same Jacobian settings.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
     /**
      * Public method used in archiving.
      *
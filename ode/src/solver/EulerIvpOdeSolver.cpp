@@ -57,6 +57,11 @@ void EulerIvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOdeSyste
 }
 
 
+boost::shared_ptr<AbstractIvpOdeSolver> EulerIvpOdeSolver::CreateCopy() const
+{
+    return boost::shared_ptr<AbstractIvpOdeSolver>(new EulerIvpOdeSolver);
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(EulerIvpOdeSolver)
@@ -94,6 +94,11 @@ public:
     EulerIvpOdeSolver()
     {}
 
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
     /**
      * Destructor.
      */
@@ -95,6 +95,11 @@ void GRL1IvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOdeSystem
 }
 
 
+boost::shared_ptr<AbstractIvpOdeSolver> GRL1IvpOdeSolver::CreateCopy() const
+{
+    return boost::shared_ptr<AbstractIvpOdeSolver>(new GRL1IvpOdeSolver);
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(GRL1IvpOdeSolver)
@@ -107,6 +107,11 @@ public:
     GRL1IvpOdeSolver()
     {}
 
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
 };
 
 #include "SerializationExportWrapper.hpp"
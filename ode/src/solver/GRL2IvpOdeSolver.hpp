@@ -112,6 +112,11 @@ public:
     GRL2IvpOdeSolver()
     {}
 
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -52,29 +52,34 @@ void HeunIvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOdeSystem
 
     const unsigned num_equations = pAbstractOdeSystem->GetNumberOfStateVariables();
 
-    std::vector<double> k1(num_equations);
-    std::vector<double> k2(num_equations);
+    mk1.resize(num_equations);
+    mk2.resize(num_equations);
     std::vector<double>& dy = rNextYValues; // re-use memory
 
     // Work out k1
-    pAbstractOdeSystem->EvaluateYDerivatives(time, rCurrentYValues, k1);
+    pAbstractOdeSystem->EvaluateYDerivatives(time, rCurrentYValues, mk1);
 
     // Add current y values to k1 values
     for (unsigned i=0; i<num_equations; i++)
     {
-        dy[i] = timeStep*k1[i] + rCurrentYValues[i];
+        dy[i] = timeStep*mk1[i] + rCurrentYValues[i];
     }
     //Work out k2
-    pAbstractOdeSystem->EvaluateYDerivatives(time+timeStep, dy, k2);
+    pAbstractOdeSystem->EvaluateYDerivatives(time+timeStep, dy, mk2);
 
     // New solution
     for (unsigned i=0; i<num_equations; i++)
     {
-        rNextYValues[i] = rCurrentYValues[i] + timeStep*0.5*(k1[i] + k2[i]);
+        rNextYValues[i] = rCurrentYValues[i] + timeStep*0.5*(mk1[i] + mk2[i]);
     }
 }
 
 
+boost::shared_ptr<AbstractIvpOdeSolver> HeunIvpOdeSolver::CreateCopy() const
+{
+    return boost::shared_ptr<AbstractIvpOdeSolver>(new HeunIvpOdeSolver);
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(HeunIvpOdeSolver)
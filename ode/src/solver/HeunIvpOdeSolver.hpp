@@ -81,6 +81,11 @@ protected:
                              std::vector<double>& rCurrentYValues,
                              std::vector<double>& rNextYValues);
 
+private:
+
+    std::vector<double> mk1;  /**< Working memory: expression k1 in the Heun method. */
+    std::vector<double> mk2;  /**< Working memory: expression k2 in the Heun method. */
+
 public:
 
     /**
@@ -89,6 +94,11 @@ public:
     HeunIvpOdeSolver()
     {}
 
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -50,7 +50,7 @@ void RungeKutta2IvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOd
 
     const unsigned num_equations = pAbstractOdeSystem->GetNumberOfStateVariables();
 
-    std::vector<double> k1(num_equations);
+    mk1.resize(num_equations);
     std::vector<double>& dy = rNextYValues; // re-use memory
 
     // Work out k1
@@ -58,12 +58,12 @@ void RungeKutta2IvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOd
 
     for (unsigned i=0; i<num_equations; i++)
     {
-        k1[i] = timeStep*dy[i];
-        k1[i] = k1[i]/2.0 + rCurrentYValues[i];
+        mk1[i] = timeStep*dy[i];
+        mk1[i] = mk1[i]/2.0 + rCurrentYValues[i];
     }
 
     // Work out k2 and new solution
-    pAbstractOdeSystem->EvaluateYDerivatives(time+timeStep/2.0, k1, dy);
+    pAbstractOdeSystem->EvaluateYDerivatives(time+timeStep/2.0, mk1, dy);
     for (unsigned i=0; i<num_equations; i++)
     {
         rNextYValues[i] = rCurrentYValues[i] + timeStep*dy[i];
@@ -71,6 +71,11 @@ void RungeKutta2IvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOd
 }
 
 
+boost::shared_ptr<AbstractIvpOdeSolver> RungeKutta2IvpOdeSolver::CreateCopy() const
+{
+    return boost::shared_ptr<AbstractIvpOdeSolver>(new RungeKutta2IvpOdeSolver);
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(RungeKutta2IvpOdeSolver)
@@ -81,6 +81,10 @@ protected:
                              std::vector<double>& rCurrentYValues,
                              std::vector<double>& rNextYValues);
 
+private:
+
+    std::vector<double> mk1;  /**< Working memory: expression k1 in the RK2 method. */
+
 public:
 
     /**
@@ -89,6 +93,11 @@ public:
     RungeKutta2IvpOdeSolver()
     {}
 
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
 };
 
 #include "SerializationExportWrapper.hpp"
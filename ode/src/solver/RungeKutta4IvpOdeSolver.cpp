@@ -90,6 +90,11 @@ void RungeKutta4IvpOdeSolver::CalculateNextYValue(AbstractOdeSystem* pAbstractOd
 }
 
 
+boost::shared_ptr<AbstractIvpOdeSolver> RungeKutta4IvpOdeSolver::CreateCopy() const
+{
+    return boost::shared_ptr<AbstractIvpOdeSolver>(new RungeKutta4IvpOdeSolver);
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(RungeKutta4IvpOdeSolver)
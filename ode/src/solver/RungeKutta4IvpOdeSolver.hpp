@@ -89,6 +89,12 @@ private:
     std::vector<double> k4;  /**< Working memory: expression k4 in the RK4 method. */
     std::vector<double> yki; /**< Working memory: expression yki in the RK4 method. */
 
+public:
+
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
 };
 
 #include "SerializationExportWrapper.hpp"
@@ -297,13 +297,13 @@ OdeSolution RungeKuttaFehlbergIvpOdeSolver::Solve(AbstractOdeSystem* pOdeSystem,
     {
         EXCEPTION("(Solve with sampling) Stopping event is true for initial condition");
     }
-    // Allocate working memory
-    std::vector<double> working_memory(rYValues.size());
+    // Perhaps resize working memory
+    mWorkingMemory.resize(rYValues.size());
     // And solve...
     OdeSolution solutions;
     //solutions.SetNumberOfTimeSteps((unsigned)(10.0*(startTime-endTime)/timeStep));
     bool return_solution = true;
-    InternalSolve(solutions, pOdeSystem, rYValues, working_memory, startTime, endTime, timeStep, 1e-5, tolerance, return_solution);
+    InternalSolve(solutions, pOdeSystem, rYValues, mWorkingMemory, startTime, endTime, timeStep, 1e-5, tolerance, return_solution);
     return solutions;
 }
 
@@ -322,15 +322,20 @@ void RungeKuttaFehlbergIvpOdeSolver::Solve(AbstractOdeSystem* pOdeSystem,
     {
         EXCEPTION("(Solve without sampling) Stopping event is true for initial condition");
     }
-    // Allocate working memory
-    std::vector<double> working_memory(rYValues.size());
+    // Perhaps resize working memory
+    mWorkingMemory.resize(rYValues.size());
     // And solve...
     OdeSolution not_required_solution;
     bool return_solution = false;
-    InternalSolve(not_required_solution, pOdeSystem, rYValues, working_memory, startTime, endTime, timeStep, 1e-4, 1e-5, return_solution);
+    InternalSolve(not_required_solution, pOdeSystem, rYValues, mWorkingMemory, startTime, endTime, timeStep, 1e-4, 1e-5, return_solution);
 }
 
 
+boost::shared_ptr<AbstractIvpOdeSolver> RungeKuttaFehlbergIvpOdeSolver::CreateCopy() const
+{
+    return boost::shared_ptr<AbstractIvpOdeSolver>(new RungeKuttaFehlbergIvpOdeSolver);
+}
+
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
 CHASTE_CLASS_EXPORT(RungeKuttaFehlbergIvpOdeSolver)
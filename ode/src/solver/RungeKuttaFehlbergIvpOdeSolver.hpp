@@ -110,6 +110,9 @@ private:
     std::vector<double> myk5; /**< Working memory: expression yk5 in the RKF45 method. */
     std::vector<double> myk6; /**< Working memory: expression yk6 in the RKF45 method. */
 
+    /** Working memory for the solution at the next time step, kept between calls to Solve(). */
+    std::vector<double> mWorkingMemory;
+
 protected:
 
     /**
@@ -176,6 +179,11 @@ public:
      */
     RungeKuttaFehlbergIvpOdeSolver();
 
+    /**
+     * @return a new solver of this type.
+     */
+    boost::shared_ptr<AbstractIvpOdeSolver> CreateCopy() const;
+
     /**
      * Solves a system of ODEs using a specified one-step ODE solver and returns
      * the solution as an OdeSolution object.
@@ -448,6 +448,58 @@ public:
 #endif // CHASTE_CVODE
     }
 
+    void TestWarmRestarts() throw (Exception)
+    {
+#ifdef CHASTE_CVODE
+        ParameterisedCvode ode;
+        ode.SetUseWarmRestarts();
+        TS_ASSERT_EQUALS(ode.GetUseWarmRestarts(), true);
+
+        // Jump the state before each solve, as a tissue simulation does to the voltage;
+        // unlike minimal reset mode, the jumps must not be lost
+        ode.SetParameter("a", 1.0); // dy/dt = 1
+        ode.SetStateVariable(0u, 0.0);
+        for (unsigned i=0; i<10; i++)
+        {
+            ode.SetStateVariable(0u, ode.GetStateVariable(0u) + 1.0);
+            ode.Solve(i, i+1.0, 1.0);
+        }
+        TS_ASSERT_DELTA(ode.GetStateVariable(0u), 20.0, 1e-10);
+        TS_ASSERT_LESS_THAN(0.0, ode.GetLastStepSize());
+
+        ode.SetUseWarmRestarts(false);
+        TS_ASSERT_EQUALS(ode.GetUseWarmRestarts(), false);
+#else
+        std::cout << "Cvode is not enabled - this test was not run.\n";
+#endif // CHASTE_CVODE
+    }
+
+    void TestBandedLinearSolver() throw (Exception)
+    {
+#ifdef CHASTE_CVODE
+        // This system has a diagonal Jacobian
+        TwoDimCvodeSystem ode_system;
+        ode_system.SetUseBandedLinearSolver();
+        ode_system.Solve(0.0, 1.0, 0.01);
+
+#if CHASTE_SUNDIALS_VERSION >= 20400
+        TS_ASSERT_EQUALS(ode_system.IsUsingBandedLinearSolver(), true);
+#else
+        TS_ASSERT_EQUALS(ode_system.IsUsingBandedLinearSolver(), false);
+#endif
+        TS_ASSERT_DELTA(ode_system.GetStateVariable(0u), exp(1.0), 1e-3);
+        TS_ASSERT_DELTA(ode_system.GetStateVariable(1u), 2.0*exp(1.0), 2e-3);
+
+        // Switching back re-creates the solver with the dense linear solver
+        ode_system.SetUseBandedLinearSolver(false);
+        ode_system.Solve(1.0, 2.0, 0.01);
+        TS_ASSERT_EQUALS(ode_system.IsUsingBandedLinearSolver(), false);
+        TS_ASSERT_DELTA(ode_system.GetStateVariable(0u), exp(2.0), 1e-2);
+#else
+        std::cout << "Cvode is not enabled - this test was not run.\n";
+#endif // CHASTE_CVODE
+    }
+
     void TestArchiving() throw (Exception)
     {
 #ifdef CHASTE_CVODE
@@ -96,6 +96,9 @@ protected:
      * The concrete subclass can overload this and IncrementInterpolatedQuantities()
      * if there are some quantities which need to be computed at each Gauss point.
      * They are called in AssembleOnElement().
+     *
+     * Concrete classes which store interpolated quantities in member variables should
+     * also override CanAssembleConcurrently() to return false.
      */
     virtual void ResetInterpolatedQuantities()
     {}
@@ -39,6 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cassert>
 #include "UblasCustomFunctions.hpp"
 #include "PetscTools.hpp"
+#include "Exception.hpp"
 
 /**
  *   A common bass class for AbstractFeVolumeIntegralAssembler (the main abstract assembler class), and other assembler classes
@@ -79,6 +80,36 @@ protected:
     /** Ownership range of the vector/matrix - highest component owned +1. */
     PetscInt mOwnershipRangeHi;
 
+    /** Number of threads used to compute element contributions (defaults to 1). */
+    unsigned mNumAssemblyThreads;
+
+    /**
+     * Number of elements whose contributions are computed concurrently before being
+     * added to the matrix/vector, when more than one assembly thread is used.
+     */
+    static const unsigned ASSEMBLY_CHUNK_SIZE = 512;
+
+    /**
+     * @return whether element contributions may be computed by several threads at once.
+     * This requires AssembleOnElement() (and the integrands it calls) to only read
+     * member data.  Returns true here; concrete assemblers which keep state at each
+     * quadrature point should override this to return false, in which case assembly
+     * is serial whatever the number of assembly threads.
+     */
+    virtual bool CanAssembleConcurrently()
+    {
+        return true;
+    }
+
+    /**
+     * @return whether DoAssemble() should compute element contributions using
+     * several threads.
+     */
+    bool AssembleConcurrently()
+    {
+        return mNumAssemblyThreads > 1u && CanAssembleConcurrently();
+    }
+
     /**
      * The main assembly method. Protected, should only be called through Assemble(),
      * AssembleMatrix() or AssembleVector() which set mAssembleMatrix, mAssembleVector
@@ -113,6 +144,27 @@ public:
      */
     void SetVectorToAssemble(Vec& rVecToAssemble, bool zeroVectorBeforeAssembly);
 
+    /**
+     * Set the number of threads used to compute element contributions.
+     *
+     * Element matrices and vectors are computed a chunk of elements at a time by
+     * all the threads, and then added to the matrix/vector by a single thread in
+     * element order, since PETSc insertion is not thread-safe.  The result is
+     * therefore identical to serial assembly.  Values larger than 1 require Chaste
+     * to have been compiled with OpenMP support (build=...,openmp).
+     *
+     * @param numThreads  the number of threads (must be positive)
+     */
+    void SetNumAssemblyThreads(unsigned numThreads);
+
+    /**
+     * @return the number of threads used to compute element contributions.
+     */
+    unsigned GetNumAssemblyThreads() const
+    {
+        return mNumAssemblyThreads;
+    }
+
     /**
      * Assemble everything that the class can assemble.
      */
@@ -158,7 +210,8 @@ AbstractFeAssemblerInterface<CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX>::Abstract
     : mVectorToAssemble(NULL),
       mMatrixToAssemble(NULL),
       mZeroMatrixBeforeAssembly(true),
-      mZeroVectorBeforeAssembly(true)
+      mZeroVectorBeforeAssembly(true),
+      mNumAssemblyThreads(1u)
 {
     assert(CAN_ASSEMBLE_VECTOR || CAN_ASSEMBLE_MATRIX);
 }
@@ -183,4 +236,20 @@ void AbstractFeAssemblerInterface<CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX>::Set
     mZeroVectorBeforeAssembly = zeroVectorBeforeAssembly;
 }
 
+template <bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX>
+void AbstractFeAssemblerInterface<CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX>::SetNumAssemblyThreads(unsigned numThreads)
+{
+    if (numThreads == 0u)
+    {
+        EXCEPTION("The number of assembly threads must be positive.");
+    }
+#ifndef _OPENMP
+    if (numThreads > 1u)
+    {
+        EXCEPTION("Chaste was not compiled with OpenMP support, so elements can only be assembled by one thread.");
+    }
+#endif // _OPENMP
+    mNumAssemblyThreads = numThreads;
+}
+
 #endif // ABSTRACTFEASSEMBLERINTERFACE_HPP_
@@ -41,11 +41,17 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscVecTools.hpp"
 #include "PetscMatTools.hpp"
 
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+
 /**
  * The class in similar to AbstractFeVolumeIntegralAssembler (see documentation for this), but is for
  * creating a finite element matrices or vectors that involve integrals over CABLES, ie 1d regions
  * in a 2d/3d mesh. Required for cardiac simulations with a Purkinje network. Uses
  * a MixedDimensionMesh, which is composed of the normal mesh plus cables.
+ *
+ * As for volume integrals, cable element contributions are computed concurrently if
+ * SetNumAssemblyThreads() has been called with more than one thread.
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX, InterpolationLevel INTERPOLATION_LEVEL>
 class AbstractFeCableIntegralAssembler : public AbstractFeAssemblerCommon<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,CAN_ASSEMBLE_VECTOR,CAN_ASSEMBLE_MATRIX,INTERPOLATION_LEVEL>
@@ -91,6 +97,13 @@ protected:
      */
     void DoAssemble();
 
+    /**
+     * Assemble the contributions of all owned cable elements which satisfy
+     * ElementAssemblyCriterion(), computing the element contributions with
+     * #mNumAssemblyThreads threads.  Called by DoAssemble().
+     */
+    void DoAssembleConcurrently();
+
     /**
      * @return the matrix to be added to element stiffness matrix
      * for a given Gauss point, ie, essentially the INTEGRAND in the integral
@@ -271,7 +284,11 @@ void AbstractFeCableIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_A
     c_vector<double, STENCIL_SIZE> b_elem;
 
     // Loop over elements
-    if (this->mAssembleMatrix || this->mAssembleVector)
+    if ((this->mAssembleMatrix || this->mAssembleVector) && this->AssembleConcurrently())
+    {
+        DoAssembleConcurrently();
+    }
+    else if (this->mAssembleMatrix || this->mAssembleVector)
     {
         for (typename MixedDimensionMesh<CABLE_ELEMENT_DIM, SPACE_DIM>::CableElementIterator iter = mpMesh->GetCableElementIteratorBegin();
              iter != mpMesh->GetCableElementIteratorEnd();
@@ -303,6 +320,86 @@ void AbstractFeCableIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_A
     HeartEventHandler::EndEvent(assemble_event);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX, InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeCableIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::DoAssembleConcurrently()
+{
+    const size_t STENCIL_SIZE=PROBLEM_DIM*NUM_CABLE_ELEMENT_NODES;
+
+    // See AbstractFeVolumeIntegralAssembler::DoAssembleConcurrently()
+    std::vector<Element<CABLE_ELEMENT_DIM, SPACE_DIM>*> chunk_elements;
+    chunk_elements.reserve(this->ASSEMBLY_CHUNK_SIZE);
+    std::vector<c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> > a_elems(this->ASSEMBLY_CHUNK_SIZE);
+    std::vector<c_vector<double, STENCIL_SIZE> > b_elems(this->ASSEMBLY_CHUNK_SIZE);
+
+    typename MixedDimensionMesh<CABLE_ELEMENT_DIM, SPACE_DIM>::CableElementIterator iter = mpMesh->GetCableElementIteratorBegin();
+    while (iter != mpMesh->GetCableElementIteratorEnd())
+    {
+        // Gather the next chunk of cable elements to be assembled
+        chunk_elements.clear();
+        for ( ; iter != mpMesh->GetCableElementIteratorEnd() && chunk_elements.size() < this->ASSEMBLY_CHUNK_SIZE; ++iter)
+        {
+            Element<CABLE_ELEMENT_DIM, SPACE_DIM>& r_element = *(*iter);
+            if ( r_element.GetOwnership() == true && ElementAssemblyCriterion(r_element)==true )
+            {
+                chunk_elements.push_back(&r_element);
+            }
+        }
+
+        // OpenMP 2.5 loops need a signed index
+        const int num_chunk_elements = chunk_elements.size();
+
+        // Details of the failure with the lowest index in the chunk, if any
+        int failed_index = num_chunk_elements;
+        boost::scoped_ptr<Exception> p_failure;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(this->mNumAssemblyThreads)
+#endif // _OPENMP
+        for (int i=0; i<num_chunk_elements; i++)
+        {
+            // Exceptions can't propagate out of a parallel region, so record the failure instead
+            try
+            {
+                AssembleOnCableElement(*(chunk_elements[i]), a_elems[i], b_elems[i]);
+            }
+            catch (Exception& e)
+            {
+#ifdef _OPENMP
+#pragma omp critical(AbstractFeCableIntegralAssembler_Failure)
+#endif // _OPENMP
+                {
+                    if (i < failed_index)
+                    {
+                        failed_index = i;
+                        p_failure.reset(new Exception(e));
+                    }
+                }
+            }
+        }
+
+        if (p_failure)
+        {
+            throw Exception(*p_failure);
+        }
+
+        for (int i=0; i<num_chunk_elements; i++)
+        {
+            unsigned p_indices[STENCIL_SIZE];
+            chunk_elements[i]->GetStiffnessMatrixGlobalIndices(PROBLEM_DIM, p_indices);
+
+            if (this->mAssembleMatrix)
+            {
+                PetscMatTools::AddMultipleValues<STENCIL_SIZE>(this->mMatrixToAssemble, p_indices, a_elems[i]);
+            }
+
+            if (this->mAssembleVector)
+            {
+                PetscVecTools::AddMultipleValues<STENCIL_SIZE>(this->mVectorToAssemble, p_indices, b_elems[i]);
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 // Implementation - AssembleOnCableElement and smaller
 ///////////////////////////////////////////////////////////////////////////////////
@@ -313,7 +410,7 @@ void AbstractFeCableIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_A
         const c_matrix<double, CABLE_ELEMENT_DIM, SPACE_DIM>& rInverseJacobian,
         c_matrix<double, SPACE_DIM, NUM_CABLE_ELEMENT_NODES>& rReturnValue)
 {
-    static c_matrix<double, CABLE_ELEMENT_DIM, NUM_CABLE_ELEMENT_NODES> grad_phi;
+    c_matrix<double, CABLE_ELEMENT_DIM, NUM_CABLE_ELEMENT_NODES> grad_phi;
 
     LinearBasisFunction<CABLE_ELEMENT_DIM>::ComputeBasisFunctionDerivatives(rPoint, grad_phi);
     rReturnValue = prod(trans(rInverseJacobian), grad_phi);
@@ -56,6 +56,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  non-zero Neumann BCs (from the BoundaryConditionsContainer given) are assembled on.
  *
  *  The interface is the same the volume assemblers.
+ *
+ *  Surface element contributions are always computed serially, whatever the number of assembly
+ *  threads, since BoundaryConditionsContainer::GetNeumannBCValue() caches the last condition found.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM>
 class AbstractFeSurfaceIntegralAssembler : public AbstractFeAssemblerCommon<ELEMENT_DIM,SPACE_DIM,PROBLEM_DIM,true,false,NORMAL>
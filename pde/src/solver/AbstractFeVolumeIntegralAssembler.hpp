@@ -42,6 +42,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscVecTools.hpp"
 #include "PetscMatTools.hpp"
 
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+
 /**
  *
  * An abstract class for creating finite element vectors or matrices that are defined
@@ -73,6 +76,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *
  * This class inherits from AbstractFeAssemblerCommon which is where some member variables
  * (the matrix/vector to be created, for example) are defined.
+ *
+ * If SetNumAssemblyThreads() has been called with more than one thread, the element
+ * contributions are computed concurrently, so ComputeMatrixTerm() and ComputeVectorTerm()
+ * must then only read member data.  Concrete classes for which this is not the case
+ * should override CanAssembleConcurrently().
  */
 template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX, InterpolationLevel INTERPOLATION_LEVEL>
 class AbstractFeVolumeIntegralAssembler :
@@ -118,6 +126,13 @@ protected:
      */
     void DoAssemble();
 
+    /**
+     * Assemble the contributions of all owned elements which satisfy
+     * ElementAssemblyCriterion(), computing the element contributions with
+     * #mNumAssemblyThreads threads.  Called by DoAssemble().
+     */
+    void DoAssembleConcurrently();
+
 protected:
 
     /**
@@ -287,6 +302,13 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_
         PetscMatTools::Zero(this->mMatrixToAssemble);
     }
 
+    if (this->AssembleConcurrently())
+    {
+        DoAssembleConcurrently();
+        HeartEventHandler::EndEvent(assemble_event);
+        return;
+    }
+
     const size_t STENCIL_SIZE=PROBLEM_DIM*(ELEMENT_DIM+1);
     c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> a_elem;
     c_vector<double, STENCIL_SIZE> b_elem;
@@ -321,6 +343,91 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_
     HeartEventHandler::EndEvent(assemble_event);
 }
 
+template <unsigned ELEMENT_DIM, unsigned SPACE_DIM, unsigned PROBLEM_DIM, bool CAN_ASSEMBLE_VECTOR, bool CAN_ASSEMBLE_MATRIX, InterpolationLevel INTERPOLATION_LEVEL>
+void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_ASSEMBLE_VECTOR, CAN_ASSEMBLE_MATRIX, INTERPOLATION_LEVEL>::DoAssembleConcurrently()
+{
+    const size_t STENCIL_SIZE=PROBLEM_DIM*(ELEMENT_DIM+1);
+
+    /*
+     * Each element's contribution goes into its own slot of these buffers, so threads
+     * never write to the same memory and there is no need to colour the elements.
+     * The buffers are then added to the PETSc objects by this thread in element order,
+     * which gives exactly the same sums as the serial loop in DoAssemble().
+     */
+    std::vector<Element<ELEMENT_DIM, SPACE_DIM>*> chunk_elements;
+    chunk_elements.reserve(this->ASSEMBLY_CHUNK_SIZE);
+    std::vector<c_matrix<double, STENCIL_SIZE, STENCIL_SIZE> > a_elems(this->ASSEMBLY_CHUNK_SIZE);
+    std::vector<c_vector<double, STENCIL_SIZE> > b_elems(this->ASSEMBLY_CHUNK_SIZE);
+
+    typename AbstractTetrahedralMesh<ELEMENT_DIM, SPACE_DIM>::ElementIterator iter = mpMesh->GetElementIteratorBegin();
+    while (iter != mpMesh->GetElementIteratorEnd())
+    {
+        // Gather the next chunk of elements to be assembled
+        chunk_elements.clear();
+        for ( ; iter != mpMesh->GetElementIteratorEnd() && chunk_elements.size() < this->ASSEMBLY_CHUNK_SIZE; ++iter)
+        {
+            Element<ELEMENT_DIM, SPACE_DIM>& r_element = *iter;
+            if ( r_element.GetOwnership() == true && ElementAssemblyCriterion(r_element)==true )
+            {
+                chunk_elements.push_back(&r_element);
+            }
+        }
+
+        // OpenMP 2.5 loops need a signed index
+        const int num_chunk_elements = chunk_elements.size();
+
+        // Details of the failure with the lowest index in the chunk, if any
+        int failed_index = num_chunk_elements;
+        boost::scoped_ptr<Exception> p_failure;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) num_threads(this->mNumAssemblyThreads)
+#endif // _OPENMP
+        for (int i=0; i<num_chunk_elements; i++)
+        {
+            // Exceptions can't propagate out of a parallel region, so record the failure instead
+            try
+            {
+                AssembleOnElement(*(chunk_elements[i]), a_elems[i], b_elems[i]);
+            }
+            catch (Exception& e)
+            {
+#ifdef _OPENMP
+#pragma omp critical(AbstractFeVolumeIntegralAssembler_Failure)
+#endif // _OPENMP
+                {
+                    if (i < failed_index)
+                    {
+                        failed_index = i;
+                        p_failure.reset(new Exception(e));
+                    }
+                }
+            }
+        }
+
+        if (p_failure)
+        {
+            throw Exception(*p_failure);
+        }
+
+        for (int i=0; i<num_chunk_elements; i++)
+        {
+            unsigned p_indices[STENCIL_SIZE];
+            chunk_elements[i]->GetStiffnessMatrixGlobalIndices(PROBLEM_DIM, p_indices);
+
+            if (this->mAssembleMatrix)
+            {
+                PetscMatTools::AddMultipleValues<STENCIL_SIZE>(this->mMatrixToAssemble, p_indices, a_elems[i]);
+            }
+
+            if (this->mAssembleVector)
+            {
+                PetscVecTools::AddMultipleValues<STENCIL_SIZE>(this->mVectorToAssemble, p_indices, b_elems[i]);
+            }
+        }
+    }
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Implementation - AssembleOnElement and smaller
@@ -333,7 +440,7 @@ void AbstractFeVolumeIntegralAssembler<ELEMENT_DIM, SPACE_DIM, PROBLEM_DIM, CAN_
         c_matrix<double, SPACE_DIM, ELEMENT_DIM+1>& rReturnValue)
 {
     assert(ELEMENT_DIM < 4 && ELEMENT_DIM > 0);
-    static c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> grad_phi;
+    c_matrix<double, ELEMENT_DIM, ELEMENT_DIM+1> grad_phi;
 
     LinearBasisFunction<ELEMENT_DIM>::ComputeBasisFunctionDerivatives(rPoint, grad_phi);
     rReturnValue = prod(trans(rInverseJacobian), grad_phi);
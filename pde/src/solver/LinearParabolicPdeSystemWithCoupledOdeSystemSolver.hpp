@@ -153,6 +153,16 @@ private:
      */
     void IncrementInterpolatedQuantities(double phiI, const Node<SPACE_DIM>* pNode);
 
+    /**
+     * Overridden CanAssembleConcurrently() method.
+     *
+     * @return false, since the ODE state variables are interpolated into a member variable.
+     */
+    bool CanAssembleConcurrently()
+    {
+        return false;
+    }
+
     /**
      * Initialise method: sets up the linear system (using the mesh to
      * determine the number of unknowns per row to preallocate) if it is not
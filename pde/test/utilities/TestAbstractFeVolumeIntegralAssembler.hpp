@@ -592,6 +592,68 @@ public:
         PetscTools::Destroy(mat);
     }
 
+    void TestThreadedAssembly() throw(Exception)
+    {
+        // More elements than fit in one chunk of concurrently-computed element contributions
+        TetrahedralMesh<2,2> mesh;
+        mesh.ConstructRegularSlabMesh(0.05, 1.0, 1.0);
+        TS_ASSERT_LESS_THAN(512u, mesh.GetNumElements());
+
+        Mat mat;
+        PetscTools::SetupMat(mat, mesh.GetNumNodes(), mesh.GetNumNodes(), 9);
+        Mat threaded_mat;
+        PetscTools::SetupMat(threaded_mat, mesh.GetNumNodes(), mesh.GetNumNodes(), 9);
+        Vec vec = PetscTools::CreateVec(mesh.GetNumNodes());
+        Vec threaded_vec = PetscTools::CreateVec(mesh.GetNumNodes());
+
+        StiffnessMatrixAssembler<2,2> matrix_assembler(&mesh);
+        BasicVectorAssembler<2> vector_assembler(&mesh);
+        StiffnessMatrixAssembler<2,2> threaded_matrix_assembler(&mesh);
+        BasicVectorAssembler<2> threaded_vector_assembler(&mesh);
+        TS_ASSERT_EQUALS(threaded_matrix_assembler.GetNumAssemblyThreads(), 1u);
+
+        TS_ASSERT_THROWS_THIS(threaded_matrix_assembler.SetNumAssemblyThreads(0u),
+                              "The number of assembly threads must be positive.");
+#ifdef _OPENMP
+        unsigned num_threads = 4u;
+#else
+        TS_ASSERT_THROWS_THIS(threaded_matrix_assembler.SetNumAssemblyThreads(4u),
+                              "Chaste was not compiled with OpenMP support, so elements can only be assembled by one thread.");
+        unsigned num_threads = 1u;
+#endif // _OPENMP
+        threaded_matrix_assembler.SetNumAssemblyThreads(num_threads);
+        threaded_vector_assembler.SetNumAssemblyThreads(num_threads);
+        TS_ASSERT_EQUALS(threaded_matrix_assembler.GetNumAssemblyThreads(), num_threads);
+
+        matrix_assembler.SetMatrixToAssemble(mat);
+        matrix_assembler.Assemble();
+        vector_assembler.SetVectorToAssemble(vec, true);
+        vector_assembler.Assemble();
+        threaded_matrix_assembler.SetMatrixToAssemble(threaded_mat);
+        threaded_matrix_assembler.Assemble();
+        threaded_vector_assembler.SetVectorToAssemble(threaded_vec, true);
+        threaded_vector_assembler.Assemble();
+
+        PetscMatTools::Finalise(mat);
+        PetscMatTools::Finalise(threaded_mat);
+        PetscVecTools::Finalise(vec);
+        PetscVecTools::Finalise(threaded_vec);
+
+        // Contributions are added in the same order, so the results are identical
+        TS_ASSERT(PetscMatTools::CheckEquality(mat, threaded_mat, 1e-12));
+        ReplicatableVector vec_repl(vec);
+        ReplicatableVector threaded_vec_repl(threaded_vec);
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            TS_ASSERT_DELTA(threaded_vec_repl[i], vec_repl[i], 1e-12);
+        }
+
+        PetscTools::Destroy(mat);
+        PetscTools::Destroy(threaded_mat);
+        PetscTools::Destroy(vec);
+        PetscTools::Destroy(threaded_vec);
+    }
+
     void TestInterpolationOfPositionAndCurrentSolution() throw(Exception)
     {
         TetrahedralMesh<1,1> mesh;
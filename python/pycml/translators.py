@@ -1054,8 +1054,7 @@ class CellMLTranslator(object):
                 min, max, step, _ = self.lut_parameters(key)
                 self.writeln(self.TYPE_CONST_UNSIGNED, '_table_size_', idx, self.EQ_ASSIGN,
                              self.lut_size_calculation(min, max, step), self.STMT_END)
-                self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'new double[_table_size_', idx,
-                             '][', self.doc.lookup_tables_num_per_index[idx], ']', self.STMT_END)
+                self.output_lut_allocation(idx)
         # Generate each table in a separate loop
         for expr in self.doc.lookup_tables:
             var = expr.component.get_variable_by_name(expr.var)
@@ -1065,6 +1064,9 @@ class CellMLTranslator(object):
                 continue
             min, max, step, _ = self.lut_parameters(key)
             j = expr.table_name
+            guarded = self.output_lut_generation_guard(idx)
+            if guarded:
+                self.open_block()
             self.writeln('for (unsigned i=0 ; i<_table_size_', idx, '; i++)')
             self.open_block()
             self.writeln(self.TYPE_CONST_DOUBLE, self.code_name(var), self.EQ_ASSIGN, min,
@@ -1072,9 +1074,24 @@ class CellMLTranslator(object):
             self.writeln(self.lut_access_code(idx, j, 'i'), self.EQ_ASSIGN, nl=False)
             self.output_expr(expr, False)
             self.writeln(self.STMT_END, indent=False)
-            self.close_block()
+            self.close_block(blank_line=not guarded)
+            if guarded:
+                self.close_block()
         self.use_lookup_tables = True
 
+    def output_lut_generation_guard(self, idx):
+        """Output any condition under which the lookup tables with the given table index are filled.
+
+        Returns True if a condition was output, in which case the generation code is put in a block.
+        By default the tables are always filled, so nothing is output.
+        """
+        return False
+
+    def output_lut_allocation(self, idx):
+        """Output code to allocate memory for the lookup tables with the given table index."""
+        self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'new double[_table_size_', idx,
+                     '][', self.doc.lookup_tables_num_per_index[idx], ']', self.STMT_END)
+
     def output_lut_deletion(self, only_index=None):
         """Output code to delete memory allocated for lookup tables."""
         for idx in self.doc.lookup_table_indexes.itervalues():
@@ -1160,13 +1177,24 @@ class CellMLTranslator(object):
         self.writeln()
         return
     
-    def output_lut_row_lookup_memory(self):
-        """Output declarations for the memory used by the row lookup methods."""
+    def output_lut_row_lookup_memory(self, thread_private=False):
+        """Output declarations for the memory used by the row lookup methods.
+
+        If thread_private is True, the memory is declared at file scope and made private
+        to each OpenMP thread, so that cells sharing a lookup table collection may be
+        solved concurrently.
+        """
         self.output_comment('Row lookup methods memory')
         for key, idx in self.doc.lookup_table_indexes.iteritems():
             min, max, step, var = key
             num_tables = unicode(self.doc.lookup_tables_num_per_index[idx])
-            self.writeln('double _lookup_table_', idx, '_row[', num_tables, '];')
+            if thread_private:
+                self.writeln('static double _lookup_table_', idx, '_row[', num_tables, '];')
+                self.writeln('#ifdef _OPENMP', indent=False)
+                self.writeln('#pragma omp threadprivate(_lookup_table_', idx, '_row)', indent=False)
+                self.writeln('#endif // _OPENMP', indent=False)
+            else:
+                self.writeln('double _lookup_table_', idx, '_row[', num_tables, '];')
         self.writeln()
         return
 
@@ -2015,10 +2043,38 @@ class CellMLToChasteTranslator(CellMLTranslator):
         else:
             super(CellMLToChasteTranslator, self).output_table_index_generation_code(key, idx)
 
+    def output_lut_allocation(self, idx):
+        """Override base class method to use memory held by AbstractLookupTableCollection.
+
+        The tables in a separate class may then be moved into memory shared by all the
+        processes on a node using AbstractLookupTableCollection::MoveTablesToNodeSharedMemory.
+        """
+        if self.separate_lut_class:
+            num_tables = self.doc.lookup_tables_num_per_index[idx]
+            self.writeln('_lookup_table_', idx, self.EQ_ASSIGN, 'reinterpret_cast<double (*)[', num_tables,
+                         ']>(AllocateTableStorage(', idx, '))', self.STMT_END)
+        else:
+            super(CellMLToChasteTranslator, self).output_lut_allocation(idx)
+
+    def output_lut_generation_guard(self, idx):
+        """Override base class method so that tables in node-shared memory are filled by one process per node."""
+        if self.separate_lut_class:
+            self.writeln('if (IsTableStorageWriter(', idx, '))')
+            return True
+        return False
+
+    def output_lut_deletion(self, only_index=None):
+        """Override base class method, since memory held by AbstractLookupTableCollection is freed by it."""
+        if not self.separate_lut_class:
+            super(CellMLToChasteTranslator, self).output_lut_deletion(only_index)
+
     def output_lut_class(self):
         """Output a separate class for lookup tables.
         
         This will live entirely in the .cpp file."""
+        if self.row_lookup_method:
+            # The collection is a singleton shared by all cells, so the row memory lives outside it
+            self.output_lut_row_lookup_memory(thread_private=True)
         # Lookup tables class
         self.writeln('class ', self.lt_class_name, ' : public AbstractLookupTableCollection')
         self.writeln('{')
@@ -2096,8 +2152,6 @@ class CellMLToChasteTranslator(CellMLTranslator):
         self.writeln('private:', indent_level=0)
         self.writeln('/** The single instance of the class */')
         self.writeln('static std::auto_ptr<', self.lt_class_name, '> mpInstance;\n')
-        if self.row_lookup_method:
-            self.output_lut_row_lookup_memory()
         self.output_lut_declarations()
         # Close the class
         self.set_indent(0)
@@ -2704,7 +2758,29 @@ class CellMLToChasteTranslator(CellMLTranslator):
                 # Forward Euler update
                 self.writeln('rY[', i, '] += mDt * rDY[', i, '];')
         self.close_block()
-    
+
+        # GetRushLarsenUpdateInformation
+        ################################
+        self.output_method_start('GetRushLarsenUpdateInformation',
+                                 ['std::vector<RushLarsenUpdateType>& rUpdateTypes',
+                                  'std::vector<double>& rTimeScaleFactors'],
+                                 'bool', access='public')
+        self.open_block()
+        self.writeln('rUpdateTypes.assign(', len(self.state_vars), ', NO_UPDATE);')
+        self.writeln('rTimeScaleFactors.assign(', len(self.state_vars), ', 1.0);')
+        for i, var in enumerate(self.state_vars):
+            if var in rl_vars:
+                if rl_vars[var][0] == 'ab':
+                    self.writeln('rUpdateTypes[', i, '] = ALPHA_BETA_UPDATE;')
+                else:
+                    self.writeln('rUpdateTypes[', i, '] = TAU_INF_UPDATE;')
+                if rl_vars[var][3]:
+                    self.writeln('rTimeScaleFactors[', i, '] = ', str(rl_vars[var][3]), self.STMT_END)
+            elif var is not self.v_variable:
+                self.writeln('rUpdateTypes[', i, '] = FORWARD_EULER_UPDATE;')
+        self.writeln('return true;')
+        self.close_block()
+
     #Megan E. Marsh, Raymond J. Spiteri 
     #Numerical Simulation Laboratory 
     #University of Saskatchewan 